@@ -0,0 +1,67 @@
+//----------------------------------------------------------------------------
+//!	@file	vs_model_instanced.fx
+//!	@brief	静的メッシュのインスタンス描画頂点シェーダー
+//----------------------------------------------------------------------------
+
+// カメラ情報
+cbuffer CameraInfo : register(b10)	// Constant Buffer = 10番
+{
+	matrix	mat_view_;		//!< ビュー行列
+	matrix	mat_proj_;		//!< 投影行列
+	float3	eye_position_;	//!< カメラの位置
+};
+
+// 頂点シェーダーの入力
+struct VS_INPUT_INSTANCED
+{
+	float3	position_ : POSITION;			//!< 座標 (モデル空間)
+	float3	normal_   : NORMAL;				//!< 法線 (モデル空間)
+	float4	diffuse_  : COLOR0;				//!< Diffuseカラー
+	float2	uv0_      : TEXCOORD0;			//!< テクスチャ座標
+
+	// インスタンスごとのワールド行列 (3行)
+	float4	world0_   : INSTANCE_WORLD0;
+	float4	world1_   : INSTANCE_WORLD1;
+	float4	world2_   : INSTANCE_WORLD2;
+};
+
+// 頂点シェーダーの出力 (vs_model.fx と同じ)
+struct VS_OUTPUT_3D
+{
+	float4	position_      : SV_Position;		//!< 座標 (スクリーン空間)
+	float3	worldPosition_ : WORLD_POSITION;	//!< ワールド座標
+	float3	normal_        : NORMAL0;			//!< 法線
+	float4	diffuse_       : COLOR0;			//!< Diffuseカラー
+	float2	uv0_           : TEXCOORD0;			//!< テクスチャ座標
+};
+
+//----------------------------------------------------------------------------
+//	メイン関数
+//----------------------------------------------------------------------------
+VS_OUTPUT_3D main(VS_INPUT_INSTANCED input)
+{
+	VS_OUTPUT_3D output;
+
+	//----------------------------------------------------------
+	// 頂点座標変換
+	//----------------------------------------------------------
+	float3x4	matWorld = float3x4(input.world0_, input.world1_, input.world2_);
+
+	float3	worldPosition = mul(matWorld, float4(input.position_, 1.0));	// ワールド空間へ変換
+	float3	viewPosition  = mul(mat_view_, float4(worldPosition, 1.0));		// ビュー空間へ変換
+	output.position_      = mul(mat_proj_, float4(viewPosition , 1.0));		// スクリーン空間へ変換
+
+	output.worldPosition_ = worldPosition;
+
+	//----------------------------------------------------------
+	// 出力パラメータ
+	//----------------------------------------------------------
+	output.normal_  = mul(matWorld, float4(input.normal_, 0.0));	// 法線をワールド空間へ変換
+	output.diffuse_ = input.diffuse_;								// Diffuseカラー
+	output.uv0_     = input.uv0_;									// テクスチャ座標
+
+	//----------------------------------------------------------
+	// 出力パラメータを返す
+	//----------------------------------------------------------
+	return output;
+}
@@ -4,6 +4,7 @@
 //---------------------------------------------------------------------------
 #include <System/Scene.h>
 #include <System/Component/Component.h>
+#include <System/Graphics/TexturePool.h>
 
 #ifndef COMPONENTTEXTURE2D_HEADER
 #    define COMPONENTTEXTURE2D_HEADER
@@ -34,7 +35,7 @@ class ComponentTexture2D: public Component {
     void Construct(ObjectPtr owner, std::string_view path) {
         Construct(owner);
         m_pShaderPS = std::make_shared<ShaderPs>("data/Shader/ps_texture");
-        m_pTexture  = std::make_shared<Texture>(path);
+        m_pTexture  = TexturePool::load(path, TexturePool::PRIORITY_IMMEDIATE);
     }
 
     //------------------------------------------------------------
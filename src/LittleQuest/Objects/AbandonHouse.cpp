@@ -2,6 +2,7 @@
 
 #include <System/Component/ComponentAttachModel.h>
 #include <System/Component/ComponentCollisionModel.h>
+#include <System/Component/ComponentInstancedModel.h>
 #include <System/Component/ComponentModel.h>
 
 namespace LittleQuest {
@@ -12,7 +13,7 @@ AbandonHousePtr AbandonHouse::Create(std::string name, const float3& pos) {
     auto obj = Scene::CreateObjectPtr<AbandonHouse>();
     obj->SetName(name);
     obj->SetTranslate(pos);
-    obj->AddComponent<ComponentModel>("data/LittleQuest/Model/AbandonHouse/AbandonHouse.mv1");
+    obj->AddComponent<ComponentInstancedModel>("data/LittleQuest/Model/AbandonHouse/AbandonHouse.mv1");
 
     obj->m_pBox = Scene::CreateObjectPtr<Object>("AbandonHouseBox");
     obj->m_pBox->AddComponent<ComponentModel>("data/Sample/SwordBout/Stage/Stage_Obj009_c.mv1");
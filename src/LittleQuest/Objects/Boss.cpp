@@ -14,6 +14,54 @@
 #include <System/Component/ComponentTargetTracking.h>
 
 namespace LittleQuest {
+namespace {
+//! アニメーションID (SetAnimation()で登録する名前)
+const AnimId ANIM_IDLE(STR(BossState::IDLE));
+const AnimId ANIM_WALK("Walk");
+const AnimId ANIM_TURN_LEFT(STR(BossState::TURN_LEFT));
+const AnimId ANIM_TURN_RIGHT(STR(BossState::TURN_RIGHT));
+const AnimId ANIM_SWIP_ATTACK(STR(BossAnim::SWIP_ATTACK));
+const AnimId ANIM_QUICK_SWIP(STR(BossAnim::QUICK_SWIP));
+const AnimId ANIM_PUNCH(STR(BossAnim::PUNCH));
+const AnimId ANIM_QUICK_PUNCH(STR(BossAnim::QUICK_PUNCH));
+const AnimId ANIM_BACKFLIP(STR(BossAnim::BACKFLIP));
+const AnimId ANIM_DOUBLE_PUNCH(STR(BossAnim::DOUBLE_PUNCH));
+const AnimId ANIM_CHARGE(STR(BossAnim::CHARGE));
+const AnimId ANIM_EXPLODE_CHARGE(STR(BossAnim::EXPLODE_CHARGE));
+const AnimId ANIM_TAUNT_ANIM(STR(BossAnim::TAUNT_ANIM));
+const AnimId ANIM_ANGRY_AURA(STR(BossAnim::ANGRY_AURA));
+const AnimId ANIM_GET_HIT(STR(BossState::GET_HIT));
+const AnimId ANIM_DEAD(STR(BossState::DEAD));
+
+//! 攻撃判定のコリジョン名 (イベントの対象)
+constexpr std::string_view COLLISION_LEFT_HAND  = "LeftHand";
+constexpr std::string_view COLLISION_RIGHT_HAND = "RightHand";
+//! 両手パンチのエフェクト名 (イベントの対象)
+constexpr std::string_view EFFECT_DOUBLE_PUNCH  = "DoublePunch";
+
+//! イベントトラックのファイル (あればコードの設定より優先)
+constexpr std::string_view EVENT_FILE = "data/LittleQuest/Anim/BossEvents.txt";
+
+//! 攻撃アニメーションのイベントトラック
+//! @param info タイミング
+//! @param collisions 攻撃を判定するコリジョン名
+//! @param effect エフェクト名
+//! @param effectAngle エフェクトの角度
+std::vector<Animation::Event> AttackEvents(const AnimInfo& info, std::vector<std::string_view> collisions,
+                                           std::string_view effect, float effectAngle) {
+    using Type = Animation::Event::Type;
+
+    std::vector<Animation::Event> events;
+    for(auto name: collisions) {
+        events.push_back({Type::CollisionOn, info.triggerStartTime, std::string(name)});
+        events.push_back({Type::CollisionOff, info.triggerEndTime, std::string(name)});
+    }
+    events.push_back({Type::Sound, info.triggerStartTime, "Attack"});
+    events.push_back({Type::Effect, info.triggerStartTime, std::string(effect), effectAngle});
+    return events;
+}
+}    // namespace
+
 BossPtr Boss::Create(const float3& pos) {
     auto pBoss = Scene::CreateObjectDelayInitialize<Boss>();
     pBoss->SetName("Boss");
@@ -41,11 +89,15 @@ bool Boss::Init() {
         {    STR(BossState::GET_HIT),             "data/LittleQuest/Anim/MutantSet/HeavyHit.mv1", 0, 1.0f},
         {       STR(BossState::DEAD),          "data/LittleQuest/Anim/MutantSet/ZombieDeath.mv1", 0, 1.0f},
     });
-    m_pModel.lock()->PlayAnimation(STR(BossState::IDLE), true);
+    m_pModel.lock()->PlayAnimation(ANIM_IDLE, true);
 
     SetAnimList();
     SetComboList();
 
+    // 攻撃判定・効果音・エフェクトはアニメーションから通知してもらう
+    m_pModel.lock()->SetAnimationEventCallback(
+        [this](AnimId animId, const Animation::Event& event) { OnAnimationEvent(animId, event); });
+
     m_powerUpEffect          = LoadEffekseerEffect("data/LittleQuest/Effect/PowerUp.efk", 20.0f);
     m_punchEffect            = LoadEffekseerEffect("data/LittleQuest/Effect/PunchSprite.efk", 2.5f);
     m_powerPunchEffect       = LoadEffekseerEffect("data/LittleQuest/Effect/PunchSprite2.efk", 2.5f);
@@ -115,7 +167,7 @@ void Boss::Update() {
 void Boss::TransInAction() {
     switch(m_state) {
     case BossState::IDLE:
-        m_pModel.lock()->PlayAnimationNoSame(STR(BossState::IDLE));
+        m_pModel.lock()->PlayAnimationNoSame(ANIM_IDLE);
         break;
     case BossState::TAUNT:
         Taunt();
@@ -152,7 +204,7 @@ void Boss::GameAction() {
         Wait();
         break;
     case BossState::TURN_LEFT:
-        m_pModel.lock()->PlayAnimationNoSame(STR(BossState::TURN_LEFT));
+        m_pModel.lock()->PlayAnimationNoSame(ANIM_TURN_LEFT);
         if(!m_pModel.lock()->IsPlaying()) {
             ChangeState(BossState::WAIT);
         } else {
@@ -160,7 +212,7 @@ void Boss::GameAction() {
         }
         break;
     case BossState::TURN_RIGHT:
-        m_pModel.lock()->PlayAnimationNoSame(STR(BossState::TURN_RIGHT));
+        m_pModel.lock()->PlayAnimationNoSame(ANIM_TURN_RIGHT);
         if(!m_pModel.lock()->IsPlaying()) {
             ChangeState(BossState::WAIT);
         } else {
@@ -223,13 +275,13 @@ void Boss::OnHit([[maybe_unused]] const ComponentCollision::HitInfo& hitInfo) {
 }
 
 void Boss::Idle() {
-    m_pModel.lock()->PlayAnimationNoSame(STR(BossState::IDLE), true);
+    m_pModel.lock()->PlayAnimationNoSame(ANIM_IDLE, true);
 }
 
 void Boss::Wait() {
     m_bossCombo = BossCombo::NONE;
     m_combo     = 0;
-    m_pModel.lock()->PlayAnimationNoSame(STR(BossState::IDLE), true, 0.3f);
+    m_pModel.lock()->PlayAnimationNoSame(ANIM_IDLE, true, 0.3f);
     m_waitFor -= GetDeltaTime60();
 
     if(m_waitFor <= 0.0f || (m_pHP.lock()->GetHPRate() < 50.0f && !m_isAngry)) {
@@ -241,7 +293,7 @@ void Boss::ChasePlayer() {
     float3 move     = m_pPlayer.lock()->GetTranslate() - this->GetTranslate();
     float  distance = GetDistance(move);
 
-    m_pModel.lock()->PlayAnimationNoSame("Walk", true);
+    m_pModel.lock()->PlayAnimationNoSame(ANIM_WALK, true);
 
     if(distance > 0) {
         move = normalize(move);
@@ -412,12 +464,14 @@ void Boss::Attack() {
     }
 }
 
-void Boss::AttackAnimation(std::string animName, AnimInfo& animInfo, std::vector<ComponentCollisionCapsulePtr> atkCol,
-                           bool playSE) {
-    if(m_pModel.lock()->GetPlayAnimationName() != animName) {
-        m_pModel.lock()->PlayAnimationNoSame(animName, false, 0.2F, animInfo.animStartTime);
+void Boss::AttackAnimation(AnimId animId, AnimInfo& animInfo) {
+    if(m_pModel.lock()->GetPlayAnimationId() != animId) {
+        m_pModel.lock()->PlayAnimationNoSame(animId, false, 0.2F, animInfo.animStartTime);
         m_pModel.lock()->SetAnimationSpeed(animInfo.animStartSpeed);
-        m_playedSE = false;
+
+        // 途中で切り替えた前の攻撃の判定を残さない
+        m_pLeftHandBox.lock()->SetHitCollisionGroup((u32)ComponentCollision::CollisionGroup::NONE);
+        m_pRightHandBox.lock()->SetHitCollisionGroup((u32)ComponentCollision::CollisionGroup::NONE);
     }
     m_currAnimTime = m_pModel.lock()->GetAnimationPlayTime();
     if(m_currAnimTime >= animInfo.triggerStartTime) {
@@ -426,70 +480,71 @@ void Boss::AttackAnimation(std::string animName, AnimInfo& animInfo, std::vector
         } else {
             m_pModel.lock()->SetAnimationSpeed(animInfo.animSpeed);
         }
-        for(int i = 0; i < atkCol.size(); i++) {
-            atkCol[i]->SetHitCollisionGroup((u32)ComponentCollision::CollisionGroup::PLAYER);
-        }
-
-        if(!m_playedSE && playSE) {
-            PlaySoundMem(m_attackSE, DX_PLAYTYPE_BACK);
-            ChangeVolumeSoundMem((int)(MAX_VOLUME * (Scene::GetSEVolume() / 100.0f)), m_attackSE);
-            m_playedSE = true;
-        }
-    }
-    if(m_currAnimTime >= animInfo.triggerEndTime) {
-        for(int i = 0; i < atkCol.size(); i++) {
-            atkCol[i]->SetHitCollisionGroup((u32)ComponentCollision::CollisionGroup::NONE);
-        }
     }
+    // 同じアニメーションでもコンボによって切り替えるタイミングが違うため時間で判定
     if(m_currAnimTime >= animInfo.animCutInTime) {
         m_combo++;
         m_isHitPlayer = false;
     }
 }
 
-void Boss::AttackAnimation(std::string animName, AnimInfo& animInfo, bool playSE) {
-    AttackAnimation(animName, animInfo, {}, playSE);
+void Boss::OnAnimationEvent(AnimId animId, const Animation::Event& event) {
+    switch(event.type_) {
+    case Animation::Event::Type::CollisionOn:
+    case Animation::Event::Type::CollisionOff: {
+        std::weak_ptr<ComponentCollisionCapsule> collision;
+        if(event.name_ == COLLISION_LEFT_HAND)
+            collision = m_pLeftHandBox;
+        else if(event.name_ == COLLISION_RIGHT_HAND)
+            collision = m_pRightHandBox;
+
+        if(auto col = collision.lock()) {
+            bool on = event.type_ == Animation::Event::Type::CollisionOn;
+            col->SetHitCollisionGroup(on ? (u32)ComponentCollision::CollisionGroup::PLAYER
+                                         : (u32)ComponentCollision::CollisionGroup::NONE);
+        }
+        break;
+    }
+    case Animation::Event::Type::Sound:
+        PlaySoundMem(m_attackSE, DX_PLAYTYPE_BACK);
+        ChangeVolumeSoundMem((int)(MAX_VOLUME * (Scene::GetSEVolume() / 100.0f)), m_attackSE);
+        break;
+    case Animation::Event::Type::Effect: {
+        int   index = (event.name_ == EFFECT_DOUBLE_PUNCH) ? 2 : 0;
+        float angle = event.value_;
+        // ５連撃の２回目以降の払いは角度を変える
+        if(animId == ANIM_SWIP_ATTACK && m_bossCombo == BossCombo::COMBO5 && m_combo != 1)
+            angle = -80;
+
+        m_playingEffect = PlayEffekseer3DEffect(m_pEffectList[index + m_isAngry]);
+        SetPosPlayingEffekseer3DEffect(m_playingEffect, GetTranslate().x - 15 * sinf(GetRotationAxisXYZ().y * DegToRad),
+                                       GetTranslate().y + 12, GetTranslate().z - 15 * cosf(GetRotationAxisXYZ().y * DegToRad));
+        SetRotationPlayingEffekseer3DEffect(m_playingEffect, 0, GetRotationAxisXYZ().y * DegToRad, angle * DegToRad);
+        break;
+    }
+    default:
+        break;
+    }
 }
 
 void Boss::Combo5() {
     switch(m_combo) {
     case 1:
-        AttackAnimation(STR(BossAnim::SWIP_ATTACK), m_animList[STR(BossAnim::SWIP_ATTACK)], {m_pLeftHandBox.lock()});
-        if(m_currAnimTime >= m_animList[STR(BossAnim::SWIP_ATTACK)].triggerStartTime) {
-            m_playingEffect = PlayEffekseer3DEffect(m_pEffectList[0 + m_isAngry]);
-            SetPosPlayingEffekseer3DEffect(m_playingEffect, GetTranslate().x - 15 * sinf(GetRotationAxisXYZ().y * DegToRad),
-                                           GetTranslate().y + 12,
-                                           GetTranslate().z - 15 * cosf(GetRotationAxisXYZ().y * DegToRad));
-            SetRotationPlayingEffekseer3DEffect(m_playingEffect, 0, GetRotationAxisXYZ().y * DegToRad, -30 * DegToRad);
-        }
+        AttackAnimation(ANIM_SWIP_ATTACK, m_animList[ANIM_SWIP_ATTACK]);
         break;
     case 3:
     case 5:
         if(m_isAngry) {
             SetRotationToPositionWithLimit(m_pPlayer.lock()->GetTranslate(), 1);
         }
-        AttackAnimation(STR(BossAnim::SWIP_ATTACK), m_animList[STR(BossAnim::QUICK_SWIP)], {m_pLeftHandBox.lock()});
-        if(m_currAnimTime >= m_animList[STR(BossAnim::QUICK_SWIP)].triggerStartTime) {
-            m_playingEffect = PlayEffekseer3DEffect(m_pEffectList[0 + m_isAngry]);
-            SetPosPlayingEffekseer3DEffect(m_playingEffect, GetTranslate().x - 15 * sinf(GetRotationAxisXYZ().y * DegToRad),
-                                           GetTranslate().y + 12,
-                                           GetTranslate().z - 15 * cosf(GetRotationAxisXYZ().y * DegToRad));
-            SetRotationPlayingEffekseer3DEffect(m_playingEffect, 0, GetRotationAxisXYZ().y * DegToRad, -80 * DegToRad);
-        }
+        AttackAnimation(ANIM_SWIP_ATTACK, m_animList[ANIM_QUICK_SWIP]);
         break;
     case 2:
     case 4:
         if(m_isAngry) {
             SetRotationToPositionWithLimit(m_pPlayer.lock()->GetTranslate(), 1);
         }
-        AttackAnimation(STR(BossAnim::PUNCH), m_animList[STR(BossAnim::QUICK_PUNCH)], {m_pRightHandBox.lock()});
-        if(m_currAnimTime >= m_animList[STR(BossAnim::QUICK_PUNCH)].triggerStartTime) {
-            m_playingEffect = PlayEffekseer3DEffect(m_pEffectList[0 + m_isAngry]);
-            SetPosPlayingEffekseer3DEffect(m_playingEffect, GetTranslate().x - 15 * sinf(GetRotationAxisXYZ().y * DegToRad),
-                                           GetTranslate().y + 12,
-                                           GetTranslate().z - 15 * cosf(GetRotationAxisXYZ().y * DegToRad));
-            SetRotationPlayingEffekseer3DEffect(m_playingEffect, 0, GetRotationAxisXYZ().y * DegToRad, 80 * DegToRad);
-        }
+        AttackAnimation(ANIM_PUNCH, m_animList[ANIM_QUICK_PUNCH]);
         break;
     default:
         ChangeState(BossState::WAIT);
@@ -504,29 +559,23 @@ void Boss::BackflipPunch() {
     vec.y      = 0;
     switch(m_combo) {
     case 1:
-        AttackAnimation(STR(BossAnim::BACKFLIP), m_animList[STR(BossAnim::BACKFLIP)], true);
+        AttackAnimation(ANIM_BACKFLIP, m_animList[ANIM_BACKFLIP]);
         vec *= 1.0f * GetDeltaTime60();
         AddTranslate(vec);
-        if(m_currAnimTime < m_animList[STR(BossAnim::BACKFLIP)].animCutInTime) {
+        if(m_currAnimTime < m_animList[ANIM_BACKFLIP].animCutInTime) {
             m_pBodyBox.lock()->Overlap((u32)ComponentCollision::CollisionGroup::PLAYER);
         } else {
             m_pBodyBox.lock()->Overlap(!(u32)ComponentCollision::CollisionGroup::PLAYER);
         }
         break;
     case 2:
-        AttackAnimation(STR(BossAnim::DOUBLE_PUNCH), m_animList[STR(BossAnim::DOUBLE_PUNCH)],
-                        {m_pLeftHandBox.lock(), m_pRightHandBox.lock()});
-        if(m_currAnimTime < m_animList[STR(BossAnim::DOUBLE_PUNCH)].triggerStartTime) {
+        AttackAnimation(ANIM_DOUBLE_PUNCH, m_animList[ANIM_DOUBLE_PUNCH]);
+        // 攻撃が始まるまではプレイヤーに詰め寄る
+        if(m_currAnimTime < m_animList[ANIM_DOUBLE_PUNCH].triggerStartTime) {
             float distance = GetDistance(this->GetTranslate(), m_pPlayer.lock()->GetTranslate());
             vec *= distance * -0.25f * GetDeltaTime60();
             AddTranslate(vec);
             SetRotationToPositionWithLimit(m_pPlayer.lock()->GetTranslate(), 10);
-        } else {
-            m_playingEffect = PlayEffekseer3DEffect(m_pEffectList[2 + m_isAngry]);
-            SetPosPlayingEffekseer3DEffect(m_playingEffect, GetTranslate().x - 15 * sinf(GetRotationAxisXYZ().y * DegToRad),
-                                           GetTranslate().y + 12,
-                                           GetTranslate().z - 15 * cosf(GetRotationAxisXYZ().y * DegToRad));
-            SetRotationPlayingEffekseer3DEffect(m_playingEffect, 0, GetRotationAxisXYZ().y * DegToRad, 0);
         }
         break;
     default:
@@ -542,22 +591,16 @@ void Boss::ChargePunch() {
     vec.y      = 0;
     switch(m_combo) {
     case 1:
-        AttackAnimation(STR(BossAnim::CHARGE), m_animList[STR(BossAnim::CHARGE)], false);
+        AttackAnimation(ANIM_CHARGE, m_animList[ANIM_CHARGE]);
         break;
     case 2:
-        AttackAnimation(STR(BossAnim::DOUBLE_PUNCH), m_animList[STR(BossAnim::DOUBLE_PUNCH)],
-                        {m_pLeftHandBox.lock(), m_pRightHandBox.lock()});
-        if(m_currAnimTime < m_animList[STR(BossAnim::DOUBLE_PUNCH)].triggerStartTime) {
+        AttackAnimation(ANIM_DOUBLE_PUNCH, m_animList[ANIM_DOUBLE_PUNCH]);
+        // 攻撃が始まるまではプレイヤーに詰め寄る
+        if(m_currAnimTime < m_animList[ANIM_DOUBLE_PUNCH].triggerStartTime) {
             float distance = GetDistance(this->GetTranslate(), m_pPlayer.lock()->GetTranslate());
             vec *= distance * -0.25f * GetDeltaTime60();
             AddTranslate(vec);
             SetRotationToPositionWithLimit(m_pPlayer.lock()->GetTranslate(), 10);
-        } else {
-            m_playingEffect = PlayEffekseer3DEffect(m_pEffectList[2 + m_isAngry]);
-            SetPosPlayingEffekseer3DEffect(m_playingEffect, GetTranslate().x - 15 * sinf(GetRotationAxisXYZ().y * DegToRad),
-                                           GetTranslate().y + 12,
-                                           GetTranslate().z - 15 * cosf(GetRotationAxisXYZ().y * DegToRad));
-            SetRotationPlayingEffekseer3DEffect(m_playingEffect, 0, GetRotationAxisXYZ().y * DegToRad, 0);
         }
         break;
     default:
@@ -571,26 +614,12 @@ void Boss::Swip() {
     float distance;
     switch(m_combo) {
     case 1:
-        AttackAnimation(STR(BossAnim::SWIP_ATTACK), m_animList[STR(BossAnim::SWIP_ATTACK)], {m_pLeftHandBox.lock()});
-        if(m_currAnimTime >= m_animList[STR(BossAnim::SWIP_ATTACK)].triggerStartTime) {
-            m_playingEffect = PlayEffekseer3DEffect(m_pEffectList[0 + m_isAngry]);
-            SetPosPlayingEffekseer3DEffect(m_playingEffect, GetTranslate().x - 15 * sinf(GetRotationAxisXYZ().y * DegToRad),
-                                           GetTranslate().y + 12,
-                                           GetTranslate().z - 15 * cosf(GetRotationAxisXYZ().y * DegToRad));
-            SetRotationPlayingEffekseer3DEffect(m_playingEffect, 0, GetRotationAxisXYZ().y * DegToRad, -30 * DegToRad);
-        }
+        AttackAnimation(ANIM_SWIP_ATTACK, m_animList[ANIM_SWIP_ATTACK]);
         break;
     case 2:
         distance = GetDistance(this->GetTranslate(), m_pPlayer.lock()->GetTranslate());
         if(distance < 50) {
-            AttackAnimation(STR(BossAnim::PUNCH), m_animList[STR(BossAnim::PUNCH)], {m_pRightHandBox.lock()});
-            if(m_currAnimTime >= m_animList[STR(BossAnim::PUNCH)].triggerStartTime) {
-                m_playingEffect = PlayEffekseer3DEffect(m_pEffectList[0 + m_isAngry]);
-                SetPosPlayingEffekseer3DEffect(m_playingEffect, GetTranslate().x - 15 * sinf(GetRotationAxisXYZ().y * DegToRad),
-                                               GetTranslate().y + 12,
-                                               GetTranslate().z - 15 * cosf(GetRotationAxisXYZ().y * DegToRad));
-                SetRotationPlayingEffekseer3DEffect(m_playingEffect, 0, GetRotationAxisXYZ().y * DegToRad, 80 * DegToRad);
-            }
+            AttackAnimation(ANIM_PUNCH, m_animList[ANIM_PUNCH]);
         } else {
             m_combo++;
         }
@@ -617,7 +646,7 @@ void Boss::RangedShot() {
 void Boss::ChargeExplode() {
     switch(m_combo) {
     case 1:
-        AttackAnimation(STR(BossAnim::EXPLODE_CHARGE), m_animList[STR(BossAnim::EXPLODE_CHARGE)], {m_pLeftHandBox.lock()});
+        AttackAnimation(ANIM_EXPLODE_CHARGE, m_animList[ANIM_EXPLODE_CHARGE]);
         break;
     default:
         ChangeState(BossState::WAIT);
@@ -629,7 +658,7 @@ void Boss::ChargeExplode() {
 void Boss::Taunt() {
     switch(m_combo) {
     case 1:
-        AttackAnimation(STR(BossAnim::TAUNT_ANIM), m_animList[STR(BossAnim::TAUNT_ANIM)], false);
+        AttackAnimation(ANIM_TAUNT_ANIM, m_animList[ANIM_TAUNT_ANIM]);
         break;
     default:
         ChangeState(BossState::IDLE);
@@ -638,10 +667,10 @@ void Boss::Taunt() {
 }
 
 void Boss::PowerUp() {
-    m_pModel.lock()->PlayAnimationNoSame(STR(BossAnim::CHARGE));
+    m_pModel.lock()->PlayAnimationNoSame(ANIM_CHARGE);
     m_currAnimTime = m_pModel.lock()->GetAnimationPlayTime();
-    if(m_currAnimTime > m_animList[STR(BossAnim::ANGRY_AURA)].triggerStartTime) {
-        m_pModel.lock()->SetAnimationSpeed(m_animList[STR(BossAnim::ANGRY_AURA)].animSpeed);
+    if(m_currAnimTime > m_animList[ANIM_ANGRY_AURA].triggerStartTime) {
+        m_pModel.lock()->SetAnimationSpeed(m_animList[ANIM_ANGRY_AURA].animSpeed);
         if(m_pAngryBox.expired()) {
             m_pAngryBox = AddComponent<ComponentCollisionSphere>();
             m_pAngryBox.lock()->SetTranslate({0, 0, 0});
@@ -657,14 +686,14 @@ void Boss::PowerUp() {
             SetPosPlayingEffekseer3DEffect(m_playingEffect, GetTranslate().x, GetTranslate().y, GetTranslate().z);
         }
     }
-    if(m_currAnimTime > m_animList[STR(BossAnim::ANGRY_AURA)].triggerEndTime) {
+    if(m_currAnimTime > m_animList[ANIM_ANGRY_AURA].triggerEndTime) {
         if(!m_pAngryBox.expired()) {
             RemoveComponent(m_pAngryBox.lock());
             m_pAngryBox.reset();
             StopEffekseer3DEffect(m_playingEffect);
         }
     }
-    if(m_currAnimTime > m_animList[STR(BossAnim::ANGRY_AURA)].animCutInTime) {
+    if(m_currAnimTime > m_animList[ANIM_ANGRY_AURA].animCutInTime) {
         m_combo++;
         m_isHitPlayer = false;
     }
@@ -703,7 +732,7 @@ void Boss::GetHit(int damage) {
 void Boss::Damaging() {
     switch(m_combo) {
     case 1:
-        AttackAnimation(STR(BossState::GET_HIT), m_animList[STR(BossState::GET_HIT)], false);
+        AttackAnimation(ANIM_GET_HIT, m_animList[ANIM_GET_HIT]);
         break;
     default:
         ChangeState(BossState::WAIT);
@@ -713,7 +742,7 @@ void Boss::Damaging() {
 }
 
 void Boss::Die() {
-    m_pModel.lock()->PlayAnimationNoSame(STR(BossState::DEAD));
+    m_pModel.lock()->PlayAnimationNoSame(ANIM_DEAD);
     if(m_slowMotion) {
         m_pModel.lock()->SetAnimationSpeed(0.1f);
     } else {
@@ -741,7 +770,7 @@ void Boss::PlayDead() {
 }
 
 bool Boss::IsPlayedTaunt() {
-    if(m_pModel.lock()->GetOldPlayAnimationName() == STR(BossAnim::TAUNT_ANIM)) {
+    if(m_pModel.lock()->GetOldPlayAnimationId() == ANIM_TAUNT_ANIM) {
         ChangeState(BossState::WAIT);
         return true;
     }
@@ -788,13 +817,14 @@ void Boss::SetAnimList() {
     info.animSpeed        = 1.2f;
     info.animStartSpeed   = 2.0f;
 
-    m_animList[STR(BossAnim::SWIP_ATTACK)] = info;
+    m_animList[ANIM_SWIP_ATTACK] = info;
+    m_pModel.lock()->SetAnimationEvents(ANIM_SWIP_ATTACK, AttackEvents(info, {COLLISION_LEFT_HAND}, "Swip", -30));
 
     info.animStartSpeed = 1.0f;
     info.animStartTime  = 75;
     info.animCutInTime  = 83;
 
-    m_animList[STR(BossAnim::QUICK_SWIP)] = info;
+    m_animList[ANIM_QUICK_SWIP] = info;
 
     info                  = {};
     info.triggerStartTime = 15;
@@ -803,20 +833,23 @@ void Boss::SetAnimList() {
     info.animStartSpeed   = 1.0f;
     info.animSpeed        = 1.0f;
 
-    m_animList[STR(BossAnim::PUNCH)] = info;
+    m_animList[ANIM_PUNCH] = info;
+    m_pModel.lock()->SetAnimationEvents(ANIM_PUNCH, AttackEvents(info, {COLLISION_RIGHT_HAND}, "Punch", 80));
 
     info.animStartTime  = 15;
     info.triggerEndTime = 20;
     info.animCutInTime  = 20;
 
-    m_animList[STR(BossAnim::QUICK_PUNCH)] = info;
+    m_animList[ANIM_QUICK_PUNCH] = info;
 
     info               = {};
     info.animStartTime = 27;
     info.animCutInTime = 90;
     info.animSpeed     = 2.0f;
 
-    m_animList[STR(BossAnim::BACKFLIP)] = info;
+    m_animList[ANIM_BACKFLIP] = info;
+    // 効果音のみ (再生開始と同時)
+    m_pModel.lock()->SetAnimationEvents(ANIM_BACKFLIP, {{Animation::Event::Type::Sound, info.animStartTime, "Attack"}});
 
     info                  = {};
     info.animStartTime    = 100;
@@ -826,7 +859,9 @@ void Boss::SetAnimList() {
     info.animSpeed        = 2.0f;
     info.animStartSpeed   = 6.0f;
 
-    m_animList[STR(BossAnim::DOUBLE_PUNCH)] = info;
+    m_animList[ANIM_DOUBLE_PUNCH] = info;
+    m_pModel.lock()->SetAnimationEvents(ANIM_DOUBLE_PUNCH, AttackEvents(info, {COLLISION_LEFT_HAND, COLLISION_RIGHT_HAND},
+                                                                        EFFECT_DOUBLE_PUNCH, 0));
 
     info                  = {};
     info.triggerStartTime = 20;
@@ -834,14 +869,14 @@ void Boss::SetAnimList() {
     info.animStartSpeed   = 0.8f;
     info.animSpeed        = 1.0f;
 
-    m_animList[STR(BossAnim::CHARGE)] = info;
+    m_animList[ANIM_CHARGE] = info;
 
     info                  = {};
     info.triggerStartTime = 205;
     info.animStartSpeed   = 0.5f;
     info.animSpeed        = 1.0f;
 
-    m_animList[STR(BossAnim::EXPLODE_CHARGE)] = info;
+    m_animList[ANIM_EXPLODE_CHARGE] = info;
 
     info                  = {};
     info.triggerStartTime = 27;
@@ -849,19 +884,22 @@ void Boss::SetAnimList() {
     info.animCutInTime    = 170;
     info.animStartSpeed   = 0.5f;
 
-    m_animList[STR(BossAnim::ANGRY_AURA)] = info;
+    m_animList[ANIM_ANGRY_AURA] = info;
 
     info                = {};
     info.animCutInTime  = 170;
     info.animStartSpeed = 2.0f;
     info.animSpeed      = 2.0f;
 
-    m_animList[STR(BossAnim::TAUNT_ANIM)] = info;
+    m_animList[ANIM_TAUNT_ANIM] = info;
 
     info               = {};
     info.animCutInTime = 167;
 
-    m_animList[STR(BossState::GET_HIT)] = info;
+    m_animList[ANIM_GET_HIT] = info;
+
+    // ファイルがあればタイミングを上書き
+    m_pModel.lock()->LoadAnimationEvents(EVENT_FILE);
 }
 
 void Boss::SetComboList() {
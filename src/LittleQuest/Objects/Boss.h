@@ -193,7 +193,7 @@ class Boss: public Object {
     //! 怒り爆発のコリションボックス
     std::weak_ptr<ComponentCollisionSphere>   m_pAngryBox;
     //! アニメーション名とアニメーション情報のマップ
-    std::unordered_map<std::string, AnimInfo> m_animList;
+    std::unordered_map<AnimId, AnimInfo>      m_animList;
     //! 攻撃方法と攻撃力のマップ
     std::unordered_map<BossCombo, float>      m_comboList;
 
@@ -246,8 +246,6 @@ class Boss: public Object {
     bool   m_isDead      = false;
     //! 怒っているのか
     bool   m_isAngry     = false;
-    //! サウンドエフェクトが再生しているのか
-    bool   m_playedSE    = false;
 
     //bool m_bigExplode = false;
     //! スローモーション
@@ -294,21 +292,17 @@ class Boss: public Object {
     //------------------------------------------------------------
     //! @brief 攻撃のアニメーション
     //!
-    //! @param animName アニメーション名
+    //! @param animId アニメーションID
     //! @param animInfo アニメーション情報
-    //! @param atkCol 攻撃を判定するコリション
-    //! @param playSE サウンドエフェクトを再生するか
     //------------------------------------------------------------
-    void AttackAnimation(std::string animName, AnimInfo& animInfo, std::vector<ComponentCollisionCapsulePtr> atkCol = {},
-                         bool playSE = true);
+    void AttackAnimation(AnimId animId, AnimInfo& animInfo);
     //------------------------------------------------------------
-    //! @brief 攻撃のアニメーション
+    //! @brief アニメーションイベントを処理します。
     //!
-    //! @param animName アニメーション名
-    //! @param animInfo アニメーション情報
-    //! @param playSE サウンドエフェクトを再生するか
+    //! @param animId イベントが発生したアニメーションID
+    //! @param event イベント (攻撃判定・効果音・エフェクト)
     //------------------------------------------------------------
-    void AttackAnimation(std::string animName, AnimInfo& animInfo, bool playSE);
+    void OnAnimationEvent(AnimId animId, const Animation::Event& event);
     //------------------------------------------------------------
     //! @brief ５連撃
     //------------------------------------------------------------
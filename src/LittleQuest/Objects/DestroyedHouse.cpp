@@ -2,6 +2,7 @@
 
 #include <System/Component/ComponentAttachModel.h>
 #include <System/Component/ComponentCollisionModel.h>
+#include <System/Component/ComponentInstancedModel.h>
 #include <System/Component/ComponentModel.h>
 
 namespace LittleQuest {
@@ -9,7 +10,7 @@ DestroyedHousePtr DestroyedHouse::Create(std::string name, const float3& pos) {
     auto obj = Scene::CreateObjectPtr<DestroyedHouse>();
     obj->SetName(name);
     obj->SetTranslate(pos);
-    obj->AddComponent<ComponentModel>("data/LittleQuest/Model/DestroyedHouse/DestroyedHouse.mv1");
+    obj->AddComponent<ComponentInstancedModel>("data/LittleQuest/Model/DestroyedHouse/DestroyedHouse.mv1");
 
     obj->m_pBox = Scene::CreateObjectPtr<Object>("DestroyedHouseBox");
     obj->m_pBox->AddComponent<ComponentModel>("data/Sample/SwordBout/Stage/Stage_Obj009_c.mv1");
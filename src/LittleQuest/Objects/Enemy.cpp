@@ -14,7 +14,41 @@
 #include <System/Component/ComponentTargetTracking.h>
 
 namespace LittleQuest {
+EnemyPtr Enemy::Create(const float3& pos, bool isPatrol, bool isBoss) {
+    auto pEnemy = Scene::CreateObjectDelayInitialize<Enemy>();
+    pEnemy->SetName("Enemy");
+    pEnemy->SetTranslate(pos);
+    pEnemy->spawnPos = pos;
+    pEnemy->isPatrol = isPatrol;
+    pEnemy->isBoss   = isBoss;
+
+    return pEnemy;
+}
+
 bool Enemy::Init() {
+    pModel = AddComponent<ComponentModel>("data/LittleQuest/Model/Mutant/Mutant.mv1");
+    pModel.lock()->SetScaleAxisXYZ({0.08f});
+    pModel.lock()->SetAnimation({
+        {  "idle",    "data/LittleQuest/Anim/MutantSet/MutantIdle.mv1", 0, 1.0f},
+        {  "walk", "data/LittleQuest/Anim/MutantSet/MutantWalking.mv1", 0, 1.0f},
+        {   "run",     "data/LittleQuest/Anim/MutantSet/MutantRun.mv1", 0, 1.0f},
+        {"attack", "data/LittleQuest/Anim/MutantSet/MutantSwiping.mv1", 0, 1.0f},
+        {"getHit",      "data/LittleQuest/Anim/MutantSet/HeavyHit.mv1", 0, 1.0f},
+        {   "die",   "data/LittleQuest/Anim/MutantSet/MutantDying.mv1", 0, 1.0f},
+    });
+    pModel.lock()->PlayAnimation("idle", true);
+
+    auto pBodyBox = AddComponent<ComponentCollisionCapsule>();
+    pBodyBox->UseGravity();
+    pBodyBox->SetHeight(12);
+    pBodyBox->SetRadius(3);
+    pBodyBox->SetMass(50.0f);
+    pBodyBox->SetCollisionGroup(ComponentCollision::CollisionGroup::ENEMY);
+
+    pHP = AddComponent<ComponentHP>();
+    pHP.lock()->SetType(isBoss ? ComponentHP::HP_TYPE::BOSS : ComponentHP::HP_TYPE::PLAYER);
+    pHP.lock()->SetHP(maxHP);
+
     prevState = state = EnemyState::IDLE;
 
     if(isPatrol) {
@@ -98,10 +132,14 @@ void Enemy::LateDraw() {
         printfDx("\nz distance: %f", float3(goal - GetTranslate())[2]);
         printfDx("\nf(distance): %f", GetDistance(GetTranslate(), goal));
         printfDx("\nisFound: %i", isFoundPlayer);
-        printfDx("\ntargetDegree: %f", GetDegreeToPosition(pPlayer.lock()->GetTranslate()));
+        if(auto player = pPlayer.lock())
+            printfDx("\ntargetDegree: %f", GetDegreeToPosition(player->GetTranslate()));
         printfDx("\ndie timer: %f", destroyTimer);
     }
-    pHP.lock()->DrawHPBar();
+
+    // HPゲージは画面固定の表示なのでボスのみ
+    if(isBoss)
+        pHP.lock()->DrawHPBar();
 }
 
 void Enemy::GUI() {
@@ -120,8 +158,13 @@ void Enemy::Idle() {
 }
 
 bool Enemy::FindPlayer() {
-    float distance = GetDistance(pPlayer.lock()->GetTranslate(), this->GetTranslate());
-    if(distance < 50 && GetDegreeToPosition(pPlayer.lock()->GetTranslate()) < 50) {
+    // プレイヤーがいないシーンでは巡回のみ
+    auto player = pPlayer.lock();
+    if(!player)
+        return false;
+
+    float distance = GetDistance(player->GetTranslate(), this->GetTranslate());
+    if(distance < 50 && GetDegreeToPosition(player->GetTranslate()) < 50) {
         ChangeState(EnemyState::CHASING);
         return true;
     } else if(prevState == EnemyState::CHASING) {
@@ -143,6 +186,7 @@ void Enemy::BackToInitialPosition(float3& move) {
 
         this->SetRotationAxisXYZ({0, theta, 0});
         speedFactor = runVal;
+        pModel.lock()->PlayAnimationNoSame("run", true);
     } else {
         this->ChangeState(initialState);
     }
@@ -171,6 +215,7 @@ void Enemy::Patrol(float3& move) {
 
         SetRotationAxisXYZ({0, theta, 0});
         speedFactor = walkVal;
+        pModel.lock()->PlayAnimationNoSame("walk", true);
     }
 }
 
@@ -55,6 +55,7 @@ class Enemy: public Object {
     float3              spawnPos;
     float3              goal;
     bool                isPatrol;
+    bool                isBoss = false;
     std::vector<float3> patrolPoint;
     int                 patrolIndex;
     float               waitTime;
@@ -69,6 +70,8 @@ class Enemy: public Object {
     const float runVal      = 1.f;
     float       speedFactor = 1.0f;
 
+    const int maxHP = 100;
+
     bool  isDead       = false;
     float destroyTimer = 5;
 
@@ -2,6 +2,7 @@
 
 #include <System/Component/ComponentAttachModel.h>
 #include <System/Component/ComponentCollisionModel.h>
+#include <System/Component/ComponentInstancedModel.h>
 #include <System/Component/ComponentModel.h>
 
 namespace LittleQuest {
@@ -9,7 +10,7 @@ FencePtr Fence::Create(const float3& pos) {
     auto obj = Scene::CreateObjectPtr<Fence>();
     obj->SetName("Fence");
     obj->SetTranslate(pos);
-    obj->AddComponent<ComponentModel>("data/Sample/SwordBout/Stage/Stage_Obj009.mv1");
+    obj->AddComponent<ComponentInstancedModel>("data/Sample/SwordBout/Stage/Stage_Obj009.mv1");
 
     obj->m_pBox = Scene::CreateObjectPtr<Object>("FenceBox");
     obj->m_pBox->AddComponent<ComponentModel>("data/Sample/SwordBout/Stage/Stage_Obj009_c.mv1");
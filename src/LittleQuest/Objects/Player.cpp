@@ -16,6 +16,40 @@
 #include <System/Component/ComponentSpringArm.h>
 
 namespace LittleQuest {
+namespace {
+//! アニメーションID (SetAnimation()で登録する名前)
+const AnimId ANIM_IDLE(STR(PlayerState::IDLE));
+const AnimId ANIM_ROLL(STR(PlayerState::ROLL));
+const AnimId ANIM_GET_HIT(STR(PlayerState::GET_HIT));
+const AnimId ANIM_WALK(STR(PlayerState::WALK));
+const AnimId ANIM_NORMAL_COMBO1(STR(Combo::NORMAL_COMBO1));
+const AnimId ANIM_NORMAL_COMBO2(STR(Combo::NORMAL_COMBO2));
+const AnimId ANIM_NORMAL_COMBO3(STR(Combo::NORMAL_COMBO3));
+const AnimId ANIM_NORMAL_COMBO4(STR(Combo::NORMAL_COMBO4));
+const AnimId ANIM_SPECIAL_ATTACK(STR(Combo::SPECIAL_ATTACK));
+const AnimId ANIM_SPECIAL_CHARGE(STR(Combo::SPECIAL_CHARGE));
+const AnimId ANIM_DEAD(STR(PlayerState::DEAD));
+
+//! 次の攻撃に移れるタイミングの通知名
+constexpr std::string_view EVENT_CUT_IN = "CutIn";
+
+//! イベントトラックのファイル (あればコードの設定より優先)
+constexpr std::string_view EVENT_FILE = "data/LittleQuest/Anim/PlayerEvents.txt";
+
+//! 攻撃アニメーションのイベントトラック
+//! @param info タイミング
+//! @param effectAngle 斬撃エフェクトの角度
+std::vector<Animation::Event> AttackEvents(const AnimInfo& info, float effectAngle) {
+    using Type = Animation::Event::Type;
+    return {
+        {Type::CollisionOn,  info.triggerStartTime, "Weapon"},
+        {      Type::Sound,  info.triggerStartTime,  "Swing"},
+        {     Type::Effect,  info.triggerStartTime,  "Slash", effectAngle},
+        {Type::CollisionOff,   info.triggerEndTime, "Weapon"},
+        {     Type::Notify,    info.animCutInTime, std::string(EVENT_CUT_IN)},
+    };
+}
+}    // namespace
 
 static std::string_view colName = "";
 PlayerPtr               Player::Create(const float3& pos) {
@@ -45,11 +79,16 @@ bool Player::Init() {
         { STR(PlayerState::GET_HIT),    "data/LittleQuest/Anim/KachujinSet/HitToBody.mv1", 0, 3.0f},
         {    STR(PlayerState::DEAD),   "data/LittleQuest/Anim/KachujinSet/SwordDeath.mv1", 0, 1.0f},
     });
-    m_pModel.lock()->PlayAnimationNoSame(STR(PlayerState::IDLE), true);
+    m_pModel.lock()->PlayAnimationNoSame(ANIM_IDLE, true);
 
     SetAnimInfo();
     SetComboList();
 
+    // 攻撃のタイミングはアニメーションから通知してもらう
+    m_pModel.lock()->SetAnimationEventCallback(
+        [this](AnimId animId, const Animation::Event& event) { OnAnimationEvent(animId, event); });
+    m_pModel.lock()->LoadAnimationEvents(EVENT_FILE);
+
     {
         auto sword = Scene::CreateObjectPtr<Object>("Katana");
         auto model = sword->AddComponent<ComponentModel>();
@@ -171,7 +210,7 @@ void Player::GameAction() {
         Attack();
         break;
     case PlayerState::ROLL:
-        m_pModel.lock()->PlayAnimationNoSame(STR(PlayerState::ROLL));
+        m_pModel.lock()->PlayAnimationNoSame(ANIM_ROLL);
         m_currCombo = Combo::NO_COMBO;
         m_pWeapon.lock()->SetHitCollisionGroup((u32)ComponentCollision::CollisionGroup::NONE);
         if(m_pModel.lock()->IsPlaying()) {
@@ -227,35 +266,6 @@ void Player::LateDraw() {
 }
 
 void Player::OnHit([[maybe_unused]] const ComponentCollision::HitInfo& hitInfo) {
-    if((u32)hitInfo.collision_->GetCollisionGroup() & (u32)ComponentCollision::CollisionGroup::WEAPON) {
-        auto* owner = hitInfo.hit_collision_->GetOwner();
-
-        Boss* boss;
-        if((boss = dynamic_cast<Boss*>(owner)) && m_currCombo != Combo::NO_COMBO) {
-            bool inList = false;
-            for(int i = 0; i < m_attackList.size(); i++) {
-                if(m_attackList[i] == boss->GetName().data()) {
-                    inList = true;
-                    break;
-                }
-            }
-
-            if(!inList) {
-                m_attackList.push_back(boss->GetName().data());
-                boss->GetHit((int)(this->BASE_ATK * m_comboList[m_currCombo] * m_pCombo.lock()->ComboBuff()));
-                m_isHit = true;
-                m_hitTimer += HIT_PAUSE;
-                m_pCombo.lock()->AddCombo(m_comboList[m_currCombo]);
-                m_playingEffect = PlayEffekseer3DEffect(m_hitEffect);
-                PlaySoundMem(m_swordHitSE, DX_PLAYTYPE_BACK);
-                ChangeVolumeSoundMem((int)(MAX_VOLUME * (Scene::GetSEVolume() / 100.0f)), m_swordHitSE);
-                SetPosPlayingEffekseer3DEffect(m_playingEffect, hitInfo.hit_position_.x, hitInfo.hit_position_.y,
-                                               hitInfo.hit_position_.z);
-                m_pCamera.lock()->SetCameraShake(15, 5);
-                m_pCamera.lock()->ShakeCamera();
-            }
-        }
-    }
     if(m_pCamera.lock()) {
         if((u32)hitInfo.collision_->GetCollisionGroup() & (u32)ComponentCollision::CollisionGroup::ETC) {
             if(hitInfo.hit_) {
@@ -285,7 +295,28 @@ void Player::OnHit([[maybe_unused]] const ComponentCollision::HitInfo& hitInfo)
     Super::OnHit(hitInfo);
 }
 
-void Player::ExitHit(const ComponentCollision::HitInfo& hitInfo) {}
+void Player::OnHitEnter(const ComponentCollision::ContactInfo& contactInfo) {
+    // 武器が当たり始めた時だけダメージを与える
+    // (攻撃ごとに武器の当たりを切り替えるので、1回の攻撃で1度だけになる)
+    if(((u32)contactInfo.collision_->GetCollisionGroup() & (u32)ComponentCollision::CollisionGroup::WEAPON) == 0)
+        return;
+
+    auto* boss = dynamic_cast<Boss*>(contactInfo.hit_collision_->GetOwner());
+    if(boss == nullptr || m_currCombo == Combo::NO_COMBO)
+        return;
+
+    boss->GetHit((int)(this->BASE_ATK * m_comboList[m_currCombo] * m_pCombo.lock()->ComboBuff()));
+    m_isHit = true;
+    m_hitTimer += HIT_PAUSE;
+    m_pCombo.lock()->AddCombo(m_comboList[m_currCombo]);
+    m_playingEffect = PlayEffekseer3DEffect(m_hitEffect);
+    PlaySoundMem(m_swordHitSE, DX_PLAYTYPE_BACK);
+    ChangeVolumeSoundMem((int)(MAX_VOLUME * (Scene::GetSEVolume() / 100.0f)), m_swordHitSE);
+    SetPosPlayingEffekseer3DEffect(m_playingEffect, contactInfo.hit_position_.x, contactInfo.hit_position_.y,
+                                   contactInfo.hit_position_.z);
+    m_pCamera.lock()->SetCameraShake(15, 5);
+    m_pCamera.lock()->ShakeCamera();
+}
 
 void Player::GetHit(int damage) {
     if(m_isInvincible) {
@@ -300,7 +331,7 @@ void Player::GetHit(int damage) {
         return;
     }
 
-    m_pModel.lock()->PlayAnimation(STR(PlayerState::GET_HIT));
+    m_pModel.lock()->PlayAnimation(ANIM_GET_HIT);
     m_pWeapon.lock()->SetHitCollisionGroup((u32)ComponentCollision::CollisionGroup::NONE);
     m_playerState = PlayerState::GET_HIT;
     m_currCombo   = Combo::NO_COMBO;
@@ -412,7 +443,7 @@ void Player::InputHandle() {
 void Player::LockOnCamera() {}
 
 void Player::Idle() {
-    m_pModel.lock()->PlayAnimationNoSame(STR(PlayerState::IDLE), true, 0.5f);
+    m_pModel.lock()->PlayAnimationNoSame(ANIM_IDLE, true, 0.5f);
 }
 
 void Player::Walk() {
@@ -421,101 +452,34 @@ void Player::Walk() {
     m_movement *= BASE_SPEED * m_speedFactor * GetDeltaTime();
     AddTranslate(m_movement);
 
-    m_pModel.lock()->PlayAnimationNoSame(STR(PlayerState::WALK), true, 0.2f, 14.0f);
+    m_pModel.lock()->PlayAnimationNoSame(ANIM_WALK, true, 0.2f, 14.0f);
     m_pModel.lock()->SetAnimationSpeed(GetDistance(m_movement) * 5.0f);
 }
 
 void Player::Attack() {
+    // 攻撃判定・効果音・エフェクトはアニメーションイベントで行う (OnAnimationEvent)
     switch(m_currCombo) {
     case Combo::NORMAL_COMBO1:
-        AttackAnimation(STR(Combo::NORMAL_COMBO1), m_animList[STR(Combo::NORMAL_COMBO1)], Combo::NORMAL_COMBO2);
-        if(m_currAnimTime > m_animList[STR(Combo::NORMAL_COMBO1)].triggerStartTime) {
-            if(!m_playedFX) {
-                m_playingEffect = PlayEffekseer3DEffect(m_pEffectList[(int)m_pCombo.lock()->ComboBuff() - 1]);
-                SetPosPlayingEffekseer3DEffect(m_playingEffect, GetTranslate().x, GetTranslate().y + 6, GetTranslate().z);
-                SetRotationPlayingEffekseer3DEffect(m_playingEffect, 0, (m_pModel.lock()->GetRotationAxisXYZ().y) * DegToRad,
-                                                    0);
-
-                PlaySoundMem(m_swordSE, DX_PLAYTYPE_BACK);
-                ChangeVolumeSoundMem((int)(MAX_VOLUME * (Scene::GetSEVolume() / 100.0f)), m_swordSE);
-                m_playedFX = true;
-            }
-        }
+        AttackAnimation(ANIM_NORMAL_COMBO1, m_animList[ANIM_NORMAL_COMBO1], Combo::NORMAL_COMBO2);
         break;
     case Combo::NORMAL_COMBO2:
-        AttackAnimation(STR(Combo::NORMAL_COMBO2), m_animList[STR(Combo::NORMAL_COMBO2)], Combo::NORMAL_COMBO3);
-        if(m_currAnimTime > m_animList[STR(Combo::NORMAL_COMBO2)].triggerStartTime) {
-            if(!m_playedFX) {
-                m_playingEffect = PlayEffekseer3DEffect(m_pEffectList[(int)m_pCombo.lock()->ComboBuff() - 1]);
-                SetPosPlayingEffekseer3DEffect(m_playingEffect, GetTranslate().x, GetTranslate().y + 6, GetTranslate().z);
-                SetRotationPlayingEffekseer3DEffect(m_playingEffect, 0, (m_pModel.lock()->GetRotationAxisXYZ().y) * DegToRad,
-                                                    180 * DegToRad);
-                PlaySoundMem(m_swordSE, DX_PLAYTYPE_BACK);
-                ChangeVolumeSoundMem((int)(MAX_VOLUME * (Scene::GetSEVolume() / 100.0f)), m_swordSE);
-                m_playedFX = true;
-            }
-        }
+        AttackAnimation(ANIM_NORMAL_COMBO2, m_animList[ANIM_NORMAL_COMBO2], Combo::NORMAL_COMBO3);
         break;
     case Combo::NORMAL_COMBO3:
-        AttackAnimation(STR(Combo::NORMAL_COMBO3), m_animList[STR(Combo::NORMAL_COMBO3)], Combo::NORMAL_COMBO4);
-        if(m_currAnimTime > m_animList[STR(Combo::NORMAL_COMBO3)].triggerStartTime) {
-            if(!m_playedFX) {
-                m_playingEffect = PlayEffekseer3DEffect(m_pEffectList[(int)m_pCombo.lock()->ComboBuff() - 1]);
-                SetPosPlayingEffekseer3DEffect(m_playingEffect, GetTranslate().x, GetTranslate().y + 6, GetTranslate().z);
-                SetRotationPlayingEffekseer3DEffect(m_playingEffect, 0, (m_pModel.lock()->GetRotationAxisXYZ().y) * DegToRad,
-                                                    -50 * DegToRad);
-                PlaySoundMem(m_swordSE, DX_PLAYTYPE_BACK);
-                ChangeVolumeSoundMem((int)(MAX_VOLUME * (Scene::GetSEVolume() / 100.0f)), m_swordSE);
-                m_playedFX = true;
-            }
-        }
+        AttackAnimation(ANIM_NORMAL_COMBO3, m_animList[ANIM_NORMAL_COMBO3], Combo::NORMAL_COMBO4);
         break;
     case Combo::NORMAL_COMBO4:
-        AttackAnimation(STR(Combo::NORMAL_COMBO4), m_animList[STR(Combo::NORMAL_COMBO4)]);
-        if(m_currAnimTime > m_animList[STR(Combo::NORMAL_COMBO4)].triggerStartTime) {
-            if(!m_playedFX) {
-                m_playingEffect = PlayEffekseer3DEffect(m_pEffectList[(int)m_pCombo.lock()->ComboBuff() - 1]);
-                SetPosPlayingEffekseer3DEffect(m_playingEffect, GetTranslate().x, GetTranslate().y + 6, GetTranslate().z);
-                SetRotationPlayingEffekseer3DEffect(m_playingEffect, 0, (m_pModel.lock()->GetRotationAxisXYZ().y) * DegToRad,
-                                                    52 * DegToRad);
-                PlaySoundMem(m_swordSE, DX_PLAYTYPE_BACK);
-                ChangeVolumeSoundMem((int)(MAX_VOLUME * (Scene::GetSEVolume() / 100.0f)), m_swordSE);
-                m_playedFX = true;
-            }
-        }
+        AttackAnimation(ANIM_NORMAL_COMBO4, m_animList[ANIM_NORMAL_COMBO4]);
         break;
     case Combo::SPECIAL_ATTACK:
         if(m_isCombo) {
-            AttackAnimation(STR(Combo::SPECIAL_ATTACK), m_animList[STR(Combo::SPECIAL_ATTACK)], Combo::SPECIAL_CHARGE);
+            AttackAnimation(ANIM_SPECIAL_ATTACK, m_animList[ANIM_SPECIAL_ATTACK], Combo::SPECIAL_CHARGE);
         } else {
-            AttackAnimation(STR(Combo::SPECIAL_ATTACK), m_animList[STR(Combo::SPECIAL_ATTACK)]);
-        }
-        if(m_currAnimTime > m_animList[STR(Combo::SPECIAL_ATTACK)].triggerStartTime) {
-            if(!m_playedFX) {
-                m_playingEffect = PlayEffekseer3DEffect(m_pEffectList[(int)m_pCombo.lock()->ComboBuff() - 1]);
-                SetPosPlayingEffekseer3DEffect(m_playingEffect, GetTranslate().x, GetTranslate().y + 6, GetTranslate().z);
-                SetRotationPlayingEffekseer3DEffect(m_playingEffect, 0, (m_pModel.lock()->GetRotationAxisXYZ().y) * DegToRad,
-                                                    180 * DegToRad);
-                PlaySoundMem(m_swordSE, DX_PLAYTYPE_BACK);
-                ChangeVolumeSoundMem((int)(MAX_VOLUME * (Scene::GetSEVolume() / 100.0f)), m_swordSE);
-                m_playedFX = true;
-            }
+            AttackAnimation(ANIM_SPECIAL_ATTACK, m_animList[ANIM_SPECIAL_ATTACK]);
         }
         break;
     case Combo::SPECIAL_CHARGE:
-        AttackAnimation(STR(Combo::SPECIAL_CHARGE), m_animList[STR(Combo::SPECIAL_CHARGE)]);
-        if(m_currAnimTime > m_animList[STR(Combo::SPECIAL_CHARGE)].triggerStartTime) {
-            if(!m_playedFX) {
-                m_playingEffect = PlayEffekseer3DEffect(m_pEffectList[(int)m_pCombo.lock()->ComboBuff() - 1]);
-                SetPosPlayingEffekseer3DEffect(m_playingEffect, GetTranslate().x + 3.5f, GetTranslate().y + 6,
-                                               GetTranslate().z);
-                SetRotationPlayingEffekseer3DEffect(m_playingEffect, -20 * DegToRad,
-                                                    (m_pModel.lock()->GetRotationAxisXYZ().y) * DegToRad, 180 * DegToRad);
-                PlaySoundMem(m_swordSE, DX_PLAYTYPE_BACK);
-                ChangeVolumeSoundMem((int)(MAX_VOLUME * (Scene::GetSEVolume() / 100.0f)), m_swordSE);
-                m_playedFX = true;
-            }
-        }
+        AttackAnimation(ANIM_SPECIAL_CHARGE, m_animList[ANIM_SPECIAL_CHARGE]);
         break;
     default:
         m_playerState = PlayerState::IDLE;
@@ -524,17 +488,18 @@ void Player::Attack() {
     }
 }
 
-void Player::AttackAnimation(std::string animName, AnimInfo animInfo, Combo nextCombo) {
-    if(m_pModel.lock()->GetPlayAnimationName() != animName) {
-        m_currAnimName = animName;
+void Player::AttackAnimation(AnimId animId, AnimInfo animInfo, Combo nextCombo) {
+    if(m_pModel.lock()->GetPlayAnimationId() != animId) {
+        m_currAnimId = animId;
         this->SetModelRotation();
-        m_pModel.lock()->PlayAnimationNoSame(animName, false, 0.2F, m_animList[animName].animStartTime);
+        m_pModel.lock()->PlayAnimationNoSame(animId, false, 0.2F, m_animList[animId].animStartTime);
         m_pModel.lock()->SetAnimationSpeed(animInfo.animStartSpeed);
-        m_attackList.clear();
-        m_playedFX = false;
+        // 次の攻撃の当たり判定開始で改めて接触させる
+        m_pWeapon.lock()->SetHitCollisionGroup((u32)ComponentCollision::CollisionGroup::NONE);
+        m_isTriggered = false;
+        m_isCutIn     = false;
     }
-    m_currAnimTime = m_pModel.lock()->GetAnimationPlayTime();
-    if(m_currAnimTime > m_animList[animName].triggerStartTime) {
+    if(m_isTriggered) {
         if(m_isHit) {
             m_pModel.lock()->SetAnimationSpeed(animInfo.animSpeed * 0);
         } else if(m_slowMotion) {
@@ -542,12 +507,8 @@ void Player::AttackAnimation(std::string animName, AnimInfo animInfo, Combo next
         } else {
             m_pModel.lock()->SetAnimationSpeed(animInfo.animSpeed);
         }
-        m_pWeapon.lock()->SetHitCollisionGroup((u32)ComponentCollision::CollisionGroup::ENEMY);
     }
-    if(m_currAnimTime > m_animList[animName].triggerEndTime) {
-        m_pWeapon.lock()->SetHitCollisionGroup((u32)ComponentCollision::CollisionGroup::NONE);
-    }
-    if(m_currAnimTime > m_animList[animName].animCutInTime) {
+    if(m_isCutIn) {
         m_currCombo = Combo::NO_COMBO;
         if(m_isCombo) {
             m_currCombo = nextCombo;
@@ -556,8 +517,42 @@ void Player::AttackAnimation(std::string animName, AnimInfo animInfo, Combo next
     }
 }
 
+void Player::OnAnimationEvent(AnimId animId, const Animation::Event& event) {
+    // 攻撃アニメーション以外のイベントは使わない
+    if(m_playerState != PlayerState::ATTACK || animId != m_currAnimId)
+        return;
+
+    switch(event.type_) {
+    case Animation::Event::Type::CollisionOn:
+        m_isTriggered = true;
+        m_pWeapon.lock()->SetHitCollisionGroup((u32)ComponentCollision::CollisionGroup::ENEMY);
+        break;
+    case Animation::Event::Type::CollisionOff:
+        m_pWeapon.lock()->SetHitCollisionGroup((u32)ComponentCollision::CollisionGroup::NONE);
+        break;
+    case Animation::Event::Type::Sound:
+        PlaySoundMem(m_swordSE, DX_PLAYTYPE_BACK);
+        ChangeVolumeSoundMem((int)(MAX_VOLUME * (Scene::GetSEVolume() / 100.0f)), m_swordSE);
+        break;
+    case Animation::Event::Type::Effect: {
+        // 角度(Z軸回転)はイベントの値
+        float offsetX   = (animId == ANIM_SPECIAL_CHARGE) ? 3.5f : 0.0f;
+        float rotationX = (animId == ANIM_SPECIAL_CHARGE) ? -20 * DegToRad : 0.0f;
+        m_playingEffect = PlayEffekseer3DEffect(m_pEffectList[(int)m_pCombo.lock()->ComboBuff() - 1]);
+        SetPosPlayingEffekseer3DEffect(m_playingEffect, GetTranslate().x + offsetX, GetTranslate().y + 6, GetTranslate().z);
+        SetRotationPlayingEffekseer3DEffect(m_playingEffect, rotationX, (m_pModel.lock()->GetRotationAxisXYZ().y) * DegToRad,
+                                            event.value_ * DegToRad);
+        break;
+    }
+    case Animation::Event::Type::Notify:
+        if(event.name_ == EVENT_CUT_IN)
+            m_isCutIn = true;
+        break;
+    }
+}
+
 void Player::Die() {
-    m_pModel.lock()->PlayAnimationNoSame(STR(PlayerState::DEAD));
+    m_pModel.lock()->PlayAnimationNoSame(ANIM_DEAD);
 }
 
 bool Player::IsDead() {
@@ -602,7 +597,8 @@ void Player::SetAnimInfo() {
     info.animStartSpeed   = 3.5f;
     info.animSpeed        = 3.5f;
 
-    m_animList[STR(Combo::NORMAL_COMBO1)] = info;
+    m_animList[ANIM_NORMAL_COMBO1] = info;
+    m_pModel.lock()->SetAnimationEvents(ANIM_NORMAL_COMBO1, AttackEvents(info, 0));
 
     info                  = {};
     info.animStartTime    = 8;
@@ -612,7 +608,8 @@ void Player::SetAnimInfo() {
     info.animStartSpeed   = 3.5f;
     info.animSpeed        = 3.5f;
 
-    m_animList[STR(Combo::NORMAL_COMBO2)] = info;
+    m_animList[ANIM_NORMAL_COMBO2] = info;
+    m_pModel.lock()->SetAnimationEvents(ANIM_NORMAL_COMBO2, AttackEvents(info, 180));
 
     info                  = {};
     info.animStartTime    = 33;
@@ -622,7 +619,8 @@ void Player::SetAnimInfo() {
     info.animStartSpeed   = 3.0f;
     info.animSpeed        = 3.0f;
 
-    m_animList[STR(Combo::NORMAL_COMBO3)] = info;
+    m_animList[ANIM_NORMAL_COMBO3] = info;
+    m_pModel.lock()->SetAnimationEvents(ANIM_NORMAL_COMBO3, AttackEvents(info, -50));
 
     info                  = {};
     info.animStartTime    = 0;
@@ -632,7 +630,8 @@ void Player::SetAnimInfo() {
     info.animStartSpeed   = 3.0f;
     info.animSpeed        = 3.0f;
 
-    m_animList[STR(Combo::NORMAL_COMBO4)] = info;
+    m_animList[ANIM_NORMAL_COMBO4] = info;
+    m_pModel.lock()->SetAnimationEvents(ANIM_NORMAL_COMBO4, AttackEvents(info, 52));
 
     info                  = {};
     info.triggerStartTime = 55;
@@ -641,7 +640,8 @@ void Player::SetAnimInfo() {
     info.animStartSpeed   = 3.0f;
     info.animSpeed        = 3.0f;
 
-    m_animList[STR(Combo::SPECIAL_ATTACK)] = info;
+    m_animList[ANIM_SPECIAL_ATTACK] = info;
+    m_pModel.lock()->SetAnimationEvents(ANIM_SPECIAL_ATTACK, AttackEvents(info, 180));
 
     info                  = {};
     info.animStartTime    = 12;
@@ -651,7 +651,8 @@ void Player::SetAnimInfo() {
     info.animStartSpeed   = 3.0f;
     info.animSpeed        = 3.0f;
 
-    m_animList[STR(Combo::SPECIAL_CHARGE)] = info;
+    m_animList[ANIM_SPECIAL_CHARGE] = info;
+    m_pModel.lock()->SetAnimationEvents(ANIM_SPECIAL_CHARGE, AttackEvents(info, 180));
 }
 
 void Player::SetComboList() {
@@ -45,8 +45,12 @@ class Player: public Object {
     //! @param hitInfo　当たったコリジョンのヒット情報
     //------------------------------------------------------------
     void OnHit(const ComponentCollision::HitInfo& hitInfo) override;
-
-    void ExitHit(const ComponentCollision::HitInfo& hitInfo) override;
+    //------------------------------------------------------------
+    //! @brief 接触開始のコールバック
+    //!
+    //! @param contactInfo　接触したコリジョンの情報
+    //------------------------------------------------------------
+    void OnHitEnter(const ComponentCollision::ContactInfo& contactInfo) override;
     //------------------------------------------------------------
     //! @brief 終了処理を行います。
     //------------------------------------------------------------
@@ -133,11 +137,9 @@ class Player: public Object {
     ObjectWeakPtr m_pBoss;
 
     //! アニメーション名とアニメーション情報のマップ
-    std::unordered_map<std::string, AnimInfo> m_animList;
+    std::unordered_map<AnimId, AnimInfo>      m_animList;
     //! 攻撃方法と攻撃力のマップ
     std::unordered_map<Combo, int>            m_comboList;
-    //! 攻撃した敵のリスト
-    std::vector<std::string_view>             m_attackList;
     //! モデル
     std::weak_ptr<ComponentModel>             m_pModel;
     //! プレイヤーカメラ
@@ -168,8 +170,6 @@ class Player: public Object {
     float  m_hitTimer      = 0.0f;
     //! 現在のアニメーションの速度
     float  m_currAnimSpeed = 1.0f;
-    //! 現在のアニメーションの時間（フレーム）
-    float  m_currAnimTime  = 0.0f;
     //! チャージしているタイマー
     float  m_chargeTime    = 0.0f;
 
@@ -182,8 +182,10 @@ class Player: public Object {
     bool  m_isHit           = false;
     //! 無敵中なのか
     bool  m_isInvincible    = false;
-    //! サウンドエフェクトが再生したのか
-    bool  m_playedFX        = false;
+    //! 攻撃判定が始まったのか (アニメーションイベントで設定)
+    bool  m_isTriggered     = false;
+    //! 次のコンボに移れるのか (アニメーションイベントで設定)
+    bool  m_isCutIn         = false;
     //! チャージしていたのか
     bool  m_charged         = false;
 
@@ -196,7 +198,7 @@ class Player: public Object {
     bool m_hideUI = false;
 
     std::string_view m_blockedName  = "";
-    std::string      m_currAnimName = "";
+    AnimId           m_currAnimId   = {};
 
     //! 攻撃当たるエフェクト
     int  m_hitEffect           = -1;
@@ -259,11 +261,18 @@ class Player: public Object {
     //------------------------------------------------------------
     //! @brief 攻撃動画を再生します。
     //!
-    //! @param animName アニメーション名
+    //! @param animId アニメーションID
     //! @param animInfo アニメーション情報
     //! @param nextCombo 次のコンボ
     //------------------------------------------------------------
-    void AttackAnimation(std::string animName, AnimInfo animInfo, Combo nextCombo = Combo::NO_COMBO);
+    void AttackAnimation(AnimId animId, AnimInfo animInfo, Combo nextCombo = Combo::NO_COMBO);
+    //------------------------------------------------------------
+    //! @brief アニメーションイベントを処理します。
+    //!
+    //! @param animId イベントが発生したアニメーションID
+    //! @param event イベント
+    //------------------------------------------------------------
+    void OnAnimationEvent(AnimId animId, const Animation::Event& event);
     //------------------------------------------------------------
     //! @brief モデルの回転を設定します。
     //------------------------------------------------------------
@@ -1,6 +1,7 @@
 ﻿#include "Rock1.h"
 
 #include <System/Component/ComponentCollisionModel.h>
+#include <System/Component/ComponentInstancedModel.h>
 #include <System/Component/ComponentModel.h>
 
 namespace LittleQuest {
@@ -13,7 +14,9 @@ Rock1Ptr Rock1::Create(const float3& pos) {
 }
 
 bool Rock1::Init() {
-    AddComponent<ComponentModel>("data/Sample/SwordBout/Stage/Stage_Obj002.mv1");
+    // 当たり判定用のモデルは描画せず、描画はインスタンス描画で行う
+    AddComponent<ComponentModel>("data/Sample/SwordBout/Stage/Stage_Obj002.mv1")->SetStatus(Component::StatusBit::NoDraw, true);
+    AddComponent<ComponentInstancedModel>("data/Sample/SwordBout/Stage/Stage_Obj002.mv1");
     AddComponent<ComponentCollisionModel>()->AttachToModel();
     return Super::Init();
 }
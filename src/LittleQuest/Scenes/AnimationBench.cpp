@@ -0,0 +1,176 @@
+﻿//---------------------------------------------------------------------------
+//! @file   AnimationBench.cpp
+//! @brief  アニメーション計測シーン (多数の敵のアニメーション更新負荷)
+//---------------------------------------------------------------------------
+#include "AnimationBench.h"
+
+#include <System/Component/ComponentCollisionModel.h>
+#include <System/Component/ComponentModel.h>
+
+namespace LittleQuest {
+//===========================================================================
+//  アニメーション計測シーン
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//! 初期化
+//---------------------------------------------------------------------------
+bool AnimationBench::Init() {
+    {
+        auto groundObj = Scene::CreateObjectPtr<Object>()->SetName("Ground");
+        groundObj->AddComponent<ComponentModel>("data/Sample/SwordBout/Stage/Stage00.mv1");
+        groundObj->SetScaleAxisXYZ({0.5f, 0.1f, 0.5f});
+        groundObj->AddComponent<ComponentCollisionModel>()->AttachToModel(true);
+    }
+
+    auto obj  = Scene::CreateObjectPtr<Object>()->SetName("BenchCamera");
+    m_pCamera = obj->AddComponent<ComponentCamera>();
+    m_pCamera.lock()->SetCurrentCamera();
+    m_pCamera.lock()->SetPerspective(45.0f);
+
+    SpawnEnemies(m_enemyCount);
+
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! 更新
+//---------------------------------------------------------------------------
+void AnimationBench::Update() {
+    if(m_warmup < 0)
+        return;
+
+    // 読み込みと最初のアタッチが落ち着くまで待つ
+    if(m_warmup > 0) {
+        m_warmup--;
+        return;
+    }
+
+    HitEnemies();
+
+    // 統計は直前のフレーム分 (PostUpdate で区切られる)
+    auto stats = Animation::stats();
+    m_result.frames_++;
+    m_result.update_time_ += stats.update_time_;
+    m_result.max_time_ = std::max(m_result.max_time_, stats.update_time_);
+    m_result.updated_clips_ += stats.updated_clips_;
+    m_result.max_clips_ = std::max(m_result.max_clips_, stats.updated_clips_);
+    m_result.blend_updates_ += stats.blend_updates_;
+    m_result.attach_count_ += stats.attach_count_;
+    m_result.detach_count_ += stats.detach_count_;
+
+    if(m_result.frames_ >= m_measureFrames) {
+        m_result.hit_count_ = m_hitCount;
+        m_lastResult        = m_result;
+        m_lastEnemyCount    = static_cast<int>(m_pEnemies.size());
+        m_warmup            = -1;
+    }
+}
+
+//---------------------------------------------------------------------------
+//! GUI
+//---------------------------------------------------------------------------
+void AnimationBench::GUI() {
+    if(!ImGui::TreeNodeEx(u8"アニメーション計測", ImGuiTreeNodeFlags_DefaultOpen))
+        return;
+
+    ImGui::SliderInt(u8"敵の数", &m_enemyCount, 1, MAX_ENEMY_COUNT);
+    ImGui::SliderInt(u8"計測フレーム数", &m_measureFrames, 60, 3600);
+    ImGui::SliderFloat(u8"被弾させる間隔(秒)", &m_hitInterval, 0.0f, 5.0f);    // 0で巡回と待機の切り替えのみ
+    ImGui::Checkbox(u8"巡回", &m_isPatrol);
+
+    if(ImGui::Button(u8"配置して計測")) {
+        SpawnEnemies(m_enemyCount);
+        StartMeasure();
+    }
+    ImGui::SameLine();
+    if(ImGui::Button(u8"再計測"))
+        StartMeasure();
+
+    if(m_warmup > 0)
+        ImGui::Text(u8"準備中 : %d", m_warmup);
+    else if(m_warmup == 0)
+        ImGui::Text(u8"計測中 : %d / %d", m_result.frames_, m_measureFrames);
+
+    auto& r = m_lastResult;
+    if(r.frames_ > 0) {
+        const float frames  = static_cast<float>(r.frames_);
+        const float enemies = static_cast<float>(std::max(m_lastEnemyCount, 1));
+        const float average = static_cast<float>(r.update_time_ / r.frames_);
+
+        ImGui::Separator();
+        ImGui::Text(u8"敵の数 : %d  フレーム数 : %d  被弾 : %llu", m_lastEnemyCount, r.frames_, r.hit_count_);
+        ImGui::Text(u8"更新時間 : 平均 %.3f ms / 最大 %.3f ms", average, r.max_time_);
+        ImGui::Text(u8"1体あたり : %.2f us", average * 1000.0f / enemies);
+
+        // 1体あたりのアニメーション数が同時ブレンド数より十分少なければ再生中の数に比例している
+        ImGui::Text(u8"時間を更新したアニメーション : %.1f / フレーム (最大 %u)", r.updated_clips_ / frames, r.max_clips_);
+        ImGui::Text(u8"1体あたりのアニメーション : %.2f (同時ブレンド数 %u)", r.updated_clips_ / frames / enemies,
+                    Animation::CONTEXT_COUNT);
+        ImGui::Text(u8"ブレンド率の再設定 : %.1f / フレーム", r.blend_updates_ / frames);
+        ImGui::Text(u8"アタッチ / 解除 : %.2f / %.2f / フレーム", r.attach_count_ / frames, r.detach_count_ / frames);
+    }
+
+    ImGui::TreePop();
+}
+
+//---------------------------------------------------------------------------
+//! 終了
+//---------------------------------------------------------------------------
+void AnimationBench::Exit() {
+    m_pEnemies.clear();
+}
+
+//---------------------------------------------------------------------------
+//! 敵を並べなおす
+//---------------------------------------------------------------------------
+void AnimationBench::SpawnEnemies(int count) {
+    for(auto& pEnemy: m_pEnemies)
+        Scene::ReleaseObject(pEnemy.lock());
+    m_pEnemies.clear();
+
+    // 原点を中心に正方形に並べる
+    int   columns = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(count))));
+    float half    = (columns - 1) * ENEMY_SPACING * 0.5f;
+    for(int i = 0; i < count; ++i) {
+        float3 pos = {(i % columns) * ENEMY_SPACING - half, 1, (i / columns) * ENEMY_SPACING - half};
+        m_pEnemies.push_back(Enemy::Create(pos, m_isPatrol));
+    }
+
+    // 全体が見える位置から見下ろす
+    float extent = std::max(half, ENEMY_SPACING) * 2.0f;
+    m_pCamera.lock()->SetPositionAndTarget({0, extent * 0.8f, -extent * 1.2f}, {0, 0, 0});
+
+    m_warmup = -1;
+}
+
+//---------------------------------------------------------------------------
+//! 計測を開始
+//---------------------------------------------------------------------------
+void AnimationBench::StartMeasure() {
+    m_result    = {};
+    m_warmup    = WARMUP_FRAMES;
+    m_hitBudget = 0.0f;
+    m_hitCount  = 0;
+}
+
+//---------------------------------------------------------------------------
+//! 間隔ごとに敵を順番に被弾させる
+//---------------------------------------------------------------------------
+void AnimationBench::HitEnemies() {
+    if(m_hitInterval <= 0.0f || m_pEnemies.empty())
+        return;
+
+    // 1体あたり間隔ごとに1回になるように、フレームごとに少しずつずらして被弾させる
+    m_hitBudget += static_cast<float>(m_pEnemies.size()) * GetDeltaTime() / m_hitInterval;
+    while(m_hitBudget >= 1.0f) {
+        m_hitBudget -= 1.0f;
+
+        auto pEnemy = m_pEnemies[m_hitCursor++ % m_pEnemies.size()].lock();
+        if(pEnemy) {
+            pEnemy->GetHit(0);
+            m_hitCount++;
+        }
+    }
+}
+}    // namespace LittleQuest
@@ -0,0 +1,110 @@
+﻿//---------------------------------------------------------------------------
+//! @file   AnimationBench.h
+//! @brief  アニメーション計測シーン (多数の敵のアニメーション更新負荷)
+//---------------------------------------------------------------------------
+#include <LittleQuest/Objects/Enemy.h>
+
+#include <vector>
+#include <System/Scene.h>
+#include <System/Component/ComponentCamera.h>
+
+#pragma once
+namespace LittleQuest {
+//////////////////////////////////////////////////////////////
+//! @brief アニメーション計測シーンクラス
+//!
+//! 敵を並べて巡回させ、一定間隔で被弾アニメーションに切り替えながら
+//! フレームごとのアニメーション更新時間と Animation::stats() を集計します。
+//! 操作はシーンのGUIから行います
+//////////////////////////////////////////////////////////////
+class AnimationBench: public Scene::Base {
+   public:
+    BP_CLASS_DECL(AnimationBench, u8"LittleQuest/AnimationBench")
+
+    //------------------------------------------------------------
+    //! @brief 初期化処理を行います。
+    //!
+    //! @retval true 初期化成功
+    //! @retval false 初期化失敗
+    //------------------------------------------------------------
+    bool Init() override;
+    //------------------------------------------------------------
+    //! @brief 更新処理を行います。
+    //------------------------------------------------------------
+    void Update() override;
+    //------------------------------------------------------------
+    //! @brief GUI処理を行います。
+    //------------------------------------------------------------
+    void GUI() override;
+    //------------------------------------------------------------
+    //! @brief 終了処理を行います。
+    //------------------------------------------------------------
+    void Exit() override;
+
+   private:
+    //! 敵の最大数
+    const int   MAX_ENEMY_COUNT = 500;
+    //! 敵の配置間隔
+    const float ENEMY_SPACING   = 20.0f;
+    //! 計測を始めるまでのフレーム数 (読み込みと最初のアタッチを除く)
+    const int   WARMUP_FRAMES   = 60;
+
+    //! 集計結果
+    struct Result {
+        int    frames_        = 0;       //!< 集計したフレーム数
+        double update_time_   = 0.0;     //!< アニメーション更新時間の合計 (ms)
+        float  max_time_      = 0.0f;    //!< 1フレームの最大更新時間 (ms)
+        u64    updated_clips_ = 0;       //!< 時間を更新したアニメーション数の合計
+        u32    max_clips_     = 0;       //!< 1フレームの最大アニメーション数
+        u64    blend_updates_ = 0;       //!< ブレンド率の再設定の合計
+        u64    attach_count_  = 0;       //!< アタッチ回数の合計
+        u64    detach_count_  = 0;       //!< アタッチ解除回数の合計
+        u64    hit_count_     = 0;       //!< 被弾させた回数の合計
+    };
+
+    //! 配置する敵の数
+    int   m_enemyCount    = 100;
+    //! 計測するフレーム数
+    int   m_measureFrames = 600;
+    //! 1体を被弾させる間隔 (秒 0で被弾させない)
+    float m_hitInterval   = 2.0f;
+    //! 巡回させるか
+    bool  m_isPatrol      = true;
+
+    //! 計測開始までの残りフレーム数 (-1で計測していない)
+    int    m_warmup    = -1;
+    //! 被弾させる数の端数
+    float  m_hitBudget = 0.0f;
+    //! 次に被弾させる敵
+    size_t m_hitCursor = 0;
+    //! 計測中の被弾回数
+    u64    m_hitCount  = 0;
+
+    //! 集計中の結果
+    Result m_result;
+    //! 直前の計測結果
+    Result m_lastResult;
+    //! 直前の計測の敵の数
+    int    m_lastEnemyCount = 0;
+
+    //! 配置した敵
+    std::vector<std::weak_ptr<Enemy>> m_pEnemies;
+    //! シーンカメラ
+    std::weak_ptr<ComponentCamera>    m_pCamera;
+
+    //------------------------------------------------------------
+    //! @brief 敵を並べなおします。
+    //!
+    //! @param count 敵の数
+    //------------------------------------------------------------
+    void SpawnEnemies(int count);
+    //------------------------------------------------------------
+    //! @brief 計測を開始します。
+    //------------------------------------------------------------
+    void StartMeasure();
+    //------------------------------------------------------------
+    //! @brief 間隔ごとに敵を順番に被弾させます。
+    //------------------------------------------------------------
+    void HitEnemies();
+};
+}    // namespace LittleQuest
@@ -2,6 +2,7 @@
 #include "Stage01.h"
 
 #include <System/Component/ComponentSpringArm.h>
+#include <System/AssetPreloader.h>
 
 namespace LittleQuest {
 bool GameTitleScene::Init() {
@@ -81,6 +82,9 @@ void GameTitleScene::Update() {
 #endif    // !_DEBUG
            || IsPadOn(PAD_ID::PAD_R_PUSH) || IsPadOn(PAD_ID::PAD_B)) {
             scene_state = Scene::SceneState::TRANS_OUT;
+
+            // フェードアウト中にステージのアセットを読み込んでおく
+            AssetPreloader::start(Stage01::Type.className());
         }
         break;
     case Scene::SceneState::TRANS_OUT:
@@ -94,7 +98,7 @@ void GameTitleScene::Update() {
 
         m_pModel.lock()->PlayAnimationNoSame("Stand", false, 1.0f);
 
-        if(m_startTimer <= 0) {
+        if(m_startTimer <= 0 && !AssetPreloader::isLoading()) {
             Scene::Change(Scene::GetScene<Stage01>());
         }
         break;
@@ -122,6 +126,12 @@ void GameTitleScene::LateDraw() {
         m_pTitle.lock()->SetPosition((screen_width * 0.1f), (screen_height * (0.2f + (0.2f * (m_alpha / 255)))),
                                      (screen_width * 0.9f), (screen_height * (0.4f + (0.2f * (m_alpha / 255)))));
         m_pTitle.lock()->DrawTexture();
+
+        // フェードアウトが終わっても読み込み中の場合は進捗を表示
+        if(m_startTimer <= 0 && AssetPreloader::isLoading()) {
+            DrawFormatStringToHandle((int)(screen_width * 0.05f), (int)(screen_height * 0.9f), 0xffee42, m_fontHandle,
+                                     "Loading %d%%", (int)(AssetPreloader::progress() * 100.0f));
+        }
         break;
     }
 }
@@ -0,0 +1,228 @@
+﻿//---------------------------------------------------------------------------
+//! @file   AssetPreloader.cpp
+//! @brief  シーンのアセット先読み (前回使用したアセットの記録と読み込み)
+//---------------------------------------------------------------------------
+#include "AssetPreloader.h"
+
+#include <System/AssetRegistry.h>
+#include <System/Graphics/ResourceModel.h>
+#include <System/Graphics/Animation.h>
+#include <System/Graphics/TexturePool.h>
+
+#include <format>
+#include <fstream>
+
+namespace {
+
+//===========================================================================
+//! 先読み情報
+//===========================================================================
+struct PreloadEntry {
+    AssetType             type_    = AssetType::Model;    //!< 種類
+    std::string           path_;                          //!< 正規化したパス
+    std::shared_ptr<void> asset_;                         //!< 取得したアセット (保持して解放を防ぐ)
+    u32                   id_      = ~0u;                 //!< アセットID
+    const Texture*        texture_ = nullptr;             //!< テクスチャの場合の読み込み状態の確認用
+};
+
+std::vector<PreloadEntry> preload_entries;               //!< 先読み一覧
+u32                       preload_next       = 0;        //!< 次に取得する位置
+u32                       preload_done       = 0;        //!< 読み込み済の数 (update()で集計)
+u32                       preload_per_frame  = 4;        //!< 1フレームで取得する最大数
+LONGLONG                  preload_start_time = 0;        //!< 先読みを開始した時間
+f32                       preload_timeout    = 10.0f;    //!< 先読みを待つ最大秒数 (0で無制限)
+bool                      preload_timed_out  = false;    //!< 最大秒数を超えて待つのをやめた
+
+//---------------------------------------------------------------------------
+//! 一覧ファイルのパス
+//---------------------------------------------------------------------------
+std::string manifestPath(std::string_view folder, std::string_view scene_name) {
+    return std::string(folder) + std::string(scene_name) + ".preload.txt";
+}
+
+//---------------------------------------------------------------------------
+//! 種類名から種類を取得
+//---------------------------------------------------------------------------
+bool findType(std::string_view name, AssetType& type) {
+    for(u32 i = 0; i < static_cast<u32>(AssetType::Count); ++i) {
+        if(name == AssetRegistry::typeName(static_cast<AssetType>(i))) {
+            type = static_cast<AssetType>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+//---------------------------------------------------------------------------
+//! 取得 (読み込みは各リソースの非同期読み込みで進む)
+//---------------------------------------------------------------------------
+void acquire(PreloadEntry& entry) {
+    const std::string& path = entry.path_;
+
+    switch(entry.type_) {
+        case AssetType::Model: {
+            auto handle = AssetRegistry::acquire<ResourceModel>(AssetType::Model, path, [&path]() {
+                return std::make_shared<ResourceModel>(path);
+            });
+            entry.asset_ = handle.shared();
+            entry.id_    = handle.id();
+            break;
+        }
+        case AssetType::Animation: {
+            auto handle = AssetRegistry::acquire<ResourceAnimation>(AssetType::Animation, path, [&path]() {
+                return std::make_shared<ResourceAnimation>(path);
+            });
+            entry.asset_ = handle.shared();
+            entry.id_    = handle.id();
+            break;
+        }
+        case AssetType::Texture: {
+            auto texture   = TexturePool::load(path);
+            entry.texture_ = texture.get();
+            entry.asset_   = texture;
+            entry.id_      = AssetRegistry::find<Texture>(AssetType::Texture, path).id();
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+//---------------------------------------------------------------------------
+//! 読み込みが終わったかどうか
+//---------------------------------------------------------------------------
+bool isDone(const PreloadEntry& entry) {
+    // 取得できなかったもの (種類が不明/生成失敗) は待たない
+    if(!entry.asset_)
+        return true;
+    if(entry.texture_ && TexturePool::isPending(entry.texture_))
+        return false;
+    return !AssetRegistry::isBusy(entry.id_);
+}
+
+}    // namespace
+
+//---------------------------------------------------------------------------
+//! 現在のシーンで取得したアセットを一覧ファイルに記録
+//---------------------------------------------------------------------------
+bool AssetPreloader::saveManifest(std::string_view scene_name) {
+    auto assets = AssetRegistry::sceneAssets();
+    if(assets.empty())
+        return false;
+
+    HelperLib::File::CreateFolder(".\\data\\_save\\");
+    std::ofstream file(manifestPath(".\\data\\_save\\", scene_name));
+    if(!file)
+        return false;
+
+    for(auto& [type, path]: assets) {
+        // シェーダーはバリエーション数が必要で同期コンパイルのため対象外
+        if(type == AssetType::Shader)
+            continue;
+        file << AssetRegistry::typeName(type) << '\t' << path << '\n';
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! 先読みを開始
+//---------------------------------------------------------------------------
+bool AssetPreloader::start(std::string_view scene_name) {
+    release();
+
+    // 配布用の一覧を優先し、無ければ前回記録したものを使う
+    std::ifstream file(manifestPath(".\\data\\Load\\", scene_name));
+    if(!file.is_open())
+        file.open(manifestPath(".\\data\\_save\\", scene_name));
+    if(!file)
+        return false;
+
+    std::string line;
+    while(std::getline(file, line)) {
+        auto tab = line.find('\t');
+        if(tab == std::string::npos)
+            continue;
+
+        PreloadEntry entry;
+        if(!findType(std::string_view(line).substr(0, tab), entry.type_) || entry.type_ == AssetType::Shader)
+            continue;
+        entry.path_ = line.substr(tab + 1);
+        preload_entries.push_back(std::move(entry));
+    }
+
+    preload_start_time = GetNowHiPerformanceCount();
+    return !preload_entries.empty();
+}
+
+//---------------------------------------------------------------------------
+//! 更新
+//---------------------------------------------------------------------------
+void AssetPreloader::update() {
+    if(preload_entries.empty())
+        return;
+
+    //----------------------------------------------------------
+    // 一覧のアセットを少しずつ取得 (次のシーンのものとして登録)
+    //----------------------------------------------------------
+    AssetRegistry::setPreloading(true);
+    for(u32 count = 0; count < preload_per_frame && preload_next < preload_entries.size(); ++count)
+        acquire(preload_entries[preload_next++]);
+    AssetRegistry::setPreloading(false);
+
+    //----------------------------------------------------------
+    // 読み込み済の数を集計
+    //----------------------------------------------------------
+    preload_done = 0;
+    for(u32 i = 0; i < preload_next; ++i) {
+        if(isDone(preload_entries[i]))
+            preload_done++;
+    }
+
+    //----------------------------------------------------------
+    // 読み込みが終わらないものがあってもシーン切り替えを止め続けない
+    //----------------------------------------------------------
+    if(preload_timeout > 0.0f && !preload_timed_out && preload_done < preload_entries.size()) {
+        f32 elapsed = static_cast<f32>(GetNowHiPerformanceCount() - preload_start_time) / 1000000.0f;
+        if(elapsed >= preload_timeout) {
+            preload_timed_out = true;
+
+            auto message = std::format("AssetPreloader: timed out after {:.1f}s ({}/{} loaded)\n", elapsed,
+                                       preload_done, preload_entries.size());
+            OutputDebugStringA(message.c_str());
+        }
+    }
+}
+
+//---------------------------------------------------------------------------
+//! 先読みで保持しているアセットを手放す
+//---------------------------------------------------------------------------
+void AssetPreloader::release() {
+    preload_entries.clear();
+    preload_next      = 0;
+    preload_done      = 0;
+    preload_timed_out = false;
+}
+
+//---------------------------------------------------------------------------
+//! 先読み中かどうか
+//---------------------------------------------------------------------------
+bool AssetPreloader::isLoading() {
+    return !preload_timed_out && preload_done < preload_entries.size();
+}
+
+//---------------------------------------------------------------------------
+//! 進捗
+//---------------------------------------------------------------------------
+f32 AssetPreloader::progress() {
+    if(preload_entries.empty())
+        return 1.0f;
+    return static_cast<f32>(preload_done) / static_cast<f32>(preload_entries.size());
+}
+
+//---------------------------------------------------------------------------
+//! 設定
+//---------------------------------------------------------------------------
+void AssetPreloader::setup(u32 per_frame, f32 timeout) {
+    preload_per_frame = std::max(per_frame, 1u);
+    preload_timeout   = std::max(timeout, 0.0f);
+}
@@ -0,0 +1,45 @@
+﻿//---------------------------------------------------------------------------
+//! @file   AssetPreloader.h
+//! @brief  シーンのアセット先読み (前回使用したアセットの記録と読み込み)
+//---------------------------------------------------------------------------
+#pragma once
+
+//===========================================================================
+//! @brief シーンのアセット先読み
+//! @details シーンを抜けるときに、そのシーンで取得したアセットを一覧ファイルに記録します。
+//!          次回そのシーンへ切り替える前 (前のシーンのフェードアウト中など) に start() を呼ぶと、
+//!          一覧のアセットを1フレームに数個ずつ取得して非同期で読み込みます。
+//!          シーンの初期化では読み込み済のアセットを共有するだけになります
+//===========================================================================
+class AssetPreloader final {
+   public:
+    //! @brief 現在のシーンで取得したアセットを一覧ファイルに記録
+    //! @param [in] scene_name  シーン名
+    static bool saveManifest(std::string_view scene_name);
+
+    //! @brief 先読みを開始
+    //! @param [in] scene_name  切り替え先のシーン名
+    //! @return 一覧ファイルが無い場合は false
+    static bool start(std::string_view scene_name);
+
+    //! @brief 更新 (1フレームに1回)
+    //! @details 一覧のアセットを設定数ずつ取得します
+    static void update();
+
+    //! @brief 先読みで保持しているアセットを手放す
+    //! @details 新しいシーンの初期化で再取得されたものはそのまま残ります
+    static void release();
+
+    //! @brief 先読み中かどうか
+    //! @details 読み込みに失敗したものは完了として扱います。
+    //!          設定した最大秒数を超えた場合も、残りを待たずに false を返します
+    static bool isLoading();
+
+    //! 進捗 (0.0～1.0 一覧が無い場合は1.0)
+    static f32 progress();
+
+    //! @brief 設定
+    //! @param [in] per_frame   1フレームで取得する最大数
+    //! @param [in] timeout     先読みを待つ最大秒数 (0で無制限)
+    static void setup(u32 per_frame, f32 timeout = 10.0f);
+};
@@ -0,0 +1,410 @@
+﻿//---------------------------------------------------------------------------
+//! @file   AssetRegistry.cpp
+//! @brief  アセットレジストリ (モデル/アニメーション/テクスチャ/シェーダーの共有と解放)
+//---------------------------------------------------------------------------
+#include "AssetRegistry.h"
+
+#include <array>
+#include <cctype>
+#include <filesystem>
+
+namespace {
+
+constexpr u32 TYPE_COUNT = static_cast<u32>(AssetType::Count);
+constexpr u32 INVALID_ID = ~0u;
+
+using BytesFunc = u64 (*)(const void*);     //!< 使用メモリ量の取得関数
+using BusyFunc  = bool (*)(const void*);    //!< 解放できない状態かの取得関数
+
+//===========================================================================
+//! 登録情報
+//===========================================================================
+struct AssetEntry {
+    AssetType             type_         = AssetType::Model;    //!< 種類
+    std::string           key_;                                //!< 正規化したパス
+    std::shared_ptr<void> asset_;                              //!< アセット (レジストリの参照)
+    BytesFunc             bytes_func_   = nullptr;             //!< 使用メモリ量の取得
+    BusyFunc              busy_func_    = nullptr;             //!< 解放できない状態かの取得
+    u64                   bytes_        = 0;                   //!< 使用メモリ量 (update()で集計)
+    u64                   last_used_    = 0;                   //!< 最後に使用したフレーム
+    u32                   scene_serial_ = 0;                   //!< 最後に取得したシーン番号
+    u16                   generation_   = 0;                   //!< 世代 (解放で増加)
+    bool                  used_         = false;               //!< 使用中のスロットか
+};
+
+std::vector<AssetEntry>                      asset_entries;             //!< 登録情報 (スロット)
+std::vector<u32>                             asset_free_slots;          //!< 空きスロット
+std::unordered_map<std::string, u32>         asset_keys[TYPE_COUNT];    //!< 種類ごとのパス→スロット
+std::array<AssetRegistry::Stats, TYPE_COUNT> asset_stats;               //!< 種類ごとの統計情報
+
+u64      asset_frame             = 1;                        //!< フレーム番号
+u64      asset_budget_bytes      = 1024ull * 1024 * 1024;    //!< メモリ予算
+u32      asset_scene_serial      = 0;                        //!< 現在のシーン番号
+bool     asset_scene_ready       = false;                    //!< 現在のシーンの初期化が終わったか
+bool     asset_preloading        = false;                    //!< 先読み中か
+LONGLONG asset_scene_change_time = 0;                        //!< シーンを切り替えた時間 (計測中でなければ0)
+f32      asset_scene_init_time   = 0.0f;                     //!< シーン切り替えから初期化完了までの時間 (ms)
+f32      asset_scene_load_time   = 0.0f;                     //!< シーン切り替えから操作可能になるまでの時間 (ms)
+
+//---------------------------------------------------------------------------
+//! アセットIDを作成
+//---------------------------------------------------------------------------
+u32 makeId(u32 slot) {
+    return slot | (static_cast<u32>(asset_entries[slot].generation_) << 16);
+}
+
+//---------------------------------------------------------------------------
+//! アセットIDから登録情報を取得
+//---------------------------------------------------------------------------
+AssetEntry* findEntry(u32 id) {
+    u32 slot = id & 0xffff;
+    if(id == INVALID_ID || slot >= asset_entries.size())
+        return nullptr;
+
+    auto& entry = asset_entries[slot];
+    if(!entry.used_ || entry.generation_ != static_cast<u16>(id >> 16))
+        return nullptr;
+    return &entry;
+}
+
+//---------------------------------------------------------------------------
+//! 参照されていないか (レジストリのみが保持している)
+//---------------------------------------------------------------------------
+bool isUnreferenced(const AssetEntry& entry) {
+    return entry.asset_.use_count() == 1 && !entry.busy_func_(entry.asset_.get());
+}
+
+//---------------------------------------------------------------------------
+//! 解放
+//---------------------------------------------------------------------------
+void release(u32 slot, bool evict) {
+    auto& entry = asset_entries[slot];
+    auto& stats = asset_stats[static_cast<u32>(entry.type_)];
+
+    stats.count_--;
+    stats.resident_bytes_ -= entry.bytes_;
+    if(evict)
+        stats.evict_++;
+
+    asset_keys[static_cast<u32>(entry.type_)].erase(entry.key_);
+
+    entry.asset_.reset();
+    entry.key_.clear();
+    entry.bytes_ = 0;
+    entry.used_  = false;
+    entry.generation_++;
+    asset_free_slots.push_back(slot);
+}
+
+}    // namespace
+
+//---------------------------------------------------------------------------
+//! 使用したことを通知
+//---------------------------------------------------------------------------
+void AssetRegistry::touch(u32 id) {
+    if(auto* entry = findEntry(id))
+        entry->last_used_ = asset_frame;
+}
+
+//---------------------------------------------------------------------------
+//! 登録されているかどうか
+//---------------------------------------------------------------------------
+bool AssetRegistry::isResident(u32 id) {
+    return findEntry(id) != nullptr;
+}
+
+//---------------------------------------------------------------------------
+//! 読み込み中など解放できない状態かどうか
+//---------------------------------------------------------------------------
+bool AssetRegistry::isBusy(u32 id) {
+    auto* entry = findEntry(id);
+    return entry && entry->busy_func_(entry->asset_.get());
+}
+
+//---------------------------------------------------------------------------
+//! シーン切り替えを通知
+//---------------------------------------------------------------------------
+void AssetRegistry::changeScene() {
+    asset_scene_serial++;
+    asset_scene_ready       = false;
+    asset_scene_change_time = GetNowHiPerformanceCount();
+}
+
+//---------------------------------------------------------------------------
+//! シーンの初期化完了を通知
+//---------------------------------------------------------------------------
+void AssetRegistry::sceneReady() {
+    asset_scene_ready = true;
+
+    if(asset_scene_change_time != 0)
+        asset_scene_init_time = (f32)(GetNowHiPerformanceCount() - asset_scene_change_time) / 1000.0f;
+}
+
+//---------------------------------------------------------------------------
+//! 先読み中かどうかを設定
+//---------------------------------------------------------------------------
+void AssetRegistry::setPreloading(bool preloading) {
+    asset_preloading = preloading;
+}
+
+//---------------------------------------------------------------------------
+//! 現在のシーンで取得したアセットの一覧
+//---------------------------------------------------------------------------
+std::vector<std::pair<AssetType, std::string>> AssetRegistry::sceneAssets() {
+    std::vector<std::pair<AssetType, std::string>> assets;
+    for(auto& entry: asset_entries) {
+        if(entry.used_ && entry.scene_serial_ == asset_scene_serial)
+            assets.emplace_back(entry.type_, entry.key_);
+    }
+    return assets;
+}
+
+//---------------------------------------------------------------------------
+//! シーン切り替えから操作可能になるまでの時間
+//---------------------------------------------------------------------------
+f32 AssetRegistry::sceneLoadTime() {
+    return asset_scene_load_time;
+}
+
+//---------------------------------------------------------------------------
+//! 更新
+//---------------------------------------------------------------------------
+void AssetRegistry::update() {
+    //----------------------------------------------------------
+    // 使用メモリ量を集計
+    //----------------------------------------------------------
+    u64  total_bytes = 0;
+    bool scene_busy  = false;
+    for(auto& stats: asset_stats) {
+        stats.resident_bytes_ = 0;
+        stats.referenced_     = 0;
+    }
+
+    for(auto& entry: asset_entries) {
+        if(!entry.used_)
+            continue;
+
+        auto& stats  = asset_stats[static_cast<u32>(entry.type_)];
+        entry.bytes_ = entry.bytes_func_(entry.asset_.get());
+        stats.resident_bytes_ += entry.bytes_;
+        if(entry.asset_.use_count() > 1)
+            stats.referenced_++;
+        total_bytes += entry.bytes_;
+
+        if(entry.scene_serial_ == asset_scene_serial && entry.busy_func_(entry.asset_.get()))
+            scene_busy = true;
+    }
+
+    //----------------------------------------------------------
+    // シーンの初期化後、現在のシーンのアセットがすべて読み込み終わったら操作可能とする
+    //----------------------------------------------------------
+    if(asset_scene_ready && !scene_busy && asset_scene_change_time != 0) {
+        asset_scene_load_time   = (f32)(GetNowHiPerformanceCount() - asset_scene_change_time) / 1000.0f;
+        asset_scene_change_time = 0;
+    }
+
+    //----------------------------------------------------------
+    // シーン切り替えの遅延解放
+    // 新しいシーンの初期化後も再取得されず、参照も無いものを解放
+    //----------------------------------------------------------
+    if(asset_scene_ready) {
+        for(u32 slot = 0; slot < asset_entries.size(); ++slot) {
+            auto& entry = asset_entries[slot];
+            if(!entry.used_ || entry.scene_serial_ == asset_scene_serial || !isUnreferenced(entry))
+                continue;
+
+            total_bytes -= entry.bytes_;
+            release(slot, false);
+        }
+    }
+
+    //----------------------------------------------------------
+    // メモリ予算を超えている場合は参照の無いものを古い順に解放
+    //----------------------------------------------------------
+    if(total_bytes > asset_budget_bytes) {
+        std::vector<u32> candidates;
+        for(u32 slot = 0; slot < asset_entries.size(); ++slot) {
+            auto& entry = asset_entries[slot];
+            if(entry.used_ && entry.bytes_ > 0 && isUnreferenced(entry))
+                candidates.push_back(slot);
+        }
+
+        std::sort(candidates.begin(), candidates.end(), [](u32 a, u32 b) {
+            return asset_entries[a].last_used_ < asset_entries[b].last_used_;
+        });
+
+        for(u32 slot: candidates) {
+            if(total_bytes <= asset_budget_bytes)
+                break;
+
+            total_bytes -= asset_entries[slot].bytes_;
+            release(slot, true);
+        }
+    }
+
+    asset_frame++;
+}
+
+//---------------------------------------------------------------------------
+//! すべて解放
+//---------------------------------------------------------------------------
+void AssetRegistry::clear() {
+    for(u32 slot = 0; slot < asset_entries.size(); ++slot) {
+        if(asset_entries[slot].used_)
+            release(slot, false);
+    }
+}
+
+//---------------------------------------------------------------------------
+//! メモリ予算を設定
+//---------------------------------------------------------------------------
+void AssetRegistry::setBudget(u64 budget_bytes) {
+    asset_budget_bytes = budget_bytes;
+}
+
+//---------------------------------------------------------------------------
+//! メモリ予算を取得
+//---------------------------------------------------------------------------
+u64 AssetRegistry::budget() {
+    return asset_budget_bytes;
+}
+
+//---------------------------------------------------------------------------
+//! 種類ごとの統計情報を取得
+//---------------------------------------------------------------------------
+AssetRegistry::Stats AssetRegistry::stats(AssetType type) {
+    return asset_stats[static_cast<u32>(type)];
+}
+
+//---------------------------------------------------------------------------
+//! 種類ごとの使用メモリ量を取得
+//---------------------------------------------------------------------------
+u64 AssetRegistry::residentBytes(AssetType type) {
+    return asset_stats[static_cast<u32>(type)].resident_bytes_;
+}
+
+//---------------------------------------------------------------------------
+//! 種類の表示名を取得
+//---------------------------------------------------------------------------
+const char* AssetRegistry::typeName(AssetType type) {
+    switch(type) {
+        case AssetType::Model:
+            return "Model";
+        case AssetType::Animation:
+            return "Animation";
+        case AssetType::Texture:
+            return "Texture";
+        case AssetType::Shader:
+            return "Shader";
+        default:
+            return "Unknown";
+    }
+}
+
+//---------------------------------------------------------------------------
+//! デバッグ表示
+//---------------------------------------------------------------------------
+void AssetRegistry::GUI() {
+    constexpr f64 MB = 1024.0 * 1024.0;
+
+    u64 total_bytes = 0;
+    for(auto& stats: asset_stats)
+        total_bytes += stats.resident_bytes_;
+
+    ImGui::Text(u8"使用メモリ : %.1f / %.1f MB", total_bytes / MB, asset_budget_bytes / MB);
+    ImGui::Text(u8"シーン読み込み : 初期化 %.1f ms / 操作可能 %.1f ms", asset_scene_init_time, asset_scene_load_time);
+
+    for(u32 i = 0; i < TYPE_COUNT; ++i) {
+        auto  type  = static_cast<AssetType>(i);
+        auto& stats = asset_stats[i];
+
+        if(ImGui::TreeNode(typeName(type), u8"%s : %d (参照中 %d) %.2f MB", typeName(type), stats.count_, stats.referenced_,
+                           stats.resident_bytes_ / MB)) {
+            ImGui::Text(u8"共有/新規/解放 : %d / %d / %d", stats.hit_, stats.miss_, stats.evict_);
+
+            for(auto& entry: asset_entries) {
+                if(!entry.used_ || entry.type_ != type)
+                    continue;
+                ImGui::Text("%s  %.2f MB  ref:%d", entry.key_.c_str(), entry.bytes_ / MB,
+                            static_cast<int>(entry.asset_.use_count() - 1));
+            }
+            ImGui::TreePop();
+        }
+    }
+}
+
+//---------------------------------------------------------------------------
+//! パスを正規化
+//---------------------------------------------------------------------------
+std::string AssetRegistry::normalizePath(std::string_view path) {
+    // 区切り文字を '/' に統一してから "./" や "../" を整理
+    std::string key(path);
+    std::replace(key.begin(), key.end(), '\\', '/');
+    key = std::filesystem::path(key).lexically_normal().generic_string();
+
+    // 小文字に統一することで大文字小文字の差異をなくす
+    std::transform(key.begin(), key.end(), key.begin(), [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+    return key;
+}
+
+//---------------------------------------------------------------------------
+//! パスから検索
+//---------------------------------------------------------------------------
+u32 AssetRegistry::lookup(AssetType type, const std::string& key, bool use) {
+    auto& keys = asset_keys[static_cast<u32>(type)];
+
+    auto it = keys.find(key);
+    if(it == keys.end())
+        return INVALID_ID;
+
+    if(use) {
+        // 現在のシーンで取得したものとして記録 (先読みは次のシーンの初期化で記録される)
+        auto& entry      = asset_entries[it->second];
+        entry.last_used_ = asset_frame;
+        if(!asset_preloading)
+            entry.scene_serial_ = asset_scene_serial;
+        asset_stats[static_cast<u32>(type)].hit_++;
+    }
+    return makeId(it->second);
+}
+
+//---------------------------------------------------------------------------
+//! アセットを取得
+//---------------------------------------------------------------------------
+std::shared_ptr<void> AssetRegistry::asset(u32 id) {
+    auto* entry = findEntry(id);
+    return entry ? entry->asset_ : nullptr;
+}
+
+//---------------------------------------------------------------------------
+//! 登録
+//---------------------------------------------------------------------------
+u32 AssetRegistry::add(AssetType type, std::string key, std::shared_ptr<void> asset, BytesFunc bytes, BusyFunc busy) {
+    u32 slot;
+    if(asset_free_slots.empty()) {
+        slot = static_cast<u32>(asset_entries.size());
+        asset_entries.emplace_back();
+        assert(slot <= 0xffff && "アセット数が上限を超えました");
+    } else {
+        slot = asset_free_slots.back();
+        asset_free_slots.pop_back();
+    }
+
+    auto& entry         = asset_entries[slot];
+    entry.type_         = type;
+    entry.key_          = key;
+    entry.asset_        = std::move(asset);
+    entry.bytes_func_   = bytes;
+    entry.busy_func_    = busy;
+    entry.bytes_        = 0;
+    entry.last_used_    = asset_frame;
+    entry.scene_serial_ = asset_preloading ? asset_scene_serial + 1 : asset_scene_serial;    // 先読みは次のシーンのもの
+    entry.used_         = true;
+
+    auto& stats = asset_stats[static_cast<u32>(type)];
+    stats.count_++;
+    stats.miss_++;
+
+    asset_keys[static_cast<u32>(type)][std::move(key)] = slot;
+    return makeId(slot);
+}
@@ -0,0 +1,196 @@
+﻿//---------------------------------------------------------------------------
+//! @file   AssetRegistry.h
+//! @brief  アセットレジストリ (モデル/アニメーション/テクスチャ/シェーダーの共有と解放)
+//---------------------------------------------------------------------------
+#pragma once
+
+#include <memory>
+#include <vector>
+
+//! アセットの種類
+enum class AssetType : u32 {
+    Model,        //!< 3Dモデル
+    Animation,    //!< アニメーション
+    Texture,      //!< テクスチャ
+    Shader,       //!< シェーダー
+
+    Count,
+};
+
+//===========================================================================
+//! @brief 型付きアセットハンドル
+//! @details 保持している間は参照中として扱われ、解放されません
+//===========================================================================
+template <class T>
+class AssetHandle {
+    friend class AssetRegistry;
+
+   public:
+    static constexpr u32 INVALID = ~0u;    //!< 無効なID
+
+    AssetHandle() = default;
+
+    //! アセットを取得
+    T* get() const {
+        return asset_.get();
+    }
+
+    T* operator->() const {
+        return asset_.get();
+    }
+
+    T& operator*() const {
+        return *asset_;
+    }
+
+    explicit operator bool() const {
+        return asset_ != nullptr;
+    }
+
+    //! 共有ポインタを取得 (既存のインターフェースへ渡す場合)
+    const std::shared_ptr<T>& shared() const {
+        return asset_;
+    }
+
+    //! アセットID (上位16ビット:世代 下位16ビット:スロット番号)
+    u32 id() const {
+        return id_;
+    }
+
+    //! 参照を解除
+    void reset() {
+        asset_.reset();
+        id_ = INVALID;
+    }
+
+   private:
+    AssetHandle(std::shared_ptr<T> asset, u32 id)
+        : asset_(std::move(asset))
+        , id_(id) {}
+
+    std::shared_ptr<T> asset_;            //!< アセット
+    u32                id_ = INVALID;    //!< アセットID
+};
+
+//===========================================================================
+//! @brief アセットレジストリ
+//! @details 正規化したファイルパスをキーにアセットを共有します。
+//!          登録する型は次の関数を持つ必要があります。
+//!          - u64 residentBytes() const   使用メモリ量
+//!          - bool isBusy() const         読み込み中など解放できない状態か
+//!
+//!          参照されなくなったアセットは次の条件で解放されます。
+//!          - シーン切り替え後、新しいシーンの初期化が終わっても再取得されなかったもの
+//!          - メモリ予算を超えた場合、最後に使用したのが古いもの
+//===========================================================================
+class AssetRegistry final {
+   public:
+    //! 種類ごとの統計情報
+    struct Stats {
+        u32 count_          = 0;    //!< 登録数
+        u32 referenced_     = 0;    //!< 参照中の数
+        u32 hit_            = 0;    //!< 共有できた数
+        u32 miss_           = 0;    //!< 新規作成した数
+        u32 evict_          = 0;    //!< 解放した数
+        u64 resident_bytes_ = 0;    //!< 使用メモリ量
+    };
+
+    //! @brief アセットを取得 (無ければ作成して登録)
+    //! @param [in]  type       アセットの種類
+    //! @param [in]  path       ファイルパス
+    //! @param [in]  create     作成関数 std::shared_ptr<T>()
+    //! @param [out] created    新規作成したかどうか (省略可)
+    template <class T, class Create>
+    static AssetHandle<T> acquire(AssetType type, std::string_view path, Create&& create, bool* created = nullptr) {
+        auto key = normalizePath(path);
+
+        u32 id = lookup(type, key);
+        if(created)
+            *created = (id == AssetHandle<T>::INVALID);
+
+        if(id != AssetHandle<T>::INVALID)
+            return AssetHandle<T>(std::static_pointer_cast<T>(asset(id)), id);
+
+        std::shared_ptr<T> asset = create();
+        id                       = add(
+            type, std::move(key), asset,
+            [](const void* p) -> u64 { return static_cast<const T*>(p)->residentBytes(); },
+            [](const void* p) -> bool { return static_cast<const T*>(p)->isBusy(); });
+        return AssetHandle<T>(std::move(asset), id);
+    }
+
+    //! @brief 登録済のアセットを検索 (作成はしない)
+    //! @param [in] type    アセットの種類
+    //! @param [in] path    ファイルパス
+    //! @return 見つからなかった場合は空のハンドル
+    template <class T>
+    static AssetHandle<T> find(AssetType type, std::string_view path) {
+        u32 id = lookup(type, normalizePath(path), false);
+        if(id == AssetHandle<T>::INVALID)
+            return {};
+        return AssetHandle<T>(std::static_pointer_cast<T>(asset(id)), id);
+    }
+
+    //! 使用したことを通知 (解放の優先順に使用)
+    static void touch(u32 id);
+
+    //! 登録されているかどうか
+    static bool isResident(u32 id);
+
+    //! 読み込み中など解放できない状態かどうか
+    static bool isBusy(u32 id);
+
+    //! @brief シーン切り替えを通知
+    //! @details 以前のシーンで取得したアセットは sceneReady() 以降に参照が無ければ解放されます
+    static void changeScene();
+
+    //! シーンの初期化完了を通知
+    static void sceneReady();
+
+    //! @brief 先読み中かどうかを設定
+    //! @details 先読み中に取得したものは現在のシーンの使用として記録せず、次のシーンのアセットとして扱います
+    static void setPreloading(bool preloading);
+
+    //! 現在のシーンで取得したアセットの一覧 (種類と正規化したパス)
+    static std::vector<std::pair<AssetType, std::string>> sceneAssets();
+
+    //! @brief シーン切り替えから操作可能になるまでの時間 (ms)
+    //! @details 初期化が終わり、読み込み中のアセットが無くなった最初のフレームまでを計測します
+    static f32 sceneLoadTime();
+
+    //! @brief 更新 (1フレームに1回)
+    //! @details 使用メモリ量の集計と、参照されていないアセットの解放を行います
+    static void update();
+
+    //! すべて解放
+    static void clear();
+
+    //! メモリ予算を設定
+    static void setBudget(u64 budget_bytes);
+
+    //! メモリ予算を取得
+    static u64 budget();
+
+    //! 種類ごとの統計情報を取得
+    static Stats stats(AssetType type);
+
+    //! 種類ごとの使用メモリ量を取得
+    static u64 residentBytes(AssetType type);
+
+    //! 種類の表示名を取得
+    static const char* typeName(AssetType type);
+
+    //! デバッグ表示
+    static void GUI();
+
+    //! パスを正規化 (区切り文字/大文字小文字/相対表記の違いを吸収)
+    static std::string normalizePath(std::string_view path);
+
+   private:
+    using BytesFunc = u64 (*)(const void*);
+    using BusyFunc  = bool (*)(const void*);
+
+    static u32 lookup(AssetType type, const std::string& key, bool use = true);
+    static std::shared_ptr<void> asset(u32 id);
+    static u32 add(AssetType type, std::string key, std::shared_ptr<void> asset, BytesFunc bytes, BusyFunc busy);
+};
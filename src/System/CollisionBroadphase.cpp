@@ -0,0 +1,303 @@
+﻿//---------------------------------------------------------------------------
+//! @file   CollisionBroadphase.cpp
+//! @brief  コリジョンブロードフェーズ (動的AABBツリー)
+//---------------------------------------------------------------------------
+#include "CollisionBroadphase.h"
+
+//===========================================================================
+// コリジョンブロードフェーズ CollisionBroadphase
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//! コンストラクタ
+//---------------------------------------------------------------------------
+CollisionBroadphase::CollisionBroadphase() {
+    nodes_.reserve(256);
+}
+
+//---------------------------------------------------------------------------
+//! プロキシを作成します
+//---------------------------------------------------------------------------
+s32 CollisionBroadphase::createProxy(const CollisionAABB& aabb, void* user_data) {
+    s32   proxy = allocateNode();
+    Node& node  = nodes_[proxy];
+
+    // 余白を付けておくことで小さな移動では組み替えが発生しないようにする
+    node.aabb_.min_ = aabb.min_ - margin_;
+    node.aabb_.max_ = aabb.max_ + margin_;
+    node.user_data_ = user_data;
+    node.height_    = 0;
+
+    insertLeaf(proxy);
+    proxy_count_++;
+
+    return proxy;
+}
+
+//---------------------------------------------------------------------------
+//! プロキシを削除します
+//---------------------------------------------------------------------------
+void CollisionBroadphase::destroyProxy(s32 proxy) {
+    if(!isValidProxy(proxy)) {
+        assert(false);
+        return;
+    }
+
+    removeLeaf(proxy);
+    freeNode(proxy);
+    proxy_count_--;
+}
+
+//---------------------------------------------------------------------------
+//! プロキシを移動します
+//---------------------------------------------------------------------------
+bool CollisionBroadphase::moveProxy(s32 proxy, const CollisionAABB& aabb) {
+    if(!isValidProxy(proxy)) {
+        assert(false);
+        return false;
+    }
+
+    // 余白の範囲内なら何もしない
+    if(nodes_[proxy].aabb_.isContain(aabb))
+        return false;
+
+    removeLeaf(proxy);
+
+    nodes_[proxy].aabb_.min_ = aabb.min_ - margin_;
+    nodes_[proxy].aabb_.max_ = aabb.max_ + margin_;
+
+    insertLeaf(proxy);
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! 全プロキシを削除します
+//---------------------------------------------------------------------------
+void CollisionBroadphase::clear() {
+    nodes_.clear();
+    root_        = NULL_PROXY;
+    free_list_   = NULL_PROXY;
+    proxy_count_ = 0;
+}
+
+//---------------------------------------------------------------------------
+//! ノードを確保します
+//---------------------------------------------------------------------------
+s32 CollisionBroadphase::allocateNode() {
+    // 空きがなければ末尾に追加
+    if(free_list_ == NULL_PROXY) {
+        nodes_.emplace_back();
+        return (s32)nodes_.size() - 1;
+    }
+
+    s32 index  = free_list_;
+    free_list_ = nodes_[index].parent_;
+
+    nodes_[index] = Node();
+    return index;
+}
+
+//---------------------------------------------------------------------------
+//! ノードを解放します
+//---------------------------------------------------------------------------
+void CollisionBroadphase::freeNode(s32 node) {
+    nodes_[node]         = Node();
+    nodes_[node].parent_ = free_list_;
+    free_list_           = node;
+}
+
+//---------------------------------------------------------------------------
+//! リーフを挿入します
+//---------------------------------------------------------------------------
+void CollisionBroadphase::insertLeaf(s32 leaf) {
+    if(root_ == NULL_PROXY) {
+        root_                 = leaf;
+        nodes_[root_].parent_ = NULL_PROXY;
+        return;
+    }
+
+    //----------------------------------------------------------
+    // 表面積の増加が最小になる兄弟ノードを探す
+    //----------------------------------------------------------
+    CollisionAABB leaf_aabb = nodes_[leaf].aabb_;
+    s32           index     = root_;
+    while(!nodes_[index].isLeaf()) {
+        const Node& node = nodes_[index];
+
+        f32 area          = node.aabb_.surfaceArea();
+        f32 combined_area = CollisionAABB::merge(node.aabb_, leaf_aabb).surfaceArea();
+
+        // ここに新しい親を作る場合のコスト
+        f32 cost = 2.0f * combined_area;
+
+        // 子へ降りる場合に継承されるコスト
+        f32 inheritance_cost = 2.0f * (combined_area - area);
+
+        auto child_cost = [&](s32 child) {
+            CollisionAABB aabb = CollisionAABB::merge(leaf_aabb, nodes_[child].aabb_);
+            if(nodes_[child].isLeaf())
+                return aabb.surfaceArea() + inheritance_cost;
+            return (aabb.surfaceArea() - nodes_[child].aabb_.surfaceArea()) + inheritance_cost;
+        };
+
+        f32 cost1 = child_cost(node.child1_);
+        f32 cost2 = child_cost(node.child2_);
+
+        if(cost < cost1 && cost < cost2)
+            break;
+
+        index = (cost1 < cost2) ? node.child1_ : node.child2_;
+    }
+
+    //----------------------------------------------------------
+    // 新しい親を作成して兄弟ノードと繋ぐ
+    //----------------------------------------------------------
+    s32 sibling    = index;
+    s32 old_parent = nodes_[sibling].parent_;
+    s32 new_parent = allocateNode();
+
+    nodes_[new_parent].parent_ = old_parent;
+    nodes_[new_parent].aabb_   = CollisionAABB::merge(leaf_aabb, nodes_[sibling].aabb_);
+    nodes_[new_parent].height_ = nodes_[sibling].height_ + 1;
+    nodes_[new_parent].child1_ = sibling;
+    nodes_[new_parent].child2_ = leaf;
+    nodes_[sibling].parent_    = new_parent;
+    nodes_[leaf].parent_       = new_parent;
+
+    if(old_parent != NULL_PROXY) {
+        if(nodes_[old_parent].child1_ == sibling)
+            nodes_[old_parent].child1_ = new_parent;
+        else
+            nodes_[old_parent].child2_ = new_parent;
+    } else {
+        root_ = new_parent;
+    }
+
+    //----------------------------------------------------------
+    // 親をたどってAABBと高さを更新
+    //----------------------------------------------------------
+    index = nodes_[leaf].parent_;
+    while(index != NULL_PROXY) {
+        index = balance(index);
+
+        s32 child1 = nodes_[index].child1_;
+        s32 child2 = nodes_[index].child2_;
+
+        nodes_[index].height_ = 1 + std::max(nodes_[child1].height_, nodes_[child2].height_);
+        nodes_[index].aabb_   = CollisionAABB::merge(nodes_[child1].aabb_, nodes_[child2].aabb_);
+
+        index = nodes_[index].parent_;
+    }
+}
+
+//---------------------------------------------------------------------------
+//! リーフを取り外します
+//---------------------------------------------------------------------------
+void CollisionBroadphase::removeLeaf(s32 leaf) {
+    if(leaf == root_) {
+        root_ = NULL_PROXY;
+        return;
+    }
+
+    s32 parent       = nodes_[leaf].parent_;
+    s32 grand_parent = nodes_[parent].parent_;
+    s32 sibling      = (nodes_[parent].child1_ == leaf) ? nodes_[parent].child2_ : nodes_[parent].child1_;
+
+    if(grand_parent == NULL_PROXY) {
+        // 親がルートだったので兄弟がルートになる
+        root_                   = sibling;
+        nodes_[sibling].parent_ = NULL_PROXY;
+        freeNode(parent);
+        return;
+    }
+
+    // 親を消して兄弟を祖父に繋ぐ
+    if(nodes_[grand_parent].child1_ == parent)
+        nodes_[grand_parent].child1_ = sibling;
+    else
+        nodes_[grand_parent].child2_ = sibling;
+    nodes_[sibling].parent_ = grand_parent;
+    freeNode(parent);
+
+    // 祖先のAABBと高さを更新
+    s32 index = grand_parent;
+    while(index != NULL_PROXY) {
+        index = balance(index);
+
+        s32 child1 = nodes_[index].child1_;
+        s32 child2 = nodes_[index].child2_;
+
+        nodes_[index].aabb_   = CollisionAABB::merge(nodes_[child1].aabb_, nodes_[child2].aabb_);
+        nodes_[index].height_ = 1 + std::max(nodes_[child1].height_, nodes_[child2].height_);
+
+        index = nodes_[index].parent_;
+    }
+}
+
+//---------------------------------------------------------------------------
+//! 回転でツリーのバランスを取ります
+//! @param  [in]    a   対象ノード
+//! @return 回転後にaの位置に来たノード
+//---------------------------------------------------------------------------
+s32 CollisionBroadphase::balance(s32 a) {
+    if(nodes_[a].isLeaf() || nodes_[a].height_ < 2)
+        return a;
+
+    s32 b = nodes_[a].child1_;
+    s32 c = nodes_[a].child2_;
+
+    s32 diff = nodes_[c].height_ - nodes_[b].height_;
+
+    // 高いほうの子を持ち上げる
+    auto rotate = [&](s32 up, s32 other, bool up_is_child2) {
+        Node& node_a  = nodes_[a];
+        Node& node_up = nodes_[up];
+
+        s32 f = node_up.child1_;
+        s32 g = node_up.child2_;
+
+        // upをaの位置へ
+        node_up.child1_ = a;
+        node_up.parent_ = node_a.parent_;
+        node_a.parent_  = up;
+
+        if(node_up.parent_ != NULL_PROXY) {
+            if(nodes_[node_up.parent_].child1_ == a)
+                nodes_[node_up.parent_].child1_ = up;
+            else
+                nodes_[node_up.parent_].child2_ = up;
+        } else {
+            root_ = up;
+        }
+
+        // 低いほうの孫をaに残す
+        s32 keep = f;
+        s32 move = g;
+        if(nodes_[f].height_ <= nodes_[g].height_) {
+            keep = g;
+            move = f;
+        }
+
+        node_up.child2_      = keep;
+        nodes_[move].parent_ = a;
+        if(up_is_child2)
+            node_a.child2_ = move;
+        else
+            node_a.child1_ = move;
+
+        node_a.aabb_    = CollisionAABB::merge(nodes_[other].aabb_, nodes_[move].aabb_);
+        node_up.aabb_   = CollisionAABB::merge(node_a.aabb_, nodes_[keep].aabb_);
+        node_a.height_  = 1 + std::max(nodes_[other].height_, nodes_[move].height_);
+        node_up.height_ = 1 + std::max(node_a.height_, nodes_[keep].height_);
+
+        return up;
+    };
+
+    if(diff > 1)
+        return rotate(c, b, true);
+
+    if(diff < -1)
+        return rotate(b, c, false);
+
+    return a;
+}
@@ -0,0 +1,183 @@
+﻿//---------------------------------------------------------------------------
+//! @file   CollisionBroadphase.h
+//! @brief  コリジョンブロードフェーズ (動的AABBツリー)
+//---------------------------------------------------------------------------
+#pragma once
+
+//===========================================================================
+//! 軸平行境界ボックス
+//===========================================================================
+struct CollisionAABB {
+    float3 min_ = {0.0f, 0.0f, 0.0f};    //!< 最小座標
+    float3 max_ = {0.0f, 0.0f, 0.0f};    //!< 最大座標
+
+    //! 重なっているか
+    bool isOverlap(const CollisionAABB& other) const {
+        if(max_.x < other.min_.x || other.max_.x < min_.x)
+            return false;
+        if(max_.y < other.min_.y || other.max_.y < min_.y)
+            return false;
+        if(max_.z < other.min_.z || other.max_.z < min_.z)
+            return false;
+        return true;
+    }
+
+    //! 完全に内包しているか
+    bool isContain(const CollisionAABB& other) const {
+        return min_.x <= other.min_.x && min_.y <= other.min_.y && min_.z <= other.min_.z &&    //
+               other.max_.x <= max_.x && other.max_.y <= max_.y && other.max_.z <= max_.z;
+    }
+
+    //! 表面積 (SAH用)
+    f32 surfaceArea() const {
+        float3 d = max_ - min_;
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    //! 結合したAABBを取得
+    static CollisionAABB merge(const CollisionAABB& a, const CollisionAABB& b) {
+        return CollisionAABB{min(a.min_, b.min_), max(a.max_, b.max_)};
+    }
+};
+
+//===========================================================================
+//! コリジョンブロードフェーズ
+//! @note 動的AABBツリーでコリジョンの候補ペアを絞り込みます。
+//!       登録したAABBは余白付きで保持され、その範囲から出た時のみツリーを組み替えます
+//===========================================================================
+class CollisionBroadphase final : noncopyable {
+   public:
+    static constexpr s32 NULL_PROXY = -1;    //!< 無効なプロキシ番号
+
+    //! プロキシを作成します
+    //! @param  [in]    aabb        AABB
+    //! @param  [in]    user_data   ユーザーデータ
+    //! @return プロキシ番号
+    s32 createProxy(const CollisionAABB& aabb, void* user_data);
+
+    //! プロキシを削除します
+    //! @param  [in]    proxy   プロキシ番号
+    void destroyProxy(s32 proxy);
+
+    //! プロキシを移動します
+    //! @param  [in]    proxy   プロキシ番号
+    //! @param  [in]    aabb    新しいAABB
+    //! @retval true    ツリーを組み替えた
+    //! @retval false   余白内の移動のため組み替えなし
+    bool moveProxy(s32 proxy, const CollisionAABB& aabb);
+
+    //! 有効なプロキシか
+    bool isValidProxy(s32 proxy) const {
+        return proxy >= 0 && proxy < (s32)nodes_.size() && nodes_[proxy].height_ == 0;
+    }
+
+    //! ユーザーデータを取得
+    void* userData(s32 proxy) const {
+        return nodes_[proxy].user_data_;
+    }
+
+    //! 余白付きAABBを取得
+    const CollisionAABB& fatAABB(s32 proxy) const {
+        return nodes_[proxy].aabb_;
+    }
+
+    //! 重なっているプロキシを探索します
+    //! @param  [in]    aabb        探索範囲
+    //! @param  [in]    callback    bool(s32 proxy) falseを返すと探索を中断します
+    template<class F>
+    void query(const CollisionAABB& aabb, F&& callback) const;
+
+    //! 全プロキシを削除します
+    void clear();
+
+    //! 登録プロキシ数
+    size_t proxyCount() const {
+        return proxy_count_;
+    }
+
+    //! ツリーの高さ
+    s32 height() const {
+        return root_ == NULL_PROXY ? 0 : nodes_[root_].height_;
+    }
+
+    //! AABBの余白を設定
+    void setMargin(f32 margin) {
+        margin_ = margin;
+    }
+
+   public:
+    //! コンストラクタ
+    CollisionBroadphase();
+
+    //! デストラクタ
+    virtual ~CollisionBroadphase() = default;
+
+   private:
+    //! ツリーノード
+    struct Node {
+        CollisionAABB aabb_;                      //!< AABB (リーフは余白付き)
+        void*         user_data_ = nullptr;       //!< ユーザーデータ
+        s32           parent_    = NULL_PROXY;    //!< 親ノード (未使用時は次の空きノード)
+        s32           child1_    = NULL_PROXY;    //!< 子ノード1
+        s32           child2_    = NULL_PROXY;    //!< 子ノード2
+        s32           height_    = -1;            //!< 高さ (リーフ=0, 未使用=-1)
+
+        bool isLeaf() const {
+            return child1_ == NULL_PROXY;
+        }
+    };
+
+    s32  allocateNode();
+    void freeNode(s32 node);
+    void insertLeaf(s32 leaf);
+    void removeLeaf(s32 leaf);
+    s32  balance(s32 node);
+
+    std::vector<Node> nodes_;                       //!< ノード実体
+    s32               root_        = NULL_PROXY;    //!< ルートノード
+    s32               free_list_   = NULL_PROXY;    //!< 空きノードリスト
+    size_t            proxy_count_ = 0;             //!< 登録プロキシ数
+    f32               margin_      = 0.2f;          //!< AABBの余白
+};
+
+//---------------------------------------------------------------------------
+//! 重なっているプロキシを探索します
+//---------------------------------------------------------------------------
+template<class F>
+void CollisionBroadphase::query(const CollisionAABB& aabb, F&& callback) const {
+    if(root_ == NULL_PROXY)
+        return;
+
+    s32              stack_buffer[256];
+    std::vector<s32> stack_overflow;
+    s32              stack_count = 0;
+
+    stack_buffer[stack_count++] = root_;
+
+    while(stack_count > 0 || !stack_overflow.empty()) {
+        s32 index;
+        if(!stack_overflow.empty()) {
+            index = stack_overflow.back();
+            stack_overflow.pop_back();
+        } else {
+            index = stack_buffer[--stack_count];
+        }
+
+        const Node& node = nodes_[index];
+        if(!node.aabb_.isOverlap(aabb))
+            continue;
+
+        if(node.isLeaf()) {
+            if(!callback(index))
+                return;
+            continue;
+        }
+
+        for(s32 child: {node.child1_, node.child2_}) {
+            if(stack_count < (s32)std::size(stack_buffer))
+                stack_buffer[stack_count++] = child;
+            else
+                stack_overflow.push_back(child);
+        }
+    }
+}
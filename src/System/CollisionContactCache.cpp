@@ -0,0 +1,41 @@
+﻿//---------------------------------------------------------------------------
+//! @file   CollisionContactCache.cpp
+//! @brief  コリジョン接触ペアキャッシュ (フレームをまたいだ接触状態)
+//---------------------------------------------------------------------------
+#include "CollisionContactCache.h"
+
+//===========================================================================
+// コリジョン接触ペアキャッシュ CollisionContactCache
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//! フレームの接触の登録を開始します
+//---------------------------------------------------------------------------
+void CollisionContactCache::beginFrame() {
+    current_.clear();
+}
+
+//---------------------------------------------------------------------------
+//! 当たったペアを登録します
+//---------------------------------------------------------------------------
+bool CollisionContactCache::touch(u32 id_1, u32 id_2, const float3& hit_position) {
+    Contact contact;
+    contact.key_          = makeKey(id_1, id_2);
+    contact.id_[0]        = id_1;
+    contact.id_[1]        = id_2;
+    contact.hit_position_ = hit_position;
+    current_.push_back(contact);
+
+    // 前フレームはキー順に並んでいる
+    auto it = std::lower_bound(previous_.begin(), previous_.end(), contact.key_,
+                               [](const Contact& c, u64 key) { return c.key_ < key; });
+    return it != previous_.end() && it->key_ == contact.key_;
+}
+
+//---------------------------------------------------------------------------
+//! 全接触を削除します
+//---------------------------------------------------------------------------
+void CollisionContactCache::clear() {
+    previous_.clear();
+    current_.clear();
+}
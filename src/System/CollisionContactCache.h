@@ -0,0 +1,78 @@
+﻿//---------------------------------------------------------------------------
+//! @file   CollisionContactCache.h
+//! @brief  コリジョン接触ペアキャッシュ (フレームをまたいだ接触状態)
+//---------------------------------------------------------------------------
+#pragma once
+
+#include <algorithm>
+
+//===========================================================================
+//! コリジョン接触ペアキャッシュ
+//! @note コリジョンの接触IDの組で前フレームの接触を保持し、
+//!       開始 (Enter) / 継続 (Stay) / 終了 (Exit) を判別します。
+//!       配列はフレームごとに入れ替えて使いまわすため、毎フレームの確保は発生しません
+//===========================================================================
+class CollisionContactCache final : noncopyable {
+   public:
+    //! 接触ペア
+    struct Contact {
+        u64    key_          = 0;                     //!< 検索キー (接触IDの小さい方が上位)
+        u32    id_[2]        = {0, 0};                //!< 接触ID (当たり判定の順)
+        float3 hit_position_ = {0.0f, 0.0f, 0.0f};    //!< 最後に当たった地点
+    };
+
+    //! フレームの接触の登録を開始します
+    void beginFrame();
+
+    //! @brief 当たったペアを登録します
+    //! @param  [in]    id_1            自分の接触ID
+    //! @param  [in]    id_2            相手の接触ID
+    //! @param  [in]    hit_position    当たった地点
+    //! @retval true    前フレームから続いている接触 (Stay)
+    //! @retval false   新しい接触 (Enter)
+    bool touch(u32 id_1, u32 id_2, const float3& hit_position);
+
+    //! @brief フレームの接触の登録を終了します
+    //! @param  [in]    on_exit     void(const Contact&) 今フレームに当たらなかった前フレームの接触
+    template<class F>
+    void endFrame(F&& on_exit);
+
+    //! 全接触を削除します (Exitは通知しません)
+    void clear();
+
+    //! 接触中のペア数
+    size_t size() const {
+        return previous_.size();
+    }
+
+   private:
+    //! 検索キー
+    static u64 makeKey(u32 id_1, u32 id_2) {
+        return id_1 < id_2 ? (static_cast<u64>(id_1) << 32) | id_2 : (static_cast<u64>(id_2) << 32) | id_1;
+    }
+
+    std::vector<Contact> previous_;    //!< 前フレームの接触 (キー順)
+    std::vector<Contact> current_;     //!< 今フレームの接触
+};
+
+//---------------------------------------------------------------------------
+//! フレームの接触の登録を終了します
+//---------------------------------------------------------------------------
+template<class F>
+void CollisionContactCache::endFrame(F&& on_exit) {
+    std::sort(current_.begin(), current_.end(), [](const Contact& a, const Contact& b) { return a.key_ < b.key_; });
+
+    // どちらもキー順なので突き合わせて今フレームに無いものを探す
+    auto it = current_.begin();
+    for(auto& contact: previous_) {
+        while(it != current_.end() && it->key_ < contact.key_)
+            ++it;
+        if(it != current_.end() && it->key_ == contact.key_)
+            continue;
+
+        on_exit(contact);
+    }
+
+    std::swap(previous_, current_);
+    current_.clear();
+}
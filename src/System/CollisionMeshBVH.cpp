@@ -0,0 +1,717 @@
+﻿//---------------------------------------------------------------------------
+//! @file   CollisionMeshBVH.cpp
+//! @brief  コリジョンメッシュBVH (三角形の境界ボリューム階層)
+//---------------------------------------------------------------------------
+#include "CollisionMeshBVH.h"
+#include "CollisionBroadphase.h"
+
+#include <algorithm>
+
+namespace {
+constexpr f32 SEGMENT_EPSILON = 1.0e-6f;    //!< 線分の長さを0とみなす値
+constexpr u32 MAX_LEAF_COST   = 16;         //!< SAHで分割しない場合に葉にできる三角形数の上限
+
+//! 構築用の三角形
+struct BuildTriangle {
+    CollisionAABB bounds_;      //!< 境界AABB
+    float3        centroid_;    //!< 重心 (AABBの中心)
+};
+
+//! SAHの分割候補
+struct Bin {
+    CollisionAABB bounds_;
+    u32           count_ = 0;
+};
+
+//---------------------------------------------------------------------------
+//! BVH構築
+//---------------------------------------------------------------------------
+class Builder {
+   public:
+    Builder(std::span<const VECTOR> vertices, std::span<const u32> indices) {
+        const u32 triangle_count = static_cast<u32>(indices.size() / 3);
+
+        triangles_.resize(triangle_count);
+        order_.resize(triangle_count);
+        for(u32 i = 0; i < triangle_count; ++i) {
+            float3 v0 = cast(vertices[indices[i * 3 + 0]]);
+            float3 v1 = cast(vertices[indices[i * 3 + 1]]);
+            float3 v2 = cast(vertices[indices[i * 3 + 2]]);
+
+            auto& triangle     = triangles_[i];
+            triangle.bounds_   = {min(min(v0, v1), v2), max(max(v0, v1), v2)};
+            triangle.centroid_ = (triangle.bounds_.min_ + triangle.bounds_.max_) * 0.5f;
+            order_[i]          = i;
+        }
+    }
+
+    //! 構築
+    void build(std::vector<CollisionMeshBVH::Node>& nodes) {
+        nodes.clear();
+        nodes.reserve(triangles_.size() * 2);
+        buildNode(nodes, 0, static_cast<u32>(triangles_.size()), 0);
+    }
+
+    //! 葉の順に並べた三角形番号
+    const std::vector<u32>& order() const {
+        return order_;
+    }
+
+   private:
+    //! 範囲の三角形からノードを作成します
+    void buildNode(std::vector<CollisionMeshBVH::Node>& nodes, u32 begin, u32 end, u32 depth) {
+        const u32 node_index = static_cast<u32>(nodes.size());
+        nodes.emplace_back();
+
+        // 境界と重心の範囲
+        CollisionAABB bounds          = triangles_[order_[begin]].bounds_;
+        CollisionAABB centroid_bounds = {triangles_[order_[begin]].centroid_, triangles_[order_[begin]].centroid_};
+        for(u32 i = begin + 1; i < end; ++i) {
+            const auto& triangle   = triangles_[order_[i]];
+            bounds                 = CollisionAABB::merge(bounds, triangle.bounds_);
+            centroid_bounds.min_   = min(centroid_bounds.min_, triangle.centroid_);
+            centroid_bounds.max_   = max(centroid_bounds.max_, triangle.centroid_);
+        }
+        setBounds(nodes[node_index], bounds);
+
+        const u32 count = end - begin;
+        auto      leaf  = [&]() {
+            nodes[node_index].offset_ = begin;
+            nodes[node_index].count_  = count;
+        };
+
+        if(count <= CollisionMeshBVH::LEAF_TRIANGLES || depth >= CollisionMeshBVH::MAX_DEPTH) {
+            leaf();
+            return;
+        }
+
+        // SAHで最もコストの低い分割を探す
+        u32 split_axis = 0;
+        u32 split_bin  = 0;
+        f32 split_cost = FLT_MAX;
+
+        const f32 extent[3] = {centroid_bounds.max_.x - centroid_bounds.min_.x, centroid_bounds.max_.y - centroid_bounds.min_.y,
+                               centroid_bounds.max_.z - centroid_bounds.min_.z};
+        const f32 origin[3] = {centroid_bounds.min_.x, centroid_bounds.min_.y, centroid_bounds.min_.z};
+
+        for(u32 axis = 0; axis < 3; ++axis) {
+            if(extent[axis] <= SEGMENT_EPSILON)
+                continue;
+
+            Bin       bins[CollisionMeshBVH::SAH_BINS];
+            const f32 scale = CollisionMeshBVH::SAH_BINS / extent[axis];
+            for(u32 i = begin; i < end; ++i) {
+                const auto& triangle = triangles_[order_[i]];
+                auto&       bin      = bins[binIndex(triangle.centroid_, axis, origin[axis], scale)];
+                bin.bounds_          = bin.count_ ? CollisionAABB::merge(bin.bounds_, triangle.bounds_) : triangle.bounds_;
+                bin.count_++;
+            }
+
+            // 右側の累積を先に求めておき、左から走査する
+            f32           right_area[CollisionMeshBVH::SAH_BINS] = {};
+            u32           right_count[CollisionMeshBVH::SAH_BINS] = {};
+            CollisionAABB right_bounds;
+            u32           right_total = 0;
+            for(u32 b = CollisionMeshBVH::SAH_BINS - 1; b > 0; --b) {
+                if(bins[b].count_) {
+                    right_bounds = right_total ? CollisionAABB::merge(right_bounds, bins[b].bounds_) : bins[b].bounds_;
+                    right_total += bins[b].count_;
+                }
+                right_area[b]  = right_total ? right_bounds.surfaceArea() : 0.0f;
+                right_count[b] = right_total;
+            }
+
+            CollisionAABB left_bounds;
+            u32           left_total = 0;
+            for(u32 b = 0; b < CollisionMeshBVH::SAH_BINS - 1; ++b) {
+                if(bins[b].count_) {
+                    left_bounds = left_total ? CollisionAABB::merge(left_bounds, bins[b].bounds_) : bins[b].bounds_;
+                    left_total += bins[b].count_;
+                }
+                if(left_total == 0 || right_count[b + 1] == 0)
+                    continue;
+
+                f32 cost = left_bounds.surfaceArea() * left_total + right_area[b + 1] * right_count[b + 1];
+                if(cost < split_cost) {
+                    split_cost = cost;
+                    split_axis = axis;
+                    split_bin  = b;
+                }
+            }
+        }
+
+        u32 middle = begin;
+        if(split_cost < FLT_MAX) {
+            // 分割しない方が安い場合は葉にする
+            f32 leaf_cost = bounds.surfaceArea() * count;
+            if(split_cost >= leaf_cost && count <= MAX_LEAF_COST) {
+                leaf();
+                return;
+            }
+
+            const f32 scale = CollisionMeshBVH::SAH_BINS / extent[split_axis];
+            auto      it    = std::partition(order_.begin() + begin, order_.begin() + end, [&](u32 index) {
+                return binIndex(triangles_[index].centroid_, split_axis, origin[split_axis], scale) <= split_bin;
+            });
+            middle          = static_cast<u32>(it - order_.begin());
+        } else {
+            // 重心がすべて同じ位置にある場合は数で半分にする
+            if(count <= MAX_LEAF_COST) {
+                leaf();
+                return;
+            }
+            middle = begin + count / 2;
+        }
+
+        buildNode(nodes, begin, middle, depth + 1);
+        nodes[node_index].offset_ = static_cast<u32>(nodes.size());
+        nodes[node_index].count_  = 0;
+        buildNode(nodes, middle, end, depth + 1);
+    }
+
+    //! 重心の属する分割候補
+    static u32 binIndex(const float3& centroid, u32 axis, f32 origin, f32 scale) {
+        f32 value = axis == 0 ? centroid.x : (axis == 1 ? centroid.y : centroid.z);
+        s32 index = static_cast<s32>((value - origin) * scale);
+        return static_cast<u32>(std::clamp(index, 0, static_cast<s32>(CollisionMeshBVH::SAH_BINS) - 1));
+    }
+
+    //! ノードに境界を設定
+    static void setBounds(CollisionMeshBVH::Node& node, const CollisionAABB& bounds) {
+        node.min_[0] = bounds.min_.x;
+        node.min_[1] = bounds.min_.y;
+        node.min_[2] = bounds.min_.z;
+        node.max_[0] = bounds.max_.x;
+        node.max_[1] = bounds.max_.y;
+        node.max_[2] = bounds.max_.z;
+    }
+
+    std::vector<BuildTriangle> triangles_;    //!< 三角形
+    std::vector<u32>           order_;        //!< 三角形番号 (構築中に並べ替える)
+};
+
+//---------------------------------------------------------------------------
+//! 点と三角形の最近点 (Real-Time Collision Detection 5.1.5)
+//---------------------------------------------------------------------------
+float3 closestPointTriangle(const float3& p, const float3& a, const float3& b, const float3& c) {
+    float3 ab = b - a;
+    float3 ac = c - a;
+    float3 ap = p - a;
+    f32    d1 = dot(ab, ap);
+    f32    d2 = dot(ac, ap);
+    if(d1 <= 0.0f && d2 <= 0.0f)
+        return a;
+
+    float3 bp = p - b;
+    f32    d3 = dot(ab, bp);
+    f32    d4 = dot(ac, bp);
+    if(d3 >= 0.0f && d4 <= d3)
+        return b;
+
+    f32 vc = d1 * d4 - d3 * d2;
+    if(vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+        return a + ab * (d1 / (d1 - d3));
+
+    float3 cp = p - c;
+    f32    d5 = dot(ab, cp);
+    f32    d6 = dot(ac, cp);
+    if(d6 >= 0.0f && d5 <= d6)
+        return c;
+
+    f32 vb = d5 * d2 - d1 * d6;
+    if(vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+        return a + ac * (d2 / (d2 - d6));
+
+    f32 va = d3 * d6 - d5 * d4;
+    if(va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+    f32 denom = 1.0f / (va + vb + vc);
+    return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+//---------------------------------------------------------------------------
+//! 線分どうしの最近点 (Real-Time Collision Detection 5.1.9)
+//! @return 最近点どうしの距離の2乗
+//---------------------------------------------------------------------------
+f32 closestSegmentSegment(const float3& p1, const float3& q1, const float3& p2, const float3& q2, float3* c1, float3* c2) {
+    float3 d1 = q1 - p1;
+    float3 d2 = q2 - p2;
+    float3 r  = p1 - p2;
+    f32    a  = dot(d1, d1);
+    f32    e  = dot(d2, d2);
+    f32    f  = dot(d2, r);
+    f32    s  = 0.0f;
+    f32    t  = 0.0f;
+
+    if(a <= SEGMENT_EPSILON && e <= SEGMENT_EPSILON) {
+        // どちらも点
+    } else if(a <= SEGMENT_EPSILON) {
+        t = std::clamp(f / e, 0.0f, 1.0f);
+    } else {
+        f32 c = dot(d1, r);
+        if(e <= SEGMENT_EPSILON) {
+            s = std::clamp(-c / a, 0.0f, 1.0f);
+        } else {
+            f32 b     = dot(d1, d2);
+            f32 denom = a * e - b * b;
+            s         = denom > SEGMENT_EPSILON ? std::clamp((b * f - c * e) / denom, 0.0f, 1.0f) : 0.0f;
+            t         = (b * s + f) / e;
+            if(t < 0.0f) {
+                t = 0.0f;
+                s = std::clamp(-c / a, 0.0f, 1.0f);
+            } else if(t > 1.0f) {
+                t = 1.0f;
+                s = std::clamp((b - c) / a, 0.0f, 1.0f);
+            }
+        }
+    }
+
+    *c1      = p1 + d1 * s;
+    *c2      = p2 + d2 * t;
+    float3 d = *c1 - *c2;
+    return dot(d, d);
+}
+
+//---------------------------------------------------------------------------
+//! 線分と三角形の交差 (両面 / Möller-Trumbore)
+//! @param  [out]   t   始点から終点までの割合
+//---------------------------------------------------------------------------
+bool intersectSegmentTriangle(const float3& p, const float3& d, const float3& a, const float3& b, const float3& c, f32* t) {
+    float3 e1  = b - a;
+    float3 e2  = c - a;
+    float3 h   = cross(d, e2);
+    f32    det = dot(e1, h);
+    if(fabsf(det) <= 1.0e-12f)
+        return false;
+
+    f32    inv_det = 1.0f / det;
+    float3 s       = p - a;
+    f32    u       = dot(s, h) * inv_det;
+    if(u < 0.0f || u > 1.0f)
+        return false;
+
+    float3 q = cross(s, e1);
+    f32    v = dot(d, q) * inv_det;
+    if(v < 0.0f || u + v > 1.0f)
+        return false;
+
+    f32 hit_t = dot(e2, q) * inv_det;
+    if(hit_t < 0.0f || hit_t > 1.0f)
+        return false;
+
+    *t = hit_t;
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! 線分と三角形の最近点
+//! @return 最近点どうしの距離の2乗
+//---------------------------------------------------------------------------
+f32 closestSegmentTriangle(const float3& p, const float3& q, const float3 (&v)[3], float3* segment_point,
+                           float3* triangle_point) {
+    // 貫通していれば交点が最近点
+    f32 t = 0.0f;
+    if(intersectSegmentTriangle(p, q - p, v[0], v[1], v[2], &t)) {
+        *segment_point  = p + (q - p) * t;
+        *triangle_point = *segment_point;
+        return 0.0f;
+    }
+
+    // 貫通していない場合は端点と三角形、線分と各辺のいずれかが最近点になる
+    float3 tp          = closestPointTriangle(p, v[0], v[1], v[2]);
+    float3 d           = p - tp;
+    f32    distance_sq = dot(d, d);
+    *segment_point     = p;
+    *triangle_point    = tp;
+
+    tp = closestPointTriangle(q, v[0], v[1], v[2]);
+    d  = q - tp;
+    if(f32 dsq = dot(d, d); dsq < distance_sq) {
+        distance_sq     = dsq;
+        *segment_point  = q;
+        *triangle_point = tp;
+    }
+
+    for(u32 i = 0; i < 3; ++i) {
+        float3 c1;
+        float3 c2;
+        if(f32 dsq = closestSegmentSegment(p, q, v[i], v[(i + 1) % 3], &c1, &c2); dsq < distance_sq) {
+            distance_sq     = dsq;
+            *segment_point  = c1;
+            *triangle_point = c2;
+        }
+    }
+    return distance_sq;
+}
+
+//---------------------------------------------------------------------------
+//! 三角形どうしの最近点
+//! @return 最近点どうしの距離の2乗
+//---------------------------------------------------------------------------
+f32 closestTriangleTriangle(const float3 (&s)[3], const float3 (&v)[3], float3* shape_point, float3* triangle_point) {
+    f32 distance_sq = FLT_MAX;
+
+    // 交差していればどちらかの辺がもう一方を貫通するため、辺と三角形の組み合わせで求まる
+    for(u32 i = 0; i < 3; ++i) {
+        float3 c1;
+        float3 c2;
+        if(f32 dsq = closestSegmentTriangle(s[i], s[(i + 1) % 3], v, &c1, &c2); dsq < distance_sq) {
+            distance_sq     = dsq;
+            *shape_point    = c1;
+            *triangle_point = c2;
+        }
+        if(f32 dsq = closestSegmentTriangle(v[i], v[(i + 1) % 3], s, &c2, &c1); dsq < distance_sq) {
+            distance_sq     = dsq;
+            *shape_point    = c1;
+            *triangle_point = c2;
+        }
+    }
+    return distance_sq;
+}
+
+//---------------------------------------------------------------------------
+//! 三角形の法線 (指定した点の側を向く)
+//---------------------------------------------------------------------------
+float3 triangleNormal(const float3 (&v)[3], const float3& toward) {
+    float3 n  = cross(v[1] - v[0], v[2] - v[0]);
+    f32    sq = dot(n, n);
+    if(sq <= 1.0e-20f)
+        return float3(0.0f, 1.0f, 0.0f);
+
+    n = n / sqrtf(sq);
+    return static_cast<f32>(dot(n, toward - v[0])) < 0.0f ? -n : n;
+}
+
+//---------------------------------------------------------------------------
+//! 点を行列で変換
+//---------------------------------------------------------------------------
+float3 transformPoint(const float3& p, const matrix& m) {
+    return mul(float4(p, 1.0f), m).xyz;
+}
+
+}    // namespace
+
+//===========================================================================
+// コリジョンメッシュBVH CollisionMeshBVH
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//! 三角形からBVHを構築します
+//---------------------------------------------------------------------------
+CollisionMeshBVH::Source CollisionMeshBVH::build(std::span<const VECTOR> vertices, std::span<const u32> indices) {
+    Source source;
+    if(vertices.empty() || indices.size() < 3)
+        return source;
+
+    Builder builder(vertices, indices);
+    builder.build(source.nodes_);
+
+    // 葉が連続した範囲を参照できるようにインデックスを並べ替える
+    source.indices_.reserve(builder.order().size() * 3);
+    for(u32 triangle: builder.order()) {
+        source.indices_.push_back(indices[triangle * 3 + 0]);
+        source.indices_.push_back(indices[triangle * 3 + 1]);
+        source.indices_.push_back(indices[triangle * 3 + 2]);
+    }
+    return source;
+}
+
+//---------------------------------------------------------------------------
+//! 構築済みの配列が問い合わせに使えるか検証します
+//---------------------------------------------------------------------------
+bool CollisionMeshBVH::validate(size_t vertex_count, std::span<const Node> nodes, std::span<const u32> indices) {
+    // 三角形が無い場合はノードも作られない (問い合わせもされない)
+    if(nodes.empty())
+        return true;
+
+    if(indices.size() % 3 != 0)
+        return false;
+    for(u32 index: indices) {
+        if(index >= vertex_count)
+            return false;
+    }
+
+    const u32 node_count     = static_cast<u32>(nodes.size());
+    const u32 triangle_count = static_cast<u32>(indices.size() / 3);
+
+    // 子は必ず親より後ろにある (深さ優先順) ため、前から順に深さを伝えれば循環もスタックのあふれも検出できる
+    std::vector<u32> depth(node_count, 0);
+    for(u32 i = 0; i < node_count; ++i) {
+        const Node& node = nodes[i];
+        if(node.count_ == 0) {
+            // 左の子は次のノード、右の子はそれより後ろ
+            if(node.offset_ <= i + 1 || node.offset_ >= node_count || depth[i] >= MAX_DEPTH)
+                return false;
+
+            depth[i + 1]        = std::max(depth[i + 1], depth[i] + 1);
+            depth[node.offset_] = std::max(depth[node.offset_], depth[i] + 1);
+        } else if(node.count_ > triangle_count || node.offset_ > triangle_count - node.count_) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! 構築済みの配列を参照します
+//---------------------------------------------------------------------------
+void CollisionMeshBVH::attach(std::span<const VECTOR> vertices, std::span<const Node> nodes, std::span<const u32> indices) {
+    vertices_ = vertices;
+    nodes_    = nodes;
+    indices_  = indices;
+}
+
+//---------------------------------------------------------------------------
+//! 参照を解除します
+//---------------------------------------------------------------------------
+void CollisionMeshBVH::reset() {
+    vertices_ = {};
+    nodes_    = {};
+    indices_  = {};
+}
+
+//---------------------------------------------------------------------------
+//! 三角形をワールド空間で取得します
+//---------------------------------------------------------------------------
+void CollisionMeshBVH::triangle(u32 triangle, const matrix& world, float3 (&v)[3]) const {
+    for(u32 i = 0; i < 3; ++i)
+        v[i] = transformPoint(cast(vertices_[indices_[triangle * 3 + i]]), world);
+}
+
+//---------------------------------------------------------------------------
+//! 全三角形を内包するAABBをワールド空間で取得します
+//---------------------------------------------------------------------------
+bool CollisionMeshBVH::worldBounds(const matrix& world, float3* world_min, float3* world_max) const {
+    if(!isValid())
+        return false;
+
+    // ルートノードの8頂点を変換して内包する
+    const Node& root = nodes_[0];
+    for(u32 i = 0; i < 8; ++i) {
+        float3 corner(root.min_[0], root.min_[1], root.min_[2]);
+        if(i & 1)
+            corner.x = root.max_[0];
+        if(i & 2)
+            corner.y = root.max_[1];
+        if(i & 4)
+            corner.z = root.max_[2];
+
+        float3 p   = transformPoint(corner, world);
+        *world_min = i ? min(*world_min, p) : p;
+        *world_max = i ? max(*world_max, p) : p;
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! ワールド空間のAABBに重なる葉を列挙します
+//---------------------------------------------------------------------------
+template<class F>
+void CollisionMeshBVH::queryAABB(const float3& world_min, const float3& world_max, const matrix& world,
+                                 F&& on_triangle) const {
+    // 8頂点をモデル空間に変換して内包するAABBにする
+    const matrix inv_world = inverse(world);
+
+    float3 local_min = transformPoint(world_min, inv_world);
+    float3 local_max = local_min;
+    for(u32 i = 1; i < 8; ++i) {
+        float3 corner(i & 1 ? world_max.x : world_min.x, i & 2 ? world_max.y : world_min.y, i & 4 ? world_max.z : world_min.z);
+        float3 p  = transformPoint(corner, inv_world);
+        local_min = min(local_min, p);
+        local_max = max(local_max, p);
+    }
+    const f32 query_min[3] = {local_min.x, local_min.y, local_min.z};
+    const f32 query_max[3] = {local_max.x, local_max.y, local_max.z};
+
+    u32 stack[MAX_DEPTH + 2];
+    u32 stack_count    = 0;
+    stack[stack_count++] = 0;
+
+    while(stack_count) {
+        const Node& node = nodes_[stack[--stack_count]];
+
+        if(node.max_[0] < query_min[0] || query_max[0] < node.min_[0] ||    //
+           node.max_[1] < query_min[1] || query_max[1] < node.min_[1] ||    //
+           node.max_[2] < query_min[2] || query_max[2] < node.min_[2])
+            continue;
+
+        if(node.count_ == 0) {
+            stack[stack_count++] = node.offset_;
+            stack[stack_count++] = static_cast<u32>(&node - nodes_.data()) + 1;
+            continue;
+        }
+
+        // 三角形はワールド空間で判定する (非一様スケールでも形状が歪まないように)
+        for(u32 triangle = node.offset_; triangle < node.offset_ + node.count_; ++triangle) {
+            float3 v[3];
+            this->triangle(triangle, world, v);
+            on_triangle(triangle, v);
+        }
+    }
+}
+
+//---------------------------------------------------------------------------
+//! 線分で最も手前の三角形を調べます
+//---------------------------------------------------------------------------
+bool CollisionMeshBVH::raycast(const matrix& world, const float3& start, const float3& end, RayHit* hit) const {
+    if(!isValid())
+        return false;
+
+    // 線分をモデル空間に変換する (アフィン変換では線分上の割合は変わらない)
+    const matrix inv_world = inverse(world);
+    const float3 origin    = transformPoint(start, inv_world);
+    const float3 direction = transformPoint(end, inv_world) - origin;
+
+    const f32 o[3]       = {origin.x, origin.y, origin.z};
+    const f32 d[3]       = {direction.x, direction.y, direction.z};
+    f32       inv_d[3];
+    for(u32 axis = 0; axis < 3; ++axis)
+        // 軸に平行な場合はスラブの内外だけで決まるように大きな値にしておく
+        inv_d[axis] = fabsf(d[axis]) > 1.0e-12f ? 1.0f / d[axis] : (d[axis] < 0.0f ? -FLT_MAX : FLT_MAX);
+
+    // スラブ法でノードに入る割合を求める
+    auto enter = [&](const Node& node, f32 t_max) {
+        f32 t_near = 0.0f;
+        f32 t_far  = t_max;
+        for(u32 axis = 0; axis < 3; ++axis) {
+            f32 t0 = (node.min_[axis] - o[axis]) * inv_d[axis];
+            f32 t1 = (node.max_[axis] - o[axis]) * inv_d[axis];
+            if(t0 > t1)
+                std::swap(t0, t1);
+            t_near = std::max(t_near, t0);
+            t_far  = std::min(t_far, t1);
+        }
+        return t_near <= t_far ? t_near : FLT_MAX;
+    };
+
+    f32 best_t        = 1.0f;
+    u32 best_triangle = ~0u;
+
+    u32 stack[MAX_DEPTH + 2];
+    u32 stack_count = 0;
+    if(enter(nodes_[0], best_t) != FLT_MAX)
+        stack[stack_count++] = 0;
+
+    while(stack_count) {
+        const u32   node_index = stack[--stack_count];
+        const Node& node       = nodes_[node_index];
+
+        if(node.count_ == 0) {
+            // 手前の子を先に調べる
+            u32 near_child = node_index + 1;
+            u32 far_child  = node.offset_;
+            f32 near_t     = enter(nodes_[near_child], best_t);
+            f32 far_t      = enter(nodes_[far_child], best_t);
+            if(far_t < near_t) {
+                std::swap(near_child, far_child);
+                std::swap(near_t, far_t);
+            }
+            if(far_t != FLT_MAX)
+                stack[stack_count++] = far_child;
+            if(near_t != FLT_MAX)
+                stack[stack_count++] = near_child;
+            continue;
+        }
+
+        // すでにより手前で当たっていれば調べない
+        if(enter(node, best_t) == FLT_MAX)
+            continue;
+
+        for(u32 triangle = node.offset_; triangle < node.offset_ + node.count_; ++triangle) {
+            f32 t = 0.0f;
+            if(intersectSegmentTriangle(origin, direction, cast(vertices_[indices_[triangle * 3 + 0]]),
+                                        cast(vertices_[indices_[triangle * 3 + 1]]),
+                                        cast(vertices_[indices_[triangle * 3 + 2]]), &t) &&
+               t <= best_t) {
+                best_t        = t;
+                best_triangle = triangle;
+            }
+        }
+    }
+
+    if(best_triangle == ~0u)
+        return false;
+
+    float3 v[3];
+    triangle(best_triangle, world, v);
+
+    hit->t_        = best_t;
+    hit->triangle_ = best_triangle;
+    hit->position_ = start + (end - start) * best_t;
+    hit->normal_   = triangleNormal(v, start);
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! 球を動かした範囲に触れる三角形を集めます
+//---------------------------------------------------------------------------
+u32 CollisionMeshBVH::sweepSphere(const matrix& world, const float3& from, const float3& to, f32 radius,
+                                  std::vector<TriangleContact>* contacts) const {
+    if(!isValid())
+        return 0;
+
+    const f32 radius_sq = radius * radius;
+    const u32 first     = static_cast<u32>(contacts->size());
+
+    queryAABB(min(from, to) - float3(radius), max(from, to) + float3(radius), world, [&](u32 triangle, const float3(&v)[3]) {
+        TriangleContact contact;
+        contact.distance_sq_ = closestSegmentTriangle(from, to, v, &contact.shape_point_, &contact.triangle_point_);
+        if(contact.distance_sq_ > radius_sq)
+            return;
+
+        contact.triangle_ = triangle;
+        contact.normal_   = triangleNormal(v, from);
+        contacts->push_back(contact);
+    });
+
+    return static_cast<u32>(contacts->size()) - first;
+}
+
+//---------------------------------------------------------------------------
+//! カプセルを動かした範囲に触れる三角形を集めます
+//---------------------------------------------------------------------------
+u32 CollisionMeshBVH::sweepCapsule(const matrix& world, const float3& p0, const float3& p1, const float3& move, f32 radius,
+                                   std::vector<TriangleContact>* contacts) const {
+    // 動いていない/点の場合は線分の掃引 (カプセル) と同じ
+    if(static_cast<f32>(dot(move, move)) <= SEGMENT_EPSILON)
+        return sweepSphere(world, p0, p1, radius, contacts);
+
+    float3 axis = p1 - p0;
+    if(static_cast<f32>(dot(axis, axis)) <= SEGMENT_EPSILON)
+        return sweepSphere(world, p0, p0 + move, radius, contacts);
+
+    if(!isValid())
+        return 0;
+
+    const f32 radius_sq = radius * radius;
+    const u32 first     = static_cast<u32>(contacts->size());
+
+    // 線分が掃引する平行四辺形を2つの三角形に分ける
+    const float3 quad[2][3] = {{p0, p1, p1 + move}, {p0, p1 + move, p0 + move}};
+
+    float3 world_min = min(min(p0, p1), min(p0 + move, p1 + move)) - float3(radius);
+    float3 world_max = max(max(p0, p1), max(p0 + move, p1 + move)) + float3(radius);
+
+    queryAABB(world_min, world_max, world, [&](u32 triangle, const float3(&v)[3]) {
+        TriangleContact contact;
+        contact.distance_sq_ = FLT_MAX;
+        for(auto& half: quad) {
+            float3 shape_point;
+            float3 triangle_point;
+            if(f32 dsq = closestTriangleTriangle(half, v, &shape_point, &triangle_point); dsq < contact.distance_sq_) {
+                contact.distance_sq_    = dsq;
+                contact.shape_point_    = shape_point;
+                contact.triangle_point_ = triangle_point;
+            }
+        }
+        if(contact.distance_sq_ > radius_sq)
+            return;
+
+        contact.triangle_ = triangle;
+        contact.normal_   = triangleNormal(v, (p0 + p1) * 0.5f);
+        contacts->push_back(contact);
+    });
+
+    return static_cast<u32>(contacts->size()) - first;
+}
@@ -0,0 +1,152 @@
+﻿//---------------------------------------------------------------------------
+//! @file   CollisionMeshBVH.h
+//! @brief  コリジョンメッシュBVH (三角形の境界ボリューム階層)
+//---------------------------------------------------------------------------
+#pragma once
+
+#include <span>
+
+//===========================================================================
+//! コリジョンメッシュBVH
+//! @note モデルキャッシュの三角形からSAH (表面積ヒューリスティック) で構築した静的なBVHです。
+//!       ノードと三角形はモデル空間で保持し、キャッシュファイル内をそのまま参照します。
+//!       問い合わせはワールド行列を受け取るため、移動/回転するモデルでも作り直しは不要です
+//===========================================================================
+class CollisionMeshBVH final {
+   public:
+    static constexpr u32 LEAF_TRIANGLES = 4;     //!< 葉にまとめる三角形数の目安
+    static constexpr u32 MAX_DEPTH      = 60;    //!< ツリーの最大の深さ
+    static constexpr u32 SAH_BINS       = 12;    //!< SAHの分割候補数 (軸ごと)
+
+    //! ノード (キャッシュファイルにそのまま保存されます)
+    struct alignas(16) Node {
+        f32 min_[3];    //!< 境界AABBの最小座標 (モデル空間)
+        u32 offset_;    //!< 内部ノード:右の子のノード番号 / 葉:先頭の三角形番号
+        f32 max_[3];    //!< 境界AABBの最大座標 (モデル空間)
+        u32 count_;     //!< 葉の三角形数 (0の場合は内部ノード。左の子は次のノード)
+    };
+    static_assert(sizeof(Node) == 32);
+
+    //! 構築結果
+    struct Source {
+        std::vector<Node> nodes_;      //!< ノード配列 (深さ優先順)
+        std::vector<u32>  indices_;    //!< 三角形のインデックス配列 (葉の順に並べ替え済み)
+    };
+
+    //! レイの当たり
+    struct RayHit {
+        f32    t_        = 0.0f;                  //!< 始点から終点までの割合 (0～1)
+        u32    triangle_ = 0;                     //!< 三角形番号 (BVH内の順序)
+        float3 position_ = {0.0f, 0.0f, 0.0f};    //!< 当たった地点 (ワールド空間)
+        float3 normal_   = {0.0f, 1.0f, 0.0f};    //!< 三角形の法線 (始点側を向く)
+    };
+
+    //! 形状と三角形の接触
+    struct TriangleContact {
+        u32    triangle_       = 0;                     //!< 三角形番号 (BVH内の順序)
+        float3 shape_point_    = {0.0f, 0.0f, 0.0f};    //!< 形状の芯 (線分/掃引面) 上の最近点
+        float3 triangle_point_ = {0.0f, 0.0f, 0.0f};    //!< 三角形上の最近点
+        float3 normal_         = {0.0f, 1.0f, 0.0f};    //!< 三角形の法線 (形状の始点側を向く)
+        f32    distance_sq_    = 0.0f;                  //!< 最近点どうしの距離の2乗
+    };
+
+    //! @brief 三角形からBVHを構築します
+    //! @param  [in]    vertices    頂点配列 (モデル空間)
+    //! @param  [in]    indices     インデックス配列 (三角形リスト)
+    //! @return ノード配列と並べ替えたインデックス配列
+    //! @note DxLibを使用しないためワーカースレッドで実行できます
+    static Source build(std::span<const VECTOR> vertices, std::span<const u32> indices);
+
+    //! @brief 構築済みの配列が問い合わせに使えるか検証します
+    //! @param  [in]    vertex_count    頂点数
+    //! @param  [in]    nodes           ノード配列
+    //! @param  [in]    indices         並べ替え済みのインデックス配列
+    //! @retval true    子のノード番号・葉の三角形の範囲・頂点番号がすべて範囲内で、深さも上限以内
+    //! @note キャッシュファイルから読み込んだ配列を attach() する前に使用します
+    static bool validate(size_t vertex_count, std::span<const Node> nodes, std::span<const u32> indices);
+
+    //! @brief 構築済みの配列を参照します (コピーはしません)
+    //! @param  [in]    vertices    頂点配列
+    //! @param  [in]    nodes       ノード配列
+    //! @param  [in]    indices     並べ替え済みのインデックス配列
+    void attach(std::span<const VECTOR> vertices, std::span<const Node> nodes, std::span<const u32> indices);
+
+    //! 参照を解除します
+    void reset();
+
+    //! 問い合わせ可能か
+    bool isValid() const {
+        return !nodes_.empty();
+    }
+
+    //! ノード数
+    u32 nodeCount() const {
+        return static_cast<u32>(nodes_.size());
+    }
+
+    //! 三角形数
+    u32 triangleCount() const {
+        return static_cast<u32>(indices_.size() / 3);
+    }
+
+    //! 使用メモリ量 (キャッシュファイル内のノード配列とインデックス配列)
+    size_t sizeBytes() const {
+        return nodes_.size_bytes() + indices_.size_bytes();
+    }
+
+    //! @brief 三角形をワールド空間で取得します
+    //! @param  [in]    triangle    三角形番号 (BVH内の順序)
+    //! @param  [in]    world       モデルのワールド行列
+    //! @param  [out]   v           三角形の3頂点
+    void triangle(u32 triangle, const matrix& world, float3 (&v)[3]) const;
+
+    //! @brief 全三角形を内包するAABBをワールド空間で取得します
+    //! @param  [in]    world       モデルのワールド行列
+    //! @param  [out]   world_min   最小座標
+    //! @param  [out]   world_max   最大座標
+    //! @return 取得できたか
+    bool worldBounds(const matrix& world, float3* world_min, float3* world_max) const;
+
+    //! @brief 線分で最も手前の三角形を調べます (両面)
+    //! @param  [in]    world   モデルのワールド行列
+    //! @param  [in]    start   始点 (ワールド空間)
+    //! @param  [in]    end     終点 (ワールド空間)
+    //! @param  [out]   hit     当たり情報
+    //! @return 当たったか
+    bool raycast(const matrix& world, const float3& start, const float3& end, RayHit* hit) const;
+
+    //! @brief 球を始点から終点まで動かした範囲 (カプセル) に触れる三角形を集めます
+    //! @param  [in]    world       モデルのワールド行列
+    //! @param  [in]    from        移動前の球の中心 (ワールド空間)
+    //! @param  [in]    to          移動後の球の中心 (ワールド空間)
+    //! @param  [in]    radius      球の半径
+    //! @param  [out]   contacts    接触 (追加されます)
+    //! @return 追加した接触数
+    u32 sweepSphere(const matrix& world, const float3& from, const float3& to, f32 radius,
+                    std::vector<TriangleContact>* contacts) const;
+
+    //! @brief カプセルを移動量だけ動かした範囲に触れる三角形を集めます
+    //! @param  [in]    world       モデルのワールド行列
+    //! @param  [in]    p0          移動前のカプセルの線分の始点 (ワールド空間)
+    //! @param  [in]    p1          移動前のカプセルの線分の終点 (ワールド空間)
+    //! @param  [in]    move        移動量
+    //! @param  [in]    radius      カプセルの半径
+    //! @param  [out]   contacts    接触 (追加されます)
+    //! @return 追加した接触数
+    //! @note 線分が掃引する平行四辺形と三角形の最近点で判定します
+    u32 sweepCapsule(const matrix& world, const float3& p0, const float3& p1, const float3& move, f32 radius,
+                     std::vector<TriangleContact>* contacts) const;
+
+   private:
+    //! @brief ワールド空間のAABBに重なる葉を列挙します
+    //! @param  [in]    world_min       AABBの最小座標 (ワールド空間)
+    //! @param  [in]    world_max       AABBの最大座標 (ワールド空間)
+    //! @param  [in]    world           モデルのワールド行列
+    //! @param  [in]    on_triangle     void(u32 triangle, const float3 (&v)[3]) ワールド空間の三角形
+    template<class F>
+    void queryAABB(const float3& world_min, const float3& world_max, const matrix& world, F&& on_triangle) const;
+
+    std::span<const VECTOR> vertices_;    //!< 頂点配列 (キャッシュファイル内)
+    std::span<const Node>   nodes_;       //!< ノード配列 (キャッシュファイル内)
+    std::span<const u32>    indices_;     //!< インデックス配列 (キャッシュファイル内)
+};
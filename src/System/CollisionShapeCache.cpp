@@ -0,0 +1,175 @@
+﻿//---------------------------------------------------------------------------
+//! @file   CollisionShapeCache.cpp
+//! @brief  コリジョン形状キャッシュ (ワールド空間形状のSoA配列)
+//---------------------------------------------------------------------------
+#include "CollisionShapeCache.h"
+
+#include <algorithm>
+
+namespace {
+constexpr f32 SEGMENT_EPSILON = 1.0e-6f;    //!< 線分の長さを0とみなす値
+
+//! 配列から4候補分を集める (端数は最後の候補で埋める)
+float4 gather(const std::vector<f32>& values, const u32* index) {
+    return float4(values[index[0]], values[index[1]], values[index[2]], values[index[3]]);
+}
+}    // namespace
+
+//===========================================================================
+// コリジョン形状キャッシュ CollisionShapeCache
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//! 形状数を設定します
+//---------------------------------------------------------------------------
+void CollisionShapeCache::resize(size_t count) {
+    p0x_.assign(count, 0.0f);
+    p0y_.assign(count, 0.0f);
+    p0z_.assign(count, 0.0f);
+    p1x_.assign(count, 0.0f);
+    p1y_.assign(count, 0.0f);
+    p1z_.assign(count, 0.0f);
+    radius_.assign(count, 0.0f);
+    type_.assign(count, CollisionShape::Type::None);
+}
+
+//---------------------------------------------------------------------------
+//! 形状を設定します
+//---------------------------------------------------------------------------
+void CollisionShapeCache::set(u32 index, const CollisionShape& shape) {
+    p0x_[index]    = shape.p0_.x;
+    p0y_[index]    = shape.p0_.y;
+    p0z_[index]    = shape.p0_.z;
+    p1x_[index]    = shape.p1_.x;
+    p1y_[index]    = shape.p1_.y;
+    p1z_[index]    = shape.p1_.z;
+    radius_[index] = shape.radius_;
+    type_[index]   = shape.type_;
+}
+
+//---------------------------------------------------------------------------
+//! 形状を取得します
+//---------------------------------------------------------------------------
+CollisionShape CollisionShapeCache::get(u32 index) const {
+    CollisionShape shape;
+    shape.type_   = type_[index];
+    shape.p0_     = {p0x_[index], p0y_[index], p0z_[index]};
+    shape.p1_     = {p1x_[index], p1y_[index], p1z_[index]};
+    shape.radius_ = radius_[index];
+    return shape;
+}
+
+//---------------------------------------------------------------------------
+//! 1つの形状と複数の候補をまとめて判定します
+//! 線分どうしの最近点 (Real-Time Collision Detection 5.1.9) を4候補ずつ分岐なしで求めます
+//---------------------------------------------------------------------------
+u32 CollisionShapeCache::overlapBatch(u32 self, const u32* candidates, u32 count, Contact* contacts) const {
+    // 自分の線分 (全レーン同じ値)
+    const float4 p1x(p0x_[self]);
+    const float4 p1y(p0y_[self]);
+    const float4 p1z(p0z_[self]);
+
+    const f32    d1x_value = p1x_[self] - p0x_[self];
+    const f32    d1y_value = p1y_[self] - p0y_[self];
+    const f32    d1z_value = p1z_[self] - p0z_[self];
+    const f32    a_value   = d1x_value * d1x_value + d1y_value * d1y_value + d1z_value * d1z_value;
+    const float4 d1x(d1x_value);
+    const float4 d1y(d1y_value);
+    const float4 d1z(d1z_value);
+    const float4 a(a_value);
+    // 自分が点 (球) の場合は s を常に0にする
+    const float4 inv_a(a_value > SEGMENT_EPSILON ? 1.0f / a_value : 0.0f);
+    const float4 self_radius(radius_[self]);
+
+    const bool inclusive = type_[self] == CollisionShape::Type::Line;
+
+    const float4 zero(0.0f);
+    const float4 one(1.0f);
+    const float4 epsilon(SEGMENT_EPSILON);
+
+    u32 hit_count = 0;
+    for(u32 base = 0; base < count; base += BATCH) {
+        const u32 lanes = std::min(BATCH, count - base);
+
+        u32 index[BATCH];
+        for(u32 lane = 0; lane < BATCH; lane++)
+            index[lane] = candidates[base + std::min(lane, lanes - 1)];
+
+        // 候補の線分
+        const float4 p2x = gather(p0x_, index);
+        const float4 p2y = gather(p0y_, index);
+        const float4 p2z = gather(p0z_, index);
+        const float4 d2x = gather(p1x_, index) - p2x;
+        const float4 d2y = gather(p1y_, index) - p2y;
+        const float4 d2z = gather(p1z_, index) - p2z;
+        const float4 rx  = p1x - p2x;
+        const float4 ry  = p1y - p2y;
+        const float4 rz  = p1z - p2z;
+
+        const float4 b = d1x * d2x + d1y * d2y + d1z * d2z;
+        const float4 c = d1x * rx + d1y * ry + d1z * rz;
+        const float4 e = d2x * d2x + d2y * d2y + d2z * d2z;
+        const float4 f = d2x * rx + d2y * ry + d2z * rz;
+
+        // 平行でなければ無限直線どうしの最近点から求める
+        const float4 denom = a * e - b * b;
+        float4       s     = select(denom > epsilon, saturate((b * f - c * e) / max(denom, epsilon)), zero);
+
+        // 候補が点の場合は t<0 の扱いにして s を求めなおす
+        float4 t = select(e > epsilon, (b * s + f) / max(e, epsilon), float4(-1.0f));
+
+        // t が範囲外ならクランプして s を求めなおす
+        s = select(t < zero, saturate(-c * inv_a), select(t > one, saturate((b - c) * inv_a), s));
+        t = saturate(t);
+
+        // 最近点どうしの距離
+        const float4 dx          = (p1x + d1x * s) - (p2x + d2x * t);
+        const float4 dy          = (p1y + d1y * s) - (p2y + d2y * t);
+        const float4 dz          = (p1z + d1z * s) - (p2z + d2z * t);
+        const float4 distance_sq = dx * dx + dy * dy + dz * dz;
+
+        const float4 radius    = self_radius + gather(radius_, index);
+        const float4 radius_sq = radius * radius;
+        const float4 hit       = inclusive ? float4(distance_sq <= radius_sq) : float4(distance_sq < radius_sq);
+
+        // 当たった候補だけを書き出す
+        f32 hit_lane[BATCH];
+        store(hit, hit_lane);
+        if(hit_lane[0] == 0.0f && hit_lane[1] == 0.0f && hit_lane[2] == 0.0f && hit_lane[3] == 0.0f)
+            continue;
+
+        f32 s_lane[BATCH];
+        f32 t_lane[BATCH];
+        f32 distance_lane[BATCH];
+        store(s, s_lane);
+        store(t, t_lane);
+        store(distance_sq, distance_lane);
+
+        for(u32 lane = 0; lane < lanes; lane++) {
+            if(hit_lane[lane] == 0.0f)
+                continue;
+
+            Contact& contact     = contacts[hit_count++];
+            contact.index_       = base + lane;
+            contact.s_           = s_lane[lane];
+            contact.t_           = t_lane[lane];
+            contact.distance_sq_ = distance_lane[lane];
+        }
+    }
+
+    return hit_count;
+}
+
+//---------------------------------------------------------------------------
+//! 当たった候補との最近点を取得します
+//---------------------------------------------------------------------------
+void CollisionShapeCache::closestPoints(u32 self, u32 other, const Contact& contact, float3* self_point,
+                                        float3* other_point) const {
+    float3 p0 = {p0x_[self], p0y_[self], p0z_[self]};
+    float3 p1 = {p1x_[self], p1y_[self], p1z_[self]};
+    float3 q0 = {p0x_[other], p0y_[other], p0z_[other]};
+    float3 q1 = {p1x_[other], p1y_[other], p1z_[other]};
+
+    *self_point  = p0 + (p1 - p0) * contact.s_;
+    *other_point = q0 + (q1 - q0) * contact.t_;
+}
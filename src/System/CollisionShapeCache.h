@@ -0,0 +1,94 @@
+﻿//---------------------------------------------------------------------------
+//! @file   CollisionShapeCache.h
+//! @brief  コリジョン形状キャッシュ (ワールド空間形状のSoA配列)
+//---------------------------------------------------------------------------
+#pragma once
+
+//===========================================================================
+//! ワールド空間でのコリジョン形状
+//! @note 球・カプセル・ラインをすべて「線分 + 半径」で表します。
+//!       球は始点と終点が同じ点、ラインは半径0になります
+//===========================================================================
+struct CollisionShape {
+    //! 形状の種類
+    enum class Type : u8 {
+        None,       //!< キャッシュ対象外 (モデルなど)
+        Sphere,     //!< 球
+        Capsule,    //!< カプセル
+        Line,       //!< ライン
+    };
+
+    Type   type_   = Type::None;            //!< 形状の種類
+    float3 p0_     = {0.0f, 0.0f, 0.0f};    //!< 線分の始点 (球の場合は中心)
+    float3 p1_     = {0.0f, 0.0f, 0.0f};    //!< 線分の終点 (球の場合は中心)
+    f32    radius_ = 0.0f;                  //!< 半径 (スケール適用済み)
+};
+
+//===========================================================================
+//! コリジョン形状キャッシュ
+//! @note 当たり判定の前に全コリジョンのワールド形状を一度だけ求めて配列に並べ、
+//!       1つのコリジョンと複数の候補を SIMD (float4 で4候補ずつ) でまとめて判定します。
+//!       当たった候補だけが Contact として返されます
+//===========================================================================
+class CollisionShapeCache final : noncopyable {
+   public:
+    static constexpr u32 BATCH = 4;    //!< 1回の演算で判定する候補数
+
+    //! 当たった候補
+    struct Contact {
+        u32 index_       = 0;       //!< 候補配列内の位置
+        f32 s_           = 0.0f;    //!< 自分の線分上の最近点パラメーター (0～1)
+        f32 t_           = 0.0f;    //!< 候補の線分上の最近点パラメーター (0～1)
+        f32 distance_sq_ = 0.0f;    //!< 最近点どうしの距離の2乗
+    };
+
+    //! 形状数を設定します (すべて None になります)
+    //! @param  [in]    count   形状数
+    void resize(size_t count);
+
+    //! 形状を設定します
+    //! @param  [in]    index   形状番号
+    //! @param  [in]    shape   ワールド空間での形状
+    void set(u32 index, const CollisionShape& shape);
+
+    //! 形状を取得します
+    //! @param  [in]    index   形状番号
+    CollisionShape get(u32 index) const;
+
+    //! 形状の種類を取得します
+    CollisionShape::Type type(u32 index) const {
+        return type_[index];
+    }
+
+    //! 形状数
+    size_t size() const {
+        return type_.size();
+    }
+
+    //! @brief 1つの形状と複数の候補をまとめて判定します
+    //! @param  [in]    self        自分の形状番号
+    //! @param  [in]    candidates  候補の形状番号の配列
+    //! @param  [in]    count       候補数
+    //! @param  [out]   contacts    当たった候補 (count 個分の領域が必要です)
+    //! @return 当たった候補数 (contacts は候補配列の順に並びます)
+    //! @note 自分がラインの場合は距離が半径と等しい時も当たりとします (ComponentCollision::isHit と同じ)
+    u32 overlapBatch(u32 self, const u32* candidates, u32 count, Contact* contacts) const;
+
+    //! 当たった候補との最近点を取得します
+    //! @param  [in]    self        自分の形状番号
+    //! @param  [in]    other       候補の形状番号
+    //! @param  [in]    contact     overlapBatch() の結果
+    //! @param  [out]   self_point  自分の線分上の最近点
+    //! @param  [out]   other_point 候補の線分上の最近点
+    void closestPoints(u32 self, u32 other, const Contact& contact, float3* self_point, float3* other_point) const;
+
+   private:
+    std::vector<f32>                  p0x_;       //!< 始点X
+    std::vector<f32>                  p0y_;       //!< 始点Y
+    std::vector<f32>                  p0z_;       //!< 始点Z
+    std::vector<f32>                  p1x_;       //!< 終点X
+    std::vector<f32>                  p1y_;       //!< 終点Y
+    std::vector<f32>                  p1z_;       //!< 終点Z
+    std::vector<f32>                  radius_;    //!< 半径
+    std::vector<CollisionShape::Type> type_;      //!< 形状の種類
+};
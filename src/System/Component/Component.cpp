@@ -133,6 +133,16 @@ void Component::RegisterToObject(ComponentPtr cmp, ObjectPtr obj) {
     cmp->Construct(obj);
 
     obj->GetComponents().push_back(cmp);
+    obj->RebuildComponentIndex();
+
+    // 次のPreUpdateで初期化と処理登録を行う
+    Scene::RequestObjectState(obj.get());
+}
+
+//! @brief オーナーの処理状態(処理登録/ポーズ/更新/描画)の再設定をシーンに予約する
+void Component::requestOwnerState() {
+    if(owner_)
+        Scene::RequestObjectState(owner_.get());
 }
 
 //! @brief ステータスの設定
@@ -236,9 +236,13 @@ class Component: public std::enable_shared_from_this<Component> {
                       ProcPriority prio = ProcPriority::NORMAL) {
         auto& proc = GetProc(proc_name, timing);
         proc.SetProc(proc_name, timing, prio, func);
+        requestOwnerState();
         return proc;
     }
 
+    //! @brief オーナーの処理状態(処理登録/ポーズ/更新/描画)の再設定をシーンに予約する
+    void requestOwnerState();
+
     void ResetProc(std::string proc_name) {
         auto itr = proc_timings_.find(proc_name);
         if(itr != proc_timings_.end()) {
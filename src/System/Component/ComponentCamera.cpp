@@ -4,6 +4,7 @@
 #include <System/Scene.h>
 
 #include <System/Debug/DebugCamera.h>
+#include <System/Graphics/ModelCache.h>
 #include <System/ImGui.h>
 
 ComponentCameraWeakPtr ComponentCamera::current_camera_{};
@@ -122,6 +123,9 @@ void ComponentCamera::SetCameraTransform() {
         frustum_.setNearZ(near_z_);
         frustum_.setFarZ(far_z_);
         frustum_.update();
+
+        // モデルキャッシュのLOD選択に使用
+        ModelCache::setLodView(&frustum_, static_cast<u32>(WINDOW_H));
     }
 }
 
@@ -185,6 +189,10 @@ void ComponentCamera::Exit() {
     // 定数バッファを解放
     DeleteShaderConstantBuffer(cb_camera_info_);
 
+    // LOD選択から外す
+    if(camera_status_.is(CameraBit::Current))
+        ModelCache::setLodView(nullptr, 0);
+
     __super::Exit();
 }
 
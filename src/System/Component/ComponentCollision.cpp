@@ -16,6 +16,7 @@
 #include <System/Object.h>
 
 #include <algorithm>
+#include <atomic>
 
 namespace {
 // 大きな値を取得する
@@ -33,20 +34,25 @@ float3 merge(float3 v1, float3 v2) {
 
     return vh;
 }
+
+std::atomic<u32> next_contact_id{1};    //!< 次に割り当てる接触ID (0は無効)
+
+std::vector<CollisionMeshBVH::TriangleContact> model_contacts;    //!< モデルとの接触 (毎回の確保を避けるため使いまわす)
 }    // namespace
 
 ComponentCollision::ComponentCollision() {
     // 複数設定可能とする
     SetStatus(Component::StatusBit::SameType, true);
+
+    contact_id_ = next_contact_id.fetch_add(1, std::memory_order_relaxed);
 }
 
 void ComponentCollision::Construct(ObjectPtr owner) {
     // 識別子設定
     assert(owner);
-    owner_    = owner;
-    auto cmps = owner->GetComponents<ComponentCollision>();
-    int  max  = -1;
-    for(ComponentCollisionPtr cmp: cmps) {
+    owner_  = owner;
+    int max = -1;
+    for(ComponentCollision* cmp: owner->ViewComponents<ComponentCollision>()) {
         if((int)cmp->collision_id_ > max)
             max = (int)cmp->collision_id_;
     }
@@ -77,12 +83,23 @@ void ComponentCollision::OnHit(const HitInfo& hitInfo) {
     obj->OnHit(hitInfo);
 }
 
-#pragma region customized
-void           ComponentCollision::ExitHit(const HitInfo& hitInfo) {
-    auto obj = GetOwner();
-    obj->ExitHit(hitInfo);
+//! @brief 接触が始まった時のコールバック
+//! @param contactInfo 接触情報
+void ComponentCollision::OnHitEnter(const ContactInfo& contactInfo) {
+    GetOwner()->OnHitEnter(contactInfo);
+}
+
+//! @brief 接触が続いている間のコールバック
+//! @param contactInfo 接触情報
+void ComponentCollision::OnHitStay(const ContactInfo& contactInfo) {
+    GetOwner()->OnHitStay(contactInfo);
+}
+
+//! @brief 接触が終わった時のコールバック
+//! @param contactInfo 接触情報
+void ComponentCollision::OnHitExit(const ContactInfo& contactInfo) {
+    GetOwner()->OnHitExit(contactInfo);
 }
-#pragma endregion
 
 #if 0
 void ComponentCollision::SetName(std::string_view name)
@@ -107,6 +124,9 @@ void ComponentCollision::GUICollisionData(bool use_attach) {
     // アタッチが存在必要な時
     if(use_attach)
         guiCollisionDataAttach();
+
+    // GUIからは直接行列を編集しているためキャッシュを無効にする
+    collision_version_ = WorldMatrixCache::NewVersion();
 }
 
 void ComponentCollision::LateUpdate() {
@@ -116,9 +136,10 @@ void ComponentCollision::LateUpdate() {
     // attach_node_matrix_ にモデルのNode位置を設定する
     if(attach_node_ >= 0) {
         attach_node_matrix_ = matrix::identity();
-        if(auto mdl = GetOwner()->GetComponent<ComponentModel>()) {
+        if(auto mdl = GetOwner()->FindComponent<ComponentModel>()) {
             attach_node_matrix_ = MV1GetFrameLocalWorldMatrix(mdl->GetModel(), attach_node_);
         }
+        collision_version_ = WorldMatrixCache::NewVersion();
     }
 #ifdef USE_JOLT_PHYSICS
 #else
@@ -141,7 +162,8 @@ void ComponentCollision::PostUpdate() {
 void ComponentCollision::GUI() {}
 
 void ComponentCollision::AttachToModel(int node) {
-    attach_node_ = node;
+    attach_node_       = node;
+    collision_version_ = WorldMatrixCache::NewVersion();
 #ifdef USE_JOLT_PHYSICS
     if(GetRigidBody())
         GetRigidBody()->setGravityFactor(0.0f);
@@ -149,8 +171,9 @@ void ComponentCollision::AttachToModel(int node) {
 }
 
 void ComponentCollision::AttachToModel(const std::string_view name) {
-    if(auto mdl = GetOwner()->GetComponent<ComponentModel>()) {
-        attach_node_ = mdl->GetNodeIndex(name);
+    if(auto mdl = GetOwner()->FindComponent<ComponentModel>()) {
+        attach_node_       = mdl->GetNodeIndex(name);
+        collision_version_ = WorldMatrixCache::NewVersion();
 #ifdef USE_JOLT_PHYSICS
         if(GetRigidBody())
             GetRigidBody()->setGravityFactor(0.0f);
@@ -226,7 +249,7 @@ void ComponentCollision::guiCollisionData() {
 
 void ComponentCollision::guiCollisionDataAttach() {
     // モデルにアタッチしているかを調べる
-    if(auto cmp = GetOwner()->GetComponent<ComponentModel>()) {
+    if(auto cmp = GetOwner()->FindComponent<ComponentModel>()) {
         // GUIでの AttachNodeの切り替えに対応させる
         bool attach = false;
         if(attach_node_ >= 0) {
@@ -270,14 +293,14 @@ ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionCapsuleP
 
     // モデルアタッチ
     if(col1->attach_node_ >= 0) {
-        if(auto mdl = col1->GetOwner()->GetComponent<ComponentModel>()) {
+        if(auto mdl = col1->GetOwner()->FindComponent<ComponentModel>()) {
             cpos1 = mul(float4(cpos1, 1), col1->attach_node_matrix_).xyz;
             cpos2 = mul(float4(cpos2, 1), col1->attach_node_matrix_).xyz;
             cpos2 = normalize(cpos2 - cpos1) * col1->GetHeight() + cpos1;
         }
     } else {
         // ComponentTransform(オブジェクト姿勢)
-        if(auto cmp = col1->GetOwner()->GetComponent<ComponentTransform>()) {
+        if(auto cmp = col1->GetOwner()->FindComponent<ComponentTransform>()) {
             // 高さに回転とスケールを掛け合わせる
             cpos1 = mul(float4(cpos1, 1), cmp->GetMatrix()).xyz;
             cpos2 = mul(float4(cpos2, 1), cmp->GetMatrix()).xyz;
@@ -288,13 +311,13 @@ ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionCapsuleP
 
     // モデルアタッチ
     if(col2->attach_node_ >= 0) {
-        if(auto mdl = col1->GetOwner()->GetComponent<ComponentModel>()) {
+        if(auto mdl = col1->GetOwner()->FindComponent<ComponentModel>()) {
             epos1 = col2->GetTranslate();
             epos1 = mul(float4(epos1, 1), col2->attach_node_matrix_).xyz;
         }
     } else {
         // ComponentTransform(オブジェクト姿勢)
-        if(auto cmp = col2->GetOwner()->GetComponent<ComponentTransform>()) {
+        if(auto cmp = col2->GetOwner()->FindComponent<ComponentTransform>()) {
             epos1    = mul(col2->GetMatrix(), cmp->GetMatrix())._41_42_43;
             //pos1 = mul( float4( pos1, 0 ) , cmp->GetMatrix() ).xyz;
             //pos1 += cmp->GetTranslate().xyz;
@@ -365,14 +388,14 @@ ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionCapsuleP
 
     // モデルアタッチ
     if(col1->attach_node_ >= 0) {
-        if(auto mdl = col1->GetOwner()->GetComponent<ComponentModel>()) {
+        if(auto mdl = col1->GetOwner()->FindComponent<ComponentModel>()) {
             cpos1 = mul(float4(cpos1, 1), col1->attach_node_matrix_).xyz;
             cpos2 = mul(float4(cpos2, 1), col1->attach_node_matrix_).xyz;
             cpos2 = normalize(cpos2 - cpos1) * col1->GetHeight() + cpos1;
         }
     } else {
         // ComponentTransform(オブジェクト姿勢)
-        if(auto cmp = col1->GetOwner()->GetComponent<ComponentTransform>()) {
+        if(auto cmp = col1->GetOwner()->FindComponent<ComponentTransform>()) {
             auto& mtx = cmp->GetWorldMatrix();
             // 高さに回転とスケールを掛け合わせる
             cpos1     = mul(float4(cpos1, 1), mtx).xyz;
@@ -389,14 +412,14 @@ ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionCapsuleP
 
     // モデルアタッチ
     if(col2->attach_node_ >= 0) {
-        if(auto mdl = col2->GetOwner()->GetComponent<ComponentModel>()) {
+        if(auto mdl = col2->GetOwner()->FindComponent<ComponentModel>()) {
             epos1 = mul(float4(epos1, 1), col2->attach_node_matrix_).xyz;
             epos2 = mul(float4(epos2, 1), col2->attach_node_matrix_).xyz;
             epos2 = normalize(epos2 - epos1) * col2->GetHeight() + epos1;
         }
     } else {
         // ComponentTransform(オブジェクト姿勢)
-        if(auto cmp = col2->GetOwner()->GetComponent<ComponentTransform>()) {
+        if(auto cmp = col2->GetOwner()->FindComponent<ComponentTransform>()) {
             auto& mtx = cmp->GetWorldMatrix();
             // 高さに回転とスケールを掛け合わせる
             epos1     = mul(float4(epos1, 1), mtx).xyz;
@@ -463,12 +486,12 @@ ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionSpherePt
 
     // モデルアタッチ
     if(col1->attach_node_ >= 0) {
-        if(auto mdl = col1->GetOwner()->GetComponent<ComponentModel>()) {
+        if(auto mdl = col1->GetOwner()->FindComponent<ComponentModel>()) {
             pos1 = col1->GetTranslate();
             pos1 = mul(float4(pos1, 1), col1->attach_node_matrix_).xyz;
         }
     } else {
-        if(auto cmp = col1->GetOwner()->GetComponent<ComponentTransform>()) {
+        if(auto cmp = col1->GetOwner()->FindComponent<ComponentTransform>()) {
             pos1     = mul(col1->GetMatrix(), cmp->GetWorldMatrix())._41_42_43;
             //pos1 = mul( float4( pos1, 0 ) , cmp->GetMatrix() ).xyz;
             //pos1 += cmp->GetTranslate().xyz;
@@ -484,12 +507,12 @@ ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionSpherePt
 
     // モデルアタッチ
     if(col2->attach_node_ >= 0) {
-        if(auto mdl = col2->GetOwner()->GetComponent<ComponentModel>()) {
+        if(auto mdl = col2->GetOwner()->FindComponent<ComponentModel>()) {
             pos2 = col2->GetTranslate();
             pos2 = mul(float4(pos2, 1), col2->attach_node_matrix_).xyz;
         }
     } else {
-        if(auto cmp = col2->GetOwner()->GetComponent<ComponentTransform>()) {
+        if(auto cmp = col2->GetOwner()->FindComponent<ComponentTransform>()) {
             pos2     = mul(col2->GetMatrix(), cmp->GetWorldMatrix())._41_42_43;
             //pos2 = mul( float4( pos2, 0 ), cmp->GetMatrix() ).xyz;
             //pos2 += cmp->GetTranslate().xyz;
@@ -532,8 +555,7 @@ ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionSpherePt
     ComponentCollision::HitInfo info{};
 
     // モデルが存在していない
-    auto mdl = col2->GetOwner()->GetComponent<ComponentModel>();
-    if(mdl == nullptr)
+    if(!col2->IsModelAttached())
         return info;
 
     float3 opos{};
@@ -658,26 +680,17 @@ ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionSpherePt
         // 戻し量
         float3 vh = 0;
 
-        MV1_COLL_RESULT_POLY_DIM hit_poly_dim{};
-
         float3 ocenter = opos + info.push_;
         float3 ncenter = cpos + info.push_;
 
         //DrawCapsule3D( cast( ocenter ), cast( ncenter ), radius, 10, GetColor( 0, 0, 255 ), GetColor( 0, 0, 255 ), FALSE );
 
-        // スピードは一旦無視。面倒なのでカプセルをそのまま利用
-        hit_poly_dim = MV1CollCheck_Capsule(mdl->GetModel(), -1, cast(ocenter), cast(ncenter), radius);
-        for(int i = 0; i < hit_poly_dim.HitNum; i++) {
-            SEGMENT_TRIANGLE_RESULT result{};
-
-            VECTOR v1 = cast(ocenter);
-            VECTOR v2 = cast(ncenter);
-            DxLib::Segment_Triangle_Analyse(&v1, &v2, &hit_poly_dim.Dim[i].Position[0], &hit_poly_dim.Dim[i].Position[1],
-                                            &hit_poly_dim.Dim[i].Position[2], &result);
-
-            float3 line_pos = cast(result.Seg_MinDist_Pos);
-            float3 tri_pos  = cast(result.Tri_MinDist_Pos);
-            float3 tri_nml  = cast(hit_poly_dim.Dim[i].Normal);
+        // スピードは一旦無視。移動前から移動後まで球を掃引した範囲で調べる
+        col2->SweepSphere(ocenter, ncenter, radius, &model_contacts);
+        for(auto& contact: model_contacts) {
+            float3 line_pos = contact.shape_point_;
+            float3 tri_pos  = contact.triangle_point_;
+            float3 tri_nml  = contact.normal_;
 
             // カプセルへの戻し方向
             if(HelperLib::Math::NearlyEqual(length(line_pos - tri_pos), 0)) {
@@ -693,7 +706,7 @@ ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionSpherePt
                 vh         = merge(vh, v);
             }
         }
-        if(hit_poly_dim.HitNum > 0) {
+        if(!model_contacts.empty()) {
             info.push_ += vh;
             info.hit_ = true;
             info.hit_position_ += (cpos - vh);
@@ -731,8 +744,7 @@ ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionCapsuleP
     ComponentCollision::HitInfo info{};
 
     // モデルが存在していない
-    auto mdl = col2->GetOwner()->GetComponent<ComponentModel>();
-    if(mdl == nullptr)
+    if(!col2->IsModelAttached())
         return info;
 
     float3 opos{};
@@ -788,13 +800,12 @@ ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionCapsuleP
 
     float radius = col1->GetRadius() * scale;
 
-    MV1_COLL_RESULT_POLY hit_poly{};
-    float3               bottom = cpos;     //-float3{ 0, col1->GetRadius() * scale, 0 };
-    float3               top    = cpos1;    //bottom + float3{ 0, col1->GetRadius() * scale * 2, 0 };
-    hit_poly                    = MV1CollCheck_Line(mdl->GetModel(), -1, cast(top), cast(bottom));
+    CollisionMeshBVH::RayHit hit_ray{};
+    float3                   bottom = cpos;     //-float3{ 0, col1->GetRadius() * scale, 0 };
+    float3                   top    = cpos1;    //bottom + float3{ 0, col1->GetRadius() * scale * 2, 0 };
 
-    if(hit_poly.HitFlag != 0) {
-        float3 pos = cast(hit_poly.HitPosition);
+    if(col2->Raycast(top, bottom, &hit_ray)) {
+        float3 pos = hit_ray.position_;
 
         // 半径分押し戻し
         float3 vec = pos - cpos;
@@ -864,24 +875,15 @@ ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionCapsuleP
         // 戻し量
         float3 vh = 0;
 
-        MV1_COLL_RESULT_POLY_DIM hit_poly_dim{};
-
         float3 oc = opos1 - float3(0, radius, 0) + info.push_;
         float3 cc = cpos1 - float3(0, radius, 0) + info.push_;
 
         //DrawCapsule3D( cast( oc ), cast( cc ), radius, 10, GetColor( 0, 0, 255 ), GetColor( 0, 0, 255 ), FALSE );
 
-        hit_poly_dim = MV1CollCheck_Capsule(mdl->GetModel(), -1, cast(oc), cast(cc), radius);
-        for(int i = 0; i < hit_poly_dim.HitNum; i++) {
-            SEGMENT_TRIANGLE_RESULT result{};
-
-            VECTOR v1 = cast(oc);
-            VECTOR v2 = cast(cc);
-            DxLib::Segment_Triangle_Analyse(&v1, &v2, &hit_poly_dim.Dim[i].Position[0], &hit_poly_dim.Dim[i].Position[1],
-                                            &hit_poly_dim.Dim[i].Position[2], &result);
-
-            float3 line_pos = cast(result.Seg_MinDist_Pos);
-            float3 tri_pos  = cast(result.Tri_MinDist_Pos);
+        col2->SweepSphere(oc, cc, radius, &model_contacts);
+        for(auto& contact: model_contacts) {
+            float3 line_pos = contact.shape_point_;
+            float3 tri_pos  = contact.triangle_point_;
 
             // カプセルへの戻し方向
             if(HelperLib::Math::NearlyEqual(length(line_pos - tri_pos), 0)) {
@@ -895,7 +897,7 @@ ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionCapsuleP
                 vh         = merge(vh, v);
             }
         }
-        if(hit_poly_dim.HitNum > 0) {
+        if(!model_contacts.empty()) {
             info.push_ += vh;
             info.hit_ = true;
             info.hit_position_ += (cpos - vh);
@@ -911,24 +913,16 @@ ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionCapsuleP
         // 戻し量
         float3 vh = 0;
 
-        MV1_COLL_RESULT_POLY_DIM hit_poly_dim{};
-
         float3 bottomx = cpos + info.push_ + float3(0, radius, 0);
         float3 topx    = cpos1 - float3(0, radius, 0);
 
         //DrawCapsule3D( cast( topx ), cast( bottomx ), radius, 10, GetColor( 0, 0, 255 ), GetColor( 0, 0, 255 ), FALSE );
 
-        hit_poly_dim = MV1CollCheck_Capsule(mdl->GetModel(), -1, cast(topx), cast(bottomx), radius);
-        for(int i = 0; i < hit_poly_dim.HitNum; i++) {
-            SEGMENT_TRIANGLE_RESULT result{};
-
-            VECTOR v1 = cast(topx);
-            VECTOR v2 = cast(bottomx);
-            DxLib::Segment_Triangle_Analyse(&v1, &v2, &hit_poly_dim.Dim[i].Position[0], &hit_poly_dim.Dim[i].Position[1],
-                                            &hit_poly_dim.Dim[i].Position[2], &result);
-
-            float3 line_pos = cast(result.Seg_MinDist_Pos);
-            float3 tri_pos  = cast(result.Tri_MinDist_Pos);
+        // 現在位置のカプセル (線分を掃引した球と同じ範囲)
+        col2->SweepSphere(topx, bottomx, radius, &model_contacts);
+        for(auto& contact: model_contacts) {
+            float3 line_pos = contact.shape_point_;
+            float3 tri_pos  = contact.triangle_point_;
 
             // カプセルへの戻し方向
             if(HelperLib::Math::NearlyEqual(length(line_pos - tri_pos), 0)) {
@@ -942,7 +936,7 @@ ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionCapsuleP
                 vh         = merge(vh, v);
             }
         }
-        if(hit_poly_dim.HitNum > 0) {
+        if(!model_contacts.empty()) {
             info.push_ += vh;
             info.hit_ = true;
             info.hit_position_ += (cpos - vh);
@@ -953,32 +947,25 @@ ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionCapsuleP
 }
 
 // Line(col1)とSphere(col2)の当たりをチェックします
+// 形状は GetWorldShape() で求める (スケールを含めた半径。形状キャッシュの判定と同じ)
 ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionLinePtr col1, ComponentCollisionSpherePtr col2) {
     // 当たり情報
     ComponentCollision::HitInfo info{};
 
-    // ラインの情報
-    auto line_owner = col1->GetOwner();
-    auto line_comp  = line_owner->GetComponent<ComponentCollisionLine>();
-    auto line       = line_comp->GetWorldLine();
-
-    // 球の情報
-    auto sphere_owner = col2->GetOwner();
-    if(sphere_owner == nullptr)
+    // ラインと球の情報
+    CollisionShape line;
+    CollisionShape sphere;
+    if(!col1->GetWorldShape(&line) || !col2->GetWorldShape(&sphere))
         return info;
 
-    auto sphere = sphere_owner->GetComponent<ComponentCollisionSphere>();
-    if(sphere == nullptr)
-        return info;
-
-    auto  pos    = sphere->GetWorldMatrix().translate();
-    float radius = sphere->GetRadius();
+    auto  pos    = sphere.p0_;
+    float radius = sphere.radius_;
 
     SEGMENT_POINT_RESULT result;
 
     // ライン情報と点情報を用意する
-    VECTOR start  = cast(line[0]);
-    VECTOR end    = cast(line[1]);
+    VECTOR start  = cast(line.p0_);
+    VECTOR end    = cast(line.p1_);
     VECTOR center = cast(pos);
 
     // ラインと点により分析する
@@ -991,7 +978,7 @@ ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionLinePtr
 
     // その距離が半径よりも小さければ当たっている
     if(len <= radius) {
-        auto vec           = normalize(line[0] - line[1]);
+        auto vec           = normalize(line.p0_ - line.p1_);
         info.hit_          = true;
         info.hit_position_ = point + vec * acos(len / radius) / 0.5f * DX_PI_F;
     }
@@ -1001,37 +988,25 @@ ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionLinePtr
 }
 
 // Line(col1)とCapsule(col2)の当たりをチェックします
+// 形状は GetWorldShape() で求める (スケールを含めた半径と半径分縮めた縦ライン。形状キャッシュの判定と同じ)
 ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionLinePtr col1, ComponentCollisionCapsulePtr col2) {
     ComponentCollision::HitInfo info{};
 
-    // ラインの情報
-    auto line_owner = col1->GetOwner();
-    auto line_comp  = line_owner->GetComponent<ComponentCollisionLine>();
-    auto line       = line_comp->GetWorldLine();
-
-    // カプセルの情報
-    auto capsule_owner = col2->GetOwner();
-    if(capsule_owner == nullptr)
+    // ラインとカプセルの情報
+    CollisionShape line;
+    CollisionShape capsule;
+    if(!col1->GetWorldShape(&line) || !col2->GetWorldShape(&capsule))
         return info;
 
-    auto capsule = capsule_owner->GetComponent<ComponentCollisionCapsule>();
-    if(capsule == nullptr)
-        return info;
-
-    // カプセルの状態を分析
-    auto  mat    = capsule->GetWorldMatrix();
-    auto  pos    = mat.translate();
-    float height = capsule->GetHeight();
-    float radius = capsule->GetRadius();
-    auto  pos1   = pos + height * mat.axisY();
+    float radius = capsule.radius_;
 
     SEGMENT_SEGMENT_RESULT result;
 
     // ライン情報とカプセルの縦ラインを互いにチェックする
-    VECTOR l1_start = cast(line[0]);
-    VECTOR l1_end   = cast(line[1]);
-    VECTOR l2_start = cast(pos);
-    VECTOR l2_end   = cast(pos1);
+    VECTOR l1_start = cast(line.p0_);
+    VECTOR l1_end   = cast(line.p1_);
+    VECTOR l2_start = cast(capsule.p0_);
+    VECTOR l2_end   = cast(capsule.p1_);
 
     // ラインどうしの状態を分析
     Segment_Segment_Analyse(&l1_start, &l1_end, &l2_start, &l2_end, &result);
@@ -1045,7 +1020,7 @@ ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionLinePtr
     // 当たったかどうかが判定できる
     if(len <= radius) {
         // 当たったら情報を入れておく
-        auto vec           = normalize(line[0] - line[1]);
+        auto vec           = normalize(line.p0_ - line.p1_);
         info.hit_          = true;
         info.hit_position_ = point + vec * acos(len / radius) / 0.5f * DX_PI_F;
     }
@@ -1068,20 +1043,16 @@ ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionLinePtr
     if(model_owner == nullptr)
         return info;
 
-    auto model = model_owner->GetComponent<ComponentModel>();
-    if(model == nullptr)
+    if(!col2->IsModelAttached())
         return info;
 
-    MV1_COLL_RESULT_POLY hit_poly{};
+    CollisionMeshBVH::RayHit hit_ray{};
 
-    // MV1とラインのチェック関数を呼び出す
-    hit_poly = MV1CollCheck_Line(model->GetModel(), -1, cast(line[0]), cast(line[1]));
-    if(hit_poly.HitFlag == FALSE) {
-        int a = 0;
-    }
+    // モデルの当たり判定メッシュとラインのチェック関数を呼び出す
     // 当たったかどうかのフラグを設定し、当たった位置も入れておく
-    info.hit_          = hit_poly.HitFlag;
-    info.hit_position_ = float3(hit_poly.HitPosition.x, hit_poly.HitPosition.y, hit_poly.HitPosition.z);
+    info.hit_ = col2->Raycast(line[0], line[1], &hit_ray);
+    if(info.hit_)
+        info.hit_position_ = hit_ray.position_;
 
     return info;
 }
@@ -1095,3 +1066,43 @@ ComponentCollision::HitInfo ComponentCollision::isHit(ComponentCollisionModelPtr
     hit.push_ = -hit.push_;    // push方向を反対にする
     return hit;
 }
+
+//! @brief 形状キャッシュの判定結果から当たり情報を作成します
+//! @param cache 形状キャッシュ
+//! @param self 自分の形状番号
+//! @param other 相手の形状番号
+//! @param contact CollisionShapeCache::overlapBatch() で当たった結果
+//! @return 当たり情報
+ComponentCollision::HitInfo ComponentCollision::HitInfoFromContact(const CollisionShapeCache& cache, u32 self, u32 other,
+                                                                   const CollisionShapeCache::Contact& contact) {
+    ComponentCollision::HitInfo info{};
+
+    // 最も近い点
+    float3 c0;
+    float3 e0;
+    cache.closestPoints(self, other, contact, &c0, &e0);
+
+    auto  self_shape  = cache.get(self);
+    auto  other_shape = cache.get(other);
+    float len         = sqrtf(contact.distance_sq_);
+
+    info.hit_ = true;
+
+    // ラインは押し戻しなし (isHit(Line, Sphere/Capsule) と同じ位置にする)
+    if(self_shape.type_ == CollisionShape::Type::Line) {
+        auto vec           = normalize(self_shape.p0_ - self_shape.p1_);
+        info.hit_position_ = c0 + vec * acos(len / other_shape.radius_) / 0.5f * DX_PI_F;
+        return info;
+    }
+
+    float3 vec = c0 - e0;    // 相手から離れる方向
+    if(len <= FLT_EPSILON) {
+        // 全く同じ位置にいる場合はz移動する形にしておく
+        vec = {0, 0, 1};
+    }
+
+    // このpush_は、調べたほうの押し戻し方向100%で作成する
+    info.push_         = normalize(vec) * (self_shape.radius_ + other_shape.radius_ - len);
+    info.hit_position_ = (e0 + c0) * 0.5f;
+    return info;
+}
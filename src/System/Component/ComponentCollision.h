@@ -5,6 +5,9 @@
 #pragma once
 
 #include <System/Component/Component.h>
+#include <System/Component/ComponentTransform.h>
+#include <System/CollisionBroadphase.h>
+#include <System/CollisionShapeCache.h>
 #include <ImGuizmo/ImGuizmo.h>
 
 #ifdef USE_JOLT_PHYSICS
@@ -24,6 +27,8 @@ USING_PTR(ComponentCollisionLine);
 
 //! @brief モデルコンポーネントクラス
 class ComponentCollision: public Component {
+    friend class Scene;
+
    public:
     //! @brief ヒット情報
     struct HitInfo {
@@ -34,6 +39,15 @@ class ComponentCollision: public Component {
         ComponentCollisionPtr hit_collision_ = nullptr;               //!< 当たったコリジョン
     };
 
+    //! @brief 接触情報 (OnHitEnter/OnHitStay/OnHitExit)
+    //! @details 毎フレーム作成されるため shared_ptr は持たずにポインタで渡します
+    struct ContactInfo {
+        ComponentCollision* collision_      = nullptr;               //!< 自分のコリジョン
+        ComponentCollision* hit_collision_  = nullptr;               //!< 相手のコリジョン (OnHitExitで相手が存在しない場合はnullptr)
+        u32                 hit_contact_id_ = 0;                     //!< 相手のコリジョンの接触ID
+        float3              hit_position_   = {0.0f, 0.0f, 0.0f};    //!< 当たった地点 (OnHitExitでは最後に当たった地点)
+    };
+
     ComponentCollision();
     void Construct(ObjectPtr owner);
 
@@ -58,9 +72,19 @@ class ComponentCollision: public Component {
     //! @details 当たった回数分ここに来ます
     virtual void OnHit(const HitInfo& hitInfo);
 
-#pragma region customized
-    virtual void ExitHit(const HitInfo& hitInfo);
-#pragma endregion
+    //! @brief 接触が始まった時のコールバック
+    //! @param contactInfo 接触情報
+    virtual void OnHitEnter(const ContactInfo& contactInfo);
+
+    //! @brief 接触が続いている間のコールバック
+    //! @param contactInfo 接触情報
+    //! @details 接触が始まったフレームには呼ばれません
+    virtual void OnHitStay(const ContactInfo& contactInfo);
+
+    //! @brief 接触が終わった時のコールバック
+    //! @param contactInfo 接触情報
+    //! @details 相手のコリジョンが削除された場合も呼ばれます
+    virtual void OnHitExit(const ContactInfo& contactInfo);
 #if 0    // 通常コンポーネントへ移動
     void SetName(std::string_view name);
 
@@ -262,6 +286,11 @@ class ComponentCollision: public Component {
         return collision_id_;
     }
 
+    //! @brief 接触ID (全コリジョンで重複しない識別子) を取得します
+    inline u32 GetContactId() const {
+        return contact_id_;
+    }
+
     //----------------------------------------------------------
     // @name アタッチ関係
     //----------------------------------------------------------
@@ -275,7 +304,7 @@ class ComponentCollision: public Component {
 #if 1
     //! @brief コリジョンマトリクス
     float* GetColMatrixFloat() {
-        return collision_transform_.f32_128_0;
+        return collisionMatrix().f32_128_0;
     }
 
     float3 GetColMatrixTranslate() const {
@@ -337,6 +366,31 @@ class ComponentCollision: public Component {
         return true;
     }
 
+    //! @brief ワールド空間でのAABBを取得します (ブロードフェーズ用)
+    //! @param aabb [out] 当たりを内包するAABB
+    //! @retval false 範囲が決まらない (常に判定対象となります)
+    virtual bool GetWorldAABB(CollisionAABB* aabb) const {
+        // オーバーライドしてください
+        return false;
+    }
+
+    //! @brief ワールド空間での形状を取得します (形状キャッシュ用)
+    //! @param shape [out] 線分 + 半径で表した形状
+    //! @retval false 球/カプセル/ライン以外のため形状キャッシュで判定できない
+    virtual bool GetWorldShape(CollisionShape* shape) const {
+        // オーバーライドしてください
+        return false;
+    }
+
+    //! @brief 形状キャッシュの判定結果から当たり情報を作成します
+    //! @param cache 形状キャッシュ
+    //! @param self 自分の形状番号
+    //! @param other 相手の形状番号
+    //! @param contact CollisionShapeCache::overlapBatch() で当たった結果
+    //! @return 当たり情報 (IsHit() と同じ向きの push_ / hit_position_ 。collision_ は設定されません)
+    static HitInfo HitInfoFromContact(const CollisionShapeCache& cache, u32 self, u32 other,
+                                      const CollisionShapeCache::Contact& contact);
+
     void UseGravity(bool b = true) {
         use_gravity_ = b;
     }
@@ -370,6 +424,23 @@ class ComponentCollision: public Component {
     //! @brief アタッチ情報のみ表示
     void guiCollisionDataAttach();
 
+    //! @brief AABB用のスケールを取得します
+    //! @param mat ワールドMatrix
+    //! @return 最大軸のスケール (当たり判定側がスケールを使わない場合もあるため1以上にする)
+    static float aabbScale(const matrix& mat) {
+        float sx = length(mat.axisX());
+        float sy = length(mat.axisY());
+        float sz = length(mat.axisZ());
+        return std::max({1.0f, sx, sy, sz});
+    }
+
+    //! @brief 書き換え用のコリジョン行列を取得します
+    //! @details ワールド行列のキャッシュを無効にするため、書き換える場合はこちらを使用してください
+    matrix& collisionMatrix() {
+        collision_version_ = WorldMatrixCache::NewVersion();
+        return collision_transform_;
+    }
+
     //----------------------------------------------------------------------------
     //! @name 当たり判定処理
     //----------------------------------------------------------------------------
@@ -464,6 +535,7 @@ class ComponentCollision: public Component {
 
     float collision_mass_ = 1;    //!< 押し戻される量に影響(マイナスは戻されない)
     u32   collision_id_   = 0;    //!< コリジョン識別子
+    u32   contact_id_     = 0;    //!< 接触ID (接触ペアキャッシュ用。保存はしない)
 
     int    attach_node_        = -1;    //!< モデルノードに付くときは0以上
     matrix attach_node_matrix_ = matrix::identity();
@@ -476,6 +548,12 @@ class ComponentCollision: public Component {
 
     //bool is_overlap_ = false;
 
+    s32           broadphase_proxy_ = CollisionBroadphase::NULL_PROXY;    //!< ブロードフェーズのプロキシ番号
+    CollisionAABB broadphase_aabb_;                                       //!< 前回のAABB (移動量を含めるため)
+
+    u64 collision_version_ = WorldMatrixCache::NewVersion();    //!< コリジョン行列/アタッチ行列のバージョン
+    mutable WorldMatrixCache world_cache_;                      //!< ワールド行列キャッシュ
+
 #if 0    // 通常コンポーネントへ
 	std::string name_ = "None";
 #endif
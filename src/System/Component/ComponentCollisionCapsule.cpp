@@ -285,20 +285,81 @@ ComponentCollisionCapsule::HitInfo ComponentCollisionCapsule::IsHit(ComponentCol
 //! @brief ワールドMatrixの取得
 //! @return 他のコンポーネントも含めた位置
 const matrix ComponentCollisionCapsule::GetWorldMatrix() const {
+    auto obj           = GetOwner();
+    u64  owner_version = obj->GetWorldVersion();
+    if(world_cache_.isValid(owner_version, collision_version_))
+        return world_cache_.get();
+
     auto transform = collision_transform_;
 
-    auto obj = GetOwner();
     if(attach_node_ >= 0) {
-        auto mdl = obj->GetComponent<ComponentModel>();
+        auto mdl = obj->FindComponent<ComponentModel>();
         if(mdl) {
             transform = mul(transform, attach_node_matrix_);
         }
     } else {
-        auto cmp = obj->GetComponent<ComponentTransform>();
+        auto cmp = obj->FindComponent<ComponentTransform>();
         if(cmp) {
             transform = mul(transform, cmp->GetWorldMatrix());
         }
     }
 
-    return transform;
+    return world_cache_.resolve(owner_version, collision_version_, 0, transform);
+}
+
+//! @brief ワールド空間でのAABBを取得します
+//! @param aabb [out] 当たりを内包するAABB
+//! @return AABBが取得できたか
+bool ComponentCollisionCapsule::GetWorldAABB(CollisionAABB* aabb) const {
+    auto  trans = GetWorldMatrix();
+    float scale = aabbScale(trans);
+
+    // 根元と先端の2点を半径分膨らませる
+    float3 pos1   = trans.translate();
+    float3 pos2   = normalize(trans.axisY()) * height_ * scale + pos1;
+    float  radius = radius_ * scale;
+
+    aabb->min_ = min(pos1, pos2) - radius;
+    aabb->max_ = max(pos1, pos2) + radius;
+    return true;
+}
+
+//! @brief ワールド空間での形状を取得します
+//! @param shape [out] 線分 + 半径で表した形状
+//! @return 形状が取得できたか
+//! @details 線分は両端を半径分縮め、半球を含めた全長が高さになるようにします
+bool ComponentCollisionCapsule::GetWorldShape(CollisionShape* shape) const {
+    auto obj = GetOwner();
+
+    float3 pos1  = collision_transform_.translate();
+    float3 pos2  = normalize(collision_transform_.axisY()) * height_ + pos1;
+    float  scale = 1.0f;
+
+    if(attach_node_ >= 0) {
+        // モデルアタッチ
+        if(obj->FindComponent<ComponentModel>()) {
+            pos1 = mul(float4(pos1, 1), attach_node_matrix_).xyz;
+            pos2 = mul(float4(pos2, 1), attach_node_matrix_).xyz;
+            pos2 = normalize(pos2 - pos1) * height_ + pos1;
+        }
+    } else {
+        // ComponentTransform(オブジェクト姿勢)
+        if(auto cmp = obj->FindComponent<ComponentTransform>()) {
+            auto& mtx = cmp->GetWorldMatrix();
+            // 高さに回転とスケールを掛け合わせる
+            pos1      = mul(float4(pos1, 1), mtx).xyz;
+            pos2      = mul(float4(pos2, 1), mtx).xyz;
+            // 半径はXZで平均としておく
+            scale     = (length(mtx.axisX()) + length(mtx.axisZ())) / 2;
+        }
+    }
+
+    float  radius = radius_ * scale;
+    float3 vec    = normalize(pos1 - pos2);
+
+    shape->type_   = CollisionShape::Type::Capsule;
+    shape->p0_     = pos1 - vec * radius;
+    shape->p1_     = pos2 + vec * radius;
+    shape->radius_ = radius;
+    return true;
 }
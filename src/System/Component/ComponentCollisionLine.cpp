@@ -181,11 +181,15 @@ ComponentCollisionLine::HitInfo ComponentCollisionLine::IsHit(ComponentCollision
 //! @brief ワールドMatrixの取得
 //! @return 他のコンポーネントも含めた位置
 const matrix ComponentCollisionLine::GetWorldMatrix() const {
+    auto obj           = GetOwner();
+    u64  owner_version = obj->GetWorldVersion();
+    if(world_cache_.isValid(owner_version, collision_version_))
+        return world_cache_.get();
+
     matrix transform = collision_transform_;
 
-    auto obj = GetOwner();
     if(attach_node_ >= 0) {
-        auto mdl = obj->GetComponent<ComponentModel>();
+        auto mdl = obj->FindComponent<ComponentModel>();
         if(mdl) {
             transform = mul(transform, attach_node_matrix_);
         }
@@ -194,5 +198,29 @@ const matrix ComponentCollisionLine::GetWorldMatrix() const {
         transform  = mul(transform, mat);
     }
 
-    return transform;
+    return world_cache_.resolve(owner_version, collision_version_, 0, transform);
+}
+
+//! @brief ワールド空間でのAABBを取得します
+//! @param aabb [out] 当たりを内包するAABB
+//! @return AABBが取得できたか
+bool ComponentCollisionLine::GetWorldAABB(CollisionAABB* aabb) const {
+    auto line = GetWorldLine();
+
+    aabb->min_ = min(line[0], line[1]);
+    aabb->max_ = max(line[0], line[1]);
+    return true;
+}
+
+//! @brief ワールド空間での形状を取得します
+//! @param shape [out] 線分 + 半径で表した形状 (半径0)
+//! @return 形状が取得できたか
+bool ComponentCollisionLine::GetWorldShape(CollisionShape* shape) const {
+    auto line = GetWorldLine();
+
+    shape->type_   = CollisionShape::Type::Line;
+    shape->p0_     = line[0];
+    shape->p1_     = line[1];
+    shape->radius_ = 0.0f;
+    return true;
 }
@@ -49,6 +49,16 @@ class ComponentCollisionLine
     //! @return HitInfoを返す
     HitInfo IsHit(ComponentCollisionPtr col) override;
 
+    //! @brief ワールド空間でのAABBを取得します
+    //! @param aabb [out] 当たりを内包するAABB
+    //! @return AABBが取得できたか
+    bool GetWorldAABB(CollisionAABB* aabb) const override;
+
+    //! @brief ワールド空間での形状を取得します
+    //! @param shape [out] 線分 + 半径で表した形状
+    //! @return 形状が取得できたか
+    bool GetWorldShape(CollisionShape* shape) const override;
+
     //----------------------------------------------------------------------
     //! @name IMatrixインターフェースの利用するための定義
     //----------------------------------------------------------------------
@@ -56,7 +66,7 @@ class ComponentCollisionLine
     //! @brief TransformのMatrix情報を取得します
     //! @return ComponentTransform の Matrix
     matrix& Matrix() override {
-        return collision_transform_;
+        return collisionMatrix();
     }
 
     const matrix& GetMatrix() const override {
@@ -8,6 +8,9 @@
 #include <System/Component/ComponentCollisionLine.h>
 #include <System/Component/ComponentTransform.h>
 #include <System/Component/ComponentModel.h>
+#include <System/Graphics/Model.h>
+#include <System/Graphics/ModelCache.h>
+#include <System/Graphics/ResourceModel.h>
 #include <System/Object.h>
 #include <System/Scene.h>
 
@@ -19,11 +22,12 @@ void ComponentCollisionModel::Update() {
     __super::Update();
 
     // モデルチェック
-    if(auto mdl = GetOwner()->GetComponent<ComponentModel>()) {
+    if(auto mdl = GetOwner()->FindComponent<ComponentModel>()) {
         if(!mdl->IsValid())
             ref_model_ = -1;
     } else {
         ref_model_ = -1;
+        model_.reset();
     }
 }
 
@@ -33,7 +37,12 @@ void ComponentCollisionModel::PostUpdate() {
 }
 
 void ComponentCollisionModel::Draw() {
-    if(update_) {
+    matrix      world;
+    const auto* bvh = collisionMesh(&world);
+
+    // BVHはモデル空間で保持しているため更新は不要
+    // キャッシュ生成前のみDxLibのコリジョン情報を更新する
+    if(update_ && !bvh && ref_model_ != -1) {
         MV1RefreshReferenceMesh(ref_model_, -1, TRUE);
         MV1RefreshCollInfo(ref_model_);
         ref_poly_ = MV1GetReferenceMesh(ref_model_, -1, TRUE);
@@ -47,18 +56,33 @@ void ComponentCollisionModel::Draw() {
     SetUseLighting(FALSE);
     SetLightEnable(FALSE);
 
-    // ポリゴンの数だけ繰り返し
-    for(int i = 0; i < ref_poly_.PolygonNum; i++) {
-        float3 p0 = cast(ref_poly_.Vertexs[ref_poly_.Polygons[i].VIndex[0]].Position);
-        float3 p1 = cast(ref_poly_.Vertexs[ref_poly_.Polygons[i].VIndex[1]].Position);
-        float3 p2 = cast(ref_poly_.Vertexs[ref_poly_.Polygons[i].VIndex[2]].Position);
+    if(bvh) {
+        // BVHの三角形の数だけ繰り返し
+        for(u32 i = 0; i < bvh->triangleCount(); i++) {
+            float3 v[3];
+            bvh->triangle(i, world, v);
+
+            // 三角形の三頂点を使用してワイヤーフレームを描画する
+            DrawLine3D(cast(v[0]), cast(v[1]), GetColor(255, 255, 0));
+
+            DrawLine3D(cast(v[1]), cast(v[2]), GetColor(255, 255, 0));
+
+            DrawLine3D(cast(v[2]), cast(v[0]), GetColor(255, 255, 0));
+        }
+    } else {
+        // ポリゴンの数だけ繰り返し
+        for(int i = 0; i < ref_poly_.PolygonNum; i++) {
+            float3 p0 = cast(ref_poly_.Vertexs[ref_poly_.Polygons[i].VIndex[0]].Position);
+            float3 p1 = cast(ref_poly_.Vertexs[ref_poly_.Polygons[i].VIndex[1]].Position);
+            float3 p2 = cast(ref_poly_.Vertexs[ref_poly_.Polygons[i].VIndex[2]].Position);
 
-        // ポリゴンを形成する三頂点を使用してワイヤーフレームを描画する
-        DrawLine3D(cast(p0), cast(p1), GetColor(255, 255, 0));
+            // ポリゴンを形成する三頂点を使用してワイヤーフレームを描画する
+            DrawLine3D(cast(p0), cast(p1), GetColor(255, 255, 0));
 
-        DrawLine3D(cast(p1), cast(p2), GetColor(255, 255, 0));
+            DrawLine3D(cast(p1), cast(p2), GetColor(255, 255, 0));
 
-        DrawLine3D(cast(p2), cast(p0), GetColor(255, 255, 0));
+            DrawLine3D(cast(p2), cast(p0), GetColor(255, 255, 0));
+        }
     }
 
     SetLightEnable(TRUE);
@@ -103,6 +127,13 @@ void ComponentCollisionModel::GUI() {
             //ImGui::DragFloat3( u8"COLサイズ(S)", matrixScale, 0.01f );
             RecomposeMatrixFromComponents(matrixTranslation, matrixRotation, matrixScale, mat);
 
+            matrix world;
+            if(const auto* bvh = collisionMesh(&world)) {
+                ImGui::Text(u8"BVH ノード数:%u 三角形数:%u", bvh->nodeCount(), bvh->triangleCount());
+            } else {
+                ImGui::Text(u8"BVH 生成中 (DxLibのコリジョン情報を使用)");
+            }
+
             if(ImGui::Button(u8"モデルにコリジョンを張り付ける")) {
                 if(ref_model_ == -1)
                     AttachToModel(true);
@@ -115,7 +146,10 @@ void ComponentCollisionModel::GUI() {
 }
 
 void ComponentCollisionModel::AttachToModel(bool update) {
-    if(auto mdl = GetOwner()->GetComponent<ComponentModel>()) {
+    if(auto mdl = GetOwner()->FindComponent<ComponentModel>()) {
+        // 当たり判定のたびに検索しないように保持しておく
+        model_ = mdl;
+
 #ifdef USE_JOLT_PHYSICS
         // 地形衝突情報を作成 (メッシュ剛体は必ず静的)
         float3 scale = mdl->GetScaleAxisXYZ();
@@ -177,21 +211,27 @@ ComponentCollisionModel::HitInfo ComponentCollisionModel::IsHit(ComponentCollisi
 //! @brief ワールドMatrixの取得
 //! @return 他のコンポーネントも含めた位置
 const matrix ComponentCollisionModel::GetWorldMatrix() const {
-    auto transform = matrix::identity();
-
     auto obj = GetOwner();
+    auto mdl = obj->FindComponent<ComponentModel>();
+
+    // モデル側のワールド行列が変わった場合も再計算する
+    u64 owner_version = obj->GetWorldVersion();
+    u64 model_version = mdl ? mdl->GetWorldVersion() : 0;
+    if(world_cache_.isValid(owner_version, collision_version_, model_version))
+        return world_cache_.get();
+
+    auto transform = matrix::identity();
     {
-        auto mdl = obj->GetComponent<ComponentModel>();
         if(mdl) {
             transform = mul(transform, mdl->GetWorldMatrix());
         }
-        auto cmp = obj->GetComponent<ComponentTransform>();
+        auto cmp = obj->FindComponent<ComponentTransform>();
         if(cmp) {
             transform = mul(transform, cmp->GetWorldMatrix());
         }
     }
 
-    return transform;
+    return world_cache_.resolve(owner_version, collision_version_, model_version, transform);
 }
 
 //! @brief マップに対する正確な移動量を割り出す(傾きによる移動量)
@@ -199,27 +239,148 @@ const matrix ComponentCollisionModel::GetWorldMatrix() const {
 //! @param force 山に上る時の上りにくさ (1.0で普通に楽々上る ~ 3.0くらいだともう登れない )
 //! @return 実際動ける量
 float3 ComponentCollisionModel::checkMovement(float3 pos, float3 vec, float force) {
-    MV1_COLL_RESULT_POLY hit_poly{};
-    float3               top = pos + float3(0, 10, 0);
-    float3               btm = pos + float3(0, -1.5, 0);
+    CollisionMeshBVH::RayHit hit{};
+    float3                   top = pos + float3(0, 10, 0);
+    float3                   btm = pos + float3(0, -1.5, 0);
 
     if(length(vec).x <= 0)
         return float3(0, 0, 0);
 
-    if(auto mdl = GetOwner()->GetComponent<ComponentModel>()) {
-        hit_poly = MV1CollCheck_Line(mdl->GetModel(), -1, cast(top), cast(btm));
-        if(hit_poly.HitFlag) {
-            // 制限あり (dotがマイナスということは山に上る形になっている)
-            float pt = dot(cast(hit_poly.Normal), normalize(vec));
-            if(pt < 0) {
-                pt *= force;
-                if(pt < -1)
-                    pt = -1;
-
-                // 傾きに合わせて、実際の移動量は、vec(最大) ~ 0(最小) となる
-                return vec + vec * pt;
-            }
+    if(Raycast(top, btm, &hit)) {
+        // 制限あり (dotがマイナスということは山に上る形になっている)
+        float pt = dot(hit.normal_, normalize(vec));
+        if(pt < 0) {
+            pt *= force;
+            if(pt < -1)
+                pt = -1;
+
+            // 傾きに合わせて、実際の移動量は、vec(最大) ~ 0(最小) となる
+            return vec + vec * pt;
         }
     }
     return vec;
 }
+
+//! @brief ワールド空間でのAABBを取得します
+//! @param aabb [out] 当たりを内包するAABB
+//! @return AABBが取得できたか
+bool ComponentCollisionModel::GetWorldAABB(CollisionAABB* aabb) const {
+    // BVHがあればモデルの現在の行列で求める
+    matrix world;
+    if(const auto* bvh = collisionMesh(&world))
+        return bvh->worldBounds(world, &aabb->min_, &aabb->max_);
+
+    // アタッチ前は範囲が分からない
+    if(ref_model_ == -1)
+        return false;
+
+    // 参照用メッシュはワールド座標で構築されている
+    aabb->min_ = cast(ref_poly_.MinPosition);
+    aabb->max_ = cast(ref_poly_.MaxPosition);
+    return true;
+}
+
+//! @brief 当たり判定用のBVHを取得します
+//! @param world [out] モデルのワールド行列
+//! @return BVH (キャッシュ生成前は nullptr)
+const CollisionMeshBVH* ComponentCollisionModel::collisionMesh(matrix* world) const {
+    auto mdl = model_.lock();
+    if(!mdl)
+        return nullptr;
+
+    auto* model = mdl->GetModelClass();
+    if(!model || !model->resource())
+        return nullptr;
+
+    auto* model_cache = model->resource()->modelCache();
+    if(!model_cache || !model_cache->isValid() || !model_cache->collisionMesh().isValid())
+        return nullptr;
+
+    // DxLibのコリジョン情報と同じくモデルに設定されている行列を使う
+    *world = model->worldMatrix();
+    return &model_cache->collisionMesh();
+}
+
+//! @brief 線分で最も手前の三角形を調べます
+//! @param start 始点
+//! @param end 終点
+//! @param hit [out] 当たり情報
+//! @return 当たったか
+bool ComponentCollisionModel::Raycast(const float3& start, const float3& end, CollisionMeshBVH::RayHit* hit) const {
+    matrix world;
+    if(const auto* bvh = collisionMesh(&world))
+        return bvh->raycast(world, start, end, hit);
+
+    // キャッシュ生成前はDxLibで調べる
+    if(ref_model_ == -1)
+        return false;
+
+    MV1_COLL_RESULT_POLY hit_poly = MV1CollCheck_Line(ref_model_, -1, cast(start), cast(end));
+    if(!hit_poly.HitFlag)
+        return false;
+
+    float len      = length(end - start);
+    hit->position_ = cast(hit_poly.HitPosition);
+    hit->t_        = len > 0.0f ? length(hit->position_ - start) / len : 0.0f;
+    hit->triangle_ = static_cast<u32>(hit_poly.PolygonIndex);
+    hit->normal_   = cast(hit_poly.Normal);
+    return true;
+}
+
+//! @brief 球を動かした範囲に触れる三角形を集めます
+//! @param from 移動前の球の中心
+//! @param to 移動後の球の中心
+//! @param radius 球の半径
+//! @param contacts [out] 接触
+//! @return 接触数
+u32 ComponentCollisionModel::SweepSphere(const float3& from, const float3& to, float radius,
+                                         std::vector<CollisionMeshBVH::TriangleContact>* contacts) const {
+    contacts->clear();
+
+    matrix world;
+    if(const auto* bvh = collisionMesh(&world))
+        return bvh->sweepSphere(world, from, to, radius, contacts);
+
+    // キャッシュ生成前はDxLibで調べる
+    if(ref_model_ == -1)
+        return 0;
+
+    MV1_COLL_RESULT_POLY_DIM hit_poly_dim = MV1CollCheck_Capsule(ref_model_, -1, cast(from), cast(to), radius);
+    for(int i = 0; i < hit_poly_dim.HitNum; i++) {
+        SEGMENT_TRIANGLE_RESULT result{};
+
+        VECTOR v1 = cast(from);
+        VECTOR v2 = cast(to);
+        DxLib::Segment_Triangle_Analyse(&v1, &v2, &hit_poly_dim.Dim[i].Position[0], &hit_poly_dim.Dim[i].Position[1],
+                                        &hit_poly_dim.Dim[i].Position[2], &result);
+
+        CollisionMeshBVH::TriangleContact contact;
+        contact.triangle_       = static_cast<u32>(hit_poly_dim.Dim[i].PolygonIndex);
+        contact.shape_point_    = cast(result.Seg_MinDist_Pos);
+        contact.triangle_point_ = cast(result.Tri_MinDist_Pos);
+        contact.normal_         = cast(hit_poly_dim.Dim[i].Normal);
+        contact.distance_sq_    = result.Seg_Tri_MinDist_Square;
+        contacts->push_back(contact);
+    }
+    MV1CollResultPolyDimTerminate(hit_poly_dim);
+
+    return static_cast<u32>(contacts->size());
+}
+
+//! @brief カプセルを動かした範囲に触れる三角形を集めます
+//! @param p0 移動前のカプセルの線分の始点
+//! @param p1 移動前のカプセルの線分の終点
+//! @param move 移動量
+//! @param radius カプセルの半径
+//! @param contacts [out] 接触
+//! @return 接触数 (キャッシュ生成前は0)
+u32 ComponentCollisionModel::SweepCapsule(const float3& p0, const float3& p1, const float3& move, float radius,
+                                          std::vector<CollisionMeshBVH::TriangleContact>* contacts) const {
+    contacts->clear();
+
+    matrix world;
+    if(const auto* bvh = collisionMesh(&world))
+        return bvh->sweepCapsule(world, p0, p1, move, radius, contacts);
+
+    return 0;
+}
@@ -6,9 +6,11 @@
 
 #include <System/Component/ComponentCollision.h>
 #include <System/Component/ComponentTransform.h>
+#include <System/CollisionMeshBVH.h>
 #include <ImGuizmo/ImGuizmo.h>
 
 USING_PTR(ComponentCollisionModel);
+USING_PTR(ComponentModel);
 
 //! @brief コリジョンコンポーネントクラス
 class ComponentCollisionModel
@@ -39,6 +41,11 @@ class ComponentCollisionModel
 
     HitInfo IsHit(ComponentCollisionPtr col) override;
 
+    //! @brief ワールド空間でのAABBを取得します
+    //! @param aabb [out] 当たりを内包するAABB
+    //! @return AABBが取得できたか
+    bool GetWorldAABB(CollisionAABB* aabb) const override;
+
     //----------------------------------------------------------------------
     //! @name IMatrixインターフェースの利用するための定義
     //----------------------------------------------------------------------
@@ -46,7 +53,7 @@ class ComponentCollisionModel
     //! @brief TransformのMatrix情報を取得します
     //! @return ComponentTransform の Matrix
     matrix& Matrix() override {
-        return collision_transform_;
+        return collisionMatrix();
     }
 
     const matrix& GetMatrix() const override {
@@ -75,6 +82,45 @@ class ComponentCollisionModel
     //! @return 実際動ける量
     float3 checkMovement(float3 pos, float3 vec, float force = 1.0f);
 
+    //----------------------------------------------------------------------
+    //! @name 当たり判定メッシュへの問い合わせ
+    //! モデルキャッシュのBVHを使用します (キャッシュ生成前はDxLibのコリジョン情報で代用します)
+    //----------------------------------------------------------------------
+    //@{
+
+    //! @brief モデルに張り付けられているか
+    bool IsModelAttached() const {
+        return !model_.expired();
+    }
+
+    //! @brief 線分で最も手前の三角形を調べます
+    //! @param start 始点
+    //! @param end 終点
+    //! @param hit [out] 当たり情報
+    //! @return 当たったか
+    bool Raycast(const float3& start, const float3& end, CollisionMeshBVH::RayHit* hit) const;
+
+    //! @brief 球を動かした範囲に触れる三角形を集めます
+    //! @param from 移動前の球の中心
+    //! @param to 移動後の球の中心
+    //! @param radius 球の半径
+    //! @param contacts [out] 接触 (クリアしてから追加します)
+    //! @return 接触数
+    u32 SweepSphere(const float3& from, const float3& to, float radius,
+                    std::vector<CollisionMeshBVH::TriangleContact>* contacts) const;
+
+    //! @brief カプセルを動かした範囲に触れる三角形を集めます
+    //! @param p0 移動前のカプセルの線分の始点
+    //! @param p1 移動前のカプセルの線分の終点
+    //! @param move 移動量
+    //! @param radius カプセルの半径
+    //! @param contacts [out] 接触 (クリアしてから追加します)
+    //! @return 接触数 (キャッシュ生成前は0)
+    u32 SweepCapsule(const float3& p0, const float3& p1, const float3& move, float radius,
+                     std::vector<CollisionMeshBVH::TriangleContact>* contacts) const;
+
+    //@}
+
 #if 1    // CompoentCollisionからの移行
 #    if 0
 	inline ComponentCollisionModelPtr SetName( std::string_view name )
@@ -105,8 +151,14 @@ class ComponentCollisionModel
 #endif
 
    private:
+    //! @brief 当たり判定用のBVHを取得します
+    //! @param world [out] モデルのワールド行列
+    //! @return BVH (キャッシュ生成前は nullptr)
+    const CollisionMeshBVH* collisionMesh(matrix* world) const;
+
     bool                                  update_    = false;
     int                                   ref_model_ = -1;
+    ComponentModelWeakPtr                 model_;            //!< 張り付けたモデル
     MV1_REF_POLYGONLIST                   ref_poly_{};       //!< ポリゴンデータ
     std::vector<MV1_COLL_RESULT_POLY_DIM> hit_poly_dims_;    //!< 結果代入用ポリゴン配列
 
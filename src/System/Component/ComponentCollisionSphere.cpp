@@ -137,20 +137,61 @@ ComponentCollisionSphere::HitInfo ComponentCollisionSphere::IsHit(ComponentColli
 //! @brief ワールドMatrixの取得
 //! @return 他のコンポーネントも含めた位置
 const matrix ComponentCollisionSphere::GetWorldMatrix() const {
+    auto obj           = GetOwner();
+    u64  owner_version = obj->GetWorldVersion();
+    if(world_cache_.isValid(owner_version, collision_version_))
+        return world_cache_.get();
+
     auto transform = collision_transform_;
 
-    auto obj = GetOwner();
     if(attach_node_ >= 0) {
-        auto mdl = obj->GetComponent<ComponentModel>();
+        auto mdl = obj->FindComponent<ComponentModel>();
         if(mdl) {
             transform = mul(transform, attach_node_matrix_);
         }
     } else {
-        auto cmp = obj->GetComponent<ComponentTransform>();
+        auto cmp = obj->FindComponent<ComponentTransform>();
         if(cmp) {
             transform = mul(transform, cmp->GetWorldMatrix());
         }
     }
 
-    return transform;
+    return world_cache_.resolve(owner_version, collision_version_, 0, transform);
+}
+
+//! @brief ワールド空間でのAABBを取得します
+//! @param aabb [out] 当たりを内包するAABB
+//! @return AABBが取得できたか
+bool ComponentCollisionSphere::GetWorldAABB(CollisionAABB* aabb) const {
+    auto trans = GetWorldMatrix();
+
+    float  radius = radius_ * aabbScale(trans);
+    float3 pos    = trans.translate();
+
+    aabb->min_ = pos - radius;
+    aabb->max_ = pos + radius;
+    return true;
+}
+
+//! @brief ワールド空間での形状を取得します
+//! @param shape [out] 線分 + 半径で表した形状 (始点と終点が中心)
+//! @return 形状が取得できたか
+bool ComponentCollisionSphere::GetWorldShape(CollisionShape* shape) const {
+    float scale = 1.0f;
+
+    // モデルアタッチ時はスケールを使用しない (isHit と同じ)
+    if(attach_node_ < 0) {
+        if(auto cmp = GetOwner()->FindComponent<ComponentTransform>()) {
+            auto& mtx = cmp->GetWorldMatrix();
+            scale     = (length(mtx.axisX()) + length(mtx.axisY()) + length(mtx.axisZ())) / 3.0f;
+        }
+    }
+
+    float3 pos = GetWorldMatrix().translate();
+
+    shape->type_   = CollisionShape::Type::Sphere;
+    shape->p0_     = pos;
+    shape->p1_     = pos;
+    shape->radius_ = radius_ * scale;
+    return true;
 }
@@ -41,6 +41,16 @@ class ComponentCollisionSphere
 
     HitInfo IsHit(ComponentCollisionPtr col) override;
 
+    //! @brief ワールド空間でのAABBを取得します
+    //! @param aabb [out] 当たりを内包するAABB
+    //! @return AABBが取得できたか
+    bool GetWorldAABB(CollisionAABB* aabb) const override;
+
+    //! @brief ワールド空間での形状を取得します
+    //! @param shape [out] 線分 + 半径で表した形状
+    //! @return 形状が取得できたか
+    bool GetWorldShape(CollisionShape* shape) const override;
+
     //----------------------------------------------------------------------
     //! @name IMatrixインターフェースの利用するための定義
     //----------------------------------------------------------------------
@@ -48,7 +58,7 @@ class ComponentCollisionSphere
     //! @brief TransformのMatrix情報を取得します
     //! @return ComponentTransform の Matrix
     matrix& Matrix() override {
-        return collision_transform_;
+        return collisionMatrix();
     }
 
     const matrix& GetMatrix() const override {
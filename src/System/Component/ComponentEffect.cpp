@@ -206,6 +206,9 @@ void ComponentEffect::GUI() {
             ImGui::DragFloat3(u8"サイズ(S)", matrixScale, 0.01f, 0.00f, 1000.0f, "%.2f");
             RecomposeMatrixFromComponents(matrixTranslation, matrixRotation, matrixScale, mat);
 
+            // effect_transform_ を直接編集しているためキャッシュを無効にする
+            local_version_ = WorldMatrixCache::NewVersion();
+
             ImGui::TreePop();
         }
     }
@@ -283,12 +286,26 @@ const float ComponentEffect::GetEffectTime() {
 //! @return 他のコンポーネントも含めた位置
 
 const matrix ComponentEffect::GetWorldMatrix() const {
-    return mul(GetMatrix(), GetOwner()->GetWorldMatrix());
+    auto owner         = GetOwner();
+    u64  owner_version = owner->GetWorldVersion();
+    if(world_cache_.isValid(owner_version, local_version_))
+        return world_cache_.get();
+
+    return world_cache_.resolve(owner_version, local_version_, 0, mul(GetMatrix(), owner->GetWorldMatrix()));
 }
 
 //! @brief 1フレーム前のワールドMatrixの取得
 //! @return 他のコンポーネントも含めた位置
 
 const matrix ComponentEffect::GetOldWorldMatrix() const {
+    // PostUpdate後に確定した行列があればそのまま返す
+    if(world_cache_.hasOld())
+        return world_cache_.old();
+
     return mul(GetMatrix(), GetOwner()->GetOldWorldMatrix());
 }
+
+//! @brief ワールド行列を確定して1フレーム前の行列として保存する
+void ComponentEffect::ResolveWorldMatrix() {
+    world_cache_.storeOld(GetWorldMatrix());
+}
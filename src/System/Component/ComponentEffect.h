@@ -119,6 +119,7 @@ class ComponentEffect final
     //@{
 
     matrix& Matrix() override {
+        local_version_ = WorldMatrixCache::NewVersion();
         return effect_transform_;
     }    //!< マトリクス取得
 
@@ -138,12 +139,19 @@ class ComponentEffect final
     //! @return 他のコンポーネントも含めた位置
     virtual const matrix GetOldWorldMatrix() const override;
 
+    //! @brief ワールド行列を確定して1フレーム前の行列として保存する
+    //! @details シーンのPostUpdate後にまとめて呼ばれます
+    void ResolveWorldMatrix();
+
     //@}
 
    private:
     //! モデル用のトランスフォーム
     matrix effect_transform_ = matrix::scale(1.0f);
 
+    u64                      local_version_ = WorldMatrixCache::NewVersion();    //!< ローカル行列のバージョン
+    mutable WorldMatrixCache world_cache_;                                       //!< ワールド行列キャッシュ
+
     Status<EffectBit> effect_status_;    //!< 状態
     std::string       path_{};           //!< 読み込みエフェクト名
 
@@ -0,0 +1,92 @@
+﻿//---------------------------------------------------------------------------
+//! @file   ComponentInstancedModel.cpp
+//! @brief  インスタンス描画モデルコンポーネント
+//---------------------------------------------------------------------------
+#include <System/Component/ComponentInstancedModel.h>
+#include <System/Component/ComponentTransform.h>
+#include <System/Object.h>
+#include <System/ImGui.h>
+
+//! @brief モデルロード
+//! @param path ロードするモデル(.MV1/.MQO/.Xなど)
+void ComponentInstancedModel::Load(std::string_view path) {
+    path_ = path;
+
+    // ファイルが存在しているか?
+    if(!HelperLib::File::CheckFileExistence(path_)) {
+        mesh_.reset();
+        return;
+    }
+
+    // 同じモデルのメッシュは共有
+    mesh_ = InstancedRenderer::acquire(path_);
+}
+
+//! @brief 描画登録 (描画はシーンの描画後にまとめて行われます)
+void ComponentInstancedModel::Draw() {
+    visible_ = false;
+
+    if(GetStatus(Component::StatusBit::NoDraw))
+        return;
+
+    if(mesh_ == nullptr)
+        return;
+
+    // 物理の補間姿勢など描画専用の姿勢があればそれで描画する
+    visible_ = InstancedRenderer::submit(mesh_, mul(model_transform_, GetOwner()->GetDrawMatrix()));
+}
+
+//! @brief GUI処理
+void ComponentInstancedModel::GUI() {
+    // オーナーの取得
+    assert(GetOwner());
+    auto obj_name = GetOwner()->GetName();
+
+    ImGui::Begin(obj_name.data());
+    {
+        ImGui::Separator();
+
+        auto name = std::string(u8"InstancedModel 【") + std::string(GetName()) + std::string(u8"】");
+        if(ImGui::TreeNode(UNIQUE_TEXT(name))) {
+            if(ImGui::Button(UNIQUE_TEXT(u8"削除"))) {
+                GetOwner()->RemoveComponent(shared_from_this());
+            }
+
+            // ロード完了チェックフラグ
+            bool loaded = mesh_ && mesh_->isActive();
+
+            ImGui::BeginDisabled(true);    // UI上の編集不可(ReadOnly)
+            {
+                if(loaded)
+                    ImGui::Checkbox(u8"【LoadOK】", &loaded);
+                else
+                    ImGui::TextColored({1, 0, 0, 1}, u8"【LoadNG】");
+
+                ImGui::SameLine();
+                bool visible = visible_;
+                ImGui::Checkbox(u8"【Visible】", &visible);
+            }
+            ImGui::EndDisabled();
+
+            // モデルファイル名
+            char file_name[1024]{};
+            sprintf_s(file_name, "%s", path_.c_str());
+            if(ImGui::InputText(UNIQUE_TEXT(u8"File"), file_name, 1024)) {
+                Load(file_name);
+            }
+            ImGui::Separator();
+
+            // 姿勢を TRSで変更できるように設定
+            float* mat = model_transform_.f32_128_0;
+            float  matrixTranslation[3], matrixRotation[3], matrixScale[3];
+            DecomposeMatrixToComponents(mat, matrixTranslation, matrixRotation, matrixScale);
+            ImGui::DragFloat3(UNIQUE_TEXT(u8"座標(T)"), matrixTranslation, 0.01f, -100000.00f, 100000.0f, "%.2f");
+            ImGui::DragFloat3(UNIQUE_TEXT(u8"回転(R)"), matrixRotation, 0.1f, -360.0f, 360.0f, "%.2f");
+            ImGui::DragFloat3(UNIQUE_TEXT(u8"スケール(S)"), matrixScale, 0.01f, 0.00f, 1000.0f, "%.2f");
+            RecomposeMatrixFromComponents(matrixTranslation, matrixRotation, matrixScale, mat);
+
+            ImGui::TreePop();
+        }
+    }
+    ImGui::End();
+}
@@ -0,0 +1,81 @@
+﻿//---------------------------------------------------------------------------
+//! @file   ComponentInstancedModel.h
+//! @brief  インスタンス描画モデルコンポーネント
+//---------------------------------------------------------------------------
+#pragma once
+
+#include <System/Component/Component.h>
+#include <System/Graphics/InstancedRenderer.h>
+#include <System/Cereal.h>
+
+USING_PTR(ComponentInstancedModel);
+
+//! @brief インスタンス描画モデルコンポーネントクラス
+//! @details 同じモデルを並べる動かない小物用です。
+//!          モデルは InstancedRenderer でまとめて描画され、MV1ハンドルの複製やアニメーションは行いません
+class ComponentInstancedModel: public Component {
+   public:
+    BP_COMPONENT_DECL(ComponentInstancedModel, u8"InstancedModel機能クラス");
+
+    ComponentInstancedModel() {
+        // 複数設定可能とする
+        SetStatus(Component::StatusBit::SameType, true);
+    }
+
+    void Construct(ObjectPtr owner) {
+        __super::Construct(owner);
+    }
+
+    void Construct(ObjectPtr owner, std::string_view path) {
+        __super::Construct(owner);
+        Load(path);
+    }
+
+    //! @brief モデルロード
+    //! @param path モデル名
+    void Load(std::string_view path);
+
+    virtual void Draw() override;    //!< 描画登録
+    virtual void GUI() override;     //!< GUI
+
+    //! @brief モデル用のトランスフォームを設定
+    //! @param mat オーナーのワールド行列に掛ける行列 (ComponentModel と同じく既定は0.1倍)
+    void SetModelMatrix(const matrix& mat) {
+        model_transform_ = mat;
+    }
+
+    //! @brief モデル用のトランスフォームを取得
+    const matrix& GetModelMatrix() const {
+        return model_transform_;
+    }
+
+    //! @brief 直前の描画で視錐台内にあったか
+    bool IsVisible() const {
+        return visible_;
+    }
+
+   private:
+    matrix                         model_transform_ = matrix::scale(0.1f);    //!< モデル用のトランスフォーム
+    std::string                    path_            = "";                     //!< 読み込みモデル名
+    std::shared_ptr<InstancedMesh> mesh_;                                     //!< 共有メッシュ
+    bool                           visible_ = false;                          //!< 直前の描画で視錐台内にあったか
+
+   private:
+    //--------------------------------------------------------------------
+    //! @name Cereal処理
+    //--------------------------------------------------------------------
+    //@{
+    CEREAL_SAVELOAD(arc, ver) {
+        arc(cereal::make_nvp("owner", owner_), cereal::make_nvp("model_transform", model_transform_),
+            cereal::make_nvp("path", path_));
+
+        arc(cereal::make_nvp("Component", cereal::base_class<Component>(this)));
+
+        if(!path_.empty())
+            Load(path_);
+    }
+    //@}
+};
+
+CEREAL_REGISTER_TYPE(ComponentInstancedModel)
+CEREAL_REGISTER_POLYMORPHIC_RELATION(Component, ComponentInstancedModel)
@@ -5,10 +5,14 @@
 #include <System/Component/ComponentModel.h>
 #include <System/Component/ComponentTransform.h>
 #include <System/Object.h>
+#include <System/Graphics/Frustum.h>
 
 namespace {
 std::string null_name = "  ";
 
+//! アニメーションするモデルの境界の拡大率 (キャッシュの頂点はバインドポーズのため)
+constexpr f32 animated_bounds_scale = 1.5f;
+
 // string用のCombo
 static int Combo(const std::string& caption, std::string& current_item, const std::vector<std::string_view>& items) {
     int select_index = -1;
@@ -107,19 +111,24 @@ void ComponentModel::Update() {
 
     // モデルが存在しているならばTransform設定を行う
     if(IsValid()) {
-        // アニメーションがあり再生している?
-        if(animation_ && animation_->isValid() && animation_->isPlaying()) {
+        // アニメーションがアタッチされている?
+        // 基本レイヤーの再生が終わっても補間中やほかのレイヤーは進める
+        if(animation_ && animation_->isValid() && animation_->activeClipCount() > 0) {
+            bool was_playing = animation_->isPlaying();
+
             animation_->update(delta);
-            animation_time_ += delta;
+            if(was_playing) {
+                animation_time_ += delta;
 
-            // 進めた結果終了した場合はOldとして確保
-            if(!animation_->isPlaying()) {
-                old_animation_name_ = current_animation_name_;
+                // 進めた結果終了した場合はOldとして確保
+                if(!animation_->isPlaying()) {
+                    old_animation_id_ = current_animation_id_;
+                }
             }
         }
 
         auto mat  = model_transform_;
-        auto trns = GetOwner()->GetComponent<ComponentTransform>();
+        auto trns = GetOwner()->FindComponent<ComponentTransform>();
         if(trns) {
             mat = mul(mat, trns->GetWorldMatrix());
         }
@@ -130,6 +139,7 @@ void ComponentModel::Update() {
 
             // モデル更新
             model_->update(delta);
+            DirtyNodeMatrix();
         }
     }
 }
@@ -143,59 +153,93 @@ void ComponentModel::Draw() {
     if(GetStatus(Component::StatusBit::NoDraw))
         return;
 
+    // 視錐台の外にあるものは描画しない
+    if(culled_)
+        return;
+
     if(model_ == nullptr)
         return;
 
     // ワールド行列を設定(コリジョン移動分)
-    model_->setWorldMatrix(GetWorldMatrix());
+    // 物理の補間姿勢など描画専用の姿勢があればそれで描画する
+    auto owner           = GetOwner();
+    bool has_draw_matrix = owner->HasDrawMatrix();
+    model_->setWorldMatrix(has_draw_matrix ? calcWorldMatrix(owner->GetDrawMatrix()) : GetWorldMatrix());
+    DirtyNodeMatrix();
 
     // シェーダーを利用するかどうかを設定
     model_->useShader(UseShader());
 
-    std::shared_ptr<Texture> empty = nullptr;
-
-    auto drawFrame = [this, &empty](int i) {
-        if(materials_.find(i) != materials_.end()) {
-            // マテリアルが存在した
-            model_->overrideTexture(Model::TextureType::Diffuse, materials_[i].diffuse_);
-            model_->overrideTexture(Model::TextureType::Normal, materials_[i].normal_);
-            model_->overrideTexture(Model::TextureType::Roughness, materials_[i].roughness_);
-            model_->overrideTexture(Model::TextureType::Metalness, materials_[i].metalness_);
-            model_->overrideTexture(Model::TextureType::AO, materials_[i].AO_);
-            model_->overrideTexture(Model::TextureType::Specular, materials_[i].specular_);
-        } else {
-            // 存在せず
-            model_->overrideTexture(Model::TextureType::Diffuse, empty);
-            model_->overrideTexture(Model::TextureType::Normal, empty);
-            model_->overrideTexture(Model::TextureType::Roughness, empty);
-            model_->overrideTexture(Model::TextureType::Metalness, empty);
-            model_->overrideTexture(Model::TextureType::AO, empty);
-            model_->overrideTexture(Model::TextureType::Specular, empty);
-        }
-        model_->renderByFrame(i, overrided_shader_vs_, overrided_shader_ps_);
+    // 描画されるマテリアルのテクスチャはカメラに近いものから読み込む
+    if(!materials_.empty()) {
+        f32 distance = length(GetWorldMatrix()._41_42_43 - cast(GetCameraPosition()));
+        for(auto& [index, material]: materials_)
+            material.TouchTextures(distance);
+    }
+
+    // マテリアルの上書きテクスチャはフレームごとに解決済のものを使う
+    UpdateFrameTextures();
+
+    auto drawFrame = [this](int i) {
+        const auto* textures = (0 <= i && i < static_cast<int>(frame_textures_.size())) ? &frame_textures_[i] : nullptr;
+        model_->renderByFrame(i, overrided_shader_vs_, overrided_shader_ps_, textures ? textures : &no_textures_);
     };
 
     // モデル描画
     if(draw_meshes_.size() > 0 && draw_meshes_[0] == -1) {
-        if(materials_.find(-1) != materials_.end()) {
-            model_->overrideTexture(Model::TextureType::Diffuse, materials_[-1].diffuse_);
-            model_->overrideTexture(Model::TextureType::Normal, materials_[-1].normal_);
-            model_->overrideTexture(Model::TextureType::Roughness, materials_[-1].roughness_);
-            model_->overrideTexture(Model::TextureType::Metalness, materials_[-1].metalness_);
-            model_->overrideTexture(Model::TextureType::AO, materials_[-1].AO_);
-            model_->overrideTexture(Model::TextureType::Specular, materials_[-1].specular_);
-            model_->render();
+        // 読み込み中はモデルキャッシュを描画 (フレーム単位の描画はブロッキングロードになるため)
+        if(has_all_textures_ || !model_->isActive()) {
+            model_->render(nullptr, nullptr, &all_textures_);
         } else {
             for(int i = 0; i < model_->frameCount(); ++i) {
                 drawFrame(i);
             }
         }
-        return;
+    } else {
+        for(int i: draw_meshes_) {
+            drawFrame(i);
+        }
     }
 
-    for(int i: draw_meshes_) {
-        drawFrame(i);
+    // ノード行列を参照するゲーム処理が描画専用の姿勢を見ないように戻す
+    if(has_draw_matrix) {
+        model_->setWorldMatrix(GetWorldMatrix());
+        DirtyNodeMatrix();
+    }
+}
+
+//! @brief フレームごとの上書きテクスチャを解決
+//! @details マテリアルが変更されたか、モデルのフレーム数が変わった場合のみ作り直します
+void ComponentModel::UpdateFrameTextures() {
+    // 読み込み中にフレーム数を取得するとブロッキングロードになるため読み込み後に作成
+    s32 frame_count = model_->isActive() ? std::max(model_->frameCount(), 0) : 0;
+    if(!frame_textures_dirty_ && static_cast<s32>(frame_textures_.size()) == frame_count)
+        return;
+
+    auto resolve = [](const Material& material) {
+        Model::TextureOverrides textures{};
+        textures[static_cast<s32>(Model::TextureType::Diffuse)]   = material.diffuse_.get();
+        textures[static_cast<s32>(Model::TextureType::Normal)]    = material.normal_.get();
+        textures[static_cast<s32>(Model::TextureType::Roughness)] = material.roughness_.get();
+        textures[static_cast<s32>(Model::TextureType::Metalness)] = material.metalness_.get();
+        textures[static_cast<s32>(Model::TextureType::AO)]        = material.AO_.get();
+        textures[static_cast<s32>(Model::TextureType::Specular)]  = material.specular_.get();
+        return textures;
+    };
+
+    // マテリアルが存在しないフレームは上書きなし
+    frame_textures_.assign(frame_count, Model::TextureOverrides{});
+    for(auto& [index, material]: materials_) {
+        if(0 <= index && index < frame_count)
+            frame_textures_[index] = resolve(material);
     }
+
+    // -1 はモデル全体に適用
+    auto it           = materials_.find(-1);
+    has_all_textures_ = it != materials_.end();
+    all_textures_     = has_all_textures_ ? resolve(it->second) : Model::TextureOverrides{};
+
+    frame_textures_dirty_ = false;
 }
 
 //! @brief 終了処理
@@ -329,6 +373,69 @@ void ComponentModel::GUI() {
                         if(ImGui::Button(UNIQUE_TEXT(u8"アニメーション追加")))
                             animations_desc_.push_back({});
 
+                        // 選択中のアニメーションのイベントトラック
+                        if(ImGui::TreeNode(UNIQUE_TEXT(u8"イベント"))) {
+                            static const char* type_names[] = {u8"通知", u8"コリジョン有効", u8"コリジョン無効", u8"サウンド",
+                                                               u8"エフェクト"};
+
+                            for(auto& desc: animations_desc_) {
+                                if(desc.name_ != current_animation_name_)
+                                    continue;
+
+                                bool event_change = false;
+                                for(int i = 0; i < (int)desc.events_.size();) {
+                                    auto& event = desc.events_[i];
+                                    ImGui::PushID(i);
+                                    if(ImGui::Button(u8"削除")) {
+                                        desc.events_.erase(desc.events_.begin() + i);
+                                        event_change = true;
+                                        ImGui::PopID();
+                                        continue;
+                                    }
+                                    ImGui::SameLine();
+
+                                    int type = (int)event.type_;
+                                    ImGui::SetNextItemWidth(120);
+                                    if(ImGui::Combo("##type", &type, type_names, (int)std::size(type_names))) {
+                                        event.type_  = (Animation::Event::Type)type;
+                                        event_change = true;
+                                    }
+                                    ImGui::SameLine();
+                                    ImGui::SetNextItemWidth(80);
+                                    event_change |= ImGui::DragFloat("##time", &event.time_, 0.5f, 0.0f, 10000.0f, "%.1f");
+                                    ImGui::SameLine();
+                                    ImGui::SetNextItemWidth(120);
+                                    event_change |= ImGui::InputText("##name", &event.name_);
+                                    ImGui::SameLine();
+                                    ImGui::SetNextItemWidth(60);
+                                    event_change |= ImGui::DragFloat("##value", &event.value_);
+                                    ImGui::PopID();
+                                    i++;
+                                }
+
+                                if(ImGui::Button(UNIQUE_TEXT(u8"イベント追加"))) {
+                                    // 再生中の時間に追加
+                                    Animation::Event event;
+                                    event.time_ = GetAnimationPlayTime();
+                                    desc.events_.push_back(event);
+                                    event_change = true;
+                                }
+
+                                // アニメーションは作りなおさずにイベントだけ差し替える
+                                if(event_change && animation_)
+                                    animation_->setEvents(AnimId(desc.name_), desc.events_);
+                            }
+
+                            ImGui::InputText(UNIQUE_TEXT(u8"ファイル"), &animation_events_path_);
+                            if(ImGui::Button(UNIQUE_TEXT(u8"保存")))
+                                SaveAnimationEvents(animation_events_path_);
+                            ImGui::SameLine();
+                            if(ImGui::Button(UNIQUE_TEXT(u8"読み込み")))
+                                LoadAnimationEvents(animation_events_path_);
+
+                            ImGui::TreePop();
+                        }
+
                         ImGui::TreePop();
                     }
                 }
@@ -443,18 +550,21 @@ void ComponentModel::GUI() {
 
     if(node_manipulate_) {
         matrix matx = MV1GetFrameLocalWorldMatrix(GetModel(), select_node_index_);
-        auto   trns = GetOwner()->GetComponent<ComponentTransform>();
+        auto   trns = GetOwner()->FindComponent<ComponentTransform>();
 
         float* mat_float = (float*)matx.f32_128_0;
         ShowGizmo(mat_float, gizmo_operation_, gizmo_mode_, reinterpret_cast<uint64_t>(this));
     }
     if(editor_attach_node_manipulate_) {
         matrix matx = MV1GetFrameLocalWorldMatrix(editor_attach_model_->GetModel(), editor_attach_node_index_);
-        auto   trns = GetOwner()->GetComponent<ComponentTransform>();
+        auto   trns = GetOwner()->FindComponent<ComponentTransform>();
 
         float* mat_float = (float*)matx.f32_128_0;
         ShowGizmo(mat_float, gizmo_operation_, gizmo_mode_, reinterpret_cast<uint64_t>(this));
     }
+
+    // GUIからは model_transform_ を直接編集しているため毎回キャッシュを無効にする
+    local_version_ = WorldMatrixCache::NewVersion();
 }
 
 ComponentModelPtr ComponentModel::SetAnimation(const std::vector<Animation::Desc> anims) {
@@ -464,6 +574,7 @@ ComponentModelPtr ComponentModel::SetAnimation(const std::vector<Animation::Desc
 
         // アニメーションクラスの作成
         animation_ = std::make_unique<Animation>(anims.data(), anims.size());
+        animation_->setEventCallback(animation_event_callback_);
 
         //  モデルにアニメーションを設定
         model_->bindAnimation(animation_.get());
@@ -481,10 +592,115 @@ void ComponentModel::PlayAnimationNoSame(std::string_view name, bool loop, float
 
 void ComponentModel::PlayAnimation(std::string_view name, bool loop, float blend_time, float start_time) {
     if(animation_) {
-        animation_->play(name, loop, blend_time, start_time);
+        PlayAnimation(AnimId::find(name), loop, blend_time, start_time);
+
+        // 登録されていない名前も再生要求として残す
         current_animation_name_ = name;
+    }
+}
+
+void ComponentModel::PlayAnimationNoSame(AnimId id, bool loop, float blend_time, float start_time) {
+    if(current_animation_id_ == id)
+        return;
+
+    PlayAnimation(id, loop, blend_time, start_time);
+}
+
+void ComponentModel::PlayAnimation(AnimId id, bool loop, float blend_time, float start_time) {
+    if(animation_) {
+        animation_->play(id, loop, blend_time, start_time);
+        current_animation_id_   = id;
+        current_animation_name_ = id.name();
         animation_time_         = 0.0f;
+        DirtyNodeMatrix();
+    }
+}
+
+void ComponentModel::SetAnimationLayer(u32 layer, std::string_view frame_name, float weight) {
+    if(!animation_ || !model_ || layer == 0)
+        return;
+
+    if(animation_->layerCount() <= layer)
+        animation_->setLayerCount(layer + 1);
+
+    s32 frame_index = -1;
+    if(!frame_name.empty()) {
+        frame_index = MV1SearchFrame(GetModel(), std::string(frame_name).c_str());
+        if(frame_index < 0)
+            return;
     }
+    animation_->setLayerMask(layer, frame_index, weight);
+}
+
+void ComponentModel::PlayAnimationLayer(u32 layer, AnimId id, bool loop, float blend_time) {
+    if(animation_) {
+        animation_->playLayer(layer, id, loop, blend_time);
+        DirtyNodeMatrix();
+    }
+}
+
+void ComponentModel::StopAnimationLayer(u32 layer, float blend_time) {
+    if(animation_)
+        animation_->stopLayer(layer, blend_time);
+}
+
+void ComponentModel::SetAnimationEventCallback(Animation::EventCallback callback) {
+    animation_event_callback_ = std::move(callback);
+    if(animation_)
+        animation_->setEventCallback(animation_event_callback_);
+}
+
+void ComponentModel::SetAnimationEvents(AnimId id, std::vector<Animation::Event> events) {
+    if(!id.isValid())
+        return;
+
+    // アニメーションを作りなおしても残るように定義側にも保存しておく
+    for(auto& desc: animations_desc_) {
+        if(desc.name_ == id.name())
+            desc.events_ = events;
+    }
+
+    if(animation_)
+        animation_->setEvents(id, std::move(events));
+}
+
+bool ComponentModel::LoadAnimationEvents(std::string_view path) {
+    std::ifstream file{std::string(path)};
+    if(!file)
+        return false;
+
+    // アニメーション名ごとのイベントトラック
+    std::unordered_map<std::string, std::vector<Animation::Event>> tracks;
+    {
+        cereal::JSONInputArchive i_archive(file);
+        i_archive(CEREAL_NVP(tracks));
+    }
+
+    for(auto& [name, events]: tracks)
+        SetAnimationEvents(AnimId::find(name), std::move(events));
+
+    animation_events_path_ = path;
+    return true;
+}
+
+bool ComponentModel::SaveAnimationEvents(std::string_view path) {
+    std::ofstream file{std::string(path)};
+    if(!file)
+        return false;
+
+    std::unordered_map<std::string, std::vector<Animation::Event>> tracks;
+    for(auto& desc: animations_desc_) {
+        if(!desc.events_.empty())
+            tracks[desc.name_] = desc.events_;
+    }
+
+    {
+        cereal::JSONOutputArchive o_archive(file);
+        o_archive(CEREAL_NVP(tracks));
+    }
+
+    animation_events_path_ = path;
+    return true;
 }
 
 bool ComponentModel::IsPlaying() {
@@ -494,6 +710,13 @@ bool ComponentModel::IsPlaying() {
     return false;
 }
 
+bool ComponentModel::IsPlaying(AnimId id) {
+    if(animation_)
+        return animation_->isPlaying(id);
+
+    return false;
+}
+
 void ComponentModel::PlayPause(bool is_pause) {
     if(animation_)
         animation_->pause(is_pause);
@@ -525,13 +748,32 @@ const std::string_view ComponentModel::GetPlayAnimationName() {
 const std::string_view ComponentModel::GetOldPlayAnimationName() {
     if(IsPlaying()) {
         // 既に再生されている場合は前のアニメーション名を返す
-        return old_animation_name_;
+        return old_animation_id_.name();
     }
 
     // 何も再生されていないときは再生されていたものを返す
     return current_animation_name_;
 }
 
+AnimId ComponentModel::GetPlayAnimationId() {
+    if(IsPlaying()) {
+        return current_animation_id_;
+    }
+
+    // 何も再生されていない
+    return {};
+}
+
+AnimId ComponentModel::GetOldPlayAnimationId() {
+    if(IsPlaying()) {
+        // 既に再生されている場合は前のアニメーションIDを返す
+        return old_animation_id_;
+    }
+
+    // 何も再生されていないときは再生されていたものを返す
+    return current_animation_id_;
+}
+
 const float ComponentModel::GetAnimationTime() {
     if(IsPlaying())
         return animation_time_;
@@ -644,15 +886,18 @@ matrix ComponentModel::GetNodeMatrix(int no, bool local) {
 }
 
 void ComponentModel::SetMaterial(int index, Material material) {
-    materials_[index] = material;
+    materials_[index]     = material;
+    frame_textures_dirty_ = true;
 }
 
 void ComponentModel::ResetMaterial(int index) {
     materials_.erase(index);
+    frame_textures_dirty_ = true;
 }
 
 void ComponentModel::ResetMaterialAll() {
     materials_.clear();
+    frame_textures_dirty_ = true;
 }
 
 void ComponentModel::SetDrawMeshIndex(const std::vector<int>& meshes) {
@@ -673,28 +918,107 @@ void ComponentModel::SetDrawMeshIndex(const std::vector<int>& meshes) {
 //! @brief ワールドMatrixの取得
 //! @return 他のコンポーネントも含めた位置
 const matrix ComponentModel::GetWorldMatrix() const {
-    matrix mat = matrix::identity();
+    auto owner = GetOwner();
 
-    // AttachedOtherModelの場合はそのコンポーネントもマージする
+    u64 attach_version = getAttachVersion();
+    u64 owner_version  = owner->GetWorldVersion();
+    if(world_cache_.isValid(owner_version, local_version_, attach_version))
+        return world_cache_.get();
+
+    return world_cache_.resolve(owner_version, local_version_, attach_version, calcWorldMatrix(owner->GetWorldMatrix()));
+}
+
+//! @brief 1フレーム前のワールドMatrixの取得
+//! @return 他のコンポーネントも含めた位置
+const matrix ComponentModel::GetOldWorldMatrix() const {
+    // PostUpdate後に確定した行列があればそのまま返す
+    if(world_cache_.hasOld())
+        return world_cache_.old();
+
+    return calcWorldMatrix(GetOwner()->GetOldWorldMatrix());
+}
+
+//! @brief ワールド行列のバージョン取得
+//! @return ワールド行列が再計算されるたびに変わる値
+u64 ComponentModel::GetWorldVersion() const {
+    return world_cache_.version(GetOwner()->GetWorldVersion(), local_version_, getAttachVersion());
+}
+
+//! @brief アタッチ先のノード行列のバージョン取得
+//! @details アタッチ先のノードが動いた場合もワールド行列を再計算するため依存キーに含めます
+u64 ComponentModel::getAttachVersion() const {
     if(IsAttachedOtherModel()) {
-        mat = GetAttachMatrix();
+        if(auto target_model = target_model_.lock())
+            return target_model->node_version_;
+    }
+    return 0;
+}
 
-        // スケールを自前のものに戻す
-        if(!use_model_node_scale_) {
-            matrix parent_mat(float4{normalize(mat.axisX()), 0}, float4{normalize(mat.axisY()), 0},
-                              float4{normalize(mat.axisZ()), 0}, float4{mat.translate(), 1});
-            mat = parent_mat;
+//! @brief ワールド行列を確定して1フレーム前の行列として保存する
+void ComponentModel::ResolveWorldMatrix() {
+    world_cache_.storeOld(GetWorldMatrix());
+}
+
+//! @brief ワールド空間の境界AABBを取得
+//! @details ワールド行列が変わった時だけモデルキャッシュの境界から計算しなおします
+bool ComponentModel::GetWorldBounds(float3& aabb_min, float3& aabb_max) {
+    u64 version = GetWorldVersion();
+    if(bounds_version_ != version) {
+        float3 local_min;
+        float3 local_max;
+        if(model_ == nullptr || !model_->localBounds(local_min, local_max))
+            return false;
+
+        float3 center = (local_min + local_max) * 0.5f;
+        float3 extent = (local_max - local_min) * 0.5f;
+        if(animation_)
+            extent *= animated_bounds_scale;
+
+        // 回転したAABBを包む軸平行なAABB (各軸の絶対値で広がりを求める)
+        matrix mat_world    = GetWorldMatrix();
+        float3 world_center = mul(float4(center, 1.0f), mat_world).xyz;
+        float3 world_extent = abs(mat_world.axisX()) * extent.x + abs(mat_world.axisY()) * extent.y +
+                              abs(mat_world.axisZ()) * extent.z;
+
+        bounds_min_     = world_center - world_extent;
+        bounds_max_     = world_center + world_extent;
+        bounds_version_ = version;
+    }
+
+    aabb_min = bounds_min_;
+    aabb_max = bounds_max_;
+    return true;
+}
+
+//! @brief 描画するかを判定して今フレームの可視状態を設定する
+bool ComponentModel::UpdateVisibility(const Frustum& frustum) {
+    culled_ = false;
+
+    // 境界が分からない間は常に描画する
+    float3 aabb_min;
+    float3 aabb_max;
+    if(!GetWorldBounds(aabb_min, aabb_max))
+        return true;
+
+    // 描画距離 (AABBの最近点までの距離)
+    if(cull_distance_ > 0.0f) {
+        float3 position = frustum.position();
+        float3 nearest  = clamp(position, aabb_min, aabb_max);
+        f32    distance = length(nearest - position);
+        if(distance > cull_distance_) {
+            culled_ = true;
+            return false;
         }
     }
 
-    mat = mul(GetMatrix(), mat);
-    return mul(mat, GetOwner()->GetWorldMatrix());
+    culled_ = !frustum.isVisibleAabb(aabb_min, aabb_max);
+    return !culled_;
 }
 
-//! @brief 1フレーム前のワールドMatrixの取得
+//! @brief ワールド行列の計算 (キャッシュなし)
+//! @param owner_world オーナーのワールド行列
 //! @return 他のコンポーネントも含めた位置
-
-const matrix ComponentModel::GetOldWorldMatrix() const {
+matrix ComponentModel::calcWorldMatrix(const matrix& owner_world) const {
     matrix mat = matrix::identity();
 
     // AttachedOtherModelの場合はそのコンポーネントもマージする
@@ -710,7 +1034,7 @@ const matrix ComponentModel::GetOldWorldMatrix() const {
     }
 
     mat = mul(GetMatrix(), mat);
-    return mul(mat, GetOwner()->GetOldWorldMatrix());
+    return mul(mat, owner_world);
 }
 
 bool ComponentModel::Attach(const std::string_view& model, const std::string_view& node, bool use_model_node_scale) {
@@ -760,4 +1084,4 @@ matrix ComponentModel::GetAttachMatrix() const {
     return mat;
 }
 
-CEREAL_CLASS_VERSION(ComponentModel, 2);
+CEREAL_CLASS_VERSION(ComponentModel, 3);
@@ -7,11 +7,14 @@
 #include <System/Component/Component.h>
 #include <System/Component/ComponentTransform.h>
 #include <System/Graphics/Animation.h>
+#include <System/Graphics/TexturePool.h>
 
 #include <ImGuizmo/ImGuizmo.h>
 
 USING_PTR(ComponentModel);
 
+class Frustum;
+
 //! @brief モデルコンポーネントクラス
 class ComponentModel
     : public Component
@@ -32,14 +35,14 @@ class ComponentModel
     ~ComponentModel() {}
 
     void Construct(ObjectPtr owner) {
-        auto models = owner->GetComponents<ComponentModel>();
+        auto models = owner->ViewComponents<ComponentModel>();
         name_       = "Model" + std::to_string(models.size());
 
         __super::Construct(owner);
     }
 
     void Construct(ObjectPtr owner, std::string_view path) {
-        auto models = owner->GetComponents<ComponentModel>();
+        auto models = owner->ViewComponents<ComponentModel>();
         name_       = "Model" + std::to_string(models.size());
 
         __super::Construct(owner);
@@ -91,10 +94,67 @@ class ComponentModel
     //! @param start_time スタートする位置(デフォルト:0.0)
     void PlayAnimation(std::string_view name, bool loop = false, float blend_time = 0.2f, float start_time = 0.0f);
 
+    //! @brief アニメーション再生(同じなら再再生しない)
+    //! @param id 再生するアニメーションID
+    //! @param loop ループするかどうか(デフォルト:しない)
+    //! @param speed 補完秒数(デフォルト:0.2秒)
+    //! @param start_time スタートする位置(デフォルト:0.0)
+    void PlayAnimationNoSame(AnimId id, bool loop = false, float blend_time = 0.2f, float start_time = 0.0f);
+
+    //! @brief アニメーション再生
+    //! @param id 再生するアニメーションID
+    //! @param loop ループするかどうか(デフォルト:しない)
+    //! @param speed 補完秒数(デフォルト:0.2秒)
+    //! @param start_time スタートする位置(デフォルト:0.0)
+    void PlayAnimation(AnimId id, bool loop = false, float blend_time = 0.2f, float start_time = 0.0f);
+
+    //! @brief アニメーションレイヤーの適用範囲を設定 (足りない場合はレイヤーを追加)
+    //! @param layer レイヤー番号 (1以上)
+    //! @param frame_name 適用するフレーム名 (子フレームも含む 空なら全身)
+    //! @param weight 下位レイヤーを上書きする割合
+    void SetAnimationLayer(u32 layer, std::string_view frame_name, float weight = 1.0f);
+
+    //! @brief レイヤーでアニメーション再生 (上半身だけ別のアニメーションなど)
+    //! @param layer レイヤー番号 (1以上)
+    //! @param id 再生するアニメーションID
+    //! @param loop ループするかどうか(デフォルト:しない)
+    //! @param blend_time 補完秒数(デフォルト:0.2秒)
+    void PlayAnimationLayer(u32 layer, AnimId id, bool loop = false, float blend_time = 0.2f);
+
+    //! @brief レイヤーのアニメーションをフェードアウトして停止
+    //! @param layer レイヤー番号 (1以上)
+    //! @param blend_time 補完秒数(デフォルト:0.2秒)
+    void StopAnimationLayer(u32 layer, float blend_time = 0.2f);
+
+    //! @brief アニメーションイベントの通知先を設定
+    //! @details 再生中のアニメーションがイベントの時間を通過したときに呼ばれます (毎フレームの時間の確認は不要)
+    //! @param callback 通知先
+    void SetAnimationEventCallback(Animation::EventCallback callback);
+
+    //! @brief アニメーションのイベントトラックを設定
+    //! @param id アニメーションID
+    //! @param events イベントトラック
+    void SetAnimationEvents(AnimId id, std::vector<Animation::Event> events);
+
+    //! @brief イベントトラックをファイルから読み込み (ファイルにあるアニメーションのみ上書き)
+    //! @param path ファイルパス
+    //! @retval false : ファイルが無い
+    bool LoadAnimationEvents(std::string_view path);
+
+    //! @brief イベントトラックをファイルに保存
+    //! @param path ファイルパス
+    //! @retval false : 保存できない
+    bool SaveAnimationEvents(std::string_view path);
+
     //! @brief アニメーション中かどうか
     //! @retval true : アニメーション中
     bool IsPlaying();
 
+    //! @brief 指定のアニメーション中かどうか
+    //! @param id アニメーションID
+    //! @retval true : アニメーション中
+    bool IsPlaying(AnimId id);
+
     //! @brief ポーズ処理と解除処理
     //! @param active ポーズするかどうか
     void PlayPause(bool active = true);
@@ -115,6 +175,14 @@ class ComponentModel
     //! @return アニメーション名
     const std::string_view GetOldPlayAnimationName();
 
+    //! @brief 再生アニメーションID
+    //! @return アニメーションID (再生していない場合は無効なID)
+    AnimId GetPlayAnimationId();
+
+    //! @brief 前回再生したアニメーションID
+    //! @return アニメーションID
+    AnimId GetOldPlayAnimationId();
+
     //! @brief 再生経過時間の取得
     //! @return 再生経過時間
     const float GetAnimationTime();
@@ -159,6 +227,12 @@ class ComponentModel
     matrix GetNodeMatrix(std::string_view name, bool local = false);
     matrix GetNodeMatrix(int no, bool local = false);
 
+    //! @brief ノード行列が変化したことを通知
+    //! @details ノードへアタッチしているモデルのワールド行列キャッシュを無効にします
+    void DirtyNodeMatrix() {
+        node_version_ = WorldMatrixCache::NewVersion();
+    }
+
     //@}
 
     //---------------------------------------------------------------------------
@@ -189,6 +263,7 @@ class ComponentModel
     }
     void SetAttachOtherModel(bool link) {
         model_status_.set(ModelBit::AttachedOtherModel, link);
+        local_version_ = WorldMatrixCache::NewVersion();
     }
 
     bool Attach(const std::string_view& model, const std::string_view& node, bool use_model_node_scale = false);
@@ -216,19 +291,26 @@ class ComponentModel
 
         void SetDiffuse(const std::string_view diffuse) {
             file_diffuse_ = diffuse;
-            diffuse_      = std::make_shared<Texture>(diffuse);
+            diffuse_      = TexturePool::load(diffuse);
         }
         void SetNormal(const std::string_view normal) {
             file_normal_ = normal;
-            normal_      = std::make_shared<Texture>(normal);
+            normal_      = TexturePool::load(normal);
         }
         void SetRoughness(const std::string_view roughness) {
             file_roughness_ = roughness;
-            roughness_      = std::make_shared<Texture>(roughness);
+            roughness_      = TexturePool::load(roughness);
         }
         void SetMetalness(const std::string_view metalness) {
             file_metalness_ = metalness;
-            metalness_      = std::make_shared<Texture>(metalness);
+            metalness_      = TexturePool::load(metalness);
+        }
+
+        //! 描画で使用したテクスチャの読み込み優先を更新
+        //! @param [in] priority    読み込み優先 (カメラからの距離)
+        void TouchTextures(f32 priority) const {
+            for(auto* texture: {diffuse_.get(), normal_.get(), roughness_.get(), metalness_.get(), AO_.get(), specular_.get()})
+                TexturePool::touch(texture, priority);
         }
 
        private:
@@ -264,10 +346,18 @@ class ComponentModel
     void SetDrawMeshIndex(const std::vector<int>& meshes);
 
    private:
-    std::unordered_map<int, Material> materials_;
-    std::vector<int>                  draw_meshes_{-1};
-    ShaderVs*                         overrided_shader_vs_ = nullptr;    //!< 上書きする頂点シェーダー
-    ShaderPs*                         overrided_shader_ps_ = nullptr;    //!< 上書きするピクセルシェーダー
+    //! フレームごとの上書きテクスチャを解決
+    void UpdateFrameTextures();
+
+    std::unordered_map<int, Material>    materials_;
+    std::vector<int>                     draw_meshes_{-1};
+    ShaderVs*                            overrided_shader_vs_ = nullptr;    //!< 上書きする頂点シェーダー
+    ShaderPs*                            overrided_shader_ps_ = nullptr;    //!< 上書きするピクセルシェーダー
+    std::vector<Model::TextureOverrides> frame_textures_;                   //!< フレームごとの上書きテクスチャ
+    Model::TextureOverrides              all_textures_{};                   //!< モデル全体の上書きテクスチャ (マテリアル番号-1)
+    Model::TextureOverrides              no_textures_{};                    //!< 上書きなし
+    bool                                 has_all_textures_     = false;     //!< モデル全体の上書きがあるか
+    bool                                 frame_textures_dirty_ = true;      //!< 上書きテクスチャの作り直しが必要
 
     //@}
 
@@ -277,6 +367,7 @@ class ComponentModel
     //---------------------------------------------------------------------------
     //@{
     matrix& Matrix() override {
+        local_version_ = WorldMatrixCache::NewVersion();
         return model_transform_;
     }    //!< マトリクス取得
 
@@ -296,12 +387,75 @@ class ComponentModel
     //! @return 他のコンポーネントも含めた位置
     virtual const matrix GetOldWorldMatrix() const override;
 
+    //! @brief ワールド行列のバージョン取得
+    //! @return ワールド行列が再計算されるたびに変わる値
+    u64 GetWorldVersion() const;
+
+    //! @brief ワールド行列を確定して1フレーム前の行列として保存する
+    //! @details シーンのPostUpdate後にまとめて呼ばれます (キャッシュへの保存はここでのみ行われます)
+    void ResolveWorldMatrix();
+
+    //@}
+
+    //---------------------------------------------------------------------------
+    //! @name 視錐台カリング
+    //---------------------------------------------------------------------------
+    //@{
+
+    //! @brief 描画するかを判定して今フレームの可視状態を設定する
+    //! @details シーンのDraw前にまとめて呼ばれます
+    //! @param frustum 判定するカメラの視錐台
+    //! @return 描画する場合は true
+    bool UpdateVisibility(const Frustum& frustum);
+
+    //! @brief 可視状態を解除する (カリングしない)
+    void ResetVisibility() {
+        culled_ = false;
+    }
+
+    //! @brief 今フレームはカリングされているか
+    bool IsCulled() const {
+        return culled_;
+    }
+
+    //! @brief 描画距離を設定
+    //! @param distance カメラからの距離 (0で無制限)
+    ComponentModelPtr SetCullDistance(f32 distance) {
+        cull_distance_ = distance;
+        return SharedThis();
+    }
+
+    //! @brief 描画距離を取得
+    f32 GetCullDistance() const {
+        return cull_distance_;
+    }
+
+    //! @brief ワールド空間の境界AABBを取得
+    //! @retval false モデルキャッシュが未作成で境界が分からない
+    bool GetWorldBounds(float3& aabb_min, float3& aabb_max);
+
     //@}
 
    private:
     //! モデル用のトランスフォーム
     matrix model_transform_ = matrix::scale(0.1f);
 
+    u64                      local_version_ = WorldMatrixCache::NewVersion();    //!< ローカル行列のバージョン
+    u64                      node_version_  = WorldMatrixCache::NewVersion();    //!< ノード行列のバージョン
+    mutable WorldMatrixCache world_cache_;                                       //!< ワールド行列キャッシュ
+
+    //! ワールド行列の計算 (キャッシュなし)
+    matrix calcWorldMatrix(const matrix& owner_world) const;
+
+    //! アタッチ先のノード行列のバージョン (アタッチしていなければ0)
+    u64 getAttachVersion() const;
+
+    float3 bounds_min_     = {0.0f, 0.0f, 0.0f};    //!< 境界AABBの最小座標 (ワールド空間)
+    float3 bounds_max_     = {0.0f, 0.0f, 0.0f};    //!< 境界AABBの最大座標 (ワールド空間)
+    u64    bounds_version_ = 0;                     //!< 境界AABBを計算したワールド行列のバージョン (0で未計算)
+    f32    cull_distance_  = 0.0f;                  //!< 描画距離 (0で無制限)
+    bool   culled_         = false;                 //!< 今フレームはカリングされている
+
     Status<ModelBit>       model_status_;       //!< 状態
     std::string            path_  = "";         //!< 読み込みモデル名
     std::unique_ptr<Model> model_ = nullptr;    //!< モデルクラス
@@ -315,14 +469,18 @@ class ComponentModel
 
     //! @brief アニメーション
     std::unique_ptr<Animation> animation_;
-    std::string                current_animation_name_;
-    std::string                old_animation_name_;
+    std::string                current_animation_name_;    //!< 再生中のアニメーション名 (保存/GUI用)
+    AnimId                     current_animation_id_;      //!< 再生中のアニメーションID
+    AnimId                     old_animation_id_;          //!< 前回再生したアニメーションID
 
     float animation_time_ = 0.0f;
     bool  anim_loop_      = false;    //!< アニメーションループ設定
 
     std::vector<Animation::Desc> animations_desc_;
 
+    Animation::EventCallback animation_event_callback_;    //!< アニメーションイベントの通知先
+    std::string              animation_events_path_;       //!< イベントトラックのファイル
+
     //--------------------------------------------------------------------
     //! @name アタッチ処理
     //--------------------------------------------------------------------
@@ -371,12 +529,22 @@ class ComponentModel
             }
         }
 
+        if(ver >= 3) {
+            arc(cereal::make_nvp("animation_events", animation_events_path_));
+        }
+
         arc(cereal::make_nvp("Component", cereal::base_class<Component>(this)));
 
         if(!path_.empty()) {
             Load(path_);
             if(!animations_desc_.empty()) {
                 SetAnimation(animations_desc_);
+
+                // イベントトラックはファイルのタイミングを優先
+                if constexpr(Archive::is_loading::value) {
+                    if(!animation_events_path_.empty())
+                        LoadAnimationEvents(animation_events_path_);
+                }
             }
         }
     }
@@ -393,5 +561,14 @@ CEREAL_SAVELOAD_OTHER(Animation::Desc, arc, other) {
     );
 }
 
+//! @brief 外部Animation::Eventのセーブロード
+CEREAL_SAVELOAD_OTHER(Animation::Event, arc, other) {
+    arc(CEREAL_NVP(other.type_),    //!< 種類
+        CEREAL_NVP(other.time_),    //!< 発生時間 (アニメーションのフレーム)
+        CEREAL_NVP(other.name_),    //!< 対象の名前
+        CEREAL_NVP(other.value_)    //!< 任意の値
+    );
+}
+
 CEREAL_REGISTER_TYPE(ComponentModel)
 CEREAL_REGISTER_POLYMORPHIC_RELATION(Component, ComponentModel)
@@ -413,13 +413,12 @@ int              debug_ref_count = 0;
 u16 ComponentPhysics::hit_status_[CollisionTypeSize] = {};
 
 ComponentPhysics::~ComponentPhysics() {
-#if 0
-	if( constraint_ )
-	{
-		physics::Engine::physicsSystem()->RemoveConstraint( constraint_ );
-		constraint_ = nullptr;
-	}
-#endif
+    // 剛体はプールに戻って別のオブジェクトで再利用されるため、拘束を残さないようにする
+    // (物理シミュレーションの終了後は何もしない)
+    if(constraint_ && physics::Engine::instance()) {
+        physics::Engine::physicsSystem()->RemoveConstraint(constraint_);
+        constraint_ = nullptr;
+    }
 }
 
 void ComponentPhysics::Init() {
@@ -481,7 +480,7 @@ void ComponentPhysics::PostPhysics() {
         return;
 
     // 回転を整える
-    matrix mat = matrix(body_->worldMatrix());
+    matrix mat = body_->worldMatrix();
 #if 0
 	// y軸固定
 	{
@@ -497,9 +496,15 @@ void ComponentPhysics::PostPhysics() {
 #endif
 
     // 物理位置からphysics分を差し引いたものをObject位置とする
-    //auto mat = mul( inverse( physics_transform_ ), body_->worldMatrix() );
-    mat = mul(inverse(physics_transform_), mat);
-    GetOwner()->SetMatrix(mat);
+    // ゲーム処理と次フレームのキネマティック移動はシミュレーション結果の姿勢を使う
+    matrix inv_physics = inverse(physics_transform_);
+    GetOwner()->SetMatrix(mul(inv_physics, mat));
+
+    // 固定ステップ時は前回ステップとの間を補間した姿勢を描画専用に設定する
+    // (ワールド行列はシミュレーション結果のまま。描画専用の行列は次のPreUpdateで解除されます)
+    auto engine = physics::Engine::instance();
+    if(engine->fixedDeltaTime() > 0.0f)
+        GetOwner()->SetDrawMatrix(mul(inv_physics, body_->interpolatedMatrix(engine->interpolationAlpha())));
 }
 
 void ComponentPhysics::Draw() {
@@ -620,6 +625,12 @@ void ComponentPhysics::GUI() {
             GetOwner()->RemoveComponent(shared_from_this());
         }
 
+        // 固定ステップの状態
+        if(auto engine = physics::Engine::instance()) {
+            ImGui::Text(u8"固定⊿t : %.4f  ステップ数 : %u  補間 : %.2f", engine->fixedDeltaTime(), engine->stepCount(),
+                        engine->interpolationAlpha());
+        }
+
         // 形状
         {
             int shape = -1;
@@ -886,8 +897,13 @@ void ComponentPhysics::GUI() {
 }
 
 void ComponentPhysics::MoveTo(const matrix& mat) {
+    // シミュレーションが進まないフレームでは速度を設定しない (0で割らない)
+    f32 dt = GetKinematicDeltaTime();
+    if(dt <= 0.0f)
+        return;
+
     if(auto body = GetRigidBody()) {
-        body->moveKinematic(mat.translate(), quaternion(float3x3(mat)), GetDeltaTime());
+        body->moveKinematic(mat.translate(), quaternion(float3x3(mat)), dt);
     }
 }
 
@@ -895,6 +911,18 @@ void ComponentPhysics::MoveToWorldMatrix() {
     MoveTo(GetWorldMatrix());
 }
 
+//---------------------------------------------------------------------------
+//! キネマティック移動に使う⊿tを取得
+//! @details 固定ステップ時は 固定⊿t×このフレームのステップ数 になるため、
+//!          ステップ数が変動しても目標位置で止まり、同じ入力なら同じ結果になります
+//---------------------------------------------------------------------------
+f32 ComponentPhysics::GetKinematicDeltaTime() {
+    auto engine = physics::Engine::instance();
+    if(!engine)
+        return 0.0f;
+    return engine->simulationTime(GetPhysicsDeltaTime());
+}
+
 void ComponentPhysics::LockRotateAxis(bool x, bool y, bool z) {
     if(constraint_)
         physics::Engine::physicsSystem()->RemoveConstraint(constraint_);
@@ -38,6 +38,10 @@ class ComponentPhysics final
     void MoveTo(const matrix& mat);
     void MoveToWorldMatrix();
 
+    //! @brief キネマティック移動に使う⊿tを取得
+    //! @return このフレームで物理シミュレーションが実際に進む時間 (0ならステップしない)
+    static f32 GetKinematicDeltaTime();
+
     // 回転軸のロック
     void LockRotateAxis(bool x, bool y, bool z);
     //------------------------------------------------------------------------
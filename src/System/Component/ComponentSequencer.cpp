@@ -15,7 +15,7 @@
 //! @brief フレーム情報からアニメーションを取得
 //! @param frame フレーム
 void SequenceObject::SetAnimationFromFrame(int frame) {
-    animation_name_  = "";
+    AnimId id{};
     animation_loop_  = false;
     animation_frame_ = 0;
     // 後ろからキーを取得して行く
@@ -26,17 +26,20 @@ void SequenceObject::SetAnimationFromFrame(int frame) {
             // キーから何フレーム進んでいるかを割り出す
             float past = static_cast<float>(frame - key);
 
-            // アニメーションが現在指定されているものと違う場合は
-            // 変化準備とする
-            if(animation_name_ != animation_values_[i].name_)
-                animation_change_ = true;
-
-            animation_name_  = animation_values_[i].name_;
+            id               = animation_values_[i].GetId();
             animation_frame_ = static_cast<int>(past);
             animation_loop_  = animation_values_[i].loop_;
             break;
         }
     }
+
+    // アニメーションが現在指定されているものと違う場合は
+    // 変化準備とする (毎フレーム名前をコピーしないようにIDで比較)
+    if(animation_id_ != id) {
+        animation_change_ = true;
+        animation_id_     = id;
+        animation_name_   = id.name();
+    }
 }
 
 //! @brief フレーム情報からエフェクトを取得
@@ -181,9 +184,9 @@ void SequenceObject::Update(bool playing, float frame) {
 
             // モデルを取得してアニメーションを設定する
             if(auto component = obj->GetComponent<ComponentModel>()) {
-                component->PlayAnimationNoSame(animation_name_, animation_loop_);
+                component->PlayAnimationNoSame(animation_id_, animation_loop_);
                 if(fabs(frame - animation_frame_old_) > 1.0f && !component->IsPlaying())
-                    component->PlayAnimation(animation_name_, false, 0.0f, animation_frame_old_ / 60.0f);
+                    component->PlayAnimation(animation_id_, false, 0.0f, animation_frame_old_ / 60.0f);
 
                 //component->Update( ( frame - animation_frame_old_ ) / 60.0f );
                 animation_frame_old_ = i_frame;
@@ -3,6 +3,7 @@
 #include <System/Component/Component.h>
 #include <System/Component/ComponentTransform.h>
 #include <System/Cereal.h>
+#include <System/Graphics/Animation.h>
 
 #include <im-neo-sequencer/imgui_neo_sequencer.h>
 
@@ -11,7 +12,20 @@ struct AnimObject {
     std::string name_;
     bool        loop_;
 
+    //! @brief アニメーションIDを取得
+    //! @details 名前から一度だけ解決し、名前が編集されるまで使いまわします
+    AnimId GetId() {
+        if(id_name_ != name_) {
+            id_      = AnimId(name_);
+            id_name_ = name_;
+        }
+        return id_;
+    }
+
    private:
+    AnimId      id_;         //!< 解決済みのアニメーションID
+    std::string id_name_;    //!< IDを解決した時の名前
+
     CEREAL_SAVELOAD(arc, ver) {
         arc(CEREAL_NVP(name_), CEREAL_NVP(loop_));
     }
@@ -114,6 +128,7 @@ class SequenceObject: public IMatrix<SequenceObject> {
     std::vector<AnimObject> animation_values_{};    //!< アニメーション値
 
     std::string animation_name_{};               //!< アニメーション名
+    AnimId      animation_id_{};                 //!< アニメーションID
     int         animation_frame_old_ = -1;       //!< 前のフレーム
     int         animation_frame_     = -1;       //!< 現在のフレーム
     bool        animation_loop_      = false;    //!< ループするかの設定
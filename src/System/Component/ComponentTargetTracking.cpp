@@ -48,8 +48,10 @@ void ComponentTargetTracking::Init() {
 //---------------------------------------------------------
 void ComponentTargetTracking::PreUpdate() {
     // 一旦リセットする
-    if(auto model = owner_model_.lock())
+    if(auto model = owner_model_.lock()) {
         MV1ResetFrameUserLocalMatrix(model->GetModel(), tracked_node_index_);
+        model->DirtyNodeMatrix();
+    }
 }
 
 void ComponentTargetTracking::PostUpdate() {
@@ -155,6 +157,7 @@ void ComponentTargetTracking::PostUpdate() {
         //mat = mul(mul(tracking_matrix_, rotx), roty);
 
         MV1SetFrameUserLocalMatrix(model->GetModel(), tracked_node_index_, cast(mat));
+        model->DirtyNodeMatrix();
 
         // これをONにすると他のGizmoのIsOverなどがチェックが取れずPICKが常に有効になる(地面が選ばれてしまう)
         //ShowGizmo( (float*)mat.f32_128_0, ImGuizmo::OPERATION::TRANSLATE, ImGuizmo::MODE::LOCAL, 0xab1245 );
@@ -115,14 +115,15 @@ void ComponentTransform::Init() {
 
 void ComponentTransform::PrePhysics() {
     // 移動可能な物体
-    if(auto cmp_physics = GetOwner()->GetComponent<ComponentPhysics>()) {
+    if(auto cmp_physics = GetOwner()->FindComponent<ComponentPhysics>()) {
         if(!cmp_physics->GetPhysicsStatus(ComponentPhysics::PhysicsBit::Static)) {
             auto       mx = cmp_physics->GetWorldMatrix();
             quaternion q((float3x3)mx);
             auto       trans = mx.translate();
-            auto       t     = GetDeltaTime();
+            auto       t     = ComponentPhysics::GetKinematicDeltaTime();
             auto       body  = cmp_physics->GetRigidBody();
-            if(body) {
+            // シミュレーションが進まないフレームでは速度を設定しない (0で割らない)
+            if(body && t > 0.0f) {
                 float3 v = {0, body->linearVelocity().y, 0};
                 if(v.y > 0)
                     v.y = 0;
@@ -155,8 +156,11 @@ void ComponentTransform::GUI() {
         if(world_transform_enable_)
             ptr = world_transform_.f32_128_0;
 
-        if(ShowGizmo(ptr, gizmo_operation_, gizmo_mode_, reinterpret_cast<uint64_t>(this)))
-            update = true;
+        if(ShowGizmo(ptr, gizmo_operation_, gizmo_mode_, reinterpret_cast<uint64_t>(this))) {
+            // 行列を直接書き換えたため、子のキャッシュが同じフレーム内で再計算されるようにする
+            world_version_ = WorldMatrixCache::NewVersion();
+            update         = true;
+        }
 
         // キーにより、Manipulateの処理を変更する
         // TODO : 一旦UE4に合わせておくが、のちにEditor.iniで設定できるようにする
@@ -232,7 +236,7 @@ void ComponentTransform::GUI() {
 
         if(update) {
             // 親が ComponentPhysics を持っている場合はそちらを変更する必要がある
-            if(auto cmp_physics = GetOwner()->GetComponent<ComponentPhysics>())
+            if(auto cmp_physics = GetOwner()->FindComponent<ComponentPhysics>())
                 cmp_physics->SetPhysicsMatrix(cmp_physics->GetWorldMatrix());
 
             PostUpdate();
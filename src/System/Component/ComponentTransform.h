@@ -5,6 +5,7 @@
 #pragma once
 
 #include <System/Component/Component.h>
+#include <System/WorldMatrixCache.h>
 #include <ImGuizmo/ImGuizmo.h>
 #include <memory>
 
@@ -444,7 +445,11 @@ class ComponentTransform
     virtual void Init() override;
 
     virtual void PreUpdate() override {
-        world_transform_enable_ = false;
+        if(world_transform_enable_) {
+            world_transform_enable_ = false;
+            world_version_          = WorldMatrixCache::NewVersion();
+        }
+        draw_transform_enable_ = false;
     }
 
     virtual void PrePhysics() override;
@@ -456,7 +461,9 @@ class ComponentTransform
     //---------------------------------------------------------------------------
     //@{
 
+    //! @attention 書き換え可能な参照を返すため、呼ぶたびにワールド行列のバージョンが進みます
     matrix& Matrix() override {
+        world_version_ = WorldMatrixCache::NewVersion();
         return transform_;
     }
 
@@ -487,6 +494,35 @@ class ComponentTransform
     void SetWorldMatrix(const matrix& mat) {
         world_transform_enable_ = true;
         world_transform_        = mat;
+        world_version_          = WorldMatrixCache::NewVersion();
+    }
+
+    //! @brief ワールド行列のバージョン取得
+    //! @details 位置が変更されるたびに変わるため、子のキャッシュ判定に使用します
+    u64 GetWorldVersion() const {
+        return world_version_;
+    }
+
+    //! @brief 描画用Matrixの取得
+    //! @return 描画専用の姿勢が設定されていなければワールドMatrix
+    const matrix GetDrawMatrix() const {
+        if(draw_transform_enable_)
+            return draw_transform_;
+
+        return GetWorldMatrix();
+    }
+
+    //! @brief 描画専用Matrixの設定
+    //! @details 物理の補間姿勢など見た目だけの姿勢に使用します。
+    //!          ワールド行列(ゲーム処理/コリジョン/1フレーム前の行列)には影響せず、次のPreUpdateで解除されます
+    void SetDrawMatrix(const matrix& mat) {
+        draw_transform_enable_ = true;
+        draw_transform_        = mat;
+    }
+
+    //! @brief 描画専用Matrixが設定されているか
+    bool HasDrawMatrix() const {
+        return draw_transform_enable_;
     }
 
     //@}
@@ -496,6 +532,9 @@ class ComponentTransform
     matrix old_transform_;                     //!< 1フレーム前の位置
     matrix world_transform_;                   //!< 最終ワールドマトリクス
     bool   world_transform_enable_ = false;    //!< 最終ワールドマトリクスが有効
+    matrix draw_transform_;                    //!< 描画専用マトリクス
+    bool   draw_transform_enable_  = false;    //!< 描画専用マトリクスが有効
+    u64    world_version_ = WorldMatrixCache::NewVersion();    //!< ワールド行列のバージョン
 
     bool                is_guizmo_       = false;                  //!< ギズモ使用
     ImGuizmo::OPERATION gizmo_operation_ = ImGuizmo::TRANSLATE;    //!< Gizmo処理選択
@@ -515,6 +554,7 @@ class ComponentTransform
             arc(cereal::make_nvp("world_transform_enable", world_transform_enable_));
             arc(cereal::make_nvp("world_transform", world_transform_));
         }
+        world_version_ = WorldMatrixCache::NewVersion();
     }
 
     //@}
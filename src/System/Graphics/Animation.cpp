@@ -4,13 +4,87 @@
 //---------------------------------------------------------------------------
 #include "Animation.h"
 
+#include <algorithm>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+
 namespace {
 
-//! アニメーションリソースプール
-std::unordered_map<std::string, std::shared_ptr<ResourceAnimation>> resource_pool;
+//! 登録済みのアニメーション名
+//! @note キーは names_ 内の文字列を参照するため検索で std::string を作りません
+struct NameTable {
+    std::mutex                                mutex_;    //!< 登録の排他
+    std::deque<std::string>                   names_;    //!< 名前 (IDの順 参照を保つためdeque)
+    std::unordered_map<std::string_view, u32> ids_;      //!< 名前からID
+};
+
+//! 他の静的変数の初期化から使われてもよいように関数内で作成
+NameTable& nameTable() {
+    static NameTable table;
+    return table;
+}
+
+Animation::Stats frame_stats;    //!< 集計中の統計情報
+Animation::Stats last_stats;     //!< 直前のフレームの統計情報
 
 }    // namespace
 
+//===========================================================================
+// アニメーションID AnimId
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//! コンストラクタ (未登録の名前は登録する)
+//---------------------------------------------------------------------------
+AnimId::AnimId(std::string_view name) {
+    if(name.empty())
+        return;
+
+    auto&                       table = nameTable();
+    std::lock_guard<std::mutex> lock(table.mutex_);
+
+    if(auto it = table.ids_.find(name); it != table.ids_.end()) {
+        id_ = it->second;
+        return;
+    }
+
+    id_ = static_cast<u32>(table.names_.size());
+    table.names_.emplace_back(name);
+    table.ids_.emplace(table.names_.back(), id_);
+}
+
+//---------------------------------------------------------------------------
+//! 登録済みの名前からIDを取得
+//---------------------------------------------------------------------------
+AnimId AnimId::find(std::string_view name) {
+    AnimId result;
+
+    auto&                       table = nameTable();
+    std::lock_guard<std::mutex> lock(table.mutex_);
+
+    if(auto it = table.ids_.find(name); it != table.ids_.end())
+        result.id_ = it->second;
+
+    return result;
+}
+
+//---------------------------------------------------------------------------
+//! アニメーション名を取得
+//---------------------------------------------------------------------------
+std::string_view AnimId::name() const {
+    if(!isValid())
+        return {};
+
+    auto&                       table = nameTable();
+    std::lock_guard<std::mutex> lock(table.mutex_);
+    return table.names_[id_];
+}
+
+//===========================================================================
+// アニメーション Animation
+//===========================================================================
+
 //---------------------------------------------------------------------------
 //! コントラクタ
 //---------------------------------------------------------------------------
@@ -53,23 +127,30 @@ bool Animation::load(const Animation::Desc* desc, size_t desc_count) {
         //------------------------------------------------------
         const std::string& resource_path = x.file_path_;
 
-        auto it = resource_pool.find(resource_path);
-        if(it == resource_pool.end()) {    // 新規登録
-            resource_pool[resource_path] = std::make_shared<ResourceAnimation>(resource_path);
-        }
-
-        // 共有
-        std::shared_ptr<ResourceAnimation>& resource = resource_pool[resource_path];
+        auto resource = AssetRegistry::acquire<ResourceAnimation>(AssetType::Animation, resource_path, [&resource_path]() {
+            return std::make_shared<ResourceAnimation>(resource_path);
+        });
 
         descs_.push_back(x);
         mv1_handles_.push_back(MV1DuplicateModel(*resource));
+        resources_.push_back(resource);
 
         if(resource->isValid() == false) {
             is_valid_ = false;    // 一度でもエラーの場合はfalse
         }
 
-        // 名前逆引きテーブルに登録
-        name_table_[desc[i].name_] = i;
+        // イベントトラックは時間順に並べておく
+        auto& events = descs_.back().events_;
+        std::stable_sort(events.begin(), events.end(), [](const Event& a, const Event& b) { return a.time_ < b.time_; });
+
+        // ID逆引きテーブルに登録
+        AnimId id(x.name_);
+        ids_.push_back(id);
+        if(id.isValid()) {
+            if(id.value() >= id_table_.size())
+                id_table_.resize(id.value() + 1, -1);
+            id_table_[id.value()] = static_cast<s32>(descs_.size() - 1);
+        }
     }
 
     return is_valid_;
@@ -81,76 +162,122 @@ bool Animation::load(const Animation::Desc* desc, size_t desc_count) {
 void Animation::update(f32 dt) {
     assert(model_ && "アニメーションにモデルが設定されていません");
 
-    // 再生していない場合
-    if(isPlaying() == false)
-        return;
-
     // ポーズ中の場合
     if(is_paused_)
         return;
 
-    //----------------------------------------------------------
-    // アニメーションを進める
-    //----------------------------------------------------------
-    float blend_ratio_total = 0.0f;
-    for(u32 i = 0; i < std::size(contexts_); ++i) {
-        auto& c = contexts_[i];
+    LONGLONG start_time = GetNowHiPerformanceCount();
 
-        if(c.animation_index_ == -1)
-            continue;
+    for(auto& layer: layers_) {
+        auto& contexts = layer.contexts_;
 
-        auto& desc = descs_[c.animation_index_];
+        // 再生していないレイヤーは何もしない
+        if(contexts.empty())
+            continue;
 
-        // アニメーション再生時間を進める
-        c.play_time_ += dt * 30.0f * desc.animation_speed_;
+        const size_t current    = contexts.size() - 1;
+        const f32    blend_step = dt / layer.blend_time_;
 
-        if(c.is_loop_) {
-            // アニメーション再生時間がアニメーションの総時間を越えていたらループさせる
-            if(c.animation_total_time_ <= c.play_time_) {
-                c.play_time_ -= c.animation_total_time_;
+        //----------------------------------------------------------
+        // アニメーションを進める
+        //----------------------------------------------------------
+        for(size_t i = 0; i < contexts.size(); ++i) {
+            auto& c = contexts[i];
+
+            // 再生が終わったものは最後の姿勢のまま (時間の設定も不要)
+            if(c.is_playing_) {
+                auto& desc = descs_[c.animation_index_];
+
+                // イベントは現在のアニメーションのみ通知 (フェードアウト中のものは通知しない)
+                const bool has_events = event_callback_ && !desc.events_.empty() && i == current && !layer.stopping_;
+
+                // 再生開始直後は開始時間ちょうどのイベントも通知する
+                f32  event_from   = c.play_time_;
+                bool include_from = !c.is_started_;
+                c.is_started_     = true;
+
+                // アニメーション再生時間を進める
+                c.play_time_ += dt * 30.0f * desc.animation_speed_;
+
+                if(c.is_loop_) {
+                    // アニメーション再生時間がアニメーションの総時間を越えていたらループさせる
+                    // dtが大きく複数周した場合も周ごとにイベントを通知する
+                    while(c.animation_total_time_ > 0.0f && c.animation_total_time_ <= c.play_time_) {
+                        if(has_events)
+                            collectEvents(c, event_from, c.animation_total_time_, include_from);
+
+                        c.play_time_ -= c.animation_total_time_;
+                        event_from   = 0.0f;
+                        include_from = true;
+                    }
+                } else {
+                    // アニメーション再生時間がアニメーションの総時間を越えていたら停止
+                    if(c.animation_total_time_ <= c.play_time_) {
+                        c.play_time_  = c.animation_total_time_;
+                        c.is_playing_ = false;
+                    }
+                }
+
+                if(has_events)
+                    collectEvents(c, event_from, c.play_time_, include_from);
+
+                // 新しいアニメーション再生時間をセット
+                DxLib::MV1SetAttachAnimTime(model_handle_, c.animation_attach_index_, c.play_time_);
+                frame_stats.updated_clips_++;
             }
-        } else {
-            // アニメーション再生時間がアニメーションの総時間を越えていたら停止
-            if(c.animation_total_time_ <= c.play_time_) {
-                c.play_time_  = c.animation_total_time_;
-                c.is_playing_ = false;
+
+            //----------------------------------------------------------
+            // ブレンドを進める (変化したときだけモデルに設定しなおす)
+            //----------------------------------------------------------
+            const f32 target = (i == current && !layer.stopping_) ? 1.0f : 0.0f;
+            if(c.blend_ratio_ != target) {
+                c.blend_ratio_ += (target > c.blend_ratio_) ? blend_step : -blend_step;
+                c.blend_ratio_ = std::clamp(c.blend_ratio_, 0.0f, 1.0f);
+                blend_dirty_   = true;
             }
         }
 
-        // 新しいアニメーション再生時間をセット
-        DxLib::MV1SetAttachAnimTime(model_handle_, c.animation_attach_index_, c.play_time_);
-
         //----------------------------------------------------------
-        // アニメーションブレンド
+        // 補間完了後は補間元のアニメーションを解除
         //----------------------------------------------------------
+        for(size_t i = contexts.size(); i-- > 0;) {
+            auto& c = contexts[i];
+            if(i == current && !layer.stopping_)
+                continue;
 
-        // ブレンドを進める
-        c.blend_ratio_ += ((1.0f / blend_time_) * dt) * ((i == 0) ? +1.0f : -1.0f);
-        c.blend_ratio_ = std::clamp(c.blend_ratio_, 0.0f, 1.0f);
-
-        blend_ratio_total += c.blend_ratio_;
+            if(c.blend_ratio_ == 0.0f) {    // float値の==判定は0.0fのみ正確に判定できる
+                detachAnimation(c);
+                contexts.erase(contexts.begin() + i);
+                blend_dirty_ = true;
+            }
+        }
+        if(contexts.empty())
+            layer.stopping_ = false;
     }
 
     //----------------------------------------------------------
     // アニメーションブレンド
     //----------------------------------------------------------
-    blend_ratio_total = std::max(FLT_EPSILON, blend_ratio_total);
+    if(blend_dirty_)
+        applyBlendRates();
 
-    for(u32 i = 0; i < std::size(contexts_); ++i) {
-        auto& c = contexts_[i];
-
-        float ratio = c.blend_ratio_;
-
-        DxLib::MV1SetAttachAnimBlendRate(model_handle_, c.animation_attach_index_, ratio / blend_ratio_total);
-
-        // 補間完了後は補間元のアニメーションを停止
-        if(i > 0) {
-            if(c.blend_ratio_ == 0.0f) {    // float値の==判定は0.0fのみ正確に判定できる
-                detachAnimation(i);
-                c.is_playing_ = false;
-            }
+    //----------------------------------------------------------
+    // イベント通知
+    // 通知先で再生を切り替えてもよいように更新が終わってからまとめて通知
+    //----------------------------------------------------------
+    if(!fired_events_.empty()) {
+        auto events = std::move(fired_events_);
+        fired_events_.clear();
+
+        frame_stats.event_count_ += static_cast<u32>(events.size());
+        for(auto& [animation_index, event]: events) {
+            if(event_callback_)
+                event_callback_(ids_[animation_index], event);
         }
     }
+
+    // 通知先の処理時間も含む
+    frame_stats.update_time_ += (float)(GetNowHiPerformanceCount() - start_time) / 1000.0f;
 }
 
 //---------------------------------------------------------------------------
@@ -164,9 +291,7 @@ void Animation::bindModel(Model* model) {
     auto* last = model_;
     if(last) {
         // [DxLib]モデルとアニメーションの関連付けを解除
-        for(u32 i = 0; i < CONTEXT_COUNT; ++i) {
-            detachAnimation(i);
-        }
+        detachAll();
 
         model_        = nullptr;
         model_handle_ = -1;
@@ -186,62 +311,133 @@ void Animation::bindModel(Model* model) {
 //! アニメーションを再生する
 //---------------------------------------------------------------------------
 bool Animation::play(std::string_view name, bool is_loop, f32 blend_time, f32 start_time) {
+    // 登録されていない名前は見つからない
+    return play(AnimId::find(name), is_loop, blend_time, start_time);
+}
+
+//---------------------------------------------------------------------------
+//! アニメーションを再生する (ID指定)
+//---------------------------------------------------------------------------
+bool Animation::play(AnimId id, bool is_loop, f32 blend_time, f32 start_time) {
+    return playLayer(0, id, is_loop, blend_time, start_time);
+}
+
+//---------------------------------------------------------------------------
+//! レイヤーでアニメーションを再生する
+//---------------------------------------------------------------------------
+bool Animation::playLayer(u32 layer_index, AnimId id, bool is_loop, f32 blend_time, f32 start_time) {
+    // IDからアニメーションを検索
+    // 見つからない場合は再生中のアニメーションをそのまま残す
+    if(layer_index >= layers_.size())
+        return false;
+    if(!id.isValid() || id.value() >= id_table_.size() || id_table_[id.value()] < 0) {
+        return false;
+    }
+    s32 animation_index = id_table_[id.value()];
+
+    auto& layer    = layers_[layer_index];
+    auto& contexts = layer.contexts_;
+
     // ブレンドの速度
-    blend_time_ = std::max(FLT_EPSILON, blend_time);    // 0.0fにならないように
+    layer.blend_time_ = std::max(FLT_EPSILON, blend_time);    // 0.0fにならないように
+    layer.stopping_   = false;
 
     //----------------------------------------------------------
-    // [DxLib] 設定されているアニメーションを一旦解除
+    // 補間元はアタッチしたまま残し、新しいアニメーションだけを追加する
+    // 末尾 = 現在のアニメーション
+    // それ以前 = 以前のアニメーション (フェードアウト中)
     //----------------------------------------------------------
-    for(u32 i = 0; i < CONTEXT_COUNT; ++i) {
-        detachAnimation(i);
-    }
-
-    // 補間のために現在のアニメーションを補間前として設定
-    // [0] = 現在のアニメーション
-    // [1以降] = 以前のアニメーション
-    for(s32 i = CONTEXT_COUNT - 2; i >= 0; --i) {
-        contexts_[i + 1] = contexts_[i];
+    if(contexts.size() >= CONTEXT_COUNT) {
+        // 一番古いものから解除
+        detachAnimation(contexts.front());
+        contexts.erase(contexts.begin());
     }
 
     //----------------------------------------------------------
     // 新規再生
     //----------------------------------------------------------
-    {
-        // 名前からアニメーションを検索
-        std::string name_string(name);
-        auto        it = name_table_.find(name_string);
+    Context c;
+    c.animation_index_ = animation_index;
+    c.play_time_       = start_time;    // 開始位置は start_time から
+    c.is_playing_      = true;
+    c.is_loop_         = is_loop;
+    // 基本レイヤーで補間元が無い場合はすぐに表示 (1フレームだけT-poseになる現象を回避)
+    c.blend_ratio_ = (layer_index == 0 && contexts.empty()) ? 1.0f : 0.0f;
+
+    if(!attachAnimation(c))
+        return false;
+    contexts.push_back(c);
 
-        if(it == name_table_.end()) {
-            return false;    // 見つからなかった場合
-        }
+    // ポーズ解除
+    is_paused_ = false;
 
-        auto& c = contexts_[0];
+    // 追加したアニメーションのブレンド率を設定(時間は進めない)
+    applyBlendRates();
 
-        // アニメーション番号
-        c.animation_index_ = it->second;
-        // 現在の時間
-        c.play_time_       = start_time;    // 開始位置は start_time から
+    return true;
+}
 
-        c.is_playing_  = true;
-        c.is_loop_     = is_loop;
-        c.blend_ratio_ = 0.0f;
-    }
+//---------------------------------------------------------------------------
+//! レイヤーのアニメーションをフェードアウトして停止する
+//---------------------------------------------------------------------------
+void Animation::stopLayer(u32 layer_index, f32 blend_time) {
+    // 基本レイヤーは停止しない (姿勢が無くなるため)
+    if(layer_index == 0 || layer_index >= layers_.size())
+        return;
 
-    //----------------------------------------------------------
-    // アニメーション再生を設定
-    //----------------------------------------------------------
-    for(u32 i = 0; i < CONTEXT_COUNT; ++i) {
-        attachAnimation(i);
+    auto& layer = layers_[layer_index];
+    if(layer.contexts_.empty())
+        return;
+
+    layer.blend_time_ = std::max(FLT_EPSILON, blend_time);
+    layer.stopping_   = true;
+}
+
+//---------------------------------------------------------------------------
+//! レイヤー数を設定
+//---------------------------------------------------------------------------
+void Animation::setLayerCount(u32 count) {
+    count = std::max(count, 1u);
+
+    // 減らしたレイヤーのアニメーションを解除
+    for(u32 i = count; i < layers_.size(); ++i) {
+        for(auto& c: layers_[i].contexts_)
+            detachAnimation(c);
     }
 
-    // ポーズ解除
-    is_paused_ = false;
+    layers_.resize(count);
+    blend_dirty_ = true;
+}
 
-    // 強制的に再更新(時間は進めない)
-    // これを実行することで1フレームだけ不定値になってT-poseになる現象を回避
-    update(0.0f);
+//---------------------------------------------------------------------------
+//! レイヤーの適用範囲を設定
+//---------------------------------------------------------------------------
+void Animation::setLayerMask(u32 layer_index, s32 frame_index, f32 weight) {
+    if(layer_index == 0 || layer_index >= layers_.size())
+        return;
 
-    return true;
+    auto& layer       = layers_[layer_index];
+    layer.mask_frame_ = frame_index;
+    layer.weight_     = std::clamp(weight, 0.0f, 1.0f);
+    blend_dirty_      = true;
+}
+
+//---------------------------------------------------------------------------
+//! イベントの通知先を設定する
+//---------------------------------------------------------------------------
+void Animation::setEventCallback(EventCallback callback) {
+    event_callback_ = std::move(callback);
+}
+
+//---------------------------------------------------------------------------
+//! アニメーションのイベントトラックを設定する
+//---------------------------------------------------------------------------
+void Animation::setEvents(AnimId id, std::vector<Event> events) {
+    if(!id.isValid() || id.value() >= id_table_.size() || id_table_[id.value()] < 0)
+        return;
+
+    std::stable_sort(events.begin(), events.end(), [](const Event& a, const Event& b) { return a.time_ < b.time_; });
+    descs_[id_table_[id.value()]].events_ = std::move(events);
 }
 
 //---------------------------------------------------------------------------
@@ -255,7 +451,65 @@ void Animation::pause(bool active) {
 //!  再生中かどうかを取得
 //---------------------------------------------------------------------------
 bool Animation::isPlaying() const {
-    return contexts_[0].is_playing_;
+    auto* c = currentContext();
+    return c && c->is_playing_;
+}
+
+//---------------------------------------------------------------------------
+//!  指定のアニメーションを再生中かどうかを取得 (いずれかのレイヤー)
+//---------------------------------------------------------------------------
+bool Animation::isPlaying(AnimId id) const {
+    if(!id.isValid())
+        return false;
+
+    for(u32 i = 0; i < layers_.size(); ++i) {
+        if(playingId(i) == id)
+            return true;
+    }
+    return false;
+}
+
+//---------------------------------------------------------------------------
+//!  再生中のアニメーションIDを取得
+//---------------------------------------------------------------------------
+AnimId Animation::playingId(u32 layer) const {
+    auto* c = currentContext(layer);
+    if(!c || !c->is_playing_ || c->animation_index_ >= static_cast<s32>(ids_.size()))
+        return {};
+
+    return ids_[c->animation_index_];
+}
+
+//---------------------------------------------------------------------------
+//!  レイヤー数を取得
+//---------------------------------------------------------------------------
+u32 Animation::layerCount() const {
+    return static_cast<u32>(layers_.size());
+}
+
+//---------------------------------------------------------------------------
+//!  アタッチ中のアニメーション数を取得
+//---------------------------------------------------------------------------
+u32 Animation::activeClipCount() const {
+    size_t count = 0;
+    for(auto& layer: layers_)
+        count += layer.contexts_.size();
+    return static_cast<u32>(count);
+}
+
+//---------------------------------------------------------------------------
+//!  統計情報を取得
+//---------------------------------------------------------------------------
+Animation::Stats Animation::stats() {
+    return last_stats;
+}
+
+//---------------------------------------------------------------------------
+//!  統計情報のフレームを区切る
+//---------------------------------------------------------------------------
+void Animation::finishFrame() {
+    last_stats  = frame_stats;
+    frame_stats = {};
 }
 
 //---------------------------------------------------------------------------
@@ -284,27 +538,29 @@ bool Animation::isActive() const {
 //! アニメーションの再生フレームを取得
 //---------------------------------------------------------------------------
 float          Animation::GetAnimationPlayTime() const {
-    return contexts_[0].play_time_;
+    auto* c = currentContext();
+    return c ? c->play_time_ : 0.0f;
 }
 
 //---------------------------------------------------------------------------
 //! アニメーションの総フレームを取得
 //---------------------------------------------------------------------------
 float Animation::GetAnimationTotalTime() const {
-    return contexts_[0].animation_total_time_;
+    auto* c = currentContext();
+    return c ? c->animation_total_time_ : 0.0f;
 }
 
 float Animation::GetAnimationSpeed() const {
-    if(contexts_) {
-        auto& desc = descs_[contexts_[0].animation_index_];
+    if(auto* c = currentContext()) {
+        auto& desc = descs_[c->animation_index_];
         return desc.animation_speed_;
     }
     return 1.0f;
 }
 
 void Animation::SetAnimationSpeed(float speed) {
-    if(contexts_) {
-        auto& desc            = descs_[contexts_[0].animation_index_];
+    if(auto* c = currentContext()) {
+        auto& desc            = descs_[c->animation_index_];
         desc.animation_speed_ = speed;
     }
 }
@@ -313,9 +569,7 @@ void Animation::SetAnimationSpeed(float speed) {
 //---------------------------------------------------------------------------
 //! アニメーションを割り当て
 //---------------------------------------------------------------------------
-bool Animation::attachAnimation(s32 context_index) {
-    auto& c = contexts_[context_index];
-
+bool Animation::attachAnimation(Context& c) {
     if(c.animation_index_ == -1)
         return false;
 
@@ -326,6 +580,9 @@ bool Animation::attachAnimation(s32 context_index) {
     auto mv1_handle      = mv1_handles_[c.animation_index_];    // [DxLib] アニメーションのMV1
 
     c.animation_attach_index_ = DxLib::MV1AttachAnim(model_handle_, animation_index, mv1_handle, true);
+    if(c.animation_attach_index_ == -1)
+        return false;
+    frame_stats.attach_count_++;
 
     // アニメーション総再生時間を取得
     c.animation_total_time_ = DxLib::MV1GetAttachAnimTotalTime(model_handle_, c.animation_attach_index_);
@@ -339,9 +596,143 @@ bool Animation::attachAnimation(s32 context_index) {
 //---------------------------------------------------------------------------
 //! アニメーション割り当てを解除
 //---------------------------------------------------------------------------
-void Animation::detachAnimation(s32 context_index) {
-    DxLib::MV1DetachAnim(model_handle_, contexts_[context_index].animation_attach_index_);
-    contexts_[context_index].animation_attach_index_ = -1;
+void Animation::detachAnimation(Context& c) {
+    if(c.animation_attach_index_ == -1)
+        return;
+
+    DxLib::MV1DetachAnim(model_handle_, c.animation_attach_index_);
+    c.animation_attach_index_ = -1;
+    frame_stats.detach_count_++;
+}
+
+//---------------------------------------------------------------------------
+//! すべてのアニメーション割り当てを解除
+//---------------------------------------------------------------------------
+void Animation::detachAll() {
+    for(auto& layer: layers_) {
+        for(auto& c: layer.contexts_)
+            detachAnimation(c);
+        layer.contexts_.clear();
+        layer.stopping_ = false;
+    }
+}
+
+//---------------------------------------------------------------------------
+//! ブレンド率をモデルに設定
+//! 上位レイヤーは適用範囲 (mask_frame_ 以下のフレーム) で下位レイヤーを上書きします。
+//! 部分レイヤー同士が重なる場合は、後のレイヤーの範囲の設定が優先されます
+//---------------------------------------------------------------------------
+void Animation::applyBlendRates() {
+    blend_dirty_ = false;
+    frame_stats.blend_updates_++;
+
+    // レイヤーごとの合計と上書きの割合
+    for(u32 k = 0; k < layers_.size(); ++k) {
+        auto& layer = layers_[k];
+
+        f32 total = 0.0f;
+        for(auto& c: layer.contexts_)
+            total += c.blend_ratio_;
+
+        layer.coverage_ = (k == 0) ? 1.0f : layer.weight_ * std::min(total, 1.0f);
+    }
+
+    for(u32 j = 0; j < layers_.size(); ++j) {
+        auto& layer = layers_[j];
+        if(layer.contexts_.empty())
+            continue;
+
+        f32 total = 0.0f;
+        for(auto& c: layer.contexts_)
+            total += c.blend_ratio_;
+
+        // 全身を上書きする上位レイヤーの分だけ弱める
+        f32 whole_rate = 1.0f;
+        for(u32 k = j + 1; k < layers_.size(); ++k) {
+            if(layers_[k].mask_frame_ < 0)
+                whole_rate *= 1.0f - layers_[k].coverage_;
+        }
+
+        for(auto& c: layer.contexts_) {
+            // 基本レイヤーはブレンド比の合計で正規化、上位レイヤーはフェード分を残す
+            f32 rate;
+            if(j == 0)
+                rate = (total > 0.0f) ? c.blend_ratio_ / total : 1.0f / layer.contexts_.size();
+            else
+                rate = c.blend_ratio_ / std::max(total, 1.0f) * layer.weight_;
+
+            // 自分のレイヤーの適用範囲
+            if(layer.mask_frame_ < 0) {
+                DxLib::MV1SetAttachAnimBlendRate(model_handle_, c.animation_attach_index_, rate * whole_rate);
+            } else {
+                DxLib::MV1SetAttachAnimBlendRate(model_handle_, c.animation_attach_index_, 0.0f);
+                DxLib::MV1SetAttachAnimBlendRateToFrame(model_handle_,
+                                                        c.animation_attach_index_,
+                                                        layer.mask_frame_,
+                                                        rate * whole_rate,
+                                                        TRUE);
+            }
+
+            // 部分的に上書きする上位レイヤーの範囲を弱める
+            for(u32 k = j + 1; k < layers_.size(); ++k) {
+                const auto& upper = layers_[k];
+                if(upper.mask_frame_ < 0 || upper.coverage_ <= 0.0f)
+                    continue;
+
+                // 自分の適用範囲と重なる部分のみ
+                s32 frame = -1;
+                if(layer.mask_frame_ < 0 || isChildFrame(upper.mask_frame_, layer.mask_frame_))
+                    frame = upper.mask_frame_;
+                else if(isChildFrame(layer.mask_frame_, upper.mask_frame_))
+                    frame = layer.mask_frame_;
+                if(frame < 0)
+                    continue;
+
+                DxLib::MV1SetAttachAnimBlendRateToFrame(model_handle_,
+                                                        c.animation_attach_index_,
+                                                        frame,
+                                                        rate * whole_rate * (1.0f - upper.coverage_),
+                                                        TRUE);
+            }
+        }
+    }
+}
+
+//---------------------------------------------------------------------------
+//! 通過したイベントを通知待ちに積む
+//---------------------------------------------------------------------------
+void Animation::collectEvents(const Context& c, f32 from, f32 to, bool include_from) {
+    // 時間順に並んでいるので区間を越えたら終了
+    for(auto& event: descs_[c.animation_index_].events_) {
+        if(event.time_ > to)
+            break;
+
+        if(event.time_ > from || (include_from && event.time_ == from))
+            fired_events_.emplace_back(c.animation_index_, event);
+    }
+}
+
+//---------------------------------------------------------------------------
+//! レイヤーの現在のアニメーションを取得
+//---------------------------------------------------------------------------
+const Animation::Context* Animation::currentContext(u32 layer) const {
+    if(layer >= layers_.size() || layers_[layer].contexts_.empty())
+        return nullptr;
+
+    return &layers_[layer].contexts_.back();
+}
+
+//---------------------------------------------------------------------------
+//! フレームが指定フレームの子孫かどうか (同じフレームも含む)
+//---------------------------------------------------------------------------
+bool Animation::isChildFrame(s32 frame_index, s32 root_index) const {
+    // [DxLib] 親が無い場合は -2 エラーの場合は -1
+    while(frame_index >= 0) {
+        if(frame_index == root_index)
+            return true;
+        frame_index = DxLib::MV1GetFrameParent(model_handle_, frame_index);
+    }
+    return false;
 }
 
 //===========================================================================
@@ -360,8 +751,11 @@ ResourceAnimation::ResourceAnimation(std::string_view path) {
     // パスの保存
     path_ = convertTo(resource_path);
 
-    // アニメーションが含まれるモデルデータを読み込み
-    mv1_handle_ = DxLib::MV1LoadModel(resource_path.c_str());
+    // 使用メモリ量の目安としてファイルサイズを保存
+    std::error_code ec;
+    file_bytes_ = std::filesystem::file_size(resource_path, ec);
+    if(ec)
+        file_bytes_ = 0;
 
     // ハンドルの非同期読み込み処理が完了したら呼ばれる関数
     auto finish_callback = []([[maybe_unused]] int mv1_handle, void* data) {
@@ -413,3 +807,18 @@ bool ResourceAnimation::isActive() const {
 ResourceAnimation::operator int() const {
     return mv1_handle_;
 }
+
+//---------------------------------------------------------------------------
+//! 使用メモリ量を取得
+//---------------------------------------------------------------------------
+u64 ResourceAnimation::residentBytes() const {
+    return file_bytes_;
+}
+
+//---------------------------------------------------------------------------
+//! 読み込み中かどうか
+//---------------------------------------------------------------------------
+bool ResourceAnimation::isBusy() const {
+    // 非同期読み込みに失敗したものは読み込み中として扱わない
+    return mv1_handle_ != -1 && !active_ && CheckHandleASyncLoad(mv1_handle_) != -1;
+}
@@ -4,21 +4,111 @@
 //---------------------------------------------------------------------------
 #pragma once
 
+#include <System/AssetRegistry.h>
+
+#include <functional>
+
 class ResourceAnimation;
 
+//===========================================================================
+//! @brief アニメーションID (インターン済みのアニメーション名)
+//! @details 同じ名前は常に同じ番号になるため、文字列を作らずに比較や検索ができます。
+//!          名前の登録は Animation::load() で行われます
+//===========================================================================
+class AnimId {
+   public:
+    static constexpr u32 INVALID = ~0u;    //!< 無効なID
+
+    //! デフォルトコンストラクタ (無効なID)
+    AnimId() = default;
+
+    //  コンストラクタ (未登録の名前は登録する)
+    //! @param  [in]    name    アニメーション名 (空文字列は無効なID)
+    explicit AnimId(std::string_view name);
+
+    //  登録済みの名前からIDを取得
+    //! @param  [in]    name    アニメーション名
+    //! @return 登録されていない場合は無効なID
+    static AnimId find(std::string_view name);
+
+    //! 番号を取得
+    u32 value() const {
+        return id_;
+    }
+
+    //! 有効なIDかどうか
+    bool isValid() const {
+        return id_ != INVALID;
+    }
+
+    //  アニメーション名を取得
+    //! @note   登録された名前は解放されないため参照し続けることができます
+    std::string_view name() const;
+
+    bool operator==(const AnimId& other) const = default;
+
+   private:
+    u32 id_ = INVALID;    //!< 番号
+};
+
+namespace std {
+//! AnimId をハッシュのキーに使用するため
+template<>
+struct hash<AnimId> {
+    size_t operator()(const AnimId& id) const noexcept {
+        return id.value();
+    }
+};
+}    // namespace std
+
 //===========================================================================
 //! アニメーションクラス
 //===========================================================================
 class Animation final {
    public:
+    //! アニメーションイベント (再生時間が指定時間を通過したときに通知)
+    struct Event {
+        //! イベントの種類
+        enum class Type : u32 {
+            Notify,          //!< 汎用の通知
+            CollisionOn,     //!< コリジョン有効
+            CollisionOff,    //!< コリジョン無効
+            Sound,           //!< サウンド再生
+            Effect,          //!< エフェクト再生
+        };
+
+        Type        type_  = Type::Notify;    //!< 種類
+        f32         time_  = 0.0f;            //!< 発生時間 (アニメーションのフレーム)
+        std::string name_;                    //!< 対象の名前 (コリジョン名/サウンド名など)
+        f32         value_ = 0.0f;            //!< 任意の値 (エフェクトの角度など)
+    };
+
+    //! イベント通知先
+    //! @param  [in]    id      イベントが発生したアニメーション
+    //! @param  [in]    event   イベント
+    using EventCallback = std::function<void(AnimId id, const Event& event)>;
+
     //! アニメーション定義オプション
     struct Desc {
-        std::string name_;                      //!< アニメーション名(任意)
-        std::string file_path_;                 //!< ファイルパス
-        u32         animation_index_ = 0;       //!< ファイル内のアニメーション番号
-        f32         animation_speed_ = 1.0f;    //!< アニメーションの再生速度(default:1.0f)
+        std::string        name_;                      //!< アニメーション名(任意)
+        std::string        file_path_;                 //!< ファイルパス
+        u32                animation_index_ = 0;       //!< ファイル内のアニメーション番号
+        f32                animation_speed_ = 1.0f;    //!< アニメーションの再生速度(default:1.0f)
+        std::vector<Event> events_;                    //!< イベントトラック
     };
 
+    //! 統計情報 (1フレーム分)
+    struct Stats {
+        u32 updated_clips_ = 0;       //!< 再生時間を更新したアニメーション数
+        u32 blend_updates_ = 0;       //!< ブレンド率を設定しなおしたモデル数
+        u32 attach_count_  = 0;       //!< [DxLib] アタッチ回数
+        u32 detach_count_  = 0;       //!< [DxLib] アタッチ解除回数
+        u32 event_count_   = 0;       //!< 通知したイベント数
+        f32 update_time_   = 0.0f;    //!< update() の処理時間の合計 (単位:ms)
+    };
+
+    static constexpr u32 CONTEXT_COUNT = 4;    //!< レイヤーごとに同時にブレンドできるアニメーション数
+
     //----------------------------------------------------------
     //! @name   初期化
     //----------------------------------------------------------
@@ -71,6 +161,49 @@ class Animation final {
     //! @retval false   失敗(nameで指定した名前が見つからなかった場合)
     bool play(std::string_view name, bool is_loop = false, f32 blend_time = 1.0f, f32 start_time = 0.0f);
 
+    //  アニメーションを再生する
+    //! @param  [in]    id          アニメーションID
+    //! @param  [in]    is_loop     ループ再生するかどうか(default:false)
+    //! @param  [in]    blend_time  ブレンドする時間 (default:1.0秒)
+    //! @param  [in]    start_time  再生開始時間(default:0.0f)
+    //! @retval true    成功(正常終了)
+    //! @retval false   失敗(idのアニメーションが登録されていない場合)
+    bool play(AnimId id, bool is_loop = false, f32 blend_time = 1.0f, f32 start_time = 0.0f);
+
+    //  レイヤーでアニメーションを再生する
+    //! @param  [in]    layer       レイヤー番号 (0が全身の基本レイヤー)
+    //! @param  [in]    id          アニメーションID
+    //! @param  [in]    is_loop     ループ再生するかどうか
+    //! @param  [in]    blend_time  ブレンドする時間
+    //! @param  [in]    start_time  再生開始時間
+    //! @retval false   失敗(レイヤーが無いかidのアニメーションが登録されていない場合)
+    bool playLayer(u32 layer, AnimId id, bool is_loop = false, f32 blend_time = 1.0f, f32 start_time = 0.0f);
+
+    //  レイヤーのアニメーションをフェードアウトして停止する
+    //! @param  [in]    layer       レイヤー番号 (1以上)
+    //! @param  [in]    blend_time  フェードアウトする時間
+    void stopLayer(u32 layer, f32 blend_time = 0.2f);
+
+    //  レイヤー数を設定
+    //! @param  [in]    count   レイヤー数 (1以上 減らしたレイヤーのアニメーションは解除)
+    void setLayerCount(u32 count);
+
+    //  レイヤーの適用範囲を設定 (部分レイヤー)
+    //! @param  [in]    layer           レイヤー番号 (1以上)
+    //! @param  [in]    frame_index     適用するフレーム番号 (子フレームも含む -1で全身)
+    //! @param  [in]    weight          下位レイヤーを上書きする割合 (0.0f～1.0f)
+    void setLayerMask(u32 layer, s32 frame_index, f32 weight = 1.0f);
+
+    //  イベントの通知先を設定する
+    //! @param  [in]    callback    通知先 (nullptrで解除)
+    //! @note   通知は update() の最後にまとめて行うため、通知先から play() を呼んでもかまいません
+    void setEventCallback(EventCallback callback);
+
+    //  アニメーションのイベントトラックを設定する
+    //! @param  [in]    id      アニメーションID
+    //! @param  [in]    events  イベントトラック (時間順でなくてもよい)
+    void setEvents(AnimId id, std::vector<Event> events);
+
     // アニメーションを一時停止する
     //! @param  [in]    active  停止フラグ(true:停止 false:再開)
     void pause(bool active = true);
@@ -84,6 +217,27 @@ class Animation final {
     //  再生中かどうかを取得
     bool isPlaying() const;
 
+    //  指定のアニメーションを再生中かどうかを取得
+    //! @param  [in]    id  アニメーションID
+    bool isPlaying(AnimId id) const;
+
+    //  再生中のアニメーションIDを取得
+    //! @param  [in]    layer   レイヤー番号
+    //! @return 再生していない場合は無効なID
+    AnimId playingId(u32 layer = 0) const;
+
+    //  レイヤー数を取得
+    u32 layerCount() const;
+
+    //  アタッチ中のアニメーション数を取得 (フェードアウト中も含む)
+    u32 activeClipCount() const;
+
+    //  統計情報を取得 (直前のフレーム)
+    static Stats stats();
+
+    //  統計情報のフレームを区切る
+    static void finishFrame();
+
     //  一時停止中かどうかを取得
     bool isPaused() const;
 
@@ -121,33 +275,64 @@ class Animation final {
     //@}
 
    private:
+    struct Context;
+    struct Layer;
+
     //  アニメーションを割り当て
-    //! @param  [in]    context_index   コンテキスト番号
-    bool attachAnimation(s32 context_index);
+    //! @param  [in]    c   コンテキスト
+    bool attachAnimation(Context& c);
 
     //  アニメーション割り当てを解除
-    //! @param  [in]    context_index   コンテキスト番号
-    void detachAnimation(s32 context_index);
+    //! @param  [in]    c   コンテキスト
+    void detachAnimation(Context& c);
+
+    //  すべてのアニメーション割り当てを解除
+    void detachAll();
+
+    //  ブレンド率をモデルに設定
+    void applyBlendRates();
+
+    //  通過したイベントを通知待ちに積む
+    //! @param  [in]    c               コンテキスト
+    //! @param  [in]    from            区間の開始時間
+    //! @param  [in]    to              区間の終了時間 (この時間のイベントを含む)
+    //! @param  [in]    include_from    開始時間ちょうどのイベントも含めるか
+    void collectEvents(const Context& c, f32 from, f32 to, bool include_from);
+
+    //  レイヤーの現在のアニメーションを取得
+    //! @return 再生していない場合は nullptr
+    const Context* currentContext(u32 layer = 0) const;
+
+    //  フレームが指定フレームの子孫かどうか
+    bool isChildFrame(s32 frame_index, s32 root_index) const;
 
     std::wstring path_;                      //!< ファイルパス
     bool         is_valid_     = false;      //!< 初期化が正しく成功しているかどうか
     Model*       model_        = nullptr;    //!< 関連付けられているモデル
     int          model_handle_ = -1;         //!< [DxLib] 関連付けられているモデルのハンドル
 
-    std::vector<Animation::Desc> descs_;          //!< アニメーション定義情報
-    std::vector<int>             mv1_handles_;    //!< [DxLib] アニメーションMV1ハンドル
+    std::vector<Animation::Desc>                descs_;          //!< アニメーション定義情報
+    std::vector<int>                            mv1_handles_;    //!< [DxLib] アニメーションMV1ハンドル
+    std::vector<AssetHandle<ResourceAnimation>> resources_;      //!< アニメーションリソース (複製元)
 
-    //! 名前逆引きテーブル (名前からアニメーション番号を取得)
-    std::unordered_map<std::string, u32> name_table_;
+    EventCallback                        event_callback_;    //!< イベント通知先
+    std::vector<std::pair<s32, Event>>   fired_events_;      //!< 通知待ちのイベント (アニメーション番号, イベント)
+
+    //! ID逆引きテーブル (AnimId::value() からアニメーション番号を取得 未登録は-1)
+    std::vector<s32> id_table_;
+
+    //! アニメーション番号ごとのID
+    std::vector<AnimId> ids_;
 
     //----------------------------------------------------------
     //! @name   再生中の情報
     //----------------------------------------------------------
     //@{
 
-    bool is_paused_ = false;    //!< ポーズ中かどうか
+    bool is_paused_   = false;    //!< ポーズ中かどうか
+    bool blend_dirty_ = false;    //!< ブレンド率の設定しなおしが必要
 
-    //! 再生中の情報構造体
+    //! 再生中の情報構造体 (アタッチ中のアニメーションのみ)
     struct Context {
         bool is_playing_             = false;    //!< 再生中かどうか
         bool is_loop_                = false;    //!< ループ再生かどうか
@@ -156,11 +341,20 @@ class Animation final {
         f32  animation_total_time_   = 0.0f;     //!< 総再生時間
         f32  play_time_              = 0.0f;     //!< 現在再生中の時間
         f32  blend_ratio_            = 0.0f;     //!< ブレンド比(0.0f～1.0f)
+        bool is_started_             = false;    //!< 開始時間のイベントを通知済みか
+    };
+
+    //! レイヤー
+    struct Layer {
+        std::vector<Context> contexts_;               //!< ブレンド中のアニメーション (末尾が現在のアニメーション)
+        s32                  mask_frame_ = -1;        //!< 適用するフレーム番号 (-1で全身)
+        f32                  weight_     = 1.0f;      //!< 下位レイヤーを上書きする割合
+        f32                  coverage_   = 0.0f;      //!< フェードを含めた上書きの割合 (applyBlendRates()で計算)
+        f32                  blend_time_ = 1.0f;      //!< ブレンドの補間時間
+        bool                 stopping_   = false;     //!< フェードアウトして停止中
     };
 
-    static constexpr u32 CONTEXT_COUNT = 4;
-    Context              contexts_[CONTEXT_COUNT];    //!< 構造体はアニメーションブレンドのため複数持つ
-    f32                  blend_time_ = 1.0f;          //!< ブレンドの補間時間
+    std::vector<Layer> layers_ = std::vector<Layer>(1);    //!< レイヤー (0が全身の基本レイヤー)
 
     //@}
 };
@@ -190,6 +384,12 @@ class ResourceAnimation final {
     // [DxLib] MV1ハンドルを取得
     operator int() const;
 
+    // 使用メモリ量を取得 (アニメーションファイルのサイズ)
+    u64 residentBytes() const;
+
+    // 読み込み中かどうか (読み込み中は解放できません)
+    bool isBusy() const;
+
     //----------------------------------------------------------
     //! @name   copy/move禁止
     //----------------------------------------------------------
@@ -205,6 +405,7 @@ class ResourceAnimation final {
 
    private:
     std::wstring      path_;                  //!< モデルファイルへのパス
+    u64               file_bytes_ = 0;        //!< アニメーションファイルのサイズ
     int               mv1_handle_ = -1;       //!< [DxLib] MV1モデルハンドル (アニメーション用途)
     std::atomic<bool> active_     = false;    //!< アクティブ状態 true:利用可能 false:ロード未完了
 };
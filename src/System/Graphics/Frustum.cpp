@@ -20,6 +20,16 @@ Frustum::Frustum(const matrix& mat_view, const matrix& mat_proj, Frustum::DepthM
     // f32               z_near_          = 0.01f;                        //!< 近クリップ面までの距離
     // f32               z_far_           = 1000.0f;                      //!< 遠クリップ面までの距離
     // Camera::DepthMode depthMode_       = Camera::DepthMode::Default;   //!< デプス動作モード
+
+    // カメラのワールド行列はビュー行列の逆行列
+    mat_camera_world_ = inverse(mat_view_);
+    position_         = mat_camera_world_.translate();
+    look_at_          = position_ + mat_camera_world_.axisZ();
+
+    // 合成
+    mat_view_proj_ = mul(mat_view_, mat_proj_);
+
+    updatePlanes();
 }
 
 //---------------------------------------------------------------------------
@@ -52,6 +62,8 @@ void Frustum::update() {
 
     // 合成
     mat_view_proj_ = mul(mat_view_, mat_proj_);
+
+    updatePlanes();
 }
 
 //---------------------------------------------------------------------------
@@ -202,7 +214,7 @@ Frustum& Frustum::setNearZ(f32 z_near) {
 //! 遠クリップ距離を設定
 //---------------------------------------------------------------------------
 Frustum& Frustum::setFarZ(f32 z_far) {
-    z_far = z_far;
+    z_far_ = z_far;
     return *this;
 }
 
@@ -335,3 +347,90 @@ const matrix& Frustum::matProj() const {
 const matrix& Frustum::matViewProj() const {
     return mat_view_proj_;
 }
+
+//---------------------------------------------------------------------------
+//! 視錐台の平面を取得
+//---------------------------------------------------------------------------
+const std::array<float4, 6>& Frustum::planes() const {
+    return planes_;
+}
+
+//---------------------------------------------------------------------------
+//! 球が視錐台と交差しているか
+//---------------------------------------------------------------------------
+bool Frustum::isVisible(const float3& center, f32 radius) const {
+    float4 r = float4(-radius);
+
+    // 4枚ずつまとめて判定 (どれか1枚でも完全に外側なら見えない)
+    for(u32 i = 0; i < 2; ++i) {
+        float4 d = plane_x_[i] * center.x + plane_y_[i] * center.y + plane_z_[i] * center.z + plane_w_[i];
+        if(any(d < r))
+            return false;
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! AABBが視錐台と交差しているか
+//---------------------------------------------------------------------------
+bool Frustum::isVisibleAabb(const float3& aabb_min, const float3& aabb_max) const {
+    float3 center = (aabb_max + aabb_min) * 0.5f;
+    float3 extent = (aabb_max - aabb_min) * 0.5f;
+
+    // 平面の法線方向へのAABBの投影半径 |n|・e で球と同じように判定
+    for(u32 i = 0; i < 2; ++i) {
+        float4 d = plane_x_[i] * center.x + plane_y_[i] * center.y + plane_z_[i] * center.z + plane_w_[i];
+        float4 r = abs(plane_x_[i]) * extent.x + abs(plane_y_[i]) * extent.y + abs(plane_z_[i]) * extent.z;
+        if(any(d < -r))
+            return false;
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! ビュー ✕ 投影行列から平面を抽出
+//---------------------------------------------------------------------------
+void Frustum::updatePlanes() {
+    // クリップ座標 = float4(ワールド座標, 1) ✕ ビュー投影行列 の列ベクトルの組み合わせで平面になる
+    matrix m  = transpose(mat_view_proj_);
+    float4 cx = m._11_12_13_14;
+    float4 cy = m._21_22_23_24;
+    float4 cz = m._31_32_33_34;
+    float4 cw = m._41_42_43_44;
+
+    // D3Dの深度範囲は 0～w。反転Zの場合は近と遠が入れ替わる
+    float4 z_near = useReverseDepth() ? cw - cz : cz;
+    float4 z_far  = useReverseDepth() ? cz : cw - cz;
+
+    planes_ = {cw + cx, cw - cx, cw + cy, cw - cy, z_near, z_far};
+
+    for(auto& plane: planes_) {
+        f32 norm = length(plane.xyz);
+
+        // 無限遠の遠平面は法線がゼロになるため常に内側として扱う
+        if(norm < 1e-6f) {
+            plane = float4(0.0f, 0.0f, 0.0f, 1.0f);
+            continue;
+        }
+        plane /= norm;
+    }
+
+    //----------------------------------------------------------
+    // 4枚ずつSoAに並べ替え (2組目の余りは複製で埋める)
+    //----------------------------------------------------------
+    static constexpr u32 order[2][4] = {
+        {0, 1, 2, 3},
+        {4, 5, 4, 5},
+    };
+    for(u32 i = 0; i < 2; ++i) {
+        const auto& p0 = planes_[order[i][0]];
+        const auto& p1 = planes_[order[i][1]];
+        const auto& p2 = planes_[order[i][2]];
+        const auto& p3 = planes_[order[i][3]];
+
+        plane_x_[i] = float4(p0.x, p1.x, p2.x, p3.x);
+        plane_y_[i] = float4(p0.y, p1.y, p2.y, p3.y);
+        plane_z_[i] = float4(p0.z, p1.z, p2.z, p3.z);
+        plane_w_[i] = float4(p0.w, p1.w, p2.w, p3.w);
+    }
+}
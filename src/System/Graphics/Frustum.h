@@ -4,6 +4,8 @@
 //---------------------------------------------------------------------------
 #pragma once
 
+#include <array>
+
 //===========================================================================
 //! カメラ
 //===========================================================================
@@ -132,9 +134,32 @@ class Frustum {
     //  ビュー ✕ 投影行列を取得
     [[nodiscard]] const matrix& matViewProj() const;
 
+    //  視錐台の平面を取得
+    //! @return 左/右/下/上/近/遠 の順の平面 (xyz:法線 w:距離 内側が正)
+    [[nodiscard]] const std::array<float4, 6>& planes() const;
+
+    //@}
+    //----------------------------------------------------------
+    //! @name   判定
+    //----------------------------------------------------------
+    //@{
+
+    //  球が視錐台と交差しているか
+    //! @param  [in]    center  中心 (ワールド座標)
+    //! @param  [in]    radius  半径
+    [[nodiscard]] bool isVisible(const float3& center, f32 radius) const;
+
+    //  AABBが視錐台と交差しているか
+    //! @param  [in]    aabb_min    最小座標 (ワールド座標)
+    //! @param  [in]    aabb_max    最大座標 (ワールド座標)
+    [[nodiscard]] bool isVisibleAabb(const float3& aabb_min, const float3& aabb_max) const;
+
     //@}
 
    private:
+    //  ビュー ✕ 投影行列から平面を抽出
+    void updatePlanes();
+
     float3             position_         = float3(0.0f, 5.0f, -15.0f);     //!< 位置
     float3             look_at_          = float3(0.0f, 0.0f, 0.0f);       //!< 注視点
     float3             world_up_         = float3(0.0f, 1.0f, 0.0f);       //!< 世界の上方向のベクトル
@@ -147,4 +172,10 @@ class Frustum {
     matrix             mat_view_         = matrix::identity();             //!< ビュー行列
     matrix             mat_proj_         = matrix::identity();             //!< 投影行列
     matrix             mat_view_proj_    = matrix::identity();             //!< ビュー ✕ 投影行列
+
+    std::array<float4, 6> planes_{};     //!< 視錐台の平面 (左/右/下/上/近/遠)
+    float4                plane_x_[2];    //!< 平面の法線X (4枚ずつ 2組目の余りは複製)
+    float4                plane_y_[2];    //!< 平面の法線Y
+    float4                plane_z_[2];    //!< 平面の法線Z
+    float4                plane_w_[2];    //!< 平面の距離
 };
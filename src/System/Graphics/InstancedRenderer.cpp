@@ -0,0 +1,610 @@
+﻿//---------------------------------------------------------------------------
+//! @file   InstancedRenderer.cpp
+//! @brief  静的メッシュのインスタンス描画
+//---------------------------------------------------------------------------
+#include "InstancedRenderer.h"
+#include "ResourceModel.h"
+#include "Render.h"
+#include "Shader.h"
+#include "TexturePool.h"
+#include "Frustum.h"
+
+#include <bit>
+
+namespace {
+
+//! 頂点 (vs_model_instanced.fx の VS_INPUT_INSTANCED と同じ並び)
+struct Vertex {
+    f32 position_[3];    //!< 座標 (モデル空間)
+    f32 normal_[3];      //!< 法線 (モデル空間)
+    u8  diffuse_[4];     //!< ディフューズカラー (RGBA)
+    f32 uv0_[2];         //!< テクスチャ座標
+};
+
+//! インスタンスあたりのデータ数 (ワールド行列の3行)
+constexpr u32 INSTANCE_ROWS = 3;
+
+//! カメラ情報 (ps_model.fx の CameraInfo b10 と同じ並び)
+struct CameraInfo {
+    matrix mat_view_;        //!< ビュー行列
+    matrix mat_proj_;        //!< 投影行列
+    float3 eye_position_;    //!< カメラの位置
+};
+
+std::unordered_map<std::string, std::weak_ptr<InstancedMesh>> instanced_meshes;    //!< 共有中のメッシュ
+std::vector<std::shared_ptr<InstancedMesh>>                    submitted_meshes;    //!< 今フレームに登録されたメッシュ
+
+Frustum camera_frustum;                  //!< カメラの視錐台
+bool    camera_frustum_valid = false;    //!< 今フレームの視錐台を取得済みか
+
+InstancedRenderer::Stats frame_stats;    //!< 今フレームの統計情報
+InstancedRenderer::Stats last_stats;     //!< 直前の flush() の統計情報
+
+std::shared_ptr<ShaderVs> shader_vs;               //!< 頂点シェーダー
+std::shared_ptr<ShaderPs> shader_ps;               //!< ピクセルシェーダー (ps_model)
+const void*               vs_bytecode = nullptr;    //!< D3Dシェーダー作成に使用したバイトコード
+const void*               ps_bytecode = nullptr;    //!< D3Dシェーダー作成に使用したバイトコード
+
+std::shared_ptr<Texture> tex_null_white;      //!< ディフューズテクスチャがない場合
+std::shared_ptr<Texture> tex_null_normal;     //!< 法線マップがない場合
+std::shared_ptr<Texture> tex_ibl_diffuse;     //!< IBLテクスチャ(Diffuse)
+std::shared_ptr<Texture> tex_ibl_specular;    //!< IBLテクスチャ(Specular)
+
+Microsoft::WRL::ComPtr<ID3D11VertexShader>      d3d_vs;                   //!< 頂点シェーダー
+Microsoft::WRL::ComPtr<ID3D11PixelShader>       d3d_ps;                   //!< ピクセルシェーダー
+Microsoft::WRL::ComPtr<ID3D11InputLayout>       d3d_input_layout;         //!< 入力レイアウト
+Microsoft::WRL::ComPtr<ID3D11Buffer>            d3d_instance_buffer;      //!< インスタンスバッファ
+u32                                             instance_capacity = 0;    //!< インスタンスバッファの容量 (インスタンス数)
+Microsoft::WRL::ComPtr<ID3D11Buffer>            d3d_camera_cb;            //!< カメラ情報定数バッファ
+Microsoft::WRL::ComPtr<ID3D11SamplerState>      d3d_sampler;              //!< サンプラー
+Microsoft::WRL::ComPtr<ID3D11DepthStencilState> d3d_depth_state;          //!< デプステスト/書き込みあり
+Microsoft::WRL::ComPtr<ID3D11RasterizerState>   d3d_rasterizer_state;     //!< カリングなし
+
+//---------------------------------------------------------------------------
+//! MV1モデルのテクスチャからShaderResourceViewを作成
+//---------------------------------------------------------------------------
+Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> createTextureSrv(int mv1_handle, int texture_index) {
+    if(texture_index < 0)
+        return nullptr;
+
+    int graph_handle = MV1GetTextureGraphHandle(mv1_handle, texture_index);
+    if(graph_handle == -1)
+        return nullptr;
+
+    auto* d3d_resource = reinterpret_cast<ID3D11Resource*>(const_cast<void*>(GetGraphID3D11Texture2D(graph_handle)));
+    if(d3d_resource == nullptr)
+        return nullptr;
+
+    Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> d3d_srv;
+    GetD3DDevice()->CreateShaderResourceView(d3d_resource, nullptr, &d3d_srv);
+    return d3d_srv;
+}
+
+//---------------------------------------------------------------------------
+//! テクスチャのShaderResourceViewを取得 (読み込み中はnullptr)
+//---------------------------------------------------------------------------
+ID3D11ShaderResourceView* textureSrv(const std::shared_ptr<Texture>& texture) {
+    if(!texture || static_cast<int>(*texture) == -1)    // 遅延初期化
+        return nullptr;
+    return texture->srv();
+}
+
+//---------------------------------------------------------------------------
+//! 描画パイプラインを準備 (シェーダーの再読み込みにも対応)
+//---------------------------------------------------------------------------
+bool setupPipeline() {
+    auto* d3d_device = GetD3DDevice();
+
+    // 初回のみ読み込み
+    if(!shader_vs) {
+        shader_vs = std::make_shared<ShaderVs>("data/Shader/vs_model_instanced", 1);
+        shader_ps = std::make_shared<ShaderPs>("data/Shader/ps_model", Model::PS_VARIANT_COUNT);
+
+        tex_null_white   = TexturePool::load("data/System/null_white.dds", TexturePool::PRIORITY_IMMEDIATE);
+        tex_null_normal  = TexturePool::load("data/System/null_normal.dds", TexturePool::PRIORITY_IMMEDIATE);
+        tex_ibl_diffuse  = TexturePool::load("data/IBL/iblDiffuseHDR.dds", TexturePool::PRIORITY_IMMEDIATE);
+        tex_ibl_specular = TexturePool::load("data/IBL/iblSpecularHDR.dds", TexturePool::PRIORITY_IMMEDIATE);
+
+        // 定数バッファ
+        {
+            D3D11_BUFFER_DESC desc{
+                .ByteWidth = (sizeof(CameraInfo) + 15) & ~15u,    // 16バイト単位
+                .Usage     = D3D11_USAGE_DEFAULT,
+                .BindFlags = D3D11_BIND_CONSTANT_BUFFER,
+            };
+            d3d_device->CreateBuffer(&desc, nullptr, &d3d_camera_cb);
+        }
+
+        // サンプラー
+        {
+            D3D11_SAMPLER_DESC desc{};
+            desc.Filter         = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+            desc.AddressU       = D3D11_TEXTURE_ADDRESS_WRAP;
+            desc.AddressV       = D3D11_TEXTURE_ADDRESS_WRAP;
+            desc.AddressW       = D3D11_TEXTURE_ADDRESS_WRAP;
+            desc.ComparisonFunc = D3D11_COMPARISON_NEVER;
+            desc.MaxLOD         = D3D11_FLOAT32_MAX;
+            d3d_device->CreateSamplerState(&desc, &d3d_sampler);
+        }
+
+        // デプスステート (SetUseZBuffer3D/SetWriteZBuffer3D と同じ)
+        {
+            D3D11_DEPTH_STENCIL_DESC desc{};
+            desc.DepthEnable    = TRUE;
+            desc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ALL;
+            desc.DepthFunc      = D3D11_COMPARISON_LESS_EQUAL;
+            d3d_device->CreateDepthStencilState(&desc, &d3d_depth_state);
+        }
+
+        // ラスタライザーステート (柵などの両面ポリゴンがあるためカリングなし)
+        {
+            D3D11_RASTERIZER_DESC desc{};
+            desc.FillMode        = D3D11_FILL_SOLID;
+            desc.CullMode        = D3D11_CULL_NONE;
+            desc.DepthClipEnable = TRUE;
+            desc.ScissorEnable   = TRUE;
+            d3d_device->CreateRasterizerState(&desc, &d3d_rasterizer_state);
+        }
+    }
+
+    //----------------------------------------------------------
+    // 頂点シェーダーと入力レイアウト
+    //----------------------------------------------------------
+    auto [vs_binary, vs_binary_size] = shader_vs->shader_bytecode();
+    if(vs_binary != vs_bytecode) {
+        d3d_vs.Reset();
+        d3d_input_layout.Reset();
+        vs_bytecode = vs_binary;
+
+        if(vs_binary) {
+            // clang-format off
+            D3D11_INPUT_ELEMENT_DESC layout[]{
+                {"POSITION",       0, DXGI_FORMAT_R32G32B32_FLOAT,    0, offsetof(Vertex, position_), D3D11_INPUT_PER_VERTEX_DATA,   0},
+                {"NORMAL",         0, DXGI_FORMAT_R32G32B32_FLOAT,    0, offsetof(Vertex, normal_),   D3D11_INPUT_PER_VERTEX_DATA,   0},
+                {"COLOR",          0, DXGI_FORMAT_R8G8B8A8_UNORM,     0, offsetof(Vertex, diffuse_),  D3D11_INPUT_PER_VERTEX_DATA,   0},
+                {"TEXCOORD",       0, DXGI_FORMAT_R32G32_FLOAT,       0, offsetof(Vertex, uv0_),      D3D11_INPUT_PER_VERTEX_DATA,   0},
+                {"INSTANCE_WORLD", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, sizeof(float4) * 0,          D3D11_INPUT_PER_INSTANCE_DATA, 1},
+                {"INSTANCE_WORLD", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, sizeof(float4) * 1,          D3D11_INPUT_PER_INSTANCE_DATA, 1},
+                {"INSTANCE_WORLD", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, sizeof(float4) * 2,          D3D11_INPUT_PER_INSTANCE_DATA, 1},
+            };
+            // clang-format on
+
+            d3d_device->CreateVertexShader(vs_binary, vs_binary_size, nullptr, &d3d_vs);
+            d3d_device->CreateInputLayout(layout, static_cast<u32>(std::size(layout)), vs_binary, vs_binary_size,
+                                          &d3d_input_layout);
+        }
+    }
+
+    //----------------------------------------------------------
+    // ピクセルシェーダー
+    //----------------------------------------------------------
+    auto [ps_binary, ps_binary_size] = shader_ps->shader_bytecode();
+    if(ps_binary != ps_bytecode) {
+        d3d_ps.Reset();
+        ps_bytecode = ps_binary;
+
+        if(ps_binary)
+            d3d_device->CreatePixelShader(ps_binary, ps_binary_size, nullptr, &d3d_ps);
+    }
+
+    return d3d_vs && d3d_ps && d3d_input_layout && d3d_camera_cb;
+}
+
+//---------------------------------------------------------------------------
+//! インスタンスバッファを確保
+//---------------------------------------------------------------------------
+bool reserveInstanceBuffer(u32 instance_count) {
+    if(instance_count <= instance_capacity)
+        return true;
+
+    // 再確保を減らすため2のべき乗で確保
+    u32 capacity = std::bit_ceil(std::max(instance_count, 64u));
+
+    D3D11_BUFFER_DESC desc{
+        .ByteWidth      = sizeof(float4) * INSTANCE_ROWS * capacity,
+        .Usage          = D3D11_USAGE_DYNAMIC,
+        .BindFlags      = D3D11_BIND_VERTEX_BUFFER,
+        .CPUAccessFlags = D3D11_CPU_ACCESS_WRITE,
+    };
+
+    d3d_instance_buffer.Reset();
+    instance_capacity = 0;
+    if(GetD3DDevice()->CreateBuffer(&desc, nullptr, &d3d_instance_buffer) != S_OK)
+        return false;
+
+    instance_capacity = capacity;
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! 今フレームの登録を破棄して統計情報を確定
+//---------------------------------------------------------------------------
+void finishFrame() {
+    for(auto& mesh: submitted_meshes)
+        mesh->instances_.clear();
+    submitted_meshes.clear();
+
+    last_stats           = frame_stats;
+    frame_stats          = {};
+    camera_frustum_valid = false;
+}
+
+}    // namespace
+
+//===========================================================================
+// インスタンス描画用の静的メッシュ InstancedMesh
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//! コンストラクタ
+//---------------------------------------------------------------------------
+InstancedMesh::InstancedMesh(std::string_view path) {
+    // ComponentModel と同じモデルリソースを共有
+    resource_model_ = AssetRegistry::acquire<ResourceModel>(AssetType::Model, path, [path]() {
+        return std::make_shared<ResourceModel>(path);
+    });
+}
+
+//---------------------------------------------------------------------------
+//! デストラクタ
+//---------------------------------------------------------------------------
+InstancedMesh::~InstancedMesh() = default;
+
+//---------------------------------------------------------------------------
+//! 描画可能かどうか
+//---------------------------------------------------------------------------
+bool InstancedMesh::isActive() const {
+    return is_valid_;
+}
+
+//---------------------------------------------------------------------------
+//! モデルのファイルパスを取得
+//---------------------------------------------------------------------------
+const std::wstring& InstancedMesh::path() const {
+    return resource_model_->path();
+}
+
+//---------------------------------------------------------------------------
+//! 境界球の中心を取得
+//---------------------------------------------------------------------------
+float3 InstancedMesh::boundsCenter() const {
+    return bounds_center_;
+}
+
+//---------------------------------------------------------------------------
+//! 境界球の半径を取得
+//---------------------------------------------------------------------------
+f32 InstancedMesh::boundsRadius() const {
+    return bounds_radius_;
+}
+
+//---------------------------------------------------------------------------
+//! バッファを作成
+//---------------------------------------------------------------------------
+bool InstancedMesh::setup() {
+    if(is_setup_)
+        return is_valid_;
+
+    // 読み込み中/キャッシュ生成中はモデルハンドルに触らない
+    if(!resource_model_ || !resource_model_->isActive() || resource_model_->isBusy())
+        return false;
+
+    is_setup_ = true;
+
+    int mv1_handle = *resource_model_;
+
+    //----------------------------------------------------------
+    // 参照用メッシュから頂点とマテリアルごとのインデックスを抽出
+    //----------------------------------------------------------
+    std::vector<Vertex>           vertices;
+    std::vector<std::vector<u32>> material_indices(std::max(MV1GetMaterialNum(mv1_handle), 0));
+    {
+        bool is_transform = true;
+        MV1SetupReferenceMesh(mv1_handle, -1, is_transform);
+        auto poly_list = MV1GetReferenceMesh(mv1_handle, -1, is_transform);
+
+        vertices.resize(poly_list.VertexNum);
+        for(s32 i = 0; i < poly_list.VertexNum; ++i) {
+            const auto& src = poly_list.Vertexs[i];
+            auto&       dst = vertices[i];
+
+            dst.position_[0] = src.Position.x;
+            dst.position_[1] = src.Position.y;
+            dst.position_[2] = src.Position.z;
+            dst.normal_[0]   = src.Normal.x;
+            dst.normal_[1]   = src.Normal.y;
+            dst.normal_[2]   = src.Normal.z;
+            dst.diffuse_[0]  = src.DiffuseColor.r;    // COLOR_U8 は BGRA の並び
+            dst.diffuse_[1]  = src.DiffuseColor.g;
+            dst.diffuse_[2]  = src.DiffuseColor.b;
+            dst.diffuse_[3]  = src.DiffuseColor.a;
+            dst.uv0_[0]      = src.TexCoord[0].u;
+            dst.uv0_[1]      = src.TexCoord[0].v;
+        }
+
+        for(s32 i = 0; i < poly_list.PolygonNum; ++i) {
+            const auto& polygon = poly_list.Polygons[i];
+            if(polygon.MaterialIndex >= material_indices.size())
+                continue;
+
+            auto& indices = material_indices[polygon.MaterialIndex];
+            indices.push_back(static_cast<u32>(polygon.VIndex[0]));
+            indices.push_back(static_cast<u32>(polygon.VIndex[1]));
+            indices.push_back(static_cast<u32>(polygon.VIndex[2]));
+        }
+
+        // 境界球 (AABBの外接球)
+        float3 min_position = cast(poly_list.MinPosition);
+        float3 max_position = cast(poly_list.MaxPosition);
+        bounds_center_      = (min_position + max_position) * 0.5f;
+        bounds_radius_      = length(max_position - min_position) * 0.5f;
+
+        MV1TerminateReferenceMesh(mv1_handle, -1, is_transform);
+    }
+
+    //----------------------------------------------------------
+    // マテリアルごとの描画パケット
+    //----------------------------------------------------------
+    std::vector<u32> indices;
+    for(s32 material = 0; material < static_cast<s32>(material_indices.size()); ++material) {
+        auto& material_index = material_indices[material];
+        if(material_index.empty())
+            continue;
+
+        Packet packet;
+        packet.index_start_ = static_cast<u32>(indices.size());
+        packet.index_count_ = static_cast<u32>(material_index.size());
+        packet.diffuse_     = createTextureSrv(mv1_handle, MV1GetMaterialDifMapTexture(mv1_handle, material));
+        packet.normal_      = createTextureSrv(mv1_handle, MV1GetMaterialNormalMapTexture(mv1_handle, material));
+        packets_.push_back(std::move(packet));
+
+        indices.insert(indices.end(), material_index.begin(), material_index.end());
+    }
+
+    if(vertices.empty() || indices.empty())
+        return false;
+
+    //----------------------------------------------------------
+    // 頂点/インデックスバッファを作成
+    //----------------------------------------------------------
+    auto* d3d_device = GetD3DDevice();
+    {
+        D3D11_BUFFER_DESC desc{
+            .ByteWidth = static_cast<u32>(sizeof(Vertex) * vertices.size()),
+            .Usage     = D3D11_USAGE_IMMUTABLE,
+            .BindFlags = D3D11_BIND_VERTEX_BUFFER,
+        };
+        D3D11_SUBRESOURCE_DATA data{.pSysMem = vertices.data()};
+        if(d3d_device->CreateBuffer(&desc, &data, &d3d_vb_) != S_OK)
+            return false;
+    }
+    {
+        D3D11_BUFFER_DESC desc{
+            .ByteWidth = static_cast<u32>(sizeof(u32) * indices.size()),
+            .Usage     = D3D11_USAGE_IMMUTABLE,
+            .BindFlags = D3D11_BIND_INDEX_BUFFER,
+        };
+        D3D11_SUBRESOURCE_DATA data{.pSysMem = indices.data()};
+        if(d3d_device->CreateBuffer(&desc, &data, &d3d_ib_) != S_OK)
+            return false;
+    }
+
+    is_valid_ = true;
+    return true;
+}
+
+//===========================================================================
+// 静的メッシュのインスタンス描画 InstancedRenderer
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//! メッシュを取得
+//---------------------------------------------------------------------------
+std::shared_ptr<InstancedMesh> InstancedRenderer::acquire(std::string_view path) {
+    auto key = AssetRegistry::normalizePath(path);
+
+    auto& entry = instanced_meshes[key];
+    if(auto mesh = entry.lock())
+        return mesh;
+
+    auto mesh = std::make_shared<InstancedMesh>(path);
+    entry     = mesh;
+    return mesh;
+}
+
+//---------------------------------------------------------------------------
+//! インスタンスを登録
+//---------------------------------------------------------------------------
+bool InstancedRenderer::submit(const std::shared_ptr<InstancedMesh>& mesh, const matrix& mat_world) {
+    if(!mesh)
+        return false;
+
+    frame_stats.submitted_++;
+
+    // 読み込みが終わるまでは描画しない
+    if(!mesh->setup())
+        return false;
+
+    //----------------------------------------------------------
+    // 視錐台カリング (境界球)
+    //----------------------------------------------------------
+    if(!camera_frustum_valid) {
+        camera_frustum       = Frustum(matrix(GetCameraViewMatrix()), matrix(GetCameraProjectionMatrix()));
+        camera_frustum_valid = true;
+    }
+
+    float3 center = mul(float4(mesh->bounds_center_, 1.0f), mat_world).xyz;
+    f32    scale  = max(max(length(mat_world.axisX()), length(mat_world.axisY())), length(mat_world.axisZ()));
+    if(!camera_frustum.isVisible(center, mesh->bounds_radius_ * scale))
+        return false;
+
+    //----------------------------------------------------------
+    // ワールド行列を転置した3行を登録 (シェーダーで dot(row, float4(position, 1)))
+    //----------------------------------------------------------
+    f32 m[16];
+    store(mat_world, m);
+
+    if(mesh->instances_.empty())
+        submitted_meshes.push_back(mesh);
+
+    mesh->instances_.push_back(float4(m[0], m[4], m[8], m[12]));
+    mesh->instances_.push_back(float4(m[1], m[5], m[9], m[13]));
+    mesh->instances_.push_back(float4(m[2], m[6], m[10], m[14]));
+
+    frame_stats.visible_++;
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! 登録されたインスタンスを描画
+//---------------------------------------------------------------------------
+void InstancedRenderer::flush() {
+    if(submitted_meshes.empty() || !setupPipeline()) {
+        finishFrame();
+        return;
+    }
+
+    auto* d3d_context = GetD3DDeviceContext();
+
+    //----------------------------------------------------------
+    // インスタンスバッファを更新
+    //----------------------------------------------------------
+    u32 instance_count = 0;
+    for(auto& mesh: submitted_meshes)
+        instance_count += static_cast<u32>(mesh->instances_.size()) / INSTANCE_ROWS;
+
+    if(!reserveInstanceBuffer(instance_count)) {
+        finishFrame();
+        return;
+    }
+
+    {
+        D3D11_MAPPED_SUBRESOURCE mapped;
+        if(d3d_context->Map(d3d_instance_buffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped) != S_OK) {
+            finishFrame();
+            return;
+        }
+
+        auto* p = static_cast<float4*>(mapped.pData);
+        for(auto& mesh: submitted_meshes) {
+            std::copy(mesh->instances_.begin(), mesh->instances_.end(), p);
+            p += mesh->instances_.size();
+        }
+        d3d_context->Unmap(d3d_instance_buffer.Get(), 0);
+    }
+
+    //----------------------------------------------------------
+    // カメラ情報を更新
+    //----------------------------------------------------------
+    {
+        CameraInfo info;
+        info.mat_view_     = GetCameraViewMatrix();
+        info.mat_proj_     = GetCameraProjectionMatrix();
+        info.eye_position_ = cast(GetCameraPosition());
+        d3d_context->UpdateSubresource(d3d_camera_cb.Get(), 0, nullptr, &info, 0, 0);
+    }
+
+    //----------------------------------------------------------
+    // パイプラインを設定
+    //----------------------------------------------------------
+    // [DxLib] DXライブラリ内部のプリミティブバッファをフラッシュさせる
+    RenderVertex();
+
+    d3d_context->IASetInputLayout(d3d_input_layout.Get());
+    d3d_context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    d3d_context->VSSetShader(d3d_vs.Get(), nullptr, 0);
+    d3d_context->GSSetShader(nullptr, nullptr, 0);
+    d3d_context->PSSetShader(d3d_ps.Get(), nullptr, 0);
+
+    ID3D11Buffer* cb = d3d_camera_cb.Get();
+    d3d_context->VSSetConstantBuffers(10, 1, &cb);    // b10 = CameraInfo
+    d3d_context->PSSetConstantBuffers(10, 1, &cb);
+
+    ID3D11SamplerState* samplers[2] = {d3d_sampler.Get(), d3d_sampler.Get()};    // s0 = Diffuse, s1 = Normal
+    d3d_context->PSSetSamplers(0, 2, samplers);
+
+    ID3D11ShaderResourceView* ibl[2] = {textureSrv(tex_ibl_diffuse), textureSrv(tex_ibl_specular)};    // t11, t12
+    d3d_context->PSSetShaderResources(11, 2, ibl);
+
+    d3d_context->OMSetDepthStencilState(d3d_depth_state.Get(), 0);
+    d3d_context->OMSetBlendState(nullptr, nullptr, 0xffffffff);
+    d3d_context->RSSetState(d3d_rasterizer_state.Get());
+
+    ID3D11ShaderResourceView* null_white  = textureSrv(tex_null_white);
+    ID3D11ShaderResourceView* null_normal = textureSrv(tex_null_normal);
+
+    //----------------------------------------------------------
+    // メッシュごとにマテリアル単位で描画
+    //----------------------------------------------------------
+    u32 start_instance = 0;
+    for(auto& mesh: submitted_meshes) {
+        u32 count = static_cast<u32>(mesh->instances_.size()) / INSTANCE_ROWS;
+
+        ID3D11Buffer* buffers[2] = {mesh->d3d_vb_.Get(), d3d_instance_buffer.Get()};
+        u32           strides[2] = {sizeof(Vertex), sizeof(float4) * INSTANCE_ROWS};
+        u32           offsets[2] = {0, 0};
+        d3d_context->IASetVertexBuffers(0, 2, buffers, strides, offsets);
+        d3d_context->IASetIndexBuffer(mesh->d3d_ib_.Get(), DXGI_FORMAT_R32_UINT, 0);
+
+        for(auto& packet: mesh->packets_) {
+            ID3D11ShaderResourceView* textures[2] = {
+                packet.diffuse_ ? packet.diffuse_.Get() : null_white,    // t0
+                packet.normal_ ? packet.normal_.Get() : null_normal,     // t1
+            };
+            d3d_context->PSSetShaderResources(0, 2, textures);
+
+            d3d_context->DrawIndexedInstanced(packet.index_count_, count, packet.index_start_, 0, start_instance);
+            frame_stats.draw_calls_++;
+        }
+
+        start_instance += count;
+        frame_stats.meshes_++;
+    }
+
+    //----------------------------------------------------------
+    // 使い終わったスロットを解除してDxLibの設定を戻す
+    //----------------------------------------------------------
+    ID3D11ShaderResourceView* null_srvs[2] = {};
+    d3d_context->PSSetShaderResources(0, 2, null_srvs);
+    d3d_context->PSSetShaderResources(11, 2, null_srvs);
+
+    // [DxLib] DXライブラリが行ったDirect3Dの設定を再度行う
+    RefreshDxLibDirect3DSetting();
+
+    finishFrame();
+}
+
+//---------------------------------------------------------------------------
+//! 統計情報を取得
+//---------------------------------------------------------------------------
+InstancedRenderer::Stats InstancedRenderer::stats() {
+    return last_stats;
+}
+
+//---------------------------------------------------------------------------
+//! 描画リソースを解放
+//---------------------------------------------------------------------------
+void InstancedRenderer::clear() {
+    finishFrame();
+    instanced_meshes.clear();
+
+    shader_vs.reset();
+    shader_ps.reset();
+    vs_bytecode = nullptr;
+    ps_bytecode = nullptr;
+
+    tex_null_white.reset();
+    tex_null_normal.reset();
+    tex_ibl_diffuse.reset();
+    tex_ibl_specular.reset();
+
+    d3d_vs.Reset();
+    d3d_ps.Reset();
+    d3d_input_layout.Reset();
+    d3d_instance_buffer.Reset();
+    instance_capacity = 0;
+    d3d_camera_cb.Reset();
+    d3d_sampler.Reset();
+    d3d_depth_state.Reset();
+    d3d_rasterizer_state.Reset();
+}
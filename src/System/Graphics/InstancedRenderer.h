@@ -0,0 +1,98 @@
+﻿//---------------------------------------------------------------------------
+//! @file   InstancedRenderer.h
+//! @brief  静的メッシュのインスタンス描画
+//---------------------------------------------------------------------------
+#pragma once
+
+#include <System/AssetRegistry.h>
+
+class ResourceModel;
+
+//===========================================================================
+//! @brief インスタンス描画用の静的メッシュ
+//! @details MV1モデルを参照用メッシュから頂点/インデックスバッファへ展開し、
+//!          マテリアルごとの描画パケットにまとめます。
+//!          アニメーションやフレームごとの移動は反映されません
+//===========================================================================
+class InstancedMesh final : noncopyable {
+    friend class InstancedRenderer;
+
+   public:
+    //! コンストラクタ
+    //! @param  [in]    path    モデルファイルパス
+    InstancedMesh(std::string_view path);
+
+    //! デストラクタ
+    ~InstancedMesh();
+
+    //! 描画可能かどうか (モデルの読み込み完了後、最初の描画でバッファを作成します)
+    bool isActive() const;
+
+    //! モデルのファイルパスを取得
+    const std::wstring& path() const;
+
+    //! 境界球の中心を取得 (モデル空間)
+    float3 boundsCenter() const;
+
+    //! 境界球の半径を取得 (モデル空間)
+    f32 boundsRadius() const;
+
+   private:
+    //! バッファを作成 (モデルの読み込み完了後に1回のみ)
+    bool setup();
+
+    //! 描画パケット (マテリアル単位)
+    struct Packet {
+        u32                                              index_start_ = 0;    //!< 開始インデックス
+        u32                                              index_count_ = 0;    //!< インデックス数
+        Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> diffuse_;            //!< ディフューズテクスチャ
+        Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> normal_;             //!< 法線マップ (nullptrならNull法線)
+    };
+
+    AssetHandle<ResourceModel>           resource_model_;                               //!< モデルリソース
+    bool                                 is_setup_      = false;                        //!< バッファ作成済み
+    bool                                 is_valid_      = false;                        //!< バッファ作成に成功したか
+    float3                               bounds_center_ = float3(0.0f, 0.0f, 0.0f);    //!< 境界球の中心
+    f32                                  bounds_radius_ = 0.0f;                         //!< 境界球の半径
+    Microsoft::WRL::ComPtr<ID3D11Buffer> d3d_vb_;                                       //!< 頂点バッファ
+    Microsoft::WRL::ComPtr<ID3D11Buffer> d3d_ib_;                                       //!< インデックスバッファ
+    std::vector<Packet>                  packets_;                                      //!< 描画パケット
+    std::vector<float4>                  instances_;    //!< 今フレームに描画するインスタンス (ワールド行列を3行ずつ)
+};
+
+//===========================================================================
+//! @brief 静的メッシュのインスタンス描画
+//! @details 描画フェーズで submit() されたものをメッシュごとにまとめ、
+//!          シーンの描画後に flush() でマテリアル単位に1回ずつ描画します。
+//!          視錐台の外にあるインスタンスは submit() の時点で除外されます
+//===========================================================================
+class InstancedRenderer final {
+   public:
+    //! 統計情報 (直前の flush() の結果)
+    struct Stats {
+        u32 draw_calls_ = 0;    //!< 描画コール数
+        u32 meshes_     = 0;    //!< 描画したメッシュの種類
+        u32 submitted_  = 0;    //!< 登録されたインスタンス数
+        u32 visible_    = 0;    //!< 視錐台内で描画したインスタンス数
+    };
+
+    //! @brief メッシュを取得 (同じモデルは共有されます)
+    //! @param [in] path    モデルファイルパス
+    static std::shared_ptr<InstancedMesh> acquire(std::string_view path);
+
+    //! @brief インスタンスを登録
+    //! @param [in] mesh        メッシュ
+    //! @param [in] mat_world   ワールド行列
+    //! @return 視錐台内で描画対象になった場合は true
+    static bool submit(const std::shared_ptr<InstancedMesh>& mesh, const matrix& mat_world);
+
+    //! @brief 登録されたインスタンスを描画
+    //! @details 現在の描画先に描画し、DxLibの描画設定を元に戻します
+    static void flush();
+
+    //! 統計情報を取得
+    static Stats stats();
+
+    //! シェーダーなどの描画リソースを解放
+    static void clear();
+};
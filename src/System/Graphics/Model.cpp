@@ -7,12 +7,10 @@
 #include "ModelCache.h"
 #include "Shader.h"
 #include "Animation.h"
+#include "TexturePool.h"
 
 namespace {
 
-//! モデルリソースプール
-std::unordered_map<std::string, std::shared_ptr<ResourceModel>> resource_model_pool;
-
 std::shared_ptr<Texture> textureIBL_diffuse_;     //!< IBLテクスチャ(Diffuse)
 std::shared_ptr<Texture> textureIBL_specular_;    //!< IBLテクスチャ(Specular)
 }    // namespace
@@ -125,24 +123,17 @@ class DxLib_MV1MatrixCache {
 //---------------------------------------------------------------------------
 bool Model::load(std::string_view path) {
     if(!textureIBL_diffuse_)
-        textureIBL_diffuse_ = std::make_shared<Texture>("data/IBL/iblDiffuseHDR.dds");
+        textureIBL_diffuse_ = TexturePool::load("data/IBL/iblDiffuseHDR.dds", TexturePool::PRIORITY_IMMEDIATE);
     if(!textureIBL_specular_)
-        textureIBL_specular_ = std::make_shared<Texture>("data/IBL/iblSpecularHDR.dds");
+        textureIBL_specular_ = TexturePool::load("data/IBL/iblSpecularHDR.dds", TexturePool::PRIORITY_IMMEDIATE);
 
     //----------------------------------------------------------
     // モデルリソース読み込み
     //----------------------------------------------------------
-    {
-        std::string resource_path = std::string(path);
-
-        auto it = resource_model_pool.find(resource_path);
-        if(it == resource_model_pool.end()) {    // 新規登録
-            resource_model_pool[resource_path] = std::make_shared<ResourceModel>(path);
-        }
-
-        // 共有
-        resource_model_ = resource_model_pool[resource_path];
-    }
+    // 既に同名ファイルがある場合は共有
+    resource_model_ = AssetRegistry::acquire<ResourceModel>(AssetType::Model, path, [path]() {
+        return std::make_shared<ResourceModel>(path);
+    });
 
     // 以前ロードしたデータは削除する
     if(animation_) {
@@ -173,9 +164,9 @@ bool Model::load(std::string_view path) {
         //----------------------------------------------------------
         // デフォルトテクスチャを読み込み
         //----------------------------------------------------------
-        tex_null_white_  = std::make_shared<Texture>("data/System/null_white.dds");
-        tex_null_black_  = std::make_shared<Texture>("data/System/null_black.dds");
-        tex_null_normal_ = std::make_shared<Texture>("data/System/null_normal.dds");
+        tex_null_white_  = TexturePool::load("data/System/null_white.dds", TexturePool::PRIORITY_IMMEDIATE);
+        tex_null_black_  = TexturePool::load("data/System/null_black.dds", TexturePool::PRIORITY_IMMEDIATE);
+        tex_null_normal_ = TexturePool::load("data/System/null_normal.dds", TexturePool::PRIORITY_IMMEDIATE);
     }
 
     // 速度バッファ生成用のStreamOutジオメトリシェーダーを作成
@@ -226,7 +217,7 @@ void Model::update([[maybe_unused]] f32 dt) {
 //---------------------------------------------------------------------------
 //! 描画
 //---------------------------------------------------------------------------
-void Model::render(ShaderVs* override_vs, ShaderPs* override_ps) {
+void Model::render(ShaderVs* override_vs, ShaderPs* override_ps, const TextureOverrides* override_textures) {
     if(!resource_model_)
         return;
 
@@ -241,15 +232,25 @@ void Model::render(ShaderVs* override_vs, ShaderPs* override_ps) {
     // ロード終了していたらハンドルを複製
     on_initialize();
 
-    for(s32 frame = 0; frame < frameCount(); ++frame) {
-        renderByFrame(frame, override_vs, override_ps);
+    // ワールド行列を設定
+    MV1SetMatrix(mv1_handle_, mat_world_);
+
+    // シェーダーを使わない場合はDxLib関数を直接実行
+    if(!use_shader_) {
+        for(s32 frame = 0; frame < frame_count_; ++frame) {
+            MV1DrawFrame(mv1_handle_, frame);
+        }
+        return;
     }
+
+    // 全フレームの描画パケットをまとめて描画
+    drawPackets(0, static_cast<u32>(draw_packets_.size()), override_vs, override_ps, override_textures);
 }
 
 //---------------------------------------------------------------------------
 //! フレーム番号指定で描画
 //---------------------------------------------------------------------------
-void Model::renderByFrame(s32 frame_index, ShaderVs* override_vs, ShaderPs* override_ps) {
+void Model::renderByFrame(s32 frame_index, ShaderVs* override_vs, ShaderPs* override_ps, const TextureOverrides* override_textures) {
     if(!resource_model_)
         return;
 
@@ -260,7 +261,7 @@ void Model::renderByFrame(s32 frame_index, ShaderVs* override_vs, ShaderPs* over
     on_initialize();
 
     // フレーム番号が有効範囲外
-    if(MV1GetFrameNum(mv1_handle_) <= frame_index) {
+    if(frame_index < 0 || frame_count_ <= frame_index) {
         return;
     }
 
@@ -273,20 +274,35 @@ void Model::renderByFrame(s32 frame_index, ShaderVs* override_vs, ShaderPs* over
         return;
     }
 
+    drawPackets(frame_packet_offsets_[frame_index], frame_packet_offsets_[frame_index + 1], override_vs, override_ps,
+                override_textures);
+}
+
+//---------------------------------------------------------------------------
+//! 描画パケットを描画
+//---------------------------------------------------------------------------
+void Model::drawPackets(u32 begin, u32 end, ShaderVs* override_vs, ShaderPs* override_ps, const TextureOverrides* override_textures) {
     //--------------------------------------------------
     // テクスチャ設定の上書き
     //--------------------------------------------------
-    bool override_normalmap = false;
+    TextureOverrides textures{};
+    if(override_textures) {
+        textures = *override_textures;
+    } else {
+        for(size_t i = 0; i < textures.size(); ++i)
+            textures[i] = overridedTextures_[i].get();
+    }
+
+    Texture* override_normal = textures[static_cast<s32>(Model::TextureType::Normal)];
 
-    if(overridedTextures_[static_cast<s32>(Model::TextureType::Diffuse)]) {
-        SetUseTextureToShader(0, *overridedTextures_[static_cast<s32>(Model::TextureType::Diffuse)]);
+    if(auto* texture = textures[static_cast<s32>(Model::TextureType::Diffuse)]) {
+        SetUseTextureToShader(0, *texture);
     }
-    if(overridedTextures_[static_cast<s32>(Model::TextureType::Normal)]) {
-        SetUseTextureToShader(1, *overridedTextures_[static_cast<s32>(Model::TextureType::Normal)]);
-        override_normalmap = true;    // 法線マップを使用
+    if(override_normal) {
+        SetUseTextureToShader(1, *override_normal);    // 法線マップを使用
     }
-    if(overridedTextures_[static_cast<s32>(Model::TextureType::Specular)]) {
-        SetUseTextureToShader(2, *overridedTextures_[static_cast<s32>(Model::TextureType::Specular)]);
+    if(auto* texture = textures[static_cast<s32>(Model::TextureType::Specular)]) {
+        SetUseTextureToShader(2, *texture);
     }
 
     //--------------------------------------------------
@@ -295,112 +311,98 @@ void Model::renderByFrame(s32 frame_index, ShaderVs* override_vs, ShaderPs* over
     ShaderVs* vs = override_vs ? override_vs : shader_vs_.get();
     ShaderPs* ps = override_ps ? override_ps : shader_ps_.get();
 
-    // オリジナルシェーダーを使用をONにする
-    MV1SetUseOrigShader(true);
-
     SetUseTextureToShader(11, *textureIBL_diffuse_);
     SetUseTextureToShader(12, *textureIBL_specular_);
 
-    for(s32 mesh_index = 0; mesh_index < MV1GetFrameMeshNum(mv1_handle_, frame_index);
-        ++mesh_index) {                                                      // フレームに含まれるメッシュの数
-        s32 mesh = MV1GetFrameMesh(mv1_handle_, frame_index, mesh_index);    // メッシュ番号
+    // ピクセルシェーダーはすべてのトライアングルリストで共通
+    int handle_ps = *ps;
+    DxLib::SetUsePixelShader(handle_ps);
 
-        for(s32 tlist_index = 0; tlist_index < MV1GetMeshTListNum(mv1_handle_, mesh);
-            ++tlist_index) {    // メッシュに含まれるトライアングルリストの数
-            auto tlist = MV1GetMeshTList(mv1_handle_, mesh, tlist_index);    // トライアングルリスト番号
+    auto* d3d_context = reinterpret_cast<ID3D11DeviceContext*>(const_cast<void*>(DxLib::GetUseDirect3D11DeviceContext()));
 
-            // トライアングルリストが使用しているマテリアルのインデックスを取得する
-            auto material_index = MV1GetTriangleListUseMaterial(mv1_handle_, tlist);
+    // 直前と同じ設定は省略する (-2 = 未設定)
+    int current_vs     = -2;
+    int current_normal = -2;
 
-            // 法線マップを使用しているかどうか
-            bool use_normalmap = MV1GetMaterialNormalMapTexture(mv1_handle_, material_index) != -1;
+    for(u32 i = begin; i < end; ++i) {
+        const auto& packet = draw_packets_[i];
+        const auto  tlist  = packet.tlist_;
 
-            // 法線マップを使用しない場合はNull法線を登録しておく
-            if(!use_normalmap && !override_normalmap) {
-                SetUseTextureToShader(1, *tex_null_normal_);
+        // 法線マップを使用しない場合はNull法線を登録しておく (使用する場合はモデルのテクスチャ)
+        if(!override_normal) {
+            int normal = packet.use_normalmap_ ? -1 : static_cast<int>(*tex_null_normal_);
+            if(normal != current_normal) {
+                DxLib::SetUseTextureToShader(1, normal);
+                current_normal = normal;
             }
+        }
 
-            //--------------------------------------------------
-            // シェーダーバリエーションを選択
-            //--------------------------------------------------
-            // 頂点データタイプ(DX_MV1_VERTEX_TYPE_1FRAME 等)
-            auto vertex_type = MV1GetTriangleListVertexType(mv1_handle_, tlist);
-            u32 variant_vs = vertex_type;    // DXライブラリの頂点タイプをそのままバリエーション番号に
-
-            //--------------------------------------------------
-            // トライアングルリストを描画
-            //--------------------------------------------------
-            int handle_vs = vs->variant(variant_vs);
-            int handle_ps = *ps;
-
+        //--------------------------------------------------
+        // シェーダーバリエーションを選択
+        //--------------------------------------------------
+        int handle_vs = vs->variant(packet.variant_vs_);
+        if(handle_vs != current_vs) {
             // シェーダーがない場合はオリジナルシェーダー利用を無効化
             bool shader_enable = (handle_vs != -1) && (handle_ps != -1);
             DxLib::MV1SetUseOrigShader(shader_enable);
 
             // 頂点シェーダー
             DxLib::SetUseVertexShader(handle_vs);
+            current_vs = handle_vs;
+        }
 
-            // ピクセルシェーダー
-            DxLib::SetUsePixelShader(handle_ps);
-
-            //--------------------------------------------------
-            // 速度バッファ生成のための2パス描画
-            //--------------------------------------------------
-            // StreamOutを利用して現在の頂点をバッファに出力保存
+        //--------------------------------------------------
+        // 速度バッファ生成のための2パス描画
+        //--------------------------------------------------
+        // StreamOutを利用して現在の頂点をバッファに出力保存
+        {
+            // ジオメトリシェーダーでStreamOutするための出力先を設定
+            Microsoft::WRL::ComPtr<ID3D11GeometryShader> old_shader_gs;
             {
-                auto* d3d_context =
-                    reinterpret_cast<ID3D11DeviceContext*>(const_cast<void*>(DxLib::GetUseDirect3D11DeviceContext()));
+                ID3D11Buffer* stream_out_buffer = mv1_matrix_cache_->position_buffer(tlist);
 
-                // ジオメトリシェーダーでStreamOutするための出力先を設定
-                Microsoft::WRL::ComPtr<ID3D11GeometryShader> old_shader_gs;
-                {
-                    ID3D11Buffer* stream_out_buffer = mv1_matrix_cache_->position_buffer(tlist);
-
-                    u32 offset[1] = {0};
-                    d3d_context->SOSetTargets(1, &stream_out_buffer, offset);
+                u32 offset[1] = {0};
+                d3d_context->SOSetTargets(1, &stream_out_buffer, offset);
 
-                    d3d_context->GSGetShader(&old_shader_gs, nullptr, nullptr);
-                    d3d_context->GSSetShader(d3d_shader_gs_streamout_position_.Get(), nullptr, 0);
-                }
+                d3d_context->GSGetShader(&old_shader_gs, nullptr, nullptr);
+                d3d_context->GSSetShader(d3d_shader_gs_streamout_position_.Get(), nullptr, 0);
+            }
 
-                // 描画 (StreamOut用)
-                MV1DrawTriangleList(mv1_handle_, tlist);
+            // 描画 (StreamOut用)
+            MV1DrawTriangleList(mv1_handle_, tlist);
 
-                // StreamOutをもとに戻す
-                {
-                    ID3D11Buffer* stream_out_buffer = nullptr;
-                    u32           offset[1]         = {0};
-                    d3d_context->SOSetTargets(1, &stream_out_buffer, offset);
+            // StreamOutをもとに戻す
+            {
+                ID3D11Buffer* stream_out_buffer = nullptr;
+                u32           offset[1]         = {0};
+                d3d_context->SOSetTargets(1, &stream_out_buffer, offset);
 
-                    d3d_context->GSSetShader(old_shader_gs.Get(), nullptr, 0);
-                }
+                d3d_context->GSSetShader(old_shader_gs.Get(), nullptr, 0);
             }
+        }
 
-            // (2) 1フレーム前の(1)を設定してGeometryShaderで頂点合成
-            {
-                auto* d3d_context =
-                    reinterpret_cast<ID3D11DeviceContext*>(const_cast<void*>(DxLib::GetUseDirect3D11DeviceContext()));
-                u32 slot = 0;
+        // (2) 1フレーム前の(1)を設定してGeometryShaderで頂点合成
+        {
+            u32 slot = 0;
 
-                // ジオメトリシェーダーで1フレーム前の頂点座標を合成
-                DxLib::SetUseGeometryShader(*shader_gs_composite_prev_position_);
+            // ジオメトリシェーダーで1フレーム前の頂点座標を合成
+            DxLib::SetUseGeometryShader(*shader_gs_composite_prev_position_);
 
-                // 1フレーム前のStreamOutされた頂点バッファをShaderResourceとして設定
-                Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> old_srv;
-                {
-                    ID3D11ShaderResourceView* srv = mv1_matrix_cache_->srv(tlist);
-                    d3d_context->GSGetShaderResources(slot, 1, &old_srv);
-                    d3d_context->GSSetShaderResources(slot, 1, &srv);
-                }
+            // 1フレーム前のStreamOutされた頂点バッファをShaderResourceとして設定
+            Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> old_srv;
+            {
+                ID3D11ShaderResourceView* srv = mv1_matrix_cache_->srv(tlist);
+                d3d_context->GSGetShaderResources(slot, 1, &old_srv);
+                d3d_context->GSSetShaderResources(slot, 1, &srv);
+            }
 
-                // 描画 (本来のシーン用)
-                MV1DrawTriangleList(mv1_handle_, tlist);
+            // 描画 (本来のシーン用)
+            MV1DrawTriangleList(mv1_handle_, tlist);
 
-                // もとに戻す
-                {
-                    d3d_context->GSSetShaderResources(slot, 1, &old_srv);
-                    DxLib::SetUseGeometryShader(-1);
-                }
+            // もとに戻す
+            {
+                d3d_context->GSSetShaderResources(slot, 1, &old_srv);
+                DxLib::SetUseGeometryShader(-1);
             }
         }
     }
@@ -507,7 +509,7 @@ s32 Model::frameCount() {
     // 強制的にハンドルを複製 (ブロッキングロードに切り替わる)
     on_initialize();
 
-    return MV1GetFrameNum(mv1_handle_);
+    return frame_count_;
 }
 
 //---------------------------------------------------------------------------
@@ -561,6 +563,22 @@ ResourceModel* Model::resource() const {
     return resource_model_.get();
 }
 
+//---------------------------------------------------------------------------
+//! 境界AABBを取得 (モデル空間)
+//---------------------------------------------------------------------------
+bool Model::localBounds(float3& aabb_min, float3& aabb_max) const {
+    if(!resource_model_)
+        return false;
+
+    auto* model_cache = resource_model_->modelCache();
+    if(!model_cache || !model_cache->isValid() || model_cache->vertices().empty())
+        return false;
+
+    aabb_min = model_cache->boundsMin();
+    aabb_max = model_cache->boundsMax();
+    return true;
+}
+
 //---------------------------------------------------------------------------
 //! 遅延初期化
 //---------------------------------------------------------------------------
@@ -575,6 +593,48 @@ void Model::on_initialize() {
         // 行列キャッシュを初期化
         mv1_matrix_cache_ = std::make_unique<DxLib_MV1MatrixCache>(mv1_handle_);
 
+        // 描画パケットを作成
+        buildDrawPackets();
+
         need_initialize_ = false;
     }
 }
+
+//---------------------------------------------------------------------------
+//! 描画パケットを作成
+//---------------------------------------------------------------------------
+void Model::buildDrawPackets() {
+    draw_packets_.clear();
+    frame_packet_offsets_.clear();
+
+    frame_count_ = MV1GetFrameNum(mv1_handle_);
+
+    for(s32 frame_index = 0; frame_index < frame_count_; ++frame_index) {
+        frame_packet_offsets_.push_back(static_cast<u32>(draw_packets_.size()));
+
+        // フレームに含まれるメッシュの数
+        for(s32 mesh_index = 0; mesh_index < MV1GetFrameMeshNum(mv1_handle_, frame_index); ++mesh_index) {
+            s32 mesh = MV1GetFrameMesh(mv1_handle_, frame_index, mesh_index);    // メッシュ番号
+
+            // メッシュに含まれるトライアングルリストの数
+            for(s32 tlist_index = 0; tlist_index < MV1GetMeshTListNum(mv1_handle_, mesh); ++tlist_index) {
+                DrawPacket packet;
+                packet.mesh_  = mesh;
+                packet.tlist_ = MV1GetMeshTList(mv1_handle_, mesh, tlist_index);    // トライアングルリスト番号
+
+                // トライアングルリストが使用しているマテリアルのインデックスを取得する
+                packet.material_ = MV1GetTriangleListUseMaterial(mv1_handle_, packet.tlist_);
+
+                // 法線マップを使用しているかどうか
+                packet.use_normalmap_ = MV1GetMaterialNormalMapTexture(mv1_handle_, packet.material_) != -1;
+
+                // 頂点データタイプ(DX_MV1_VERTEX_TYPE_1FRAME 等)
+                // DXライブラリの頂点タイプをそのままバリエーション番号に
+                packet.variant_vs_ = static_cast<u32>(MV1GetTriangleListVertexType(mv1_handle_, packet.tlist_));
+
+                draw_packets_.push_back(packet);
+            }
+        }
+    }
+    frame_packet_offsets_.push_back(static_cast<u32>(draw_packets_.size()));
+}
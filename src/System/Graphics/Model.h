@@ -4,6 +4,8 @@
 //---------------------------------------------------------------------------
 #pragma once
 
+#include <System/AssetRegistry.h>
+
 class ModelCache;       // 3Dモデルキャッシュ
 class ResourceModel;    // モデルリソース
 class Animation;        // アニメーション
@@ -36,6 +38,9 @@ class Model final
         CountMax,    //!< 定義個数
     };
 
+    //! 上書きするテクスチャ (TextureType順 nullptrは上書きなし)
+    using TextureOverrides = std::array<Texture*, static_cast<size_t>(TextureType::CountMax)>;
+
     //----------------------------------------------------------
     //! @name   初期化
     //----------------------------------------------------------
@@ -69,16 +74,21 @@ class Model final
     void update(f32 dt);
 
     //  描画
-    //! @param  [in]    override_vs  上書きする頂点シェーダー (nullptrで無効化)
-    //! @param  [in]    override_ps  上書きするピクセルシェーダー (nullptrで無効化)
-    void render(ShaderVs* override_vs = nullptr, ShaderPs* override_ps = nullptr);
+    //! @param  [in]    override_vs         上書きする頂点シェーダー (nullptrで無効化)
+    //! @param  [in]    override_ps         上書きするピクセルシェーダー (nullptrで無効化)
+    //! @param  [in]    override_textures   上書きするテクスチャ (nullptrの場合は overrideTexture() の設定)
+    void render(ShaderVs* override_vs = nullptr, ShaderPs* override_ps = nullptr, const TextureOverrides* override_textures = nullptr);
 
     //  フレーム番号指定で描画
-    //! @param  [in]    frame_index フレーム番号
-    //! @param  [in]    override_vs 上書きする頂点シェーダー (nullptrで無効化)
-    //! @param  [in]    override_ps 上書きするピクセルシェーダー (nullptrで無効化)
+    //! @param  [in]    frame_index         フレーム番号
+    //! @param  [in]    override_vs         上書きする頂点シェーダー (nullptrで無効化)
+    //! @param  [in]    override_ps         上書きするピクセルシェーダー (nullptrで無効化)
+    //! @param  [in]    override_textures   上書きするテクスチャ (nullptrの場合は overrideTexture() の設定)
     //! @note フレームの総数は frameCount() で取得することができます。
-    void renderByFrame(s32 frame_index, ShaderVs* override_vs = nullptr, ShaderPs* override_ps = nullptr);
+    void renderByFrame(s32                     frame_index,
+                       ShaderVs*               override_vs       = nullptr,
+                       ShaderPs*               override_ps       = nullptr,
+                       const TextureOverrides* override_textures = nullptr);
 
     //@}
     //----------------------------------------------------------
@@ -131,13 +141,36 @@ class Model final
     // モデルリソースを取得
     ResourceModel* resource() const;
 
+    // 境界AABBを取得 (モデル空間)
+    //! @param  [out]   aabb_min    最小座標
+    //! @param  [out]   aabb_max    最大座標
+    //! @retval false   モデルキャッシュが読み込まれていないため境界が分からない
+    //! @note   キャッシュの頂点はバインドポーズのためアニメーションによる変形は含みません
+    bool localBounds(float3& aabb_min, float3& aabb_max) const;
+
     //@}
    private:
     // 遅延初期化
     void on_initialize();
 
+    // 描画パケットを作成
+    void buildDrawPackets();
+
+    // 描画パケットを描画
+    void drawPackets(u32 begin, u32 end, ShaderVs* override_vs, ShaderPs* override_ps, const TextureOverrides* override_textures);
+
+    //! @brief 描画パケット (トライアングルリストごとの描画情報)
+    //! @details モデルの構造は読み込み後に変わらないため初期化時に一度だけ作成します
+    struct DrawPacket {
+        s32  mesh_          = -1;       //!< メッシュ番号
+        s32  tlist_         = -1;       //!< トライアングルリスト番号
+        s32  material_      = -1;       //!< マテリアル番号
+        u32  variant_vs_    = 0;        //!< 頂点シェーダーバリエーション (頂点タイプ)
+        bool use_normalmap_ = false;    //!< マテリアルが法線マップを持っているか
+    };
+
    private:
-    std::shared_ptr<ResourceModel>        resource_model_;                     //!< モデルリソース
+    AssetHandle<ResourceModel>            resource_model_;                     //!< モデルリソース
     std::unique_ptr<DxLib_MV1MatrixCache> mv1_matrix_cache_;                   //!< [DxLib] 行列キャッシュ
     int                                   mv1_handle_ = -1;                    //!< [DxLib] MV1モデルハンドル
     std::wstring                          path_;                               //!< ファイルパス
@@ -147,6 +180,10 @@ class Model final
 
     bool need_initialize_ = true;    //!< 初期化要求フラグ true:初期化が必要 false:初期化済または完了で不要
 
+    s32                     frame_count_ = -1;        //!< フレーム数
+    std::vector<DrawPacket> draw_packets_;            //!< 描画パケット (フレーム順)
+    std::vector<u32>        frame_packet_offsets_;    //!< フレームごとの描画パケットの開始位置 (フレーム数+1個)
+
     //! 上書きするテクスチャ
     std::array<std::shared_ptr<Texture>, static_cast<s32>(Model::TextureType::CountMax)> overridedTextures_;
 
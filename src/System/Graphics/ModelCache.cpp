@@ -1,12 +1,138 @@
 ﻿//---------------------------------------------------------------------------
 //! @file   ModelCache.cpp
-//! @brief  3Dモデルキャッシュ
+//! @brief  3Dモデルキャッシュ (キャッシュファイルの作成と読み込み)
+//! @note   MV1モデルからの抽出と描画は ModelCacheRender.cpp にあります
 //---------------------------------------------------------------------------
 #include "ModelCache.h"
+#include "Frustum.h"
 #include <filesystem>
 
 #include <meshoptimizer/src/meshoptimizer.h>
 
+namespace {
+
+//===========================================================================
+// キャッシュファイルの構造
+// すべての配列は16バイト境界に配置し、ファイルを割り当てたまま参照できるようにしています
+//
+// +-------------------+ 0
+// | CacheHeader       |
+// +-------------------+ vertex_offset_
+// | 頂点配列          |
+// +-------------------+ lods_[0].index_offset_
+// | LOD0 インデックス |
+// +-------------------+ lods_[1].index_offset_
+// | ...               |
+// +-------------------+ bvh_node_offset_
+// | BVHノード         |
+// +-------------------+ bvh_index_offset_
+// | BVHインデックス   |
+// +-------------------+ file_size_
+//===========================================================================
+
+constexpr u32 CACHE_MAGIC = 0x48434d4d;    //!< 'MMCH'
+constexpr u32 CACHE_ALIGN = 16;            //!< 配列の配置境界
+
+//! LOD情報
+struct alignas(16) CacheLod {
+    u32 index_offset_;    //!< インデックス配列の位置
+    u32 index_count_;     //!< インデックス数
+    f32 error_;           //!< 簡略化誤差
+    u32 reserved_;
+};
+
+//! ファイルヘッダー
+struct alignas(16) CacheHeader {
+    u32      magic_;                             //!< 識別子
+    u32      version_;                           //!< ファイルバージョン
+    u32      vertex_count_;                      //!< 頂点数
+    u32      lod_count_;                         //!< LOD段数
+    u64      source_size_;                       //!< 元モデルのファイルサイズ
+    u64      source_time_;                       //!< 元モデルの更新日時
+    u64      source_hash_;                       //!< 元モデルの内容のハッシュ値
+    u32      vertex_offset_;                     //!< 頂点配列の位置
+    u32      file_size_;                         //!< ファイルサイズ
+    u32      bvh_node_offset_;                   //!< BVHノード配列の位置
+    u32      bvh_node_count_;                    //!< BVHノード数
+    u32      bvh_index_offset_;                  //!< BVHインデックス配列の位置
+    u32      bvh_index_count_;                   //!< BVHインデックス数
+    CacheLod lods_[ModelCache::LOD_COUNT];       //!< LOD情報
+};
+static_assert(sizeof(CacheHeader) % CACHE_ALIGN == 0);
+
+//! 元モデルの情報
+struct SourceInfo {
+    bool exist_ = false;    //!< ファイルが存在するか (アーカイブ内の場合は存在しない扱い)
+    u64  size_  = 0;        //!< ファイルサイズ
+    u64  time_  = 0;        //!< 更新日時
+};
+
+//---------------------------------------------------------------------------
+//! 配置境界に切り上げ
+//---------------------------------------------------------------------------
+u32 alignUp(size_t offset) {
+    return static_cast<u32>((offset + CACHE_ALIGN - 1) & ~static_cast<size_t>(CACHE_ALIGN - 1));
+}
+
+//---------------------------------------------------------------------------
+//! 元モデルのサイズと更新日時を取得
+//---------------------------------------------------------------------------
+SourceInfo getSourceInfo(const std::string& path) {
+    SourceInfo info;
+
+    std::error_code error_code;
+    auto            size = std::filesystem::file_size(path, error_code);
+    if(error_code)
+        return info;
+
+    auto time = std::filesystem::last_write_time(path, error_code);
+    if(error_code)
+        return info;
+
+    info.exist_ = true;
+    info.size_  = static_cast<u64>(size);
+    info.time_  = static_cast<u64>(time.time_since_epoch().count());
+    return info;
+}
+
+//---------------------------------------------------------------------------
+//! 元モデルの内容のハッシュ値を計算 (FNV-1a 64bit)
+//---------------------------------------------------------------------------
+u64 hashSourceFile(const std::string& path) {
+    u64 hash = 0xcbf29ce484222325ull;
+
+    std::ifstream stream(path, std::ios_base::in | std::ios_base::binary);
+    if(!stream.is_open())
+        return 0;
+
+    std::array<char, 64 * 1024> buffer;
+    while(stream) {
+        stream.read(buffer.data(), buffer.size());
+        auto count = stream.gcount();
+        for(std::streamsize i = 0; i < count; ++i) {
+            hash ^= static_cast<u8>(buffer[i]);
+            hash *= 0x100000001b3ull;
+        }
+    }
+    return hash;
+}
+
+//---------------------------------------------------------------------------
+//! キャッシュファイルのヘッダーの元モデル更新日時を書き換え
+//! @note 他の内容は変えないため、ヘッダーの該当箇所だけを上書きします
+//---------------------------------------------------------------------------
+bool writeSourceTime(const std::string& path, u64 time) {
+    std::fstream stream(path, std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+    if(!stream.is_open())
+        return false;
+
+    stream.seekp(offsetof(CacheHeader, source_time_));
+    stream.write(reinterpret_cast<const char*>(&time), sizeof(time));
+    return static_cast<bool>(stream);
+}
+
+}    // namespace
+
 //---------------------------------------------------------------------------
 //! コンストラクタ
 //---------------------------------------------------------------------------
@@ -15,10 +141,11 @@ ModelCache::ModelCache(std::string_view path) {
 
     //　対応するキャッシュファイルのパスを取得
     {
-        std::array<char, 1024> temporary_path;
-        GetTempPath(static_cast<DWORD>(sizeof(temporary_path)), temporary_path.data());
+        // エラーコードを受け取ると例外を送出しない
+        std::error_code error_code;
+        auto            temporary_path = std::filesystem::temp_directory_path(error_code);
 
-        model_cache_path_ = std::string(temporary_path.data()) + "BaseProject/" + std::string(path) + ".cache";
+        model_cache_path_ = temporary_path.string() + "/BaseProject/" + std::string(path) + ".cache";
     }
 }
 
@@ -32,62 +159,22 @@ ModelCache::~ModelCache() {
     }
 
     // インデックスバッファ
-    if(handle_ib_ != -1) {
-        DeleteIndexBuffer(handle_ib_);
+    for(auto& lod: lods_) {
+        if(lod.handle_ib_ != -1) {
+            DeleteIndexBuffer(lod.handle_ib_);
+        }
     }
 }
 
 //---------------------------------------------------------------------------
-//! モデルキャッシュを保存
+//! 抽出した頂点形状から最適化してキャッシュファイルを作成
 //---------------------------------------------------------------------------
-bool ModelCache::save(int mv1_handle) const {
-    std::vector<VECTOR> varray;    // 頂点配列
-    std::vector<u32>    iarray;    // インデックス配列
-
-    // 指定のパスにモデルを保存する
-    //  MV1SaveModelToMV1FileWithStrLen(handle_, path.data(), path.size(), MV1_SAVETYPE_NORMAL);
-
-    //--------------------------------------------------------------
-    // MV1モデルから頂点形状を抽出する
-    //--------------------------------------------------------------
-    {
-        bool is_transform = true;
-        MV1SetupReferenceMesh(mv1_handle, -1, is_transform, true);    // 参照用メッシュのセットアップ
-        auto poly_list = MV1GetReferenceMesh(mv1_handle, -1, is_transform, true);    // 参照用メッシュを取得する
-
-        // 頂点インデックス配列を抽出
-        varray.resize(0);
-        for(s32 i = 0; i < poly_list.VertexNum; ++i) {
-            auto vertex = poly_list.Vertexs[i];
+bool ModelCache::build(SourceMesh mesh) const {
+    auto& varray = mesh.vertices_;    // 頂点配列
+    auto& iarray = mesh.indices_;     // インデックス配列
 
-            varray.push_back(vertex.Position);
-        }
-
-        // インデックス配列を抽出
-        iarray.resize(0);
-        for(s32 i = 0; i < poly_list.PolygonNum; ++i) {
-            auto polygon = poly_list.Polygons[i];
-
-            // 縮退三角形を検出したら破棄
-            u32 i0 = polygon.VIndex[0];
-            u32 i1 = polygon.VIndex[1];
-            u32 i2 = polygon.VIndex[2];
-
-            auto v0 = cast(varray[i0]);
-            auto v1 = cast(varray[i1]);
-            auto v2 = cast(varray[i2]);
-            auto c  = cross(v2 - v1, v0 - v1);
-            if(dot(c, c).x < 0.00001f) {
-                continue;
-            }
-
-            // 登録
-            iarray.push_back(i0);
-            iarray.push_back(i1);
-            iarray.push_back(i2);
-        }
-
-        MV1TerminateReferenceMesh(mv1_handle, -1, false, true);    // 参照用メッシュの後始末
+    if(varray.empty() || iarray.empty()) {
+        return false;
     }
 
     //----------------------------------------------------------
@@ -111,11 +198,14 @@ bool ModelCache::save(int mv1_handle) const {
     //----------------------------------------------------------
     // LOD生成
     //----------------------------------------------------------
-    constexpr u32    LOD_COUNT = 8;
     std::vector<u32> lods[LOD_COUNT];
+    f32              lod_errors[LOD_COUNT] = {};
 
     lods[0] = iarray;
 
+    // meshopt_simplify の誤差はモデルの大きさに対する相対値のため距離に換算する
+    f32 error_scale = meshopt_simplifyScale(&varray[0].x, varray.size(), sizeof(VECTOR));
+
     for(size_t i = 1; i < LOD_COUNT; ++i) {
         auto& lod = lods[i];
 
@@ -130,33 +220,55 @@ bool ModelCache::save(int mv1_handle) const {
 
         lod.resize(source.size());
 
+        f32    result_error = 0.0f;
         size_t result_size =
             meshopt_simplify(lod.data(), source.data(), source.size(), reinterpret_cast<const float*>(varray.data()),
-                             varray.size(), sizeof(VECTOR), target_index_count, target_error);
+                             varray.size(), sizeof(VECTOR), target_index_count, target_error, 0, &result_error);
 
         lod.resize(result_size);
+
+        // 誤差の上限で簡略化が止まると1段前より大きくなることがあるため、その場合は1段前をそのまま使う
+        if(lod.size() > lods[i - 1].size()) {
+            lod          = lods[i - 1];
+            result_error = 0.0f;
+        }
+
+        // 粗いLODほど誤差が大きくなるようにそろえておく (選択時に先頭から探せるように)
+        lod_errors[i] = std::max(result_error * error_scale, lod_errors[i - 1]);
     }
-    // iarray = lods[6];   // LOD6を採用
 
     //----------------------------------------------------------
     // 頂点の最適化
     //----------------------------------------------------------
-    // [meshoptimizer] 頂点キャッシュ最適化
-    meshopt_optimizeVertexCache(iarray.data(), iarray.data(), iarray.size(), varray.size());
+    for(auto& lod: lods) {
+        // [meshoptimizer] 頂点キャッシュ最適化
+        meshopt_optimizeVertexCache(lod.data(), lod.data(), lod.size(), varray.size());
 
-    // [meshoptimizer] オーバードロー最適化
-    meshopt_optimizeOverdraw(iarray.data(), iarray.data(), iarray.size(), &varray[0].x, varray.size(), sizeof(VECTOR), 1.0f);
+        // [meshoptimizer] オーバードロー最適化
+        meshopt_optimizeOverdraw(lod.data(), lod.data(), lod.size(), &varray[0].x, varray.size(), sizeof(VECTOR), 1.0f);
+    }
 
     // [meshoptimizer] 頂点フェッチ最適化
-    meshopt_optimizeVertexFetch(varray.data(), iarray.data(), iarray.size(), varray.data(), varray.size(), sizeof(VECTOR));
+    // 全LODで頂点配列を共有するため、LOD0の順序で並べ替えて全LODのインデックスをつけ直す
+    {
+        std::vector<u32> remap(varray.size());
+        size_t           unique_vertex_count =
+            meshopt_optimizeVertexFetchRemap(remap.data(), lods[0].data(), lods[0].size(), varray.size());
+
+        for(auto& lod: lods) {
+            meshopt_remapIndexBuffer(lod.data(), lod.data(), lod.size(), remap.data());
+        }
+        meshopt_remapVertexBuffer(varray.data(), varray.data(), varray.size(), sizeof(VECTOR), remap.data());
+        varray.resize(unique_vertex_count);
+    }
 
     //----------------------------------------------------------
     // 縮退三角形の存在チェック
     //----------------------------------------------------------
-    for(u32 i = 0; i < iarray.size(); i += 3) {
-        auto i0 = iarray[i + 0];
-        auto i1 = iarray[i + 1];
-        auto i2 = iarray[i + 2];
+    for(u32 i = 0; i < lods[0].size(); i += 3) {
+        auto i0 = lods[0][i + 0];
+        auto i1 = lods[0][i + 1];
+        auto i2 = lods[0][i + 2];
         auto v0 = cast(varray[i0]);
         auto v1 = cast(varray[i1]);
         auto v2 = cast(varray[i2]);
@@ -164,6 +276,11 @@ bool ModelCache::save(int mv1_handle) const {
         assert(dot(c, c).x > 0.00001f && "縮退ポリゴンが検出されました.");
     }
 
+    //----------------------------------------------------------
+    // 当たり判定用のBVHを構築 (LOD0)
+    //----------------------------------------------------------
+    auto bvh = CollisionMeshBVH::build(varray, lods[0]);
+
     //----------------------------------------------------------
     // ディレクトリを作成
     //----------------------------------------------------------
@@ -177,29 +294,80 @@ bool ModelCache::save(int mv1_handle) const {
     }
 
     //----------------------------------------------------------
-    // 保存
+    // ヘッダーと配置を決める
     //----------------------------------------------------------
-    std::string   file_path(model_cache_path_);    // null終端文字列に変換
-    std::ofstream stream(file_path.c_str(), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
-    if(!stream.is_open()) {
-        return false;
+    CacheHeader header{};
+    header.magic_        = CACHE_MAGIC;
+    header.version_      = ModelCache::VERSION;
+    header.vertex_count_ = static_cast<u32>(varray.size());
+    header.lod_count_    = LOD_COUNT;
+
+    // 元モデルが更新されたときに作り直せるように情報を記録しておく
+    auto source         = getSourceInfo(model_path_);
+    header.source_size_ = source.size_;
+    header.source_time_ = source.time_;
+    header.source_hash_ = source.exist_ ? hashSourceFile(model_path_) : 0;
+
+    u32 offset            = alignUp(sizeof(CacheHeader));
+    header.vertex_offset_ = offset;
+    offset                = alignUp(offset + varray.size() * sizeof(VECTOR));
+
+    for(u32 i = 0; i < LOD_COUNT; ++i) {
+        header.lods_[i].index_offset_ = offset;
+        header.lods_[i].index_count_  = static_cast<u32>(lods[i].size());
+        header.lods_[i].error_        = lod_errors[i];
+        offset                        = alignUp(offset + lods[i].size() * sizeof(u32));
     }
 
-    // ファイルバージョン
-    u32 file_version = ModelCache::VERSION;
-    stream.write(reinterpret_cast<char*>(&file_version), sizeof(file_version));
+    header.bvh_node_offset_  = offset;
+    header.bvh_node_count_   = static_cast<u32>(bvh.nodes_.size());
+    offset                   = alignUp(offset + bvh.nodes_.size() * sizeof(CollisionMeshBVH::Node));
+    header.bvh_index_offset_ = offset;
+    header.bvh_index_count_  = static_cast<u32>(bvh.indices_.size());
+    offset                   = alignUp(offset + bvh.indices_.size() * sizeof(u32));
+
+    header.file_size_ = offset;
+
+    //----------------------------------------------------------
+    // イメージを作成して一括で書き込む
+    //----------------------------------------------------------
+    std::vector<std::byte> image(header.file_size_);
+    memcpy(image.data(), &header, sizeof(header));
+    memcpy(image.data() + header.vertex_offset_, varray.data(), varray.size() * sizeof(VECTOR));
+    for(u32 i = 0; i < LOD_COUNT; ++i) {
+        memcpy(image.data() + header.lods_[i].index_offset_, lods[i].data(), lods[i].size() * sizeof(u32));
+    }
+    memcpy(image.data() + header.bvh_node_offset_, bvh.nodes_.data(), bvh.nodes_.size() * sizeof(CollisionMeshBVH::Node));
+    memcpy(image.data() + header.bvh_index_offset_, bvh.indices_.data(), bvh.indices_.size() * sizeof(u32));
 
-    u32 vertex_count = static_cast<u32>(varray.size());    // 頂点数
-    u32 index_count  = static_cast<u32>(iarray.size());    // インデックス数
-    stream.write(reinterpret_cast<char*>(&vertex_count), sizeof(vertex_count));
-    stream.write(reinterpret_cast<char*>(&index_count), sizeof(index_count));
+    //----------------------------------------------------------
+    // 保存
+    // 書き込み途中で中断されたファイルを残さないように一時ファイルに書いてから置き換える
+    //----------------------------------------------------------
+    std::filesystem::path file_path(model_cache_path_);
+    auto                  temporary_path = file_path;
+    temporary_path += ".tmp";
 
-    // 頂点配列
-    stream.write(reinterpret_cast<char*>(varray.data()), vertex_count * sizeof(VECTOR));
+    std::error_code error_code;
+    {
+        std::ofstream stream(temporary_path, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+        if(!stream.is_open()) {
+            return false;
+        }
 
-    // インデックス配列
-    stream.write(reinterpret_cast<char*>(iarray.data()), index_count * sizeof(u32));
+        stream.write(reinterpret_cast<const char*>(image.data()), image.size());
+        if(!stream) {
+            stream.close();
+            std::filesystem::remove(temporary_path, error_code);
+            return false;
+        }
+    }
 
+    std::filesystem::rename(temporary_path, file_path, error_code);
+    if(error_code) {
+        std::filesystem::remove(temporary_path, error_code);
+        return false;
+    }
     return true;
 }
 
@@ -207,155 +375,210 @@ bool ModelCache::save(int mv1_handle) const {
 //! モデルキャッシュを読み込み
 //---------------------------------------------------------------------------
 bool ModelCache::load() {
-    // ロードされたバイナリー
-    std::vector<std::byte> binary;
+    if(isValid()) {
+        return true;
+    }
+
+    // キャッシュが古い/壊れていた場合は削除して作り直す
+    auto remove_cache = [&]() {
+        lods_.clear();
+        vertices_ = {};
+        bvh_.reset();
+        mapped_file_.close();
+
+        // エラーコードを受け取ると例外を送出しない
+        std::error_code error_code;
+        std::filesystem::remove(model_cache_path_, error_code);
+        return false;
+    };
 
     //----------------------------------------------------------
-    // キャッシュファイルを読み込み
+    // キャッシュファイルを割り当て (コピーせずにそのまま参照する)
     //----------------------------------------------------------
-    {
-        auto handle = FileRead_fullyLoad_WithStrLen(model_cache_path_.data(), model_cache_path_.size());
-        if(handle == -1) {
-            return false;
+    if(!mapped_file_.open(model_cache_path_)) {
+        // 空のファイル (書き込み途中で中断されたもの) は割り当てられないためここで削除する
+        std::error_code error_code;
+        if(std::filesystem::file_size(model_cache_path_, error_code) == 0 && !error_code) {
+            return remove_cache();
         }
-        auto* p    = FileRead_fullyLoad_getImage(handle);
-        auto  size = FileRead_fullyLoad_getSize(handle);
-
-        binary.resize(size);
-        memcpy(binary.data(), p, size);
-
-        // 一時領域を解放
-        FileRead_fullyLoad_delete(handle);
+        return false;
     }
 
+    const std::byte* base = mapped_file_.data();
+    size_t           size = mapped_file_.size();
+
     //----------------------------------------------------------
-    // メモリ領域から取り出し
+    // ヘッダーの検証
     //----------------------------------------------------------
-    {
-        uintptr_t p = reinterpret_cast<uintptr_t>(binary.data());
+    if(size < sizeof(CacheHeader)) {
+        return remove_cache();
+    }
+    // 元モデルの日時を更新するために割り当てなおす場合があるため、ヘッダーはコピーしておく
+    CacheHeader header;
+    memcpy(&header, base, sizeof(header));
 
-        // ファイルバージョン
-        u32 version = *reinterpret_cast<u32*>(p);
-        p += sizeof(u32);
+    // ファイルバージョンが異なっていた場合はキャッシュクリア
+    if(header.magic_ != CACHE_MAGIC || header.version_ != ModelCache::VERSION || header.file_size_ != size) {
+        return remove_cache();
+    }
 
-        // ファイルバージョンが異なっていた場合はキャッシュクリア
-        if(version != ModelCache::VERSION) {
-            // エラーコードを受け取ると例外を送出しない
-            std::error_code error_code;
-            std::filesystem::remove(model_cache_path_, error_code);
-            return false;
-        }
+    if(header.lod_count_ == 0 || header.lod_count_ > LOD_COUNT) {
+        return remove_cache();
+    }
 
-        u32 vertex_count = *reinterpret_cast<u32*>(p);
-        u32 index_count  = *reinterpret_cast<u32*>(p + sizeof(u32));
-        p += sizeof(u32) * 2;
+    // 配列が境界に沿ってファイル内に収まっているか
+    auto is_valid_range = [&](u32 offset, size_t bytes) {
+        return (offset % CACHE_ALIGN) == 0 && offset >= sizeof(CacheHeader) && offset + bytes <= size;
+    };
+
+    if(!is_valid_range(header.vertex_offset_, sizeof(VECTOR) * header.vertex_count_)) {
+        return remove_cache();
+    }
+    for(u32 i = 0; i < header.lod_count_; ++i) {
+        if(!is_valid_range(header.lods_[i].index_offset_, sizeof(u32) * header.lods_[i].index_count_)) {
+            return remove_cache();
+        }
+    }
+    if(!is_valid_range(header.bvh_node_offset_, sizeof(CollisionMeshBVH::Node) * header.bvh_node_count_) ||
+       !is_valid_range(header.bvh_index_offset_, sizeof(u32) * header.bvh_index_count_)) {
+        return remove_cache();
+    }
 
-        // 頂点配列
-        vertices_.resize(vertex_count);
-        memcpy(vertices_.data(), reinterpret_cast<void*>(p), sizeof(VECTOR) * vertex_count);
-        p += sizeof(VECTOR) * vertex_count;
+    //----------------------------------------------------------
+    // 元モデルとの一致を確認
+    // サイズと更新日時が一致すれば有効。日時のみ異なる場合は内容のハッシュ値で比較する
+    //----------------------------------------------------------
+    if(auto source = getSourceInfo(model_path_); source.exist_) {
+        if(source.size_ != header.source_size_) {
+            return remove_cache();
+        }
+        if(source.time_ != header.source_time_) {
+            if(hashSourceFile(model_path_) != header.source_hash_) {
+                return remove_cache();
+            }
 
-        // インデックス配列
-        indices_.resize(index_count);
-        memcpy(indices_.data(), reinterpret_cast<void*>(p), sizeof(u32) * index_count);
-        p += sizeof(u32) * index_count;
+            // 内容は同じなので日時だけ書き換え、次回からハッシュ値の計算を省く (失敗しても次回また比較するだけ)
+            // 割り当て中は書き込めない (Windows) ため、一度閉じてから割り当てなおす
+            mapped_file_.close();
+            writeSourceTime(model_cache_path_, source.time_);
+            if(!mapped_file_.open(model_cache_path_) || mapped_file_.size() != size) {
+                return remove_cache();
+            }
+            base = mapped_file_.data();
+        }
     }
 
     //----------------------------------------------------------
-    // 頂点バッファとインデックスバッファを作成
+    // 割り当てた領域を直接参照
     //----------------------------------------------------------
-    {
-        // DXライブラリ形式の頂点データーを一時的に作成
-        std::vector<VERTEX3D> varray;
-        std::vector<u32>      iarray;
+    vertices_ = {reinterpret_cast<const VECTOR*>(base + header.vertex_offset_), header.vertex_count_};
+
+    lods_.resize(header.lod_count_);
+    for(u32 i = 0; i < header.lod_count_; ++i) {
+        auto& lod    = lods_[i];
+        lod.indices_ = {reinterpret_cast<const u32*>(base + header.lods_[i].index_offset_), header.lods_[i].index_count_};
+        lod.error_   = header.lods_[i].error_;
+    }
 
-        for(DxLib::VECTOR& position: vertices_) {
-            VERTEX3D v{};
+    std::span<const CollisionMeshBVH::Node> bvh_nodes = {
+        reinterpret_cast<const CollisionMeshBVH::Node*>(base + header.bvh_node_offset_), header.bvh_node_count_};
+    std::span<const u32> bvh_indices = {reinterpret_cast<const u32*>(base + header.bvh_index_offset_), header.bvh_index_count_};
 
-            v.pos = position;
-            v.dif = GetColorU8(255, 255, 0, 255);
+    // 壊れたBVHで範囲外を参照しないように、子/葉/頂点の番号を確認してから公開する
+    if(!CollisionMeshBVH::validate(vertices_.size(), bvh_nodes, bvh_indices)) {
+        return remove_cache();
+    }
+    bvh_.attach(vertices_, bvh_nodes, bvh_indices);
 
-            varray.emplace_back(std::move(v));
-        }
-        for(u32 i = 0; i < indices_.size(); i += 3) {
-            u32 a = indices_[i + 0];
-            u32 b = indices_[i + 1];
-            u32 c = indices_[i + 2];
-
-            // ワイヤーフレーム描画にするために三角形abcインデックスを a-b, b-c, c-a という順に接続する
-            iarray.push_back(a);
-            iarray.push_back(b);
-            iarray.push_back(b);
-            iarray.push_back(c);
-            iarray.push_back(c);
-            iarray.push_back(a);
+    //----------------------------------------------------------
+    // 境界AABBと境界球 (視錐台カリングとLOD選択の距離計算用)
+    //----------------------------------------------------------
+    if(!vertices_.empty()) {
+        float3 aabb_min = cast(vertices_[0]);
+        float3 aabb_max = aabb_min;
+        for(auto& v: vertices_) {
+            aabb_min = min(aabb_min, cast(v));
+            aabb_max = max(aabb_max, cast(v));
         }
 
-        // 頂点バッファとインデックスバッファを作成
-        handle_vb_ = CreateVertexBuffer(static_cast<s32>(varray.size()), DX_VERTEX_TYPE_NORMAL_3D);
-        handle_ib_ = CreateIndexBuffer(static_cast<s32>(iarray.size()), DX_INDEX_TYPE_32BIT);
-
-        // バッファにデーターを転送
-        SetVertexBufferData(0, varray.data(), static_cast<s32>(varray.size()), handle_vb_);
-        SetIndexBufferData(0, iarray.data(), static_cast<s32>(iarray.size()), handle_ib_);
+        aabb_min_      = aabb_min;
+        aabb_max_      = aabb_max;
+        bounds_center_ = (aabb_min + aabb_max) * 0.5f;
+        bounds_radius_ = length(aabb_max - aabb_min) * 0.5f;
     }
 
-    is_valid_ = true;
+    // 最後に公開する (頂点バッファは描画スレッドで初回描画時に作成)
+    is_valid_.store(true, std::memory_order_release);
     return true;
 }
 
 //---------------------------------------------------------------------------
 //! 頂点配列を取得
 //---------------------------------------------------------------------------
-const std::vector<VECTOR>& ModelCache::vertices() const {
+std::span<const VECTOR> ModelCache::vertices() const {
     return vertices_;
 }
 
 //---------------------------------------------------------------------------
 //! インデックス配列を取得
 //---------------------------------------------------------------------------
-const std::vector<u32>& ModelCache::indices() const {
-    return indices_;
+std::span<const u32> ModelCache::indices(u32 lod) const {
+    if(lods_.empty())
+        return {};
+
+    return lods_[std::min(lod, lodCount() - 1)].indices_;
 }
 
 //---------------------------------------------------------------------------
-// 初期化が正しく成功しているかどうか
+//! 当たり判定用のBVHを取得
 //---------------------------------------------------------------------------
-bool ModelCache::isValid() const {
-    return is_valid_;
+const CollisionMeshBVH& ModelCache::collisionMesh() const {
+    return bvh_;
 }
 
 //---------------------------------------------------------------------------
-//! 描画
+//! LOD段数を取得
 //---------------------------------------------------------------------------
-void ModelCache::render(const matrix& mat_world) const {
-    // ワールド行列を設定
-    MATRIX matrix = cast(mat_world);
-    SetTransformToWorld(&matrix);
+u32 ModelCache::lodCount() const {
+    return static_cast<u32>(lods_.size());
+}
 
-    //----------------------------------------------------------
-    // ジオメトリを描画
-    // 頂点バッファの利用でCPU負荷を大幅に削減できる
-    //----------------------------------------------------------
-    if constexpr(false) {    // デバッグ描画を利用した描画
+//---------------------------------------------------------------------------
+//! LODの簡略化誤差を取得
+//---------------------------------------------------------------------------
+f32 ModelCache::lodError(u32 lod) const {
+    if(lod >= lodCount())
+        return 0.0f;
 
-        for(size_t i = 0; i < indices_.size(); i += 3) {
-            auto i0 = indices_[i + 0];
-            auto i1 = indices_[i + 1];
-            auto i2 = indices_[i + 2];
+    return lods_[lod].error_;
+}
 
-            DrawTriangle3D(vertices_[i0], vertices_[i1], vertices_[i2], GetColor(255, 255, 0), false);
-        }
-    } else {    // 頂点バッファを利用した描画
+//---------------------------------------------------------------------------
+//! 境界AABBの最小座標を取得
+//---------------------------------------------------------------------------
+float3 ModelCache::boundsMin() const {
+    return aabb_min_;
+}
 
-        SetUseLighting(false);    // 照明OFF
-        DrawPrimitiveIndexed3D_UseVertexBuffer(handle_vb_, handle_ib_, DX_PRIMTYPE_LINELIST, DX_NONE_GRAPH, false);
-        SetUseLighting(true);
-    }
+//---------------------------------------------------------------------------
+//! 境界AABBの最大座標を取得
+//---------------------------------------------------------------------------
+float3 ModelCache::boundsMax() const {
+    return aabb_max_;
+}
+
+//---------------------------------------------------------------------------
+// 初期化が正しく成功しているかどうか
+//---------------------------------------------------------------------------
+bool ModelCache::isValid() const {
+    return is_valid_.load(std::memory_order_acquire);
+}
 
-    // 単位行列を設定して元に戻す
-    MATRIX mat_identity = MGetIdent();
-    SetTransformToWorld(&mat_identity);
+//---------------------------------------------------------------------------
+//! キャッシュファイルのパスを取得
+//---------------------------------------------------------------------------
+const std::string& ModelCache::cachePath() const {
+    return model_cache_path_;
 }
 
 //---------------------------------------------------------------------------
@@ -364,3 +587,56 @@ void ModelCache::render(const matrix& mat_world) const {
 bool ModelCache::isExist() const {
     return std::filesystem::exists(model_cache_path_);
 }
+
+//---------------------------------------------------------------------------
+//! 画面上の誤差からLODを選択
+//---------------------------------------------------------------------------
+u32 ModelCache::selectLod(const matrix& mat_world, const Frustum& frustum, u32 resolution_height,
+                          f32 max_pixel_error) const {
+    if(lodCount() <= 1)
+        return 0;
+
+    // 拡大縮小されている場合は誤差も同じだけ拡大される
+    f32 sx    = length(mat_world.axisX());
+    f32 sy    = length(mat_world.axisY());
+    f32 sz    = length(mat_world.axisZ());
+    f32 scale = std::max({sx, sy, sz});
+
+    // カメラから境界球表面までの距離
+    float3 center   = mul(float4(bounds_center_, 1.0f), mat_world).xyz;
+    f32    distance = length(center - frustum.position());
+    distance        = std::max(distance - bounds_radius_ * scale, frustum.nearZ());
+
+    // 距離1あたりの画面上のピクセル数
+    f32 pixels_per_unit = frustum.screenDistance(resolution_height) * scale / distance;
+
+    // 許容誤差に収まる最も粗いLODを選ぶ (誤差は粗いほど大きい)
+    u32 lod = 0;
+    for(u32 i = 1; i < lodCount(); ++i) {
+        if(lods_[i].error_ * pixels_per_unit > max_pixel_error)
+            break;
+        lod = i;
+    }
+    return lod;
+}
+
+//---------------------------------------------------------------------------
+//! 許容誤差からLODを選択
+//---------------------------------------------------------------------------
+u32 ModelCache::selectLodByError(f32 max_error) const {
+    u32 lod = 0;
+    for(u32 i = 1; i < lodCount(); ++i) {
+        if(lods_[i].error_ > max_error)
+            break;
+        lod = i;
+    }
+    return lod;
+}
+
+//---------------------------------------------------------------------------
+//! LOD選択に使用するカメラを設定
+//---------------------------------------------------------------------------
+void ModelCache::setLodView(const Frustum* frustum, u32 resolution_height) {
+    lod_frustum_           = frustum;
+    lod_resolution_height_ = resolution_height;
+}
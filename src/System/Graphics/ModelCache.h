@@ -4,13 +4,24 @@
 //---------------------------------------------------------------------------
 #pragma once
 
+#include <System/Utils/MappedFile.h>
+#include <System/CollisionMeshBVH.h>
+
+#include <atomic>
+#include <span>
+
+class Frustum;
+
 //===========================================================================
 //! 3Dモデルキャッシュ
 //===========================================================================
 class ModelCache {
    public:
     //! モデルキャッシュのバージョン
-    static constexpr u32 VERSION = 2;
+    static constexpr u32 VERSION = 5;
+
+    //! LOD段数
+    static constexpr u32 LOD_COUNT = 8;
 
     //----------------------------------------------------------
     //! @name   初期化
@@ -24,17 +35,51 @@ class ModelCache {
     //  デストラクタ
     virtual ~ModelCache();
 
-    //  モデルキャッシュを保存
+    //! 抽出した頂点形状
+    struct SourceMesh {
+        std::vector<VECTOR> vertices_;    //!< 頂点配列
+        std::vector<u32>    indices_;     //!< インデックス配列
+    };
+
+    //  モデルキャッシュを保存 (extract() + build())
     bool save(int mv1_handle) const;
 
+    //  MV1モデルから頂点形状を抽出
+    //! @note   DxLibの参照用メッシュを使用するためモデルの読み込みスレッドで呼んでください
+    static SourceMesh extract(int mv1_handle);
+
+    //  抽出した頂点形状から最適化してキャッシュファイルを作成
+    //! @note   DxLibを使用しないためワーカースレッドで実行できます
+    bool build(SourceMesh mesh) const;
+
     //  モデルキャッシュへ読み込み
+    //! @note   DxLibを使用しないためワーカースレッドで実行できます
     bool load();
 
     //! 頂点配列を取得
-    const std::vector<VECTOR>& vertices() const;
+    //! @note   キャッシュファイルを割り当てた領域を直接参照しています
+    std::span<const VECTOR> vertices() const;
 
     //! インデックス配列を取得
-    const std::vector<u32>& indices() const;
+    //! @param  [in]    lod     LOD番号 (0が最も詳細)
+    //! @note   キャッシュファイルを割り当てた領域を直接参照しています
+    std::span<const u32> indices(u32 lod = 0) const;
+
+    //! 当たり判定用のBVHを取得 (LOD0の三角形)
+    //! @note   キャッシュファイルを割り当てた領域を直接参照しています
+    const CollisionMeshBVH& collisionMesh() const;
+
+    //! LOD段数を取得
+    u32 lodCount() const;
+
+    //! LODの簡略化誤差を取得 (モデル空間の距離)
+    f32 lodError(u32 lod) const;
+
+    //! 境界AABBの最小座標を取得 (モデル空間)
+    float3 boundsMin() const;
+
+    //! 境界AABBの最大座標を取得 (モデル空間)
+    float3 boundsMax() const;
 
     // 初期化が正しく成功しているかどうか
     bool isValid() const;
@@ -47,20 +92,60 @@ class ModelCache {
 
     //  描画
     //! @param  [in]    mat_world   ワールド行列
-    void render(const matrix& mat_world) const;
+    //! @note   setLodView()で設定されたカメラから画面上の誤差でLODを選択します
+    void render(const matrix& mat_world);
+
+    //  画面上の誤差からLODを選択
+    //! @param  [in]    mat_world           ワールド行列
+    //! @param  [in]    frustum             カメラの視錐台
+    //! @param  [in]    resolution_height   画面解像度の高さ
+    //! @param  [in]    max_pixel_error     許容する画面上の誤差(ピクセル)
+    //! @return LOD番号
+    u32 selectLod(const matrix& mat_world, const Frustum& frustum, u32 resolution_height, f32 max_pixel_error = 1.0f) const;
+
+    //  許容誤差からLODを選択 (当たり判定用)
+    //! @param  [in]    max_error   許容する簡略化誤差 (モデル空間の距離)
+    //! @return LOD番号
+    u32 selectLodByError(f32 max_error) const;
+
+    //  LOD選択に使用するカメラを設定
+    //! @param  [in]    frustum             カメラの視錐台 (nullptrでLOD0固定)
+    //! @param  [in]    resolution_height   画面解像度の高さ
+    static void setLodView(const Frustum* frustum, u32 resolution_height);
+
+    //! キャッシュファイルのパスを取得
+    const std::string& cachePath() const;
 
     //  キャッシュファイルが存在するかチェック
-    //! @param  [in]    model_path    モデルファイルパス
+    //! @note   元モデルとの一致は load() で検証され、古いキャッシュは削除されます
     bool isExist() const;
 
     //@}
 
    private:
-    bool                is_valid_ = false;    //!< 初期化が正しく成功しているかどうか
-    std::string         model_path_;          //!< モデルのファイルパス
-    std::string         model_cache_path_;    //!< モデルキャッシュのファイルパス
-    std::vector<VECTOR> vertices_;            //!< 頂点配列
-    std::vector<u32>    indices_;             //!< インデックス配列
-    int                 handle_vb_ = -1;      //!< [DxLib] 頂点バッファハンドル
-    int                 handle_ib_ = -1;      //!< [DxLib] インデックスバッファハンドル
+    //  頂点バッファとインデックスバッファを作成
+    void setupBuffers();
+
+    //! LOD
+    struct Lod {
+        std::span<const u32> indices_;            //!< インデックス配列 (キャッシュファイル内)
+        f32                  error_     = 0.0f;    //!< 簡略化誤差 (モデル空間の距離)
+        int                  handle_ib_ = -1;      //!< [DxLib] インデックスバッファハンドル
+    };
+
+    std::atomic<bool>       is_valid_      = false;                 //!< 初期化が正しく成功しているかどうか
+    std::string             model_path_;                            //!< モデルのファイルパス
+    std::string             model_cache_path_;                      //!< モデルキャッシュのファイルパス
+    MappedFile              mapped_file_;                           //!< 割り当てたキャッシュファイル
+    std::span<const VECTOR> vertices_;                              //!< 頂点配列 (キャッシュファイル内)
+    std::vector<Lod>        lods_;                                  //!< LOD (0が最も詳細)
+    CollisionMeshBVH        bvh_;                                   //!< 当たり判定用のBVH (キャッシュファイル内)
+    float3                  aabb_min_      = {0.0f, 0.0f, 0.0f};    //!< 境界AABBの最小座標 (モデル空間)
+    float3                  aabb_max_      = {0.0f, 0.0f, 0.0f};    //!< 境界AABBの最大座標 (モデル空間)
+    float3                  bounds_center_ = {0.0f, 0.0f, 0.0f};    //!< 境界球の中心 (モデル空間)
+    f32                     bounds_radius_ = 0.0f;                  //!< 境界球の半径 (モデル空間)
+    int                     handle_vb_     = -1;                    //!< [DxLib] 頂点バッファハンドル
+
+    static inline const Frustum* lod_frustum_           = nullptr;    //!< LOD選択用のカメラ
+    static inline u32            lod_resolution_height_ = 0;          //!< LOD選択用の画面解像度の高さ
 };
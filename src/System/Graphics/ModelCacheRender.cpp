@@ -0,0 +1,167 @@
+﻿//---------------------------------------------------------------------------
+//! @file   ModelCacheRender.cpp
+//! @brief  3Dモデルキャッシュ (DxLibを使用する抽出と描画)
+//---------------------------------------------------------------------------
+#include "ModelCache.h"
+
+//---------------------------------------------------------------------------
+//! モデルキャッシュを保存
+//---------------------------------------------------------------------------
+bool ModelCache::save(int mv1_handle) const {
+    return build(extract(mv1_handle));
+}
+
+//---------------------------------------------------------------------------
+//! MV1モデルから頂点形状を抽出
+//---------------------------------------------------------------------------
+ModelCache::SourceMesh ModelCache::extract(int mv1_handle) {
+    SourceMesh mesh;
+
+    auto& varray = mesh.vertices_;    // 頂点配列
+    auto& iarray = mesh.indices_;     // インデックス配列
+
+    // 指定のパスにモデルを保存する
+    //  MV1SaveModelToMV1FileWithStrLen(handle_, path.data(), path.size(), MV1_SAVETYPE_NORMAL);
+
+    //--------------------------------------------------------------
+    // MV1モデルから頂点形状を抽出する
+    //--------------------------------------------------------------
+    {
+        bool is_transform = true;
+        MV1SetupReferenceMesh(mv1_handle, -1, is_transform, true);    // 参照用メッシュのセットアップ
+        auto poly_list = MV1GetReferenceMesh(mv1_handle, -1, is_transform, true);    // 参照用メッシュを取得する
+
+        // 頂点インデックス配列を抽出
+        varray.resize(0);
+        for(s32 i = 0; i < poly_list.VertexNum; ++i) {
+            auto vertex = poly_list.Vertexs[i];
+
+            varray.push_back(vertex.Position);
+        }
+
+        // インデックス配列を抽出
+        iarray.resize(0);
+        for(s32 i = 0; i < poly_list.PolygonNum; ++i) {
+            auto polygon = poly_list.Polygons[i];
+
+            // 縮退三角形を検出したら破棄
+            u32 i0 = polygon.VIndex[0];
+            u32 i1 = polygon.VIndex[1];
+            u32 i2 = polygon.VIndex[2];
+
+            auto v0 = cast(varray[i0]);
+            auto v1 = cast(varray[i1]);
+            auto v2 = cast(varray[i2]);
+            auto c  = cross(v2 - v1, v0 - v1);
+            if(dot(c, c).x < 0.00001f) {
+                continue;
+            }
+
+            // 登録
+            iarray.push_back(i0);
+            iarray.push_back(i1);
+            iarray.push_back(i2);
+        }
+
+        MV1TerminateReferenceMesh(mv1_handle, -1, false, true);    // 参照用メッシュの後始末
+    }
+
+    return mesh;
+}
+
+//---------------------------------------------------------------------------
+//! 頂点バッファとインデックスバッファを作成
+//---------------------------------------------------------------------------
+void ModelCache::setupBuffers() {
+    if(handle_vb_ != -1) {
+        return;
+    }
+
+    // DXライブラリ形式の頂点データーを一時的に作成
+    std::vector<VERTEX3D> varray;
+    std::vector<u32>      iarray;
+
+    for(const DxLib::VECTOR& position: vertices_) {
+        VERTEX3D v{};
+
+        v.pos = position;
+        v.dif = GetColorU8(255, 255, 0, 255);
+
+        varray.emplace_back(std::move(v));
+    }
+
+    // 頂点バッファを作成 (全LODで共有)
+    handle_vb_ = CreateVertexBuffer(static_cast<s32>(varray.size()), DX_VERTEX_TYPE_NORMAL_3D);
+    SetVertexBufferData(0, varray.data(), static_cast<s32>(varray.size()), handle_vb_);
+
+    for(auto& lod: lods_) {
+        auto& indices = lod.indices_;
+
+        iarray.clear();
+        for(u32 i = 0; i < indices.size(); i += 3) {
+            u32 a = indices[i + 0];
+            u32 b = indices[i + 1];
+            u32 c = indices[i + 2];
+
+            // ワイヤーフレーム描画にするために三角形abcインデックスを a-b, b-c, c-a という順に接続する
+            iarray.push_back(a);
+            iarray.push_back(b);
+            iarray.push_back(b);
+            iarray.push_back(c);
+            iarray.push_back(c);
+            iarray.push_back(a);
+        }
+        if(iarray.empty())
+            continue;
+
+        // インデックスバッファを作成
+        lod.handle_ib_ = CreateIndexBuffer(static_cast<s32>(iarray.size()), DX_INDEX_TYPE_32BIT);
+        SetIndexBufferData(0, iarray.data(), static_cast<s32>(iarray.size()), lod.handle_ib_);
+    }
+}
+
+//---------------------------------------------------------------------------
+//! 描画
+//---------------------------------------------------------------------------
+void ModelCache::render(const matrix& mat_world) {
+    // 生成中のキャッシュは描画しない
+    if(!isValid()) {
+        return;
+    }
+    setupBuffers();
+
+    // ワールド行列を設定
+    MATRIX matrix = cast(mat_world);
+    SetTransformToWorld(&matrix);
+
+    //----------------------------------------------------------
+    // ジオメトリを描画
+    // 頂点バッファの利用でCPU負荷を大幅に削減できる
+    //----------------------------------------------------------
+    // 離れている場合は粗いLODを使う
+    u32 lod = 0;
+    if(lod_frustum_) {
+        lod = selectLod(mat_world, *lod_frustum_, lod_resolution_height_);
+    }
+
+    if constexpr(false) {    // デバッグ描画を利用した描画
+        auto& indices = this->indices(lod);
+
+        for(size_t i = 0; i < indices.size(); i += 3) {
+            auto i0 = indices[i + 0];
+            auto i1 = indices[i + 1];
+            auto i2 = indices[i + 2];
+
+            DrawTriangle3D(vertices_[i0], vertices_[i1], vertices_[i2], GetColor(255, 255, 0), false);
+        }
+    } else if(lod < lodCount() && lods_[lod].handle_ib_ != -1) {    // 頂点バッファを利用した描画
+
+        SetUseLighting(false);    // 照明OFF
+        DrawPrimitiveIndexed3D_UseVertexBuffer(handle_vb_, lods_[lod].handle_ib_, DX_PRIMTYPE_LINELIST, DX_NONE_GRAPH, false);
+        SetUseLighting(true);
+    }
+
+    // 単位行列を設定して元に戻す
+    MATRIX mat_identity = MGetIdent();
+    SetTransformToWorld(&mat_identity);
+}
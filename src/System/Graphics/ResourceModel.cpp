@@ -4,6 +4,10 @@
 //---------------------------------------------------------------------------
 #include "ResourceModel.h"
 #include "ModelCache.h"
+#include <System/JobScheduler.h>
+
+#include <filesystem>
+#include <thread>
 
 //---------------------------------------------------------------------------
 //! コンストラクタ
@@ -16,17 +20,36 @@ ResourceModel::ResourceModel(std::string_view path) {
     // パスの保存
     path_           = convertTo(model_path);
 
+    // 使用メモリ量の目安としてファイルサイズを保存
+    std::error_code ec;
+    file_bytes_ = std::filesystem::file_size(model_path, ec);
+    if(ec)
+        file_bytes_ = 0;
+
     // ハンドルの非同期読み込み処理が完了したら呼ばれる関数
     auto finish_callback = [](int mv1_handle, void* data) {
         auto* resource = reinterpret_cast<ResourceModel*>(data);
 
         // ジオメトリのキャッシュファイルが無かったら作成する
         auto* model_cache = resource->model_cache_.get();
-        if(!model_cache->isExist()) {
-            model_cache->save(mv1_handle);
+        if(!model_cache->isValid()) {
+            // 参照用メッシュの抽出はDxLibを使うため読み込みスレッドで行い、
+            // 最適化とファイル書き込みはワーカースレッドで行う
+            auto mesh = ModelCache::extract(mv1_handle);
 
-            // 読み込みなおす
-            model_cache->load();
+            resource->pending_jobs_++;
+            runJobAsync([resource, mesh = std::move(mesh)]() mutable {
+                auto* model_cache = resource->model_cache_.get();
+                if(model_cache->build(std::move(mesh))) {
+                    // 読み込みなおす
+                    model_cache->load();
+                }
+
+                // アクティブフラグを設定
+                resource->active_ = true;
+                resource->pending_jobs_--;
+            });
+            return;
         }
 
         // アクティブフラグを設定
@@ -37,13 +60,14 @@ ResourceModel::ResourceModel(std::string_view path) {
     // キャッシュファイルの読み込み
     // キャッシュにはリダクションされたワイヤーフレーム表示用の頂点データーが入っています
     //----------------------------------------------------------
-    model_cache_      = std::make_unique<ModelCache>(model_path);
-    bool cache_result = model_cache_->load();
+    model_cache_ = std::make_unique<ModelCache>(model_path);
+    model_cache_->load();
 
     //----------------------------------------------------------
     // 非同期読み込み
+    // キャッシュが無い場合も読み込みは止めず、生成完了までは描画しない
     //----------------------------------------------------------
-    SetUseASyncLoadFlag(cache_result);    // キャッシュファイルが無かった場合はブロッキングロードにする
+    SetUseASyncLoadFlag(true);
     {
         // モデルの読み込み
         mv1_handle_ = MV1LoadModel(model_path.c_str());
@@ -56,6 +80,9 @@ ResourceModel::ResourceModel(std::string_view path) {
 //! デストラクタ
 //---------------------------------------------------------------------------
 ResourceModel::~ResourceModel() {
+    // 読み込み中/キャッシュ生成中のものが終わるまで待つ
+    waitForReadFinish();
+
     MV1DeleteModel(mv1_handle_);
 }
 
@@ -66,6 +93,11 @@ void ResourceModel::waitForReadFinish() {
     if(isActive() == false) {
         WaitHandleASyncLoad(mv1_handle_);
     }
+
+    // キャッシュ生成が終わるまで待つ
+    while(pending_jobs_ > 0) {
+        std::this_thread::yield();
+    }
 }
 
 //---------------------------------------------------------------------------
@@ -102,3 +134,27 @@ bool ResourceModel::isValid() const {
 bool ResourceModel::isActive() const {
     return active_;
 }
+
+//---------------------------------------------------------------------------
+//! 使用メモリ量を取得
+//---------------------------------------------------------------------------
+u64 ResourceModel::residentBytes() const {
+    u64 bytes = file_bytes_;
+
+    if(model_cache_->isValid()) {
+        bytes += model_cache_->vertices().size_bytes();
+        for(u32 lod = 0; lod < model_cache_->lodCount(); ++lod)
+            bytes += model_cache_->indices(lod).size_bytes();
+        bytes += model_cache_->collisionMesh().sizeBytes();
+    }
+    return bytes;
+}
+
+//---------------------------------------------------------------------------
+//! 読み込み中/キャッシュ生成中かどうか
+//---------------------------------------------------------------------------
+bool ResourceModel::isBusy() const {
+    // 非同期読み込みに失敗したものは読み込み中として扱わない
+    bool loading = mv1_handle_ != -1 && !active_ && CheckHandleASyncLoad(mv1_handle_) != -1;
+    return loading || pending_jobs_ > 0;
+}
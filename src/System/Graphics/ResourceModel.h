@@ -17,7 +17,7 @@ class ResourceModel final {
     // デストラクタ
     ~ResourceModel();
 
-    // 読み込み完了まで待つ
+    // 読み込み完了まで待つ (キャッシュ生成中の場合はその完了まで待つ)
     void waitForReadFinish();
 
     // [DxLib] MV1ハンドルを取得
@@ -36,6 +36,12 @@ class ResourceModel final {
     //! @note   描画可能になっていない状態でMV1関数を呼ぶとブロッキングされます
     bool isActive() const;
 
+    // 使用メモリ量を取得 (モデルファイルサイズとモデルキャッシュの合計)
+    u64 residentBytes() const;
+
+    // 読み込み中/キャッシュ生成中かどうか (その間は解放できません)
+    bool isBusy() const;
+
    private:
     //----------------------------------------------------------
     //! @name   copy/move禁止
@@ -52,6 +58,8 @@ class ResourceModel final {
    private:
     int                         mv1_handle_ = -1;    //!< [DxLib] MV1モデルハンドル
     std::wstring                path_;               //!< モデルファイルへのパス
+    u64                         file_bytes_ = 0;     //!< モデルファイルのサイズ
     std::atomic<bool>           active_ = false;     //!< アクティブ状態 true:利用可能 false:ロード未完了
+    std::atomic<u32>            pending_jobs_ = 0;   //!< 実行中のキャッシュ生成ジョブ数
     std::unique_ptr<ModelCache> model_cache_;        //!< 3Dモデルキャッシュ
 };
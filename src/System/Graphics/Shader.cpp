@@ -6,14 +6,135 @@
 
 #include <d3dcompiler.h>    // シェーダーコンパイラ
 
+#include "System/AssetRegistry.h"
 #include "System/FileWatcher.h"
+#include "System/JobScheduler.h"
 #include "Shader.h"
+#include "ShaderCache.h"
 
 // DirectX関連のリンク
 #pragma comment(lib, "d3d11.lib")
 #pragma comment(lib, "dxgi.lib")
 #pragma comment(lib, "d3dcompiler.lib")
 
+namespace {
+
+//---------------------------------------------------------------------------
+//! コンパイラフラグ
+//---------------------------------------------------------------------------
+u32 compileFlags() {
+    u32 compile_flags = D3DCOMPILE_OPTIMIZATION_LEVEL3;
+    compile_flags |= D3DCOMPILE_PACK_MATRIX_ROW_MAJOR;
+
+#if defined(_DEBUG)
+    // GraphicDebuggingツール用にシェーダーデバッグ向け設定
+    compile_flags |= D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
+#endif
+    return compile_flags;
+}
+
+//---------------------------------------------------------------------------
+//! @brief シェーダーバイトコードをコンパイル
+//! @note  ワーカースレッドから並列に呼ばれます (D3DCompile はスレッドセーフ)
+//---------------------------------------------------------------------------
+bool compileBytecode(const std::vector<std::byte>& source_code,
+                     const std::wstring&           source_path,
+                     u32                           index,
+                     int                           dxlib_shader_type,
+                     std::vector<std::byte>&       bytecode,
+                     std::string&                  error_message) {
+    // #define SHADER_VARIANT  index の形式でプリプロセッサ定義
+    auto number_string = std::to_string(index);
+
+    auto dxlib_version = std::format("{:#x}", DXLIB_VERSION);
+
+    // シェーダーモデル名
+    static const char* target_names[]{
+        "vs_5_0",    // DX_SHADERTYPE_VERTEX   // 頂点シェーダー
+        "ps_5_0",    // DX_SHADERTYPE_PIXEL    // ピクセルシェーダー
+        "gs_5_0",    // DX_SHADERTYPE_GEOMETRY // ジオメトリシェーダー
+        "cs_5_0",    // DX_SHADERTYPE_COMPUTE  // コンピュートシェーダー
+        "ds_5_0",    // DX_SHADERTYPE_DOMAIN   // ドメインシェーダー
+        "hs_5_0",    // DX_SHADERTYPE_HULL     // ハルシェーダー
+    };
+
+    // シェーダー内で参照できる #define マクロ定義
+    const D3D_SHADER_MACRO defines[]{
+        {"SHADER_VARIANT", number_string.c_str()},
+        { "DXLIB_VERSION", dxlib_version.c_str()},
+        {         nullptr,               nullptr},
+    };
+
+    Microsoft::WRL::ComPtr<ID3DBlob> byte_code = nullptr;
+    Microsoft::WRL::ComPtr<ID3DBlob> errors;
+
+    auto hr = D3DCompile(source_code.data(),    // [in]  ソースコードのメモリ上のアドレス
+                         source_code.size(),    // [in]  ソースコードサイズ
+                         convertTo(source_path).c_str(),    // [in]  ソースコードのファイルパス(使用しない場合はnullptr)
+                         defines,                           // [in]  プリプロセッサマクロ定義
+                         D3D_COMPILE_STANDARD_FILE_INCLUDE,    // [in]  カスタムインクルード処理
+                         "main",                               // [in]  関数名
+                         target_names[dxlib_shader_type],      // [in]  シェーダーモデル名
+                         compileFlags(),                       // [in]  コンパイラフラグ  (D3DCOMPILE_xxxx)
+                         0,                                    // [in]  コンパイラフラグ2 (D3DCOMPILE_FLAGS2_xxxx)
+                         &byte_code,                           // [out] コンパイルされたバイトコード
+                         &errors);                             // [out] エラーメッセージ
+
+    // エラー警告はメインスレッドで表示する
+    if(errors != nullptr) {
+        error_message = static_cast<const char*>(errors->GetBufferPointer());
+    }
+
+    if(FAILED(hr)) {
+        return false;
+    }
+
+    // シェーダーバイトコードを保存
+    auto* shader_bytecode = static_cast<const std::byte*>(byte_code->GetBufferPointer());
+    bytecode.assign(shader_bytecode, shader_bytecode + byte_code->GetBufferSize());
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! コンパイルエラー警告を表示
+//---------------------------------------------------------------------------
+void showCompileError(const std::wstring& source_path, const std::string& error_message) {
+    // 「出力」ウィンドウに表示
+    OutputDebugStringA("--------------------\n");
+    OutputDebugStringA(error_message.c_str());
+    OutputDebugStringA("--------------------\n");
+
+    // メッセージボックス
+    auto file_name = convertTo(source_path);
+    MessageBox(DxLib::GetMainWindowHandle(), error_message.c_str(), file_name.c_str(), MB_ICONWARNING | MB_OK);
+}
+
+//---------------------------------------------------------------------------
+//! ファイルパスを正規化 (小文字/区切り文字'/'に統一)
+//---------------------------------------------------------------------------
+std::wstring normalizePath(std::wstring path) {
+    path = std::filesystem::path(path).lexically_normal().wstring();
+
+    auto normalize_path = [](wchar_t c) {
+        // 小文字に統一することで大文字小文字の差異をなくす
+        c = ::towlower(c);
+
+        // ファイルパス記号 '\\' を '/' に統一
+        if(c == '\\') {
+            c = '/';
+        }
+        return c;
+    };
+
+    std::transform(path.begin(), path.end(), path.begin(), normalize_path);
+    return path;
+}
+
+//! ファイル → そのファイルを参照しているシェーダーのパス (ホットリロードの対象を探す)
+std::unordered_map<std::wstring, std::vector<std::wstring>> shader_dependents;
+
+}    // namespace
+
 //===========================================================================
 //! シェーダーバリエーションの情報
 //===========================================================================
@@ -27,103 +148,16 @@ struct Variant {
         }
     }
 
-    //! @param  [in]    source_path         HLSLソースコードのファイルパス
+    //! @param  [in]    bytecode            シェーダーバイトコード
     //! @param  [in]    dxlib_shader_type   [DxLib] シェーダーの種類(DX_SHADERTYPE_VERTEXなど)
-    bool compile(const std::wstring& source_path, u32 index, int dxlib_shader_type) {
-        //---------------------------------------------------------------------
-        // ファイルからソースファイルを読み込み
-        //---------------------------------------------------------------------
-        std::vector<std::byte> source_code;
-        {
-            // ファイルから読み込み
-            std::ifstream file(
-                source_path.c_str(),
-                std::ios::in | std::ios::binary | std::ios::ate);    // ateを指定すると最初からファイルポインタが末尾に移動
-            if(!file.is_open()) {
-                return false;
-            }
-            auto size = file.tellg();
-            source_code.resize(static_cast<size_t>(size));
-
-            file.seekg(0, std::ios::beg);
-            file.read(reinterpret_cast<char*>(source_code.data()), size);
-            file.close();
-        }
-
-        //--------------------------------------------------------------
-        // シェーダーをコンパイル
-        //--------------------------------------------------------------
-        u32 compile_flags = D3DCOMPILE_OPTIMIZATION_LEVEL3;
-        compile_flags |= D3DCOMPILE_PACK_MATRIX_ROW_MAJOR;
-
-#if defined(_DEBUG)
-        // GraphicDebuggingツール用にシェーダーデバッグ向け設定
-        compile_flags |= D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
-#endif
-
-        // #define SHADER_VARIANT  index の形式でプリプロセッサ定義
-        auto number_string = std::to_string(index);
-
-        auto dxlib_version = std::format("{:#x}", DXLIB_VERSION);
-
-        // シェーダーモデル名
-        static const char* target_names[]{
-            "vs_5_0",    // DX_SHADERTYPE_VERTEX   // 頂点シェーダー
-            "ps_5_0",    // DX_SHADERTYPE_PIXEL    // ピクセルシェーダー
-            "gs_5_0",    // DX_SHADERTYPE_GEOMETRY // ジオメトリシェーダー
-            "cs_5_0",    // DX_SHADERTYPE_COMPUTE  // コンピュートシェーダー
-            "ds_5_0",    // DX_SHADERTYPE_DOMAIN   // ドメインシェーダー
-            "hs_5_0",    // DX_SHADERTYPE_HULL     // ハルシェーダー
-        };
-
-        // シェーダー内で参照できる #define マクロ定義
-        const D3D_SHADER_MACRO defines[]{
-            {"SHADER_VARIANT", number_string.c_str()},
-            { "DXLIB_VERSION", dxlib_version.c_str()},
-            {         nullptr,               nullptr},
-        };
-
-        Microsoft::WRL::ComPtr<ID3DBlob> byte_code = nullptr;
-        Microsoft::WRL::ComPtr<ID3DBlob> errors;
-
-        auto hr = D3DCompile(source_code.data(),    // [in]  ソースコードのメモリ上のアドレス
-                             source_code.size(),    // [in]  ソースコードサイズ
-                             convertTo(source_path).c_str(),    // [in]  ソースコードのファイルパス(使用しない場合はnullptr)
-                             defines,                           // [in]  プリプロセッサマクロ定義
-                             D3D_COMPILE_STANDARD_FILE_INCLUDE,    // [in]  カスタムインクルード処理
-                             "main",                               // [in]  関数名
-                             target_names[dxlib_shader_type],      // [in]  シェーダーモデル名
-                             compile_flags,                        // [in]  コンパイラフラグ  (D3DCOMPILE_xxxx)
-                             0,                                    // [in]  コンパイラフラグ2 (D3DCOMPILE_FLAGS2_xxxx)
-                             &byte_code,                           // [out] コンパイルされたバイトコード
-                             &errors);                             // [out] エラーメッセージ
-
-        // エラー警告出力
-        if(errors != nullptr) {
-            // 「出力」ウィンドウに表示
-            OutputDebugStringA("--------------------\n");
-            OutputDebugStringA((char*)errors->GetBufferPointer());
-            OutputDebugStringA("--------------------\n");
-
-            // メッセージボックス
-            auto file_name = convertTo(source_path);
-            MessageBox(DxLib::GetMainWindowHandle(), static_cast<char*>(errors->GetBufferPointer()), file_name.c_str(),
-                       MB_ICONWARNING | MB_OK);
-        }
-
-        if(FAILED(hr)) {
-            return false;
-        }
-
+    bool create(std::vector<std::byte> bytecode, int dxlib_shader_type) {
         //------------------------------------------------------
         // [DxLib] シェーダーを作成
         //------------------------------------------------------
-        const void* shader_bytecode = byte_code->GetBufferPointer();    // シェーダーバイトコードの先頭アドレス
-        auto shader_size = static_cast<int>(byte_code->GetBufferSize());    // シェーダーバイトコードのサイズ
+        shader_bytecode_ = std::move(bytecode);
 
-        // シェーダーバイトコードを保存
-        shader_bytecode_.resize(shader_size);
-        memcpy(shader_bytecode_.data(), shader_bytecode, shader_size);
+        const void* shader_bytecode = shader_bytecode_.data();                   // シェーダーバイトコードの先頭アドレス
+        auto        shader_size     = static_cast<int>(shader_bytecode_.size());    // シェーダーバイトコードのサイズ
 
         int handle = -1;
 
@@ -161,9 +195,6 @@ struct Shader::Impl {
     int                  type_ = -1;    //!< [DxLib] シェーダーの種類(DX_SHADERTYPE_VERTEXなど)
     std::vector<Variant> variant_;      //!< バリエーションごとの定義
 
-    //! 現在アクティブなシェーダーリスト
-    static inline std::unordered_map<std::wstring, std::shared_ptr<Shader::Impl>> shaders_;
-
    public:
     //! @param  [in]    path                HLSLソースコードのファイルパス
     //! @param  [in]    dxlib_shader_type   [DxLib] シェーダーの種類(DX_SHADERTYPE_VERTEXなど)
@@ -185,17 +216,97 @@ struct Shader::Impl {
         std::wstring source_path = path_ + L".fx";
 
         //----------------------------------------------------------
-        // シェーダーバリエーションコンパイル
+        // ファイルからソースファイルを読み込み
         //----------------------------------------------------------
-        for(u32 i = 0; i < variant_.size(); i++) {
-            // シェーダーをコンパイル
-            Variant new_variant;
-            bool    result = new_variant.compile(source_path, i, type_);
+        std::vector<std::byte> source_code;
+        {
+            // ファイルから読み込み
+            std::ifstream file(
+                source_path.c_str(),
+                std::ios::in | std::ios::binary | std::ios::ate);    // ateを指定すると最初からファイルポインタが末尾に移動
+            if(!file.is_open()) {
+                return false;
+            }
+            auto size = file.tellg();
+            source_code.resize(static_cast<size_t>(size));
+
+            file.seekg(0, std::ios::beg);
+            file.read(reinterpret_cast<char*>(source_code.data()), size);
+            file.close();
+        }
+
+        //----------------------------------------------------------
+        // キャッシュのキーを作成 (インクルードファイルの内容も含む)
+        //----------------------------------------------------------
+        std::vector<std::filesystem::path> dependencies;
+
+        ShaderCacheKey key;
+        key.source_hash_   = ShaderCache::hashSource(source_path, &dependencies);
+        key.shader_type_   = static_cast<u32>(type_);
+        key.compile_flags_ = compileFlags();
+        key.dxlib_version_ = static_cast<u32>(DXLIB_VERSION);
+
+        // 参照しているファイルが更新されたときにホットリロードできるように登録
+        for(auto& dependency: dependencies) {
+            auto& dependents = shader_dependents[normalizePath(dependency.wstring())];
+            if(std::find(dependents.begin(), dependents.end(), path_) == dependents.end())
+                dependents.push_back(path_);
+        }
+
+        //----------------------------------------------------------
+        // シェーダーバリエーションをキャッシュから読み込み
+        // 無いものはワーカースレッドで並列にコンパイル
+        //----------------------------------------------------------
+        const u32 variant_count = static_cast<u32>(variant_.size());
+
+        std::vector<std::vector<std::byte>> bytecodes(variant_count);
+        std::vector<std::string>            error_messages(variant_count);
+        std::vector<u8>                     compiled(variant_count, false);    // std::vector<bool>は並列に書き込めない
+        std::vector<u8>                     succeeded(variant_count, false);
+
+        JobGroup jobs(variant_count);
+        for(u32 i = 0; i < variant_count; i++) {
+            key.variant_ = i;
+            if(ShaderCache::load(source_path, key, bytecodes[i])) {
+                succeeded[i] = true;
+                continue;
+            }
 
-            // 失敗したらその先の更新をスキップ終了
-            if(!result) {
+            // 読み書きするデータが重ならないので並列に実行される
+            jobs.registerJob(
+                Priority(),
+                [&, i]() {
+                    succeeded[i] = compileBytecode(source_code, source_path, i, type_, bytecodes[i], error_messages[i]);
+                    compiled[i]  = true;
+                },
+                JobAccess(0, 0));
+        }
+        jobs.execute();
+
+        // エラー警告出力 (同じ内容はまとめて1回)
+        for(u32 i = 0; i < variant_count; i++) {
+            if(!error_messages[i].empty() && (i == 0 || error_messages[i] != error_messages[i - 1]))
+                showCompileError(source_path, error_messages[i]);
+        }
+
+        // 失敗したら旧シェーダーのまま終了
+        for(u32 i = 0; i < variant_count; i++) {
+            if(!succeeded[i]) {
                 return false;
             }
+        }
+
+        //----------------------------------------------------------
+        // コンパイルしたものをキャッシュに保存して置換
+        //----------------------------------------------------------
+        for(u32 i = 0; i < variant_count; i++) {
+            if(compiled[i]) {
+                key.variant_ = i;
+                ShaderCache::save(source_path, key, bytecodes[i]);
+            }
+
+            Variant new_variant;
+            new_variant.create(std::move(bytecodes[i]), type_);
 
             // 作成が成功したら旧シェーダーを解放して新しい結果に置換
             // 代入ではなくstd::swapで行う理由は、交換されたあとのローカル変数が自動解放されるのを利用して
@@ -205,6 +316,19 @@ struct Shader::Impl {
 
         return true;
     }
+
+    //! 使用メモリ量を取得 (シェーダーバイトコードの合計)
+    u64 residentBytes() const {
+        u64 bytes = 0;
+        for(auto& variant: variant_)
+            bytes += variant.shader_bytecode_.size();
+        return bytes;
+    }
+
+    //! 解放できない状態かどうか
+    bool isBusy() const {
+        return false;
+    }
 };
 
 namespace {
@@ -226,40 +350,23 @@ Shader::Shader(std::string_view source_path, u32 dxlib_shader_type, u32 variant_
     std::filesystem::path path(source_path);
 
     // 拡張子を除去したファイルパスを取得
-    auto shader_path = path.parent_path().wstring() + L"/" + path.stem().wstring();
-
-    auto normalize_path = [](wchar_t c) {
-        // 小文字に統一することで大文字小文字の差異をなくす
-        c = ::towlower(c);
-
-        // ファイルパス記号 '\\' を '/' に統一
-        if(c == '\\') {
-            c = '/';
-        }
-        return c;
-    };
-
-    std::transform(shader_path.begin(), shader_path.end(), shader_path.begin(), normalize_path);
+    auto shader_path = normalizePath(path.parent_path().wstring() + L"/" + path.stem().wstring());
 
     //-----------------------------------------------------------------------
     // 初回実行時にファイル監視を開始する
     //-----------------------------------------------------------------------
     // ファイル変更時のコールバック関数
     auto file_modified_callback = [=](const wchar_t* full_path) {
-        // ファイルパスの要素を分解
-        std::filesystem::path path(full_path);
-        auto                  file_path = path.parent_path().wstring() + L"/" + path.stem().wstring();
+        // シェーダーソースコードかインクルードファイルだった場合
+        auto it = shader_dependents.find(normalizePath(full_path));
+        if(it == shader_dependents.end())
+            return;
 
-        // シェーダーソースコードだった場合
-        if(path.extension() == L".fx") {
-            // ファイルパスを正規化
-            std::transform(file_path.begin(), file_path.end(), file_path.begin(), normalize_path);
+        // 参照しているシェーダーのみコンパイル (キャッシュは内容のハッシュで一致しなくなる)
+        for(auto& dependent: it->second) {
+            auto shader_impl = AssetRegistry::find<Shader::Impl>(AssetType::Shader, convertTo(dependent));
 
-            // 読み込み済のシェーダーパスと照合して一致したらホットリード対象
-            auto it = Shader::Impl::shaders_.find(file_path);
-
-            if(it != std::end(Shader::Impl::shaders_)) {
-                auto& shader_impl = it->second;
+            if(shader_impl) {
                 shader_impl->compile();    // 対象のシェーダーをコンパイル
             }
         }
@@ -268,24 +375,20 @@ Shader::Shader(std::string_view source_path, u32 dxlib_shader_type, u32 variant_
     // ファイル監視開始
     std::call_once(once_initialize_, [&]() {
         file_watcher_.initialize(L".", file_modified_callback);
+
+        // キャッシュフォルダはモデルキャッシュと同じ一時フォルダ
+        std::array<char, 1024> temporary_path;
+        GetTempPath(static_cast<DWORD>(sizeof(temporary_path)), temporary_path.data());
+        ShaderCache::setDirectory(std::string(temporary_path.data()) + "BaseProject/Shader/");
     });
 
     //----------------------------------------------------------
     // 初期設定
     //----------------------------------------------------------
-    // シェーダーリストを検索して既存のシェーダーの場合は再利用
-    auto it = Shader::Impl::shaders_.find(shader_path);
-
-    if(it == std::end(Shader::Impl::shaders_)) {    // 見つからなかった場合は新規作成
-        auto p = std::make_shared<Shader::Impl>(shader_path, dxlib_shader_type, variant_count);
-
-        // シェーダーリストに登録
-        Shader::Impl::shaders_[shader_path] = p;
-
-        impl_ = std::move(p);
-    } else {    // 見つかった場合は再利用
-        impl_ = it->second;
-    }
+    // 既存のシェーダーの場合は再利用し、見つからなかった場合は新規作成
+    impl_ = AssetRegistry::acquire<Shader::Impl>(AssetType::Shader, convertTo(shader_path), [&]() {
+                return std::make_shared<Shader::Impl>(shader_path, dxlib_shader_type, variant_count);
+            }).shared();
 }
 
 //---------------------------------------------------------------------------
@@ -0,0 +1,229 @@
+﻿//---------------------------------------------------------------------------
+//! @file   ShaderCache.cpp
+//! @brief  シェーダーバイトコードキャッシュ
+//---------------------------------------------------------------------------
+#include "ShaderCache.h"
+
+#include <fstream>
+#include <mutex>
+#include <unordered_set>
+
+namespace {
+
+constexpr u32 CACHE_MAGIC = 0x48435348;    //!< 'HSCH'
+
+//! ファイルヘッダー
+struct CacheHeader {
+    u32            magic_;            //!< 識別子
+    u32            version_;          //!< ファイルバージョン
+    ShaderCacheKey key_;              //!< キー
+    u64            bytecode_size_;    //!< バイトコードのサイズ
+    u64            bytecode_hash_;    //!< バイトコードのハッシュ値 (書き込み途中のファイルの検出)
+};
+
+std::mutex            cache_mutex;        //!< キャッシュフォルダ設定の排他
+std::filesystem::path cache_directory;    //!< キャッシュフォルダ
+
+//---------------------------------------------------------------------------
+//! ハッシュ値に追加 (FNV-1a 64bit)
+//---------------------------------------------------------------------------
+u64 hashBytes(u64 hash, const void* data, size_t size) {
+    auto* p = static_cast<const u8*>(data);
+    for(size_t i = 0; i < size; ++i) {
+        hash ^= p[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+//---------------------------------------------------------------------------
+//! ファイルを読み込み
+//---------------------------------------------------------------------------
+bool readFile(const std::filesystem::path& path, std::string& text) {
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if(!file.is_open())
+        return false;
+
+    text.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! #include のファイル名を取得
+//---------------------------------------------------------------------------
+bool parseInclude(std::string_view line, std::string_view& name) {
+    auto pos = line.find_first_not_of(" \t");
+    if(pos == std::string_view::npos || line[pos] != '#')
+        return false;
+
+    pos = line.find_first_not_of(" \t", pos + 1);
+    if(pos == std::string_view::npos || line.substr(pos, 7) != "include")
+        return false;
+
+    // "file" と <file> のどちらも D3D_COMPILE_STANDARD_FILE_INCLUDE ではインクルード元からの相対パス
+    auto open = line.find_first_of("\"<", pos + 7);
+    if(open == std::string_view::npos)
+        return false;
+
+    auto close = line.find(line[open] == '"' ? '"' : '>', open + 1);
+    if(close == std::string_view::npos)
+        return false;
+
+    name = line.substr(open + 1, close - open - 1);
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! ファイルとそのインクルードファイルをハッシュ化
+//---------------------------------------------------------------------------
+u64 hashFile(u64                                 hash,
+             const std::filesystem::path&        path,
+             std::unordered_set<std::string>&    visited,
+             std::vector<std::filesystem::path>* dependencies) {
+    auto normal_path = path.lexically_normal();
+    if(!visited.insert(normal_path.generic_string()).second)
+        return hash;
+
+    std::string text;
+    if(!readFile(normal_path, text)) {
+        // 見つからないファイルは名前だけ反映 (作成されたら変化する)
+        auto name = normal_path.generic_string();
+        return hashBytes(hash, name.data(), name.size());
+    }
+
+    if(dependencies)
+        dependencies->push_back(normal_path);
+
+    hash = hashBytes(hash, text.data(), text.size());
+
+    // インクルードファイルを出現順にたどる
+    std::string_view source(text);
+    while(!source.empty()) {
+        auto end  = source.find('\n');
+        auto line = source.substr(0, end);
+
+        std::string_view name;
+        if(parseInclude(line, name))
+            hash = hashFile(hash, normal_path.parent_path() / std::filesystem::path(name), visited, dependencies);
+
+        if(end == std::string_view::npos)
+            break;
+        source.remove_prefix(end + 1);
+    }
+    return hash;
+}
+
+}    // namespace
+
+//---------------------------------------------------------------------------
+//! ソースコードの内容のハッシュ値を計算
+//---------------------------------------------------------------------------
+u64 ShaderCache::hashSource(const std::filesystem::path& source_path, std::vector<std::filesystem::path>* dependencies) {
+    std::error_code error_code;
+    if(!std::filesystem::is_regular_file(source_path, error_code))
+        return 0;
+
+    std::unordered_set<std::string> visited;
+    u64                             hash = hashFile(0xcbf29ce484222325ull, source_path, visited, dependencies);
+    return hash != 0 ? hash : 1;    // 0は読み込み失敗と区別する
+}
+
+//---------------------------------------------------------------------------
+//! キャッシュフォルダを設定
+//---------------------------------------------------------------------------
+void ShaderCache::setDirectory(const std::filesystem::path& directory) {
+    std::lock_guard lock(cache_mutex);
+    cache_directory = directory;
+}
+
+//---------------------------------------------------------------------------
+//! キャッシュファイルのパスを取得
+//---------------------------------------------------------------------------
+std::filesystem::path ShaderCache::cachePath(const std::filesystem::path& source_path, const ShaderCacheKey& key) {
+    // ソースの相対パスの階層をそのまま使う (ドライブ名などは除く)
+    auto relative = source_path.lexically_normal().relative_path();
+
+    char suffix[64];
+    snprintf(suffix, sizeof(suffix), ".%u.%x.%x.cso", key.variant_, key.shader_type_, key.compile_flags_);
+
+    std::lock_guard lock(cache_mutex);
+    return cache_directory / (relative.generic_string() + suffix);
+}
+
+//---------------------------------------------------------------------------
+//! キャッシュからバイトコードを読み込み
+//---------------------------------------------------------------------------
+bool ShaderCache::load(const std::filesystem::path& source_path, const ShaderCacheKey& key, std::vector<std::byte>& bytecode) {
+    auto path = cachePath(source_path, key);
+
+    // エラーコードを受け取ると例外を送出しない
+    std::error_code error_code;
+    auto            file_size = std::filesystem::file_size(path, error_code);
+    if(error_code || file_size < sizeof(CacheHeader))
+        return false;
+
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if(!file.is_open())
+        return false;
+
+    CacheHeader header{};
+    if(!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        return false;
+
+    if(header.magic_ != CACHE_MAGIC || header.version_ != VERSION || !(header.key_ == key))
+        return false;
+
+    // 壊れたヘッダーのサイズで確保しないようにファイルサイズと照合する
+    if(header.bytecode_size_ != file_size - sizeof(header))
+        return false;
+
+    std::vector<std::byte> data(static_cast<size_t>(header.bytecode_size_));
+    if(!file.read(reinterpret_cast<char*>(data.data()), data.size()))
+        return false;
+
+    if(hashBytes(0xcbf29ce484222325ull, data.data(), data.size()) != header.bytecode_hash_)
+        return false;
+
+    bytecode = std::move(data);
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! バイトコードをキャッシュに保存
+//---------------------------------------------------------------------------
+bool ShaderCache::save(const std::filesystem::path& source_path, const ShaderCacheKey& key, const std::vector<std::byte>& bytecode) {
+    auto path = cachePath(source_path, key);
+
+    // フォルダ階層をまとめて作成
+    // エラーコードを受け取ると例外を送出しない
+    std::error_code error_code;
+    std::filesystem::create_directories(path.parent_path(), error_code);
+
+    CacheHeader header{};
+    header.magic_         = CACHE_MAGIC;
+    header.version_       = VERSION;
+    header.key_           = key;
+    header.bytecode_size_ = bytecode.size();
+    header.bytecode_hash_ = hashBytes(0xcbf29ce484222325ull, bytecode.data(), bytecode.size());
+
+    // 書き込み途中のファイルを読まないように一時ファイルに書いてから置き換える
+    auto temporary_path = path;
+    temporary_path += ".tmp";
+    {
+        std::ofstream file(temporary_path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if(!file.is_open())
+            return false;
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(bytecode.data()), bytecode.size());
+        if(!file)
+            return false;
+    }
+
+    std::filesystem::rename(temporary_path, path, error_code);
+    if(error_code) {
+        std::filesystem::remove(temporary_path, error_code);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,59 @@
+﻿//---------------------------------------------------------------------------
+//! @file   ShaderCache.h
+//! @brief  シェーダーバイトコードキャッシュ
+//---------------------------------------------------------------------------
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+//===========================================================================
+//! シェーダーキャッシュのキー
+//===========================================================================
+struct ShaderCacheKey {
+    u64 source_hash_   = 0;    //!< ソースコードとインクルードファイルの内容のハッシュ値
+    u32 variant_       = 0;    //!< バリエーション番号
+    u32 shader_type_   = 0;    //!< [DxLib] シェーダーの種類(DX_SHADERTYPE_VERTEXなど)
+    u32 compile_flags_ = 0;    //!< コンパイラフラグ (D3DCOMPILE_xxxx)
+    u32 dxlib_version_ = 0;    //!< DXLIB_VERSION
+
+    bool operator==(const ShaderCacheKey&) const = default;
+};
+
+//===========================================================================
+//! @brief シェーダーバイトコードキャッシュ
+//! @details コンパイル済のバイトコードをバリエーションごとにファイルへ保存します。
+//!          ファイル名にはソースパス、バリエーション番号、コンパイラフラグを含め、
+//!          ヘッダーに記録したキーが一致しない場合は読み込みません (再コンパイル後に上書き)。
+//!          DirectX/DxLibには依存していません
+//===========================================================================
+class ShaderCache final {
+   public:
+    static constexpr u32 VERSION = 1;    //!< ファイルバージョン (形式を変更したら更新)
+
+    //! @brief ソースコードの内容のハッシュ値を計算
+    //! @details #include で参照しているファイルを再帰的にたどり、内容をまとめてハッシュ化します
+    //! @param [in]  source_path    ソースファイルのパス
+    //! @param [out] dependencies   参照したファイルの一覧 (ソースファイルを含む 省略可)
+    //! @return ソースファイルが読み込めない場合は0
+    static u64 hashSource(const std::filesystem::path& source_path, std::vector<std::filesystem::path>* dependencies = nullptr);
+
+    //! キャッシュフォルダを設定
+    static void setDirectory(const std::filesystem::path& directory);
+
+    //! キャッシュファイルのパスを取得
+    static std::filesystem::path cachePath(const std::filesystem::path& source_path, const ShaderCacheKey& key);
+
+    //! @brief キャッシュからバイトコードを読み込み
+    //! @param [in]  source_path    ソースファイルのパス
+    //! @param [in]  key            キー
+    //! @param [out] bytecode       バイトコード
+    //! @return キャッシュが無いかキーが一致しない場合は false
+    static bool load(const std::filesystem::path& source_path, const ShaderCacheKey& key, std::vector<std::byte>& bytecode);
+
+    //! @brief バイトコードをキャッシュに保存
+    //! @param [in] source_path     ソースファイルのパス
+    //! @param [in] key             キー
+    //! @param [in] bytecode        バイトコード
+    static bool save(const std::filesystem::path& source_path, const ShaderCacheKey& key, const std::vector<std::byte>& bytecode);
+};
@@ -4,6 +4,105 @@
 //---------------------------------------------------------------------------
 #include "Texture.h"
 
+namespace {
+
+//---------------------------------------------------------------------------
+//! 1ピクセルあたりのビット数 (圧縮形式は4x4ブロック単位の平均)
+//---------------------------------------------------------------------------
+u32 bitsPerPixel(DXGI_FORMAT format) {
+    switch(format) {
+        case DXGI_FORMAT_BC1_TYPELESS:
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:
+        case DXGI_FORMAT_BC4_TYPELESS:
+        case DXGI_FORMAT_BC4_UNORM:
+        case DXGI_FORMAT_BC4_SNORM:
+            return 4;
+        case DXGI_FORMAT_BC2_TYPELESS:
+        case DXGI_FORMAT_BC2_UNORM:
+        case DXGI_FORMAT_BC2_UNORM_SRGB:
+        case DXGI_FORMAT_BC3_TYPELESS:
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:
+        case DXGI_FORMAT_BC5_TYPELESS:
+        case DXGI_FORMAT_BC5_UNORM:
+        case DXGI_FORMAT_BC5_SNORM:
+        case DXGI_FORMAT_BC6H_TYPELESS:
+        case DXGI_FORMAT_BC6H_UF16:
+        case DXGI_FORMAT_BC6H_SF16:
+        case DXGI_FORMAT_BC7_TYPELESS:
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:
+        case DXGI_FORMAT_R8_TYPELESS:
+        case DXGI_FORMAT_R8_UNORM:
+        case DXGI_FORMAT_R8_UINT:
+        case DXGI_FORMAT_R8_SNORM:
+        case DXGI_FORMAT_R8_SINT:
+        case DXGI_FORMAT_A8_UNORM:
+            return 8;
+        case DXGI_FORMAT_R8G8_TYPELESS:
+        case DXGI_FORMAT_R8G8_UNORM:
+        case DXGI_FORMAT_R8G8_UINT:
+        case DXGI_FORMAT_R8G8_SNORM:
+        case DXGI_FORMAT_R8G8_SINT:
+        case DXGI_FORMAT_R16_TYPELESS:
+        case DXGI_FORMAT_R16_FLOAT:
+        case DXGI_FORMAT_R16_UNORM:
+        case DXGI_FORMAT_R16_UINT:
+        case DXGI_FORMAT_R16_SNORM:
+        case DXGI_FORMAT_R16_SINT:
+        case DXGI_FORMAT_B5G6R5_UNORM:
+        case DXGI_FORMAT_B5G5R5A1_UNORM:
+            return 16;
+        case DXGI_FORMAT_R16G16B16A16_TYPELESS:
+        case DXGI_FORMAT_R16G16B16A16_FLOAT:
+        case DXGI_FORMAT_R16G16B16A16_UNORM:
+        case DXGI_FORMAT_R16G16B16A16_UINT:
+        case DXGI_FORMAT_R16G16B16A16_SNORM:
+        case DXGI_FORMAT_R16G16B16A16_SINT:
+        case DXGI_FORMAT_R32G32_TYPELESS:
+        case DXGI_FORMAT_R32G32_FLOAT:
+        case DXGI_FORMAT_R32G32_UINT:
+        case DXGI_FORMAT_R32G32_SINT:
+            return 64;
+        case DXGI_FORMAT_R32G32B32_TYPELESS:
+        case DXGI_FORMAT_R32G32B32_FLOAT:
+        case DXGI_FORMAT_R32G32B32_UINT:
+        case DXGI_FORMAT_R32G32B32_SINT:
+            return 96;
+        case DXGI_FORMAT_R32G32B32A32_TYPELESS:
+        case DXGI_FORMAT_R32G32B32A32_FLOAT:
+        case DXGI_FORMAT_R32G32B32A32_UINT:
+        case DXGI_FORMAT_R32G32B32A32_SINT:
+            return 128;
+        default:
+            return 32;
+    }
+}
+
+//---------------------------------------------------------------------------
+//! テクスチャの使用メモリ量を計算 (ミップマップと配列を含む)
+//---------------------------------------------------------------------------
+u64 textureBytes(const D3D11_TEXTURE2D_DESC& desc) {
+    const bool block_compressed = (desc.Format >= DXGI_FORMAT_BC1_TYPELESS && desc.Format <= DXGI_FORMAT_BC5_SNORM) ||
+                                  (desc.Format >= DXGI_FORMAT_BC6H_TYPELESS && desc.Format <= DXGI_FORMAT_BC7_UNORM_SRGB);
+    const u64  bpp              = bitsPerPixel(desc.Format);
+
+    u64 bytes = 0;
+    for(u32 mip = 0; mip < std::max(desc.MipLevels, 1u); ++mip) {
+        u64 w = std::max(desc.Width >> mip, 1u);
+        u64 h = std::max(desc.Height >> mip, 1u);
+        if(block_compressed) {
+            w = (w + 3) & ~3ull;
+            h = (h + 3) & ~3ull;
+        }
+        bytes += w * h * bpp / 8;
+    }
+    return bytes * std::max(desc.ArraySize, 1u);
+}
+
+}    // namespace
+
 //---------------------------------------------------------------------------
 //! デストラクタ
 //---------------------------------------------------------------------------
@@ -20,6 +119,8 @@ void Texture::clear() {
         handle_ = -1;
     }
 
+    resident_bytes_ = 0;
+
     d3d_resource_.Reset();
     d3d_srv_.Reset();
     d3d_rtv_.Reset();
@@ -59,6 +160,13 @@ Texture::Texture(int grHandle) {
 //!  ファイルから作成
 //---------------------------------------------------------------------------
 Texture::Texture(std::string_view path) {
+    start_load(path);
+}
+
+//---------------------------------------------------------------------------
+//!  ファイルの非同期読み込みを開始
+//---------------------------------------------------------------------------
+void Texture::start_load(std::string_view path) {
     //-----------------------------------------------------------------------
     // テクスチャの読み込み
     //-----------------------------------------------------------------------
@@ -150,8 +258,9 @@ bool Texture::initialize(ID3D11Resource* d3d_resource) {
         D3D11_TEXTURE2D_DESC desc;
         d3d_texture_2d->GetDesc(&desc);
 
-        width_  = desc.Width;     // 幅
-        height_ = desc.Height;    // 高さ
+        width_          = desc.Width;            // 幅
+        height_         = desc.Height;           // 高さ
+        resident_bytes_ = textureBytes(desc);    // 使用メモリ量
 
         if(desc.BindFlags & D3D11_BIND_SHADER_RESOURCE) {
             if(desc.Format == DXGI_FORMAT_R32_TYPELESS) {    // デプスバッファ用の場合はR32_FLOATとして利用
@@ -283,3 +392,18 @@ bool Texture::is_valid() const {
 bool Texture::is_active() const {
     return active_;
 }
+
+//---------------------------------------------------------------------------
+//! 使用メモリ量を取得
+//---------------------------------------------------------------------------
+u64 Texture::residentBytes() const {
+    return resident_bytes_;
+}
+
+//---------------------------------------------------------------------------
+//! 読み込み中かどうか
+//---------------------------------------------------------------------------
+bool Texture::isBusy() const {
+    // 非同期読み込みに失敗したものは読み込み中として扱わない
+    return handle_ != -1 && !active_ && CheckHandleASyncLoad(handle_) != -1;
+}
@@ -8,6 +8,8 @@
 //! テクスチャ
 //===========================================================================
 class Texture {
+    friend class TexturePool;
+
    public:
     // コンストラクタ
     Texture() = default;
@@ -72,9 +74,20 @@ class Texture {
     //! @note   描画可能になっていない状態でMV1関数を呼ぶとブロッキングされます
     bool is_active() const;
 
+    // 使用メモリ量を取得 (ミップマップを含む推定値)
+    //! @note   非同期読み込みの場合は初期化されるまで0です
+    u64 residentBytes() const;
+
+    // 読み込み中かどうか (読み込み中は解放できません)
+    bool isBusy() const;
+
     //@}
 
    protected:
+    // ファイルの非同期読み込みを開始
+    //! @param [in] path    ファイルパス
+    void start_load(std::string_view path);
+
     // D3D11Resource指定で初期化
     bool initialize(ID3D11Resource* d3d_resource);
 
@@ -82,9 +95,10 @@ class Texture {
     void on_initialize();
 
    protected:
-    u32               width_  = 0;        //!< 幅
-    u32               height_ = 0;        //!< 高さ
-    int               handle_ = -1;       //!< [DxLib] Graphicハンドル
+    u32               width_          = 0;     //!< 幅
+    u32               height_         = 0;     //!< 高さ
+    u64               resident_bytes_ = 0;     //!< 使用メモリ量
+    int               handle_         = -1;    //!< [DxLib] Graphicハンドル
     std::wstring      path_;              //!< ファイルパス
     std::atomic<bool> active_ = false;    //!< アクティブ状態 true:利用可能 false:ロード未完了
     std::atomic<bool> need_initialize_ = false;    //!< 初期化要求フラグ true:初期化が必要 false:初期化済または完了で不要
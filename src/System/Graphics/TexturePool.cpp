@@ -0,0 +1,205 @@
+﻿//---------------------------------------------------------------------------
+//! @file   TexturePool.cpp
+//! @brief  テクスチャリソースプール
+//---------------------------------------------------------------------------
+#include "TexturePool.h"
+
+#include <System/AssetRegistry.h>
+
+namespace {
+
+//! 読み込み状態
+enum class LoadState {
+    Queued,      //!< 読み込み待ち
+    Loading,     //!< 読み込み中
+    Resident,    //!< 読み込み済 (失敗を含む)
+};
+
+//===========================================================================
+//! 読み込み管理情報
+//===========================================================================
+struct TextureEntry {
+    std::weak_ptr<Texture> texture_;                                      //!< テクスチャ (所有は AssetRegistry)
+    std::string            path_;                                         //!< 読み込みパス
+    u32                    id_        = AssetHandle<Texture>::INVALID;    //!< アセットID
+    LoadState              state_     = LoadState::Queued;                //!< 読み込み状態
+    f32                    priority_  = TexturePool::PRIORITY_DEFAULT;    //!< 読み込み優先
+    u64                    serial_    = 0;                                //!< 登録順
+    u64                    touched_   = 0;                                //!< 優先を更新したフレーム
+};
+
+std::unordered_map<const Texture*, TextureEntry> texture_entries;    //!< 読み込み管理情報
+
+u64 pool_frame         = 1;    //!< フレーム番号
+u64 pool_serial        = 0;    //!< 登録通し番号
+u32 pool_max_loading   = 8;    //!< 同時に読み込む最大数
+u32 pool_loading_count = 0;    //!< 読み込み中の数
+
+}    // namespace
+
+//---------------------------------------------------------------------------
+//! テクスチャを取得
+//---------------------------------------------------------------------------
+std::shared_ptr<Texture> TexturePool::load(std::string_view path, f32 priority) {
+    bool created = false;
+    auto handle  = AssetRegistry::acquire<Texture>(
+        AssetType::Texture, path, []() { return std::make_shared<Texture>(); }, &created);
+
+    auto* texture = handle.get();
+    if(!created) {    // 共有
+        auto it = texture_entries.find(texture);
+        if(it != texture_entries.end())
+            it->second.priority_ = std::min(it->second.priority_, priority);
+        return handle.shared();
+    }
+
+    // 新規登録 (読み込みは update() で優先順に開始)
+    auto& entry     = texture_entries[texture];
+    entry           = {};
+    entry.texture_  = handle.shared();
+    entry.path_     = std::string(path);
+    entry.id_       = handle.id();
+    entry.priority_ = priority;
+    entry.serial_   = pool_serial++;
+    texture->path_  = convertTo(entry.path_);
+
+    // 最優先のものは待たずに読み込みを開始する
+    if(priority <= PRIORITY_IMMEDIATE) {
+        texture->start_load(entry.path_);
+        entry.state_ = LoadState::Loading;
+        pool_loading_count++;
+    }
+
+    return handle.shared();
+}
+
+//---------------------------------------------------------------------------
+//! 描画で使用したことを通知
+//---------------------------------------------------------------------------
+void TexturePool::touch(const Texture* texture, f32 priority) {
+    if(texture == nullptr)
+        return;
+
+    auto it = texture_entries.find(texture);
+    if(it == texture_entries.end())
+        return;
+
+    auto& entry = it->second;
+
+    // フレームの最初の通知で優先を置き換え、以降はそのフレームで最も近いものを採用する
+    if(entry.touched_ != pool_frame)
+        entry.priority_ = priority;
+    else
+        entry.priority_ = std::min(entry.priority_, priority);
+    entry.touched_ = pool_frame;
+
+    AssetRegistry::touch(entry.id_);
+}
+
+//---------------------------------------------------------------------------
+//! 読み込みが終わっていないかどうか
+//---------------------------------------------------------------------------
+bool TexturePool::isPending(const Texture* texture) {
+    auto it = texture_entries.find(texture);
+    return it != texture_entries.end() && it->second.state_ != LoadState::Resident;
+}
+
+//---------------------------------------------------------------------------
+//! 更新
+//---------------------------------------------------------------------------
+void TexturePool::update() {
+    //----------------------------------------------------------
+    // 読み込み完了を反映
+    //----------------------------------------------------------
+    std::vector<TextureEntry*> queued;
+    for(auto it = texture_entries.begin(); it != texture_entries.end();) {
+        auto& entry   = it->second;
+        auto  texture = entry.texture_.lock();
+
+        // AssetRegistry で解放済
+        // 読み込み中のものは読み込み枠を返す
+        // (解放済のテクスチャは SetASyncLoadFinishDeleteFlag で読み込み完了時に削除され、
+        //  まだ参照されているものは初回使用時に Texture 側で初期化されるためハンドルは追わない)
+        if(!texture || !AssetRegistry::isResident(entry.id_)) {
+            if(entry.state_ == LoadState::Loading)
+                pool_loading_count--;
+            it = texture_entries.erase(it);
+            continue;
+        }
+
+        if(entry.state_ == LoadState::Loading) {
+            if(texture->is_active()) {
+                texture->on_initialize();
+                entry.state_ = LoadState::Resident;
+                pool_loading_count--;
+            } else if(texture->handle_ == -1 || CheckHandleASyncLoad(texture->handle_) == -1) {
+                // 読み込み失敗 (再読み込みはしない)
+                entry.state_ = LoadState::Resident;
+                pool_loading_count--;
+            }
+        }
+
+        // 参照されているものだけ読み込む (AssetRegistry とここで lock した分を除く)
+        if(entry.state_ == LoadState::Queued && texture.use_count() > 2)
+            queued.push_back(&entry);
+
+        ++it;
+    }
+
+    //----------------------------------------------------------
+    // 優先順に読み込みを開始
+    //----------------------------------------------------------
+    if(pool_loading_count < pool_max_loading && !queued.empty()) {
+        u32 count = std::min(pool_max_loading - pool_loading_count, static_cast<u32>(queued.size()));
+
+        std::partial_sort(queued.begin(), queued.begin() + count, queued.end(), [](const TextureEntry* a, const TextureEntry* b) {
+            if(a->priority_ != b->priority_)
+                return a->priority_ < b->priority_;
+            return a->serial_ < b->serial_;
+        });
+
+        for(u32 i = 0; i < count; ++i) {
+            if(auto texture = queued[i]->texture_.lock())
+                texture->start_load(queued[i]->path_);
+            queued[i]->state_ = LoadState::Loading;
+        }
+        pool_loading_count += count;
+    }
+
+    pool_frame++;
+}
+
+//---------------------------------------------------------------------------
+//! 読み込み中のものを待って管理情報を破棄
+//---------------------------------------------------------------------------
+void TexturePool::clear() {
+    for(auto& [texture_ptr, entry]: texture_entries) {
+        if(entry.state_ != LoadState::Loading)
+            continue;
+        if(auto texture = entry.texture_.lock())
+            WaitHandleASyncLoad(texture->handle_);
+    }
+
+    texture_entries.clear();
+    pool_loading_count = 0;
+}
+
+//---------------------------------------------------------------------------
+//! 設定
+//---------------------------------------------------------------------------
+void TexturePool::setup(u32 max_loading) {
+    pool_max_loading = std::max(max_loading, 1u);
+}
+
+//---------------------------------------------------------------------------
+//! 統計情報を取得
+//---------------------------------------------------------------------------
+TexturePool::Stats TexturePool::stats() {
+    Stats stats;
+    stats.loading_count_ = pool_loading_count;
+    for(auto& [texture, entry]: texture_entries) {
+        if(entry.state_ == LoadState::Queued)
+            stats.queued_count_++;
+    }
+    return stats;
+}
@@ -0,0 +1,51 @@
+﻿//---------------------------------------------------------------------------
+//! @file   TexturePool.h
+//! @brief  テクスチャリソースプール
+//---------------------------------------------------------------------------
+#pragma once
+
+//===========================================================================
+//! @brief テクスチャリソースプール
+//! @details テクスチャは AssetRegistry で共有/解放されます。
+//!          ここでは読み込みを優先順のキューから少しずつDxLibの非同期読み込みへ渡します
+//===========================================================================
+class TexturePool final {
+   public:
+    static constexpr f32 PRIORITY_IMMEDIATE = 0.0f;       //!< 最優先 (システムテクスチャ/UI)
+    static constexpr f32 PRIORITY_DEFAULT   = 1.0e+6f;    //!< 描画されるまでの既定の優先
+
+    //! 統計情報
+    struct Stats {
+        u32 queued_count_  = 0;    //!< 読み込み待ち数
+        u32 loading_count_ = 0;    //!< 読み込み中数
+    };
+
+    //! @brief テクスチャを取得
+    //! @param [in] path        ファイルパス
+    //! @param [in] priority    読み込み優先 (小さいほど先に読み込む)
+    //! @return 共有テクスチャ (読み込み完了までは is_active() が false)
+    static std::shared_ptr<Texture> load(std::string_view path, f32 priority = PRIORITY_DEFAULT);
+
+    //! @brief 描画で使用したことを通知
+    //! @param [in] texture     テクスチャ (プール管理外は無視)
+    //! @param [in] priority    読み込み優先 (カメラからの距離など)
+    static void touch(const Texture* texture, f32 priority);
+
+    //! @brief 読み込みが終わっていないかどうか
+    //! @param [in] texture     テクスチャ (プール管理外は false)
+    static bool isPending(const Texture* texture);
+
+    //! @brief 更新 (1フレームに1回)
+    //! @details 完了した読み込みの反映と、優先順の読み込み開始を行います
+    static void update();
+
+    //! 読み込み中のものを待って管理情報を破棄
+    static void clear();
+
+    //! @brief 設定
+    //! @param [in] max_loading     同時に読み込む最大数
+    static void setup(u32 max_loading);
+
+    //! 統計情報を取得
+    static Stats stats();
+};
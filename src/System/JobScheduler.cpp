@@ -3,6 +3,11 @@
 //! @brief  ジョブスケジューラー
 //---------------------------------------------------------------------------
 #include "JobScheduler.h"
+#include "JobWorkerPool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
 
 struct JobHandleImpl: public JobHandle {
    public:
@@ -25,42 +30,46 @@ struct JobHandleImpl: public JobHandle {
 //! ジョブを一括実行します
 //---------------------------------------------------------------------------
 void JobGroup::execute() {
-    std::vector<Job> sorted_job;
+    auto start_time = std::chrono::steady_clock::now();
 
-    // 使用中リストを探索して直列に配置しなおす
-    // 途中に未使用領域があっても一列に詰められる
-    for(u32 index: job_used_list_) {
-        auto& job = jobs_[index];
+    // 登録状況が変わったときだけ並べなおす
+    if(dirty_)
+        rebuild();
 
-        // 一時無効になっているジョブは実行しない
-        if(job.first.priority_ & 0x80000000ul) {
-            continue;
-        }
+    auto& pool = JobWorkerPool::instance();
 
-        sorted_job.push_back(job);
-    }
+    std::vector<const std::function<void()>*> funcs;
+    for(auto& wave: waves_) {
+        funcs.clear();
 
-    //----------------------------------------------------------
-    // ジョブを実行優先順位でソート
-    //----------------------------------------------------------
-    auto compare = [&](const Job& a, const Job& b) {
-        return (a.first < b.first);
-    };
+        for(u32 i = wave.begin_; i < wave.end_; ++i) {
+            auto& job = jobs_[order_[i]];
 
-    std::stable_sort(std::begin(sorted_job), std::end(sorted_job), compare);
+            // 一時無効になっているジョブは実行しない
+            if(!job.enabled_)
+                continue;
 
-    //----------------------------------------------------------
-    // 実行
-    //----------------------------------------------------------
-    for(auto& job: sorted_job) {
-        job.second();
+            funcs.push_back(&job.func_);
+        }
+
+        //----------------------------------------------------------
+        // 実行 (1つしかない場合はスレッドを使わない)
+        //----------------------------------------------------------
+        if(funcs.size() <= 1 || pool.workerCount() == 0) {
+            for(auto func: funcs)
+                (*func)();
+        } else {
+            pool.run(funcs.data(), static_cast<u32>(funcs.size()));
+        }
     }
+
+    execute_time_ = std::chrono::duration<f32, std::milli>(std::chrono::steady_clock::now() - start_time).count();
 }
 
 //---------------------------------------------------------------------------
 //! ジョブを登録します
 //---------------------------------------------------------------------------
-JobHandle JobGroup::registerJob(const Priority& priority, const std::function<void()>& func) {
+JobHandle JobGroup::registerJob(const Priority& priority, const std::function<void()>& func, const JobAccess& access) {
     if(job_free_list_.empty()) {
         assert(false);
         return JobHandleImpl(0);    // エラー
@@ -70,29 +79,42 @@ JobHandle JobGroup::registerJob(const Priority& priority, const std::function<vo
     job_free_list_.pop_back();
 
     // 登録
-    jobs_[index] = std::move(Job{priority, func});
-    job_used_list_.push_back(index);    // 使用中にする
+    auto& job     = jobs_[index];
+    job.priority_ = priority;
+    job.func_     = func;
+    job.access_   = access;
+    job.serial_   = serial_++;
+    job.used_     = true;
+    job.enabled_  = true;
+
+    used_count_++;
+    dirty_ = true;
 
-    return JobHandleImpl(index | (0xbeef << 16));    // 上位16ビットをIDにすることで非0にする
+    // 上位16ビットを世代にすることで非0にし、解放済みハンドルも検出する
+    return JobHandleImpl(index | (static_cast<u32>(job.generation_) << 16));
 }
 
 //---------------------------------------------------------------------------
 //! ジョブを登録解除します
 //---------------------------------------------------------------------------
 void JobGroup::unregisterJob(const JobHandle& job_handle) {
-    auto value = static_cast<const JobHandleImpl&>(job_handle).value();
-
-    assert((value >> 16) == 0xbeef);    // ハンドルかどうかチェック
-    u32 index = value & 0xfffful;
-
-    // 番号がある場所を検索
-    auto it = std::find(job_used_list_.begin(), job_used_list_.end(), index);
-    if(it == job_used_list_.end()) {
-        // 使用中リスト内に見つからなかった場合（二重解放の疑いがある）
+    u32 index = slotIndex(job_handle);
+    if(index == ~0u) {
+        // 使用中のハンドルではなかった場合（二重解放の疑いがある）
         assert(false);
         return;
     }
-    job_used_list_.erase(it);
+
+    auto& job = jobs_[index];
+    job.used_ = false;
+    job.func_ = nullptr;
+
+    // 世代を進めて古いハンドルを無効にする (0は使わない)
+    if(++job.generation_ == 0)
+        job.generation_ = 1;
+
+    used_count_--;
+    dirty_ = true;
 
     // 返却
     job_free_list_.push_back(index);
@@ -102,32 +124,169 @@ void JobGroup::unregisterJob(const JobHandle& job_handle) {
 //! 対象のジョブを有効にする
 //---------------------------------------------------------------------------
 void JobGroup::enableJob(const JobHandle& job_handle) {
-    auto value = static_cast<const JobHandleImpl&>(job_handle).value();
-
-    assert((value >> 16) == 0xbeef);    // ハンドルかどうかチェック
-    u32 index = value & 0xfffful;
+    u32 index = slotIndex(job_handle);
+    assert(index != ~0u);    // ハンドルかどうかチェック
 
-    jobs_[index].first.priority_ &= ~0x80000000ul;
+    jobs_[index].enabled_ = true;
 }
 
 //---------------------------------------------------------------------------
 //! 対象のジョブを無効にする
 //---------------------------------------------------------------------------
 void JobGroup::disableJob(const JobHandle& job_handle) {
-    auto value = static_cast<const JobHandleImpl&>(job_handle).value();
+    u32 index = slotIndex(job_handle);
+    assert(index != ~0u);    // ハンドルかどうかチェック
+
+    jobs_[index].enabled_ = false;
+}
 
-    assert((value >> 16) == 0xbeef);    // ハンドルかどうかチェック
-    u32 index = value & 0xfffful;
+//---------------------------------------------------------------------------
+//! 登録されているジョブ数
+//---------------------------------------------------------------------------
+u32 JobGroup::jobCount() const {
+    return used_count_;
+}
 
-    jobs_[index].first.priority_ |= 0x80000000ul;
+//---------------------------------------------------------------------------
+//! 実行段数
+//---------------------------------------------------------------------------
+u32 JobGroup::waveCount() const {
+    return static_cast<u32>(waves_.size());
+}
+
+//---------------------------------------------------------------------------
+//! 前回の execute() の処理時間(ms)
+//---------------------------------------------------------------------------
+f32 JobGroup::executeTime() const {
+    return execute_time_;
+}
+
+//---------------------------------------------------------------------------
+//! ワーカースレッド数
+//---------------------------------------------------------------------------
+u32 JobGroup::workerCount() {
+    return JobWorkerPool::instance().workerCount();
 }
 
 //---------------------------------------------------------------------------
 //! コンストラクタ
 //---------------------------------------------------------------------------
 JobGroup::JobGroup(u32 job_max_count): jobs_(job_max_count) {
+    assert(job_max_count <= 0x10000ul);    // スロット番号は下位16ビット
+
     // 未使用リストに通し番号(すべての番号)を設定しておく
-    for(u32 i = 0; i < job_max_count; ++i) {
-        job_free_list_.push_back(i);
+    // 末尾から取り出すので若い番号から使われるように逆順で積む
+    for(u32 i = job_max_count; i > 0; --i) {
+        job_free_list_.push_back(i - 1);
     }
 }
+
+//---------------------------------------------------------------------------
+//! ハンドルからスロット番号を取得 (無効なハンドルなら~0)
+//---------------------------------------------------------------------------
+u32 JobGroup::slotIndex(const JobHandle& job_handle) const {
+    auto value = static_cast<const JobHandleImpl&>(job_handle).value();
+
+    u32 index      = value & 0xfffful;
+    u32 generation = value >> 16;
+    if(index >= jobs_.size())
+        return ~0u;
+
+    auto& job = jobs_[index];
+    if(!job.used_ || job.generation_ != generation)
+        return ~0u;
+
+    return index;
+}
+
+//---------------------------------------------------------------------------
+//! 実行順と実行段を作り直す
+//---------------------------------------------------------------------------
+void JobGroup::rebuild() {
+    order_.clear();
+    waves_.clear();
+
+    for(u32 i = 0; i < static_cast<u32>(jobs_.size()); ++i) {
+        if(jobs_[i].used_)
+            order_.push_back(i);
+    }
+
+    //----------------------------------------------------------
+    // ジョブを実行優先順位でソート (同じ優先は登録順)
+    //----------------------------------------------------------
+    auto compare = [&](u32 a, u32 b) {
+        auto& job_a = jobs_[a];
+        auto& job_b = jobs_[b];
+        if(job_a.priority_ != job_b.priority_)
+            return job_a.priority_ < job_b.priority_;
+        return job_a.serial_ < job_b.serial_;
+    };
+    std::sort(order_.begin(), order_.end(), compare);
+
+    //----------------------------------------------------------
+    // 同じ優先の中で実行段を決める
+    // データのビットごとに最後に読み書きした段を覚えておき、
+    // 競合するジョブはその次の段に置く
+    //----------------------------------------------------------
+    std::vector<u32> levels(order_.size());
+
+    u32 begin = 0;
+    while(begin < order_.size()) {
+        u32 end = begin + 1;
+        while(end < order_.size() && jobs_[order_[end]].priority_ == jobs_[order_[begin]].priority_)
+            ++end;
+
+        u32 last_read[64]  = {};    // 最後に読み込んだ段+1
+        u32 last_write[64] = {};    // 最後に書き込んだ段+1
+        u32 level_count    = 0;
+
+        for(u32 i = begin; i < end; ++i) {
+            auto& access = jobs_[order_[i]].access_;
+
+            u32 level = 0;
+            for(u32 bit = 0; bit < 64; ++bit) {
+                u64 mask = 1ull << bit;
+                if(access.read_ & mask)
+                    level = std::max(level, last_write[bit]);
+                if(access.write_ & mask)
+                    level = std::max(level, std::max(last_write[bit], last_read[bit]));
+            }
+
+            for(u32 bit = 0; bit < 64; ++bit) {
+                u64 mask = 1ull << bit;
+                if(access.read_ & mask)
+                    last_read[bit] = std::max(last_read[bit], level + 1);
+                if(access.write_ & mask)
+                    last_write[bit] = level + 1;
+            }
+
+            levels[i]   = level;
+            level_count = std::max(level_count, level + 1);
+        }
+
+        // 段ごとに並べなおす (段の中は登録順のまま)
+        std::vector<u32> group(order_.begin() + begin, order_.begin() + end);
+        std::vector<u32> group_levels(levels.begin() + begin, levels.begin() + end);
+
+        u32 pos = begin;
+        for(u32 level = 0; level < level_count; ++level) {
+            u32 wave_begin = pos;
+            for(u32 i = 0; i < static_cast<u32>(group.size()); ++i) {
+                if(group_levels[i] == level)
+                    order_[pos++] = group[i];
+            }
+            waves_.push_back({wave_begin, pos});
+        }
+
+        begin = end;
+    }
+
+    dirty_ = false;
+}
+
+//---------------------------------------------------------------------------
+//! バックグラウンドでジョブを実行します
+//---------------------------------------------------------------------------
+void runJobAsync(std::function<void()> func) {
+    JobWorkerPool::instance().submit(std::move(func));
+}
@@ -4,13 +4,42 @@
 //---------------------------------------------------------------------------
 #pragma once
 
+#include "Priority.h"
+
+#include <functional>
+#include <vector>
+
 //===========================================================================
 //! ジョブハンドル
 //! @note 登録されたジョブを管理するためのハンドルです
 //===========================================================================
 struct JobHandle {
    protected:
-    u32 value_ = 0;    //!< ハンドル値
+    u32 value_ = 0;    //!< ハンドル値 (上位16ビット:世代 下位16ビット:スロット番号)
+};
+
+//===========================================================================
+//! ジョブのデータアクセス宣言
+//! @note 読み書きするデータをビット(最大64種類)で宣言します。
+//!       同じ Priority のジョブ同士で書き込みが重ならなければ並列に実行されます。
+//!       省略した場合はすべてのデータを読み書きする扱いになり、直列に実行されます。
+//
+//  【使用例】
+//  JobAccess(READ_TRANSFORM, WRITE_MODEL | WRITE_EFFECT)
+//===========================================================================
+struct JobAccess {
+    //! コンストラクタ
+    //! @param  [in]    read    読み込むデータのビット
+    //! @param  [in]    write   書き込むデータのビット
+    JobAccess(u64 read = ~0ull, u64 write = ~0ull): read_(read), write_(write) {}
+
+    //! 同時に実行できないか
+    bool conflict(const JobAccess& other) const {
+        return (write_ & (other.read_ | other.write_)) || (other.write_ & read_);
+    }
+
+    u64 read_;     //!< 読み込むデータ
+    u64 write_;    //!< 書き込むデータ
 };
 
 //===========================================================================
@@ -21,17 +50,19 @@ class JobGroup final
     , nonmovable {
    public:
     //  ジョブを一括実行します
+    //! @note 同じ Priority で依存のないジョブはワーカースレッドで並列に実行されます
     void execute();
 
     //  ジョブを登録します
     //! @param  [in]    priority    実行優先順位
     //! @param  [in]    func        実行する関数
+    //! @param  [in]    access      読み書きするデータ (省略時は直列実行)
     //! @return 登録されたジョブハンドル (0なら登録失敗)
     //! @note 一度登録状態になったジョブは常に登録されたままになります。
     //
     //  【使用例】
     // registerJob(Priority(カテゴリーTYPE, TYPEの中の優先度), [](){ ラムダ式 })
-    JobHandle registerJob(const Priority& priority, const std::function<void()>& func);
+    JobHandle registerJob(const Priority& priority, const std::function<void()>& func, const JobAccess& access = {});
 
     //  ジョブを登録解除します
     //! @param  [in]    ジョブハンドル
@@ -47,18 +78,59 @@ class JobGroup final
     //! @note 無効化されたジョブは登録状態のまま呼び出しが停止されます
     void disableJob(const JobHandle& job_handle);
 
+    //! 登録されているジョブ数
+    u32 jobCount() const;
+
+    //! 実行段数 (並列実行できる単位の数)
+    u32 waveCount() const;
+
+    //! 前回の execute() の処理時間(ms)
+    f32 executeTime() const;
+
+    //! ワーカースレッド数
+    static u32 workerCount();
+
    public:
     // コンストラクタ
-    //! @param  [in]    job_max_count   ジョブ登録最大数
+    //! @param  [in]    job_max_count   ジョブ登録最大数 (最大65536)
     JobGroup(u32 job_max_count = 10000);
 
     //! デストラクタ
     virtual ~JobGroup() = default;
 
    private:
-    using Job = std::pair<Priority, std::function<void()>>;
+    //! ジョブ実体
+    struct Job {
+        Priority              priority_;              //!< 実行優先順位
+        std::function<void()> func_;                  //!< 実行する関数
+        JobAccess             access_;                //!< 読み書きするデータ
+        u64                   serial_     = 0;        //!< 登録通し番号 (同じ優先は登録順)
+        u16                   generation_ = 1;        //!< 世代 (解放済みハンドルの検出用)
+        bool                  used_       = false;    //!< 使用中
+        bool                  enabled_    = true;     //!< 有効
+    };
 
-    std::vector<Job> jobs_;             //!< ジョブ実体
-    std::vector<u32> job_free_list_;    //!< 空いているジョブスロットの一覧
-    std::vector<u32> job_used_list_;    //!< 使用中ジョブスロットの一覧
+    //! 実行段 (同時に実行できるジョブの並び)
+    struct Wave {
+        u32 begin_;    //!< order_ の開始位置
+        u32 end_;      //!< order_ の終了位置
+    };
+
+    u32  slotIndex(const JobHandle& job_handle) const;    //!< ハンドルからスロット番号を取得
+    void rebuild();                                       //!< 実行順と実行段を作り直す
+
+    std::vector<Job>  jobs_;                   //!< ジョブ実体
+    std::vector<u32>  job_free_list_;          //!< 空いているジョブスロットの一覧
+    std::vector<u32>  order_;                  //!< 実行順に並べたスロット番号 (実行段ごとに連続)
+    std::vector<Wave> waves_;                  //!< 実行段
+    u32               used_count_   = 0;       //!< 使用中ジョブ数
+    u64               serial_       = 0;       //!< 登録通し番号
+    bool              dirty_        = false;   //!< 実行順の作り直しが必要
+    f32               execute_time_ = 0.0f;    //!< 前回の処理時間(ms)
 };
+
+//  バックグラウンドでジョブを実行します
+//! @param  [in]    func    実行する関数
+//! @note 完了は待ちません。ワーカースレッドが空いているときに実行され、
+//!       JobGroup::execute() の呼び出し元スレッドが実行することはありません
+void runJobAsync(std::function<void()> func);
@@ -0,0 +1,191 @@
+﻿//---------------------------------------------------------------------------
+//! @file   JobWorkerPool.cpp
+//! @brief  ワーカースレッドプール
+//---------------------------------------------------------------------------
+#include "JobWorkerPool.h"
+
+#include <algorithm>
+
+//---------------------------------------------------------------------------
+//! インスタンス取得
+//---------------------------------------------------------------------------
+JobWorkerPool& JobWorkerPool::instance() {
+    static JobWorkerPool pool;
+    return pool;
+}
+
+//---------------------------------------------------------------------------
+//! 関数をまとめて実行し、すべて終了するまで待ちます
+//---------------------------------------------------------------------------
+void JobWorkerPool::run(const std::function<void()>* const* funcs, u32 count) {
+    Batch batch;
+    batch.remaining_ = count;
+
+    // 各キューへ順に振り分ける (最後のキューは呼び出し元用)
+    const u32 queue_count = static_cast<u32>(queues_.size());
+    for(u32 i = 0; i < count; ++i) {
+        auto& queue = *queues_[i % queue_count];
+
+        std::lock_guard lock(queue.mutex_);
+        queue.tasks_.push_back({funcs[i], &batch});
+    }
+    queued_.fetch_add(count);
+
+    {
+        std::lock_guard lock(sleep_mutex_);
+    }
+    wake_.notify_all();
+
+    // 呼び出し元も処理に参加する
+    const u32 self = queue_count - 1;
+    while(batch.remaining_.load(std::memory_order_acquire) > 0) {
+        Task task;
+        if(pop(self, task) || steal(self, task))
+            execute(task);
+        else
+            std::this_thread::yield();
+    }
+
+    // ワーカーが batch を参照しなくなってから例外を投げなおす
+    if(batch.error_)
+        std::rethrow_exception(batch.error_);
+}
+
+//---------------------------------------------------------------------------
+//! 関数をバックグラウンドで実行します
+//---------------------------------------------------------------------------
+void JobWorkerPool::submit(std::function<void()> func) {
+    {
+        std::lock_guard lock(background_mutex_);
+        background_.push_back(std::move(func));
+    }
+    queued_.fetch_add(1);
+
+    {
+        std::lock_guard lock(sleep_mutex_);
+    }
+    wake_.notify_one();
+}
+
+//---------------------------------------------------------------------------
+//! コンストラクタ
+//---------------------------------------------------------------------------
+JobWorkerPool::JobWorkerPool(u32 worker_count) {
+    // バックグラウンド処理のために最低1つはワーカーを用意する
+    u32 workers = worker_count;
+    if(workers == 0)
+        workers = std::max(2u, std::thread::hardware_concurrency()) - 1;
+
+    for(u32 i = 0; i < workers + 1; ++i)
+        queues_.push_back(std::make_unique<Queue>());
+
+    for(u32 i = 0; i < workers; ++i)
+        threads_.emplace_back([this, i]() { workerMain(i); });
+}
+
+//---------------------------------------------------------------------------
+//! デストラクタ
+//---------------------------------------------------------------------------
+JobWorkerPool::~JobWorkerPool() {
+    {
+        std::lock_guard lock(sleep_mutex_);
+        quit_ = true;
+    }
+    wake_.notify_all();
+
+    for(auto& thread: threads_)
+        thread.join();
+}
+
+//---------------------------------------------------------------------------
+//! 自分のキューの末尾から取り出す
+//---------------------------------------------------------------------------
+bool JobWorkerPool::pop(u32 index, Task& task) {
+    auto& queue = *queues_[index];
+
+    std::lock_guard lock(queue.mutex_);
+    if(queue.tasks_.empty())
+        return false;
+
+    task = queue.tasks_.back();
+    queue.tasks_.pop_back();
+    queued_.fetch_sub(1);
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! 他のキューの先頭から盗む
+//---------------------------------------------------------------------------
+bool JobWorkerPool::steal(u32 index, Task& task) {
+    const u32 queue_count = static_cast<u32>(queues_.size());
+    for(u32 i = 1; i < queue_count; ++i) {
+        auto& queue = *queues_[(index + i) % queue_count];
+
+        std::lock_guard lock(queue.mutex_);
+        if(queue.tasks_.empty())
+            continue;
+
+        task = queue.tasks_.front();
+        queue.tasks_.pop_front();
+        queued_.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+
+//---------------------------------------------------------------------------
+//! バックグラウンド処理を取り出す
+//---------------------------------------------------------------------------
+bool JobWorkerPool::popBackground(std::function<void()>& func) {
+    std::lock_guard lock(background_mutex_);
+    if(background_.empty())
+        return false;
+
+    func = std::move(background_.front());
+    background_.pop_front();
+    queued_.fetch_sub(1);
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! 実行
+//---------------------------------------------------------------------------
+void JobWorkerPool::execute(const Task& task) {
+    // 例外はここで受け止めて呼び出し元へ渡す
+    // (ワーカーから投げると std::terminate、呼び出し元から投げると待たずに batch が解放される)
+    try {
+        (*task.func_)();
+    } catch(...) {
+        std::lock_guard lock(task.batch_->mutex_);
+        if(!task.batch_->error_)
+            task.batch_->error_ = std::current_exception();
+    }
+
+    // 減らした後は呼び出し元が batch を解放するため触らない
+    task.batch_->remaining_.fetch_sub(1, std::memory_order_release);
+}
+
+//---------------------------------------------------------------------------
+//! ワーカースレッド
+//---------------------------------------------------------------------------
+void JobWorkerPool::workerMain(u32 index) {
+    for(;;) {
+        Task task;
+        if(pop(index, task) || steal(index, task)) {
+            execute(task);
+            continue;
+        }
+
+        // フレーム内のジョブを優先し、空いているときにバックグラウンド処理を行う
+        std::function<void()> func;
+        if(popBackground(func)) {
+            func();
+            continue;
+        }
+
+        std::unique_lock lock(sleep_mutex_);
+        wake_.wait(lock, [this]() { return quit_ || queued_.load() > 0; });
+        if(quit_)
+            return;
+    }
+}
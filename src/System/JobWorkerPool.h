@@ -0,0 +1,85 @@
+﻿//---------------------------------------------------------------------------
+//! @file   JobWorkerPool.h
+//! @brief  ワーカースレッドプール
+//! @note   DxLib に依存しないため単体テストからも直接利用できます
+//---------------------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//===========================================================================
+//! ワーカースレッドプール (ワークスティーリング)
+//! @note 各スレッドが自分のキューの末尾から取り出し、空なら他のキューの先頭から盗みます
+//===========================================================================
+class JobWorkerPool final : noncopyable {
+   public:
+    //! インスタンス取得
+    static JobWorkerPool& instance();
+
+    //! ワーカースレッド数
+    u32 workerCount() const {
+        return static_cast<u32>(threads_.size());
+    }
+
+    //! @brief 関数をまとめて実行し、すべて終了するまで待ちます
+    //! @details 呼び出し元のスレッドも実行に参加します。
+    //!          関数が例外を投げた場合もすべての終了を待ってから、最初の例外を呼び出し元へ投げなおします
+    //! @note 呼び出し元用のキューはすべての呼び出し元で共有されます。
+    //!       複数スレッドから同時に、またはジョブの中から入れ子で呼んでもかまいませんが、
+    //!       待っている間は他の呼び出しのタスクも実行するため、完了が遅れることがあります
+    void run(const std::function<void()>* const* funcs, u32 count);
+
+    //! @brief 関数をバックグラウンドで実行します (完了は待たない)
+    //! @details ワーカースレッドのみが実行し、run() の呼び出し元が拾うことはありません
+    void submit(std::function<void()> func);
+
+    // コンストラクタ
+    //! @param  [in]    worker_count    ワーカースレッド数 (0なら論理コア数-1、最低1)
+    explicit JobWorkerPool(u32 worker_count = 0);
+
+    //! デストラクタ
+    ~JobWorkerPool();
+
+   private:
+    //! run() 1回分の完了待ち
+    struct Batch {
+        std::atomic<u32>   remaining_;    //!< 残り数
+        std::mutex         mutex_;        //!< error_ の保護
+        std::exception_ptr error_;        //!< 最初に発生した例外
+    };
+
+    //! 実行単位
+    struct Task {
+        const std::function<void()>* func_  = nullptr;    //!< 実行する関数
+        Batch*                       batch_ = nullptr;    //!< 呼び出し元の完了待ち
+    };
+
+    //! スレッドごとのキュー
+    struct Queue {
+        std::mutex       mutex_;
+        std::deque<Task> tasks_;
+    };
+
+    bool        pop(u32 index, Task& task);                    //!< 自分のキューの末尾から取り出す
+    bool        steal(u32 index, Task& task);                  //!< 他のキューの先頭から盗む
+    bool        popBackground(std::function<void()>& func);    //!< バックグラウンド処理を取り出す
+    static void execute(const Task& task);                     //!< 実行
+    void        workerMain(u32 index);                         //!< ワーカースレッド
+
+    std::vector<std::unique_ptr<Queue>> queues_;              //!< キュー (ワーカー数+呼び出し元)
+    std::mutex                          background_mutex_;    //!< バックグラウンド処理の保護
+    std::deque<std::function<void()>>   background_;          //!< バックグラウンド処理
+    std::vector<std::thread>            threads_;             //!< ワーカースレッド
+    std::mutex                          sleep_mutex_;         //!< 待機用
+    std::condition_variable             wake_;                //!< 起床通知
+    std::atomic<u32>                    queued_ = 0;          //!< キューに入っている数
+    bool                                quit_   = false;      //!< 終了要求
+};
@@ -253,7 +253,7 @@ void Object::PostDraw() {}
 void Object::PrePhysics() {
 #ifdef USE_JOLT_PHYSICS
 #else
-    if(GetComponent<ComponentTransform>()) {
+    if(FindComponent<ComponentTransform>()) {
         float3 g = gravity_;
         Matrix()._41_42_43 += gravity_;
         gravity_ = 0.0f;
@@ -270,7 +270,7 @@ void Object::InitSerialize() {
 }
 
 void Object::UseWarp() {
-    if(auto trns = GetComponent<ComponentTransform>())
+    if(auto trns = FindComponent<ComponentTransform>())
         trns->PostUpdate();
 }
 
@@ -289,7 +289,17 @@ void Object::RegisterCurrentScene(ObjectPtr obj) {
 //! @param b セットするビット
 //! @param on 状態
 void Object::SetStatus(StatusBit b, bool on) {
+    bool changed = status_.is(b) != on;
     on ? status_.on(b) : status_.off(b);
+
+    // 処理の停止に関係するものが変化したときだけシーンに反映してもらう
+    if(changed && (b == StatusBit::NoUpdate || b == StatusBit::NoDraw || b == StatusBit::DisablePause || b == StatusBit::IsPause))
+        requestState();
+}
+
+//! @brief 処理状態(処理登録/ポーズ/更新/描画)の再設定をシーンに予約する
+void Object::requestState() {
+    Scene::RequestObjectState(this);
 }
 
 //! @brief ステータス取得
@@ -325,8 +335,13 @@ void Object::ModifyComponents() {
         if(c->status_.is(Component::StatusBit::Exited)) {
             auto comp = components.begin() + i;
 
-            ComponentWeakPtr weak_comp = *comp;
-            components.erase(comp);    //解放処理(自動delete)
+            // 型インデックスから外してから解放する (解放中に検索されても解放済みのものを返さない)
+            ComponentPtr released = std::move(*comp);
+            components.erase(comp);
+            buildComponentIndex();
+
+            ComponentWeakPtr weak_comp = released;
+            released.reset();    //解放処理(自動delete)
 
             if(weak_comp.lock() != nullptr) {
                 // どこかに残っているので一旦確保
@@ -336,6 +351,38 @@ void Object::ModifyComponents() {
     }
 }
 
+//! @brief 型情報に一致するコンポーネント一覧を取得
+//! @param type 型情報
+//! @return 型(派生型を含む)に一致するコンポーネント
+std::span<Component* const> Object::findComponentIndex(const TypeInfo* type) const {
+    auto itr = component_index_.find(type);
+    if(itr == component_index_.end())
+        return {};
+
+    return itr->second;
+}
+
+//! @brief コンポーネントの型インデックスを構築
+void Object::buildComponentIndex() {
+    // 配列の確保を減らすため、キーは残したまま中身だけ空にする
+    for(auto& [type, cmps]: component_index_)
+        cmps.clear();
+
+    for(auto& cmp: components_) {
+        // 自分の型から親の型へさかのぼって登録する
+        for(const TypeInfo* type = cmp->typeInfo(); type && type != &TypeInfo::Root; type = type->parent())
+            component_index_[type].push_back(cmp.get());
+    }
+
+    // 位置の取得は頻繁に行われるためTransformは個別に確保しておく
+    transform_component_ = nullptr;
+    if(auto itr = component_index_.find(&ComponentTransform::Type); itr != component_index_.end() && !itr->second.empty())
+        transform_component_ = static_cast<ComponentTransform*>(itr->second.front());
+
+    // 構成が変わった可能性があるためワールド行列のキャッシュを無効にする
+    component_index_version_ = WorldMatrixCache::NewVersion();
+}
+
 //! コンポーネント削除
 //! @param [in] component 削除するコンポーネント
 void Object::RemoveComponent(ComponentPtr component) {
@@ -347,6 +394,9 @@ void Object::RemoveComponent(ComponentPtr component) {
             break;
         }
     }
+
+    // 次のPreUpdateで終了したコンポーネントを取り除く
+    requestState();
 }
 
 //! @brief コンポーネントをすべて削除する
@@ -399,7 +449,7 @@ void Object::ClearObjectNames() {
 //! @brief TransformのMatrix情報を取得します
 //! @return ComponentTransform の Matrix
 matrix& Object::Matrix() {
-    auto cmp = GetComponent<ComponentTransform>();
+    auto cmp = findTransform();
 
     assert(cmp && "このオブジェクトは、ComponentTransformが存在していません。位置移動はできません");
 
@@ -407,17 +457,18 @@ matrix& Object::Matrix() {
 }
 
 const matrix& Object::GetMatrix() const {
-    auto cmp = GetComponent<ComponentTransform>();
+    auto cmp = findTransform();
 
     assert(cmp && "このオブジェクトは、ComponentTransformが存在していません。位置移動はできません");
 
-    return cmp->Matrix();
+    // 参照のみのため Matrix() は使わない (ワールド行列のバージョンを進めない)
+    return cmp->GetMatrix();
 }
 
 //! @brief ワールドMatrixの取得
 //! @return 他のコンポーネントも含めた位置
 const matrix Object::GetOldWorldMatrix() const {
-    auto cmp = GetComponent<ComponentTransform>();
+    auto cmp = findTransform();
 
     assert(cmp && "このオブジェクトは、ComponentTransformが存在していません。位置移動はできません");
 
@@ -427,11 +478,34 @@ const matrix Object::GetOldWorldMatrix() const {
 //! @brief ワールドMatrixの設定
 
 void Object::SetWorldMatrix(const matrix& mat) {
-    if(auto cmp = GetComponent<ComponentTransform>()) {
+    if(auto cmp = FindComponent<ComponentTransform>()) {
         cmp->SetWorldMatrix(mat);
     }
 }
 
+//! @brief 描画用Matrixの取得
+
+const matrix Object::GetDrawMatrix() const {
+    auto cmp = findTransform();
+    assert(cmp && "このオブジェクトは、ComponentTransformが存在していません。位置移動はできません");
+    return cmp->GetDrawMatrix();
+}
+
+//! @brief 描画専用Matrixの設定
+
+void Object::SetDrawMatrix(const matrix& mat) {
+    if(auto cmp = FindComponent<ComponentTransform>()) {
+        cmp->SetDrawMatrix(mat);
+    }
+}
+
+//! @brief 描画専用Matrixが設定されているか
+
+bool Object::HasDrawMatrix() const {
+    auto cmp = findTransform();
+    return cmp && cmp->HasDrawMatrix();
+}
+
 int Object::GetVersion() {
     return cereal::detail::Version<Object>::version;
 }
@@ -18,6 +18,7 @@
 
 #include <string>
 #include <memory>
+#include <span>
 
 //---------------------------------------------------------------------------
 // ポインター宣言
@@ -163,6 +164,91 @@ class ClassObjectType: public ObjTypeInfo {
 //***************************************************************************
 //***************************************************************************
 
+//===========================================================================
+//! コンポーネント型別ビュー
+//! @note Objectが持つ型インデックスを直接参照するため配列の確保は行いません。
+//!       コンポーネントの追加/削除を行うと無効になるため、保持せずにその場で使用してください
+//===========================================================================
+template<class T>
+class ComponentView {
+   public:
+    //! BP_COMPONENT_DECLで自身の型情報を持っているか (持たない場合は親の型で引いてキャストで絞り込む)
+    static constexpr bool exact = std::is_same_v<typename T::ComponentClass, T>;
+
+    class iterator {
+       public:
+        iterator(Component* const* p, Component* const* end): p_(p), end_(end) {
+            skip();
+        }
+
+        T* operator*() const {
+            if constexpr(exact)
+                return static_cast<T*>(*p_);
+            else
+                return dynamic_cast<T*>(*p_);
+        }
+
+        iterator& operator++() {
+            ++p_;
+            skip();
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const {
+            return p_ == other.p_;
+        }
+
+       private:
+        //! 対象の型ではないものを飛ばす
+        void skip() {
+            if constexpr(!exact) {
+                while(p_ != end_ && dynamic_cast<T*>(*p_) == nullptr)
+                    ++p_;
+            }
+        }
+
+        Component* const* p_;
+        Component* const* end_;
+    };
+
+    ComponentView() = default;
+    ComponentView(std::span<Component* const> span): span_(span) {}
+
+    iterator begin() const {
+        return iterator(span_.data(), span_.data() + span_.size());
+    }
+
+    iterator end() const {
+        return iterator(span_.data() + span_.size(), span_.data() + span_.size());
+    }
+
+    //! 要素数
+    size_t size() const {
+        if constexpr(exact) {
+            return span_.size();
+        } else {
+            size_t count = 0;
+            for(auto it = begin(); it != end(); ++it)
+                count++;
+            return count;
+        }
+    }
+
+    //! 空か
+    bool empty() const {
+        return begin() == end();
+    }
+
+    //! 先頭の要素 (存在しない場合はnullptr)
+    T* front() const {
+        auto it = begin();
+        return it == end() ? nullptr : *it;
+    }
+
+   private:
+    std::span<Component* const> span_;
+};
+
 //---------------------------------------------------------------------------
 //! オブジェクトクラス
 //---------------------------------------------------------------------------
@@ -274,12 +360,25 @@ class Object
     template<class T>
     std::shared_ptr<T> GetComponent(const std::string_view& name = "") const;
 
+    //! コンポーネント取得 (参照カウントを増やさない)
+    //! @tparam T コンポーネントタイプ
+    //! @return コンポーネント (存在しない場合はnullptr)
+    //! @attention ポインタを保持する場合はGetComponent()を使用してください
+    template<class T>
+    T* FindComponent(const std::string_view& name = "") const;
+
     template<class T>
     std::vector<std::shared_ptr<T>> GetComponents();
 
     template<class T>
     std::vector<std::shared_ptr<T>> GetComponents() const;
 
+    //! 複数コンポーネントの取得 (配列を作成しない)
+    //! @tparam T コンポーネントタイプ
+    //! @return コンポーネントのビュー
+    template<class T>
+    ComponentView<T> ViewComponents() const;
+
     //! コンポーネント削除
     //! @tparam [in] class T コンポーネントタイプ
     template<class T>
@@ -303,7 +402,7 @@ class Object
     //! @brief コンポーネントのヒットコールバック
     //! @param hitInfo ヒット情報
     virtual void OnHit([[maybe_unused]] const ComponentCollision::HitInfo& hit_info) {
-        if(auto cmp = GetComponent<ComponentTransform>()) {
+        if(auto cmp = FindComponent<ComponentTransform>()) {
             cmp->AddTranslate(hit_info.push_);
         }
         // 地面に当たっている時
@@ -316,7 +415,17 @@ class Object
 #pragma warning(default: 26813)
     }
 
-    virtual void ExitHit([[maybe_unused]] const ComponentCollision::HitInfo& hit_info) {}
+    //! @brief コンポーネントの接触開始コールバック
+    //! @param contact_info 接触情報
+    virtual void OnHitEnter([[maybe_unused]] const ComponentCollision::ContactInfo& contact_info) {}
+
+    //! @brief コンポーネントの接触継続コールバック
+    //! @param contact_info 接触情報
+    virtual void OnHitStay([[maybe_unused]] const ComponentCollision::ContactInfo& contact_info) {}
+
+    //! @brief コンポーネントの接触終了コールバック
+    //! @param contact_info 接触情報
+    virtual void OnHitExit([[maybe_unused]] const ComponentCollision::ContactInfo& contact_info) {}
 
     //! @brief コンポーネントのヒットコールバック
     //! @param hitInfo ヒット情報
@@ -354,6 +463,7 @@ class Object
         auto& proc = GetProc(proc_name, timing);
         if(proc_name != proc.GetName() || timing != proc.GetTiming() || prio != proc.GetPriority() || proc.IsDirty()) {
             proc.SetProc(proc_name, timing, prio, func);
+            requestState();
         }
         return proc;
     }
@@ -363,6 +473,7 @@ class Object
         auto& proc = GetProc(func->GetName(), timing);
         if(func->GetName() != proc.GetName() || timing != proc.GetTiming() || prio != proc.GetPriority() || proc.IsDirty()) {
             proc.SetAddProc(func, timing, prio);
+            requestState();
         }
         return proc;
     }
@@ -397,11 +508,21 @@ class Object
     //! @brief ワールドMatrixの取得
     //! @return 他のコンポーネントも含めた位置
     virtual const matrix GetWorldMatrix() const override {
-        auto cmp = GetComponent<ComponentTransform>();
+        auto cmp = findTransform();
         assert(cmp && "このオブジェクトは、ComponentTransformが存在していません。位置移動はできません");
         return cmp->GetWorldMatrix();
     }
 
+    //! @brief ワールド行列のバージョン取得
+    //! @details Transformの変更やコンポーネント構成の変化で値が変わります。
+    //!          コンポーネントのワールド行列キャッシュの判定に使用します
+    u64 GetWorldVersion() const {
+        auto cmp = findTransform();
+        if(!cmp)
+            return component_index_version_;
+        return std::max(component_index_version_, cmp->GetWorldVersion());
+    }
+
     //! @brief ワールドMatrixの取得
     //! @return 他のコンポーネントも含めた位置
     virtual const matrix GetOldWorldMatrix() const override;
@@ -409,6 +530,16 @@ class Object
     //! @brief ワールドMatrixの設定
     void SetWorldMatrix(const matrix& mat);
 
+    //! @brief 描画用Matrixの取得
+    //! @return 描画専用の姿勢が設定されていなければワールドMatrix
+    const matrix GetDrawMatrix() const;
+
+    //! @brief 描画専用Matrixの設定 (ワールド行列は変更せず、次のPreUpdateで解除)
+    void SetDrawMatrix(const matrix& mat);
+
+    //! @brief 描画専用Matrixが設定されているか
+    bool HasDrawMatrix() const;
+
     //@}
     //----------------------------------------------------------------------
     //! @name システム処理系
@@ -425,6 +556,12 @@ class Object
     //! 使用していないコンポーネントの削除
     void ModifyComponents();
 
+    //! コンポーネントの型インデックスを作り直す
+    //! @note components_ を直接変更した場合に、メインスレッドで呼んでください
+    void RebuildComponentIndex() {
+        buildComponentIndex();
+    }
+
     //! 使用している名前リストを消去する
     //! ステージ移行などでオブジェクトが消去されたときに呼ぶ
     static void ClearObjectNames();
@@ -457,6 +594,33 @@ class Object
 
     std::string setUniqueName(const std::string& name);
 
+    //! @brief 処理状態(処理登録/ポーズ/更新/描画)の再設定をシーンに予約する
+    //! @details 予約されたものだけが次のPreUpdateでまとめて反映されます
+    void requestState();
+
+    bool scene_registered_ = false;    //!< シーンに本登録されている
+    bool state_requested_  = false;    //!< 処理状態の再設定を予約済み
+
+    //! 型情報に一致するコンポーネント一覧を取得
+    //! @param type 型情報
+    //! @return 型(派生型を含む)に一致するコンポーネント
+    std::span<Component* const> findComponentIndex(const TypeInfo* type) const;
+
+    //! @brief コンポーネントの型インデックスを構築
+    //! @details コンポーネントの追加/削除時にメインスレッドで作り直します。
+    //!          検索は読むだけになるため、ジョブのワーカースレッドから同時に呼んでもかまいません
+    void buildComponentIndex();
+
+    //! ComponentTransformの取得 (型インデックス構築時に確保したもの)
+    ComponentTransform* findTransform() const {
+        return transform_component_;
+    }
+
+    //! 型情報 → コンポーネント (親の型情報でも引けるように継承をさかのぼって登録)
+    std::unordered_map<const TypeInfo*, std::vector<Component*>> component_index_;
+    u64                 component_index_version_ = 0;          //!< 構築時に発行したバージョン
+    ComponentTransform* transform_component_     = nullptr;    //!< 型インデックス内のTransform
+
    private:
     //--------------------------------------------------------------------
     //! @name Cereal処理
@@ -469,6 +633,8 @@ class Object
         arc(CEREAL_NVP(components_));
         arc(CEREAL_NVP(gravity_));
 
+        buildComponentIndex();
+
         status_.off(StatusBit::Serialized);
     }
     //@}
@@ -503,6 +669,10 @@ std::shared_ptr<T> Object::AddComponent(Args... args) {
     // std::shared_ptr<T> comp = std::make_shared<T>(shared_from_this(), std::forward<Args>(args)...);
     // comp->Init();
     components_.push_back(component);
+    buildComponentIndex();
+
+    // 次のPreUpdateで初期化と処理登録を行う
+    requestState();
 
     return component;
 }
@@ -512,21 +682,7 @@ std::shared_ptr<T> Object::AddComponent(Args... args) {
 //! @return 追加されたコンポーネント
 template<class T>
 std::shared_ptr<T> Object::GetComponent(const std::string_view& name) {
-    assert(this != nullptr &&
-           "実行しているオブジェクト(this)"
-           "がありません。「再試行」をおして、「呼び出し履歴」からどこでemptyになったのかを確認してください。");
-
-    for(auto& component: components_) {
-        auto cast = std::dynamic_pointer_cast<T>(component);
-        if(cast) {
-            if(name == "")
-                return cast;
-            else if(name == cast->GetName())
-                return cast;
-        }
-    }
-
-    return nullptr;
+    return std::as_const(*this).GetComponent<T>(name);
 }
 
 //! @brief コンポーネント取得
@@ -534,18 +690,26 @@ std::shared_ptr<T> Object::GetComponent(const std::string_view& name) {
 //! @return 追加されたコンポーネント
 template<class T>
 std::shared_ptr<T> Object::GetComponent(const std::string_view& name) const {
+    T* cmp = FindComponent<T>(name);
+    if(cmp == nullptr)
+        return nullptr;
+
+    // 所有権を共有したまま型だけ変える
+    return std::shared_ptr<T>(cmp->shared_from_this(), cmp);
+}
+
+//! @brief コンポーネント取得 (参照カウントを増やさない)
+//! @tparam T コンポーネントタイプ
+//! @return コンポーネント (存在しない場合はnullptr)
+template<class T>
+T* Object::FindComponent(const std::string_view& name) const {
     assert(this != nullptr &&
            "実行しているオブジェクト(this)"
            "がありません。「再試行」をおして、「呼び出し履歴」からどこでemptyになったのかを確認してください。");
 
-    for(auto& component: components_) {
-        auto cast = std::dynamic_pointer_cast<T>(component);
-        if(cast) {
-            if(name == "")
-                return cast;
-            else if(name == cast->GetName())
-                return cast;
-        }
+    for(T* cmp: ViewComponents<T>()) {
+        if(name == "" || name == cmp->GetName())
+            return cmp;
     }
 
     return nullptr;
@@ -553,36 +717,33 @@ std::shared_ptr<T> Object::GetComponent(const std::string_view& name) const {
 
 template<class T>
 std::vector<std::shared_ptr<T>> Object::GetComponents() {
+    return std::as_const(*this).GetComponents<T>();
+}
+
+template<class T>
+std::vector<std::shared_ptr<T>> Object::GetComponents() const {
     assert(this != nullptr &&
            "実行しているオブジェクト(this)"
            "がありません。「再試行」をおして、「呼び出し履歴」からどこでemptyになったのかを確認してください。");
 
+    auto view = ViewComponents<T>();
+
     std::vector<std::shared_ptr<T>> cmps;
+    cmps.reserve(view.size());
 
-    for(auto& component: components_) {
-        auto cmp = std::dynamic_pointer_cast<T>(component);
-        if(cmp)
-            cmps.push_back(cmp);
-    }
+    for(T* cmp: view)
+        cmps.push_back(std::shared_ptr<T>(cmp->shared_from_this(), cmp));
 
     return cmps;
 }
 
 template<class T>
-std::vector<std::shared_ptr<T>> Object::GetComponents() const {
+ComponentView<T> Object::ViewComponents() const {
     assert(this != nullptr &&
            "実行しているオブジェクト(this)"
            "がありません。「再試行」をおして、「呼び出し履歴」からどこでemptyになったのかを確認してください。");
 
-    std::vector<std::shared_ptr<T>> cmps;
-
-    for(auto& component: components_) {
-        auto cmp = std::dynamic_pointer_cast<T>(component);
-        if(cmp)
-            cmps.push_back(cmp);
-    }
-
-    return cmps;
+    return ComponentView<T>(findComponentIndex(&T::Type));
 }
 
 template<typename _Type>
@@ -599,4 +760,7 @@ void Object::RemoveComponent() {
             break;
         }
     }
+
+    // 次のPreUpdateで終了したコンポーネントを取り除く
+    requestState();
 }
@@ -4,6 +4,7 @@
 //---------------------------------------------------------------------------
 #include "PhysicsEngine.h"
 #include "PhysicsLayer.h"
+#include "RigidBody.h"
 #include "System/Geometry.h"
 
 //--------------------------------------------------------------
@@ -36,7 +37,13 @@
 #include <Jolt/Physics/Collision/CastResult.h>
 #include <Jolt/Physics/Collision/CollisionCollectorImpl.h>
 #include <Jolt/Physics/Collision/BroadPhase/BroadPhaseQuery.h>
+#include <Jolt/Physics/Collision/ShapeCast.h>
+#include <Jolt/Physics/Body/BodyLock.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
 #include <iostream>
 #include <sstream>
 #include <string>
@@ -55,12 +62,17 @@ void TraceImpl(const char* format, ...) {
     va_list list;
     va_start(list, format);
     char buffer[1024];
-    vsnprintf_s(buffer, sizeof(buffer), format, list);
+    std::vsnprintf(buffer, sizeof(buffer), format, list);
+    va_end(list);
 
     //----------------------------------------------------------
     // 「出力」ウィンドウに出力
     //----------------------------------------------------------
+#if defined(_WIN32)
     OutputDebugStringA(buffer);
+#else
+    std::fputs(buffer, stderr);
+#endif
 }
 
 #ifdef JPH_ENABLE_ASSERTS
@@ -177,17 +189,16 @@ class BPLayerInterfaceImpl final: public JPH::BroadPhaseLayerInterface {
 
     //! Broad-phaseレイヤーの名前を取得
     virtual const char* GetBroadPhaseLayerName(JPH::BroadPhaseLayer layer) const override {
-        switch(static_cast<JPH::BroadPhaseLayer::Type>(layer)) {
-        case BroadPhaseLayers::NON_MOVING:
+        using Type = JPH::BroadPhaseLayer::Type;
+        switch(static_cast<Type>(layer)) {
+        case static_cast<Type>(BroadPhaseLayers::NON_MOVING):
             return "NON_MOVING";
-        case BroadPhaseLayers::MOVING:
+        case static_cast<Type>(BroadPhaseLayers::MOVING):
             return "MOVING";
-        case BroadPhaseLayers::DEBRIS:
+        case static_cast<Type>(BroadPhaseLayers::DEBRIS):
             return "DEBRIS";
-        case BroadPhaseLayers::SENSOR:
+        case static_cast<Type>(BroadPhaseLayers::SENSOR):
             return "SENSOR";
-        case BroadPhaseLayers::UNUSED:
-            return "UNUSED";
         default:
             JPH_ASSERT(false);
             return "invalid";
@@ -308,6 +319,11 @@ class EngineImpl final: public physics::Engine {
     //! @param  [in]    dt  経過時間⊿t
     virtual void update(f32 dt) override;
 
+    //  固定ステップを設定
+    //! @param  [in]    rate        1秒あたりのステップ数 (0以下で可変ステップ)
+    //! @param  [in]    max_steps   1フレームで実行する最大ステップ数
+    virtual void setFixedStep(f32 rate, u32 max_steps) override;
+
     //  シーンにレイをキャスト
     //! @param  [in]    ray     シーンに飛ばすレイ
     //! @param  [out]   result  衝突結果
@@ -315,6 +331,14 @@ class EngineImpl final: public physics::Engine {
     //! @retval false   衝突なし。結果は無効
     virtual bool castRay(const Ray& ray, RayCastResult& result) override;
 
+    //  シーンにレイ・球・カプセルをまとめてキャスト
+    //! @param  [in]    queries 問い合わせの配列
+    //! @param  [out]   results 問い合わせごとの結果
+    //! @param  [out]   hits    当たりの格納先
+    //! @return 格納した当たり数
+    virtual u32 castBatch(std::span<const CastQuery> queries, std::span<CastResult> results,
+                          std::span<CastHit> hits) override;
+
     //  解放
     void clear();
 
@@ -337,6 +361,21 @@ class EngineImpl final: public physics::Engine {
     // 重力を取得
     virtual float3 gravity() const override;
 
+    //  シーン内の全ボディを囲む範囲を取得
+    virtual bool worldBounds(float3& aabb_min, float3& aabb_max) const override;
+
+    //  固定ステップの⊿tを取得
+    virtual f32 fixedDeltaTime() const override;
+
+    //  描画用の補間係数を取得
+    virtual f32 interpolationAlpha() const override;
+
+    //  次の update(dt) で実際に進むシミュレーション時間を取得
+    virtual f32 simulationTime(f32 dt) const override;
+
+    //  直前のupdate()で実行したステップ数を取得
+    virtual u32 stepCount() const override;
+
     //  正常に初期化されているかどうかを取得
     virtual bool isValid() const override;
 
@@ -362,6 +401,18 @@ class EngineImpl final: public physics::Engine {
 
     //@}
 
+    //  蓄積時間から固定ステップの実行数を求める
+    //! @param  [inout] accumulator 蓄積時間 (最大ステップ数を超えた分は切り捨てられます)
+    //! @return 実行するステップ数
+    u32 fixedSteps(f32& accumulator) const;
+
+    //  問い合わせの一部をキャスト (ジョブ1つ分)
+    //! @param  [in]    begin       先頭の問い合わせ番号
+    //! @param  [in]    end         終端の問い合わせ番号
+    //! @param  [inout] hit_cursor  当たりの格納先の使用数
+    void castRange(u32 begin, u32 end, std::span<const CastQuery> queries, std::span<CastResult> results,
+                   std::span<CastHit> hits, std::atomic<u32>& hit_cursor) const;
+
    private:
     std::unique_ptr<JPH::Factory>             jph_factory_;           //!< Factoryクラス
     std::unique_ptr<JPH::JobSystemThreadPool> job_system_;            //!< ジョブシステム
@@ -383,6 +434,12 @@ class EngineImpl final: public physics::Engine {
     MyBodyActivationListener body_activation_listener_;    //!< ユーザーコールバック BodyActivationListener
     MyContactListener        contact_listener_;            //!< ユーザーコールバック ContactListener
 
+    f32 fixed_dt_    = 0.0f;    //!< 固定ステップの⊿t (0なら可変ステップ)
+    u32 max_steps_   = 1;       //!< 1フレームの最大ステップ数
+    f32 accumulator_ = 0.0f;    //!< 未消化の経過時間
+    f32 alpha_       = 1.0f;    //!< 描画用の補間係数
+    u32 step_count_  = 0;       //!< 直前のupdate()で実行したステップ数
+
     bool is_valid_ = false;    //!< 正常に初期化されているか
 };
 
@@ -390,6 +447,97 @@ namespace {
 
     physics::EngineImpl* physics_ = nullptr;    //!< Physicsインスタンス
 
+    constexpr u32 CAST_JOB_QUERIES = 64;     //!< まとめてキャストする時の1ジョブあたりの最小の問い合わせ数
+    constexpr u32 CAST_MAX_JOBS    = 256;    //!< まとめてキャストする時の最大ジョブ数
+
+    constexpr u32 OPTIMIZE_STATIC_BODIES = 64;    //!< 追加した静的な剛体がこの数以上ならBroad-phaseを最適化する
+
+    //===========================================================================
+    //! オブジェクトレイヤーのビットマスクによるフィルター
+    //===========================================================================
+    class ObjectLayerMaskFilter final: public JPH::ObjectLayerFilter {
+       public:
+        explicit ObjectLayerMaskFilter(u32 mask): mask_(mask) {}
+
+        //! 当たるレイヤーかどうか
+        virtual bool ShouldCollide(JPH::ObjectLayer layer) const override {
+            return layer < 32 && ((mask_ >> layer) & 1) != 0;
+        }
+
+       private:
+        u32 mask_;    //!< 当たるレイヤー (1 << ObjectLayers の論理和)
+    };
+
+    //---------------------------------------------------------------------------
+    //! コレクターに集めた当たりを手前から順に渡す
+    //---------------------------------------------------------------------------
+    template<class Collector, class F>
+    void forEachHit(Collector& collector, F&& on_hit) {
+        if constexpr(requires { collector.mHits; }) {
+            collector.Sort();
+            for(auto& hit: collector.mHits)
+                on_hit(hit);
+        } else if(collector.HadHit()) {
+            on_hit(collector.mHit);
+        }
+    }
+
+    //---------------------------------------------------------------------------
+    //! 当たりの集め方に応じたコレクターでキャストする
+    //! @param  [in]    cast    void(CollectorType&) キャストの実行
+    //! @param  [in]    on_hit  void(const ResultType&) 当たりごとの処理
+    //---------------------------------------------------------------------------
+    template<class CollectorType, class Cast, class F>
+    void castWithMode(CastMode mode, Cast&& cast, F&& on_hit) {
+        switch(mode) {
+        case CastMode::Closest: {
+            JPH::ClosestHitCollisionCollector<CollectorType> collector;
+            cast(collector);
+            forEachHit(collector, on_hit);
+            break;
+        }
+        case CastMode::Any: {
+            JPH::AnyHitCollisionCollector<CollectorType> collector;
+            cast(collector);
+            forEachHit(collector, on_hit);
+            break;
+        }
+        case CastMode::All: {
+            JPH::AllHitCollisionCollector<CollectorType> collector;
+            cast(collector);
+            forEachHit(collector, on_hit);
+            break;
+        }
+        }
+    }
+
+    //---------------------------------------------------------------------------
+    //! 形状をキャストして当たりを追加する
+    //---------------------------------------------------------------------------
+    void castShapeQuery(const JPH::NarrowPhaseQuery& narrow_phase, const JPH::Shape& shape, const CastQuery& query,
+                        const JPH::ObjectLayerFilter& layer_filter, std::vector<CastHit>& hits) {
+        JPH::RShapeCast shape_cast =
+            JPH::RShapeCast::sFromWorldTransform(&shape, JPH::Vec3::sReplicate(1.0f),
+                                                 JPH::RMat44::sRotationTranslation(castJPH(query.rotation_),
+                                                                                   castJPH(query.start_)),
+                                                 castJPH(query.end_ - query.start_));
+        JPH::ShapeCastSettings settings;
+
+        castWithMode<JPH::CastShapeCollector>(
+            query.mode_,
+            [&](JPH::CastShapeCollector& collector) {
+                narrow_phase.CastShape(shape_cast, settings, JPH::RVec3::sZero(), collector, {}, layer_filter);
+            },
+            [&](const JPH::ShapeCastResult& result) {
+                CastHit& hit  = hits.emplace_back();
+                hit.body_id_  = result.mBodyID2.GetIndexAndSequenceNumber();
+                hit.t_        = result.mFraction;
+                hit.position_ = castJPH(result.mContactPointOn2);
+                // 貫通軸は相手を押し出す向きなので反転するとキャストした形状の方向になる
+                hit.normal_   = castJPH(-result.mPenetrationAxis.NormalizedOr(JPH::Vec3::sZero()));
+            });
+    }
+
 }    // namespace
 
 //---------------------------------------------------------------------------
@@ -504,6 +652,9 @@ EngineImpl::EngineImpl() {
 //! デストラクタ
 //---------------------------------------------------------------------------
 EngineImpl::~EngineImpl() {
+    // プール中のボディと形状キャッシュを解放
+    physics::clearRigidBodyCache();
+
     clear();
 
     physics_ = nullptr;
@@ -520,8 +671,68 @@ void EngineImpl::update(f32 dt) {
     // より正確なステップ結果を得たい場合は、コリジョンステップの中で複数のサブステップを行うことができます。
     const u32 integration_sub_steps = 1;    // 通常は1に設定します。
 
-    // ワールドを時間経過させて更新
-    jph_physics_system_->Update(dt, collision_steps, integration_sub_steps, temp_allocator_, job_system_.get());
+    // 追加・削除待ちの剛体をまとめて反映
+    // ステージ読み込みなどで静的な剛体が大量に追加された場合はBroad-phaseを最適化する
+    if(physics::flushRigidBodies() >= OPTIMIZE_STATIC_BODIES)
+        optimize();
+
+    //----------------------------------------------------------
+    // 可変ステップ
+    //----------------------------------------------------------
+    if(fixed_dt_ <= 0.0f) {
+        physics::storeRigidBodyStates();
+
+        // ワールドを時間経過させて更新
+        jph_physics_system_->Update(dt, collision_steps, integration_sub_steps, temp_allocator_, job_system_.get());
+
+        step_count_ = 1;
+        alpha_      = 1.0f;
+        return;
+    }
+
+    //----------------------------------------------------------
+    // 固定ステップ
+    // 経過時間を蓄積して固定⊿t単位で進める。処理落ち時は最大ステップ数で打ち切り、
+    // 超えた時間は捨てる(端数は補間のために残す)
+    //----------------------------------------------------------
+    accumulator_ += dt;
+
+    u32 steps = fixedSteps(accumulator_);
+
+    for(u32 i = 0; i < steps; ++i) {
+        // 最後のステップ直前の姿勢を補間元として保存
+        if(i == steps - 1)
+            physics::storeRigidBodyStates();
+
+        // ワールドを時間経過させて更新
+        jph_physics_system_->Update(fixed_dt_, collision_steps, integration_sub_steps, temp_allocator_, job_system_.get());
+    }
+
+    accumulator_ = std::max(accumulator_ - fixed_dt_ * steps, 0.0f);
+    alpha_       = std::min(accumulator_ / fixed_dt_, 1.0f);
+    step_count_  = steps;
+}
+
+//---------------------------------------------------------------------------
+//! 蓄積時間から固定ステップの実行数を求める
+//---------------------------------------------------------------------------
+u32 EngineImpl::fixedSteps(f32& accumulator) const {
+    u32 steps = static_cast<u32>(accumulator / fixed_dt_);
+    if(steps > max_steps_) {
+        accumulator = std::fmod(accumulator, fixed_dt_) + fixed_dt_ * max_steps_;
+        steps       = max_steps_;
+    }
+    return steps;
+}
+
+//---------------------------------------------------------------------------
+//! 固定ステップを設定
+//---------------------------------------------------------------------------
+void EngineImpl::setFixedStep(f32 rate, u32 max_steps) {
+    fixed_dt_    = (rate > 0.0f) ? 1.0f / rate : 0.0f;
+    max_steps_   = std::max(max_steps, 1u);
+    accumulator_ = 0.0f;
+    alpha_       = 1.0f;
 }
 
 //---------------------------------------------------------------------------
@@ -545,6 +756,107 @@ bool EngineImpl::castRay(const Ray& ray, RayCastResult& result) {
     return false;
 }
 
+//---------------------------------------------------------------------------
+//! シーンにレイ・球・カプセルをまとめてキャスト
+//---------------------------------------------------------------------------
+u32 EngineImpl::castBatch(std::span<const CastQuery> queries, std::span<CastResult> results, std::span<CastHit> hits) {
+    assert(results.size() >= queries.size() && "結果の格納先が問い合わせ数より少ないです.");
+
+    const u32 query_count = static_cast<u32>(std::min(queries.size(), results.size()));
+    if(query_count == 0)
+        return 0;
+
+    std::atomic<u32> hit_cursor = 0;
+
+    // ジョブ数が上限を超えないように1ジョブの問い合わせ数を決める
+    const u32 job_queries = std::max(CAST_JOB_QUERIES, (query_count + CAST_MAX_JOBS - 1) / CAST_MAX_JOBS);
+
+    if(query_count <= job_queries) {
+        // 1ジョブ分しかなければジョブを作らずに実行
+        castRange(0, query_count, queries, results, hits, hit_cursor);
+    } else {
+        JPH::JobSystem::Barrier* barrier = job_system_->CreateBarrier();
+        for(u32 begin = 0; begin < query_count; begin += job_queries) {
+            const u32 end = std::min(begin + job_queries, query_count);
+            barrier->AddJob(job_system_->CreateJob("CastBatch", JPH::Color::sCyan, [=, this, &hit_cursor] {
+                castRange(begin, end, queries, results, hits, hit_cursor);
+            }));
+        }
+        // 待っている間はこのスレッドもジョブを実行する
+        job_system_->WaitForJobs(barrier);
+        job_system_->DestroyBarrier(barrier);
+    }
+
+    return std::min(hit_cursor.load(), static_cast<u32>(hits.size()));
+}
+
+//---------------------------------------------------------------------------
+//! 問い合わせの一部をキャスト (ジョブ1つ分)
+//---------------------------------------------------------------------------
+void EngineImpl::castRange(u32 begin, u32 end, std::span<const CastQuery> queries, std::span<CastResult> results,
+                           std::span<CastHit> hits, std::atomic<u32>& hit_cursor) const {
+    auto& narrow_phase = physics_system_->GetNarrowPhaseQuery();
+    auto& body_lock    = physics_system_->GetBodyLockInterface();
+
+    std::vector<CastHit> query_hits;    // 問い合わせ1つ分の当たり (ジョブ内で使いまわす)
+
+    for(u32 i = begin; i < end; i++) {
+        const CastQuery&            query = queries[i];
+        const float3                dir   = query.end_ - query.start_;
+        const ObjectLayerMaskFilter layer_filter(query.layer_mask_);
+
+        query_hits.clear();
+
+        if(query.shape_ == CastShape::Ray || query.radius_ <= 0.0f) {
+            JPH::RRayCast        ray_cast{castJPH(query.start_), castJPH(dir)};
+            JPH::RayCastSettings settings;
+
+            castWithMode<JPH::CastRayCollector>(
+                query.mode_,
+                [&](JPH::CastRayCollector& collector) {
+                    narrow_phase.CastRay(ray_cast, settings, collector, {}, layer_filter);
+                },
+                [&](const JPH::RayCastResult& result) {
+                    CastHit& hit  = query_hits.emplace_back();
+                    hit.body_id_  = result.mBodyID.GetIndexAndSequenceNumber();
+                    hit.t_        = result.mFraction;
+                    hit.position_ = query.start_ + dir * result.mFraction;
+                    hit.normal_   = float3(0.0f, 0.0f, 0.0f);
+
+                    // レイの結果には法線が無いため、ボディの表面から求める
+                    JPH::BodyLockRead lock(body_lock, result.mBodyID);
+                    if(lock.Succeeded()) {
+                        hit.normal_ = castJPH(
+                            lock.GetBody().GetWorldSpaceSurfaceNormal(result.mSubShapeID2, castJPH(hit.position_)));
+                        // 裏面に当たった場合もレイの始点側を向ける
+                        if(static_cast<f32>(dot(hit.normal_, dir)) > 0.0f)
+                            hit.normal_ = -hit.normal_;
+                    }
+                });
+        } else if(query.shape_ == CastShape::Capsule && query.half_height_ > 0.0f) {
+            JPH::CapsuleShape capsule(query.half_height_, query.radius_);
+            capsule.SetEmbedded();
+            castShapeQuery(narrow_phase, capsule, query, layer_filter, query_hits);
+        } else {
+            JPH::SphereShape sphere(query.radius_);
+            sphere.SetEmbedded();
+            castShapeQuery(narrow_phase, sphere, query, layer_filter, query_hits);
+        }
+
+        // 当たり数分の格納先を確保して書き出す (足りない分は切り捨て)
+        const u32 count    = static_cast<u32>(query_hits.size());
+        const u32 first    = count > 0 ? hit_cursor.fetch_add(count) : 0;
+        const u32 capacity = static_cast<u32>(hits.size());
+        const u32 stored   = first < capacity ? std::min(count, capacity - first) : 0;
+        std::copy_n(query_hits.begin(), stored, hits.begin() + first);
+
+        CastResult& result = results[i];
+        result.first_hit_  = stored > 0 ? first : 0;
+        result.hit_count_  = stored;
+        result.overflow_   = stored < count;
+    }
+}
+
 //---------------------------------------------------------------------------
 //! 解放
 //---------------------------------------------------------------------------
@@ -618,6 +930,60 @@ float3 EngineImpl::gravity() const {
     return castJPH(jph_physics_system_->GetGravity());
 }
 
+//---------------------------------------------------------------------------
+//! シーン内の全ボディを囲む範囲を取得
+//---------------------------------------------------------------------------
+bool EngineImpl::worldBounds(float3& aabb_min, float3& aabb_max) const {
+    JPH::BodyIDVector body_ids;
+    jph_physics_system_->GetBodies(body_ids);
+
+    JPH::AABox bounds;
+    for(auto& id: body_ids) {
+        JPH::BodyLockRead lock(jph_physics_system_->GetBodyLockInterface(), id);
+        if(lock.Succeeded())
+            bounds.Encapsulate(lock.GetBody().GetWorldSpaceBounds());
+    }
+    if(!bounds.IsValid())
+        return false;
+
+    aabb_min = castJPH(bounds.mMin);
+    aabb_max = castJPH(bounds.mMax);
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! 固定ステップの⊿tを取得
+//---------------------------------------------------------------------------
+f32 EngineImpl::fixedDeltaTime() const {
+    return fixed_dt_;
+}
+
+//---------------------------------------------------------------------------
+//! 描画用の補間係数を取得
+//---------------------------------------------------------------------------
+f32 EngineImpl::interpolationAlpha() const {
+    return alpha_;
+}
+
+//---------------------------------------------------------------------------
+//! 次の update(dt) で実際に進むシミュレーション時間を取得
+//---------------------------------------------------------------------------
+f32 EngineImpl::simulationTime(f32 dt) const {
+    if(fixed_dt_ <= 0.0f)
+        return dt;
+
+    // update() と同じ計算でステップ数を求める
+    f32 accumulator = accumulator_ + dt;
+    return fixed_dt_ * static_cast<f32>(fixedSteps(accumulator));
+}
+
+//---------------------------------------------------------------------------
+//! 直前のupdate()で実行したステップ数を取得
+//---------------------------------------------------------------------------
+u32 EngineImpl::stepCount() const {
+    return step_count_;
+}
+
 //---------------------------------------------------------------------------
 //! 正常に初期化されているかどうかを取得
 //---------------------------------------------------------------------------
@@ -4,6 +4,9 @@
 //---------------------------------------------------------------------------
 #pragma once
 
+#include <functional>
+#include <span>
+
 class Ray;
 
 namespace JPH {
@@ -28,6 +31,57 @@ struct RayCastResult {
     f32 t_;          // 衝突点のパラメーターt  hit_position = start + t * (end - start)
 };
 
+//--------------------------------------------------------------
+//! まとめてキャストする形状
+//--------------------------------------------------------------
+enum class CastShape : u8 {
+    Ray,        //!< レイ
+    Sphere,     //!< 球
+    Capsule,    //!< カプセル (ローカルY軸方向)
+};
+
+//--------------------------------------------------------------
+//! まとめてキャストする時の当たりの集め方
+//--------------------------------------------------------------
+enum class CastMode : u8 {
+    Closest,    //!< 最も手前の当たりのみ
+    Any,        //!< 最初に見つかった当たりのみ (遮蔽チェック向け。最も手前とは限りません)
+    All,        //!< すべての当たり (手前から順)
+};
+
+//--------------------------------------------------------------
+//! まとめてキャストする問い合わせ
+//--------------------------------------------------------------
+struct CastQuery {
+    float3     start_       = {0.0f, 0.0f, 0.0f};                //!< 始点 (形状の中心)
+    float3     end_         = {0.0f, 0.0f, 0.0f};                //!< 終点 (形状の中心)
+    quaternion rotation_    = quaternion(0.0f, 0.0f, 0.0f, 1.0f);    //!< 形状の向き (カプセルのみ)
+    f32        radius_      = 0.0f;                              //!< 半径 (球・カプセル。0以下ならレイ)
+    f32        half_height_ = 0.0f;                              //!< 円柱部分の高さの半分 (カプセル。0以下なら球)
+    u32        layer_mask_  = ~0u;                               //!< 当たるオブジェクトレイヤー (1 << ObjectLayers の論理和)
+    CastShape  shape_       = CastShape::Ray;                    //!< 形状
+    CastMode   mode_        = CastMode::Closest;                 //!< 当たりの集め方
+};
+
+//--------------------------------------------------------------
+//! まとめてキャストした当たり
+//--------------------------------------------------------------
+struct CastHit {
+    u64    body_id_;     // ボディID
+    f32    t_;           // 衝突時のパラメーターt  形状の中心 = start + t * (end - start)
+    float3 position_;    // 衝突点
+    float3 normal_;      // 衝突面の法線 (キャストした形状の方向を向く)
+};
+
+//--------------------------------------------------------------
+//! まとめてキャストした問い合わせごとの結果
+//--------------------------------------------------------------
+struct CastResult {
+    u32  first_hit_ = 0;        //!< 当たりの格納先の先頭番号
+    u32  hit_count_ = 0;        //!< 当たり数
+    bool overflow_  = false;    //!< 格納先が足りずに当たりを切り捨てた
+};
+
 //===========================================================================
 // 物理シミュレーション
 //===========================================================================
@@ -42,8 +96,14 @@ class Engine {
 
     //! 更新
     //! @param  [in]    dt  経過時間⊿t
+    //! @note 固定ステップ時は経過時間を蓄積し、固定⊿t単位でシミュレーションを進めます
     virtual void update(f32 dt) = 0;
 
+    //! 固定ステップを設定
+    //! @param  [in]    rate        1秒あたりのステップ数 (0以下で可変ステップ)
+    //! @param  [in]    max_steps   1フレームで実行する最大ステップ数 (超えた分の時間は切り捨て)
+    virtual void setFixedStep(f32 rate, u32 max_steps) = 0;
+
     //  シーンにレイをキャスト
     //! @param  [in]    ray     シーンに飛ばすレイ
     //! @param  [out]   result  衝突結果
@@ -51,6 +111,16 @@ class Engine {
     //! @retval false   衝突なし。結果は無効
     virtual bool castRay(const Ray& ray, RayCastResult& result) = 0;
 
+    //! シーンにレイ・球・カプセルをまとめてキャスト
+    //! @param  [in]    queries 問い合わせの配列
+    //! @param  [out]   results 問い合わせごとの結果 (queries と同じ数が必要です)
+    //! @param  [out]   hits    当たりの格納先 (呼び出し側で確保)
+    //! @return 格納した当たり数
+    //! @details ジョブシステムで並列に実行し、すべて完了するまで待ちます。
+    //!          1つの問い合わせの当たりは hits 内で連続しますが、問い合わせ同士の並び順は不定です
+    //! @attention update() の実行中には呼び出さないでください
+    virtual u32 castBatch(std::span<const CastQuery> queries, std::span<CastResult> results, std::span<CastHit> hits) = 0;
+
     //! シーン最適化を実行
     //! @details これによって衝突検出のパフォーマンスが向上します
     //! @attention かなり重い処理のため、毎フレームまたは新しいレベルセクションのストリーミング時などには
@@ -75,6 +145,27 @@ class Engine {
     //! 重力を取得
     virtual float3 gravity() const = 0;
 
+    //! シーン内の全ボディを囲む範囲を取得
+    //! @param  [out]   aabb_min    範囲の最小座標
+    //! @param  [out]   aabb_max    範囲の最大座標
+    //! @retval false   ボディが存在しない
+    virtual bool worldBounds(float3& aabb_min, float3& aabb_max) const = 0;
+
+    //! 固定ステップの⊿tを取得 (可変ステップ時は0)
+    virtual f32 fixedDeltaTime() const = 0;
+
+    //! 描画用の補間係数を取得 (0.0f:1ステップ前 ～ 1.0f:最新ステップ)
+    virtual f32 interpolationAlpha() const = 0;
+
+    //! 次の update(dt) で実際に進むシミュレーション時間を取得
+    //! @param  [in]    dt  update() に渡す予定の経過時間⊿t
+    //! @return 固定ステップ時は 固定⊿t×ステップ数 (0ならステップしない)。可変ステップ時は dt
+    //! @note キネマティック移動の⊿tに使用すると、ステップ数によらず目標位置へ到達します
+    virtual f32 simulationTime(f32 dt) const = 0;
+
+    //! 直前のupdate()で実行したステップ数を取得
+    virtual u32 stepCount() const = 0;
+
     //! 正常に初期化されているかどうかを取得
     virtual bool isValid() const = 0;
 
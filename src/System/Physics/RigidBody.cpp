@@ -24,8 +24,12 @@
 #include <Jolt/Physics/Collision/Shape/MutableCompoundShape.h>
 #include <Jolt/Physics/Collision/Shape/ScaledShape.h>
 #include <Jolt/Physics/Body/BodyCreationSettings.h>
+#include <Jolt/Physics/Body/BodyLock.h>
 #include <Jolt/Physics/Collision/PhysicsMaterialSimple.h>
 
+#include <map>
+#include <unordered_map>
+
 //---------------------------------------------------------------------------
 //! physics::MotionType → JPH::EMotionType へキャスト
 //---------------------------------------------------------------------------
@@ -40,50 +44,224 @@ JPH::EMotionType convertTo(physics::MotionType type) {
 
 namespace physics {
 
+class RigidBodyImpl;
+
+namespace {
+
+constexpr u32 MAX_POOLED_BODIES = 64;    //!< 1つの形状あたりにプールしておく最大ボディ数
+
+//! 形状キャッシュのキー
+struct ShapeKey {
+    shape::Type        type_ = shape::Type::Unknown;    //!< 形状の種類
+    std::array<f32, 4> params_{};                       //!< 形状パラメーター (半径・高さ・スケール・密度など)
+    std::wstring       source_;                         //!< 生成元のモデルファイル (メッシュ・凸形状)
+    u32                lod_          = 0;               //!< 使用したLOD番号 (メッシュ)
+    size_t             vertex_count_ = 0;               //!< 頂点数 (モデルの更新検出用)
+    size_t             index_count_  = 0;               //!< インデックス数 (モデルの更新検出用)
+
+    bool operator==(const ShapeKey&) const = default;
+};
+
+//! 形状キャッシュのキーのハッシュ
+struct ShapeKeyHash {
+    size_t operator()(const ShapeKey& key) const {
+        size_t hash    = std::hash<std::wstring>{}(key.source_);
+        auto   combine = [&](size_t value) { hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2); };
+
+        combine(static_cast<size_t>(key.type_));
+        for(f32 param: key.params_)
+            combine(std::hash<f32>{}(param));
+        combine(key.lod_);
+        combine(key.vertex_count_);
+        combine(key.index_count_);
+        return hash;
+    }
+};
+
+//! 剛体プールのキー (形状と動作タイプが同じボディを再利用します)
+using PoolKey = std::pair<const JPH::Shape*, physics::MotionType>;
+
+//! ワールドからの削除待ちのボディ
+struct PendingRemove {
+    JPH::BodyID body_id_;     //!< ボディID
+    PoolKey     pool_key_;    //!< プールのキー (形状がnullptrならプールせずに破棄)
+};
+
+std::vector<RigidBodyImpl*> rigid_bodies_;    //!< 生成済みの剛体 (補間元の保存用)
+
+std::unordered_map<ShapeKey, JPH::ShapeRefC, ShapeKeyHash> shape_cache_;              //!< 形状キャッシュ
+std::map<PoolKey, std::vector<JPH::BodyID>>               body_pool_;                 //!< ワールドから外して待機中のボディ
+std::vector<RigidBodyImpl*>                               pending_adds_;              //!< ワールドへの追加待ちの剛体
+std::vector<PendingRemove>                                pending_removes_;           //!< ワールドからの削除待ちのボディ
+std::vector<JPH::BodyID>                                  flush_ids_;                 //!< まとめて反映する時の作業用
+u32                                                       static_added_   = 0;        //!< 前回の flushRigidBodies() から追加した静的な剛体の数
+bool                                                      release_shapes_ = false;    //!< 次の flushRigidBodies() で使われていない形状を解放するか
+RigidBodyStats                                            stats_;                     //!< 生成状況
+
+//---------------------------------------------------------------------------
+//! 形状キャッシュから形状を取得 (無ければ生成して登録)
+//! @param  [in]    key     形状キャッシュのキー
+//! @param  [in]    create  JPH::ShapeSettings::ShapeResult() 形状の生成
+//---------------------------------------------------------------------------
+template<class F>
+JPH::ShapeRefC findShape(const ShapeKey& key, F&& create) {
+    // 生成元が分からないモデル形状はキャッシュしない
+    bool cacheable = !(key.source_.empty() && (key.type_ == shape::Type::Mesh || key.type_ == shape::Type::ConvexHull));
+
+    if(cacheable) {
+        if(auto it = shape_cache_.find(key); it != shape_cache_.end()) {
+            stats_.shape_hits_++;
+            return it->second;
+        }
+    }
+
+    JPH::ShapeSettings::ShapeResult result = create();
+    if(result.HasError())
+        return nullptr;
+
+    stats_.shape_misses_++;
+    if(cacheable)
+        shape_cache_.emplace(key, result.Get());
+    return result.Get();
+}
+
+//---------------------------------------------------------------------------
+//! ボディを作成 (プールに同じ形状のボディがあれば再利用)
+//! @return 作成したボディ (ワールドには未追加。ボディを使い果たした場合はnullptr)
+//---------------------------------------------------------------------------
+JPH::Body* acquireBody(const JPH::ShapeRefC& shape, u16 layer, physics::MotionType motion_type) {
+    auto* body_interface = physics::Engine::bodyInterface();
+
+    // ボディ自体の設定を作成します。ここで跳ね返り/摩擦係数のような他のプロパティも設定できます。
+    auto position = JPH::Vec3(0.0f, 0.0f, 0.0f);
+    auto rotation = JPH::Quat::sIdentity();
+
+    JPH::BodyCreationSettings body_settings(shape,                     // 形状
+                                            position,                  // 位置座標
+                                            rotation,                  // 回転姿勢
+                                            convertTo(motion_type),    // 動的/静的/キネマティック
+                                            layer);                    // レイヤー番号
+
+    // CCD (Continuous Collision Detection) 有効
+    body_settings.mMotionQuality = JPH::EMotionQuality::LinearCast;
+
+    //----------------------------------------------------------
+    // プールから再利用
+    //----------------------------------------------------------
+    if(auto it = body_pool_.find({shape.GetPtr(), motion_type}); it != body_pool_.end() && !it->second.empty()) {
+        JPH::BodyID body_id = it->second.back();
+        it->second.pop_back();
+
+        // 前回の使用時の状態を生成直後と同じに戻す
+        auto dont_activate = JPH::EActivation::DontActivate;
+        body_interface->SetPositionAndRotation(body_id, position, rotation, dont_activate);
+        body_interface->SetMotionType(body_id, body_settings.mMotionType, dont_activate);
+        body_interface->SetLinearAndAngularVelocity(body_id, JPH::Vec3::sZero(), JPH::Vec3::sZero());
+        body_interface->SetObjectLayer(body_id, layer);
+        body_interface->SetFriction(body_id, body_settings.mFriction);
+        body_interface->SetRestitution(body_id, body_settings.mRestitution);
+        body_interface->SetGravityFactor(body_id, body_settings.mGravityFactor);
+
+        JPH::BodyLockWrite lock(physics::Engine::physicsSystem()->GetBodyLockInterface(), body_id);
+        if(lock.Succeeded()) {
+            JPH::Body& body = lock.GetBody();
+            body.SetUserData(0);
+            body.GetMotionProperties()->ResetForceAndTorqueInternal();
+
+            stats_.pool_hits_++;
+            return &body;
+        }
+    }
+
+    //----------------------------------------------------------
+    // 新しく作成
+    //----------------------------------------------------------
+    return body_interface->CreateBody(body_settings);
+}
+
+//---------------------------------------------------------------------------
+//! ワールド外のボディをプールへ戻す
+//! @retval false   プール対象外またはプールが一杯 (呼び出し側で破棄してください)
+//---------------------------------------------------------------------------
+bool poolBody(const JPH::BodyID& body_id, const PoolKey& pool_key) {
+    if(pool_key.first == nullptr)
+        return false;
+
+    auto& pool = body_pool_[pool_key];
+    if(pool.size() >= MAX_POOLED_BODIES)
+        return false;
+
+    pool.push_back(body_id);
+    return true;
+}
+
+}    // namespace
+
 //===========================================================================
 //! 剛体クラス
 //===========================================================================
 class RigidBodyImpl: public physics::RigidBody {
    public:
     RigidBodyImpl(const JPH::ShapeRefC& shape, u16 layer, physics::MotionType motion_type) {
-        // ボディ自体の設定を作成します。ここで跳ね返り/摩擦係数のような他のプロパティも設定できます。
-        auto position = JPH::Vec3(0.0f, 0.0f, 0.0f);
-        auto rotation = JPH::Quat::sIdentity();
-
-        JPH::BodyCreationSettings body_settings(shape,                     // 形状
-                                                position,                  // 位置座標
-                                                rotation,                  // 回転姿勢
-                                                convertTo(motion_type),    // 動的/静的/キネマティック
-                                                layer);                    // レイヤー番号
-
-        // CCD (Continuous Collision Detection) 有効
-        body_settings.mMotionQuality = JPH::EMotionQuality::LinearCast;
-
         //------------------------------------------------------
-        // 剛体を作成
+        // 剛体を作成 (プールに同じ形状のボディがあれば再利用)
         //------------------------------------------------------
         // ボディを使い果たした場合はnullptrが返ります
-        jph_body_ = physics::Engine::bodyInterface()->CreateBody(body_settings);
+        jph_body_ = acquireBody(shape, layer, motion_type);
 
         if(jph_body_ == nullptr) {
             assert(0 && "ボディ個数を最大数まで使い果たしました。");
             return;
         }
 
-        // ワールドに追加 (アクティブ化)
-        physics::Engine::bodyInterface()->AddBody(jph_body_->GetID(), JPH::EActivation::Activate);
-
         // IDを保存
         body_id_ = jph_body_->GetID();
+
+        // 静的以外は削除時にプールへ戻す
+        if(motion_type != physics::MotionType::Static)
+            pool_key_ = {shape.GetPtr(), motion_type};
+
+        // ワールドへの追加 (アクティブ化) は物理更新の直前にまとめて行う
+        pending_index_ = static_cast<u32>(pending_adds_.size());
+        pending_adds_.push_back(this);
+
+        // 補間元の保存対象に登録
+        registry_index_ = static_cast<u32>(rigid_bodies_.size());
+        rigid_bodies_.push_back(this);
     }
 
     //! デストラクタ
     virtual ~RigidBodyImpl() {
-        // Physicsシステムからボディを削除します。ただしボディ自体はすべての状態を保持しておりいつでも再追加可能です。
-        physics::Engine::bodyInterface()->RemoveBody(body_id_);
+        // 補間元の保存対象から外す (末尾と入れ替え)
+        if(registry_index_ != ~0u) {
+            auto* last                     = rigid_bodies_.back();
+            rigid_bodies_[registry_index_] = last;
+            last->registry_index_          = registry_index_;
+            rigid_bodies_.pop_back();
+        }
 
-        // ボディを解放します。これ以降IDが無効になります。
-        physics::Engine::bodyInterface()->DestroyBody(body_id_);
+        // 物理シミュレーションが既に終了している
+        if(jph_body_ == nullptr || physics::Engine::instance() == nullptr)
+            return;
+
+        // 削除待ちの間にユーザーデーターから参照されないようにする
+        jph_body_->SetUserData(0);
+
+        if(pending_index_ != ~0u) {
+            // ワールドへの追加待ちから外す (末尾と入れ替え)
+            auto* last                     = pending_adds_.back();
+            pending_adds_[pending_index_]  = last;
+            last->pending_index_           = pending_index_;
+            pending_adds_.pop_back();
+
+            // まだワールドに追加されていないのでその場でプールへ戻す
+            if(!poolBody(body_id_, pool_key_))
+                physics::Engine::bodyInterface()->DestroyBody(body_id_);
+            return;
+        }
+
+        // ワールドからの削除は物理更新の直前にまとめて行う
+        pending_removes_.push_back({body_id_, pool_key_});
     }
 
     //-----------------------------------------------------------------------
@@ -112,8 +290,10 @@ class RigidBodyImpl: public physics::RigidBody {
     //! @param  [in]    position    設定座標
     //! @param  [in]    is_activate アクティブ化するかどうか true:アクティブにする false:アクティブにしない
     virtual void setPosition(const float3& position, bool is_activate = true) override {
-        physics::Engine::bodyInterface()->SetPosition(
-            body_id_, castJPH(position), is_activate ? JPH::EActivation::Activate : JPH::EActivation::DontActivate);
+        physics::Engine::bodyInterface()->SetPosition(body_id_, castJPH(position), activation(is_activate));
+
+        // 瞬間移動なので補間しない
+        prev_position_ = castJPH(position);
     }
 
     //! 位置を取得
@@ -133,8 +313,10 @@ class RigidBodyImpl: public physics::RigidBody {
     //! @param  [in]    is_activate アクティブ化するかどうか true:アクティブにする false:アクティブにしない
     virtual void setRotation(const quaternion& rot, bool is_activate = true) override {
         JPH::QuatArg q = castJPH(rot);
-        physics::Engine::bodyInterface()->SetRotation(
-            body_id_, q, is_activate ? JPH::EActivation::Activate : JPH::EActivation::DontActivate);
+        physics::Engine::bodyInterface()->SetRotation(body_id_, q, activation(is_activate));
+
+        // 瞬間移動なので補間しない
+        prev_rotation_ = q;
     }
 
     //! 回転姿勢を設定
@@ -153,6 +335,24 @@ class RigidBodyImpl: public physics::RigidBody {
         return castJPH(physics::Engine::bodyInterface()->GetCenterOfMassTransform(body_id_));
     }
 
+    //! 描画用に補間したワールド行列を取得
+    virtual matrix interpolatedMatrix(f32 alpha) const override {
+        JPH::RVec3 position;
+        JPH::Quat  rotation;
+        physics::Engine::bodyInterface()->GetPositionAndRotation(body_id_, position, rotation);
+
+        if(alpha < 1.0f) {
+            position = prev_position_ + (position - prev_position_) * alpha;
+            rotation = prev_rotation_.SLERP(rotation, alpha).Normalized();
+        }
+        return castJPH(JPH::RMat44::sRotationTranslation(rotation, position));
+    }
+
+    //! 補間元として現在の位置と回転姿勢を保存
+    virtual void storeState() override {
+        physics::Engine::bodyInterface()->GetPositionAndRotation(body_id_, prev_position_, prev_rotation_);
+    }
+
     //@}
     //-----------------------------------------------------------
     //! @name   速度と角速度
@@ -166,12 +366,16 @@ class RigidBodyImpl: public physics::RigidBody {
     virtual void moveKinematic(const float3& target_position, const quaternion& target_rotation, f32 delta_time) override {
         JPH::Vec3 tpos = castJPH(target_position);
         JPH::Quat trot = castJPH(target_rotation);
+        if(modifyPending([&](JPH::Body& body) { body.MoveKinematic(tpos, trot, delta_time); }))
+            return;
         physics::Engine::bodyInterface()->MoveKinematic(body_id_, tpos, trot, delta_time);
     }
 
     //! 速度を設定
     //! @param  [in]    v   速度
     virtual void setLinearVelocity(const float3& v) override {
+        if(modifyPending([&](JPH::Body& body) { body.SetLinearVelocityClamped(castJPH(v)); }))
+            return;
         physics::Engine::bodyInterface()->SetLinearVelocity(body_id_, castJPH(v));
     }
 
@@ -183,12 +387,16 @@ class RigidBodyImpl: public physics::RigidBody {
     //! 現在の速度に速度を加算
     //! @param  [in]    v   加算する速度
     virtual void addLinearVelocity(const float3& v) override {
+        if(modifyPending([&](JPH::Body& body) { body.SetLinearVelocityClamped(body.GetLinearVelocity() + castJPH(v)); }))
+            return;
         physics::Engine::bodyInterface()->AddLinearVelocity(body_id_, castJPH(v));
     }
 
     //! 角速度を設定
     //! @param  [in]    vrot   角速度
     virtual void setAngularVelocity(const float3& vrot) override {
+        if(modifyPending([&](JPH::Body& body) { body.SetAngularVelocityClamped(castJPH(vrot)); }))
+            return;
         physics::Engine::bodyInterface()->SetAngularVelocity(body_id_, castJPH(vrot));
     }
 
@@ -212,6 +420,8 @@ class RigidBodyImpl: public physics::RigidBody {
     //! 力を与える
     //! @param  [in]    force   与える力
     virtual void addForce(const float3& force) override {
+        if(modifyPending([&](JPH::Body& body) { body.AddForce(castJPH(force)); }, true))
+            return;
         physics::Engine::bodyInterface()->AddForce(body_id_, castJPH(force));
     }
 
@@ -219,12 +429,16 @@ class RigidBodyImpl: public physics::RigidBody {
     //! @param  [in]    force   与える力
     //! @param  [in]    point   位置
     virtual void addForce(const float3& force, const float3& point) override {
+        if(modifyPending([&](JPH::Body& body) { body.AddForce(castJPH(force), castJPH(point)); }, true))
+            return;
         physics::Engine::bodyInterface()->AddForce(body_id_, castJPH(force), castJPH(point));
     }
 
     //! トルクを与える
     //! @param  [in]    force   与える力
     virtual void addTorque(const float3& torque) override {
+        if(modifyPending([&](JPH::Body& body) { body.AddTorque(castJPH(torque)); }, true))
+            return;
         physics::Engine::bodyInterface()->AddTorque(body_id_, castJPH(torque));
     }
 
@@ -237,6 +451,8 @@ class RigidBodyImpl: public physics::RigidBody {
     //! 撃力を与える
     //! @param  [in]    impulse 与える撃力
     virtual void addImpulse(const float3& impulse) override {
+        if(modifyPending([&](JPH::Body& body) { body.AddImpulse(castJPH(impulse)); }, true))
+            return;
         physics::Engine::bodyInterface()->AddImpulse(body_id_, castJPH(impulse));
     }
 
@@ -244,12 +460,16 @@ class RigidBodyImpl: public physics::RigidBody {
     //! @param  [in]    impulse 与える撃力
     //! @param  [in]    point   位置
     virtual void addImpulse(const float3& impulse, const float3& point) override {
+        if(modifyPending([&](JPH::Body& body) { body.AddImpulse(castJPH(impulse), castJPH(point)); }, true))
+            return;
         physics::Engine::bodyInterface()->AddImpulse(body_id_, castJPH(impulse), castJPH(point));
     }
 
     //! 角力積を与える
     //! @param  [in]    impulse 与える角力積
     virtual void addAngularImpulse(const float3& impulse) override {
+        if(modifyPending([&](JPH::Body& body) { body.AddAngularImpulse(castJPH(impulse)); }, true))
+            return;
         physics::Engine::bodyInterface()->AddAngularImpulse(body_id_, castJPH(impulse));
     }
 
@@ -310,8 +530,7 @@ class RigidBodyImpl: public physics::RigidBody {
     //! @param  [in]    motion_type 動作タイプ
     //! @param  [in]    is_activate アクティブ化するかどうか true:アクティブにする false:アクティブにしない
     virtual void setMotionType(physics::MotionType motion_type, bool is_activate = true) override {
-        physics::Engine::bodyInterface()->SetMotionType(
-            body_id_, convertTo(motion_type), is_activate ? JPH::EActivation::Activate : JPH::EActivation::DontActivate);
+        physics::Engine::bodyInterface()->SetMotionType(body_id_, convertTo(motion_type), activation(is_activate));
     }
 
     //! ワールド空間の逆慣性テンソルを取得する
@@ -340,12 +559,234 @@ class RigidBodyImpl: public physics::RigidBody {
         return body_id_.GetIndexAndSequenceNumber();
     }
 
+    //! [JPH] ボディIDを取得
+    const JPH::BodyID& jphBodyID() const {
+        return body_id_;
+    }
+
+    //! 静的なボディかどうか
+    bool isStatic() const {
+        return jph_body_->IsStatic();
+    }
+
+    //! ワールドへの追加待ちを解除 (まとめて追加した後に呼ばれます)
+    void markAdded() {
+        pending_index_ = ~0u;
+    }
+
+   private:
+    //! アクティブ化の指定を取得
+    //! @note ワールドへの追加待ちの間はアクティブ化しません (追加時にアクティブ化されます)
+    JPH::EActivation activation(bool is_activate) const {
+        return is_activate && pending_index_ == ~0u ? JPH::EActivation::Activate : JPH::EActivation::DontActivate;
+    }
+
+    //! ワールドへの追加待ちならボディを直接変更する
+    //! @details BodyInterface 経由の速度や力の設定はアクティブ化を伴うため、ワールド外のボディには使えません。
+    //!          追加待ちのボディは追加時にまとめてアクティブ化されます
+    //! @param  [in]    modify          void(JPH::Body&) ボディの変更
+    //! @param  [in]    dynamic_only    動的なボディのみ変更する (力・撃力)
+    //! @retval false   追加済み (BodyInterface 経由で変更してください)
+    template<class F>
+    bool modifyPending(F&& modify, bool dynamic_only = false) {
+        if(pending_index_ == ~0u)
+            return false;
+
+        JPH::BodyLockWrite lock(physics::Engine::physicsSystem()->GetBodyLockInterface(), body_id_);
+        if(lock.Succeeded()) {
+            JPH::Body& body = lock.GetBody();
+            if(dynamic_only ? body.IsDynamic() : !body.IsStatic())
+                modify(body);
+        }
+        return true;
+    }
+
    private:
     JPH::BodyID   body_id_;               //!< [JPH] ボディID
     JPH::Body*    jph_body_ = nullptr;    //!< [JPH] ボディ
     std::intptr_t data_     = 0;          //!< 任意のデーター
+
+    JPH::RVec3 prev_position_  = JPH::RVec3::sZero();       //!< 補間元の位置
+    JPH::Quat  prev_rotation_  = JPH::Quat::sIdentity();    //!< 補間元の回転姿勢
+    u32        registry_index_ = ~0u;                       //!< rigid_bodies_ 内の位置
+    u32        pending_index_  = ~0u;                       //!< pending_adds_ 内の位置 (追加済みなら~0u)
+    PoolKey    pool_key_       = {nullptr, physics::MotionType::Static};    //!< 剛体プールのキー
 };
 
+namespace {
+
+//---------------------------------------------------------------------------
+//! 追加・削除待ちのボディをまとめてワールドに反映
+//---------------------------------------------------------------------------
+void flushPending() {
+    auto* body_interface = physics::Engine::bodyInterface();
+
+    //----------------------------------------------------------
+    // 削除 (プールに戻せないものは破棄)
+    //----------------------------------------------------------
+    if(!pending_removes_.empty()) {
+        // Physicsシステムからボディを削除します。ただしボディ自体はすべての状態を保持しておりいつでも再追加可能です。
+        flush_ids_.clear();
+        for(auto& pending: pending_removes_)
+            flush_ids_.push_back(pending.body_id_);
+        body_interface->RemoveBodies(flush_ids_.data(), static_cast<int>(flush_ids_.size()));
+
+        // ボディを解放します。これ以降IDが無効になります。
+        flush_ids_.clear();
+        for(auto& pending: pending_removes_) {
+            if(!poolBody(pending.body_id_, pending.pool_key_))
+                flush_ids_.push_back(pending.body_id_);
+        }
+        if(!flush_ids_.empty())
+            body_interface->DestroyBodies(flush_ids_.data(), static_cast<int>(flush_ids_.size()));
+
+        stats_.last_removed_ = static_cast<u32>(pending_removes_.size());
+        pending_removes_.clear();
+    }
+
+    //----------------------------------------------------------
+    // 追加 (Broad-phaseへまとめて挿入してアクティブ化)
+    //----------------------------------------------------------
+    if(!pending_adds_.empty()) {
+        flush_ids_.clear();
+        for(auto* body: pending_adds_) {
+            flush_ids_.push_back(body->jphBodyID());
+            if(body->isStatic())
+                static_added_++;
+            body->markAdded();
+        }
+
+        stats_.last_added_ = static_cast<u32>(pending_adds_.size());
+        pending_adds_.clear();
+
+        auto add_state = body_interface->AddBodiesPrepare(flush_ids_.data(), static_cast<int>(flush_ids_.size()));
+        body_interface->AddBodiesFinalize(flush_ids_.data(), static_cast<int>(flush_ids_.size()), add_state,
+                                          JPH::EActivation::Activate);
+    }
+}
+
+//---------------------------------------------------------------------------
+//! どの剛体からも使われていない形状をキャッシュから解放
+//! @note プールで待機中のボディだけが参照している形状は、そのボディも破棄して解放します
+//---------------------------------------------------------------------------
+void releaseUnusedShapes() {
+    // 形状ごとのプール内のボディ数 (ボディ1つにつき形状の参照が1つ)
+    std::unordered_map<const JPH::Shape*, u32> pooled;
+    for(auto& [pool_key, body_ids]: body_pool_)
+        pooled[pool_key.first] += static_cast<u32>(body_ids.size());
+
+    auto* body_interface = physics::Engine::bodyInterface();
+
+    for(auto it = shape_cache_.begin(); it != shape_cache_.end();) {
+        const JPH::Shape* shape = it->second.GetPtr();
+
+        // キャッシュとプールのボディ以外に参照が残っていれば使用中
+        auto pooled_it    = pooled.find(shape);
+        u32  pooled_count = pooled_it != pooled.end() ? pooled_it->second : 0;
+        if(shape->GetRefCount() > 1 + pooled_count) {
+            ++it;
+            continue;
+        }
+
+        if(pooled_count > 0) {
+            for(auto pool_it = body_pool_.begin(); pool_it != body_pool_.end();) {
+                if(pool_it->first.first != shape) {
+                    ++pool_it;
+                    continue;
+                }
+                auto& body_ids = pool_it->second;
+                if(body_interface && !body_ids.empty())
+                    body_interface->DestroyBodies(body_ids.data(), static_cast<int>(body_ids.size()));
+                pool_it = body_pool_.erase(pool_it);
+            }
+        }
+
+        stats_.shape_released_++;
+        it = shape_cache_.erase(it);
+    }
+}
+
+}    // namespace
+
+//---------------------------------------------------------------------------
+//! すべての剛体の補間元を保存
+//---------------------------------------------------------------------------
+void storeRigidBodyStates() {
+    for(auto* body: rigid_bodies_)
+        body->storeState();
+}
+
+//---------------------------------------------------------------------------
+//! 追加・削除待ちの剛体をまとめてワールドに反映
+//---------------------------------------------------------------------------
+u32 flushRigidBodies() {
+    flushPending();
+
+    // 前のシーンの剛体が削除されてから解放する
+    if(release_shapes_) {
+        release_shapes_ = false;
+        releaseUnusedShapes();
+    }
+
+    u32 static_added = static_added_;
+    static_added_    = 0;
+    return static_added;
+}
+
+//---------------------------------------------------------------------------
+//! 使われなくなった形状をキャッシュから解放するよう予約
+//---------------------------------------------------------------------------
+void requestReleaseUnusedShapes() {
+    release_shapes_ = true;
+}
+
+//---------------------------------------------------------------------------
+//! 形状キャッシュと剛体プールを解放
+//---------------------------------------------------------------------------
+void clearRigidBodyCache() {
+    if(auto* body_interface = physics::Engine::bodyInterface()) {
+        // 削除待ちのボディはプールに戻さずに破棄
+        flush_ids_.clear();
+        for(auto& pending: pending_removes_)
+            flush_ids_.push_back(pending.body_id_);
+        if(!flush_ids_.empty()) {
+            body_interface->RemoveBodies(flush_ids_.data(), static_cast<int>(flush_ids_.size()));
+            body_interface->DestroyBodies(flush_ids_.data(), static_cast<int>(flush_ids_.size()));
+        }
+
+        // プールのボディはワールド外なので破棄のみ
+        for(auto& [pool_key, body_ids]: body_pool_) {
+            if(!body_ids.empty())
+                body_interface->DestroyBodies(body_ids.data(), static_cast<int>(body_ids.size()));
+        }
+    }
+
+    // 追加待ちの剛体はワールド外のまま残る (剛体の解放時には物理シミュレーションが終了しています)
+    for(auto* body: pending_adds_)
+        body->markAdded();
+
+    pending_adds_.clear();
+    pending_removes_.clear();
+    body_pool_.clear();
+    shape_cache_.clear();
+    static_added_   = 0;
+    release_shapes_ = false;
+    stats_          = {};
+}
+
+//---------------------------------------------------------------------------
+//! 剛体の生成状況を取得
+//---------------------------------------------------------------------------
+RigidBodyStats rigidBodyStats() {
+    RigidBodyStats stats   = stats_;
+    stats.shape_count_     = static_cast<u32>(shape_cache_.size());
+    stats.pending_adds_    = static_cast<u32>(pending_adds_.size());
+    stats.pending_removes_ = static_cast<u32>(pending_removes_.size());
+    for(auto& [pool_key, body_ids]: body_pool_)
+        stats.pooled_bodies_ += static_cast<u32>(body_ids.size());
+    return stats;
+}
+
 //===========================================================================
 //! @name   生成
 //===========================================================================
@@ -356,16 +797,22 @@ class RigidBodyImpl: public physics::RigidBody {
 //---------------------------------------------------------------------------
 std::shared_ptr<physics::RigidBody> createRigidBody(const shape::Sphere& o, u16 layer, physics::MotionType motion_type,
                                                     f32 density) {
+    ShapeKey key;
+    key.type_   = shape::Type::Sphere;
+    key.params_ = {o.radius_, density};
+
     // シェイプを生成
-    JPH::SphereShapeSettings shape_settings(o.radius_);
-    shape_settings.SetDensity(density);
-    JPH::ShapeSettings::ShapeResult result = shape_settings.Create();
+    JPH::ShapeRefC shape = findShape(key, [&] {
+        JPH::SphereShapeSettings shape_settings(o.radius_);
+        shape_settings.SetDensity(density);
+        return shape_settings.Create();
+    });
 
-    if(result.HasError())
+    if(shape == nullptr)
         return nullptr;
 
     // 作成
-    return std::make_shared<RigidBodyImpl>(result.Get(), layer, motion_type);
+    return std::make_shared<RigidBodyImpl>(shape, layer, motion_type);
 }
 
 //---------------------------------------------------------------------------
@@ -373,16 +820,22 @@ std::shared_ptr<physics::RigidBody> createRigidBody(const shape::Sphere& o, u16
 //---------------------------------------------------------------------------
 std::shared_ptr<physics::RigidBody> createRigidBody(const shape::Box& o, u16 layer, physics::MotionType motion_type,
                                                     f32 density) {
+    ShapeKey key;
+    key.type_   = shape::Type::Box;
+    key.params_ = {o.extent_.x, o.extent_.y, o.extent_.z, density};
+
     // シェイプを生成
-    JPH::BoxShapeSettings shape_settings(JPH::Vec3(o.extent_.x, o.extent_.y, o.extent_.z));
-    shape_settings.SetDensity(density);
-    JPH::ShapeSettings::ShapeResult result = shape_settings.Create();
+    JPH::ShapeRefC shape = findShape(key, [&] {
+        JPH::BoxShapeSettings shape_settings(JPH::Vec3(o.extent_.x, o.extent_.y, o.extent_.z));
+        shape_settings.SetDensity(density);
+        return shape_settings.Create();
+    });
 
-    if(result.HasError())
+    if(shape == nullptr)
         return nullptr;
 
     // 作成
-    return std::make_shared<RigidBodyImpl>(result.Get(), layer, motion_type);
+    return std::make_shared<RigidBodyImpl>(shape, layer, motion_type);
 }
 
 //---------------------------------------------------------------------------
@@ -390,16 +843,22 @@ std::shared_ptr<physics::RigidBody> createRigidBody(const shape::Box& o, u16 lay
 //---------------------------------------------------------------------------
 std::shared_ptr<physics::RigidBody> createRigidBody(const shape::Cylinder& o, u16 layer, physics::MotionType motion_type,
                                                     f32 density) {
+    ShapeKey key;
+    key.type_   = shape::Type::Cylinder;
+    key.params_ = {o.half_height_, o.radius_, density};
+
     // シェイプを生成
-    JPH::CylinderShapeSettings shape_settings(o.half_height_, o.radius_);
-    shape_settings.SetDensity(density);
-    JPH::ShapeSettings::ShapeResult result = shape_settings.Create();
+    JPH::ShapeRefC shape = findShape(key, [&] {
+        JPH::CylinderShapeSettings shape_settings(o.half_height_, o.radius_);
+        shape_settings.SetDensity(density);
+        return shape_settings.Create();
+    });
 
-    if(result.HasError())
+    if(shape == nullptr)
         return nullptr;
 
     // 作成
-    return std::make_shared<RigidBodyImpl>(result.Get(), layer, motion_type);
+    return std::make_shared<RigidBodyImpl>(shape, layer, motion_type);
 }
 
 //---------------------------------------------------------------------------
@@ -407,16 +866,22 @@ std::shared_ptr<physics::RigidBody> createRigidBody(const shape::Cylinder& o, u1
 //---------------------------------------------------------------------------
 std::shared_ptr<physics::RigidBody> createRigidBody(const shape::Capsule& o, u16 layer, physics::MotionType motion_type,
                                                     f32 density) {
+    ShapeKey key;
+    key.type_   = shape::Type::Capsule;
+    key.params_ = {o.half_height_, o.radius_, density};
+
     // シェイプを生成
-    JPH::CapsuleShapeSettings shape_settings(o.half_height_, o.radius_);
-    shape_settings.SetDensity(density);
-    JPH::ShapeSettings::ShapeResult result = shape_settings.Create();
+    JPH::ShapeRefC shape = findShape(key, [&] {
+        JPH::CapsuleShapeSettings shape_settings(o.half_height_, o.radius_);
+        shape_settings.SetDensity(density);
+        return shape_settings.Create();
+    });
 
-    if(result.HasError())
+    if(shape == nullptr)
         return nullptr;
 
     // 作成
-    return std::make_shared<RigidBodyImpl>(result.Get(), layer, motion_type);
+    return std::make_shared<RigidBodyImpl>(shape, layer, motion_type);
 }
 
 //---------------------------------------------------------------------------
@@ -424,69 +889,86 @@ std::shared_ptr<physics::RigidBody> createRigidBody(const shape::Capsule& o, u16
 //---------------------------------------------------------------------------
 std::shared_ptr<physics::RigidBody> createRigidBody(const shape::ConvexHull& o, u16 layer, physics::MotionType motion_type,
                                                     f32 density) {
-    //----------------------------------------------------------
-    // 頂点配列を取得
-    //----------------------------------------------------------
-    JPH::Array<JPH::Vec3>    vertexList;
-    JPH::IndexedTriangleList indexList;
-
-    for(auto& v: o.vertices_) {
-        JPH::Vec3 position{v.x * 0.01f, v.y * 0.01f, v.z * 0.01f};
-        vertexList.emplace_back(std::move(position));
-    }
-
-    //----------------------------------------------------------
-    // シェイプを生成
-    //----------------------------------------------------------
+    ShapeKey key;
+    key.type_         = shape::Type::ConvexHull;
+    key.params_       = {density};
+    key.source_       = o.source_;
+    key.vertex_count_ = o.vertices_.size();
+
+    JPH::ShapeRefC shape = findShape(key, [&] {
+        //----------------------------------------------------------
+        // 頂点配列を取得
+        //----------------------------------------------------------
+        JPH::Array<JPH::Vec3> vertexList;
+
+        for(auto& v: o.vertices_) {
+            JPH::Vec3 position{v.x * 0.01f, v.y * 0.01f, v.z * 0.01f};
+            vertexList.emplace_back(std::move(position));
+        }
 
-    JPH::ConvexHullShapeSettings shape_settings(vertexList);
-    shape_settings.SetDensity(density);
-    JPH::ShapeSettings::ShapeResult result = shape_settings.Create();
+        //----------------------------------------------------------
+        // シェイプを生成
+        //----------------------------------------------------------
+        JPH::ConvexHullShapeSettings shape_settings(vertexList);
+        shape_settings.SetDensity(density);
+        return shape_settings.Create();
+    });
 
-    if(result.HasError())
+    if(shape == nullptr)
         return nullptr;
 
     // 作成
-    return std::make_shared<RigidBodyImpl>(result.Get(), layer, motion_type);
+    return std::make_shared<RigidBodyImpl>(shape, layer, motion_type);
 }
 
 //---------------------------------------------------------------------------
 //! Mesh剛体を作成
 //---------------------------------------------------------------------------
 std::shared_ptr<physics::RigidBody> createRigidBody(const shape::Mesh& o, u16 layer) {
-    //----------------------------------------------------------
-    // 頂点配列を取得
-    //----------------------------------------------------------
-    JPH::VertexList          vertexList;
-    JPH::IndexedTriangleList indexList;
-
-    for(auto& v: o.vertices_) {
-        JPH::Float3 position{v.x, v.y, v.z};
-        vertexList.emplace_back(std::move(position));
-    }
-    for(u32 i = 0; i < o.indices_.size(); i += 3) {
-        u32                  i0 = o.indices_[i + 0];
-        u32                  i1 = o.indices_[i + 1];
-        u32                  i2 = o.indices_[i + 2];
-        JPH::IndexedTriangle triangle(i0, i1, i2, 0);
-        indexList.emplace_back(std::move(triangle));
-    }
+    // 同じモデル・スケール・LODのメッシュは形状を使いまわす (MeshShapeの構築が重いため)
+    ShapeKey key;
+    key.type_         = shape::Type::Mesh;
+    key.params_       = {o.scale_};
+    key.source_       = o.source_;
+    key.lod_          = o.lod_;
+    key.vertex_count_ = o.vertices_.size();
+    key.index_count_  = o.indices_.size();
+
+    JPH::ShapeRefC shape = findShape(key, [&] {
+        //----------------------------------------------------------
+        // 頂点配列を取得
+        //----------------------------------------------------------
+        JPH::VertexList          vertexList;
+        JPH::IndexedTriangleList indexList;
+
+        for(auto& v: o.vertices_) {
+            JPH::Float3 position{v.x, v.y, v.z};
+            vertexList.emplace_back(std::move(position));
+        }
+        for(u32 i = 0; i < o.indices_.size(); i += 3) {
+            u32                  i0 = o.indices_[i + 0];
+            u32                  i1 = o.indices_[i + 1];
+            u32                  i2 = o.indices_[i + 2];
+            JPH::IndexedTriangle triangle(i0, i1, i2, 0);
+            indexList.emplace_back(std::move(triangle));
+        }
 
-    JPH::PhysicsMaterialList materialList;
-    materialList.push_back(new JPH::PhysicsMaterialSimple("BPMeshMaterial", JPH::Color::sGetDistinctColor(0)));
+        JPH::PhysicsMaterialList materialList;
+        materialList.push_back(new JPH::PhysicsMaterialSimple("BPMeshMaterial", JPH::Color::sGetDistinctColor(0)));
 
-    //----------------------------------------------------------
-    // シェイプを生成
-    //----------------------------------------------------------
-    JPH::MeshShapeSettings          shape_settings(vertexList, indexList, materialList);
-    JPH::ShapeSettings::ShapeResult result = shape_settings.Create();
+        //----------------------------------------------------------
+        // シェイプを生成
+        //----------------------------------------------------------
+        JPH::MeshShapeSettings shape_settings(vertexList, indexList, materialList);
+        return shape_settings.Create();
+    });
 
-    if(result.HasError())
+    if(shape == nullptr)
         return nullptr;
 
     // 作成
     // メッシュ剛体は常に静的で生成されます
-    return std::make_shared<RigidBodyImpl>(result.Get(), layer, physics::MotionType::Static);
+    return std::make_shared<RigidBodyImpl>(shape, layer, physics::MotionType::Static);
 }
 
 //@}
@@ -31,6 +31,22 @@ enum class MotionType {
     Dynamic,      //!< 通常の物理オブジェクトとして力に応答する。
 };
 
+//--------------------------------------------------------------
+//! 剛体の生成状況 (デバッグ表示用)
+//--------------------------------------------------------------
+struct RigidBodyStats {
+    u32 shape_count_     = 0;    //!< キャッシュ済みの形状数
+    u32 shape_hits_      = 0;    //!< 形状キャッシュから再利用した数
+    u32 shape_misses_    = 0;    //!< 形状を新しく生成した数
+    u32 shape_released_  = 0;    //!< 使われなくなりキャッシュから解放した形状の数
+    u32 pooled_bodies_   = 0;    //!< プールで待機中のボディ数
+    u32 pool_hits_       = 0;    //!< プールから再利用したボディ数
+    u32 pending_adds_    = 0;    //!< ワールドへの追加待ちのボディ数
+    u32 pending_removes_ = 0;    //!< ワールドからの削除待ちのボディ数
+    u32 last_added_      = 0;    //!< 直前の反映でまとめて追加したボディ数
+    u32 last_removed_    = 0;    //!< 直前の反映でまとめて削除したボディ数
+};
+
 //===========================================================================
 //! 剛体クラス
 //===========================================================================
@@ -82,6 +98,13 @@ class RigidBody {
     //! 重心の変換行列を取得
     virtual matrix centerOfMassTransform() const = 0;
 
+    //! 描画用に補間したワールド行列を取得
+    //! @param  [in]    alpha   補間係数 (0.0f:最後のステップ前 ～ 1.0f:最新)
+    virtual matrix interpolatedMatrix(f32 alpha) const = 0;
+
+    //! 補間元として現在の位置と回転姿勢を保存
+    virtual void storeState() = 0;
+
     //@}
     //-----------------------------------------------------------
     //! @name   速度と角速度
@@ -219,6 +242,9 @@ class RigidBody {
 
 //===========================================================================
 //! @name   生成
+//! @details 形状は種類とパラメーター (メッシュはモデルファイルとスケール) ごとにキャッシュされ、
+//!          同じ形状の剛体では使いまわされます。静的以外の剛体は削除時にプールへ戻り、次の生成で再利用されます。
+//!          ワールドへの追加と削除は次の物理更新の直前にまとめて行われます
 //===========================================================================
 //@{
 
@@ -258,4 +284,25 @@ std::shared_ptr<physics::RigidBody> createRigidBody(const shape::Mesh& o, u16 la
 
 //@}
 
+//  すべての剛体の補間元を保存
+//! @note   物理シミュレーションの最後のステップ直前に呼ばれます
+void storeRigidBodyStates();
+
+//  追加・削除待ちの剛体をまとめてワールドに反映
+//! @return 前回の呼び出しから追加した静的な剛体の数
+//! @note   物理シミュレーションの更新の直前に呼ばれます
+u32 flushRigidBodies();
+
+//  使われなくなった形状をキャッシュから解放するよう予約
+//! @note   シーンの切り替え時に呼ばれます。次の flushRigidBodies() で、剛体から参照されていない形状を
+//!         (プールで待機中のボディだけが参照している場合はそのボディごと) 解放します
+void requestReleaseUnusedShapes();
+
+//  形状キャッシュと剛体プールを解放
+//! @note   物理シミュレーションの終了時に呼ばれます
+void clearRigidBodyCache();
+
+//  剛体の生成状況を取得
+RigidBodyStats rigidBodyStats();
+
 }    // namespace physics
@@ -23,12 +23,14 @@ ConvexHull::ConvexHull(Model* model): shape::Base(shape::Type::ConvexHull) {
     // リソースがロード中の場合は読み込みが終わるまで待つ
     resource_model->waitForReadFinish();
 
+    source_ = resource_model->path();
+
     //----------------------------------------------------------
     // モデルキャッシュから頂点配列とインデックス配列を取得
     // この配列は既にリダクションされたジオメトリです
     //----------------------------------------------------------
     // 頂点配列
-    auto& varray = model_cache->vertices();
+    auto varray = model_cache->vertices();
     for(auto& v: varray) {
         vertices_.push_back(cast(v));    // DxLib::VECTOR→float3にキャストしながらコピー
     }
@@ -41,7 +43,7 @@ ConvexHull::ConvexHull(Model* model): shape::Base(shape::Type::ConvexHull) {
 //---------------------------------------------------------------------------
 //! コンストラクタ
 //---------------------------------------------------------------------------
-Mesh::Mesh(Model* model, f32 scale): shape::Base(shape::Type::Mesh) {
+Mesh::Mesh(Model* model, f32 scale, f32 max_error): shape::Base(shape::Type::Mesh) {
     auto* resource_model = model->resource();
     auto* model_cache    = resource_model->modelCache();
 
@@ -55,13 +57,18 @@ Mesh::Mesh(Model* model, f32 scale): shape::Base(shape::Type::Mesh) {
     // この配列は既にリダクションされたジオメトリです
     //----------------------------------------------------------
     // 頂点配列
-    auto& varray = model_cache->vertices();
+    auto varray = model_cache->vertices();
     for(auto& v: varray) {
         vertices_.push_back(cast(v) * scale);    // DxLib::VECTOR→float3にキャストしながらコピー
     }
 
-    // インデックス配列
-    indices_ = model_cache->indices();
+    // インデックス配列 (許容誤差に収まる範囲で粗いLODを使う)
+    lod_         = model_cache->selectLodByError(max_error);
+    auto indices = model_cache->indices(lod_);
+    indices_.assign(indices.begin(), indices.end());
+
+    source_ = resource_model->path();
+    scale_  = scale;
 }
 
 }    // namespace shape
@@ -4,6 +4,11 @@
 //---------------------------------------------------------------------------
 #pragma once
 
+#include <string>
+#include <vector>
+
+class Model;
+
 namespace shape {
 //--------------------------------------------------------------
 //! デフォルト質量
@@ -111,9 +116,17 @@ class Cylinder: public shape::Base {
 class ConvexHull: public shape::Base {
    public:
     std::vector<float3> vertices_;
+    std::wstring        source_;    //!< 生成元のモデルファイル (形状キャッシュのキー)
 
     //! コンストラクタ
     ConvexHull(Model* model);
+
+    //! コンストラクタ (頂点を直接指定)
+    //! @param  [in]    vertices    頂点座標
+    //! @note source_ が空の形状はキャッシュされません
+    ConvexHull(std::vector<float3> vertices)
+        : shape::Base(shape::Type::ConvexHull)
+        , vertices_(std::move(vertices)) {}
 };
 
 //===========================================================================
@@ -123,11 +136,24 @@ class Mesh: public shape::Base {
    public:
     std::vector<float3> vertices_;
     std::vector<u32>    indices_;
+    std::wstring        source_;          //!< 生成元のモデルファイル (形状キャッシュのキー)
+    f32                 scale_ = 1.0f;    //!< スケール値
+    u32                 lod_   = 0;       //!< 使用したLOD番号
 
     //! コンストラクタ
-    //! @param  [in]    model   モデルデーター
-    //! @param  [in]    scale   スケール値
-    Mesh(Model* model, f32 scale = 1.0f);
+    //! @param  [in]    model       モデルデーター
+    //! @param  [in]    scale       スケール値
+    //! @param  [in]    max_error   許容する簡略化誤差 (0なら最も詳細なLODを使用)
+    Mesh(Model* model, f32 scale = 1.0f, f32 max_error = 0.0f);
+
+    //! コンストラクタ (頂点とインデックスを直接指定)
+    //! @param  [in]    vertices    頂点座標 (スケール適用済み)
+    //! @param  [in]    indices     インデックス (3つで1ポリゴン)
+    //! @note source_ が空の形状はキャッシュされません
+    Mesh(std::vector<float3> vertices, std::vector<u32> indices)
+        : shape::Base(shape::Type::Mesh)
+        , vertices_(std::move(vertices))
+        , indices_(std::move(indices)) {}
 };
 
 }    // namespace shape
@@ -0,0 +1,245 @@
+﻿//---------------------------------------------------------------------------
+//! @file   ProcDispatcher.cpp
+//! @brief  処理タイミングごとの呼び出しリスト (優先順に並べた配列)
+//---------------------------------------------------------------------------
+#include "ProcDispatcher.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace {
+//! ProcInvoker 以外の処理を呼び出す
+void invokeFunction(void* p) {
+    (*static_cast<std::function<void()>*>(p))();
+}
+}    // namespace
+
+//===========================================================================
+//! 登録された処理
+//===========================================================================
+struct ProcDispatcher::Entry {
+    ProcInvoker                    invoker_;     //!< 呼び出し (切断済みなら call_ が nullptr)
+    s32                            priority_;    //!< 優先
+    u64                            serial_;      //!< 登録順
+    std::shared_ptr<ProcSlotState> state_;       //!< 接続状態
+};
+
+//===========================================================================
+// 接続ハンドル ProcConnection
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//! 切断
+//---------------------------------------------------------------------------
+void ProcConnection::disconnect() {
+    if(valid())
+        state_->owner_->disconnect(state_.get());
+}
+
+//---------------------------------------------------------------------------
+//! 一時停止
+//---------------------------------------------------------------------------
+void ProcConnection::block() {
+    if(valid())
+        state_->owner_->setBlocked(state_.get(), true);
+}
+
+//---------------------------------------------------------------------------
+//! 再開
+//---------------------------------------------------------------------------
+void ProcConnection::unblock() {
+    if(valid())
+        state_->owner_->setBlocked(state_.get(), false);
+}
+
+//===========================================================================
+// 処理の呼び出しリスト ProcDispatcher
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//! コンストラクタ
+//---------------------------------------------------------------------------
+ProcDispatcher::ProcDispatcher() = default;
+
+//---------------------------------------------------------------------------
+//! デストラクタ
+//---------------------------------------------------------------------------
+ProcDispatcher::~ProcDispatcher() {
+    // 残っているハンドルが解放済みの自分を触らないようにする
+    disconnect_all();
+}
+
+//---------------------------------------------------------------------------
+//! 処理を登録します
+//---------------------------------------------------------------------------
+ProcConnection ProcDispatcher::connect(const std::function<void()>& func, int priority) {
+    auto state    = std::make_shared<ProcSlotState>();
+    state->owner_ = this;
+
+    Entry entry;
+    entry.priority_ = priority;
+    entry.serial_   = serial_++;
+    entry.state_    = state;
+
+    // Object/Component の標準処理は関数ポインタで直接呼び出す
+    if(auto invoker = func.target<ProcInvoker>()) {
+        entry.invoker_ = *invoker;
+    } else {
+        state->func_   = func;
+        entry.invoker_ = {&invokeFunction, &state->func_};
+    }
+
+    // 呼び出し中は配列を壊さないように次回の呼び出しで反映する
+    if(dispatching_) {
+        pending_.push_back(std::move(entry));
+    } else {
+        state->index_ = static_cast<u32>(entries_.size());
+        entries_.push_back(std::move(entry));
+        blocked_bits_.resize((entries_.size() + 63) / 64, 0);
+    }
+
+    active_++;
+    dirty_ = true;
+
+    ProcConnection connection;
+    connection.state_ = std::move(state);
+    return connection;
+}
+
+//---------------------------------------------------------------------------
+//! すべての処理を切断します
+//---------------------------------------------------------------------------
+void ProcDispatcher::disconnect_all() {
+    for(auto& entry: entries_) {
+        entry.state_->owner_ = nullptr;
+        entry.state_->index_ = NONE;
+        entry.invoker_.call_ = nullptr;
+    }
+    for(auto& entry: pending_) {
+        entry.state_->owner_ = nullptr;
+        entry.state_->index_ = NONE;
+        entry.invoker_.call_ = nullptr;
+    }
+
+    // 呼び出し中は配列は残しておき、次回の呼び出しで片付ける
+    if(!dispatching_) {
+        entries_.clear();
+        pending_.clear();
+        blocked_bits_.clear();
+    }
+
+    active_ = 0;
+    dirty_  = true;
+}
+
+//---------------------------------------------------------------------------
+//! 登録順に処理を呼び出します
+//---------------------------------------------------------------------------
+void ProcDispatcher::operator()() {
+    // 再入時は二重に呼び出さない
+    if(dispatching_)
+        return;
+
+    if(dirty_)
+        rebuild();
+
+    dispatching_ = true;
+
+    // 処理中に追加された分は pending_ に入るので要素数は変わらない
+    const size_t count = entries_.size();
+    for(size_t i = 0; i < count; ++i) {
+        if(blocked_bits_[i >> 6] & (1ull << (i & 63)))
+            continue;
+
+        const auto& invoker = entries_[i].invoker_;
+        if(invoker.call_)
+            invoker.call_(invoker.target_);
+    }
+
+    dispatching_ = false;
+}
+
+//---------------------------------------------------------------------------
+//! 登録されている処理数
+//---------------------------------------------------------------------------
+size_t ProcDispatcher::size() const {
+    return active_;
+}
+
+//---------------------------------------------------------------------------
+//! 一時停止中の処理数
+//---------------------------------------------------------------------------
+size_t ProcDispatcher::blockedCount() const {
+    size_t count = 0;
+    for(auto bits: blocked_bits_)
+        count += std::popcount(bits);
+    return count;
+}
+
+//---------------------------------------------------------------------------
+//! 削除済みを詰めて優先順に並べ替え
+//---------------------------------------------------------------------------
+void ProcDispatcher::rebuild() {
+    for(auto& entry: pending_)
+        entries_.push_back(std::move(entry));
+    pending_.clear();
+
+    // 切断済みを取り除く
+    entries_.erase(std::remove_if(entries_.begin(), entries_.end(), [](const Entry& e) { return e.invoker_.call_ == nullptr; }),
+                   entries_.end());
+
+    // 優先が同じものは登録順 (sigslot のグループと同じ並び)
+    std::sort(entries_.begin(), entries_.end(), [](const Entry& a, const Entry& b) {
+        if(a.priority_ != b.priority_)
+            return a.priority_ < b.priority_;
+        return a.serial_ < b.serial_;
+    });
+
+    // 位置と一時停止ビットを振りなおす
+    blocked_bits_.assign((entries_.size() + 63) / 64, 0);
+    for(u32 i = 0; i < static_cast<u32>(entries_.size()); ++i) {
+        auto& state   = entries_[i].state_;
+        state->index_ = i;
+        if(state->blocked_)
+            blocked_bits_[i >> 6] |= 1ull << (i & 63);
+    }
+
+    dirty_ = false;
+}
+
+//---------------------------------------------------------------------------
+//! 切断
+//---------------------------------------------------------------------------
+void ProcDispatcher::disconnect(ProcSlotState* state) {
+    if(state->index_ != NONE) {
+        entries_[state->index_].invoker_.call_ = nullptr;
+    } else {
+        for(auto& entry: pending_) {
+            if(entry.state_.get() == state)
+                entry.invoker_.call_ = nullptr;
+        }
+    }
+
+    state->owner_ = nullptr;
+    state->index_ = NONE;
+
+    active_--;
+    dirty_ = true;
+}
+
+//---------------------------------------------------------------------------
+//! 一時停止設定
+//---------------------------------------------------------------------------
+void ProcDispatcher::setBlocked(ProcSlotState* state, bool block) {
+    state->blocked_ = block;
+
+    // 未反映のものは rebuild() でビットを立てる
+    u32 i = state->index_;
+    if(i == NONE)
+        return;
+
+    if(block)
+        blocked_bits_[i >> 6] |= 1ull << (i & 63);
+    else
+        blocked_bits_[i >> 6] &= ~(1ull << (i & 63));
+}
@@ -0,0 +1,114 @@
+﻿//---------------------------------------------------------------------------
+//! @file   ProcDispatcher.h
+//! @brief  処理タイミングごとの呼び出しリスト (優先順に並べた配列)
+//---------------------------------------------------------------------------
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+class ProcDispatcher;
+
+//===========================================================================
+//! @brief 関数ポインタ1つで呼び出せる処理
+//! @details ProcTimingFunc にこの型で入れておくと、std::function を経由せずに呼び出されます
+//===========================================================================
+struct ProcInvoker {
+    void (*call_)(void*) = nullptr;    //!< 呼び出し関数
+    void* target_        = nullptr;    //!< 呼び出し対象
+
+    void operator()() const {
+        call_(target_);
+    }
+};
+
+//===========================================================================
+//! 接続状態 (ProcConnection と ProcDispatcher で共有)
+//===========================================================================
+struct ProcSlotState {
+    ProcDispatcher*       owner_   = nullptr;    //!< 登録先 (切断済みならnullptr)
+    u32                   index_   = ~0u;        //!< 登録配列内の位置 (未反映なら~0)
+    bool                  blocked_ = false;      //!< 一時停止中
+    std::function<void()> func_;                 //!< ProcInvoker 以外の処理
+};
+
+//===========================================================================
+//! @brief 接続ハンドル
+//! @details sigslot::connection と同じ使い方ができるようにしています
+//===========================================================================
+class ProcConnection {
+    friend class ProcDispatcher;
+
+   public:
+    //! 接続中か
+    bool valid() const {
+        return state_ && state_->owner_;
+    }
+
+    //! 一時停止中か
+    bool blocked() const {
+        return state_ && state_->blocked_;
+    }
+
+    //! 切断
+    void disconnect();
+
+    //! 一時停止
+    void block();
+
+    //! 再開
+    void unblock();
+
+   private:
+    std::shared_ptr<ProcSlotState> state_;
+};
+
+//===========================================================================
+//! @brief 処理の呼び出しリスト
+//! @details 優先順に並べた連続配列を先頭から呼び出します。
+//!          並べ替えは登録/削除があった次の呼び出し時のみ行い、
+//!          一時停止はビット列で判定します
+//===========================================================================
+class ProcDispatcher final : noncopyable {
+    friend class ProcConnection;
+
+   public:
+    static constexpr u32 NONE = ~0u;    //!< 配列に未反映
+
+    ProcDispatcher();
+    ~ProcDispatcher();
+
+    //! @brief 処理を登録します
+    //! @param func 処理 (ProcInvoker の場合は直接呼び出す)
+    //! @param priority 優先 (小さいほど先に呼ばれ、同じ優先は登録順)
+    //! @return 接続ハンドル
+    ProcConnection connect(const std::function<void()>& func, int priority);
+
+    //! すべての処理を切断します
+    void disconnect_all();
+
+    //! 登録順に処理を呼び出します
+    void operator()();
+
+    //! 登録されている処理数
+    size_t size() const;
+
+    //! 一時停止中の処理数
+    size_t blockedCount() const;
+
+   private:
+    struct Entry;
+
+    void rebuild();                                       //!< 削除済みを詰めて優先順に並べ替え
+    void disconnect(ProcSlotState* state);                //!< 切断
+    void setBlocked(ProcSlotState* state, bool block);    //!< 一時停止設定
+
+    std::vector<Entry> entries_;                //!< 優先順の処理配列
+    std::vector<Entry> pending_;                //!< 呼び出し中に追加された処理
+    std::vector<u64>   blocked_bits_;           //!< 一時停止ビット (entries_ と同じ並び)
+    u64                serial_      = 0;        //!< 登録通し番号
+    size_t             active_      = 0;        //!< 有効な処理数
+    bool               dirty_       = false;    //!< 並べ替えが必要
+    bool               dispatching_ = false;    //!< 呼び出し中
+};
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "Priority.h"
+#include "ProcDispatcher.h"
 #include <System/Signals.h>
 #include <System/Cereal.h>
 #include <functional>
@@ -173,7 +174,7 @@ struct SlotProc {
     std::string               name_{};
     ProcTiming                timing_   = ProcTiming::Draw;
     ProcPriority              priority_ = ProcPriority::NORMAL;
-    sigslot::connection       connect_{};
+    ProcConnection            connect_{};
     bool                      dirty_ = true;
     ProcTimingFunc            proc_;
     std::shared_ptr<Callable> func_;
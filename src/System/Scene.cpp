@@ -4,7 +4,16 @@
 #include <System/Object.h>
 #include <System/Component/ComponentModel.h>
 #include <System/Component/ComponentCollision.h>
+#include <System/Component/ComponentEffect.h>
 #include <System/Debug/DebugCamera.h>
+#include <System/AssetRegistry.h>
+#include <System/AssetPreloader.h>
+#include <System/Graphics/TexturePool.h>
+#include <System/Graphics/InstancedRenderer.h>
+#include <System/Graphics/Frustum.h>
+#include <System/Physics/PhysicsEngine.h>
+#include <System/Physics/RigidBody.h>
+#include <System/Geometry.h>
 #include <System/SystemMain.h>    // ResetDeltaTime
 
 #include <algorithm>
@@ -37,6 +46,24 @@ float scene_overlap = 0.0f;     //!< シーン切り替えオーバーラップ
 
 bool scene_change_next = false;    //!< 次のシーンへ移行する
 
+bool  scene_collision_broadphase = true;    //!< 当たり判定でブロードフェーズを使用する
+float scene_collision_time       = 0.0f;    //!< 当たり判定の処理時間(ms)
+int   scene_collision_pairs      = 0;       //!< 当たり判定の候補ペア数
+
+bool  scene_collision_shape_cache = true;    //!< 当たり判定で形状キャッシュ(SIMDのまとめ判定)を使用する
+int   scene_collision_batched     = 0;       //!< 形状キャッシュでまとめて判定した候補数
+int   scene_collision_hits        = 0;       //!< 当たったペア数
+
+int scene_state_touched = 0;    //!< PreUpdateで処理状態を反映したオブジェクト数
+
+float scene_world_matrix_time  = 0.0f;    //!< ワールド行列確定の処理時間(ms)
+int   scene_world_matrix_count = 0;       //!< ワールド行列を確定したコンポーネント数
+
+bool  scene_culling        = true;    //!< 描画前に視錐台カリングを行う
+float scene_culling_time   = 0.0f;    //!< 視錐台カリングの処理時間(ms)
+int   scene_culling_count  = 0;       //!< 視錐台カリングで判定したモデル数
+int   scene_culling_culled = 0;       //!< 視錐台カリングで描画しなかったモデル数
+
 int                   select_object_index = 0;    //!< GUIでセレクトされているオブジェクト
 std::weak_ptr<Object> selectObject;
 
@@ -66,18 +93,37 @@ int bgm_index = -1;
 //std::vector<BGMInfo> bgm_list;
 #pragma endregion
 
+//! @brief Objectの処理呼び出し (ProcDispatcherから関数ポインタで直接呼ばれる)
+template<void (Object::*Func)()>
+void callObjectProc(void* obj) {
+    (static_cast<Object*>(obj)->*Func)();
+}
+
+//! @brief Componentの処理呼び出し (ProcDispatcherから関数ポインタで直接呼ばれる)
+template<void (Component::*Func)()>
+void callComponentProc(void* cmp) {
+    (static_cast<Component*>(cmp)->*Func)();
+}
+
+//! @brief ProcAddProcで作成した処理の呼び出し
+void callCallableProc(void* callable) {
+    static_cast<Callable*>(callable)->Exec();
+}
+
 //auto BindObjectUpdate( ProcTiming proc, ObjectPtr obj )
-auto BindObject(ProcTiming proc, ObjectPtr obj) {
-    using ObjectType = void (Object::*)();
+ProcInvoker BindObject(ProcTiming proc, ObjectPtr obj) {
+    using ObjectType = void (*)(void*);
 
     ObjectType func_table[] = {
-        &Object::PreUpdate,  &Object::Update,  &Object::LateUpdate, &Object::PrePhysics, &Object::PostPhysics,
-        &Object::PostUpdate, &Object::PreDraw, &Object::Draw,       &Object::LateDraw,   &Object::PostDraw,
+        &callObjectProc<&Object::PreUpdate>,  &callObjectProc<&Object::Update>,     &callObjectProc<&Object::LateUpdate>,
+        &callObjectProc<&Object::PrePhysics>, &callObjectProc<&Object::PostPhysics>, &callObjectProc<&Object::PostUpdate>,
+        &callObjectProc<&Object::PreDraw>,    &callObjectProc<&Object::Draw>,        &callObjectProc<&Object::LateDraw>,
+        &callObjectProc<&Object::PostDraw>,
     };
 
     assert(static_cast<u32>(proc) < static_cast<u32>(ProcTiming::NUM));
 
-    return std::bind(func_table[static_cast<int>(proc)], obj.get());
+    return ProcInvoker{func_table[static_cast<int>(proc)], obj.get()};
 
     //assert( !"処理がBindできません" );
     //return std::bind( &Object::Update, obj.get(), std::placeholders::_1 );
@@ -118,7 +164,7 @@ auto BindObject(ProcTiming proc, ObjectPtr obj) {
 #endif
 
 //auto BindComponentUpdate( ProcTiming proc, ComponentPtr cmp )
-auto BindComponent(ProcTiming proc, ComponentPtr cmp) {
+ProcInvoker BindComponent(ProcTiming proc, ComponentPtr cmp) {
 #if 0
     if(ProcTiming::PreUpdate == proc)
         return std::bind(&Component::PreUpdate, cmp.get(), std::placeholders::_1);
@@ -154,16 +200,19 @@ auto BindComponent(ProcTiming proc, ComponentPtr cmp) {
     assert(!"処理がBindできません");
     return std::bind(&Component::Update, cmp.get(), std::placeholders::_1);
 #endif
-    using ComponentType = void (Component::*)();
+    using ComponentType = void (*)(void*);
 
     ComponentType func_table[] = {
-        &Component::PreUpdate,  &Component::Update,  &Component::LateUpdate, &Component::PrePhysics, &Component::PostPhysics,
-        &Component::PostUpdate, &Component::PreDraw, &Component::Draw,       &Component::LateDraw,   &Component::PostDraw,
+        &callComponentProc<&Component::PreUpdate>,   &callComponentProc<&Component::Update>,
+        &callComponentProc<&Component::LateUpdate>,  &callComponentProc<&Component::PrePhysics>,
+        &callComponentProc<&Component::PostPhysics>, &callComponentProc<&Component::PostUpdate>,
+        &callComponentProc<&Component::PreDraw>,     &callComponentProc<&Component::Draw>,
+        &callComponentProc<&Component::LateDraw>,    &callComponentProc<&Component::PostDraw>,
     };
 
     assert(static_cast<u32>(proc) < static_cast<u32>(ProcTiming::NUM));
 
-    return std::bind(func_table[static_cast<int>(proc)], cmp.get());
+    return ProcInvoker{func_table[static_cast<int>(proc)], cmp.get()};
 }
 #if 0
 	auto BindComponentProc( ProcTiming proc, ComponentPtr cmp )
@@ -240,6 +289,9 @@ void Scene::Base::SetPriority(ObjectPtr obj, ProcTiming timing, ProcPriority pri
     proc.proc_     = BindObject(timing, obj);
     resetProc(obj, proc);
     setProc(obj, proc);
+
+    // 接続しなおしたのでポーズ状態を再反映する
+    Scene::RequestObjectState(obj.get());
 }
 
 //!	@brief 優先を設定変更します
@@ -256,6 +308,9 @@ void Scene::Base::SetPriority(ComponentPtr component, ProcTiming timing, ProcPri
     proc.proc_                          = BindComponent(timing, component);
     resetProc(component, proc);
     setProc(component, proc);
+
+    // 接続しなおしたのでポーズ状態を再反映する
+    Scene::RequestObjectState(component->GetOwner());
 }
 
 void Scene::Base::PreRegister(ObjectPtr obj, ProcPriority update, ProcPriority draw) {
@@ -360,6 +415,10 @@ void Scene::Base::Register(ObjectPtr obj, ProcPriority update, ProcPriority draw
     proc_postdraw.proc_     = BindObject(ProcTiming::PostDraw, obj);
     proc_postdraw.dirty_    = false;
     setProc(obj, proc_postdraw);
+
+    // 初期化と状態の反映を予約
+    obj->scene_registered_ = true;
+    Scene::RequestObjectState(obj.get());
 }
 
 void Scene::Base::RegisterForLoad(ObjectPtr obj) {
@@ -401,6 +460,10 @@ void Scene::Base::RegisterForLoad(ObjectPtr obj) {
 
     auto& proc_postdraw  = obj->GetProc(GetProcTimingName(ProcTiming::PostDraw), ProcTiming::PostDraw);
     proc_postdraw.dirty_ = true;
+
+    // 処理登録と状態の反映を予約
+    obj->scene_registered_ = true;
+    Scene::RequestObjectState(obj.get());
 }
 
 void Scene::Base::Unregister(ObjectPtr obj) {
@@ -408,6 +471,11 @@ void Scene::Base::Unregister(ObjectPtr obj) {
 
     obj->RemoveAllProcesses();
 
+    // 予約していた状態反映を取り消す
+    obj->scene_registered_ = false;
+    obj->state_requested_  = false;
+    std::erase_if(state_requests_, [&obj](const ObjectWeakPtr& w) { return w.lock() == obj; });
+
     // リストから削除( 自動deleteされる )
     (*itr)->RemoveAllComponents();
     (*itr)->ModifyComponents();
@@ -421,17 +489,43 @@ void Scene::Base::UnregisterAll() {
         obj->ModifyComponents();
 
         obj->RemoveAllProcesses();
+
+        obj->scene_registered_ = false;
+        obj->state_requested_  = false;
     }
     for(auto obj: objects_)
         leak_objs.push_back(obj);
 
+    state_requests_.clear();
+
     objects_.clear();
 
+    // ブロードフェーズも空にする
+    collision_broadphase_.clear();
+    collision_contacts_.clear();
+    collision_proxies_.clear();
+    collision_list_.clear();
+    collision_owners_.clear();
+
     // シグナルカット
+    for(auto& d: dispatchers_)
+        d.disconnect_all();
     for(auto& s: signals_)
         s.disconnect_all();
 }
 
+//! @brief タイミングの処理を呼び出す
+//! @param timing 処理タイミング
+void Scene::Base::Dispatch(ProcTiming timing) {
+    LONGLONG start_time = GetNowHiPerformanceCount();
+
+    // 登録処理を優先順に呼び出した後、外部から接続されたシグナルを呼ぶ
+    dispatchers_[static_cast<int>(timing)]();
+    signals_[static_cast<int>(timing)]();
+
+    dispatch_time_[static_cast<int>(timing)] = (float)(GetNowHiPerformanceCount() - start_time) / 1000.0f;
+}
+
 //! 同じシーンタイプがいないかチェックする
 bool Scene::Base::IsSceneExist(const BasePtr& scene) {
     auto it = scenes_.find(scene->typeInfo()->className());
@@ -472,13 +566,12 @@ void Scene::Base::setProc(ObjectPtr obj, SlotProc& slot) {
 
     if(slot.func_ == nullptr) {
         proc.SetProc(slot.GetName(), slot.GetTiming(), slot.GetPriority(), slot.GetProc());
-        proc.connect_ = current_scene_->GetSignals(slot.GetTiming()).connect(proc.proc_, (int)proc.priority_);
+        proc.connect_ = current_scene_->GetProcDispatcher(slot.GetTiming()).connect(proc.proc_, (int)proc.priority_);
     } else {
         proc.SetAddProc(slot.GetAddProc(), slot.GetTiming(), slot.GetPriority());
         auto p         = proc.GetAddProc().get();
-        auto ptr       = std::bind(&Callable::Exec, p);
-        proc.GetProc() = ptr;
-        proc.connect_  = current_scene_->GetSignals(slot.GetTiming()).connect(proc.proc_, (int)proc.priority_);
+        proc.GetProc() = ProcInvoker{&callCallableProc, p};
+        proc.connect_  = current_scene_->GetProcDispatcher(slot.GetTiming()).connect(proc.proc_, (int)proc.priority_);
     }
 }
 
@@ -504,7 +597,7 @@ void Scene::Base::setProc(ComponentPtr component, SlotProc& slot) {
     proc.SetProc(slot.GetName(), slot.GetTiming(), slot.GetPriority(), slot.GetProc());
 
     // 設定したい優先に設定する
-    proc.connect_ = current_scene_->GetSignals(slot.GetTiming()).connect(proc.proc_, (int)proc.priority_);
+    proc.connect_ = current_scene_->GetProcDispatcher(slot.GetTiming()).connect(proc.proc_, (int)proc.priority_);
 }
 
 //! @brief コンポーネントの指定処理を削除する
@@ -774,7 +867,18 @@ void Scene::ChangeNextScene() {
         }
     }
 
+    // 次回の先読みのため、抜けるシーンで使用したアセットを記録
+    if(current_scene_)
+        AssetPreloader::saveManifest(current_scene_->typeInfo()->className());
+
     current_scene_ = next_scene_;
+
+    // 以前のシーンのアセットは新しいシーンの初期化後に参照が無ければ解放する
+    AssetRegistry::changeScene();
+
+    // 前のシーンだけで使っていた剛体の形状も、剛体が削除された後に解放する
+    physics::requestReleaseUnusedShapes();
+
     if(!found) {
         // objectが解放できていない?
         ObjectWeakPtrVec objs = leak_objs;
@@ -860,6 +964,120 @@ void Scene::Change(BasePtr scene) {
     SetNextScene(scene);
 }
 
+//! @brief オブジェクトの処理状態(処理登録/ポーズ/更新/描画)を反映する
+//! @param obj オブジェクト
+//! @param scene_paused シーン全体がポーズ中か
+//! @return 初期化まで終了したか
+bool Scene::applyObjectState(ObjectPtr obj, bool scene_paused) {
+    // ポーズ中
+    bool is_pause = false;
+    if(obj->GetStatus(::Object::StatusBit::IsPause) || (scene_paused && !obj->GetStatus(::Object::StatusBit::DisablePause)))
+        is_pause = true;
+
+    //if( !is_pause )
+    {
+        // Init前状態
+        if(!obj->GetStatus(::Object::StatusBit::Initialized)) {
+            bool ret = obj->Init();
+            if(!ret)
+                return false;    //!< 初期化未終了
+
+            assert("継承先のInit()にて__super::Init()を入れてください." &&
+                   obj->GetStatus(::Object::StatusBit::Initialized));
+        }
+
+        functionSerialize(obj);
+    }
+#if 1
+    // dirtyのチェック
+    for(auto& timing: obj->proc_timings_) {
+        auto& proc = timing.second;
+        if(proc.IsDirty()) {
+            current_scene_->resetProc(obj, proc);
+            current_scene_->setProc(obj, proc);
+            proc.ResetDirty();
+        }
+    }
+
+    for(auto& comp: obj->components_) {
+        // Componentのdirtyのチェック
+        for(auto& timing: comp->proc_timings_) {
+            auto& proc = timing.second;
+            if(proc.IsDirty()) {
+                current_scene_->resetProc(comp, proc);
+                current_scene_->setProc(comp, proc);
+                proc.ResetDirty();
+            }
+        }
+    }
+#endif
+
+#if 1
+    // オブジェクトのUpdate
+    if(obj->GetStatus(::Object::StatusBit::NoUpdate) || is_pause) {
+        for(auto& sig: obj->proc_timings_) {
+            if((int)sig.second.IsUpdate())
+                sig.second.connect_.block();
+        }
+
+        // コンポーネントのUpdate
+        for(auto& component: obj->GetComponents()) {
+            for(auto& sig: component->proc_timings_) {
+                if((int)sig.second.IsUpdate())
+                    sig.second.connect_.block();
+            }
+        }
+    } else {
+        for(auto& sig: obj->proc_timings_) {
+            if((int)sig.second.IsUpdate())
+                sig.second.connect_.unblock();
+        }
+
+        // コンポーネントのUpdate
+        for(auto& component: obj->GetComponents()) {
+            for(auto& sig: component->proc_timings_) {
+                if((int)sig.second.IsUpdate())
+                    sig.second.connect_.unblock();
+            }
+        }
+    }
+#endif
+
+#if 1
+    // オブジェクトのDraw
+    if(obj->GetStatus(::Object::StatusBit::NoDraw)) {
+        for(auto& sig: obj->proc_timings_) {
+            if((int)sig.second.IsDraw())
+                sig.second.connect_.block();
+        }
+
+        // コンポーネント
+        for(auto& component: obj->GetComponents()) {
+            for(auto& sig: component->proc_timings_) {
+                if((int)sig.second.IsDraw())
+                    sig.second.connect_.block();
+            }
+        }
+    } else {
+        for(auto& sig: obj->proc_timings_) {
+            if((int)sig.second.IsDraw())
+                sig.second.connect_.unblock();
+        }
+
+        // コンポーネント
+        // NoDrawはここでおさえない
+        for(auto& component: obj->GetComponents()) {
+            for(auto& sig: component->proc_timings_) {
+                if((int)sig.second.IsDraw())
+                    sig.second.connect_.unblock();
+            }
+        }
+    }
+#endif
+
+    return true;
+}
+
 void Scene::PreUpdate() {
     if(IsKeyOn(KEY_INPUT_F1))
         scene_pause = !scene_pause;
@@ -883,6 +1101,12 @@ void Scene::PreUpdate() {
             // ログ
             bool initialized = current_scene_->Init();
             current_scene_->SetStatus(Scene::Base::StatusBit::Initialized, initialized);
+            if(initialized) {
+                AssetRegistry::sceneReady();
+
+                // 初期化で再取得されたので先読みの保持は不要
+                AssetPreloader::release();
+            }
 
             // シーン初期化でブロッキングロードをしていた場合に時間経過が大きくなるためリセット
             ResetDeltaTime();
@@ -906,117 +1130,38 @@ void Scene::PreUpdate() {
             current_scene_->SetStatus(Scene::Base::StatusBit::Serialized, true);
         }
 
-        // 処理優先とポーズのチェック
-        for(auto& obj: current_scene_->GetObjectPtrVec()) {
-            // ポーズ中
-            bool is_pause = false;
-            if(obj->GetStatus(::Object::StatusBit::IsPause) ||
-               ((scene_pause && !scene_step) && !obj->GetStatus(::Object::StatusBit::DisablePause)))
-                is_pause = true;
-
-            //if( !is_pause )
-            {
-                // Init前状態
-                if(!obj->GetStatus(::Object::StatusBit::Initialized)) {
-                    bool ret = obj->Init();
-                    if(!ret)
-                        continue;    //!< 初期化未終了
-
-                    assert("継承先のInit()にて__super::Init()を入れてください." &&
-                           obj->GetStatus(::Object::StatusBit::Initialized));
-                }
-
-                functionSerialize(obj);
-            }
-#if 1
-            // dirtyのチェック
-            for(auto& timing: obj->proc_timings_) {
-                auto& proc = timing.second;
-                if(proc.IsDirty()) {
-                    current_scene_->resetProc(obj, proc);
-                    current_scene_->setProc(obj, proc);
-                    proc.ResetDirty();
-                }
-            }
-
-            for(auto& comp: obj->components_) {
-                // Componentのdirtyのチェック
-                for(auto& timing: comp->proc_timings_) {
-                    auto& proc = timing.second;
-                    if(proc.IsDirty()) {
-                        current_scene_->resetProc(comp, proc);
-                        current_scene_->setProc(comp, proc);
-                        proc.ResetDirty();
-                    }
-                }
+        // シーン全体のポーズが切り替わった場合は影響を受けるオブジェクトをすべて予約する
+        bool scene_paused = scene_pause && !scene_step;
+        if(scene_paused != current_scene_->applied_pause_) {
+            current_scene_->applied_pause_ = scene_paused;
+            for(auto& obj: current_scene_->objects_) {
+                if(!obj->GetStatus(::Object::StatusBit::DisablePause))
+                    RequestObjectState(obj.get());
             }
-#endif
-
-#if 1
-            // オブジェクトのUpdate
-            // TODO is_pause または NoUpdateが変化したときのみ処理をする
-            if(obj->GetStatus(::Object::StatusBit::NoUpdate) || is_pause) {
-                for(auto& sig: obj->proc_timings_) {
-                    if((int)sig.second.IsUpdate())
-                        sig.second.connect_.block();
-                }
-
-                // コンポーネントのUpdate
-                for(auto& component: obj->GetComponents()) {
-                    for(auto& sig: component->proc_timings_) {
-                        if((int)sig.second.IsUpdate())
-                            sig.second.connect_.block();
-                    }
-                }
-            } else {
-                for(auto& sig: obj->proc_timings_) {
-                    if((int)sig.second.IsUpdate())
-                        sig.second.connect_.unblock();
-                }
+        }
 
-                // コンポーネントのUpdate
-                for(auto& component: obj->GetComponents()) {
-                    for(auto& sig: component->proc_timings_) {
-                        if((int)sig.second.IsUpdate())
-                            sig.second.connect_.unblock();
-                    }
-                }
-            }
-#endif
+        // 状態が変化したオブジェクトのみ処理優先とポーズを反映する
+        auto& requests = current_scene_->state_requests_;
+        auto& applying = current_scene_->state_applying_;
+        applying.swap(requests);
 
-#if 1
-            // オブジェクトのDraw
-            if(obj->GetStatus(::Object::StatusBit::NoDraw)) {
-                for(auto& sig: obj->proc_timings_) {
-                    if((int)sig.second.IsDraw())
-                        sig.second.connect_.block();
-                }
+        int touched = 0;
+        for(auto& weak_obj: applying) {
+            auto obj = weak_obj.lock();
+            if(obj == nullptr)
+                continue;
 
-                // コンポーネント
-                for(auto& component: obj->GetComponents()) {
-                    for(auto& sig: component->proc_timings_) {
-                        if((int)sig.second.IsDraw())
-                            sig.second.connect_.block();
-                    }
-                }
-            } else {
-                for(auto& sig: obj->proc_timings_) {
-                    if((int)sig.second.IsDraw())
-                        sig.second.connect_.unblock();
-                }
+            obj->state_requested_ = false;
+            touched++;
 
-                // コンポーネント
-                // NoDrawはここでおさえない
-                for(auto& component: obj->GetComponents()) {
-                    for(auto& sig: component->proc_timings_) {
-                        if((int)sig.second.IsDraw())
-                            sig.second.connect_.unblock();
-                    }
-                }
-            }
-#endif
+            // 初期化が終わっていないものは次のフレームでもう一度
+            if(!applyObjectState(obj, scene_paused))
+                RequestObjectState(obj.get());
         }
-        current_scene_->GetSignals(ProcTiming::PreUpdate)();
+        applying.clear();
+        scene_state_touched = touched;
+
+        current_scene_->Dispatch(ProcTiming::PreUpdate);
     }
 }
 
@@ -1084,13 +1229,13 @@ void Scene::Update() {
             current_scene_->Update();
         }
 
-        current_scene_->GetSignals(ProcTiming::Update)();
+        current_scene_->Dispatch(ProcTiming::Update);
 
         if(!scene_pause || scene_step) {
             current_scene_->LateUpdate();
             scene_time += delta;
         }
-        current_scene_->GetSignals(ProcTiming::LateUpdate)();
+        current_scene_->Dispatch(ProcTiming::LateUpdate);
     }
 }
 
@@ -1098,7 +1243,7 @@ void Scene::PrePhysics() {
     if(current_scene_) {
         current_scene_->PrePhysics();
 
-        current_scene_->GetSignals(ProcTiming::PrePhysics)();
+        current_scene_->Dispatch(ProcTiming::PrePhysics);
 
         // Physics
         CheckComponentCollisions();
@@ -1109,15 +1254,21 @@ void Scene::PostPhysics() {
     if(current_scene_) {
         current_scene_->PostPhysics();
 
-        current_scene_->GetSignals(ProcTiming::PostPhysics)();
+        current_scene_->Dispatch(ProcTiming::PostPhysics);
     }
 }
 
 void Scene::PostUpdate() {
     if(current_scene_) {
         current_scene_->PostUpdate();
-        current_scene_->GetSignals(ProcTiming::PostUpdate)();
+        current_scene_->Dispatch(ProcTiming::PostUpdate);
+
+        // すべての移動が終わったのでワールド行列を確定する
+        ResolveWorldMatrices();
     }
+
+    // アニメーションの統計情報をフレームで区切る
+    Animation::finishFrame();
 }
 
 void Scene::Draw() {
@@ -1127,15 +1278,21 @@ void Scene::Draw() {
 
     // シーンPreDrawの実行
     current_scene_->PreDraw();
-    current_scene_->GetSignals(ProcTiming::PreDraw)();
+    current_scene_->Dispatch(ProcTiming::PreDraw);
+
+    // 視錐台の外のモデルは描画しない
+    CullModels();
 
     // シーンDrawの実行
     current_scene_->Draw();
 
-    current_scene_->GetSignals(ProcTiming::Draw)();
+    current_scene_->Dispatch(ProcTiming::Draw);
+
+    // Drawで登録された静的メッシュをまとめて描画
+    InstancedRenderer::flush();
 
     current_scene_->LateDraw();
-    current_scene_->GetSignals(ProcTiming::LateDraw)();
+    current_scene_->Dispatch(ProcTiming::LateDraw);
 
 #pragma region customized
     if(scene_draw_menu) {
@@ -1190,14 +1347,14 @@ void Scene::Draw() {
 #pragma endregion
 
     current_scene_->PostDraw();
-    current_scene_->GetSignals(ProcTiming::PostDraw)();
+    current_scene_->Dispatch(ProcTiming::PostDraw);
 
-    current_scene_->GetSignals(ProcTiming::Shadow)();
-    current_scene_->GetSignals(ProcTiming::Gbuffer)();
-    current_scene_->GetSignals(ProcTiming::Light)();
-    current_scene_->GetSignals(ProcTiming::HDR)();
-    current_scene_->GetSignals(ProcTiming::Filter)();
-    current_scene_->GetSignals(ProcTiming::UI)();
+    current_scene_->Dispatch(ProcTiming::Shadow);
+    current_scene_->Dispatch(ProcTiming::Gbuffer);
+    current_scene_->Dispatch(ProcTiming::Light);
+    current_scene_->Dispatch(ProcTiming::HDR);
+    current_scene_->Dispatch(ProcTiming::Filter);
+    current_scene_->Dispatch(ProcTiming::UI);
 
     scene_step = false;
 
@@ -1311,6 +1468,81 @@ void Scene::GUI() {
         ImGui::DragFloat(u8"経過時間", &scene_time, 0.1f, 0, 0, "%.2f");
         ImGui::Text(u8"シーン内Object数 : %d", current_scene_->GetObjectPtrVec().size());
 
+        if(ImGui::TreeNode(u8"当たり判定")) {
+            ImGui::Checkbox(u8"ブロードフェーズ", &scene_collision_broadphase);
+            ImGui::Text(u8"処理時間 : %.3f ms", scene_collision_time);
+            ImGui::Text(u8"判定ペア数 : %d", scene_collision_pairs);
+            ImGui::Text(u8"プロキシ数 : %d", (int)current_scene_->collision_broadphase_.proxyCount());
+            ImGui::Text(u8"ツリーの高さ : %d", current_scene_->collision_broadphase_.height());
+            ImGui::Separator();
+            ImGui::Checkbox(u8"形状キャッシュ", &scene_collision_shape_cache);
+            ImGui::Text(u8"まとめて判定した候補数 : %d", scene_collision_batched);
+            ImGui::Text(u8"当たったペア数 : %d", scene_collision_hits);
+            ImGui::Text(u8"接触中のペア数 : %d", (int)current_scene_->collision_contacts_.size());
+            ImGui::TreePop();
+        }
+
+        if(ImGui::TreeNode(u8"物理")) {
+            auto body_stats = physics::rigidBodyStats();
+            ImGui::Text(u8"形状キャッシュ : %d (再利用 %d / 生成 %d / 解放 %d)", body_stats.shape_count_,
+                        body_stats.shape_hits_, body_stats.shape_misses_, body_stats.shape_released_);
+            ImGui::Text(u8"剛体プール : 待機 %d / 再利用 %d", body_stats.pooled_bodies_, body_stats.pool_hits_);
+            ImGui::Text(u8"追加待ち : %d  削除待ち : %d", body_stats.pending_adds_, body_stats.pending_removes_);
+            ImGui::Text(u8"直前のまとめて追加 : %d  削除 : %d", body_stats.last_added_, body_stats.last_removed_);
+            ImGui::TreePop();
+        }
+
+        ImGui::Text(u8"状態反映Object数 : %d", scene_state_touched);
+
+        if(ImGui::TreeNode(u8"アセット")) {
+            AssetRegistry::GUI();
+
+            auto texture_stats = TexturePool::stats();
+            ImGui::Text(u8"テクスチャ読み込み : 待ち %d / 読み込み中 %d", texture_stats.queued_count_, texture_stats.loading_count_);
+            ImGui::Text(u8"先読み : %.0f %%", AssetPreloader::progress() * 100.0f);
+            ImGui::TreePop();
+        }
+
+        if(ImGui::TreeNode(u8"処理リスト")) {
+            // タイミングごとの登録数/停止数/処理時間
+            for(int i = 0; i < static_cast<int>(ProcTiming::NUM); i++) {
+                auto& dispatcher = current_scene_->dispatchers_[i];
+                if(dispatcher.size() == 0)
+                    continue;
+                ImGui::Text(u8"%s : %d (停止 %d) %.3f ms", GetProcTimingName(static_cast<ProcTiming>(i)).c_str(),
+                            (int)dispatcher.size(), (int)dispatcher.blockedCount(), current_scene_->dispatch_time_[i]);
+            }
+            ImGui::TreePop();
+        }
+
+        if(ImGui::TreeNode(u8"ワールド行列")) {
+            // OFFにすると毎回再計算する (キャッシュとの比較計測用)
+            bool cache = WorldMatrixCache::IsEnable();
+            if(ImGui::Checkbox(u8"キャッシュ", &cache))
+                WorldMatrixCache::SetEnable(cache);
+            ImGui::Text(u8"確定処理時間 : %.3f ms", scene_world_matrix_time);
+            ImGui::Text(u8"確定コンポーネント数 : %d", scene_world_matrix_count);
+            ImGui::TreePop();
+        }
+
+        if(ImGui::TreeNode(u8"視錐台カリング")) {
+            // OFFにするとすべて描画する (比較計測用)
+            ImGui::Checkbox(u8"カリング", &scene_culling);
+            ImGui::Text(u8"処理時間 : %.3f ms", scene_culling_time);
+            ImGui::Text(u8"モデル数 : %d (非表示 %d)", scene_culling_count, scene_culling_culled);
+            ImGui::TreePop();
+        }
+
+        if(ImGui::TreeNode(u8"アニメーション")) {
+            auto stats = Animation::stats();
+            ImGui::Text(u8"更新時間 : %.3f ms", stats.update_time_);
+            ImGui::Text(u8"時間を更新したアニメーション数 : %u", stats.updated_clips_);
+            ImGui::Text(u8"ブレンド率の再設定 : %u", stats.blend_updates_);
+            ImGui::Text(u8"アタッチ / 解除 : %u / %u", stats.attach_count_, stats.detach_count_);
+            ImGui::Text(u8"イベント通知 : %u", stats.event_count_);
+            ImGui::TreePop();
+        }
+
         //------------------------------------------
         // 登録されているObjectを列挙する
         //------------------------------------------
@@ -1516,81 +1748,465 @@ void Scene::ExitApp() {
 }
 #pragma endregion
 
+namespace {
+//! @brief 当たり情報を通知する
+//! @param contacts 接触ペアキャッシュ
+//! @param col_1 自分のコリジョン
+//! @param col_2 相手のコリジョン
+//! @param hitInfo 当たり情報 (当たっていない場合は何もしない)
+//! @return 当たったか
+bool notifyCollisionPair(CollisionContactCache& contacts, const ComponentCollisionPtr& col_1,
+                         const ComponentCollisionPtr& col_2, ComponentCollision::HitInfo& hitInfo) {
+    if(!hitInfo.hit_)
+        return false;
+
+    // 押し戻し量再計算
+    float3 push{hitInfo.push_ * 0.5f};
+    float3 other_push{-hitInfo.push_ * 0.5f};
+    col_1->CalcPush(col_2, hitInfo.push_, &push, &other_push);
+
+    // 相手か自分がオーバーラップする設定ならば押しあたりは発生しないようにする
+    // オーバーラップする場合は当たりをすり抜ける
+    if(col_1->IsOverlap(col_2->GetCollisionGroup())) {
+        push       = {0, 0, 0};
+        other_push = {0, 0, 0};
+    }
+
+    // 相手もオーバーラップする場合は当たりをすり抜ける
+    if(col_2->IsOverlap(col_1->GetCollisionGroup())) {
+        push       = {0, 0, 0};
+        other_push = {0, 0, 0};
+    }
+
+    hitInfo.collision_     = col_1;
+    hitInfo.hit_collision_ = col_2;
+    hitInfo.push_          = push;
+    col_1->OnHit(hitInfo);
+
+    hitInfo.collision_     = col_2;
+    hitInfo.hit_collision_ = col_1;
+    hitInfo.push_          = other_push;
+    col_2->OnHit(hitInfo);
+
+    // 接触の開始/継続を通知する
+    bool stay = contacts.touch(col_1->GetContactId(), col_2->GetContactId(), hitInfo.hit_position_);
+
+    ComponentCollision::ContactInfo contactInfo;
+    contactInfo.hit_position_ = hitInfo.hit_position_;
+
+    contactInfo.collision_      = col_1.get();
+    contactInfo.hit_collision_  = col_2.get();
+    contactInfo.hit_contact_id_ = col_2->GetContactId();
+    if(stay)
+        col_1->OnHitStay(contactInfo);
+    else
+        col_1->OnHitEnter(contactInfo);
+
+    contactInfo.collision_      = col_2.get();
+    contactInfo.hit_collision_  = col_1.get();
+    contactInfo.hit_contact_id_ = col_1->GetContactId();
+    if(stay)
+        col_2->OnHitStay(contactInfo);
+    else
+        col_2->OnHitEnter(contactInfo);
+    return true;
+}
+
+//! @brief コリジョン同士の当たり判定を行い、当たり情報を通知する
+//! @param contacts 接触ペアキャッシュ
+//! @param col_1 自分のコリジョン
+//! @param col_2 相手のコリジョン
+//! @return 当たったか
+bool checkCollisionPair(CollisionContactCache& contacts, const ComponentCollisionPtr& col_1,
+                        const ComponentCollisionPtr& col_2) {
+    if(!col_1->IsGroupHit(col_2))
+        return false;
+
+    // コリジョンどうしの当たりをチェックする
+    ComponentCollision::HitInfo hitInfo;
+    hitInfo = col_1->IsHit(col_2);
+
+    return notifyCollisionPair(contacts, col_1, col_2, hitInfo);
+}
+
+//! @brief 形状キャッシュでまとめて判定できる組み合わせか
+//! @details IsHit() が判定する組み合わせのうち、相手が球/カプセルのもの
+//!          (球/カプセルからラインへの判定は IsHit() で行われないため対象外)
+bool isShapeCachePair(CollisionShape::Type type_1, CollisionShape::Type type_2) {
+    if(type_2 != CollisionShape::Type::Sphere && type_2 != CollisionShape::Type::Capsule)
+        return false;
+    return type_1 != CollisionShape::Type::None;
+}
+
+//! @brief 判定対象コリジョンのワールド形状を形状キャッシュに設定する
+void updateCollisionShapes(CollisionShapeCache& shapes, const ComponentCollisionPtrVec& cols) {
+    shapes.resize(cols.size());
+    for(u32 i = 0; i < (u32)cols.size(); i++) {
+        CollisionShape shape;
+        if(cols[i]->GetWorldShape(&shape))
+            shapes.set(i, shape);
+    }
+}
+
+//! @brief オーナーのコリジョン形状を更新する (押し戻しで移動した場合)
+//! @param index 判定順のコリジョン番号 (同じオーナーのコリジョンは連続して並んでいる)
+void updateOwnerShapes(CollisionShapeCache& shapes, const ComponentCollisionPtrVec& cols, const std::vector<Object*>& owners,
+                       s32 index) {
+    auto* owner = owners[index];
+
+    s32 first = index;
+    while(first > 0 && owners[first - 1] == owner)
+        first--;
+
+    for(s32 i = first; i < (s32)cols.size() && owners[i] == owner; i++) {
+        CollisionShape shape;
+        cols[i]->GetWorldShape(&shape);
+        shapes.set(i, shape);
+    }
+}
+
+//! @brief 形状キャッシュを使って候補ペアを判定する
+//! @details 同じコリジョンの連続した候補を SIMD でまとめて判定し、当たったペアだけ当たり情報を作成します。
+//!          当たった場合は押し戻しで移動した形状を更新し、残りの候補を判定しなおすため
+//!          通知の順番と結果はペアごとに IsHit() で判定した場合と同じになります
+//! @return 当たったペア数
+int checkCollisionPairsWithShapeCache(CollisionShapeCache& shapes, CollisionContactCache& contacts,
+                                      const ComponentCollisionPtrVec& cols, const std::vector<Object*>& owners,
+                                      const std::vector<std::pair<s32, s32>>& pairs, int* batched) {
+    std::vector<u32>                          candidates;
+    std::vector<CollisionShapeCache::Contact> results;
+
+    int hit_count = 0;
+    for(size_t k = 0; k < pairs.size();) {
+        const s32  i      = pairs[k].first;
+        const auto type_i = shapes.type(i);
+
+        // まとめて判定できないもの (モデルなど) はそのまま IsHit() で判定する
+        if(!isShapeCachePair(type_i, shapes.type(pairs[k].second))) {
+            const s32 j = pairs[k].second;
+            if(checkCollisionPair(contacts, cols[i], cols[j])) {
+                updateOwnerShapes(shapes, cols, owners, i);
+                updateOwnerShapes(shapes, cols, owners, j);
+                hit_count++;
+            }
+            k++;
+            continue;
+        }
+
+        // 続けてまとめて判定できる候補を集める
+        candidates.clear();
+        for(; k < pairs.size() && pairs[k].first == i && isShapeCachePair(type_i, shapes.type(pairs[k].second)); k++) {
+            const s32 j = pairs[k].second;
+            if(cols[i]->IsGroupHit(cols[j]))
+                candidates.push_back(j);
+        }
+        results.resize(candidates.size());
+
+        u32 begin = 0;
+        while(begin < (u32)candidates.size()) {
+            u32 count = (u32)candidates.size() - begin;
+            u32 hits  = shapes.overlapBatch(i, &candidates[begin], count, results.data());
+            *batched += count;
+            if(hits == 0)
+                break;
+
+            // 最初に当たった候補を通知する (それより前の候補は当たっていない)
+            const u32 end     = begin + results[0].index_;
+            const s32 j       = candidates[end];
+            auto      hitInfo = ComponentCollision::HitInfoFromContact(shapes, i, j, results[0]);
+            notifyCollisionPair(contacts, cols[i], cols[j], hitInfo);
+            hit_count++;
+
+            // 押し戻し後の形状で残りの候補を判定しなおす
+            updateOwnerShapes(shapes, cols, owners, i);
+            updateOwnerShapes(shapes, cols, owners, j);
+            begin = end + 1;
+        }
+    }
+
+    return hit_count;
+}
+}    // namespace
+
 //! @brief ComponentCollisionの当たり判定を行う
-void           Scene::CheckComponentCollisions() {
-    // オブジェの数を取得
-    int obj_num = (int)current_scene_->GetObjectPtrVec().size();
-    for(int obj_index = 0; obj_index < obj_num; obj_index++) {
-        // 調べるオブジェクト
-        auto obj = current_scene_->GetObjectPtrVec()[obj_index];
-
-        // コンポーネントコリジョン群の取得
-        auto cols = obj->GetComponents<ComponentCollision>();
-        {
-            // コリジョンの検査
-            for(auto col_1: cols) {
-                // 相手オブジェクトの取得
-                for(int other_index = obj_index + 1; other_index < obj_num; other_index++) {
-                    std::vector<ComponentCollision::HitInfo> hitInfos;
-
-                    // 相手オブジェクト
-                    auto obj2 = current_scene_->GetObjectPtrVec()[other_index];
-
-                    auto cols2 = obj2->GetComponents<ComponentCollision>();
-
-                    // 相手コリジョンの検査
-                    for(auto col_2: cols2) {
-                        if(!col_1->IsGroupHit(col_2))
-                            continue;
-
-                        // コリジョンどうしの当たりをチェックする
-                        ComponentCollision::HitInfo hitInfo;
-                        hitInfo = col_1->IsHit(col_2);
-
-                        if(hitInfo.hit_) {
-                            // 押し戻し量再計算
-                            float3 push{hitInfo.push_ * 0.5f};
-                            float3 other_push{-hitInfo.push_ * 0.5f};
-                            col_1->CalcPush(col_2, hitInfo.push_, &push, &other_push);
-
-                            // 相手か自分がオーバーラップする設定ならば押しあたりは発生しないようにする
-                            // オーバーラップする場合は当たりをすり抜ける
-                            if(col_1->IsOverlap(col_2->GetCollisionGroup())) {
-                                push       = {0, 0, 0};
-                                other_push = {0, 0, 0};
-                            }
-
-                            // 相手もオーバーラップする場合は当たりをすり抜ける
-                            if(col_2->IsOverlap(col_1->GetCollisionGroup())) {
-                                push       = {0, 0, 0};
-                                other_push = {0, 0, 0};
-                            }
-
-                            hitInfo.collision_     = col_1;
-                            hitInfo.hit_collision_ = col_2;
-                            hitInfo.push_          = push;
-                            col_1->OnHit(hitInfo);
-
-                            hitInfo.collision_     = col_2;
-                            hitInfo.hit_collision_ = col_1;
-                            hitInfo.push_          = other_push;
-                            col_2->OnHit(hitInfo);
-                        }
-#pragma region customized
-                        else if(!hitInfo.hit_) {
-                            hitInfo.collision_     = col_1;
-                            hitInfo.hit_collision_ = col_2;
-                            col_1->ExitHit(hitInfo);
-                            //hitInfo.collision_     = col_2;
-                            //hitInfo.hit_collision_ = col_1;
-                            //col_2->ExitHit(hitInfo);
-                        }
-#pragma endregion
-                    }
-                }
+void Scene::CheckComponentCollisions() {
+    LONGLONG start_time = GetNowHiPerformanceCount();
+
+    auto& objects = current_scene_->objects_;
+    auto& cols    = current_scene_->collision_list_;
+    auto& owners  = current_scene_->collision_owners_;
+
+    //----------------------------------------------------------
+    // 判定対象のコリジョンを収集 (オブジェクト登録順)
+    //----------------------------------------------------------
+    cols.clear();
+    owners.clear();
+    for(auto& obj: objects) {
+        for(auto& cmp: obj->GetComponents()) {
+            auto col = std::dynamic_pointer_cast<ComponentCollision>(cmp);
+            if(col == nullptr)
+                continue;
+            cols.push_back(col);
+            owners.push_back(obj.get());
+        }
+    }
+
+    auto& pairs = current_scene_->collision_pairs_;
+    pairs.clear();
+
+    if(!scene_collision_broadphase) {
+        //----------------------------------------------------------
+        // 全ペアを候補にする (ブロードフェーズとの比較用)
+        //----------------------------------------------------------
+        for(size_t i = 0; i < cols.size(); i++) {
+            for(size_t j = i + 1; j < cols.size(); j++) {
+                // 同じオブジェクトのコリジョン同士は判定しない
+                if(owners[i] == owners[j])
+                    continue;
+                pairs.emplace_back((s32)i, (s32)j);
             }
         }
+    } else {
+        auto& broadphase = current_scene_->collision_broadphase_;
+        auto& proxies    = current_scene_->collision_proxies_;
+        auto& order      = current_scene_->collision_order_;
+
+        //----------------------------------------------------------
+        // ブロードフェーズへの登録・更新
+        //----------------------------------------------------------
+        // 範囲の決まらないものは十分大きなAABBにする
+        constexpr float     unbounded = 1.0e+8f;
+        const CollisionAABB unbounded_aabb{{-unbounded, -unbounded, -unbounded}, {unbounded, unbounded, unbounded}};
+
+        std::vector<CollisionAABB> aabbs(cols.size());
+        for(size_t i = 0; i < cols.size(); i++) {
+            auto& col = cols[i];
+
+            CollisionAABB aabb;
+            if(!col->GetWorldAABB(&aabb))
+                aabb = unbounded_aabb;
+
+            aabbs[i] = aabb;
+
+            s32& proxy = col->broadphase_proxy_;
+            if(!broadphase.isValidProxy(proxy) || broadphase.userData(proxy) != col.get()) {
+                // 新規登録
+                proxy = broadphase.createProxy(aabb, col.get());
+                proxies.push_back(proxy);
+            } else {
+                // 前回位置からの移動分を含めた範囲にする
+                // (モデルとの判定は前フレーム位置からの移動量で行うため)
+                aabbs[i] = CollisionAABB::merge(aabb, col->broadphase_aabb_);
+                broadphase.moveProxy(proxy, aabbs[i]);
+            }
+            col->broadphase_aabb_ = aabb;
+        }
+
+        //----------------------------------------------------------
+        // 存在しなくなったコリジョンのプロキシを削除
+        //----------------------------------------------------------
+        s32 max_proxy = -1;
+        for(s32 proxy: proxies)
+            max_proxy = std::max(max_proxy, proxy);
+
+        order.assign(max_proxy + 1, -1);
+        for(size_t i = 0; i < cols.size(); i++)
+            order[cols[i]->broadphase_proxy_] = (s32)i;
+
+        for(size_t i = 0; i < proxies.size();) {
+            if(order[proxies[i]] >= 0) {
+                i++;
+                continue;
+            }
+            broadphase.destroyProxy(proxies[i]);
+            proxies[i] = proxies.back();
+            proxies.pop_back();
+        }
+
+        //----------------------------------------------------------
+        // 候補ペアの収集
+        //----------------------------------------------------------
+        for(size_t i = 0; i < cols.size(); i++) {
+            broadphase.query(aabbs[i], [&](s32 proxy) {
+                s32 j = order[proxy];
+
+                // 自分より前のコリジョンとのペアは相手側で収集される
+                if(j <= (s32)i || owners[i] == owners[j])
+                    return true;
+
+                pairs.emplace_back((s32)i, j);
+                return true;
+            });
+        }
+
+        // 押し戻しの結果が変わらないよう、全ペア判定と同じ順番で処理する
+        std::sort(pairs.begin(), pairs.end());
+    }
+
+    //----------------------------------------------------------
+    // 候補ペアの判定
+    //----------------------------------------------------------
+    auto& contacts = current_scene_->collision_contacts_;
+    contacts.beginFrame();
+
+    int hit_count = 0;
+    int batched   = 0;
+    if(scene_collision_shape_cache) {
+        // ワールド形状は判定前に一度だけ求めておく
+        auto& shapes = current_scene_->collision_shapes_;
+        updateCollisionShapes(shapes, cols);
+        hit_count = checkCollisionPairsWithShapeCache(shapes, contacts, cols, owners, pairs, &batched);
+    } else {
+        for(auto& [i, j]: pairs) {
+            if(checkCollisionPair(contacts, cols[i], cols[j]))
+                hit_count++;
+        }
     }
+
+    //----------------------------------------------------------
+    // 接触が終わったペアを通知する
+    //----------------------------------------------------------
+    auto& ids = current_scene_->collision_ids_;
+    ids.clear();
+    contacts.endFrame([&](const CollisionContactCache::Contact& contact) {
+        // 接触IDからコリジョンを探す表は、終了したペアがある時だけ作る
+        if(ids.empty()) {
+            for(auto& col: cols)
+                ids.emplace_back(col->GetContactId(), col.get());
+            std::sort(ids.begin(), ids.end());
+        }
+
+        // 削除されたコリジョンはnullptrになる
+        ComponentCollision* col[2];
+        for(int n = 0; n < 2; n++) {
+            auto it = std::lower_bound(ids.begin(), ids.end(), contact.id_[n],
+                                       [](const std::pair<u32, ComponentCollision*>& id, u32 value) { return id.first < value; });
+            col[n]  = (it != ids.end() && it->first == contact.id_[n]) ? it->second : nullptr;
+        }
+
+        for(int n = 0; n < 2; n++) {
+            if(col[n] == nullptr)
+                continue;
+
+            ComponentCollision::ContactInfo contactInfo;
+            contactInfo.collision_      = col[n];
+            contactInfo.hit_collision_  = col[1 - n];
+            contactInfo.hit_contact_id_ = contact.id_[1 - n];
+            contactInfo.hit_position_   = contact.hit_position_;
+            col[n]->OnHitExit(contactInfo);
+        }
+    });
+
+    scene_collision_pairs   = (int)pairs.size();
+    scene_collision_hits    = hit_count;
+    scene_collision_batched = batched;
+    scene_collision_time    = (float)(GetNowHiPerformanceCount() - start_time) / 1000.0f;
+}
+
+//! @brief 当たり判定に形状キャッシュ(SIMDのまとめ判定)を使用するか設定する
+void Scene::SetCollisionShapeCache(bool use) {
+    scene_collision_shape_cache = use;
+}
+
+//! @brief 当たり判定に形状キャッシュを使用しているか
+bool Scene::IsCollisionShapeCache() {
+    return scene_collision_shape_cache;
+}
+
+//! @brief 当たり判定にブロードフェーズを使用するか設定する
+void Scene::SetCollisionBroadphase(bool use) {
+    scene_collision_broadphase = use;
+}
+
+//! @brief 当たり判定にブロードフェーズを使用しているか
+bool Scene::IsCollisionBroadphase() {
+    return scene_collision_broadphase;
+}
+
+//! @brief オブジェクトの処理状態(処理登録/ポーズ/更新/描画)の再設定を予約する
+void Scene::RequestObjectState(Object* obj) {
+    if(current_scene_ == nullptr || obj == nullptr)
+        return;
+
+    // 本登録前は Register() で予約されるためここでは何もしない
+    if(!obj->scene_registered_ || obj->state_requested_)
+        return;
+
+    auto weak = obj->weak_from_this();
+    if(weak.expired())
+        return;
+
+    obj->state_requested_ = true;
+    current_scene_->state_requests_.push_back(std::move(weak));
+}
+
+//! @brief PostUpdate後のワールド行列を確定する
+void Scene::ResolveWorldMatrices() {
+    LONGLONG start_time = GetNowHiPerformanceCount();
+
+    // ジョブが動いていないメインスレッドでだけキャッシュへ保存する
+    WorldMatrixCache::SetResolving(true);
+
+    int count = 0;
+    for(auto& obj: current_scene_->objects_) {
+        for(auto* model: obj->ViewComponents<ComponentModel>()) {
+            model->ResolveWorldMatrix();
+            count++;
+        }
+        for(auto* effect: obj->ViewComponents<ComponentEffect>()) {
+            effect->ResolveWorldMatrix();
+            count++;
+        }
+    }
+
+    // コリジョンはモデルのワールド行列に依存するため、モデルを確定してから行う
+    for(auto& obj: current_scene_->objects_) {
+        for(auto* collision: obj->ViewComponents<ComponentCollision>()) {
+            collision->GetWorldMatrix();
+            count++;
+        }
+    }
+
+    WorldMatrixCache::SetResolving(false);
+
+    scene_world_matrix_count = count;
+    scene_world_matrix_time  = (float)(GetNowHiPerformanceCount() - start_time) / 1000.0f;
+}
+
+//! @brief 描画前にモデルの視錐台カリングを行う
+void Scene::CullModels() {
+    LONGLONG start_time = GetNowHiPerformanceCount();
+
+    // デバッグカメラ使用時も実際に描画するカメラで判定する
+    Frustum frustum(matrix(GetCameraViewMatrix()), matrix(GetCameraProjectionMatrix()));
+
+    int count  = 0;
+    int culled = 0;
+    for(auto& obj: current_scene_->objects_) {
+        for(auto* model: obj->ViewComponents<ComponentModel>()) {
+            count++;
+            if(!scene_culling) {
+                model->ResetVisibility();
+                continue;
+            }
+            if(!model->UpdateVisibility(frustum))
+                culled++;
+        }
+    }
+
+    scene_culling_count  = count;
+    scene_culling_culled = culled;
+    scene_culling_time   = (float)(GetNowHiPerformanceCount() - start_time) / 1000.0f;
+}
+
+//! @brief 視錐台カリングを使用するか設定する
+void Scene::SetCulling(bool use) {
+    scene_culling = use;
+}
+
+//! @brief 視錐台カリングを使用しているか
+bool Scene::IsCulling() {
+    return scene_culling;
 }
 
 //! セレクトしているオブジェクトかをチェックする
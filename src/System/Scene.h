@@ -7,6 +7,9 @@
 #include <System/Object.h>
 #include <System/Component/ComponentTransform.h>
 #include <System/Component/ComponentCamera.h>
+#include <System/CollisionBroadphase.h>
+#include <System/CollisionShapeCache.h>
+#include <System/CollisionContactCache.h>
 #include <System/Utils/HelperLib.h>
 #include <System/Cereal.h>
 #include <System/TypeInfo.h>
@@ -20,6 +23,8 @@
 #include <sstream>
 #include <string>
 
+USING_PTR(ComponentCollision);
+
 class Scene {
    public:
     class Base;
@@ -214,10 +219,22 @@ class Scene {
         //----------------------------------------------------------------------
         //@{
 
+        //! @brief タイミングのシグナル取得
+        //! @details 外部から接続した処理は登録済みの処理の後に呼ばれます
         SignalsDefault& GetSignals(ProcTiming timing) {
             return signals_[static_cast<int>(timing)];
         }
 
+        //! @brief タイミングの処理リスト取得
+        //! @details Object/Componentの登録処理はこちらに登録されます
+        ProcDispatcher& GetProcDispatcher(ProcTiming timing) {
+            return dispatchers_[static_cast<int>(timing)];
+        }
+
+        //! @brief タイミングの処理を呼び出す
+        //! @param timing 処理タイミング
+        void Dispatch(ProcTiming timing);
+
         //@}
         //--------------------------------------------------------------------
         //! @name ユーザーシグナル
@@ -271,8 +288,26 @@ class Scene {
         ObjectPtrVec      objects_;        //!< シーンに存在するオブジェクト
         Status<StatusBit> status_;         //!< 状態
 
+        CollisionBroadphase                              collision_broadphase_;    //!< コリジョンのブロードフェーズ
+        std::vector<s32>                                 collision_proxies_;       //!< ブロードフェーズに登録中のプロキシ
+        ComponentCollisionPtrVec                         collision_list_;          //!< 判定対象のコリジョン (作業用)
+        std::vector<Object*>                             collision_owners_;        //!< 判定対象コリジョンのオーナー (作業用)
+        std::vector<s32>                                 collision_order_;         //!< プロキシ番号から判定順への変換 (作業用)
+        std::vector<std::pair<s32, s32>>                 collision_pairs_;         //!< 候補ペア (作業用)
+        CollisionShapeCache                              collision_shapes_;        //!< 判定対象コリジョンのワールド形状 (判定順)
+        CollisionContactCache                            collision_contacts_;      //!< フレームをまたいだ接触ペア
+        std::vector<std::pair<u32, ComponentCollision*>> collision_ids_;           //!< 接触IDからコリジョンへの変換 (作業用)
+
         // プロセスタイミングによるシグナル (実行処理)
         std::array<SignalsDefault, static_cast<int>(ProcTiming::NUM)> signals_;
+
+        std::vector<ObjectWeakPtr> state_requests_;             //!< 処理状態の再設定を予約したオブジェクト
+        std::vector<ObjectWeakPtr> state_applying_;             //!< 反映中のオブジェクト (作業用)
+        bool                       applied_pause_ = false;    //!< 反映済みのシーンポーズ状態
+
+        // プロセスタイミングによる処理リスト (優先順の配列)
+        std::array<ProcDispatcher, static_cast<int>(ProcTiming::NUM)> dispatchers_;
+        std::array<float, static_cast<int>(ProcTiming::NUM)>          dispatch_time_{};    //!< 処理時間(ms)
     };
 
     //----------------------------------------------------------------
@@ -580,6 +615,41 @@ class Scene {
     //! @brief ComponentCollisionの当たり判定を行う
     static void CheckComponentCollisions();
 
+    //! @brief 当たり判定にブロードフェーズを使用するか設定する
+    //! @param use false で全ペア判定 (比較計測用)
+    static void SetCollisionBroadphase(bool use);
+
+    //! @brief 当たり判定にブロードフェーズを使用しているか
+    static bool IsCollisionBroadphase();
+
+    //! @brief 当たり判定に形状キャッシュ(SIMDのまとめ判定)を使用するか設定する
+    //! @param use false でペアごとに IsHit() で判定 (比較計測用)
+    static void SetCollisionShapeCache(bool use);
+
+    //! @brief 当たり判定に形状キャッシュを使用しているか
+    static bool IsCollisionShapeCache();
+
+    //! @brief オブジェクトの処理状態(処理登録/ポーズ/更新/描画)の再設定を予約する
+    //! @details 予約されたオブジェクトだけが次のPreUpdateでまとめて反映されます
+    //! @param obj オブジェクト (シーンに本登録されていない場合は何もしない)
+    static void RequestObjectState(Object* obj);
+
+    //! @brief PostUpdate後のワールド行列を確定する
+    //! @details モデル・エフェクト・コリジョンのワールド行列をキャッシュへ保存し、
+    //!          モデル・エフェクトの行列を1フレーム前の行列として保存します
+    static void ResolveWorldMatrices();
+
+    //! @brief 描画前にモデルの視錐台カリングを行う
+    //! @details DxLibに設定されているカメラで判定し、モデルごとの今フレームの可視状態を設定します
+    static void CullModels();
+
+    //! @brief 視錐台カリングを使用するか設定する
+    //! @param use false ですべて描画 (比較計測用)
+    static void SetCulling(bool use);
+
+    //! @brief 視錐台カリングを使用しているか
+    static bool IsCulling();
+
     //! セレクトしているオブジェクトかをチェックする
     static bool SelectObjectWindow(const ObjectPtr& object);
 
@@ -664,6 +734,9 @@ class Scene {
     //! @brief 関数シリアライズ (InitSerializeの呼び出し)
     static void functionSerialize(ObjectPtr obj);
 
+    //! @brief オブジェクトの処理状態(処理登録/ポーズ/更新/描画)を反映する
+    static bool applyObjectState(ObjectPtr obj, bool scene_paused);
+
     // シリアライズされてないものがないかチェックします
     static void checkSerialized(ObjectPtr obj);
     static void checkSerialized(ComponentPtr comp);
@@ -4,6 +4,10 @@
 //---------------------------------------------------------------------------
 #include <System/Debug/DebugCamera.h>
 #include <System/Physics/PhysicsEngine.h>
+#include <System/AssetRegistry.h>
+#include <System/AssetPreloader.h>
+#include <System/Graphics/TexturePool.h>
+#include <System/Graphics/InstancedRenderer.h>
 
 //----------------------------------------------------------------
 // シーンオブジェクト
@@ -109,6 +113,15 @@ void SetDeltaTime(f32 fps) {
     delta_time_ = fps;
 }
 
+//---------------------------------------------------------------------------
+//! 物理シミュレーションに渡す経過時間を取得
+//---------------------------------------------------------------------------
+f32 GetPhysicsDeltaTime() {
+    if(Scene::IsPause())
+        return 0.0f;
+    return delta_time_;
+}
+
 //---------------------------------------------------------------------------------
 //! グリッドの表示をON/OFFします
 //---------------------------------------------------------------------------------
@@ -254,6 +267,14 @@ void ShowFps(f32 delta) {
             ImPlot::EndPlot();
         }
         ImGui::SliderFloat(u8"履歴範囲", &history, 1, 30, "%.1f s");
+
+        //----------------------------------------------------------
+        // 描画コール数 (DxLibは前フレーム分、インスタンス描画は直接描画のため別集計)
+        //----------------------------------------------------------
+        auto instanced = InstancedRenderer::stats();
+        ImGui::Text(u8"描画コール: %d (インスタンス描画 %u)", GetDrawCallCount() + static_cast<s32>(instanced.draw_calls_),
+                    instanced.draw_calls_);
+        ImGui::Text(u8"インスタンス: %u / %u (メッシュ %u)", instanced.visible_, instanced.submitted_, instanced.meshes_);
     }
 
     //----------------------------------------------------------
@@ -306,6 +327,18 @@ void SystemInit() {
     //----------------------------------------------------------
     physics_engine_ = physics::createPhysics();
 
+    // 固定ステップ (FixedRate=0 で従来の可変ステップ)
+    physics_engine_->setFixedStep(ini.GetFloat("Physics", "FixedRate", 60.0f),
+                                  static_cast<u32>(ini.GetInt("Physics", "MaxSteps", 4)));
+
+    //----------------------------------------------------------
+    // アセットのメモリ予算とテクスチャの同時読み込み数、先読みの取得数を設定
+    //----------------------------------------------------------
+    AssetRegistry::setBudget(static_cast<u64>(ini.GetInt("Asset", "BudgetMB", 1024)) * 1024 * 1024);
+    TexturePool::setup(static_cast<u32>(ini.GetInt("Texture", "MaxLoading", 8)));
+    AssetPreloader::setup(static_cast<u32>(ini.GetInt("Asset", "PreloadPerFrame", 4)),
+                          ini.GetFloat("Asset", "PreloadTimeout", 10.0f));
+
     // 現在の時間を初期化
     ResetDeltaTime();
 
@@ -466,11 +499,7 @@ void SystemUpdate() {
     //----------------------------------------------------------
     // 物理シミュレーションを更新
     //----------------------------------------------------------
-    float physics_time = delta_time_;
-    if(Scene::IsPause())
-        physics_time = 0.0f;
-
-    physics_engine_->update(physics_time);
+    physics_engine_->update(GetPhysicsDeltaTime());
 
     //----------------------------------------------------------
     // 物理シミュレーション後の処理
@@ -517,6 +546,15 @@ void SystemDraw() {
     // シーンの描画
     Scene::Draw();
 
+    // 次のシーンの先読み (テクスチャはこの後の TexturePool::update() で読み込みを開始)
+    AssetPreloader::update();
+
+    // 描画で更新された優先順にテクスチャの読み込みを進める
+    TexturePool::update();
+
+    // 使用メモリ量の集計と、参照されなくなったアセットの解放
+    AssetRegistry::update();
+
     //----------------------------------------------------------
     // トーンマッピング
     //----------------------------------------------------------
@@ -544,6 +582,18 @@ void SystemExit() {
     // HDRバッファの解放
     texture_hdr_.reset();
 
+    // 先読みの保持を解除
+    AssetPreloader::release();
+
+    // インスタンス描画の解放
+    InstancedRenderer::clear();
+
+    // テクスチャプールの解放
+    TexturePool::clear();
+
+    // アセットの解放 (以降は保持しているハンドルの破棄で解放されます)
+    AssetRegistry::clear();
+
     //----------------------------------------------------------
     // 物理シミュレーションを解放
     //----------------------------------------------------------
@@ -53,6 +53,8 @@ f32  GetDeltaTime();
 f32  GetDeltaTime60();
 // ツールなどで使用する際強制的にFPSを変更する
 void SetDeltaTime(f32);
+// 物理シミュレーションに渡す経過時間を取得 (ポーズ中は0)
+f32  GetPhysicsDeltaTime();
 
 //	グリッドの表示をON/OFFします
 //! @param  [in]    active  true:表示する false:非表示
@@ -0,0 +1,101 @@
+﻿//---------------------------------------------------------------------------
+//! @file   MappedFile.cpp
+//! @brief  メモリマップドファイル (読み込み専用)
+//---------------------------------------------------------------------------
+#include "MappedFile.h"
+
+#if defined(_WIN32)
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+//---------------------------------------------------------------------------
+//! デストラクタ
+//---------------------------------------------------------------------------
+MappedFile::~MappedFile() {
+    close();
+}
+
+//---------------------------------------------------------------------------
+//! ファイルを開いて割り当てる
+//---------------------------------------------------------------------------
+bool MappedFile::open(const std::string& path) {
+    close();
+
+#if defined(_WIN32)
+    // 割り当て中でも削除/置き換えができるように共有モードを指定
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER file_size{};
+    if(!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(mapping == nullptr) {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if(view == nullptr) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    handle_file_    = file;
+    handle_mapping_ = mapping;
+    data_           = static_cast<const std::byte*>(view);
+    size_           = static_cast<size_t>(file_size.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+        return false;
+
+    struct stat st {};
+    if(fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);    // 割り当て後はファイル記述子は不要
+    if(view == MAP_FAILED)
+        return false;
+
+    data_ = static_cast<const std::byte*>(view);
+    size_ = static_cast<size_t>(st.st_size);
+#endif
+    return true;
+}
+
+//---------------------------------------------------------------------------
+//! 割り当てを解除して閉じる
+//---------------------------------------------------------------------------
+void MappedFile::close() {
+#if defined(_WIN32)
+    if(data_)
+        UnmapViewOfFile(data_);
+    if(handle_mapping_)
+        CloseHandle(handle_mapping_);
+    if(handle_file_)
+        CloseHandle(handle_file_);
+
+    handle_mapping_ = nullptr;
+    handle_file_    = nullptr;
+#else
+    if(data_)
+        munmap(const_cast<std::byte*>(data_), size_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
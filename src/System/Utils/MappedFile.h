@@ -0,0 +1,54 @@
+﻿//---------------------------------------------------------------------------
+//! @file   MappedFile.h
+//! @brief  メモリマップドファイル (読み込み専用)
+//---------------------------------------------------------------------------
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+//===========================================================================
+//! メモリマップドファイル (読み込み専用)
+//! @note ファイルをコピーせずにアドレス空間へ割り当てて直接参照します
+//===========================================================================
+class MappedFile final : noncopyable {
+   public:
+    //! デフォルトコンストラクタ
+    MappedFile() = default;
+
+    //! デストラクタ
+    ~MappedFile();
+
+    //  ファイルを開いて割り当てる
+    //! @param  [in]    path    ファイルパス
+    //! @retval true    成功
+    //! @retval false   失敗 (ファイルが無い/空)
+    bool open(const std::string& path);
+
+    //  割り当てを解除して閉じる
+    void close();
+
+    //! 先頭アドレスを取得 (ページ境界に配置されています)
+    const std::byte* data() const {
+        return data_;
+    }
+
+    //! ファイルサイズを取得
+    size_t size() const {
+        return size_;
+    }
+
+    //! 開いているかどうか
+    bool isOpen() const {
+        return data_ != nullptr;
+    }
+
+   private:
+    const std::byte* data_ = nullptr;    //!< 割り当て先
+    size_t           size_ = 0;          //!< サイズ
+
+#if defined(_WIN32)
+    void* handle_file_    = nullptr;    //!< [Win32] ファイルハンドル
+    void* handle_mapping_ = nullptr;    //!< [Win32] ファイルマッピングハンドル
+#endif
+};
@@ -59,8 +59,8 @@ matrix matrix::scale(f32 s) {
 //! X軸中心の回転行列
 //---------------------------------------------------------------------------
 matrix matrix::rotateX(f32 radian) {
-    f32 s = std::sinf(radian);
-    f32 c = std::cosf(radian);
+    f32 s = std::sin(radian);
+    f32 c = std::cos(radian);
 
     float4 m[4]{
         {1.0f, 0.0f, 0.0f, 0.0f},
@@ -75,8 +75,8 @@ matrix matrix::rotateX(f32 radian) {
 //! Y軸中心の回転行列
 //---------------------------------------------------------------------------
 matrix matrix::rotateY(f32 radian) {
-    f32 s = std::sinf(radian);
-    f32 c = std::cosf(radian);
+    f32 s = std::sin(radian);
+    f32 c = std::cos(radian);
 
     float4 m[4]{
         {   c, 0.0f,   -s, 0.0f},
@@ -91,8 +91,8 @@ matrix matrix::rotateY(f32 radian) {
 //! Z軸中心の回転行列
 //---------------------------------------------------------------------------
 matrix matrix::rotateZ(f32 radian) {
-    f32 s = std::sinf(radian);
-    f32 c = std::cosf(radian);
+    f32 s = std::sin(radian);
+    f32 c = std::cos(radian);
 
     float4 m[4]{
         {   c,    s, 0.0f, 0.0f},
@@ -107,8 +107,8 @@ matrix matrix::rotateZ(f32 radian) {
 //! 任意軸中心の回転行列
 //---------------------------------------------------------------------------
 matrix matrix::rotateAxis(const float3& axis, f32 radian) {
-    f32 s    = std::sinf(radian);
-    f32 c    = std::cosf(radian);
+    f32 s    = std::sin(radian);
+    f32 c    = std::cos(radian);
     f32 invc = 1.0f - c;
 
     float3 v = normalize(axis);
@@ -150,8 +150,8 @@ matrix matrix::lookAtLH(const float3& eye, const float3& lookAt, const float3& w
 //! [左手座標系] 投影行列
 //---------------------------------------------------------------------------
 matrix matrix::perspectiveFovLH(f32 fovy, f32 aspect_ratio, f32 near_z, f32 far_z) {
-    f32 s = std::sinf(fovy * 0.5f);
-    f32 c = std::cosf(fovy * 0.5f);
+    f32 s = std::sin(fovy * 0.5f);
+    f32 c = std::cos(fovy * 0.5f);
 
     f32 height = c / s;
     f32 width  = height / aspect_ratio;
@@ -170,8 +170,8 @@ matrix matrix::perspectiveFovLH(f32 fovy, f32 aspect_ratio, f32 near_z, f32 far_
 //! [左手座標系] 無限遠投影行列
 //---------------------------------------------------------------------------
 matrix matrix::perspectiveFovInfiniteFarPlaneLH(f32 fovy, f32 aspect_ratio, f32 near_z) {
-    f32 s = std::sinf(fovy * 0.5f);
-    f32 c = std::cosf(fovy * 0.5f);
+    f32 s = std::sin(fovy * 0.5f);
+    f32 c = std::cos(fovy * 0.5f);
 
     f32 height = c / s;
     f32 width  = height / aspect_ratio;
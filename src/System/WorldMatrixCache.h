@@ -0,0 +1,103 @@
+﻿//---------------------------------------------------------------------------
+//! @file   WorldMatrixCache.h
+//! @brief  ワールド行列キャッシュ (依存元のバージョンで再計算を判定)
+//---------------------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+
+//===========================================================================
+//! @brief ワールド行列キャッシュ
+//! @details 依存元(オーナーのTransform・自分のローカル行列・アタッチ先)の
+//!          バージョンが変わらない間は保持している行列をそのまま返します
+//! @attention 計算結果の保存は確定処理中 (Scene::ResolveWorldMatrices) だけ行います。
+//!            確定処理はメインスレッドでジョブが動いていない間に呼ばれるため、
+//!            それ以外の const な取得はワーカースレッドから同時に呼ばれても読むだけになります
+//===========================================================================
+class WorldMatrixCache {
+   public:
+    //! @brief 新しいバージョン番号を発行
+    //! @details 全体で単調増加するため、異なる依存元の番号同士が重なることはない。
+    //!          ジョブのワーカースレッドからも呼ばれるためアトミックに発行します
+    static u64 NewVersion() {
+        return next_version_.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    //! @brief キャッシュを利用するか (無効時は毎回再計算する)
+    static void SetEnable(bool enable) {
+        enable_ = enable;
+    }
+    static bool IsEnable() {
+        return enable_;
+    }
+
+    //! @brief 確定処理の開始/終了
+    //! @details 開始から終了までの間だけ resolve() がキャッシュへ保存します
+    static void SetResolving(bool resolving) {
+        resolving_.store(resolving, std::memory_order_relaxed);
+    }
+    static bool IsResolving() {
+        return resolving_.load(std::memory_order_relaxed);
+    }
+
+    //! キャッシュが依存元のバージョンと一致しているか
+    bool isValid(u64 parent, u64 local, u64 attach = 0) const {
+        return IsEnable() && parent_ == parent && local_ == local && attach_ == attach;
+    }
+
+    //! @brief 計算結果を返す (確定処理中のみキャッシュへ保存)
+    matrix resolve(u64 parent, u64 local, u64 attach, const matrix& mat) {
+        if(!IsResolving())
+            return mat;
+
+        world_   = mat;
+        parent_  = parent;
+        local_   = local;
+        attach_  = attach;
+        version_ = NewVersion();
+        return world_;
+    }
+
+    //! キャッシュ済みワールド行列
+    const matrix& get() const {
+        return world_;
+    }
+
+    //! @brief 計算結果のバージョン (子の依存キーとして使用)
+    //! @details 確定後に依存元が変わった場合は、毎回新しい番号を返して子に再計算させます
+    u64 version(u64 parent, u64 local, u64 attach = 0) const {
+        if(isValid(parent, local, attach))
+            return version_;
+
+        return NewVersion();
+    }
+
+    //! 1フレーム前のワールド行列として保存
+    void storeOld(const matrix& mat) {
+        old_world_ = mat;
+        old_valid_ = true;
+    }
+
+    //! 1フレーム前のワールド行列が保存されているか
+    bool hasOld() const {
+        return old_valid_ && IsEnable();
+    }
+
+    //! 1フレーム前のワールド行列
+    const matrix& old() const {
+        return old_world_;
+    }
+
+   private:
+    matrix world_     = matrix::identity();    //!< ワールド行列
+    matrix old_world_ = matrix::identity();    //!< 1フレーム前のワールド行列
+    u64    parent_    = 0;                     //!< 計算時の親バージョン
+    u64    local_     = 0;                     //!< 計算時のローカルバージョン
+    u64    attach_    = 0;                     //!< 計算時のアタッチ先バージョン
+    u64    version_   = 0;                     //!< 計算結果のバージョン
+    bool   old_valid_ = false;                 //!< old_world_ が有効か
+
+    static inline std::atomic<u64>  next_version_ = 0;        //!< 発行済みのバージョン番号
+    static inline std::atomic<bool> resolving_    = false;    //!< 確定処理中か
+    static inline bool              enable_       = true;     //!< キャッシュを利用するか
+};
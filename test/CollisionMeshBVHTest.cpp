@@ -0,0 +1,206 @@
+﻿//---------------------------------------------------------------------------
+//! @file   CollisionMeshBVHTest.cpp
+//! @brief  コリジョンメッシュBVHの単体テスト (ワールド行列を掛けた問い合わせと検証)
+//---------------------------------------------------------------------------
+#include "Test.h"
+
+#include <System/CollisionMeshBVH.h>
+
+#include <tuple>
+
+namespace {
+
+constexpr u32 GRID_SIZE = 24;    //!< 起伏のある地面の分割数
+
+//! 起伏のある地面 (モデル空間)
+struct Mesh {
+    std::vector<VECTOR> vertices_;
+    std::vector<u32>    indices_;
+};
+
+//---------------------------------------------------------------------------
+//! 起伏のある地面を作成
+//---------------------------------------------------------------------------
+Mesh makeGround() {
+    Mesh mesh;
+    for(u32 z = 0; z <= GRID_SIZE; ++z) {
+        for(u32 x = 0; x <= GRID_SIZE; ++x) {
+            f32 fx = static_cast<f32>(x) - GRID_SIZE * 0.5f;
+            f32 fz = static_cast<f32>(z) - GRID_SIZE * 0.5f;
+            mesh.vertices_.push_back({fx, std::sin(fx * 0.7f) * std::cos(fz * 0.5f), fz});
+        }
+    }
+
+    auto vertex = [](u32 x, u32 z) { return z * (GRID_SIZE + 1) + x; };
+    for(u32 z = 0; z < GRID_SIZE; ++z) {
+        for(u32 x = 0; x < GRID_SIZE; ++x) {
+            mesh.indices_.insert(mesh.indices_.end(), {vertex(x, z), vertex(x, z + 1), vertex(x + 1, z)});
+            mesh.indices_.insert(mesh.indices_.end(), {vertex(x + 1, z), vertex(x, z + 1), vertex(x + 1, z + 1)});
+        }
+    }
+    return mesh;
+}
+
+//! 頂点をワールド空間に変換したメッシュ (単位行列で問い合わせる比較用)
+Mesh transformMesh(const Mesh& mesh, const matrix& world) {
+    Mesh result = mesh;
+    for(auto& v: result.vertices_) {
+        float3 p = mul(float4(v.x, v.y, v.z, 1.0f), world).xyz;
+        v        = {p.x, p.y, p.z};
+    }
+    return result;
+}
+
+//! 構築したBVH (配列を保持したまま参照する)
+struct Built {
+    Mesh                     mesh_;
+    CollisionMeshBVH::Source source_;
+    CollisionMeshBVH         bvh_;
+
+    explicit Built(Mesh mesh)
+        : mesh_(std::move(mesh)) {
+        source_ = CollisionMeshBVH::build(mesh_.vertices_, mesh_.indices_);
+        bvh_.attach(mesh_.vertices_, source_.nodes_, source_.indices_);
+    }
+};
+
+//! 接触を三角形上の最近点の順に並べたもの (三角形番号はBVHごとに異なるため座標で比べる)
+using ContactKey = std::tuple<f32, f32, f32, f32>;
+
+std::vector<ContactKey> sortedContacts(const std::vector<CollisionMeshBVH::TriangleContact>& contacts) {
+    std::vector<ContactKey> keys;
+    for(auto& c: contacts)
+        keys.emplace_back(c.triangle_point_.x, c.triangle_point_.y, c.triangle_point_.z, c.distance_sq_);
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+//! 2つの接触の一覧が誤差の範囲で一致するか
+bool sameContacts(const std::vector<ContactKey>& a, const std::vector<ContactKey>& b) {
+    if(a.size() != b.size())
+        return false;
+
+    for(size_t i = 0; i < a.size(); ++i) {
+        auto [ax, ay, az, ad] = a[i];
+        auto [bx, by, bz, bd] = b[i];
+        if(std::abs(ax - bx) > 1e-3f || std::abs(ay - by) > 1e-3f || std::abs(az - bz) > 1e-3f || std::abs(ad - bd) > 1e-3f)
+            return false;
+    }
+    return true;
+}
+
+//! 回転と非一様スケールを含むワールド行列
+matrix skewedWorld() {
+    return mul(mul(matrix::scale(float3(2.0f, 0.5f, 3.0f)), mul(matrix::rotateX(0.3f), matrix::rotateY(0.7f))),
+               matrix::translate(float3(5.0f, -2.0f, 1.0f)));
+}
+
+}    // namespace
+
+//---------------------------------------------------------------------------
+//! 回転/非一様スケールのワールド行列で掃引しても、変換済みの頂点で問い合わせた結果と一致する
+//---------------------------------------------------------------------------
+TEST_CASE("CollisionMeshBVH/ワールド行列での掃引") {
+    const Mesh   ground = makeGround();
+    const matrix world  = skewedWorld();
+
+    Built local(ground);
+    Built baked(transformMesh(ground, world));
+    REQUIRE(local.bvh_.isValid());
+    REQUIRE(baked.bvh_.isValid());
+
+    u32 sphere_hits  = 0;
+    u32 capsule_hits = 0;
+    for(u32 i = 0; i < 16; ++i) {
+        f32    angle = static_cast<f32>(i) * 0.4f;
+        float3 from  = float3(5.0f + std::cos(angle) * 8.0f, 3.0f, 1.0f + std::sin(angle) * 8.0f);
+        float3 to    = from + float3(std::sin(angle) * 2.0f, -6.0f, 1.0f);
+        f32    r     = 0.3f + static_cast<f32>(i % 4) * 0.2f;
+
+        // 球の掃引
+        {
+            std::vector<CollisionMeshBVH::TriangleContact> a;
+            std::vector<CollisionMeshBVH::TriangleContact> b;
+            u32 count = local.bvh_.sweepSphere(world, from, to, r, &a);
+            baked.bvh_.sweepSphere(matrix::identity(), from, to, r, &b);
+
+            CHECK(count == a.size());
+            CHECK(sameContacts(sortedContacts(a), sortedContacts(b)));
+            for(auto& c: a)
+                CHECK(c.distance_sq_ <= r * r);
+            sphere_hits += count;
+        }
+
+        // カプセルの掃引 (横向きのカプセルを移動量だけ動かす)
+        {
+            float3 p0   = from;
+            float3 p1   = from + float3(1.5f, 0.5f, -1.0f);
+            float3 move = to - from;
+
+            std::vector<CollisionMeshBVH::TriangleContact> a;
+            std::vector<CollisionMeshBVH::TriangleContact> b;
+            u32 count = local.bvh_.sweepCapsule(world, p0, p1, move, r, &a);
+            baked.bvh_.sweepCapsule(matrix::identity(), p0, p1, move, r, &b);
+
+            CHECK(count == a.size());
+            CHECK(sameContacts(sortedContacts(a), sortedContacts(b)));
+            for(auto& c: a)
+                CHECK(c.distance_sq_ <= r * r);
+            capsule_hits += count;
+        }
+    }
+
+    // 地面を突き抜ける掃引なので接触がある (一致の確認が空どうしの比較にならない)
+    CHECK(sphere_hits > 0);
+    CHECK(capsule_hits > sphere_hits);
+
+    // 地面から離れた掃引は何も返さない
+    std::vector<CollisionMeshBVH::TriangleContact> none;
+    CHECK(local.bvh_.sweepSphere(world, float3(5.0f, 40.0f, 1.0f), float3(6.0f, 45.0f, 1.0f), 1.0f, &none) == 0);
+    CHECK(local.bvh_.sweepCapsule(world, float3(5.0f, 40.0f, 1.0f), float3(7.0f, 40.0f, 1.0f), float3(0.0f, 3.0f, 0.0f),
+                                  1.0f, &none) == 0);
+    CHECK(none.empty());
+}
+
+//---------------------------------------------------------------------------
+//! 壊れた配列は検証で弾かれる
+//---------------------------------------------------------------------------
+TEST_CASE("CollisionMeshBVH/検証") {
+    Built built(makeGround());
+    auto& vertices = built.mesh_.vertices_;
+    auto  nodes    = built.source_.nodes_;
+    auto  indices  = built.source_.indices_;
+
+    REQUIRE(nodes.size() > 1);
+    REQUIRE(nodes[0].count_ == 0);
+    CHECK(CollisionMeshBVH::validate(vertices.size(), nodes, indices));
+    CHECK(CollisionMeshBVH::validate(vertices.size(), {}, {}));
+
+    const u32 triangle_count = static_cast<u32>(indices.size() / 3);
+
+    // 右の子が範囲外
+    auto broken = nodes;
+    broken[0].offset_ = static_cast<u32>(nodes.size());
+    CHECK(!CollisionMeshBVH::validate(vertices.size(), broken, indices));
+
+    // 右の子が親より前 (循環)
+    broken            = nodes;
+    broken[0].offset_ = 0;
+    CHECK(!CollisionMeshBVH::validate(vertices.size(), broken, indices));
+
+    // 葉の三角形の範囲が範囲外
+    broken            = nodes;
+    broken[0].offset_ = triangle_count - 1;
+    broken[0].count_  = 2;
+    CHECK(!CollisionMeshBVH::validate(vertices.size(), broken, indices));
+
+    // 頂点番号が範囲外
+    auto broken_indices = indices;
+    broken_indices[4]   = static_cast<u32>(vertices.size());
+    CHECK(!CollisionMeshBVH::validate(vertices.size(), nodes, broken_indices));
+
+    // 三角形の途中で切れている
+    broken_indices = indices;
+    broken_indices.pop_back();
+    CHECK(!CollisionMeshBVH::validate(vertices.size(), nodes, broken_indices));
+}
@@ -0,0 +1,234 @@
+﻿//---------------------------------------------------------------------------
+//! @file   CollisionShapeCacheBench.cpp
+//! @brief  コリジョン形状キャッシュのベンチマーク (SIMDバッチ判定と1組ずつの判定の比較)
+//---------------------------------------------------------------------------
+#include "Test.h"
+
+#include <System/CollisionShapeCache.h>
+
+namespace {
+
+constexpr u32 COLLIDER_COUNT = 2048;    //!< カプセル数
+constexpr f32 AREA_SIZE      = 60.0f;   //!< 配置範囲
+constexpr f32 BROAD_DISTANCE = 4.0f;    //!< 候補にする中心間の距離 (ブロードフェーズの代わり)
+constexpr u32 REPEAT         = 20;      //!< 計測回数
+
+//! カプセルコリジョン (ComponentCollisionCapsule と同じパラメーター)
+struct Capsule {
+    matrix world_;     //!< オブジェクトのワールド行列 (ComponentTransform)
+    float3 offset_;    //!< コリジョンの位置 (GetTranslate)
+    float3 axis_y_;    //!< コリジョンの上方向 (GetVectorAxisY)
+    f32    height_;    //!< 高さ
+    f32    radius_;    //!< 半径
+};
+
+//! 当たり情報 (ComponentCollision::HitInfo の押し戻し部分)
+struct Hit {
+    u32    self_;
+    u32    other_;
+    float3 push_;
+};
+
+//---------------------------------------------------------------------------
+//! 回転と拡大縮小を含むカプセルを配置
+//---------------------------------------------------------------------------
+std::vector<Capsule> makeCapsules() {
+    std::vector<Capsule> capsules(COLLIDER_COUNT);
+
+    u32 seed = 4321;
+    for(auto& capsule: capsules) {
+        f32 scale = 0.8f + test::random(seed) * 0.4f;
+        capsule.world_ = mul(mul(matrix::scale(scale), matrix::rotateY(test::random(seed) * TAU)),
+                             matrix::translate(float3(test::random(seed) * AREA_SIZE, test::random(seed) * 2.0f,
+                                                      test::random(seed) * AREA_SIZE)));
+        capsule.offset_ = float3(0.0f, 0.1f, 0.0f);
+        capsule.axis_y_ = float3(test::random(seed) - 0.5f, 1.0f, test::random(seed) - 0.5f);
+        capsule.height_ = 1.0f + test::random(seed);
+        capsule.radius_ = 0.3f + test::random(seed) * 0.4f;
+    }
+    return capsules;
+}
+
+//---------------------------------------------------------------------------
+//! ワールド空間の線分と半径を求める
+//! (ComponentCollision::isHit(capsule, capsule) と GetWorldShape() の ComponentTransform の場合と同じ計算)
+//---------------------------------------------------------------------------
+CollisionShape worldShape(const Capsule& capsule) {
+    float3 pos1 = capsule.offset_;
+    float3 pos2 = normalize(capsule.axis_y_) * capsule.height_ + pos1;
+
+    // 高さに回転とスケールを掛け合わせる
+    auto& mtx = capsule.world_;
+    pos1      = mul(float4(pos1, 1), mtx).xyz;
+    pos2      = mul(float4(pos2, 1), mtx).xyz;
+
+    // 半径はXZで平均としておく
+    f32 scale = (length(mtx.axisX()) + length(mtx.axisZ())) / 2;
+
+    f32    radius = capsule.radius_ * scale;
+    float3 vec    = normalize(pos1 - pos2);
+
+    CollisionShape shape;
+    shape.type_   = CollisionShape::Type::Capsule;
+    shape.p0_     = pos1 - vec * radius;
+    shape.p1_     = pos2 + vec * radius;
+    shape.radius_ = radius;
+    return shape;
+}
+
+//---------------------------------------------------------------------------
+//! 線分どうしの最近点 (1組ずつ分岐で求める)
+//! ゲーム本体の DxLib::Segment_Segment_Analyse の代わり
+//---------------------------------------------------------------------------
+f32 closestSegmentSegment(const float3& p1, const float3& q1, const float3& p2, const float3& q2, float3* c1, float3* c2) {
+    float3 d1 = q1 - p1;
+    float3 d2 = q2 - p2;
+    float3 r  = p1 - p2;
+    f32    a  = dot(d1, d1);
+    f32    e  = dot(d2, d2);
+    f32    f  = dot(d2, r);
+    f32    s  = 0.0f;
+    f32    t  = 0.0f;
+
+    if(a <= 1e-6f && e <= 1e-6f) {
+        s = t = 0.0f;
+    } else if(a <= 1e-6f) {
+        t = std::clamp(f / e, 0.0f, 1.0f);
+    } else {
+        f32 c = dot(d1, r);
+        if(e <= 1e-6f) {
+            s = std::clamp(-c / a, 0.0f, 1.0f);
+        } else {
+            f32 b     = dot(d1, d2);
+            f32 denom = a * e - b * b;
+            s         = denom > 1e-6f ? std::clamp((b * f - c * e) / denom, 0.0f, 1.0f) : 0.0f;
+            t         = (b * s + f) / e;
+            if(t < 0.0f) {
+                t = 0.0f;
+                s = std::clamp(-c / a, 0.0f, 1.0f);
+            } else if(t > 1.0f) {
+                t = 1.0f;
+                s = std::clamp((b - c) / a, 0.0f, 1.0f);
+            }
+        }
+    }
+
+    *c1 = p1 + d1 * s;
+    *c2 = p2 + d2 * t;
+    return dot(*c1 - *c2, *c1 - *c2);
+}
+
+//! 押し戻し (自分の最近点 c0、相手の最近点 e0)
+float3 pushBack(const float3& c0, const float3& e0, f32 radius) {
+    float3 vec = c0 - e0;
+    f32    len = length(vec);
+    if(len <= FLT_EPSILON)
+        vec = {0, 0, 1};
+    return normalize(vec) * (radius - len);
+}
+
+//---------------------------------------------------------------------------
+//! 1組ずつの判定 (キャッシュ導入前の isHit(capsule, capsule) と同じ手順)
+//! 組ごとに両方のワールド形状を求めなおす
+//---------------------------------------------------------------------------
+void overlapScalar(const std::vector<Capsule>&                capsules,
+                   const std::vector<std::pair<u32, u32>>& pairs,
+                   std::vector<Hit>&                       hits) {
+    hits.clear();
+    for(auto [self, other]: pairs) {
+        auto c = worldShape(capsules[self]);
+        auto e = worldShape(capsules[other]);
+
+        float3 c0;
+        float3 e0;
+        f32    distance_sq = closestSegmentSegment(c.p0_, c.p1_, e.p0_, e.p1_, &c0, &e0);
+        f32    radius      = c.radius_ + e.radius_;
+        if(distance_sq < radius * radius)
+            hits.push_back({self, other, pushBack(c0, e0, radius)});
+    }
+}
+
+//---------------------------------------------------------------------------
+//! キャッシュを使った判定 (ワールド形状を1回だけ求めて4候補ずつ判定)
+//! @param  [in]    update_cache    ワールド形状の更新も計測に含めるか
+//---------------------------------------------------------------------------
+void overlapCached(const std::vector<Capsule>&                capsules,
+                   const std::vector<std::pair<u32, u32>>& pairs,
+                   CollisionShapeCache&                    cache,
+                   bool                                    update_cache,
+                   std::vector<Hit>&                       hits) {
+    if(update_cache) {
+        cache.resize(capsules.size());
+        for(u32 i = 0; i < capsules.size(); ++i)
+            cache.set(i, worldShape(capsules[i]));
+    }
+
+    hits.clear();
+
+    std::vector<u32>                          candidates;
+    std::vector<CollisionShapeCache::Contact> contacts;
+    for(size_t begin = 0; begin < pairs.size();) {
+        // 同じコリジョンの連続した候補をまとめる
+        u32    self = pairs[begin].first;
+        size_t end  = begin;
+        candidates.clear();
+        while(end < pairs.size() && pairs[end].first == self)
+            candidates.push_back(pairs[end++].second);
+
+        contacts.resize(candidates.size());
+        u32 count = cache.overlapBatch(self, candidates.data(), static_cast<u32>(candidates.size()), contacts.data());
+
+        // 当たった候補だけ当たり情報を作成
+        for(u32 i = 0; i < count; ++i) {
+            u32    other = candidates[contacts[i].index_];
+            float3 c0;
+            float3 e0;
+            cache.closestPoints(self, other, contacts[i], &c0, &e0);
+            hits.push_back({self, other, pushBack(c0, e0, cache.get(self).radius_ + cache.get(other).radius_)});
+        }
+        begin = end;
+    }
+}
+
+}    // namespace
+
+//---------------------------------------------------------------------------
+//! カプセル2048個の当たり判定 (1組ずつ/キャッシュ+SIMD)
+//---------------------------------------------------------------------------
+BENCHMARK("CollisionShapeCache/カプセル2048個") {
+    auto capsules = makeCapsules();
+
+    // 候補の組 (自分ごとに連続して並べる。ゲーム側の候補収集と同じ並び)
+    std::vector<std::pair<u32, u32>> pairs;
+    for(u32 i = 0; i < COLLIDER_COUNT; ++i) {
+        float3 a = capsules[i].world_.translate();
+        for(u32 j = i + 1; j < COLLIDER_COUNT; ++j) {
+            float3 b = capsules[j].world_.translate();
+            if(static_cast<f32>(length(a - b)) < BROAD_DISTANCE)
+                pairs.push_back({i, j});
+        }
+    }
+
+    std::vector<Hit>    scalar_hits;
+    std::vector<Hit>    cached_hits;
+    CollisionShapeCache cache;
+
+    test::report("per-pair scalar", test::measure(REPEAT, [&]() { overlapScalar(capsules, pairs, scalar_hits); }));
+    test::report("cache update + SIMD batch",
+                 test::measure(REPEAT, [&]() { overlapCached(capsules, pairs, cache, true, cached_hits); }));
+    test::report("SIMD batch only", test::measure(REPEAT, [&]() { overlapCached(capsules, pairs, cache, false, cached_hits); }));
+
+    std::printf("  pairs: %zu  hits: scalar %zu / cached %zu\n", pairs.size(), scalar_hits.size(), cached_hits.size());
+
+    // 同じ組が当たり、押し戻しも一致する
+    REQUIRE(scalar_hits.size() == cached_hits.size());
+    u32 mismatch = 0;
+    for(size_t i = 0; i < scalar_hits.size(); ++i) {
+        auto& a = scalar_hits[i];
+        auto& b = cached_hits[i];
+        if(a.self_ != b.self_ || a.other_ != b.other_ || static_cast<f32>(length(a.push_ - b.push_)) > 1e-3f)
+            mismatch++;
+    }
+    CHECK(mismatch == 0);
+    CHECK(!scalar_hits.empty());
+}
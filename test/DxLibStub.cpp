@@ -0,0 +1,38 @@
+﻿//---------------------------------------------------------------------------
+//! @file   DxLibStub.cpp
+//! @brief  テスト用のDxLib関数 (何もしません)
+//---------------------------------------------------------------------------
+
+namespace DxLib {
+
+int DeleteVertexBuffer([[maybe_unused]] int vert_buf_handle) {
+    return 0;
+}
+
+int DeleteIndexBuffer([[maybe_unused]] int index_buf_handle) {
+    return 0;
+}
+
+unsigned int GetColor([[maybe_unused]] int red, [[maybe_unused]] int green, [[maybe_unused]] int blue) {
+    return 0;
+}
+
+int SetUseLighting([[maybe_unused]] int flag) {
+    return 0;
+}
+
+int SetUseZBuffer3D([[maybe_unused]] int flag) {
+    return 0;
+}
+
+int DrawLine3D([[maybe_unused]] VECTOR pos1, [[maybe_unused]] VECTOR pos2, [[maybe_unused]] unsigned int color) {
+    return 0;
+}
+
+int DrawSphere3D([[maybe_unused]] VECTOR center_pos, [[maybe_unused]] float r, [[maybe_unused]] int div_num,
+                 [[maybe_unused]] unsigned int dif_color, [[maybe_unused]] unsigned int spc_color,
+                 [[maybe_unused]] int fill_flag) {
+    return 0;
+}
+
+}    // namespace DxLib
@@ -0,0 +1,217 @@
+﻿//---------------------------------------------------------------------------
+//! @file   FrustumTest.cpp
+//! @brief  視錐台の単体テスト (平面の抽出と球/AABBの判定)
+//---------------------------------------------------------------------------
+#include "Test.h"
+
+#include <System/Graphics/Frustum.h>
+
+namespace {
+
+constexpr f32 Z_NEAR = 1.0f;      //!< 近クリップ距離
+constexpr f32 Z_FAR  = 100.0f;    //!< 遠クリップ距離
+
+//---------------------------------------------------------------------------
+//! 原点から+Z方向を向いた画角90度/アスペクト比1の視錐台
+//! (平面の法線が45度になり期待値を手で計算できる)
+//---------------------------------------------------------------------------
+Frustum makeFrustum(Frustum::DepthMode mode) {
+    Frustum frustum;
+    frustum.setPosition(float3(0.0f, 0.0f, 0.0f))
+        .setLookAt(float3(0.0f, 0.0f, 1.0f))
+        .setFov(90.0f * DegToRad)
+        .setAspectRatio(1.0f)
+        .setNearZ(Z_NEAR)
+        .setFarZ(Z_FAR)
+        .setDepthMode(mode);
+    frustum.update();
+    return frustum;
+}
+
+//! 平面が期待値と一致するか (距離は大きさに対する相対誤差)
+bool equalPlane(const float4& plane, const float4& expect) {
+    f32 w = expect.w;
+    return static_cast<f32>(length(plane.xyz - expect.xyz)) < 1e-4f &&
+           std::abs(static_cast<f32>(plane.w) - w) < 1e-4f * std::max(1.0f, std::abs(w));
+}
+
+//! クリップ座標で視錐台の内側かどうか (平面を使わない基準の判定)
+bool isInsideClip(const Frustum& frustum, const float3& position) {
+    float4 clip = mul(float4(position, 1.0f), frustum.matViewProj());
+
+    f32 x = clip.x;
+    f32 y = clip.y;
+    f32 z = clip.z;
+    f32 w = clip.w;
+    if(w <= 0.0f || x < -w || x > w || y < -w || y > w)
+        return false;
+
+    // 反転Zの場合は深度範囲 0～w の向きが逆になるだけで同じ範囲
+    return z >= 0.0f && z <= w;
+}
+
+//! 固定値の擬似乱数 (-1～1)
+f32 randomSigned(u32& seed) {
+    return test::random(seed) * 2.0f - 1.0f;
+}
+
+}    // namespace
+
+//---------------------------------------------------------------------------
+//! ビュー投影行列から内側を向いた正規化済の平面が得られる
+//---------------------------------------------------------------------------
+TEST_CASE("Frustum/平面の抽出") {
+    const f32 s = std::sqrt(0.5f);
+
+    // 左/右/下/上/近/遠
+    const float4 expect[6] = {
+        float4(s, 0.0f, s, 0.0f),          float4(-s, 0.0f, s, 0.0f),        float4(0.0f, s, s, 0.0f),
+        float4(0.0f, -s, s, 0.0f),         float4(0.0f, 0.0f, 1.0f, -Z_NEAR), float4(0.0f, 0.0f, -1.0f, Z_FAR),
+    };
+
+    for(auto mode: {Frustum::DepthMode::Default, Frustum::DepthMode::Reverse}) {
+        auto frustum = makeFrustum(mode);
+        for(u32 i = 0; i < 6; ++i) {
+            auto& plane = frustum.planes()[i];
+            if(!equalPlane(plane, expect[i]))
+                std::printf("  mode %d plane %u: (%f %f %f %f)\n", static_cast<s32>(mode), i, static_cast<f32>(plane.x),
+                            static_cast<f32>(plane.y), static_cast<f32>(plane.z), static_cast<f32>(plane.w));
+            CHECK(equalPlane(plane, expect[i]));
+        }
+    }
+
+    // 無限遠の遠平面は常に内側
+    {
+        auto frustum = makeFrustum(Frustum::DepthMode::ReverseInfinite);
+        for(u32 i = 0; i < 5; ++i)
+            CHECK(equalPlane(frustum.planes()[i], expect[i]));
+        CHECK(equalPlane(frustum.planes()[5], float4(0.0f, 0.0f, 0.0f, 1.0f)));
+        CHECK(frustum.isVisible(float3(0.0f, 0.0f, 1e6f), 1.0f));
+    }
+}
+
+//---------------------------------------------------------------------------
+//! 任意の姿勢のカメラでも平面の判定とクリップ座標の判定が一致する
+//---------------------------------------------------------------------------
+TEST_CASE("Frustum/クリップ座標との一致") {
+    u32 seed = 2024;
+
+    for(auto mode: {Frustum::DepthMode::Default, Frustum::DepthMode::Reverse}) {
+        Frustum frustum;
+        frustum.setPosition(float3(3.0f, 2.0f, -5.0f))
+            .setLookAt(float3(-1.0f, 0.5f, 4.0f))
+            .setFov(60.0f * DegToRad)
+            .setAspectRatio(16.0f / 9.0f)
+            .setNearZ(0.5f)
+            .setFarZ(50.0f)
+            .setDepthMode(mode);
+        frustum.update();
+
+        u32 mismatch = 0;
+        u32 inside   = 0;
+        for(u32 i = 0; i < 10000; ++i) {
+            float3 p = frustum.position() + float3(randomSigned(seed), randomSigned(seed), randomSigned(seed)) * 60.0f;
+
+            // 平面上の点は誤差でどちらにもなり得るので除く
+            f32 nearest = FLT_MAX;
+            for(auto& plane: frustum.planes())
+                nearest = std::min(nearest, std::abs(static_cast<f32>(dot(plane.xyz, p) + plane.w)));
+            if(nearest < 1e-3f)
+                continue;
+
+            bool clip = isInsideClip(frustum, p);
+            if(frustum.isVisible(p, 0.0f) != clip)
+                mismatch++;
+            if(clip)
+                inside++;
+        }
+        CHECK(mismatch == 0);
+        CHECK(inside > 0);    // 内側の点も判定されている
+    }
+}
+
+//---------------------------------------------------------------------------
+//! 球の判定 (内側/外側/平面をまたぐ)
+//---------------------------------------------------------------------------
+TEST_CASE("Frustum/球") {
+    auto frustum = makeFrustum(Frustum::DepthMode::Default);
+
+    // 内側
+    CHECK(frustum.isVisible(float3(0.0f, 0.0f, 50.0f), 1.0f));
+    CHECK(frustum.isVisible(float3(8.0f, -8.0f, 10.0f), 0.5f));
+
+    // 外側
+    CHECK(!frustum.isVisible(float3(0.0f, 0.0f, -10.0f), 1.0f));     // 背後
+    CHECK(!frustum.isVisible(float3(-100.0f, 0.0f, 10.0f), 1.0f));   // 左
+    CHECK(!frustum.isVisible(float3(0.0f, 100.0f, 10.0f), 1.0f));    // 上
+    CHECK(!frustum.isVisible(float3(0.0f, 0.0f, 0.5f), 0.1f));       // 近クリップより手前
+    CHECK(!frustum.isVisible(float3(0.0f, 0.0f, 101.0f), 0.5f));     // 遠クリップより奥
+
+    // 平面をまたぐ (中心は外側で半径が平面に届く)
+    // 左平面までの距離は (x + z) * √0.5 = -0.5 * √0.5 ≒ -0.354
+    CHECK(frustum.isVisible(float3(-10.5f, 0.0f, 10.0f), 1.0f));
+    CHECK(!frustum.isVisible(float3(-10.5f, 0.0f, 10.0f), 0.3f));
+    CHECK(frustum.isVisible(float3(0.0f, 0.0f, 0.5f), 0.6f));
+    CHECK(frustum.isVisible(float3(0.0f, 0.0f, 101.0f), 2.0f));
+
+    // カメラを包む球
+    CHECK(frustum.isVisible(float3(0.0f, 0.0f, 0.0f), 5.0f));
+}
+
+//---------------------------------------------------------------------------
+//! AABBの判定 (内側/外側/平面をまたぐ)
+//---------------------------------------------------------------------------
+TEST_CASE("Frustum/AABB") {
+    auto frustum = makeFrustum(Frustum::DepthMode::Default);
+
+    auto visible = [&](const float3& center, const float3& extent) {
+        return frustum.isVisibleAabb(center - extent, center + extent);
+    };
+
+    // 内側
+    CHECK(visible(float3(0.0f, 0.0f, 50.0f), float3(1.0f, 1.0f, 1.0f)));
+
+    // 外側
+    CHECK(!visible(float3(0.0f, 0.0f, -10.0f), float3(1.0f, 1.0f, 1.0f)));
+    CHECK(!visible(float3(-100.0f, 0.0f, 10.0f), float3(1.0f, 1.0f, 1.0f)));
+    CHECK(!visible(float3(0.0f, 0.0f, 110.0f), float3(1.0f, 1.0f, 5.0f)));
+
+    // 平面をまたぐ
+    // 左平面まで中心は -0.354、角 (+0.5, 0, +0.5) までの投影半径は 0.5 * √2 ≒ 0.707
+    CHECK(visible(float3(-10.5f, 0.0f, 10.0f), float3(0.5f, 0.5f, 0.5f)));
+    CHECK(!visible(float3(-10.5f, 0.0f, 10.0f), float3(0.2f, 0.2f, 0.2f)));
+    CHECK(visible(float3(0.0f, 0.0f, 100.0f), float3(1.0f, 1.0f, 1.0f)));
+
+    // 視錐台全体を覆う大きな箱
+    CHECK(visible(float3(0.0f, 0.0f, 0.0f), float3(500.0f, 500.0f, 500.0f)));
+
+    // 薄い箱 (大きさ0の軸)
+    CHECK(visible(float3(0.0f, 0.0f, 20.0f), float3(30.0f, 0.0f, 0.0f)));
+    CHECK(!visible(float3(0.0f, 30.0f, 20.0f), float3(30.0f, 0.0f, 0.0f)));
+}
+
+//---------------------------------------------------------------------------
+//! 見える物を消さない (球/AABBとも内側の点を含むものは必ず見える)
+//---------------------------------------------------------------------------
+TEST_CASE("Frustum/保守的な判定") {
+    auto frustum = makeFrustum(Frustum::DepthMode::Reverse);
+
+    u32 seed  = 7;
+    u32 wrong = 0;
+    for(u32 i = 0; i < 10000; ++i) {
+        float3 center = float3(randomSigned(seed) * 120.0f, randomSigned(seed) * 120.0f, randomSigned(seed) * 120.0f);
+        f32    radius = (randomSigned(seed) + 1.0f) * 5.0f;
+
+        bool sphere = frustum.isVisible(center, radius);
+        bool aabb   = frustum.isVisibleAabb(center - radius, center + radius);
+
+        // 中心が内側なら見える
+        if(isInsideClip(frustum, center) && (!sphere || !aabb))
+            wrong++;
+
+        // 球を包むAABBは球が見えるなら見える
+        if(sphere && !aabb)
+            wrong++;
+    }
+    CHECK(wrong == 0);
+}
@@ -0,0 +1,86 @@
+﻿//---------------------------------------------------------------------------
+//! @file   JobSchedulerBench.cpp
+//! @brief  ジョブスケジューラーのベンチマーク
+//---------------------------------------------------------------------------
+#include "Test.h"
+
+#include <System/JobScheduler.h>
+
+#include <atomic>
+
+namespace {
+
+constexpr u32 JOB_COUNT = 10000;    //!< ジョブ数
+constexpr u32 REPEAT    = 20;       //!< 計測回数
+
+//! 小さなジョブ1つ分の処理 (最適化で消えないよう結果を書き出す)
+void work(f32* out, u32 index) {
+    f32 v = static_cast<f32>(index);
+    for(u32 i = 0; i < 64; ++i)
+        v = v * 0.999f + 1.0f;
+    out[index] = v;
+}
+
+}    // namespace
+
+//---------------------------------------------------------------------------
+//! 小さなジョブ10000件 (直列/並列/単純ループ)
+//---------------------------------------------------------------------------
+BENCHMARK("JobGroup/10000ジョブ") {
+    std::vector<f32> out(JOB_COUNT);
+
+    std::printf("  workers: %u\n", JobGroup::workerCount());
+
+    // 基準: 単純ループ
+    f32 loop_ms = test::measure(REPEAT, [&]() {
+        for(u32 i = 0; i < JOB_COUNT; ++i)
+            work(out.data(), i);
+    });
+    test::report("loop", loop_ms);
+
+    // 宣言なし (すべて直列)
+    {
+        JobGroup group(JOB_COUNT);
+        for(u32 i = 0; i < JOB_COUNT; ++i)
+            group.registerJob(Priority(0), [&out, i]() { work(out.data(), i); });
+        group.execute();    // 並べ替えを計測から除く
+
+        test::report("JobGroup serial", test::measure(REPEAT, [&]() { group.execute(); }));
+    }
+
+    // 競合なし (1段で並列)
+    {
+        JobGroup group(JOB_COUNT);
+        for(u32 i = 0; i < JOB_COUNT; ++i)
+            group.registerJob(Priority(0), [&out, i]() { work(out.data(), i); }, JobAccess(0, 0));
+        group.execute();
+
+        test::report("JobGroup parallel", test::measure(REPEAT, [&]() { group.execute(); }));
+        test::report("JobGroup parallel (executeTime)", group.executeTime());
+    }
+
+    // 優先順位を100種類に分割 (100段)
+    {
+        JobGroup group(JOB_COUNT);
+        for(u32 i = 0; i < JOB_COUNT; ++i)
+            group.registerJob(Priority(i % 100), [&out, i]() { work(out.data(), i); }, JobAccess(0, 0));
+        group.execute();
+
+        test::report("JobGroup 100 priorities", test::measure(REPEAT, [&]() { group.execute(); }));
+    }
+
+    // 登録状況の変更による並べ替え
+    {
+        JobGroup group(JOB_COUNT);
+        std::vector<JobHandle> handles;
+        for(u32 i = 0; i < JOB_COUNT; ++i)
+            handles.push_back(group.registerJob(Priority(i % 100), [&out, i]() { work(out.data(), i); }, JobAccess(1ull << (i % 64), 0)));
+
+        f32 ms = test::measure(REPEAT, [&]() {
+            group.unregisterJob(handles.back());
+            handles.back() = group.registerJob(Priority(0), []() {}, JobAccess(0, 0));
+            group.execute();
+        });
+        test::report("JobGroup rebuild + execute", ms);
+    }
+}
@@ -0,0 +1,229 @@
+﻿//---------------------------------------------------------------------------
+//! @file   JobSchedulerTest.cpp
+//! @brief  ジョブスケジューラーの単体テスト
+//---------------------------------------------------------------------------
+#include "Test.h"
+
+#include <System/JobScheduler.h>
+#include <System/JobWorkerPool.h>
+
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+//---------------------------------------------------------------------------
+//! 直列ジョブは優先順位順・同じ優先は登録順に実行される
+//---------------------------------------------------------------------------
+TEST_CASE("JobGroup/実行順") {
+    JobGroup group(16);
+
+    std::vector<int> order;
+    group.registerJob(Priority(2), [&]() { order.push_back(3); });
+    group.registerJob(Priority(1), [&]() { order.push_back(1); });
+    group.registerJob(Priority(1), [&]() { order.push_back(2); });
+    group.registerJob(Priority(2, 1), [&]() { order.push_back(4); });
+
+    group.execute();
+
+    REQUIRE(order.size() == 4);
+    CHECK(order[0] == 1);
+    CHECK(order[1] == 2);
+    CHECK(order[2] == 3);
+    CHECK(order[3] == 4);
+    CHECK(group.jobCount() == 4);
+}
+
+//---------------------------------------------------------------------------
+//! 書き込みが重ならないジョブは同じ実行段にまとまる
+//---------------------------------------------------------------------------
+TEST_CASE("JobGroup/実行段") {
+    constexpr u64 A = 1ull << 0;
+    constexpr u64 B = 1ull << 1;
+    constexpr u64 C = 1ull << 2;
+
+    JobGroup group(16);
+
+    // 段0: A書き / B書き (競合なし)
+    // 段1: A読み C書き (A書きの後)
+    // 段2: C読み (C書きの後)
+    std::atomic<u32> stage = 0;
+    std::atomic<u32> error = 0;
+    group.registerJob(Priority(0), [&]() { stage |= 1; }, JobAccess(0, A));
+    group.registerJob(Priority(0), [&]() { stage |= 2; }, JobAccess(0, B));
+    group.registerJob(
+        Priority(0),
+        [&]() {
+            if((stage & 1) == 0)
+                error++;
+            stage |= 4;
+        },
+        JobAccess(A, C));
+    group.registerJob(
+        Priority(0),
+        [&]() {
+            if((stage & 4) == 0)
+                error++;
+        },
+        JobAccess(C, 0));
+
+    group.execute();
+
+    CHECK(group.waveCount() == 3);
+    CHECK(stage == 7);
+    CHECK(error == 0);
+}
+
+//---------------------------------------------------------------------------
+//! 宣言を省略したジョブは直列に実行される
+//---------------------------------------------------------------------------
+TEST_CASE("JobGroup/既定は直列") {
+    JobGroup group(16);
+    for(int i = 0; i < 4; ++i)
+        group.registerJob(Priority(0), []() {});
+
+    group.execute();
+    CHECK(group.waveCount() == 4);
+}
+
+//---------------------------------------------------------------------------
+//! 無効化/登録解除したジョブは実行されない
+//---------------------------------------------------------------------------
+TEST_CASE("JobGroup/無効化と登録解除") {
+    JobGroup group(16);
+
+    int  a  = 0;
+    int  b  = 0;
+    auto ha = group.registerJob(Priority(0), [&]() { a++; });
+    auto hb = group.registerJob(Priority(0), [&]() { b++; });
+
+    group.disableJob(ha);
+    group.execute();
+    CHECK(a == 0);
+    CHECK(b == 1);
+
+    group.enableJob(ha);
+    group.unregisterJob(hb);
+    group.execute();
+    CHECK(a == 1);
+    CHECK(b == 1);
+    CHECK(group.jobCount() == 1);
+
+    // 解放したスロットは再利用できる
+    auto hc = group.registerJob(Priority(0), [&]() { b += 10; });
+    group.execute();
+    CHECK(b == 11);
+    group.unregisterJob(hc);
+    group.unregisterJob(ha);
+    CHECK(group.jobCount() == 0);
+}
+
+//---------------------------------------------------------------------------
+//! 並列ジョブはすべて1回ずつ実行される
+//---------------------------------------------------------------------------
+TEST_CASE("JobGroup/並列実行") {
+    constexpr u32 count = 1000;
+
+    JobGroup group(count);
+
+    std::vector<std::atomic<u32>> hits(count);
+    for(u32 i = 0; i < count; ++i)
+        group.registerJob(Priority(0), [&hits, i]() { hits[i]++; }, JobAccess(0, 0));
+
+    for(int frame = 0; frame < 10; ++frame)
+        group.execute();
+
+    CHECK(group.waveCount() == 1);
+
+    u32 wrong = 0;
+    for(auto& hit: hits) {
+        if(hit != 10)
+            wrong++;
+    }
+    CHECK(wrong == 0);
+    CHECK(group.executeTime() >= 0.0f);
+}
+
+//---------------------------------------------------------------------------
+//! バックグラウンドジョブは呼び出し元以外のスレッドで実行される
+//---------------------------------------------------------------------------
+TEST_CASE("runJobAsync/ワーカーで実行") {
+    std::atomic<bool> done = false;
+    std::thread::id   caller = std::this_thread::get_id();
+    std::thread::id   worker;
+    std::mutex        mutex;
+
+    runJobAsync([&]() {
+        std::lock_guard lock(mutex);
+        worker = std::this_thread::get_id();
+        done   = true;
+    });
+
+    auto limit = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while(!done && std::chrono::steady_clock::now() < limit)
+        std::this_thread::yield();
+
+    REQUIRE(done);
+    std::lock_guard lock(mutex);
+    CHECK(worker != caller);
+}
+
+//---------------------------------------------------------------------------
+//! ワーカー数を指定したプールでも全件実行される
+//---------------------------------------------------------------------------
+TEST_CASE("JobWorkerPool/ワーカー数指定") {
+    for(u32 workers: {1u, 2u, 7u}) {
+        JobWorkerPool pool(workers);
+        CHECK(pool.workerCount() == workers);
+
+        std::atomic<u32>                   sum = 0;
+        std::vector<std::function<void()>> funcs;
+        for(u32 i = 1; i <= 100; ++i)
+            funcs.push_back([&sum, i]() { sum += i; });
+
+        std::vector<const std::function<void()>*> ptrs;
+        for(auto& func: funcs)
+            ptrs.push_back(&func);
+
+        pool.run(ptrs.data(), static_cast<u32>(ptrs.size()));
+        CHECK(sum == 5050);
+    }
+}
+
+//---------------------------------------------------------------------------
+//! 例外が出ても全件の終了を待ってから呼び出し元へ投げなおす
+//---------------------------------------------------------------------------
+TEST_CASE("JobWorkerPool/例外") {
+    JobWorkerPool pool(2);
+
+    // 10件に1件が例外を投げる (ワーカーと呼び出し元のどちらでも起きるように複数)
+    std::atomic<u32>                   sum = 0;
+    std::vector<std::function<void()>> funcs;
+    for(u32 i = 1; i <= 100; ++i) {
+        funcs.push_back([&sum, i]() {
+            if(i % 10 == 0)
+                throw std::runtime_error("job failed");
+            sum += i;
+        });
+    }
+
+    std::vector<const std::function<void()>*> ptrs;
+    for(auto& func: funcs)
+        ptrs.push_back(&func);
+
+    bool caught = false;
+    try {
+        pool.run(ptrs.data(), static_cast<u32>(ptrs.size()));
+    } catch(const std::runtime_error&) {
+        caught = true;
+    }
+    CHECK(caught);
+    CHECK(sum == 5050 - 550);    // 例外を投げなかった関数はすべて実行済み
+
+    // 例外の後もプールはそのまま使える
+    sum = 0;
+    std::function<void()>        add  = [&sum]() { sum += 1; };
+    const std::function<void()>* once = &add;
+    pool.run(&once, 1);
+    CHECK(sum == 1);
+}
@@ -0,0 +1,431 @@
+﻿//---------------------------------------------------------------------------
+//! @file   ModelCacheTest.cpp
+//! @brief  3Dモデルキャッシュの単体テスト (build() と load() の往復)
+//---------------------------------------------------------------------------
+#include "Test.h"
+
+#include <System/Graphics/ModelCache.h>
+
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <tuple>
+
+namespace {
+
+constexpr f32 SPHERE_RADIUS = 2.0f;    //!< 合成メッシュの球の半径
+
+//---------------------------------------------------------------------------
+//! 合成メッシュ (UV球) を作成
+//! @param  [in]    slices  経度方向の分割数
+//! @param  [in]    stacks  緯度方向の分割数
+//---------------------------------------------------------------------------
+ModelCache::SourceMesh makeSphere(u32 slices, u32 stacks) {
+    ModelCache::SourceMesh mesh;
+
+    // 極の頂点
+    mesh.vertices_.push_back({0.0f, SPHERE_RADIUS, 0.0f});
+    mesh.vertices_.push_back({0.0f, -SPHERE_RADIUS, 0.0f});
+
+    // 極を除いた輪の頂点
+    for(u32 stack = 1; stack < stacks; ++stack) {
+        f32 phi = PI * static_cast<f32>(stack) / static_cast<f32>(stacks);
+        for(u32 slice = 0; slice < slices; ++slice) {
+            f32 theta = TAU * static_cast<f32>(slice) / static_cast<f32>(slices);
+            mesh.vertices_.push_back({SPHERE_RADIUS * std::sin(phi) * std::cos(theta), SPHERE_RADIUS * std::cos(phi),
+                                      SPHERE_RADIUS * std::sin(phi) * std::sin(theta)});
+        }
+    }
+
+    auto ring = [&](u32 stack, u32 slice) { return 2 + (stack - 1) * slices + (slice % slices); };
+
+    for(u32 slice = 0; slice < slices; ++slice) {
+        // 上の極
+        mesh.indices_.insert(mesh.indices_.end(), {0u, ring(1, slice + 1), ring(1, slice)});
+
+        // 輪の間
+        for(u32 stack = 1; stack + 1 < stacks; ++stack) {
+            u32 a = ring(stack, slice);
+            u32 b = ring(stack, slice + 1);
+            u32 c = ring(stack + 1, slice);
+            u32 d = ring(stack + 1, slice + 1);
+            mesh.indices_.insert(mesh.indices_.end(), {a, b, c, b, d, c});
+        }
+
+        // 下の極
+        mesh.indices_.insert(mesh.indices_.end(), {1u, ring(stacks - 1, slice), ring(stacks - 1, slice + 1)});
+    }
+    return mesh;
+}
+
+//! 三角形を座標で表したもの (頂点の並べ替えに影響されない比較用)
+using Triangle = std::array<std::tuple<f32, f32, f32>, 3>;
+
+//---------------------------------------------------------------------------
+//! 三角形を座標の列に変換 (回転して最小の頂点を先頭にする。向きは保つ)
+//---------------------------------------------------------------------------
+std::vector<Triangle> triangles(std::span<const VECTOR> vertices, std::span<const u32> indices) {
+    std::vector<Triangle> result;
+    for(size_t i = 0; i + 2 < indices.size(); i += 3) {
+        Triangle t;
+        for(u32 k = 0; k < 3; ++k) {
+            auto& v = vertices[indices[i + k]];
+            t[k]    = {v.x, v.y, v.z};
+        }
+        auto first = std::min_element(t.begin(), t.end());
+        std::rotate(t.begin(), first, t.end());
+        result.push_back(t);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+//! テスト用のモデルパス (キャッシュはテンポラリフォルダに作成される)
+const char* MODEL_PATH = "LittleQuestTest/ModelCacheTest/sphere.mv1";
+
+//! テスト用のキャッシュファイルを削除
+void removeCache() {
+    ModelCache cache(MODEL_PATH);
+
+    std::error_code error_code;
+    std::filesystem::remove(cache.cachePath(), error_code);
+}
+
+//===========================================================================
+// キャッシュファイルのヘッダー配置 (ModelCache.cpp の CacheHeader と同じ)
+//===========================================================================
+constexpr size_t HEADER_MAGIC            = 0;     //!< 識別子
+constexpr size_t HEADER_VERSION          = 4;     //!< ファイルバージョン
+constexpr size_t HEADER_VERTEX_COUNT     = 8;     //!< 頂点数
+constexpr size_t HEADER_LOD_COUNT        = 12;    //!< LOD段数
+constexpr size_t HEADER_SOURCE_TIME      = 24;    //!< 元モデルの更新日時
+constexpr size_t HEADER_VERTEX_OFFSET    = 40;    //!< 頂点配列の位置
+constexpr size_t HEADER_FILE_SIZE        = 44;    //!< ファイルサイズ
+constexpr size_t HEADER_BVH_NODE_OFFSET  = 48;    //!< BVHノード配列の位置
+constexpr size_t HEADER_BVH_NODE_COUNT   = 52;    //!< BVHノード数
+constexpr size_t HEADER_BVH_INDEX_OFFSET = 56;    //!< BVHインデックス配列の位置
+constexpr size_t HEADER_BVH_INDEX_COUNT  = 60;    //!< BVHインデックス数
+constexpr size_t HEADER_LODS             = 64;    //!< LOD情報の先頭
+constexpr size_t HEADER_LOD_STRIDE       = 16;    //!< LOD情報1つ分のサイズ
+constexpr size_t HEADER_SIZE             = HEADER_LODS + HEADER_LOD_STRIDE * ModelCache::LOD_COUNT;
+
+//! BVHノードの配置 (CollisionMeshBVH::Node と同じ)
+constexpr size_t BVH_NODE_OFFSET = 12;    //!< 右の子のノード番号 / 先頭の三角形番号
+constexpr size_t BVH_NODE_COUNT  = 28;    //!< 葉の三角形数
+
+//---------------------------------------------------------------------------
+//! キャッシュを作り直し、書き換えてから読み込む
+//! @param  [in]    source  作成する形状
+//! @param  [in]    patch   キャッシュファイルの書き換え
+//! @return load() の結果
+//---------------------------------------------------------------------------
+bool loadPatched(const ModelCache::SourceMesh& source, const std::function<void(std::vector<char>&)>& patch) {
+    ModelCache writer(MODEL_PATH);
+    if(!writer.build(source))
+        return false;
+
+    test::patchFile(writer.cachePath(), patch);
+
+    ModelCache cache(MODEL_PATH);
+    return cache.load();
+}
+
+}    // namespace
+
+//---------------------------------------------------------------------------
+//! 作成したキャッシュを読み込むと元の形状とLODが復元される
+//---------------------------------------------------------------------------
+TEST_CASE("ModelCache/LOD往復") {
+    removeCache();
+
+    auto source = makeSphere(48, 32);
+    {
+        ModelCache writer(MODEL_PATH);
+        REQUIRE(writer.build(source));
+        CHECK(writer.isExist());
+        CHECK(!writer.isValid());    // build() は読み込みまではしない
+    }
+
+    ModelCache cache(MODEL_PATH);
+    REQUIRE(cache.load());
+    REQUIRE(cache.isValid());
+
+    //----------------------------------------------------------
+    // 頂点とLOD0の三角形は元の形状と一致する (並び順は最適化で変わる)
+    //----------------------------------------------------------
+    CHECK(cache.vertices().size() == source.vertices_.size());
+    CHECK(cache.indices(0).size() == source.indices_.size());
+    CHECK(triangles(cache.vertices(), cache.indices(0)) == triangles(source.vertices_, source.indices_));
+
+    //----------------------------------------------------------
+    // LODごとのインデックス数と誤差
+    //----------------------------------------------------------
+    REQUIRE(cache.lodCount() == ModelCache::LOD_COUNT);
+    CHECK(cache.lodError(0) == 0.0f);
+
+    for(u32 lod = 0; lod < cache.lodCount(); ++lod) {
+        auto indices = cache.indices(lod);
+        CHECK(!indices.empty());
+        CHECK(indices.size() % 3 == 0);
+
+        u32 out_of_range = 0;
+        for(u32 index: indices) {
+            if(index >= cache.vertices().size())
+                out_of_range++;
+        }
+        CHECK(out_of_range == 0);
+
+        std::printf("  LOD%u: %6zu indices  error %.5f\n", lod, indices.size(), cache.lodError(lod));
+
+        if(lod == 0)
+            continue;
+
+        // 粗いLODほどインデックス数は少なく、誤差は大きい (選択時に先頭から探せる)
+        CHECK(indices.size() <= cache.indices(lod - 1).size());
+        CHECK(cache.lodError(lod) >= cache.lodError(lod - 1));
+
+        // 誤差はモデル空間の距離 (球の大きさを超えることはない)
+        CHECK(cache.lodError(lod) <= SPHERE_RADIUS * 2.0f);
+    }
+
+    // 実際に簡略化されている
+    CHECK(cache.indices(cache.lodCount() - 1).size() < cache.indices(0).size());
+
+    // 範囲外のLODは最も粗いLOD
+    CHECK(cache.indices(100).data() == cache.indices(cache.lodCount() - 1).data());
+    CHECK(cache.lodError(100) == 0.0f);
+
+    //----------------------------------------------------------
+    // 許容誤差からのLOD選択
+    //----------------------------------------------------------
+    CHECK(cache.selectLodByError(0.0f) == 0 || cache.lodError(cache.selectLodByError(0.0f)) == 0.0f);
+    CHECK(cache.selectLodByError(FLT_MAX) == cache.lodCount() - 1);
+    for(u32 lod = 1; lod < cache.lodCount(); ++lod) {
+        u32 selected = cache.selectLodByError(cache.lodError(lod));
+        CHECK(selected >= lod);
+        CHECK(cache.lodError(selected) <= cache.lodError(lod));
+    }
+
+    //----------------------------------------------------------
+    // 境界と当たり判定用のBVH
+    //----------------------------------------------------------
+    CHECK(static_cast<f32>(length(cache.boundsMin() + float3(SPHERE_RADIUS, SPHERE_RADIUS, SPHERE_RADIUS))) < 1e-3f);
+    CHECK(static_cast<f32>(length(cache.boundsMax() - float3(SPHERE_RADIUS, SPHERE_RADIUS, SPHERE_RADIUS))) < 1e-3f);
+
+    auto& bvh = cache.collisionMesh();
+    CHECK(bvh.triangleCount() * 3 == cache.indices(0).size());
+
+    CollisionMeshBVH::RayHit hit;
+    REQUIRE(bvh.raycast(matrix::identity(), float3(0.0f, 0.0f, -10.0f), float3(0.0f, 0.0f, 10.0f), &hit));
+    CHECK(static_cast<f32>(hit.position_.z) < -SPHERE_RADIUS * 0.9f);
+
+    removeCache();
+}
+
+//---------------------------------------------------------------------------
+//! 同じ形状からは同じキャッシュが作られる
+//---------------------------------------------------------------------------
+TEST_CASE("ModelCache/再作成") {
+    removeCache();
+
+    auto source = makeSphere(24, 16);
+
+    std::vector<u32> counts[2];
+    std::vector<f32> errors[2];
+    for(u32 i = 0; i < 2; ++i) {
+        ModelCache writer(MODEL_PATH);
+        REQUIRE(writer.build(source));
+
+        ModelCache cache(MODEL_PATH);
+        REQUIRE(cache.load());
+        for(u32 lod = 0; lod < cache.lodCount(); ++lod) {
+            counts[i].push_back(static_cast<u32>(cache.indices(lod).size()));
+            errors[i].push_back(cache.lodError(lod));
+        }
+    }
+    CHECK(counts[0] == counts[1]);
+    CHECK(errors[0] == errors[1]);
+
+    // 空の形状は作成しない
+    ModelCache writer(MODEL_PATH);
+    CHECK(!writer.build({}));
+
+    removeCache();
+}
+
+//---------------------------------------------------------------------------
+//! ヘッダーの値が壊れているキャッシュは読み込まずに削除する
+//---------------------------------------------------------------------------
+TEST_CASE("ModelCache/ヘッダー検証") {
+    removeCache();
+
+    auto source = makeSphere(24, 16);
+
+    // 書き換えなしなら読み込める (以降の失敗が書き換えによるものであることの確認)
+    REQUIRE(loadPatched(source, [](std::vector<char>&) {}));
+
+    // ヘッダー配置がずれていないことの確認
+    {
+        ModelCache writer(MODEL_PATH);
+        REQUIRE(writer.build(source));
+        auto image = test::readFile(writer.cachePath());
+        REQUIRE(image.size() > HEADER_SIZE);
+        CHECK(test::readValue<u32>(image, HEADER_MAGIC) == 0x48434d4d);
+        CHECK(test::readValue<u32>(image, HEADER_VERSION) == ModelCache::VERSION);
+        CHECK(test::readValue<u32>(image, HEADER_LOD_COUNT) == ModelCache::LOD_COUNT);
+        CHECK(test::readValue<u32>(image, HEADER_FILE_SIZE) == image.size());
+        CHECK(test::readValue<u32>(image, HEADER_VERTEX_OFFSET) == HEADER_SIZE);
+    }
+
+    struct Patch {
+        const char*                             name_;
+        std::function<void(std::vector<char>&)> patch_;
+    };
+    // 範囲外を指す値 (16バイト境界に揃えて境界チェック以外で弾かれないようにする)
+    auto beyond = [](const std::vector<char>& image) { return static_cast<u32>(image.size() + 16) & ~15u; };
+
+    const Patch patches[] = {
+        {"magic", [](auto& image) { test::writeValue<u32>(image, HEADER_MAGIC, 0x12345678); }},
+        {"version", [](auto& image) { test::writeValue<u32>(image, HEADER_VERSION, ModelCache::VERSION + 1); }},
+        {"file_size", [](auto& image) { test::writeValue<u32>(image, HEADER_FILE_SIZE, static_cast<u32>(image.size() + 16)); }},
+        {"lod_count 0", [](auto& image) { test::writeValue<u32>(image, HEADER_LOD_COUNT, 0); }},
+        {"lod_count 9", [](auto& image) { test::writeValue<u32>(image, HEADER_LOD_COUNT, ModelCache::LOD_COUNT + 1); }},
+        {"vertex_offset 境界", [](auto& image) { test::writeValue<u32>(image, HEADER_VERTEX_OFFSET, HEADER_SIZE + 4); }},
+        {"vertex_offset ヘッダー内", [](auto& image) { test::writeValue<u32>(image, HEADER_VERTEX_OFFSET, 0); }},
+        {"vertex_count", [](auto& image) { test::writeValue<u32>(image, HEADER_VERTEX_COUNT, static_cast<u32>(image.size())); }},
+        {"lod index_offset", [&](auto& image) { test::writeValue<u32>(image, HEADER_LODS + HEADER_LOD_STRIDE * 3, beyond(image)); }},
+        {"lod index_count", [](auto& image) { test::writeValue<u32>(image, HEADER_LODS + 4, static_cast<u32>(image.size())); }},
+        {"bvh_node_offset", [&](auto& image) { test::writeValue<u32>(image, HEADER_BVH_NODE_OFFSET, beyond(image)); }},
+        {"bvh_node_count", [](auto& image) { test::writeValue<u32>(image, HEADER_BVH_NODE_COUNT, static_cast<u32>(image.size())); }},
+        {"bvh_index_offset", [&](auto& image) { test::writeValue<u32>(image, HEADER_BVH_INDEX_OFFSET, HEADER_SIZE - 16); }},
+        {"bvh 右の子が範囲外", [](auto& image) {
+             size_t root = test::readValue<u32>(image, HEADER_BVH_NODE_OFFSET);
+             test::writeValue<u32>(image, root + BVH_NODE_OFFSET, test::readValue<u32>(image, HEADER_BVH_NODE_COUNT));
+         }},
+        {"bvh 右の子が親より前", [](auto& image) { test::writeValue<u32>(image, test::readValue<u32>(image, HEADER_BVH_NODE_OFFSET) + BVH_NODE_OFFSET, 0); }},
+        {"bvh 葉の三角形が範囲外", [](auto& image) {
+             size_t root = test::readValue<u32>(image, HEADER_BVH_NODE_OFFSET);
+             test::writeValue<u32>(image, root + BVH_NODE_OFFSET, test::readValue<u32>(image, HEADER_BVH_INDEX_COUNT) / 3);
+             test::writeValue<u32>(image, root + BVH_NODE_COUNT, 1);
+         }},
+        {"bvh 頂点番号が範囲外",
+         [](auto& image) { test::writeValue<u32>(image, test::readValue<u32>(image, HEADER_BVH_INDEX_OFFSET), test::readValue<u32>(image, HEADER_VERTEX_COUNT)); }},
+    };
+
+    for(auto& patch: patches) {
+        bool loaded = loadPatched(source, patch.patch_);
+        if(loaded)
+            std::printf("  loaded: %s\n", patch.name_);
+        CHECK(!loaded);
+
+        // 壊れたキャッシュは削除される (次回起動時に作り直す)
+        ModelCache cache(MODEL_PATH);
+        CHECK(!cache.isExist());
+    }
+
+    removeCache();
+}
+
+//---------------------------------------------------------------------------
+//! 途中で切れたキャッシュは読み込まずに削除する
+//---------------------------------------------------------------------------
+TEST_CASE("ModelCache/途中で切れたファイル") {
+    removeCache();
+
+    auto source = makeSphere(24, 16);
+
+    for(size_t keep: {size_t(0), size_t(8), HEADER_SIZE - 1, HEADER_SIZE, HEADER_SIZE + 100}) {
+        CHECK(!loadPatched(source, [keep](std::vector<char>& image) { image.resize(keep); }));
+
+        ModelCache cache(MODEL_PATH);
+        CHECK(!cache.isExist());
+    }
+
+    // 末尾だけ欠けている
+    CHECK(!loadPatched(source, [](std::vector<char>& image) { image.resize(image.size() - 16); }));
+
+    // キャッシュがなければ読み込めない (削除はしない)
+    {
+        ModelCache cache(MODEL_PATH);
+        CHECK(!cache.load());
+        CHECK(!cache.isValid());
+    }
+
+    removeCache();
+}
+
+//---------------------------------------------------------------------------
+//! 元モデルが変更されたキャッシュは古いものとして削除する
+//---------------------------------------------------------------------------
+TEST_CASE("ModelCache/元モデルの変更検出") {
+    // 元モデルの代わりのファイル (内容は問わない)
+    const char* source_path = "ModelCacheTestSource.mv1";
+    auto        write_source = [&](const std::string& text) {
+        std::ofstream stream(source_path, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+        stream << text;
+    };
+    auto remove_all = [&]() {
+        std::error_code error_code;
+        std::filesystem::remove(ModelCache(source_path).cachePath(), error_code);
+        std::filesystem::remove(source_path, error_code);
+    };
+    auto build = [&]() {
+        ModelCache writer(source_path);
+        return writer.build(makeSphere(12, 8));
+    };
+    auto load = [&]() {
+        ModelCache cache(source_path);
+        return cache.load();
+    };
+    auto touch = [&]() {
+        std::error_code error_code;
+        auto            time = std::filesystem::last_write_time(source_path, error_code);
+        std::filesystem::last_write_time(source_path, time + std::chrono::hours(1), error_code);
+    };
+
+    remove_all();
+
+    // 変更なし
+    write_source("model version 1");
+    REQUIRE(build());
+    CHECK(load());
+    CHECK(load());    // 読み込み後も削除されていない
+
+    // サイズが変わった
+    write_source("model version 1 + more data");
+    CHECK(!load());
+    CHECK(!ModelCache(source_path).isExist());
+
+    // 更新日時だけ変わった (内容は同じ。チェックアウトやコピーで起きる)
+    write_source("model version 1");
+    REQUIRE(build());
+    touch();
+    CHECK(load());
+
+    // 新しい日時がヘッダーに書き戻され、次回からハッシュ値を比較しない
+    {
+        std::error_code error_code;
+        auto            time  = std::filesystem::last_write_time(source_path, error_code);
+        auto            image = test::readFile(ModelCache(source_path).cachePath());
+        REQUIRE(image.size() >= HEADER_SIZE);
+
+        CHECK(test::readValue<u64>(image, HEADER_SOURCE_TIME) == static_cast<u64>(time.time_since_epoch().count()));
+    }
+    CHECK(load());
+
+    // 同じサイズで内容が変わった
+    write_source("model version 2");
+    touch();
+    CHECK(!load());
+    CHECK(!ModelCache(source_path).isExist());
+
+    // 元モデルがない場合 (アーカイブ内) はキャッシュをそのまま使う
+    REQUIRE(build());
+    {
+        std::error_code error_code;
+        std::filesystem::remove(source_path, error_code);
+    }
+    CHECK(load());
+
+    remove_all();
+}
@@ -0,0 +1,173 @@
+﻿//---------------------------------------------------------------------------
+//! @file   PhysicsBench.cpp
+//! @brief  物理シミュレーションのベンチマーク (描画なしで実行)
+//---------------------------------------------------------------------------
+#include "Test.h"
+
+#include <System/Geometry.h>
+#include <System/Physics/PhysicsEngine.h>
+#include <System/Physics/PhysicsLayer.h>
+#include <System/Physics/RigidBody.h>
+#include <System/Physics/Shape.h>
+
+#include <thread>
+
+namespace {
+
+constexpr u32 RAY_COUNT  = 10000;    //!< レイの数
+constexpr u32 GRID_COUNT = 128;      //!< 地形メッシュの分割数 (三角形数は 2 × 128 × 128)
+constexpr f32 GRID_SIZE  = 1.0f;     //!< 地形メッシュの1マスの大きさ
+constexpr u32 REPEAT     = 10;       //!< 計測回数
+
+//! 地形の高さ
+f32 terrainHeight(f32 x, f32 z) {
+    return std::sin(x * 0.3f) * std::cos(z * 0.2f) * 2.0f;
+}
+
+//---------------------------------------------------------------------------
+//! 起伏のある地形メッシュを作成
+//---------------------------------------------------------------------------
+shape::Mesh makeTerrain() {
+    std::vector<float3> vertices;
+    std::vector<u32>    indices;
+
+    const f32 half = GRID_COUNT * GRID_SIZE * 0.5f;
+    for(u32 z = 0; z <= GRID_COUNT; ++z) {
+        for(u32 x = 0; x <= GRID_COUNT; ++x) {
+            f32 px = static_cast<f32>(x) * GRID_SIZE - half;
+            f32 pz = static_cast<f32>(z) * GRID_SIZE - half;
+            vertices.push_back(float3(px, terrainHeight(px, pz), pz));
+        }
+    }
+
+    const u32 stride = GRID_COUNT + 1;
+    for(u32 z = 0; z < GRID_COUNT; ++z) {
+        for(u32 x = 0; x < GRID_COUNT; ++x) {
+            u32 i0 = z * stride + x;
+            u32 i1 = i0 + 1;
+            u32 i2 = i0 + stride;
+            u32 i3 = i2 + 1;
+            indices.insert(indices.end(), {i0, i2, i1, i1, i2, i3});
+        }
+    }
+    return shape::Mesh(std::move(vertices), std::move(indices));
+}
+
+}    // namespace
+
+//---------------------------------------------------------------------------
+//! メッシュ剛体へのレイ10000本 (1本ずつ/まとめてキャスト)
+//---------------------------------------------------------------------------
+BENCHMARK("Physics/メッシュへのレイ10000本") {
+    auto engine = physics::createPhysics();
+
+    auto terrain = physics::createRigidBody(makeTerrain(), physics::ObjectLayers::NON_MOVING);
+
+    // 剛体は update() でまとめてワールドに追加される
+    engine->update(1.0f / 60.0f);
+    engine->optimize();
+
+    float3 aabb_min;
+    float3 aabb_max;
+    REQUIRE(engine->worldBounds(aabb_min, aabb_max));
+
+    //----------------------------------------------------------
+    // 上から下へのレイ (一部は地形の外を通る)
+    //----------------------------------------------------------
+    std::vector<Ray>                rays(RAY_COUNT);
+    std::vector<physics::CastQuery> queries(RAY_COUNT);
+
+    u32    seed   = 99;
+    float3 extent = (aabb_max - aabb_min) * 1.05f;
+    float3 origin = (aabb_max + aabb_min) * 0.5f - extent * 0.5f;
+    for(u32 i = 0; i < RAY_COUNT; ++i) {
+        float3 start =
+            float3(origin.x + test::random(seed) * extent.x, aabb_max.y + 5.0f, origin.z + test::random(seed) * extent.z);
+        float3 end   = float3(start.x, aabb_min.y - 5.0f, start.z);
+
+        rays[i]           = Ray(start, end - start);
+        queries[i].start_ = start;
+        queries[i].end_   = end;
+    }
+
+    // まとめてキャストはジョブシステムで並列に実行される
+    std::printf("  hardware threads: %u  triangles: %u\n", std::thread::hardware_concurrency(), GRID_COUNT * GRID_COUNT * 2);
+
+    std::vector<physics::CastResult> results(RAY_COUNT);
+    std::vector<physics::CastHit>    hits(RAY_COUNT * 4);
+
+    //----------------------------------------------------------
+    // 1本ずつ
+    //----------------------------------------------------------
+    std::vector<physics::RayCastResult> single(RAY_COUNT);
+    std::vector<bool>                   single_hit(RAY_COUNT);
+    u32                                 single_count = 0;
+
+    f32 single_ms = test::measure(REPEAT, [&]() {
+        single_count = 0;
+        for(u32 i = 0; i < RAY_COUNT; ++i) {
+            single_hit[i] = engine->castRay(rays[i], single[i]);
+            if(single_hit[i])
+                single_count++;
+        }
+    });
+    test::report("castRay loop", single_ms);
+
+    //----------------------------------------------------------
+    // まとめてキャスト
+    //----------------------------------------------------------
+    u32 batch_count[3] = {};
+    for(auto mode: {physics::CastMode::Closest, physics::CastMode::Any, physics::CastMode::All}) {
+        for(auto& query: queries)
+            query.mode_ = mode;
+
+        const char* labels[] = {"castBatch closest", "castBatch any", "castBatch all"};
+        u32         index    = static_cast<u32>(mode);
+        f32         ms = test::measure(REPEAT, [&]() { batch_count[index] = engine->castBatch(queries, results, hits); });
+        test::report(labels[index], ms);
+
+        // 最も手前の当たりは1本ずつの結果と一致する (まとめてキャストは法線も求めている)
+        if(mode != physics::CastMode::Closest)
+            continue;
+
+        u32 mismatch = 0;
+        for(u32 i = 0; i < RAY_COUNT; ++i) {
+            auto& result = results[i];
+            if((result.hit_count_ != 0) != single_hit[i]) {
+                mismatch++;
+                continue;
+            }
+            if(result.hit_count_ == 0)
+                continue;
+
+            auto& hit = hits[result.first_hit_];
+            if(hit.body_id_ != single[i].body_id_ || std::abs(hit.t_ - single[i].t_) > 1e-4f)
+                mismatch++;
+        }
+        CHECK(mismatch == 0);
+    }
+
+    std::printf("  hits: castRay %u / closest %u / any %u / all %u\n", single_count, batch_count[0], batch_count[1],
+                batch_count[2]);
+
+    CHECK(single_count > RAY_COUNT / 2);
+    CHECK(batch_count[0] == single_count);
+    CHECK(batch_count[1] == single_count);
+    CHECK(batch_count[2] >= single_count);
+
+    //----------------------------------------------------------
+    // 球のキャスト (同じ経路を半径0.3の球で)
+    //----------------------------------------------------------
+    for(auto& query: queries) {
+        query.shape_  = physics::CastShape::Sphere;
+        query.radius_ = 0.3f;
+        query.mode_   = physics::CastMode::Closest;
+    }
+    u32 sphere_count = 0;
+    test::report("castBatch sphere closest",
+                 test::measure(REPEAT, [&]() { sphere_count = engine->castBatch(queries, results, hits); }));
+    CHECK(sphere_count >= single_count);
+
+    terrain.reset();
+    engine.reset();
+}
@@ -0,0 +1,239 @@
+﻿//---------------------------------------------------------------------------
+//! @file   PhysicsTest.cpp
+//! @brief  物理シミュレーションの単体テスト (描画なしで実行)
+//---------------------------------------------------------------------------
+#include "Test.h"
+
+#include <System/Physics/PhysicsEngine.h>
+#include <System/Physics/PhysicsLayer.h>
+#include <System/Physics/RigidBody.h>
+#include <System/Physics/Shape.h>
+
+namespace {
+
+constexpr u32 STACK_COUNT = 24;    //!< 積み上げる剛体の数
+
+//! 1フレームの経過時間 (固定値の擬似乱数列。処理落ちや高フレームレートを含む)
+std::vector<f32> frameTimes(u32 count) {
+    std::vector<f32> times;
+    u32              seed = 12345;
+    for(u32 i = 0; i < count; ++i) {
+        // 1/240秒 ～ 1/15秒
+        f32 t = test::random(seed);
+        times.push_back(1.0f / 240.0f + t * (1.0f / 15.0f - 1.0f / 240.0f));
+    }
+    return times;
+}
+
+//! 積み上げる剛体の初期位置
+float3 stackPosition(u32 index) {
+    f32 x = static_cast<f32>(index % 4) * 0.6f - 0.9f;
+    f32 y = 0.5f + static_cast<f32>(index / 4) * 0.55f;
+    return float3(x, y, 0.1f * static_cast<f32>(index % 5));
+}
+
+//! キネマティック移動の目標位置
+float3 kinematicTarget(f32 time) {
+    return float3(std::sin(time) * 2.0f, 1.0f, std::cos(time) * 2.0f);
+}
+
+//! 剛体1つ分の結果
+struct BodyState {
+    float3     position_;
+    quaternion rotation_;
+};
+
+//---------------------------------------------------------------------------
+//! 箱を積んだシーンを描画なしで進め、全剛体の最終姿勢を返す
+//! @param  [in]    times   フレームごとの経過時間 (入力の記録)
+//---------------------------------------------------------------------------
+std::vector<BodyState> simulate(const std::vector<f32>& times) {
+    auto engine = physics::createPhysics();
+    engine->setFixedStep(60.0f, 4);
+
+    std::vector<std::shared_ptr<physics::RigidBody>> bodies;
+
+    // 床
+    bodies.push_back(physics::createRigidBody(shape::Box(float3(20.0f, 0.5f, 20.0f)), physics::ObjectLayers::NON_MOVING,
+                                              physics::MotionType::Static));
+    bodies.back()->setPosition(float3(0.0f, -0.5f, 0.0f));
+
+    // 積み上げた箱と球
+    for(u32 i = 0; i < STACK_COUNT; ++i) {
+        if(i % 3 == 0)
+            bodies.push_back(physics::createRigidBody(shape::Sphere(float3(0.0f, 0.0f, 0.0f), 0.25f),
+                                                      physics::ObjectLayers::MOVING));
+        else
+            bodies.push_back(physics::createRigidBody(shape::Box(float3(0.25f, 0.25f, 0.25f)), physics::ObjectLayers::MOVING));
+        bodies.back()->setPosition(stackPosition(i));
+    }
+
+    // 箱の山に突っ込むキネマティック剛体
+    auto kinematic = physics::createRigidBody(shape::Box(float3(0.5f, 0.5f, 0.5f)), physics::ObjectLayers::MOVING,
+                                              physics::MotionType::Kinematic);
+    kinematic->setPosition(kinematicTarget(0.0f));
+    bodies.push_back(kinematic);
+
+    f32 time = 0.0f;
+    for(f32 dt: times) {
+        // ゲーム側と同じく、実際に進む時間でキネマティック移動を設定する
+        time += dt;
+        f32 sim_dt = engine->simulationTime(dt);
+        if(sim_dt > 0.0f)
+            kinematic->moveKinematic(kinematicTarget(time), quaternion(0.0f, 0.0f, 0.0f, 1.0f), sim_dt);
+
+        engine->update(dt);
+    }
+
+    std::vector<BodyState> states;
+    for(auto& body: bodies)
+        states.push_back({body->position(), body->rotation()});
+
+    bodies.clear();
+    kinematic.reset();
+    engine.reset();
+    return states;
+}
+
+}    // namespace
+
+//---------------------------------------------------------------------------
+//! 同じ入力で2回シミュレーションすると全剛体の姿勢がビット単位で一致する
+//---------------------------------------------------------------------------
+TEST_CASE("Physics/決定論リプレイ") {
+    auto times = frameTimes(600);
+
+    auto first  = simulate(times);
+    auto second = simulate(times);
+
+    REQUIRE(first.size() == second.size());
+
+    u32 mismatch = 0;
+    for(size_t i = 0; i < first.size(); ++i) {
+        f32 a[7] = {first[i].position_.x, first[i].position_.y, first[i].position_.z, first[i].rotation_.x,
+                    first[i].rotation_.y, first[i].rotation_.z, first[i].rotation_.w};
+        f32 b[7] = {second[i].position_.x, second[i].position_.y, second[i].position_.z, second[i].rotation_.x,
+                    second[i].rotation_.y, second[i].rotation_.z, second[i].rotation_.w};
+        if(std::memcmp(a, b, sizeof(a)) != 0) {
+            std::printf("  body %zu: (%f %f %f) != (%f %f %f)\n", i, a[0], a[1], a[2], b[0], b[1], b[2]);
+            mismatch++;
+        }
+    }
+    CHECK(mismatch == 0);
+
+    // キネマティック剛体に押されて山が崩れている (シミュレーションが進んでいることの確認)
+    u32 moved = 0;
+    for(u32 i = 0; i < STACK_COUNT; ++i) {
+        if(static_cast<f32>(length(first[i + 1].position_ - stackPosition(i))) > 0.1f)
+            moved++;
+    }
+    CHECK(moved > STACK_COUNT / 2);
+}
+
+//---------------------------------------------------------------------------
+//! simulationTime() は update() が実際に進めた時間と一致する
+//---------------------------------------------------------------------------
+TEST_CASE("Physics/シミュレーション時間") {
+    auto engine = physics::createPhysics();
+
+    // 固定ステップ (処理落ち時の切り捨てを含む)
+    engine->setFixedStep(60.0f, 3);
+    for(f32 dt: frameTimes(200)) {
+        f32 expect = engine->simulationTime(dt);
+        engine->update(dt);
+        CHECK(expect == engine->fixedDeltaTime() * static_cast<f32>(engine->stepCount()));
+        CHECK(engine->interpolationAlpha() >= 0.0f);
+        CHECK(engine->interpolationAlpha() <= 1.0f);
+    }
+
+    // ステップしないフレームは0
+    engine->setFixedStep(60.0f, 3);
+    CHECK(engine->simulationTime(1.0f / 240.0f) == 0.0f);
+
+    // ポーズ中 (経過時間0) は0
+    CHECK(engine->simulationTime(0.0f) == 0.0f);
+
+    // 可変ステップはそのまま
+    engine->setFixedStep(0.0f, 1);
+    CHECK(engine->simulationTime(1.0f / 30.0f) == 1.0f / 30.0f);
+}
+
+//---------------------------------------------------------------------------
+//! 固定ステップでもキネマティック剛体は毎フレーム目標位置で止まる
+//! (フレームの経過時間で速度を決めるとステップ数の変動で行き過ぎる)
+//---------------------------------------------------------------------------
+TEST_CASE("Physics/キネマティック移動") {
+    auto engine = physics::createPhysics();
+    engine->setFixedStep(60.0f, 4);
+
+    auto body = physics::createRigidBody(shape::Box(float3(0.5f, 0.5f, 0.5f)), physics::ObjectLayers::MOVING,
+                                         physics::MotionType::Kinematic);
+    body->setPosition(kinematicTarget(0.0f));
+
+    f32    time    = 0.0f;
+    float3 reached = kinematicTarget(0.0f);
+    f32    max_err = 0.0f;
+    for(f32 dt: frameTimes(300)) {
+        time += dt;
+        float3 target = kinematicTarget(time);
+
+        f32 sim_dt = engine->simulationTime(dt);
+        if(sim_dt > 0.0f) {
+            body->moveKinematic(target, quaternion(0.0f, 0.0f, 0.0f, 1.0f), sim_dt);
+            reached = target;
+        }
+        engine->update(dt);
+
+        // ステップしたフレームでは目標位置、しなかったフレームでは前回の位置のまま
+        max_err = std::max(max_err, static_cast<f32>(length(body->position() - reached)));
+    }
+    CHECK(max_err < 1e-3f);
+
+    // 補間係数1.0の姿勢は最新の姿勢と一致する
+    matrix a = body->interpolatedMatrix(1.0f);
+    matrix b = body->worldMatrix();
+    CHECK(static_cast<f32>(length(a.translate() - b.translate())) < 1e-5f);
+
+    body.reset();
+    engine.reset();
+}
+
+//---------------------------------------------------------------------------
+//! シーン切り替え後は使われなくなった形状だけキャッシュから解放される
+//---------------------------------------------------------------------------
+TEST_CASE("Physics/形状キャッシュの解放") {
+    auto engine = physics::createPhysics();
+
+    auto used   = physics::createRigidBody(shape::Box(float3(0.5f, 0.5f, 0.5f)), physics::ObjectLayers::MOVING,
+                                           physics::MotionType::Dynamic);
+    auto unused = physics::createRigidBody(shape::Sphere(float3(0.0f, 0.0f, 0.0f), 0.5f),
+                                           physics::ObjectLayers::MOVING, physics::MotionType::Dynamic);
+    engine->update(1.0f / 60.0f);
+    REQUIRE(physics::rigidBodyStats().shape_count_ == 2);
+
+    // 削除した剛体はプールで待機し、形状も残る
+    unused.reset();
+    engine->update(1.0f / 60.0f);
+    CHECK(physics::rigidBodyStats().shape_count_ == 2);
+    CHECK(physics::rigidBodyStats().pooled_bodies_ == 1);
+
+    // 予約後の反映で、プールのボディだけが参照している形状はボディごと解放される
+    u32 released = physics::rigidBodyStats().shape_released_;
+    physics::requestReleaseUnusedShapes();
+    engine->update(1.0f / 60.0f);
+
+    auto stats = physics::rigidBodyStats();
+    CHECK(stats.shape_count_ == 1);
+    CHECK(stats.pooled_bodies_ == 0);
+    CHECK(stats.shape_released_ == released + 1);
+
+    // 使用中の形状は再利用される
+    u32  hits = stats.shape_hits_;
+    auto same = physics::createRigidBody(shape::Box(float3(0.5f, 0.5f, 0.5f)), physics::ObjectLayers::MOVING,
+                                         physics::MotionType::Dynamic);
+    CHECK(physics::rigidBodyStats().shape_hits_ == hits + 1);
+
+    same.reset();
+    used.reset();
+    engine.reset();
+}
@@ -0,0 +1,228 @@
+﻿//---------------------------------------------------------------------------
+//! @file   ShaderCacheTest.cpp
+//! @brief  シェーダーバイトコードキャッシュの単体テスト
+//---------------------------------------------------------------------------
+#include "Test.h"
+
+#include <System/Graphics/ShaderCache.h>
+
+#include <functional>
+
+namespace {
+
+//===========================================================================
+// キャッシュファイルのヘッダー配置 (ShaderCache.cpp の CacheHeader と同じ)
+//===========================================================================
+constexpr size_t HEADER_MAGIC         = 0;     //!< 識別子
+constexpr size_t HEADER_VERSION       = 4;     //!< ファイルバージョン
+constexpr size_t HEADER_SOURCE_HASH   = 8;     //!< キーのソースハッシュ値
+constexpr size_t HEADER_BYTECODE_SIZE = 32;    //!< バイトコードのサイズ
+constexpr size_t HEADER_SIZE          = 48;    //!< ヘッダーのサイズ
+
+//! テスト用のフォルダ (テンポラリフォルダ内)
+std::filesystem::path testDirectory() {
+    std::error_code error_code;
+    return std::filesystem::temp_directory_path(error_code) / "LittleQuestTest" / "ShaderCacheTest";
+}
+
+//! テキストファイルを書き込む
+void writeText(const std::filesystem::path& path, const std::string& text) {
+    std::error_code error_code;
+    std::filesystem::create_directories(path.parent_path(), error_code);
+
+    std::ofstream stream(path, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+    stream << text;
+}
+
+//---------------------------------------------------------------------------
+//! テスト用のシェーダーソース一式を作成
+//! ps.fx → common.h, sub/inc.h → ../common.h (循環しても1回だけ)
+//---------------------------------------------------------------------------
+std::filesystem::path writeShaderSources() {
+    auto directory = testDirectory() / "shader";
+
+    writeText(directory / "ps.fx",
+              "#include \"common.h\"\n"
+              "  #  include <sub/inc.h>\n"
+              "float4 main() : SV_Target { return COLOR; }\n");
+    writeText(directory / "common.h",
+              "#pragma once\n"
+              "#define COLOR float4(1, 1, 1, 1)\n");
+    writeText(directory / "sub" / "inc.h",
+              "#include \"../common.h\"\n"
+              "// include\n");
+    return directory / "ps.fx";
+}
+
+//! テスト用のバイトコード
+std::vector<std::byte> makeBytecode(size_t size, u8 seed) {
+    std::vector<std::byte> bytecode(size);
+    for(size_t i = 0; i < size; ++i)
+        bytecode[i] = static_cast<std::byte>(seed + i * 7);
+    return bytecode;
+}
+
+}    // namespace
+
+//---------------------------------------------------------------------------
+//! インクルードファイルを含めてハッシュ化され、どれかが変わればハッシュ値も変わる
+//---------------------------------------------------------------------------
+TEST_CASE("ShaderCache/ソースのハッシュ値") {
+    std::error_code error_code;
+    std::filesystem::remove_all(testDirectory(), error_code);
+
+    auto source = writeShaderSources();
+
+    std::vector<std::filesystem::path> dependencies;
+    u64                                hash = ShaderCache::hashSource(source, &dependencies);
+    CHECK(hash != 0);
+
+    // ソース + common.h + sub/inc.h (common.h は2回目は数えない)
+    CHECK(dependencies.size() == 3);
+
+    // 同じ内容なら同じ値
+    CHECK(ShaderCache::hashSource(source) == hash);
+
+    // 読み込めないソースは0
+    CHECK(ShaderCache::hashSource(testDirectory() / "missing.fx") == 0);
+
+    // 入れ子のインクルードファイルの変更
+    auto inc = source.parent_path() / "sub" / "inc.h";
+    writeText(inc, "#include \"../common.h\"\n// include (edited)\n");
+    u64 edited = ShaderCache::hashSource(source);
+    CHECK(edited != hash);
+
+    // 元に戻すと元の値
+    writeText(inc, "#include \"../common.h\"\n// include\n");
+    CHECK(ShaderCache::hashSource(source) == hash);
+
+    // 見つからないインクルードファイルが作成された
+    {
+        std::ofstream stream(source, std::ios_base::out | std::ios_base::binary | std::ios_base::app);
+        stream << "#include \"late.h\"\n";
+    }
+    u64 missing = ShaderCache::hashSource(source);
+    writeText(source.parent_path() / "late.h", "// late\n");
+    CHECK(ShaderCache::hashSource(source) != missing);
+
+    std::filesystem::remove_all(testDirectory(), error_code);
+}
+
+//---------------------------------------------------------------------------
+//! キーが完全に一致した場合だけキャッシュを使用する
+//---------------------------------------------------------------------------
+TEST_CASE("ShaderCache/キーの一致") {
+    std::error_code error_code;
+    std::filesystem::remove_all(testDirectory(), error_code);
+    ShaderCache::setDirectory(testDirectory() / "cache");
+
+    auto source = writeShaderSources();
+
+    ShaderCacheKey key{ShaderCache::hashSource(source), 2, 1, 0x800, 0x324};
+    auto           bytecode = makeBytecode(100, 3);
+
+    // 保存前は読み込めない
+    std::vector<std::byte> loaded;
+    CHECK(!ShaderCache::load(source, key, loaded));
+
+    // 往復
+    REQUIRE(ShaderCache::save(source, key, bytecode));
+    REQUIRE(ShaderCache::load(source, key, loaded));
+    CHECK(loaded == bytecode);
+
+    // 各項目が1つでも異なれば別のキー
+    ShaderCacheKey keys[5] = {key, key, key, key, key};
+    keys[0].source_hash_++;
+    keys[1].variant_++;
+    keys[2].shader_type_++;
+    keys[3].compile_flags_++;
+    keys[4].dxlib_version_++;
+    for(auto& other: keys) {
+        CHECK(!(other == key));
+
+        // ファイル名が同じ (ハッシュ値/DxLibバージョン違い) でもヘッダーで弾かれる
+        std::vector<std::byte> other_loaded;
+        CHECK(!ShaderCache::load(source, other, other_loaded));
+    }
+
+    // バリエーションなどはファイルを分ける
+    CHECK(ShaderCache::cachePath(source, keys[1]) != ShaderCache::cachePath(source, key));
+    CHECK(ShaderCache::cachePath(source, keys[3]) != ShaderCache::cachePath(source, key));
+    CHECK(ShaderCache::cachePath(source, keys[0]) == ShaderCache::cachePath(source, key));
+
+    //----------------------------------------------------------
+    // インクルードファイルを変更するとキーが変わり、古いキャッシュは使われない
+    //----------------------------------------------------------
+    writeText(source.parent_path() / "common.h", "#pragma once\n#define COLOR float4(1, 0, 0, 1)\n");
+
+    ShaderCacheKey new_key = key;
+    new_key.source_hash_   = ShaderCache::hashSource(source);
+    CHECK(new_key.source_hash_ != key.source_hash_);
+    CHECK(!ShaderCache::load(source, new_key, loaded));
+
+    // 再コンパイル結果で上書き
+    auto new_bytecode = makeBytecode(120, 9);
+    REQUIRE(ShaderCache::save(source, new_key, new_bytecode));
+    REQUIRE(ShaderCache::load(source, new_key, loaded));
+    CHECK(loaded == new_bytecode);
+    CHECK(!ShaderCache::load(source, key, loaded));
+
+    std::filesystem::remove_all(testDirectory(), error_code);
+}
+
+//---------------------------------------------------------------------------
+//! 途中で切れたファイルや壊れたヘッダーは読み込まない
+//---------------------------------------------------------------------------
+TEST_CASE("ShaderCache/壊れたファイル") {
+    std::error_code error_code;
+    std::filesystem::remove_all(testDirectory(), error_code);
+    ShaderCache::setDirectory(testDirectory() / "cache");
+
+    auto source = writeShaderSources();
+
+    ShaderCacheKey key{ShaderCache::hashSource(source), 0, 1, 0, 0x324};
+    auto           bytecode = makeBytecode(256, 1);
+    auto           path     = ShaderCache::cachePath(source, key);
+
+    // キャッシュを作り直し、書き換えてから読み込む
+    auto load_patched = [&](const std::function<void(std::vector<char>&)>& patch) {
+        if(!ShaderCache::save(source, key, bytecode))
+            return false;
+
+        test::patchFile(path, patch);
+
+        std::vector<std::byte> loaded;
+        return ShaderCache::load(source, key, loaded);
+    };
+
+    // 書き換えなしなら読み込める
+    REQUIRE(load_patched([](auto&) {}));
+    CHECK(test::readFile(path).size() == HEADER_SIZE + bytecode.size());
+
+    // 途中で切れている
+    for(size_t keep: {size_t(0), size_t(4), HEADER_SIZE - 1, HEADER_SIZE, HEADER_SIZE + 100})
+        CHECK(!load_patched([keep](auto& image) { image.resize(keep); }));
+
+    // 末尾に余分なデーター
+    CHECK(!load_patched([](auto& image) { image.push_back(0); }));
+
+    // バイトコードが壊れている
+    CHECK(!load_patched([](auto& image) { image[HEADER_SIZE + 10] ^= 0x5a; }));
+
+    // ヘッダーが一致しない
+    CHECK(!load_patched([](auto& image) { test::writeValue<u32>(image, HEADER_MAGIC, 0x12345678); }));
+    CHECK(!load_patched([](auto& image) { test::writeValue<u32>(image, HEADER_VERSION, ShaderCache::VERSION + 1); }));
+    CHECK(!load_patched([&](auto& image) { test::writeValue<u64>(image, HEADER_SOURCE_HASH, key.source_hash_ + 1); }));
+
+    // 壊れたサイズ (巨大な確保をせずに失敗する)
+    CHECK(!load_patched([](auto& image) { test::writeValue<u64>(image, HEADER_BYTECODE_SIZE, ~0ull); }));
+    CHECK(!load_patched([](auto& image) { test::writeValue<u64>(image, HEADER_BYTECODE_SIZE, 255); }));
+
+    // 保存しなおせば読み込める
+    REQUIRE(ShaderCache::save(source, key, bytecode));
+    std::vector<std::byte> loaded;
+    CHECK(ShaderCache::load(source, key, loaded));
+    CHECK(loaded == bytecode);
+
+    std::filesystem::remove_all(testDirectory(), error_code);
+}
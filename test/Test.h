@@ -0,0 +1,171 @@
+﻿//---------------------------------------------------------------------------
+//! @file   Test.h
+//! @brief  単体テスト/ベンチマークの最小フレームワーク
+//! @note   外部ライブラリを使わず、ゲーム本体と同じ書き方でテストを記述できます
+//
+//  【使用例】
+//  TEST_CASE("JobGroup/直列") {
+//      CHECK(value == 1);
+//      REQUIRE(ptr != nullptr);    // 失敗したらこのテストを中断
+//  }
+//  BENCHMARK("JobGroup/10000") {
+//      f32 ms = test::measure(10, [&]() { group.execute(); });
+//      test::report("execute", ms);
+//  }
+//---------------------------------------------------------------------------
+#pragma once
+
+#include <cfloat>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <vector>
+
+namespace test {
+
+//! テスト関数
+using TestFunc = void (*)();
+
+//! 登録されたテスト
+struct TestEntry {
+    const char* name_;     //!< 名前
+    TestFunc    func_;     //!< 関数
+    bool        bench_;    //!< ベンチマークかどうか
+};
+
+//! テスト一覧
+inline std::vector<TestEntry>& entries() {
+    static std::vector<TestEntry> list;
+    return list;
+}
+
+//! 失敗数 (実行中のテスト)
+inline u32& failures() {
+    static u32 count = 0;
+    return count;
+}
+
+//! テスト中断用
+struct Abort {};
+
+//! 静的初期化で登録するためのヘルパー
+struct Registrar {
+    Registrar(const char* name, TestFunc func, bool bench) {
+        entries().push_back({name, func, bench});
+    }
+};
+
+//! 失敗を記録
+inline void fail(const char* expr, const char* file, int line) {
+    std::printf("  FAILED: %s\n    at %s(%d)\n", expr, file, line);
+    failures()++;
+}
+
+//---------------------------------------------------------------------------
+//! 処理時間を計測します
+//! @param  [in]    repeat  計測回数
+//! @param  [in]    func    計測する関数
+//! @return 最速の処理時間(ms)
+//---------------------------------------------------------------------------
+template <class Func>
+f32 measure(u32 repeat, Func&& func) {
+    f32 best = FLT_MAX;
+    for(u32 i = 0; i < repeat; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        auto end = std::chrono::steady_clock::now();
+        best     = std::min(best, std::chrono::duration<f32, std::milli>(end - start).count());
+    }
+    return best;
+}
+
+//! 計測結果を表示
+inline void report(const char* label, f32 ms) {
+    std::printf("  %-40s %10.3f ms\n", label, ms);
+}
+
+//---------------------------------------------------------------------------
+//! 固定値の擬似乱数 (線形合同法)
+//! @param  [in,out]    seed    乱数の状態 (同じ値から始めれば毎回同じ列になる)
+//! @return 0～1 (1を含まない)
+//---------------------------------------------------------------------------
+inline f32 random(u32& seed) {
+    seed = seed * 1664525u + 1013904223u;
+    return static_cast<f32>(seed >> 8) / static_cast<f32>(1u << 24);
+}
+
+//---------------------------------------------------------------------------
+//! @name キャッシュファイルの書き換え (壊れたファイルの読み込みテスト用)
+//---------------------------------------------------------------------------
+//@{
+
+//! ファイルを読み込む
+inline std::vector<char> readFile(const std::filesystem::path& path) {
+    std::ifstream stream(path, std::ios_base::in | std::ios_base::binary);
+    return {std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+}
+
+//! ファイルを書き込む
+inline void writeFile(const std::filesystem::path& path, const std::vector<char>& image) {
+    std::ofstream stream(path, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+    stream.write(image.data(), image.size());
+}
+
+//! ファイル内の値を読み込む
+template <typename T>
+T readValue(const std::vector<char>& image, size_t offset) {
+    T value;
+    std::memcpy(&value, image.data() + offset, sizeof(value));
+    return value;
+}
+
+//! ファイル内の値を書き換える
+template <typename T>
+void writeValue(std::vector<char>& image, size_t offset, T value) {
+    std::memcpy(image.data() + offset, &value, sizeof(value));
+}
+
+//! ファイルを読み込み、書き換えてから書き戻す
+inline void patchFile(const std::filesystem::path& path, const std::function<void(std::vector<char>&)>& patch) {
+    auto image = readFile(path);
+    patch(image);
+    writeFile(path, image);
+}
+
+//@}
+
+}    // namespace test
+
+#define TEST_CONCAT_IMPL(a, b) a##b
+#define TEST_CONCAT(a, b)      TEST_CONCAT_IMPL(a, b)
+
+#define TEST_REGISTER(name, bench)                                                  \
+    static void              TEST_CONCAT(test_func_, __LINE__)();                   \
+    static ::test::Registrar TEST_CONCAT(test_registrar_, __LINE__)(                \
+        name, &TEST_CONCAT(test_func_, __LINE__), bench);                           \
+    static void TEST_CONCAT(test_func_, __LINE__)()
+
+//! テストケースを定義
+#define TEST_CASE(name) TEST_REGISTER(name, false)
+
+//! ベンチマークを定義
+#define BENCHMARK(name) TEST_REGISTER(name, true)
+
+//! 条件を確認 (失敗しても続行)
+#define CHECK(expr)                                                                 \
+    do {                                                                            \
+        if(!(expr))                                                                 \
+            ::test::fail(#expr, __FILE__, __LINE__);                                \
+    } while(0)
+
+//! 条件を確認 (失敗したらテストを中断)
+#define REQUIRE(expr)                                                               \
+    do {                                                                            \
+        if(!(expr)) {                                                               \
+            ::test::fail(#expr, __FILE__, __LINE__);                                \
+            throw ::test::Abort{};                                                  \
+        }                                                                           \
+    } while(0)
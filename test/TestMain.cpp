@@ -0,0 +1,45 @@
+﻿//---------------------------------------------------------------------------
+//! @file   TestMain.cpp
+//! @brief  単体テスト/ベンチマークの実行
+//
+//  【使用方法】
+//  UnitTest  [フィルター]    名前にフィルター文字列を含むテストだけを実行
+//  Benchmark [フィルター]
+//---------------------------------------------------------------------------
+#include "Test.h"
+
+#include <exception>
+
+//---------------------------------------------------------------------------
+//! エントリーポイント
+//! @return 失敗したテストがあれば 1
+//---------------------------------------------------------------------------
+int main(int argc, char** argv) {
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+
+    u32 run_count  = 0;
+    u32 fail_count = 0;
+    for(auto& entry: test::entries()) {
+        if(filter && !std::strstr(entry.name_, filter))
+            continue;
+
+        std::printf("[%s] %s\n", entry.bench_ ? "BENCH" : "TEST ", entry.name_);
+
+        test::failures() = 0;
+        try {
+            entry.func_();
+        } catch(const test::Abort&) {
+            // REQUIRE で中断 (失敗は記録済み)
+        } catch(const std::exception& e) {
+            std::printf("  FAILED: exception %s\n", e.what());
+            test::failures()++;
+        }
+
+        run_count++;
+        if(test::failures() > 0)
+            fail_count++;
+    }
+
+    std::printf("\n%u run, %u failed\n", run_count, fail_count);
+    return fail_count > 0 ? 1 : 0;
+}
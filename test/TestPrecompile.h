@@ -0,0 +1,86 @@
+﻿//---------------------------------------------------------------------------
+//! @file   TestPrecompile.h
+//! @brief  テスト/ベンチマーク用の共通ヘッダー
+//! @note   Precompile.h のうち Windows/DxLib に依存しない部分だけを用意し、
+//!         ゲーム本体のソースをそのまま Linux でもビルドできるようにします
+//---------------------------------------------------------------------------
+#pragma once
+
+//===========================================================================
+// C++ STL
+//===========================================================================
+
+#include <cmath>
+#include <fstream>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cfloat>    // FLT_MAX (Windowsでは Windows SDK 経由で定義されています)
+#include <cstring>
+#include <memory>
+#include <string>
+
+//===========================================================================
+// 外部ライブラリ
+//===========================================================================
+
+// hlslpp
+#include "hlslpp/include/hlsl++.h"
+using namespace hlslpp;
+
+#include "System/Typedef.h"
+
+//===========================================================================
+// DxLibの数値型 (DxLib.h と同じメモリ配置)
+// モデルキャッシュやBVHは頂点を DxLib::VECTOR のまま扱うため型だけ用意します
+//===========================================================================
+namespace DxLib {
+
+typedef struct tagMATRIX {
+    float m[4][4];
+} MATRIX;
+
+typedef struct tagVECTOR {
+    float x, y, z;
+} VECTOR, FLOAT3;
+
+typedef struct tagFLOAT2 {
+    float u, v;
+} FLOAT2;
+
+typedef struct tagFLOAT4 {
+    float x, y, z, w;
+} FLOAT4;
+
+typedef struct tagINT4 {
+    int x, y, z, w;
+} INT4;
+
+//--------------------------------------------------------------
+// DxLibの関数 (テストでは何もしません。実体は DxLibStub.cpp)
+// 描画リソースの解放などテスト対象から呼ばれるものだけを用意します
+//--------------------------------------------------------------
+int          DeleteVertexBuffer(int vert_buf_handle);
+int          DeleteIndexBuffer(int index_buf_handle);
+unsigned int GetColor(int red, int green, int blue);
+int          SetUseLighting(int flag);
+int          SetUseZBuffer3D(int flag);
+int          DrawLine3D(VECTOR pos1, VECTOR pos2, unsigned int color);
+int          DrawSphere3D(VECTOR center_pos, float r, int div_num, unsigned int dif_color, unsigned int spc_color, int fill_flag);
+
+}    // namespace DxLib
+
+using namespace DxLib;
+
+//--------------------------------------------------------------
+// 数学定数
+//--------------------------------------------------------------
+static constexpr f32 PI       = 3.141592653589793f;    //!< 円周率 π
+static constexpr f32 TAU      = 2.0f * PI;             //!< 円周率の2倍 τ
+static constexpr f32 RadToDeg = 57.29577951f;          //!< Radian→Degree 変換係数
+static constexpr f32 DegToRad = 0.017453293f;          //!< Degree→Radian 変換係数
+
+//===========================================================================
+// 実装コード
+//===========================================================================
+#include "System/VectorMath.h"
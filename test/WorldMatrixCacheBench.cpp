@@ -0,0 +1,176 @@
+﻿//---------------------------------------------------------------------------
+//! @file   WorldMatrixCacheBench.cpp
+//! @brief  ワールド行列キャッシュのベンチマーク (毎回の再計算と確定済みキャッシュの比較)
+//---------------------------------------------------------------------------
+#include "Test.h"
+
+#include <System/WorldMatrixCache.h>
+
+namespace {
+
+constexpr u32 OBJECT_COUNT   = 500;    //!< オブジェクト数
+constexpr u32 MOVE_INTERVAL  = 10;     //!< 1フレームに動くオブジェクトの間隔 (10体に1体)
+constexpr u32 READ_PER_FRAME = 8;      //!< 1フレームにワールド行列を読む回数 (描画/カリング/コリジョン/子など)
+constexpr u32 FRAME_COUNT    = 60;     //!< 1回の計測で進めるフレーム数
+constexpr u32 REPEAT         = 20;     //!< 計測回数
+
+//! オブジェクト (ComponentTransform)
+struct Transform {
+    matrix world_;      //!< ワールド行列
+    u64    version_;    //!< ワールド行列のバージョン
+};
+
+//! モデル (ComponentModel と同じ依存関係)
+struct Model {
+    u32              owner_;            //!< オーナーのオブジェクト
+    s32              attach_ = -1;      //!< アタッチ先のモデル (-1でアタッチなし)
+    matrix           local_;            //!< モデル用のトランスフォーム
+    u64              local_version_;    //!< ローカル行列のバージョン
+    matrix           node_;             //!< アタッチされるノードのワールド行列
+    u64              node_version_;     //!< ノード行列のバージョン
+    WorldMatrixCache cache_;            //!< ワールド行列キャッシュ
+};
+
+//! シーン
+struct World {
+    std::vector<Transform> transforms_;
+    std::vector<Model>     models_;
+};
+
+//---------------------------------------------------------------------------
+//! 半分のモデルが別のオブジェクトのノードにアタッチされたシーンを作成
+//---------------------------------------------------------------------------
+World makeWorld() {
+    World world;
+    world.transforms_.resize(OBJECT_COUNT);
+    world.models_.resize(OBJECT_COUNT);
+
+    for(u32 i = 0; i < OBJECT_COUNT; ++i) {
+        f32 angle = static_cast<f32>(i) * 0.37f;
+        world.transforms_[i].world_ =
+            mul(matrix::rotateY(angle), matrix::translate(float3(static_cast<f32>(i % 25) * 4.0f, 0.0f, static_cast<f32>(i / 25) * 4.0f)));
+        world.transforms_[i].version_ = WorldMatrixCache::NewVersion();
+
+        auto& model          = world.models_[i];
+        model.owner_         = i;
+        model.local_         = mul(matrix::scale(0.1f), matrix::rotateX(angle * 0.5f));
+        model.local_version_ = WorldMatrixCache::NewVersion();
+        model.node_          = mul(matrix::scale(1.5f), matrix::translate(float3(0.3f, 1.2f, 0.1f)));
+        model.node_version_  = WorldMatrixCache::NewVersion();
+
+        // 奇数番目は1つ前のモデルのノードに付ける (武器など)
+        if(i & 1)
+            model.attach_ = static_cast<s32>(i - 1);
+    }
+    return world;
+}
+
+//---------------------------------------------------------------------------
+//! ワールド行列の計算 (ComponentModel::calcWorldMatrix と同じ手順)
+//---------------------------------------------------------------------------
+matrix calcWorldMatrix(const World& world, const Model& model) {
+    matrix mat = matrix::identity();
+
+    if(model.attach_ >= 0) {
+        mat = world.models_[model.attach_].node_;
+
+        // スケールを自前のものに戻す
+        matrix parent_mat(float4{normalize(mat.axisX()), 0}, float4{normalize(mat.axisY()), 0},
+                          float4{normalize(mat.axisZ()), 0}, float4{mat.translate(), 1});
+        mat = parent_mat;
+    }
+
+    mat = mul(model.local_, mat);
+    return mul(mat, world.transforms_[model.owner_].world_);
+}
+
+//---------------------------------------------------------------------------
+//! キャッシュ付きのワールド行列取得 (ComponentModel::GetWorldMatrix と同じ手順)
+//---------------------------------------------------------------------------
+matrix getWorldMatrix(World& world, Model& model) {
+    u64 attach_version = model.attach_ >= 0 ? world.models_[model.attach_].node_version_ : 0;
+    u64 owner_version  = world.transforms_[model.owner_].version_;
+    if(model.cache_.isValid(owner_version, model.local_version_, attach_version))
+        return model.cache_.get();
+
+    return model.cache_.resolve(owner_version, model.local_version_, attach_version, calcWorldMatrix(world, model));
+}
+
+//! 一部のオブジェクトを動かす
+void move(World& world, u32 frame) {
+    for(u32 i = frame % MOVE_INTERVAL; i < OBJECT_COUNT; i += MOVE_INTERVAL) {
+        auto& transform    = world.transforms_[i];
+        transform.world_   = mul(matrix::rotateY(0.01f), transform.world_);
+        transform.version_ = WorldMatrixCache::NewVersion();
+    }
+}
+
+//---------------------------------------------------------------------------
+//! キャッシュ導入前: 読むたびに依存元から再計算する
+//---------------------------------------------------------------------------
+f32 frameRecompute(World& world, u32 frame) {
+    move(world, frame);
+
+    f32 sum = 0.0f;
+    for(u32 read = 0; read < READ_PER_FRAME; ++read) {
+        for(auto& model: world.models_)
+            sum += calcWorldMatrix(world, model)._m30;
+    }
+    return sum;
+}
+
+//---------------------------------------------------------------------------
+//! キャッシュ: PostUpdate後に1回だけ確定し、以降は保存した行列を読む
+//---------------------------------------------------------------------------
+f32 frameCached(World& world, u32 frame) {
+    move(world, frame);
+
+    // Scene::ResolveWorldMatrices と同じ確定処理
+    WorldMatrixCache::SetResolving(true);
+    for(auto& model: world.models_)
+        getWorldMatrix(world, model);
+    WorldMatrixCache::SetResolving(false);
+
+    f32 sum = 0.0f;
+    for(u32 read = 0; read < READ_PER_FRAME; ++read) {
+        for(auto& model: world.models_)
+            sum += getWorldMatrix(world, model)._m30;
+    }
+    return sum;
+}
+
+}    // namespace
+
+//---------------------------------------------------------------------------
+//! オブジェクト500体のワールド行列 (毎回の再計算/確定済みキャッシュ)
+//---------------------------------------------------------------------------
+BENCHMARK("WorldMatrixCache/オブジェクト500体") {
+    World recompute_world = makeWorld();
+    World cached_world    = makeWorld();
+
+    f32 recompute_sum = 0.0f;
+    f32 cached_sum    = 0.0f;
+
+    test::report("recompute every read", test::measure(REPEAT, [&]() {
+                     recompute_sum = 0.0f;
+                     for(u32 frame = 0; frame < FRAME_COUNT; ++frame)
+                         recompute_sum += frameRecompute(recompute_world, frame);
+                 }));
+    test::report("resolve once + cached reads", test::measure(REPEAT, [&]() {
+                     cached_sum = 0.0f;
+                     for(u32 frame = 0; frame < FRAME_COUNT; ++frame)
+                         cached_sum += frameCached(cached_world, frame);
+                 }));
+
+    std::printf("  frames: %u  reads/frame: %u\n", FRAME_COUNT, OBJECT_COUNT * READ_PER_FRAME);
+
+    // 同じだけ動かしているので結果も一致する
+    CHECK(std::abs(recompute_sum - cached_sum) <= std::abs(recompute_sum) * 1e-4f + 1e-2f);
+
+    // 確定処理の外では読むだけで、キャッシュは書き換わらない
+    move(cached_world, 0);
+    auto& model = cached_world.models_[0];
+    getWorldMatrix(cached_world, model);
+    CHECK(!model.cache_.isValid(cached_world.transforms_[0].version_, model.local_version_));
+    CHECK(std::abs(getWorldMatrix(cached_world, model)._m30 - calcWorldMatrix(cached_world, model)._m30) <= 1e-4f);
+}
@@ -0,0 +1,156 @@
+﻿--============================================================================
+-- 単体テスト/ベンチマーク
+-- ゲーム本体とは別のソリューションで、Windows/DxLibに依存しない部分だけをビルドします
+--
+-- 【使用方法】
+--  Windows : bin\premake5.exe --file=test/premake5.lua vs2022
+--  Linux   : premake5 --file=test/premake5.lua gmake2
+--            make -C .build/test config=release
+--============================================================================
+local ROOT_PATH   = path.getabsolute("..")
+local SOURCE_PATH = path.join(ROOT_PATH, "src")
+local OPEN_PATH   = path.join(ROOT_PATH, "opensource")
+local TEST_PATH   = path.join(ROOT_PATH, "test")
+local BUILD_PATH  = path.join(ROOT_PATH, ".build/test")
+
+--============================================================================
+-- ソリューションファイル
+--============================================================================
+workspace "LittleQuestTest"
+	configurations { "Debug", "Release" }
+	architecture "x64"
+	location (BUILD_PATH)
+	startproject "UnitTest"
+
+	language          "C++"
+	cppdialect        "C++20"
+	rtti              "On"
+	exceptionhandling "On"
+	warnings          "Default"
+	vectorextensions  "SSE4.1"		-- JoltPhysics が __SSE4_1__ から SIMD 実装を選択します
+
+	targetdir (path.join(BUILD_PATH, "bin/%{cfg.buildcfg}"))
+	objdir    (path.join(BUILD_PATH, "obj/%{prj.name}/%{cfg.buildcfg}"))
+
+	filter "configurations:Debug"
+		defines  { "_DEBUG", "DEBUG" }
+		optimize "Off"
+		symbols  "On"
+	filter "configurations:Release"
+		defines  { "NDEBUG" }
+		optimize "Speed"
+		symbols  "On"
+
+	-- ゲーム本体と同じ設定でJoltPhysicsのヘッダーを使用する
+	defines {
+		"JPH_DEBUG_RENDERER=1",
+	}
+
+	filter "system:windows"
+		staticruntime "On"
+		buildoptions  { "/permissive-", "/utf-8" }
+		defines       { "NOMINMAX" }
+	filter {}
+
+--============================================================================
+-- 外部のプロジェクトファイル
+--============================================================================
+
+-----------------------------------------------------------------
+-- JoltPhysics
+-----------------------------------------------------------------
+project "JoltPhysics"
+	kind "StaticLib"
+	location (path.join(BUILD_PATH, "JoltPhysics"))
+	optimize "Speed"		-- 常に最適化
+
+	files {
+		path.join(OPEN_PATH, "JoltPhysics/Jolt/**.cpp"),
+		path.join(OPEN_PATH, "JoltPhysics/Jolt/**.h"),
+	}
+
+	includedirs {
+		path.join(OPEN_PATH, "JoltPhysics"),
+	}
+
+-----------------------------------------------------------------
+-- meshoptimizer
+-----------------------------------------------------------------
+project "meshoptimizer"
+	kind "StaticLib"
+	location (path.join(BUILD_PATH, "meshoptimizer"))
+	optimize "Speed"		-- 常に最適化
+
+	files {
+		path.join(OPEN_PATH, "meshoptimizer/src/**.cpp"),
+		path.join(OPEN_PATH, "meshoptimizer/src/**.h"),
+	}
+
+--============================================================================
+-- テスト対象のゲーム本体ソース
+-- DxLibに依存しないファイルだけを列挙します (描画リソースの解放などは DxLibStub.cpp で代用)
+--============================================================================
+local TARGET_FILES = {
+	path.join(SOURCE_PATH, "System/VectorMath.cpp"),
+	path.join(SOURCE_PATH, "System/JobScheduler.cpp"),
+	path.join(SOURCE_PATH, "System/JobWorkerPool.cpp"),
+	path.join(SOURCE_PATH, "System/CollisionMeshBVH.cpp"),
+	path.join(SOURCE_PATH, "System/CollisionShapeCache.cpp"),
+	path.join(SOURCE_PATH, "System/Graphics/Frustum.cpp"),
+	path.join(SOURCE_PATH, "System/Graphics/ModelCache.cpp"),		-- 抽出と描画 (ModelCacheRender.cpp) は除く
+	path.join(SOURCE_PATH, "System/Graphics/ShaderCache.cpp"),
+	path.join(SOURCE_PATH, "System/Utils/MappedFile.cpp"),
+	path.join(SOURCE_PATH, "System/Physics/PhysicsEngine.cpp"),
+	path.join(SOURCE_PATH, "System/Physics/PhysicsLayer.cpp"),
+	path.join(SOURCE_PATH, "System/Physics/RigidBody.cpp"),
+}
+
+--------------------------------------------------------------------
+-- テストプロジェクト共通設定
+--------------------------------------------------------------------
+function config_test_project(name, pattern)
+	project(name)
+	kind "ConsoleApp"
+	location (path.join(BUILD_PATH, name))
+
+	files {
+		path.join(TEST_PATH, "Test.h"),
+		path.join(TEST_PATH, "TestMain.cpp"),
+		path.join(TEST_PATH, "TestPrecompile.h"),
+		path.join(TEST_PATH, "DxLibStub.cpp"),
+		path.join(TEST_PATH, pattern),
+		TARGET_FILES,
+	}
+
+	includedirs {
+		SOURCE_PATH,
+		OPEN_PATH,
+		path.join(OPEN_PATH, "JoltPhysics"),
+		TEST_PATH,
+	}
+
+	links {
+		"JoltPhysics",
+		"meshoptimizer",
+	}
+
+	filter "system:linux"
+		links { "pthread" }
+	filter {}
+
+	-- Precompile.h の代わりに DxLib を含まない共通ヘッダーを使用
+	forceincludes { path.join(TEST_PATH, "TestPrecompile.h") }
+end
+
+-----------------------------------------------------------------
+-- 単体テスト (*Test.cpp)
+-----------------------------------------------------------------
+config_test_project("UnitTest", "*Test.cpp")
+
+-----------------------------------------------------------------
+-- ベンチマーク (*Bench.cpp)
+-----------------------------------------------------------------
+config_test_project("Benchmark", "*Bench.cpp")
+	filter "configurations:Debug"
+		optimize "On"		-- デバッグ構成でも計測できるように最適化
+	filter {}